@@ -6,6 +6,7 @@
 #ifndef CALC_CORE_AST_H
 #define CALC_CORE_AST_H
 
+#include "calc/core/ast_arena.h"
 #include "calc/core/token.h"
 #include "calc/utils/error.h"
 #include <memory>
@@ -16,16 +17,54 @@ namespace calc {
 
 // Forward declaration
 class ASTVisitor;
+class ASTNode;
+
+/**
+ * @brief Owning list of child nodes, stored in the tree's arena when it has one
+ */
+using ASTNodeList = std::vector<std::unique_ptr<ASTNode>, ArenaAllocator<std::unique_ptr<ASTNode>>>;
 
 /**
  * @brief Base class for all AST nodes
  *
  * Implements the Visitor pattern for tree traversal and evaluation.
+ *
+ * Nodes are created either on the heap (plain new / std::make_unique) or
+ * in an ASTArena (new (arena) T(...)). Both are owned through
+ * std::unique_ptr<ASTNode>: deleting an arena node runs its destructor
+ * but leaves the memory to the arena, which frees it when destroyed.
+ * Arena nodes must therefore not outlive their arena; clone() always
+ * produces heap nodes.
+ *
+ * Nothing that walks a whole tree recurses once per node: clone() and
+ * the destructors of inner nodes keep an explicit stack, and visitors
+ * that need every node use PostOrderWalker, so machine-generated trees
+ * millions of levels deep cannot overflow the call stack.
  */
 class ASTNode {
 public:
     virtual ~ASTNode() = default;
 
+    /**
+     * @brief Allocate a node on the heap
+     */
+    static void* operator new(std::size_t size);
+
+    /**
+     * @brief Allocate a node in an arena
+     */
+    static void* operator new(std::size_t size, ASTArena& arena);
+
+    /**
+     * @brief Release a node's memory (a no-op for arena nodes)
+     */
+    static void operator delete(void* ptr) noexcept;
+
+    /**
+     * @brief Called only if a node constructor throws during arena allocation
+     */
+    static void operator delete(void* ptr, ASTArena& arena) noexcept;
+
     /**
      * @brief Create a deep copy of this node
      * @return Unique pointer to the cloned node
@@ -42,6 +81,45 @@ public:
      * @brief Get the string representation of this node (for debugging)
      */
     virtual std::string toString() const = 0;
+
+    /**
+     * @brief Get the number of child nodes (0 for leaves)
+     */
+    virtual size_t getChildCount() const noexcept { return 0; }
+
+    /**
+     * @brief Get a child node, operands in source order
+     * @param index The child index (must be below getChildCount())
+     */
+    virtual ASTNode* getChild(size_t index) const noexcept {
+        (void)index;
+        return nullptr;
+    }
+
+protected:
+    /**
+     * @brief Move this node's inner children into @p out
+     *
+     * Children that are leaves stay in place; their destruction cannot
+     * recurse. Called by destroySubtrees().
+     */
+    virtual void detachChildren(std::vector<std::unique_ptr<ASTNode>>& out) {
+        (void)out;
+    }
+
+    /**
+     * @brief Destroy a node's descendants with an explicit stack
+     *
+     * Called from the destructors of inner nodes so that dropping a deep
+     * tree takes memory proportional to its width, not stack proportional
+     * to its depth.
+     */
+    static void destroySubtrees(ASTNode& node) noexcept;
+
+    /**
+     * @brief Deep-copy a tree with an explicit stack
+     */
+    static std::unique_ptr<ASTNode> cloneTree(const ASTNode& root);
 };
 
 /**
@@ -55,22 +133,137 @@ public:
      */
     explicit LiteralNode(double value);
 
+    /**
+     * @brief Construct an integer literal
+     * @param value The numeric value
+     * @param integer The exact value as 64 bits, which @p value may only approximate
+     */
+    LiteralNode(double value, uint64_t integer);
+
+    /**
+     * @brief Construct an integer literal wider than 64 bits
+     * @param value The numeric value, as the tokenizer converted it
+     * @param integer The low 64 bits of the exact value
+     * @param digits The literal's digits, without base prefix
+     * @param base The base of @p digits
+     */
+    LiteralNode(double value, uint64_t integer, std::string digits, NumberBase base);
+
+    /**
+     * @brief Construct a decimal literal with a fraction or exponent, keeping its digits
+     * @param value The numeric value, as the tokenizer converted it
+     * @param digits The literal as written, e.g. "0.1" or "6.02e23"
+     */
+    LiteralNode(double value, std::string digits);
+
     /**
      * @brief Get the literal value
      */
     double getValue() const noexcept { return value_; }
 
+    /**
+     * @brief Check whether the literal's exact integer value is known
+     */
+    bool hasInteger() const noexcept { return hasInteger_; }
+
+    /**
+     * @brief Get the exact 64-bit value of an integer literal
+     *
+     * Set by the parsers for literals whose value is a whole number,
+     * including ones above 2^53 that getValue() rounds. Literals are read
+     * as unsigned and wrap to 64 bits, so 0xFF..F is all ones. Only
+     * meaningful when hasInteger() is true.
+     */
+    uint64_t getInteger() const noexcept { return integer_; }
+
+    /**
+     * @brief Check whether the literal's exact value needs more than 64 bits
+     *
+     * Wide literals keep their digits so arbitrary-precision evaluators can
+     * read the exact value; getInteger() holds its low 64 bits.
+     */
+    bool isWide() const noexcept { return digits_ != nullptr && hasInteger_; }
+
+    /**
+     * @brief Check whether the literal kept its digits
+     *
+     * True for wide literals, and for decimal fractions when the parser
+     * was asked to keep them (Parser::setKeepLiteralDigits()), since
+     * getValue() only approximates 0.1.
+     */
+    bool hasDigits() const noexcept { return digits_ != nullptr; }
+
+    /**
+     * @brief Get the literal's digits, without base prefix
+     * @throws std::logic_error if the literal has no digits
+     */
+    const std::string& getDigits() const;
+
+    /**
+     * @brief Get the base of the literal's digits
+     * @throws std::logic_error if the literal has no digits
+     */
+    NumberBase getBase() const;
+
     // ASTNode implementation
     std::unique_ptr<ASTNode> clone() const override;
     void accept(ASTVisitor& visitor) override;
     std::string toString() const override;
 
 private:
+    /// Digits of a literal value_ or integer_ cannot hold, kept out of line as they are rare
+    struct Digits {
+        std::string digits;
+        NumberBase base;
+    };
+
     double value_;
+    uint64_t integer_;
+    bool hasInteger_;
+    std::unique_ptr<const Digits> digits_;
+};
+
+/**
+ * @brief Represents a named variable (e.g., x, rate)
+ *
+ * Identifiers written without an argument list parse to this node.
+ * Evaluators look the name up in the EvaluationContext's variables and
+ * fall back to a zero-argument function of the same name, which keeps
+ * constants such as PI and E working.
+ */
+class VariableNode : public ASTNode {
+public:
+    /**
+     * @brief Construct a variable node
+     * @param name The variable name
+     * @param position The position of the name in input
+     */
+    VariableNode(const std::string& name, size_t position);
+
+    /**
+     * @brief Get the variable name
+     */
+    const std::string& getName() const noexcept { return name_; }
+
+    /**
+     * @brief Get the position of the name in input
+     */
+    size_t getPosition() const noexcept { return position_; }
+
+    // ASTNode implementation
+    std::unique_ptr<ASTNode> clone() const override;
+    void accept(ASTVisitor& visitor) override;
+    std::string toString() const override;
+
+private:
+    std::string name_;
+    size_t position_;
 };
 
 /**
  * @brief Represents a binary operation (e.g., a + b, x * y)
+ *
+ * Only the opcode and source position of the operator are stored.
  */
 class BinaryOpNode : public ASTNode {
 public:
@@ -80,7 +273,19 @@ public:
      * @param op The operator token
      * @param right The right operand
      */
-    BinaryOpNode(std::unique_ptr<ASTNode> left, Token op, std::unique_ptr<ASTNode> right);
+    BinaryOpNode(std::unique_ptr<ASTNode> left, const Token& op, std::unique_ptr<ASTNode> right);
+
+    /**
+     * @brief Construct a binary operation node
+     * @param left The left operand
+     * @param op The operator classification
+     * @param position The position of the operator in input
+     * @param right The right operand
+     */
+    BinaryOpNode(std::unique_ptr<ASTNode> left, OpCode op, size_t position,
+                 std::unique_ptr<ASTNode> right);
+
+    ~BinaryOpNode() override;
 
     /**
      * @brief Get the left operand
@@ -88,9 +293,19 @@ public:
     ASTNode* getLeft() const noexcept { return left_.get(); }
 
     /**
-     * @brief Get the operator
+     * @brief Get the operator as a token rebuilt from the stored opcode and position
      */
-    const Token& getOperator() const noexcept { return op_; }
+    Token getOperator() const;
+
+    /**
+     * @brief Get the operator classification
+     */
+    OpCode getOpCode() const noexcept { return op_; }
+
+    /**
+     * @brief Get the position of the operator in input
+     */
+    size_t getPosition() const noexcept { return position_; }
 
     /**
      * @brief Get the right operand
@@ -111,15 +326,25 @@ public:
     std::unique_ptr<ASTNode> clone() const override;
     void accept(ASTVisitor& visitor) override;
     std::string toString() const override;
+    size_t getChildCount() const noexcept override { return 2; }
+    ASTNode* getChild(size_t index) const noexcept override {
+        return index == 0 ? left_.get() : right_.get();
+    }
+
+protected:
+    void detachChildren(std::vector<std::unique_ptr<ASTNode>>& out) override;
 
 private:
     std::unique_ptr<ASTNode> left_;
-    Token op_;
     std::unique_ptr<ASTNode> right_;
+    size_t position_;
+    OpCode op_;
 };
 
 /**
  * @brief Represents a unary operation (e.g., -x, +x)
+ *
+ * Only the opcode and source position of the operator are stored.
  */
 class UnaryOpNode : public ASTNode {
 public:
@@ -127,13 +352,34 @@ public:
      * @brief Construct a unary operation node
      * @param op The operator token
      * @param operand The operand
+     * @note The token's opcode is normalized to its prefix form (e.g. SUB becomes NEG)
+     */
+    UnaryOpNode(const Token& op, std::unique_ptr<ASTNode> operand);
+
+    /**
+     * @brief Construct a unary operation node
+     * @param op The operator classification, normalized to its prefix form
+     * @param position The position of the operator in input
+     * @param operand The operand
+     */
+    UnaryOpNode(OpCode op, size_t position, std::unique_ptr<ASTNode> operand);
+
+    ~UnaryOpNode() override;
+
+    /**
+     * @brief Get the operator as a token rebuilt from the stored opcode and position
+     */
+    Token getOperator() const;
+
+    /**
+     * @brief Get the operator classification (PLUS, NEG, BIT_NOT or NONE)
      */
-    UnaryOpNode(Token op, std::unique_ptr<ASTNode> operand);
+    OpCode getOpCode() const noexcept { return op_; }
 
     /**
-     * @brief Get the operator
+     * @brief Get the position of the operator in input
      */
-    const Token& getOperator() const noexcept { return op_; }
+    size_t getPosition() const noexcept { return position_; }
 
     /**
      * @brief Get the operand
@@ -149,10 +395,16 @@ public:
     std::unique_ptr<ASTNode> clone() const override;
     void accept(ASTVisitor& visitor) override;
     std::string toString() const override;
+    size_t getChildCount() const noexcept override { return 1; }
+    ASTNode* getChild(size_t) const noexcept override { return operand_.get(); }
+
+protected:
+    void detachChildren(std::vector<std::unique_ptr<ASTNode>>& out) override;
 
 private:
-    Token op_;
     std::unique_ptr<ASTNode> operand_;
+    size_t position_;
+    OpCode op_;
 };
 
 /**
@@ -169,6 +421,16 @@ public:
     FunctionCallNode(const std::string& name, size_t position,
                      std::vector<std::unique_ptr<ASTNode>> args);
 
+    /**
+     * @brief Construct a function call node
+     * @param name The function name
+     * @param position The position of function name in input
+     * @param args Argument nodes; the list keeps its allocator (and arena)
+     */
+    FunctionCallNode(const std::string& name, size_t position, ASTNodeList args);
+
+    ~FunctionCallNode() override;
+
     /**
      * @brief Get the function name
      */
@@ -194,7 +456,7 @@ public:
     /**
      * @brief Get all arguments
      */
-    const std::vector<std::unique_ptr<ASTNode>>& getArguments() const noexcept { return args_; }
+    const ASTNodeList& getArguments() const noexcept { return args_; }
 
     /**
      * @brief Release all arguments (for transfer of ownership)
@@ -205,11 +467,16 @@ public:
     std::unique_ptr<ASTNode> clone() const override;
     void accept(ASTVisitor& visitor) override;
     std::string toString() const override;
+    size_t getChildCount() const noexcept override { return args_.size(); }
+    ASTNode* getChild(size_t index) const noexcept override { return args_[index].get(); }
+
+protected:
+    void detachChildren(std::vector<std::unique_ptr<ASTNode>>& out) override;
 
 private:
     std::string name_;
     size_t position_;
-    std::vector<std::unique_ptr<ASTNode>> args_;
+    ASTNodeList args_;
 };
 
 /**
@@ -223,11 +490,50 @@ public:
     virtual ~ASTVisitor() = default;
 
     virtual void visit(LiteralNode& node) = 0;
+    virtual void visit(VariableNode& node) = 0;
     virtual void visit(BinaryOpNode& node) = 0;
     virtual void visit(UnaryOpNode& node) = 0;
     virtual void visit(FunctionCallNode& node) = 0;
 };
 
+/**
+ * @brief Visits every node of a tree after its children, without recursion
+ *
+ * The walker keeps its own stack of pending nodes, so a tree of any depth
+ * is walked in memory proportional to its depth, on the heap. Each node
+ * is passed to the visitor after all of its children, left to right;
+ * visitors that compute a value per node keep their own stack of child
+ * results and pop a node's operands when the node itself is visited.
+ *
+ * A walker reuses its stack across calls. It is not thread-safe, and a
+ * visitor must not start another walk on the same walker.
+ */
+class PostOrderWalker {
+public:
+    /**
+     * @brief Visit every node of a tree in post-order
+     * @param root The root of the tree
+     * @param visitor The visitor to call for each node
+     * @return false if the visitor called stop() before the walk finished
+     */
+    bool walk(ASTNode& root, ASTVisitor& visitor);
+
+    /**
+     * @brief End the current walk after the node being visited
+     */
+    void stop() noexcept { stopped_ = true; }
+
+private:
+    struct Frame {
+        ASTNode* node;       ///< Node whose children are being visited
+        size_t nextChild;    ///< Index of the next child to visit
+        size_t childCount;   ///< node->getChildCount(), read once
+    };
+
+    std::vector<Frame> stack_;
+    bool stopped_ = false;
+};
+
 } // namespace calc
 
 #endif // CALC_CORE_AST_H
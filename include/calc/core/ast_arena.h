@@ -0,0 +1,135 @@
+/**
+ * @file ast_arena.h
+ * @brief Bump allocator for AST nodes
+ */
+
+#ifndef CALC_CORE_AST_ARENA_H
+#define CALC_CORE_AST_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace calc {
+
+/**
+ * @brief Bump allocator that hands out memory from large blocks
+ *
+ * Allocation advances a cursor inside the current block; nothing is
+ * returned to the system until the arena itself is destroyed, which
+ * frees every block at once. Parsers use an arena to place all nodes of
+ * one tree next to each other (see Parser::parseToArena()).
+ *
+ * An arena is not thread-safe.
+ */
+class ASTArena {
+public:
+    /// Size of the first block; later blocks double up to MAX_BLOCK_SIZE
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
+    /// Largest block allocated for ordinary requests
+    static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+    /**
+     * @brief Construct an empty arena (no block is allocated until first use)
+     * @param blockSize Size of the first block in bytes
+     */
+    explicit ASTArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+
+    /**
+     * @brief Allocate memory from the current block, starting a new one if needed
+     * @param size Number of bytes
+     * @param alignment Required alignment (a power of two)
+     * @return Pointer to uninitialized memory owned by the arena
+     * @throws std::bad_alloc if a new block cannot be allocated
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * @brief Get the number of bytes handed out, including alignment padding
+     */
+    size_t getBytesUsed() const noexcept { return bytesUsed_; }
+
+    /**
+     * @brief Get the number of bytes reserved in blocks
+     */
+    size_t getBytesReserved() const noexcept { return bytesReserved_; }
+
+    /**
+     * @brief Get the number of blocks allocated so far
+     */
+    size_t getBlockCount() const noexcept { return blocks_.size(); }
+
+private:
+    std::vector<std::unique_ptr<unsigned char[]>> blocks_;
+    unsigned char* cursor_;
+    unsigned char* end_;
+    size_t nextBlockSize_;
+    size_t bytesUsed_;
+    size_t bytesReserved_;
+};
+
+/**
+ * @brief Standard allocator drawing from an ASTArena, or the heap without one
+ *
+ * Deallocation is a no-op for arena memory. Two allocators compare
+ * equal when they use the same arena.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    /**
+     * @brief Construct an allocator using the heap
+     */
+    ArenaAllocator() noexcept : arena_(nullptr) {}
+
+    /**
+     * @brief Construct an allocator
+     * @param arena The arena to allocate from (nullptr = heap)
+     */
+    explicit ArenaAllocator(ASTArena* arena) noexcept : arena_(arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.getArena()) {}
+
+    T* allocate(size_t n) {
+        if (arena_ != nullptr) {
+            return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t) noexcept {
+        if (arena_ == nullptr) {
+            ::operator delete(ptr);
+        }
+    }
+
+    /**
+     * @brief Get the arena this allocator draws from (nullptr = heap)
+     */
+    ASTArena* getArena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.getArena();
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ != other.getArena();
+    }
+
+private:
+    ASTArena* arena_;
+};
+
+} // namespace calc
+
+#endif // CALC_CORE_AST_ARENA_H
@@ -0,0 +1,130 @@
+/**
+ * @file ast_optimizer.h
+ * @brief AST rewriting pass: constant folding, strength reduction and simplification
+ */
+
+#ifndef CALC_CORE_AST_OPTIMIZER_H
+#define CALC_CORE_AST_OPTIMIZER_H
+
+#include "calc/core/ast.h"
+#include "calc/core/evaluator.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace calc {
+
+/**
+ * @brief Options controlling which rewrites ASTOptimizer may apply
+ */
+struct OptimizerOptions {
+    /**
+     * @brief Allow rewrites that are not exact in every case
+     *
+     * Enables dropping identities (x + 0, x - 0, x * 1, x / 1, x ^ 1),
+     * dividing by a constant as multiplying by its reciprocal, and
+     * expanding small integer powers into multiplications. These may
+     * differ from the unoptimized expression in the last bit, in the
+     * sign of a zero, or by returning NaN where a NaN operand would have
+     * raised DOMAIN_ERROR.
+     */
+    bool fastMath = false;
+
+    /// Largest |n| for which x ^ n is expanded into multiplications (fast-math only)
+    int maxExpandedExponent = 16;
+};
+
+/**
+ * @brief Counters reported by ASTOptimizer
+ */
+struct OptimizationStats {
+    size_t nodesBefore = 0;        ///< Nodes in the input tree
+    size_t nodesAfter = 0;         ///< Nodes in the optimized tree
+    size_t constantsFolded = 0;    ///< Subtrees replaced by a literal
+    size_t strengthReduced = 0;    ///< Powers and divisions replaced by multiplications
+    size_t identitiesRemoved = 0;  ///< Operations removed because they leave the operand unchanged
+};
+
+/**
+ * @brief Rewrites an AST into an equivalent, cheaper tree
+ *
+ * The default rewrites are exact: evaluating the optimized tree gives the
+ * same values, error codes and error positions as the original.
+ *
+ * - Operators and pure functions whose operands are all constants are
+ *   evaluated once with EvaluatorVisitor and replaced by a literal. A
+ *   subtree whose evaluation fails is kept, so the error is still raised
+ *   (with its position) when the expression is evaluated.
+ * - Names that are neither variables nor batch columns and resolve to a
+ *   pure zero-argument function (PI, E) are folded the same way.
+ * - x ^ 2 becomes x * x when x is a variable and ^ means power.
+ * - Unary plus is removed.
+ *
+ * Further rewrites are enabled by OptimizerOptions::fastMath.
+ *
+ * Names are resolved against the context when optimize() runs, as in
+ * CompiledExpression::compile(): defining a variable named like a folded
+ * constant afterwards does not affect an already optimized tree.
+ *
+ * @code
+ *   ASTOptimizer optimizer(context);
+ *   std::unique_ptr<ASTNode> optimized = optimizer.optimize(*ast);
+ *   const OptimizationStats& stats = optimizer.getStats();
+ * @endcode
+ */
+class ASTOptimizer : public ASTVisitor {
+public:
+    /**
+     * @brief Construct an optimizer
+     * @param context The context providing functions, variables and operator
+     *        semantics; it is only read, but folding calls its functions
+     * @param options Rewrites to enable
+     */
+    explicit ASTOptimizer(const EvaluationContext& context, OptimizerOptions options = {});
+
+    /**
+     * @brief Build an optimized copy of a tree
+     * @param root The root node of the expression (left unchanged)
+     * @param columns Names bound to batch input columns; these are never folded
+     * @return The optimized tree
+     */
+    std::unique_ptr<ASTNode> optimize(const ASTNode& root,
+                                      const std::vector<std::string>& columns = {});
+
+    /**
+     * @brief Get the counters of the last optimize() call
+     */
+    const OptimizationStats& getStats() const noexcept { return stats_; }
+
+    /**
+     * @brief Count the nodes of a tree
+     * @param root The root node
+     * @return The number of nodes, including the root
+     */
+    static size_t countNodes(const ASTNode& root);
+
+    // ASTVisitor implementation
+    void visit(LiteralNode& node) override;
+    void visit(VariableNode& node) override;
+    void visit(BinaryOpNode& node) override;
+    void visit(UnaryOpNode& node) override;
+    void visit(FunctionCallNode& node) override;
+
+private:
+    const EvaluationContext& context_;
+    OptimizerOptions options_;
+    const std::vector<std::string>* columns_;
+    OptimizationStats stats_;
+    std::vector<std::unique_ptr<ASTNode>> results_;  ///< Optimized subtrees not yet consumed, innermost last
+
+    std::unique_ptr<ASTNode> popResult();
+    std::unique_ptr<ASTNode> fold(std::unique_ptr<ASTNode> node);
+    std::unique_ptr<ASTNode> simplifyBinary(std::unique_ptr<BinaryOpNode> node);
+    std::unique_ptr<ASTNode> expandPower(const ASTNode& base, long long exponent, const Token& op);
+    bool isColumn(const std::string& name) const;
+    bool isPowerOperator(const BinaryOpNode& node) const;
+};
+
+} // namespace calc
+
+#endif // CALC_CORE_AST_OPTIMIZER_H
@@ -0,0 +1,354 @@
+/**
+ * @file compiled_expression.h
+ * @brief Bytecode compiler and register VM for repeated evaluation
+ */
+
+#ifndef CALC_CORE_COMPILED_EXPRESSION_H
+#define CALC_CORE_COMPILED_EXPRESSION_H
+
+#include "calc/core/ast.h"
+#include "calc/core/evaluator.h"
+#include "calc/core/expression_dag.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace calc {
+
+/**
+ * @brief Operation codes understood by the VirtualMachine
+ *
+ * Operators are resolved when the AST is lowered, so the VM never
+ * compares operator strings or queries operator semantics at run time.
+ */
+enum class BytecodeOp : uint8_t {
+    LOAD_CONST,  ///< r[a] = constant
+    LOAD_VAR,    ///< r[a] = context variable in slot imm
+    LOAD_COLUMN, ///< r[a] = batch column imm at the current row
+    ADD,         ///< r[a] = r[a] + r[b]
+    SUB,         ///< r[a] = r[a] - r[b]
+    MUL,         ///< r[a] = r[a] * r[b]
+    DIV,         ///< r[a] = r[a] / r[b]
+    MOD,         ///< r[a] = fmod(r[a], r[b])
+    POW,         ///< r[a] = pow(r[a], r[b])
+    BIT_AND,     ///< r[a] = r[a] & r[b] (as integers)
+    BIT_OR,      ///< r[a] = r[a] | r[b] (as integers)
+    BIT_XOR,     ///< r[a] = r[a] ^ r[b] (as integers)
+    SHL,         ///< r[a] = r[a] << r[b] (as integers)
+    SHR,         ///< r[a] = r[a] >> r[b] (as integers)
+    NEG,         ///< r[a] = -r[a]
+    BIT_NOT,     ///< r[a] = ~r[a] (as integer)
+    CALL,        ///< r[a] = function(r[a] .. r[a + b - 1])
+    COPY,        ///< r[a] = r[b]
+    FAIL         ///< Raise a deferred compile-time error
+};
+
+/**
+ * @brief A single VM instruction
+ *
+ * Register operands are indices into the VM register file. The immediate
+ * holds either a constant value (LOAD_CONST), a variable slot or column
+ * index (LOAD_VAR, LOAD_COLUMN), or an index into the function or error
+ * table (CALL, FAIL).
+ */
+struct Instruction {
+    uint32_t a;         ///< Destination (and left operand) register
+    uint32_t b;         ///< Right operand register or argument count
+    union {
+        double value;   ///< Constant for LOAD_CONST
+        uint32_t index; ///< Variable slot, column, function or error table index
+    } imm;
+    BytecodeOp op;      ///< Operation to perform
+};
+
+/**
+ * @brief An AST lowered into a flat instruction array
+ *
+ * Registers are allocated by expression depth, so the register file is
+ * as small as the deepest operand stack the expression needs, plus one
+ * register per shared node when compiled from an ExpressionDag. Function
+ * calls and variables are resolved to function entries and slots of the
+ * EvaluationContext used for compilation; that context must outlive the
+ * compiled expression. Calls with the wrong number of arguments compile
+ * to FAIL. Variable values are read at run time, so reassigning a
+ * variable does not require recompiling, but names must be defined
+ * before compile().
+ *
+ * @code
+ *   context.setVariable("x", 2.0);
+ *   CompiledExpression program = CompiledExpression::compile(*ast, context);
+ *   VirtualMachine vm;
+ *   EvaluationResult result = vm.execute(program);
+ * @endcode
+ */
+class CompiledExpression {
+public:
+    /**
+     * @brief Resolved function reference used by CALL instructions
+     */
+    struct FunctionRef {
+        const FunctionEntry* entry;  ///< Entry owned by the context
+        std::string name;            ///< Function name (for error messages)
+    };
+
+    /**
+     * @brief Error deferred to run time by FAIL instructions
+     */
+    struct DeferredError {
+        ErrorCode code;       ///< Error code to report
+        std::string message;  ///< Error message to report
+    };
+
+    /**
+     * @brief Lower an AST into bytecode
+     * @param root The root node of the expression
+     * @param context The context providing functions, variables and operator semantics
+     * @param columns Names bound to batch input columns, in the order they
+     *        will be passed to VirtualMachine::executeBatch(); these shadow
+     *        context variables of the same name
+     * @return The compiled expression
+     */
+    static CompiledExpression compile(const ASTNode& root, const EvaluationContext& context,
+                                      const std::vector<std::string>& columns = {});
+
+    /**
+     * @brief Lower a hash-consed DAG into bytecode
+     *
+     * Each shared node is computed once per run: its value is copied
+     * into a register of its own and copied back wherever the node
+     * occurs again. Values and errors are the same as compiling the
+     * tree the DAG was built from.
+     *
+     * @param dag The DAG, built against @p context
+     * @param context The context providing functions, variables and operator semantics
+     * @param columns Names bound to batch input columns, as for compile(const ASTNode&, ...)
+     * @return The compiled expression
+     */
+    static CompiledExpression compile(const ExpressionDag& dag, const EvaluationContext& context,
+                                      const std::vector<std::string>& columns = {});
+
+    /**
+     * @brief Get the instruction stream
+     */
+    const std::vector<Instruction>& getInstructions() const noexcept { return instructions_; }
+
+    /**
+     * @brief Get the input position associated with an instruction
+     * @param index The instruction index
+     */
+    size_t getPosition(size_t index) const noexcept { return positions_[index]; }
+
+    /**
+     * @brief Get the resolved function table
+     */
+    const std::vector<FunctionRef>& getFunctions() const noexcept { return functions_; }
+
+    /**
+     * @brief Get the table of deferred errors
+     */
+    const std::vector<DeferredError>& getErrors() const noexcept { return errors_; }
+
+    /**
+     * @brief Get the number of registers needed to run this expression
+     */
+    size_t getRegisterCount() const noexcept { return registerCount_; }
+
+    /**
+     * @brief Get the number of batch columns the expression was compiled against
+     */
+    size_t getColumnCount() const noexcept { return columnCount_; }
+
+    /**
+     * @brief Get the context whose variables LOAD_VAR reads
+     */
+    const EvaluationContext* getContext() const noexcept { return context_; }
+
+private:
+    friend class ExpressionCompiler;
+
+    CompiledExpression() = default;
+
+    std::vector<Instruction> instructions_;
+    std::vector<size_t> positions_;        ///< Parallel to instructions_, read on error paths only
+    std::vector<FunctionRef> functions_;
+    std::vector<DeferredError> errors_;
+    size_t registerCount_ = 0;
+    size_t columnCount_ = 0;
+    const EvaluationContext* context_ = nullptr;
+};
+
+/**
+ * @brief A named struct-of-arrays input column for batch evaluation
+ */
+struct BatchColumn {
+    std::string name;    ///< Variable name the column binds
+    const double* data;  ///< One value per row, owned by the caller
+};
+
+/**
+ * @brief Outcome of evaluating one expression over many rows
+ *
+ * A failing row does not stop the batch: its output is set to NaN and
+ * the first failure is kept for reporting.
+ */
+struct BatchResult {
+    size_t rows = 0;            ///< Rows written to the output buffer
+    size_t failedRows = 0;      ///< Rows whose evaluation failed
+    size_t firstFailedRow = 0;  ///< Index of the first failed row (if any)
+    std::optional<EvaluationResult> firstError;  ///< Error of the first failed row
+
+    /**
+     * @brief Check whether every row evaluated successfully
+     */
+    bool isSuccess() const noexcept { return failedRows == 0; }
+};
+
+/**
+ * @brief Instruction set used by VirtualMachine::executeBatch()
+ */
+enum class SimdLevel : uint8_t {
+    SCALAR,  ///< Interpret the program once per row
+    SSE2,    ///< Block kernels using 128-bit vectors (2 doubles)
+    AVX2,    ///< Block kernels using 256-bit vectors (4 doubles)
+    AVX512   ///< Block kernels using 512-bit vectors (8 doubles)
+};
+
+/**
+ * @brief Convert a SIMD level to its display name
+ */
+std::string simdLevelToString(SimdLevel level);
+
+/**
+ * @brief Check whether this build and CPU can run a SIMD level
+ *
+ * SCALAR is always supported. The vector levels require an x86 CPU and
+ * a GCC-compatible compiler; other builds fall back to SCALAR.
+ */
+bool isSimdLevelSupported(SimdLevel level) noexcept;
+
+/**
+ * @brief Get the widest SIMD level supported by this build and CPU
+ */
+SimdLevel detectSimdLevel() noexcept;
+
+struct BatchKernels;
+
+/**
+ * @brief Register machine that executes CompiledExpression programs
+ *
+ * Produces the same values, error codes and error positions as
+ * EvaluatorVisitor, which remains the reference implementation.
+ * The register file and call argument buffer are reused between runs,
+ * so steady-state evaluation performs no heap allocation.
+ *
+ * Batch evaluation above SimdLevel::SCALAR runs each instruction over a
+ * block of rows with kernels compiled for the selected instruction set.
+ * Rows that may fail (zero divisors, non-finite results, operands outside
+ * the integer range of the bitwise operators) are re-run by the scalar
+ * interpreter, so errors are reported exactly as by execute(). Results
+ * are bit-identical to SimdLevel::SCALAR (0 ULP): the kernels perform
+ * the same IEEE operations in the same order and call the same <cmath>
+ * functions, one instruction at a time, so nothing is contracted or
+ * reassociated. Arithmetic, abs, sqrt, rounding and the range checks run
+ * on full vectors; pow, fmod and the transcendental functions are one
+ * libm call per row at every level.
+ */
+class VirtualMachine {
+public:
+    /// Rows processed per kernel call
+    static constexpr size_t BLOCK_ROWS = 256;
+
+    /**
+     * @brief Construct a VM using the widest supported SIMD level
+     */
+    VirtualMachine();
+
+    /**
+     * @brief Select the instruction set used by executeBatch()
+     * @param level The SIMD level
+     * @throws std::invalid_argument if the level is not supported
+     */
+    void setSimdLevel(SimdLevel level);
+
+    /**
+     * @brief Get the instruction set used by executeBatch()
+     */
+    SimdLevel getSimdLevel() const noexcept { return simdLevel_; }
+
+    /**
+     * @brief Run a compiled expression
+     * @param program The program to run
+     * @return The evaluation result
+     */
+    EvaluationResult execute(const CompiledExpression& program);
+
+    /**
+     * @brief Run a compiled expression once per row over input columns
+     * @param program The program, compiled with the column names in this order
+     * @param columns One pointer per compiled column, each with at least @p rows values
+     * @param rows Number of rows to evaluate
+     * @param out Output buffer with room for @p rows values
+     * @return Row and error counts; failed rows are written as NaN
+     */
+    BatchResult executeBatch(const CompiledExpression& program,
+                             const std::vector<const double*>& columns,
+                             size_t rows, double* out);
+
+    /**
+     * @brief Compile an expression against named columns and run it over them
+     * @param root The root node of the expression
+     * @param context The context providing functions, variables and operator semantics
+     * @param columns Input columns, each with at least @p rows values
+     * @param rows Number of rows to evaluate
+     * @param out Output buffer with room for @p rows values
+     * @return Row and error counts; failed rows are written as NaN
+     */
+    BatchResult evaluateBatch(const ASTNode& root, const EvaluationContext& context,
+                              const std::vector<BatchColumn>& columns,
+                              size_t rows, double* out);
+
+    /**
+     * @brief Report one error for every row of a batch
+     * @param error The error, e.g. from parsing the expression
+     * @param rows Number of rows in the batch
+     * @param out Output buffer; every row is set to NaN
+     * @return A result with all rows failed
+     */
+    static BatchResult failBatch(EvaluationResult error, size_t rows, double* out);
+
+private:
+    std::vector<double> registers_;
+    std::vector<double> callArgs_;                 ///< Arguments of CALLBACK functions
+    std::vector<double> blockRegisters_;           ///< registerCount x BLOCK_ROWS
+    std::vector<uint8_t> blockFlags_;              ///< Rows to re-run with the scalar interpreter
+    SimdLevel simdLevel_;
+
+    /**
+     * @brief Run the program for one row, leaving the value in registers_[0]
+     * @return std::nullopt on success, otherwise the error
+     */
+    std::optional<EvaluationResult> run(const CompiledExpression& program,
+                                        const double* variables,
+                                        const double* const* columns, size_t row);
+
+    /**
+     * @brief Run the program over rows [start, start + count) in block registers
+     *
+     * Leaves the values in the first block register and marks rows that
+     * must be re-run with run() in blockFlags_.
+     */
+    void runBlock(const CompiledExpression& program, const BatchKernels& kernels,
+                  const double* variables, const double* const* columns,
+                  size_t start, size_t count);
+
+    /**
+     * @brief Run one row with the scalar interpreter and store its outcome
+     */
+    void finishRow(const CompiledExpression& program, const double* variables,
+                   const double* const* columns, size_t row, double* out, BatchResult& result);
+};
+
+} // namespace calc
+
+#endif // CALC_CORE_COMPILED_EXPRESSION_H
@@ -9,10 +9,13 @@
 #include "calc/core/ast.h"
 #include "calc/utils/error.h"
 #include <cmath>
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace calc {
 
@@ -109,6 +112,114 @@ private:
     std::variant<Success, Error> data_;
 };
 
+/**
+ * @brief Callback signature for functions registered in an EvaluationContext
+ *
+ * Such callbacks accept any number of arguments and check the count
+ * themselves. They are kept for custom functions; built-ins use the plain
+ * function pointer signatures below, which are called without building
+ * an argument vector.
+ */
+using FunctionCallback = std::function<double(const std::vector<double>&)>;
+
+/// Function taking no arguments (constants such as PI)
+using NullaryFunction = double (*)();
+
+/// Function taking exactly one argument
+using UnaryFunction = double (*)(double);
+
+/// Function taking exactly two arguments
+using BinaryFunction = double (*)(double, double);
+
+/// Function taking a contiguous range of arguments
+using VariadicFunction = double (*)(const double* args, size_t count);
+
+/**
+ * @brief Identifies a built-in one-argument math function
+ *
+ * Functions registered with a tag other than NONE promise to compute the
+ * same value as the matching <cmath> function, and to fail only where that
+ * function returns NaN or infinity. Batch evaluation relies on this to
+ * apply the function to a whole block of rows at once.
+ */
+enum class BuiltinFunction : uint8_t {
+    NONE,
+    SIN, COS, TAN, ASIN, ACOS, ATAN,
+    SINH, COSH, TANH,
+    LOG, LOG10, EXP, SQRT, CBRT,
+    ABS, FLOOR, CEIL, ROUND, TRUNC,
+    COUNT_  ///< Number of tags (not a function)
+};
+
+/**
+ * @brief How a registered function is called
+ */
+enum class FunctionArity : uint8_t {
+    NULLARY,   ///< NullaryFunction, no arguments
+    UNARY,     ///< UnaryFunction, one argument
+    BINARY,    ///< BinaryFunction, two arguments
+    VARIADIC,  ///< VariadicFunction, at least FunctionEntry::minArgs arguments
+    CALLBACK   ///< FunctionCallback, any number of arguments
+};
+
+/**
+ * @brief A function registered in an EvaluationContext
+ *
+ * Fixed-arity entries let callers reject a wrong argument count once,
+ * when an expression is compiled or a call is bound, and then call the
+ * function pointer directly with arguments read in place.
+ */
+struct FunctionEntry {
+    FunctionArity arity = FunctionArity::CALLBACK;
+    union {
+        NullaryFunction nullary;
+        UnaryFunction unary;
+        BinaryFunction binary;
+        VariadicFunction variadic;
+    } fn{};                            ///< Entry point of non-CALLBACK functions
+    FunctionCallback callback;         ///< Entry point of CALLBACK functions
+    size_t minArgs = 0;                ///< Fewest arguments a VARIADIC function accepts
+    BuiltinFunction builtin = BuiltinFunction::NONE;
+    bool pure = false;                 ///< Same arguments always give the same value
+
+    /**
+     * @brief Check whether a call with this many arguments is valid
+     */
+    bool acceptsArgumentCount(size_t count) const noexcept {
+        switch (arity) {
+            case FunctionArity::NULLARY:  return count == 0;
+            case FunctionArity::UNARY:    return count == 1;
+            case FunctionArity::BINARY:   return count == 2;
+            case FunctionArity::VARIADIC: return count >= minArgs;
+            default:                      return true;
+        }
+    }
+
+    /**
+     * @brief Describe a rejected call, e.g. "sin requires exactly 1 argument"
+     * @param name The name the function was called by
+     */
+    std::string arityMessage(const std::string& name) const;
+
+    /**
+     * @brief Call the function
+     * @param args Arguments, contiguous in memory
+     * @param count Number of arguments; must satisfy acceptsArgumentCount()
+     * @return The function's value
+     * @throws Whatever the function throws to report a domain error
+     * @note Only CALLBACK functions allocate, to build their argument vector
+     */
+    double invoke(const double* args, size_t count) const {
+        switch (arity) {
+            case FunctionArity::NULLARY:  return fn.nullary();
+            case FunctionArity::UNARY:    return fn.unary(args[0]);
+            case FunctionArity::BINARY:   return fn.binary(args[0], args[1]);
+            case FunctionArity::VARIADIC: return fn.variadic(args, count);
+            default:                      return callback(std::vector<double>(args, args + count));
+        }
+    }
+};
+
 /**
  * @brief Context for evaluation operations
  *
@@ -146,8 +257,74 @@ public:
      * @brief Add a custom function to the context
      * @param name The function name
      * @param callback The function callback
+     * @param builtin Built-in tag; replacing a function without one clears its tag
+     * @param pure Whether the function always returns the same value for the
+     *        same arguments, so calls with constant arguments may be folded
+     *        (implied by a built-in tag)
+     */
+    void addFunction(const std::string& name, FunctionCallback callback,
+                     BuiltinFunction builtin = BuiltinFunction::NONE, bool pure = false);
+
+    /**
+     * @brief Add a function taking no arguments
+     * @param name The function name
+     * @param function The function
+     * @param pure Whether calls may be evaluated ahead of time
+     */
+    void addFunction(const std::string& name, NullaryFunction function, bool pure = false);
+
+    /**
+     * @brief Add a function taking exactly one argument
+     * @param name The function name
+     * @param function The function
+     * @param builtin Built-in tag; replacing a function without one clears its tag
+     * @param pure Whether calls with constant arguments may be folded
+     *        (implied by a built-in tag)
+     */
+    void addFunction(const std::string& name, UnaryFunction function,
+                     BuiltinFunction builtin = BuiltinFunction::NONE, bool pure = false);
+
+    /**
+     * @brief Add a function taking exactly two arguments
+     * @param name The function name
+     * @param function The function
+     * @param pure Whether calls with constant arguments may be folded
+     */
+    void addFunction(const std::string& name, BinaryFunction function, bool pure = false);
+
+    /**
+     * @brief Add a function taking a variable number of arguments
+     * @param name The function name
+     * @param function The function
+     * @param minArgs Fewest arguments accepted
+     * @param pure Whether calls with constant arguments may be folded
      */
-    void addFunction(const std::string& name, std::function<double(const std::vector<double>&)> callback);
+    void addVariadicFunction(const std::string& name, VariadicFunction function,
+                             size_t minArgs, bool pure = false);
+
+    /**
+     * @brief Check whether a function is registered as pure
+     * @param name The function name
+     * @return true if calls with constant arguments may be evaluated ahead of time
+     */
+    bool isPureFunction(const std::string& name) const;
+
+    /**
+     * @brief Get the built-in tag of a function
+     * @param name The function name
+     * @return The tag, or BuiltinFunction::NONE for custom or unknown functions
+     */
+    BuiltinFunction findBuiltin(const std::string& name) const;
+
+    /**
+     * @brief Look up a function by name
+     * @param name The function name
+     * @return Pointer to the registered entry, or nullptr if not found
+     * @note The pointer stays valid for the lifetime of the context;
+     *       re-registering a name, built-ins included, replaces the entry
+     *       in place.
+     */
+    const FunctionEntry* findFunction(const std::string& name) const;
 
     /**
      * @brief Call a function by name
@@ -155,7 +332,61 @@ public:
      * @param args The function arguments
      * @return Evaluation result
      */
-    EvaluationResult callFunction(const std::string& name, const std::vector<double>& args);
+    EvaluationResult callFunction(const std::string& name, const std::vector<double>& args) const;
+
+    /**
+     * @brief Call a resolved function, checking the argument count first
+     * @param entry The function, as returned by findFunction()
+     * @param name The name it was called by (for error messages)
+     * @param args Arguments, contiguous in memory
+     * @param count Number of arguments
+     * @return Evaluation result; exceptions thrown by the function become errors
+     */
+    static EvaluationResult callFunction(const FunctionEntry& entry, const std::string& name,
+                                         const double* args, size_t count);
+
+    /// Returned by findVariableSlot() for names that are not variables
+    static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+    /**
+     * @brief Assign a variable, creating it if needed
+     * @param name The variable name
+     * @param value The value to assign
+     * @return The variable's slot, stable for the lifetime of the context
+     */
+    size_t setVariable(const std::string& name, double value);
+
+    /**
+     * @brief Check if a variable is defined
+     * @param name The variable name
+     * @return true if the variable has been assigned
+     */
+    bool hasVariable(const std::string& name) const;
+
+    /**
+     * @brief Look up the slot of a variable
+     * @param name The variable name
+     * @return The slot index, or NO_SLOT if the variable is not defined
+     */
+    size_t findVariableSlot(const std::string& name) const;
+
+    /**
+     * @brief Get a variable's value by slot
+     * @param slot A slot returned by setVariable() or findVariableSlot()
+     */
+    double getVariable(size_t slot) const noexcept { return variables_[slot]; }
+
+    /**
+     * @brief Assign a variable by slot, without a name lookup
+     * @param slot A slot returned by setVariable() or findVariableSlot()
+     * @param value The value to assign
+     */
+    void setVariable(size_t slot, double value) noexcept { variables_[slot] = value; }
+
+    /**
+     * @brief Get all variable values, indexed by slot
+     */
+    const std::vector<double>& getVariables() const noexcept { return variables_; }
 
     /**
      * @brief Get the semantics for a specific operator
@@ -171,10 +402,29 @@ public:
      */
     void setOperatorSemantics(const std::string& op, OperatorSemantics semantics);
 
+    /**
+     * @brief Get a counter that advances whenever names could bind differently
+     *
+     * Adding or replacing a function, creating a variable, setting an
+     * operator's semantics and registering the built-ins advance it;
+     * assigning an existing variable does not. A CompiledExpression built
+     * at one revision is stale once the revision moves on.
+     */
+    uint64_t getBindingRevision() const noexcept { return bindingRevision_; }
+
 private:
+    friend class MathFunctions;
+
+    // Store a function, replacing a registered one of the same name in place
+    void storeFunction(const std::string& name, FunctionEntry entry);
+
     int precision_;
-    std::unordered_map<std::string, std::function<double(const std::vector<double>&)>> functions_;
+    std::vector<FunctionEntry> builtins_;  ///< Built-ins in MathFunctions table order, empty until registered
+    std::unordered_map<std::string, FunctionEntry> functions_;  ///< Functions added by name
     std::unordered_map<std::string, OperatorSemantics> operatorSemantics_;
+    std::unordered_map<std::string, size_t> variableSlots_;
+    std::vector<double> variables_;  ///< Values indexed by slot
+    uint64_t bindingRevision_ = 0;   ///< See getBindingRevision()
 };
 
 /**
@@ -193,7 +443,7 @@ public:
      * @param context The evaluation context
      * @return The evaluation result
      */
-    virtual EvaluationResult evaluate(const ASTNode* node, EvaluationContext& context) = 0;
+    virtual EvaluationResult evaluate(const ASTNode* node, const EvaluationContext& context) = 0;
 
     /**
      * @brief Evaluate an AST node with default context
@@ -208,6 +458,14 @@ public:
  *
  * Traverses the AST using the Visitor pattern and evaluates expressions.
  * Handles arithmetic operators, function calls, and error conditions.
+ *
+ * Nodes are visited in post-order by a PostOrderWalker: each node pops
+ * its operands' values off a value stack and pushes its own, so the
+ * depth of the tree is limited by memory rather than the call stack.
+ * Evaluation stops at the first error, which is the result.
+ *
+ * The visitor keeps per-evaluation state, so each thread needs its own;
+ * the context is only read, so visitors on several threads may share one.
  */
 class EvaluatorVisitor : public ASTVisitor, public Evaluator {
 public:
@@ -222,10 +480,11 @@ public:
      * @param context The evaluation context
      * @return The evaluation result
      */
-    EvaluationResult evaluate(const ASTNode* node, EvaluationContext& context) override;
+    EvaluationResult evaluate(const ASTNode* node, const EvaluationContext& context) override;
 
     // ASTVisitor implementation
     void visit(LiteralNode& node) override;
+    void visit(VariableNode& node) override;
     void visit(BinaryOpNode& node) override;
     void visit(UnaryOpNode& node) override;
     void visit(FunctionCallNode& node) override;
@@ -244,24 +503,33 @@ public:
 
 private:
     EvaluationResult result_;
-    EvaluationContext* context_;
+    const EvaluationContext* context_;
+    PostOrderWalker walker_;        ///< Visits operands before the nodes that use them
+    std::vector<double> values_;    ///< Values of visited subtrees not yet consumed, innermost last
+
+    /**
+     * @brief Stop the walk with an error as the result
+     */
+    void fail(EvaluationResult error);
 
     /**
      * @brief Perform binary operation
      * @param left Left operand value
      * @param op The operator
+     * @param position The position of the operator in input
      * @param right Right operand value
      * @return Result of the operation
      */
-    EvaluationResult evaluateBinaryOp(double left, const Token& op, double right);
+    EvaluationResult evaluateBinaryOp(double left, OpCode op, size_t position, double right);
 
     /**
      * @brief Perform unary operation
      * @param op The operator
+     * @param position The position of the operator in input
      * @param operand The operand value
      * @return Result of the operation
      */
-    EvaluationResult evaluateUnaryOp(const Token& op, double operand);
+    EvaluationResult evaluateUnaryOp(OpCode op, size_t position, double operand);
 
     /**
      * @brief Check if two doubles are approximately equal
@@ -277,16 +545,26 @@ private:
  * @brief Built-in mathematical functions for evaluation
  *
  * Provides standard mathematical functions that are available
- * in all evaluation contexts by default.
+ * in all evaluation contexts by default. They are defined once, in a
+ * constexpr table sorted by name, so registering them neither hashes
+ * names nor allocates per function.
  */
 class MathFunctions {
 public:
     /**
      * @brief Register all built-in math functions to a context
      * @param context The context to register functions to
+     * @note Copies the built-in table into one array in the context and
+     *       resets any function of the same name to its built-in.
      */
     static void registerBuiltInFunctions(EvaluationContext& context);
 
+    /**
+     * @brief Check whether a name is one of the built-in functions
+     * @param name The function name
+     */
+    static bool isBuiltInFunction(std::string_view name) noexcept;
+
     // Trigonometric functions
     static double sin(double x);
     static double cos(double x);
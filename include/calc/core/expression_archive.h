@@ -0,0 +1,206 @@
+/**
+ * @file expression_archive.h
+ * @brief Binary archives of parsed expressions, for loading without reparsing
+ */
+
+#ifndef CALC_CORE_EXPRESSION_ARCHIVE_H
+#define CALC_CORE_EXPRESSION_ARCHIVE_H
+
+#include "calc/core/ast.h"
+#include "calc/core/parser.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace calc {
+
+// On-disk record layouts, defined in expression_archive.cpp
+struct ArchiveExpressionRecord;
+struct ArchiveNodeRecord;
+
+/**
+ * @brief Collects parsed expressions and writes them as an archive
+ *
+ * The archive format (version 1) is a 32-byte header followed by five
+ * sections, each naturally aligned, in the byte order of the writing host:
+ *
+ *   - a constant pool of distinct literal values (double)
+ *   - one 16-byte record per expression: first node, node count and
+ *     source string
+ *   - the node stream: one 16-byte record per node, expressions one
+ *     after another, each in post-order (operands before operators)
+ *   - the string table: offsets into the bytes that follow
+ *   - the string bytes: names and source texts, each stored once
+ *
+ * A node record holds its kind, opcode, pool or string index, argument
+ * count and source position, so errors raised when evaluating a loaded
+ * tree point at the same place as errors from the parsed one.
+ *
+ * @code
+ *   ExpressionArchiveWriter writer;
+ *   for (const auto& formula : formulas) {
+ *       writer.add(*parser.parse(Tokenizer(formula).tokenize()), formula);
+ *   }
+ *   writer.save("formulas.cxa");
+ * @endcode
+ */
+class ExpressionArchiveWriter {
+public:
+    ExpressionArchiveWriter() = default;
+
+    /**
+     * @brief Append an expression
+     * @param root The root node of the parsed expression
+     * @param source The text it was parsed from, kept for lookup by source
+     * @return Index of the expression in the archive
+     * @throws CalculatorException if the archive would exceed the format's 32-bit limits
+     */
+    size_t add(const ASTNode& root, const std::string& source = std::string());
+
+    /**
+     * @brief Get the number of expressions added
+     */
+    size_t size() const noexcept { return expressions_.size(); }
+
+    /**
+     * @brief Get the archive as bytes
+     */
+    std::vector<unsigned char> serialize() const;
+
+    /**
+     * @brief Write the archive to a file
+     * @param path File to create or replace
+     * @throws CalculatorException if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+private:
+    friend class ArchiveNodeWriter;
+
+    struct Expression {
+        uint32_t firstNode;
+        uint32_t nodeCount;
+        uint32_t source;
+    };
+
+    struct Node {
+        uint8_t kind;
+        uint8_t op;
+        uint32_t operand;   ///< Constant index (literals) or string index (names)
+        uint32_t argCount;  ///< Arguments of calls
+        uint32_t position;
+    };
+
+    std::vector<double> constants_;
+    std::unordered_map<uint64_t, uint32_t> constantIndex_;  ///< By bit pattern
+    std::vector<Expression> expressions_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> stringOffsets_{0};
+    std::string stringBytes_;
+    std::unordered_map<std::string, uint32_t> stringIndex_;
+
+    uint32_t internConstant(double value);
+    uint32_t internString(const std::string& text);
+};
+
+/**
+ * @brief A read-only view of an expression archive
+ *
+ * open() maps the file into memory and reads the records in place; only
+ * load() builds anything, and it builds one tree at a time into a single
+ * arena, without reparsing and without an allocation per node. Loading
+ * walks the node stream with an explicit stack, so depth is not limited.
+ *
+ * The header, section sizes and string table are checked when the archive
+ * is opened; each expression's node stream is checked when it is loaded.
+ * An archive written by a different format version or on a host of the
+ * other byte order is rejected rather than converted.
+ *
+ * Copies share the underlying mapping, which stays valid until the last
+ * copy is destroyed. Loading from several threads at once is safe.
+ *
+ * @code
+ *   ExpressionArchive archive = ExpressionArchive::open("formulas.cxa");
+ *   for (size_t i = 0; i < archive.size(); ++i) {
+ *       ParsedExpression tree = archive.load(i);
+ *       // ... compile or evaluate *tree
+ *   }
+ * @endcode
+ */
+class ExpressionArchive {
+public:
+    /// Format version written by ExpressionArchiveWriter and accepted by open()
+    static constexpr uint16_t VERSION = 1;
+
+    /**
+     * @brief Construct an empty archive
+     */
+    ExpressionArchive() = default;
+
+    /**
+     * @brief Map an archive file
+     * @param path The file written by ExpressionArchiveWriter::save()
+     * @throws CalculatorException if the file cannot be read or is not a valid archive
+     */
+    static ExpressionArchive open(const std::string& path);
+
+    /**
+     * @brief Read an archive from bytes in memory
+     * @param bytes The archive, as returned by ExpressionArchiveWriter::serialize()
+     * @throws CalculatorException if the bytes are not a valid archive
+     */
+    static ExpressionArchive fromBuffer(std::vector<unsigned char> bytes);
+
+    /**
+     * @brief Get the number of expressions
+     */
+    size_t size() const noexcept { return expressionCount_; }
+
+    /**
+     * @brief Get the number of nodes in an expression
+     * @param index Expression index (must be below size())
+     */
+    size_t getNodeCount(size_t index) const noexcept;
+
+    /**
+     * @brief Get the source text stored with an expression
+     * @param index Expression index (must be below size())
+     * @return The text, empty if none was stored; valid while the archive is
+     */
+    std::string_view getSource(size_t index) const noexcept;
+
+    /**
+     * @brief Rebuild an expression tree
+     * @param index Expression index (must be below size())
+     * @return The tree, in its own arena
+     * @throws CalculatorException if the expression's node stream is malformed
+     */
+    ParsedExpression load(size_t index) const;
+
+private:
+    std::shared_ptr<const void> storage_;  ///< Keeps the mapping or buffer alive
+    const double* constants_ = nullptr;
+    const ArchiveExpressionRecord* expressions_ = nullptr;
+    const ArchiveNodeRecord* nodes_ = nullptr;
+    const uint32_t* stringOffsets_ = nullptr;
+    const char* strings_ = nullptr;
+    size_t expressionCount_ = 0;
+    size_t constantCount_ = 0;
+    size_t stringCount_ = 0;
+
+    /**
+     * @brief Validate the header and locate the sections
+     * @throws CalculatorException if the data is not a valid archive
+     */
+    static ExpressionArchive attach(std::shared_ptr<const void> storage,
+                                    const unsigned char* data, size_t size);
+
+    std::string_view getString(uint32_t index) const noexcept;
+};
+
+} // namespace calc
+
+#endif // CALC_CORE_EXPRESSION_ARCHIVE_H
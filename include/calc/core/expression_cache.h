@@ -0,0 +1,159 @@
+/**
+ * @file expression_cache.h
+ * @brief Bounded LRU cache of parsed expressions
+ */
+
+#ifndef CALC_CORE_EXPRESSION_CACHE_H
+#define CALC_CORE_EXPRESSION_CACHE_H
+
+#include "calc/core/ast.h"
+#include "calc/core/compiled_expression.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace calc {
+
+/**
+ * @brief Counters reported by ExpressionCache
+ */
+struct CacheStats {
+    size_t hits = 0;       ///< Lookups that found a parsed expression
+    size_t misses = 0;     ///< Lookups that had to tokenize and parse
+    size_t evictions = 0;  ///< Entries dropped to respect the capacity
+    size_t size = 0;       ///< Entries currently cached
+    size_t capacity = 0;   ///< Maximum number of entries (0 = disabled)
+};
+
+/**
+ * @brief A cached tree and, once a mode has compiled it, its bytecode
+ */
+struct CachedExpression {
+    std::shared_ptr<const ASTNode> ast;         ///< The parsed tree
+    std::optional<CompiledExpression> program;  ///< Bytecode, empty until compiled
+    uint64_t revision = 0;  ///< EvaluationContext::getBindingRevision() the program was compiled at
+};
+
+/**
+ * @brief Least-recently-used cache of parsed ASTs
+ *
+ * Entries are keyed by (mode name, parser type, expression text), so a
+ * mode that switches parsers, or several modes sharing one cache, never
+ * see each other's trees. Cached trees are immutable and shared, so a
+ * tree stays valid for a caller holding it even after it is evicted.
+ * An entry can also hold the tree's bytecode, which a mode compiles on
+ * first use and recompiles when its context's bindings change.
+ *
+ * Only successful parses are cached; inputs that fail to tokenize or
+ * parse are re-parsed each time so the error is reported the same way.
+ */
+class ExpressionCache {
+public:
+    /// Default number of entries kept by each mode
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    /**
+     * @brief Construct a cache
+     * @param capacity Maximum number of entries (0 disables caching)
+     */
+    explicit ExpressionCache(size_t capacity = DEFAULT_CAPACITY);
+
+    ExpressionCache(const ExpressionCache&) = delete;
+    ExpressionCache& operator=(const ExpressionCache&) = delete;
+
+    /**
+     * @brief Look up a parsed expression and mark it most recently used
+     * @param mode The mode name
+     * @param parser The parser type name
+     * @param expression The expression text
+     * @return The cached tree, or nullptr on a miss
+     */
+    std::shared_ptr<const ASTNode> find(const std::string& mode,
+                                        const std::string& parser,
+                                        const std::string& expression);
+
+    /**
+     * @brief Look up an entry and mark it most recently used
+     *
+     * The entry stays valid until the next insert(), setCapacity() or clear().
+     *
+     * @param mode The mode name
+     * @param parser The parser type name
+     * @param expression The expression text
+     * @return The cached entry, or nullptr on a miss
+     */
+    CachedExpression* lookup(const std::string& mode,
+                             const std::string& parser,
+                             const std::string& expression);
+
+    /**
+     * @brief Insert a parsed expression, evicting the least recently used entry if full
+     * @param mode The mode name
+     * @param parser The parser type name
+     * @param expression The expression text
+     * @param ast The parsed tree
+     * @return The new entry, valid as for lookup(), or nullptr if caching is disabled
+     */
+    CachedExpression* insert(const std::string& mode,
+                const std::string& parser,
+                const std::string& expression,
+                std::shared_ptr<const ASTNode> ast);
+
+    /**
+     * @brief Change the capacity, evicting entries that no longer fit
+     * @param capacity Maximum number of entries (0 disables caching)
+     */
+    void setCapacity(size_t capacity);
+
+    /**
+     * @brief Get the maximum number of entries
+     */
+    size_t getCapacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Get the number of cached entries
+     */
+    size_t size() const noexcept { return entries_.size(); }
+
+    /**
+     * @brief Remove all entries (counters are kept)
+     */
+    void clear();
+
+    /**
+     * @brief Get hit, miss and eviction counters
+     */
+    CacheStats getStats() const noexcept;
+
+    /**
+     * @brief Reset hit, miss and eviction counters to zero
+     */
+    void resetStats() noexcept;
+
+private:
+    struct Entry {
+        std::string key;
+        CachedExpression expression;
+    };
+
+    std::list<Entry> entries_;  ///< Most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;  ///< Views into Entry::key
+    std::string keyBuffer_;     ///< Reused to build lookup keys without allocating
+    size_t capacity_;
+    size_t hits_;
+    size_t misses_;
+    size_t evictions_;
+
+    const std::string& makeKey(const std::string& mode, const std::string& parser,
+                               const std::string& expression);
+    void evictToCapacity();
+};
+
+} // namespace calc
+
+#endif // CALC_CORE_EXPRESSION_CACHE_H
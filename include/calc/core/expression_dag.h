@@ -0,0 +1,128 @@
+/**
+ * @file expression_dag.h
+ * @brief Hash-consed expression DAG with common subexpression elimination
+ */
+
+#ifndef CALC_CORE_EXPRESSION_DAG_H
+#define CALC_CORE_EXPRESSION_DAG_H
+
+#include "calc/core/ast.h"
+#include "calc/core/evaluator.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace calc {
+
+/**
+ * @brief Counters reported by ExpressionDag::build()
+ */
+struct DagStats {
+    size_t treeNodes = 0;          ///< Nodes in the input tree
+    size_t dagNodes = 0;           ///< Distinct nodes after hash-consing
+    size_t nodesDeduplicated = 0;  ///< Tree nodes that became references to an existing node
+    size_t sharedNodes = 0;        ///< DAG nodes used by more than one parent
+};
+
+/**
+ * @brief An expression lowered into a directed acyclic graph
+ *
+ * Structurally identical pure subexpressions are hash-consed into a
+ * single node, so in sin(2*PI*x) + sin(2*PI*x)^2 the call and everything
+ * below it exist once. Literals, variables and operators are pure; a
+ * call, or a name that resolves to a function, is pure if the function
+ * registry says so (FunctionEntry::pure). Impure calls such as a random
+ * number generator are never merged, and neither is anything above them.
+ *
+ * Nodes are stored in the order their first occurrence completes in a
+ * post-order walk of the tree, which is a topological order: operands
+ * come before the nodes that use them, and the root is last. Evaluating
+ * the distinct nodes in that order gives the same values, and the same
+ * first error, as evaluating the tree.
+ *
+ * CompiledExpression::compile() accepts a DAG and evaluates each shared
+ * node once per run, reusing its value wherever it occurs again.
+ *
+ * @code
+ *   ExpressionDag dag = ExpressionDag::build(*ast, context);
+ *   CompiledExpression program = CompiledExpression::compile(dag, context);
+ *   size_t saved = dag.getStats().nodesDeduplicated;
+ * @endcode
+ */
+class ExpressionDag {
+public:
+    /**
+     * @brief Kind of a DAG node, one per AST node class
+     */
+    enum class Kind : uint8_t {
+        LITERAL,
+        VARIABLE,
+        BINARY,
+        UNARY,
+        CALL
+    };
+
+    /**
+     * @brief A distinct subexpression
+     */
+    struct Node {
+        Kind kind;
+        OpCode op = OpCode::NONE;    ///< Operator of BINARY and UNARY nodes
+        double value = 0.0;          ///< Value of LITERAL nodes
+        std::string name;            ///< Name of VARIABLE and CALL nodes
+        size_t position = 0;         ///< Position of the first occurrence
+        uint32_t firstOperand = 0;   ///< Index of the first operand in getOperands()
+        uint32_t operandCount = 0;   ///< Operands, in source order
+        uint32_t parents = 0;        ///< Operand references to this node from other nodes
+    };
+
+    /**
+     * @brief Lower a tree into a DAG
+     * @param root The root node of the expression
+     * @param context The context whose function registry decides which calls are pure
+     * @return The DAG
+     */
+    static ExpressionDag build(const ASTNode& root, const EvaluationContext& context);
+
+    /**
+     * @brief Get the nodes in topological order, operands first
+     */
+    const std::vector<Node>& getNodes() const noexcept { return nodes_; }
+
+    /**
+     * @brief Get the operand lists of all nodes, concatenated
+     */
+    const std::vector<uint32_t>& getOperands() const noexcept { return operands_; }
+
+    /**
+     * @brief Get the index of an operand of a node
+     * @param node The node
+     * @param index The operand index (must be below node.operandCount)
+     */
+    uint32_t getOperand(const Node& node, size_t index) const noexcept {
+        return operands_[node.firstOperand + index];
+    }
+
+    /**
+     * @brief Get the index of the root node (the last node)
+     */
+    uint32_t getRoot() const noexcept { return static_cast<uint32_t>(nodes_.size() - 1); }
+
+    /**
+     * @brief Get the counters of the lowering
+     */
+    const DagStats& getStats() const noexcept { return stats_; }
+
+private:
+    friend class DagBuilder;
+
+    ExpressionDag() = default;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> operands_;
+    DagStats stats_;
+};
+
+} // namespace calc
+
+#endif // CALC_CORE_EXPRESSION_DAG_H
@@ -0,0 +1,262 @@
+/**
+ * @file integer_evaluator.h
+ * @brief Fixed-width integer evaluation for programmer mode
+ */
+
+#ifndef CALC_CORE_INTEGER_EVALUATOR_H
+#define CALC_CORE_INTEGER_EVALUATOR_H
+
+#include "calc/core/ast.h"
+#include "calc/core/evaluator.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace calc {
+
+/**
+ * @brief Width of the integers an IntegerEvaluator works on
+ */
+enum class WordSize : uint8_t {
+    BITS_8 = 8,
+    BITS_16 = 16,
+    BITS_32 = 32,
+    BITS_64 = 64
+};
+
+/**
+ * @brief Get the mask of the bits of a word
+ * @param size The word size
+ * @return 0xFF for BITS_8, and so on up to all ones for BITS_64
+ */
+constexpr uint64_t wordMask(WordSize size) noexcept {
+    return size == WordSize::BITS_64 ? ~uint64_t{0}
+                                     : (uint64_t{1} << static_cast<unsigned>(size)) - 1;
+}
+
+/**
+ * @brief Result of an integer evaluation: a word, or an error
+ *
+ * The value is kept as the word's bits; getSigned() and getUnsigned()
+ * read them as two's complement or unsigned, whichever the evaluation
+ * was asked for.
+ */
+class IntegerResult {
+public:
+    /**
+     * @brief Construct a successful result
+     * @param bits The word's bits (bits above the word size are ignored)
+     * @param size The word size
+     * @param isSigned Whether the word is read as two's complement
+     */
+    IntegerResult(uint64_t bits, WordSize size, bool isSigned) noexcept;
+
+    /**
+     * @brief Construct an error result
+     * @param code The error code
+     * @param message The error message
+     * @param position Optional position in input where error occurred
+     */
+    IntegerResult(ErrorCode code, const std::string& message, size_t position = 0);
+
+    /**
+     * @brief Check if evaluation was successful
+     */
+    bool isSuccess() const noexcept { return !isError_; }
+
+    /**
+     * @brief Check if evaluation resulted in an error
+     */
+    bool isError() const noexcept { return isError_; }
+
+    /**
+     * @brief Get the word's bits, zero above the word size
+     */
+    uint64_t getBits() const noexcept { return bits_; }
+
+    /**
+     * @brief Get the word read as two's complement
+     */
+    int64_t getSigned() const noexcept;
+
+    /**
+     * @brief Get the word read as unsigned
+     */
+    uint64_t getUnsigned() const noexcept { return bits_; }
+
+    /**
+     * @brief Get the value in the evaluation's interpretation, for formatting
+     *
+     * Signed words are sign-extended; unsigned words above INT64_MAX come
+     * back negative, so format them with Converter::formatUnsigned().
+     */
+    long long getValue() const noexcept { return isSigned_ ? getSigned() : static_cast<long long>(bits_); }
+
+    /**
+     * @brief Get the word size
+     */
+    WordSize getWordSize() const noexcept { return wordSize_; }
+
+    /**
+     * @brief Check whether the word is read as two's complement
+     */
+    bool isSigned() const noexcept { return isSigned_; }
+
+    /**
+     * @brief Get the error code
+     * @throws std::runtime_error if result is successful
+     */
+    ErrorCode getErrorCode() const;
+
+    /**
+     * @brief Get the error message
+     * @throws std::runtime_error if result is successful
+     */
+    const std::string& getErrorMessage() const;
+
+    /**
+     * @brief Get the error position
+     * @throws std::runtime_error if result is successful
+     */
+    size_t getErrorPosition() const;
+
+    /**
+     * @brief Convert to a floating-point result
+     *
+     * Values beyond 2^53 in magnitude are rounded to the nearest double.
+     */
+    EvaluationResult toEvaluationResult() const;
+
+private:
+    uint64_t bits_;
+    WordSize wordSize_;
+    bool isSigned_;
+    bool isError_;
+    ErrorCode errorCode_;
+    std::string errorMessage_;
+    size_t errorPosition_;
+};
+
+/**
+ * @brief Evaluates expressions on fixed-width integers
+ *
+ * Every value is a word of getWordSize() bits and every operator works on
+ * words directly, with no floating-point conversion in between:
+ *
+ *   - + - * and unary - wrap around at the word size
+ *   - / and % truncate toward zero; division by zero is an error
+ *   - & | ~ and ^ (XOR when the context's "^" semantics say so, otherwise
+ *     a wrapping power) operate on the bits
+ *   - << and >> shift by the right operand; shifting by the word size or
+ *     more gives 0 (or all sign bits for >> on a negative signed word),
+ *     and a negative count is an error
+ *
+ * Signedness only matters where two's complement and unsigned disagree:
+ * /, %, >>, the sign of a power's exponent, and conversion to double.
+ *
+ * Integer literals use their exact value (LiteralNode::getInteger()),
+ * wrapped to the word size, so 0xFFFFFFFFFFFFFFFF and 2^53 + 1 are exact.
+ * Variables, zero-argument functions and calls read the context's double
+ * values: a whole number in 64-bit range is converted, anything else is a
+ * DOMAIN_ERROR, as is a literal with a fractional part.
+ *
+ * Trees are walked with an explicit stack, so depth is not limited.
+ *
+ * @code
+ *   IntegerEvaluator evaluator(WordSize::BITS_32, false);
+ *   IntegerResult result = evaluator.evaluate(*ast, context);
+ *   std::string hex = Converter::formatUnsigned(result.getUnsigned(), NumberBase::HEXADECIMAL);
+ * @endcode
+ */
+class IntegerEvaluator : public ASTVisitor {
+public:
+    /**
+     * @brief Construct an evaluator
+     * @param size The word size
+     * @param isSigned Whether words are read as two's complement
+     */
+    explicit IntegerEvaluator(WordSize size = WordSize::BITS_64, bool isSigned = true);
+
+    /**
+     * @brief Evaluate a tree
+     * @param root The root node
+     * @param context Variables, functions and operator semantics
+     * @return The word, or the first error in evaluation order
+     */
+    IntegerResult evaluate(const ASTNode& root, const EvaluationContext& context);
+
+    /**
+     * @brief Set the word size
+     */
+    void setWordSize(WordSize size) noexcept;
+
+    /**
+     * @brief Get the word size
+     */
+    WordSize getWordSize() const noexcept { return wordSize_; }
+
+    /**
+     * @brief Set whether words are read as two's complement
+     */
+    void setSigned(bool isSigned) noexcept { isSigned_ = isSigned; }
+
+    /**
+     * @brief Check whether words are read as two's complement
+     */
+    bool isSigned() const noexcept { return isSigned_; }
+
+    // ASTVisitor implementation
+    void visit(LiteralNode& node) override;
+    void visit(VariableNode& node) override;
+    void visit(BinaryOpNode& node) override;
+    void visit(UnaryOpNode& node) override;
+    void visit(FunctionCallNode& node) override;
+
+private:
+    WordSize wordSize_;
+    uint64_t mask_;                ///< wordMask(wordSize_)
+    bool isSigned_;
+    bool xor_ = false;             ///< '^' is XOR in the current context
+    const EvaluationContext* context_ = nullptr;
+    PostOrderWalker walker_;
+    std::vector<uint64_t> values_;  ///< Words of visited subtrees not yet consumed, innermost last
+    std::vector<double> arguments_; ///< Call arguments converted for the function registry
+    IntegerResult error_{ErrorCode::UNKNOWN_ERROR, std::string()};
+    bool failed_ = false;
+
+    /**
+     * @brief Stop the walk with an error as the result
+     */
+    void fail(ErrorCode code, const std::string& message, size_t position);
+
+    /**
+     * @brief Sign-extend a word to 64 bits
+     */
+    int64_t toSigned(uint64_t word) const noexcept;
+
+    /**
+     * @brief Read a word as a double, for function arguments
+     */
+    double toDouble(uint64_t word) const noexcept;
+
+    /**
+     * @brief Convert a double from the context into a word
+     * @return false if the value is not a whole number in 64-bit range
+     */
+    bool fromDouble(double value, uint64_t& word) const noexcept;
+
+    /**
+     * @brief Apply a binary operator to two words
+     * @return false after fail() if the operation has no result
+     */
+    bool applyBinary(OpCode op, size_t position, uint64_t left, uint64_t right, uint64_t& result);
+
+    /**
+     * @brief Raise a word to a power, wrapping at the word size
+     */
+    bool power(size_t position, uint64_t base, uint64_t exponent, uint64_t& result);
+};
+
+} // namespace calc
+
+#endif // CALC_CORE_INTEGER_EVALUATOR_H
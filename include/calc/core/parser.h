@@ -7,12 +7,63 @@
 #define CALC_CORE_PARSER_H
 
 #include "calc/core/ast.h"
+#include "calc/core/ast_arena.h"
 #include "calc/core/token.h"
 #include <vector>
 #include <memory>
+#include <utility>
 
 namespace calc {
 
+/**
+ * @brief A parsed tree together with the arena holding its nodes
+ *
+ * The tree is destroyed before the arena, and the arena then frees all
+ * node memory in one go. Nodes must not be moved out of the tree and
+ * kept past the handle's lifetime; clone() them instead.
+ */
+class ParsedExpression {
+public:
+    /**
+     * @brief Construct an empty handle
+     */
+    ParsedExpression() = default;
+
+    /**
+     * @brief Take ownership of a tree and its arena
+     * @param arena The arena the tree's nodes were allocated in
+     * @param root The root node
+     */
+    ParsedExpression(std::unique_ptr<ASTArena> arena, std::unique_ptr<ASTNode> root)
+        : arena_(std::move(arena)), root_(std::move(root)) {}
+
+    ParsedExpression(ParsedExpression&&) noexcept = default;
+    ParsedExpression& operator=(ParsedExpression&& other) noexcept {
+        root_ = std::move(other.root_);  // Destroy our tree before its arena goes
+        arena_ = std::move(other.arena_);
+        return *this;
+    }
+
+    /**
+     * @brief Get the root node (nullptr if empty)
+     */
+    ASTNode* get() const noexcept { return root_.get(); }
+
+    ASTNode& operator*() const noexcept { return *root_; }
+    ASTNode* operator->() const noexcept { return root_.get(); }
+    explicit operator bool() const noexcept { return root_ != nullptr; }
+
+    /**
+     * @brief Get the arena holding the nodes (nullptr if empty)
+     */
+    const ASTArena* getArena() const noexcept { return arena_.get(); }
+
+private:
+    // Declaration order matters: root_ is destroyed first
+    std::unique_ptr<ASTArena> arena_;
+    std::unique_ptr<ASTNode> root_;
+};
+
 /**
  * @brief Abstract base class for parsers
  *
@@ -24,6 +75,16 @@ class Parser {
 public:
     virtual ~Parser() = default;
 
+    /**
+     * @brief Deepest nesting the recursive parsers accept
+     *
+     * RecursiveDescentParser and PrattParser recurse once per level of
+     * parentheses, unary operators or right-associative '^', and report
+     * deeper input as an error instead of overflowing the stack.
+     * ShuntingYardParser keeps its stacks on the heap and has no limit.
+     */
+    static constexpr size_t MAX_NESTING_DEPTH = 1000;
+
     /**
      * @brief Parse a token stream into an AST
      * @param tokens The vector of tokens to parse
@@ -32,10 +93,97 @@ public:
      */
     virtual std::unique_ptr<ASTNode> parse(const std::vector<Token>& tokens) = 0;
 
+    /**
+     * @brief Parse a token stream, placing every node in a fresh arena
+     *
+     * Produces the same tree as parse(), but with one bump allocation per
+     * node instead of one heap allocation, and the whole tree released at
+     * once when the returned handle is destroyed.
+     *
+     * @param tokens The vector of tokens to parse
+     * @return Handle owning the tree and its arena
+     * @throws SyntaxError on parsing errors
+     */
+    ParsedExpression parseToArena(const std::vector<Token>& tokens);
+
     /**
      * @brief Get the name of this parser implementation
      */
     virtual std::string getName() const = 0;
+
+    /**
+     * @brief Keep the digits of decimal literals with a fraction or exponent
+     *
+     * Off by default, since few evaluators can use more than the double.
+     * Precision mode turns it on to read "0.1" exactly (see
+     * LiteralNode::hasDigits()).
+     */
+    void setKeepLiteralDigits(bool keep) noexcept { keepLiteralDigits_ = keep; }
+
+    /**
+     * @brief Check whether decimal literals keep their digits
+     */
+    bool getKeepLiteralDigits() const noexcept { return keepLiteralDigits_; }
+
+protected:
+    /**
+     * @brief Create a node in the current arena, or on the heap outside parseToArena()
+     */
+    template <typename T, typename... Args>
+    std::unique_ptr<T> makeNode(Args&&... args) const {
+        if (arena_ != nullptr) {
+            return std::unique_ptr<T>(new (*arena_) T(std::forward<Args>(args)...));
+        }
+        return std::make_unique<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Create the literal for a NUMBER token
+     *
+     * Whole-number literals also carry their exact 64-bit value (see
+     * LiteralNode::getInteger()); the digits are only read again when the
+     * value is too large for the token's double to be exact.
+     *
+     * @throws SyntaxError if the token's value is not a valid literal
+     */
+    std::unique_ptr<ASTNode> makeLiteral(const Token& token) const;
+
+    /**
+     * @brief Create an empty argument list using the current arena, if any
+     */
+    ASTNodeList makeNodeList() const {
+        return ASTNodeList(ArenaAllocator<std::unique_ptr<ASTNode>>(arena_));
+    }
+
+    /**
+     * @brief Counts one level of recursion for as long as it is in scope
+     */
+    class NestingGuard {
+    public:
+        /**
+         * @param depth The parser's nesting counter
+         * @param position Position reported if the limit is exceeded
+         * @throws CalculatorException (PARSE_ERROR) beyond MAX_NESTING_DEPTH
+         */
+        NestingGuard(size_t& depth, size_t position) : depth_(depth) {
+            if (depth_ >= MAX_NESTING_DEPTH) {
+                throw CalculatorException(ErrorCode::PARSE_ERROR, "Expression nested too deeply", position);
+            }
+            ++depth_;
+        }
+
+        ~NestingGuard() { --depth_; }
+
+        NestingGuard(const NestingGuard&) = delete;
+        NestingGuard& operator=(const NestingGuard&) = delete;
+
+    private:
+        size_t& depth_;
+    };
+
+private:
+    ASTArena* arena_ = nullptr;  ///< Arena of the parseToArena() call in progress
+    bool keepLiteralDigits_ = false;
 };
 
 } // namespace calc
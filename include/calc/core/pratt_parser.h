@@ -0,0 +1,158 @@
+/**
+ * @file pratt_parser.h
+ * @brief Single-pass precedence climbing (Pratt) parser
+ */
+
+#ifndef CALC_CORE_PRATT_PARSER_H
+#define CALC_CORE_PRATT_PARSER_H
+
+#include "calc/core/parser.h"
+#include "calc/core/token.h"
+#include "calc/core/ast.h"
+#include "calc/utils/error.h"
+#include <vector>
+#include <memory>
+
+namespace calc {
+
+/**
+ * @brief Parser implementation using precedence climbing (Pratt parsing)
+ *
+ * Builds the tree in a single left-to-right pass over the tokens, without
+ * copying them: each operand is parsed first, then binary operators are
+ * folded in for as long as they bind tighter than the operator that
+ * called for the operand.
+ *
+ * Accepts the same operators as ShuntingYardParser (including the
+ * bitwise and shift operators used by programmer mode) with the same
+ * precedence and associativity, and builds the same trees:
+ *
+ *   |  + -        lowest
+ *   &  * / %
+ *   ^  << >>      highest binary level; '^' is right-associative
+ *   unary + - ~   bind like '^', so -2^3 = -(2^3) but -2*3 = (-2)*3
+ *
+ * An expression with a single error gets the code and position
+ * ShuntingYardParser reports. Because there is only one pass, an
+ * expression with several errors reports the leftmost one rather than,
+ * say, an unbalanced parenthesis further on. Empty argument lists such
+ * as f() are accepted, as in RecursiveDescentParser.
+ *
+ * ShuntingYardParser drops empty groups and arguments, as in () or
+ * max(1,,2), and finds out when an operator or call runs short of
+ * operands; where it takes the missing one from an enclosing expression
+ * (1 + 2 * max(,1), max(1, max(,2))) it blames the operator or call
+ * left short, while this parser blames the nearest one. It also accepts
+ * an empty group beside an operand, such as ()2, which is an error here.
+ */
+class PrattParser : public Parser {
+public:
+    /**
+     * @brief Construct a Pratt parser
+     * @param enableUnaryOperators Enable support for unary +, - and ~ operators
+     */
+    explicit PrattParser(bool enableUnaryOperators = true);
+
+    /**
+     * @brief Parse tokens into an AST
+     * @param tokens The token stream to parse
+     * @return Root node of the constructed AST
+     * @throws SyntaxError on parsing errors
+     */
+    std::unique_ptr<ASTNode> parse(const std::vector<Token>& tokens) override;
+
+    /**
+     * @brief Get parser name
+     */
+    std::string getName() const override { return "PrattParser"; }
+
+    /**
+     * @brief Enable or disable unary operator detection
+     * @param enable Whether to enable unary operators
+     */
+    void setUnaryOperatorsEnabled(bool enable) noexcept {
+        enableUnaryOperators_ = enable;
+    }
+
+    /**
+     * @brief Check if unary operators are enabled
+     */
+    bool isUnaryOperatorsEnabled() const noexcept {
+        return enableUnaryOperators_;
+    }
+
+private:
+    /**
+     * @brief Get the token at the current position, or EOF past the end
+     */
+    const Token& peek() const noexcept;
+
+    /**
+     * @brief Parse operands joined by operators that bind tighter than a bound
+     * @param minPrecedence Precedence of the operator that called for this operand
+     *        (0 at the top level, inside parentheses and in arguments)
+     * @param caller The binary operator whose right operand this is, if any
+     */
+    std::unique_ptr<ASTNode> parseExpression(int minPrecedence, const Token* caller);
+
+    /**
+     * @brief Parse a prefix operator, literal, variable, call or parenthesized group
+     * @param caller The binary operator whose right operand this is, if any
+     */
+    std::unique_ptr<ASTNode> parseOperand(const Token* caller);
+
+    /**
+     * @brief Parse a function call; the FUNCTION token is current
+     * @param caller The binary operator whose right operand this is, if any
+     */
+    std::unique_ptr<ASTNode> parseCall(const Token* caller);
+
+    /**
+     * @brief Find the end of a group holding nothing but parentheses
+     * @return Index just past the group starting at the current token, such
+     *         as () or (()), or the current index if there is none
+     */
+    size_t emptyGroupEnd() const noexcept;
+
+    /**
+     * @brief Report an empty group that stands where an operand should
+     *
+     * As ShuntingYardParser does: the caller is short of an operand, or
+     * the operator after the group is, or the whole expression is empty.
+     * Returns when the group is followed by something else.
+     *
+     * @param caller The binary operator whose right operand this is, if any
+     * @param end Index just past the group
+     */
+    void checkEmptyGroup(const Token* caller, size_t end) const;
+
+    /**
+     * @brief Report a missing operand at the current token
+     * @param caller The binary operator whose right operand is missing, if any
+     */
+    [[noreturn]] void missingOperand(const Token* caller) const;
+
+    /**
+     * @brief Report the token after an expression that should have ended there
+     *
+     * Called when the token after a complete expression is not the one the
+     * context expects (end of input, ')' or ',').
+     */
+    [[noreturn]] void unexpectedAfterOperand() const;
+
+    /**
+     * @brief Reject the operator pairs ShuntingYardParser rejects (1**2, 1++2)
+     * @param index Index of an operator token that follows another operator
+     */
+    void checkConsecutiveOperators(size_t index) const;
+
+    const std::vector<Token>* tokens_;  ///< Token stream being parsed (not owned)
+    size_t current_;                    ///< Current position in tokens_
+    size_t depth_;                      ///< Open parentheses at current_
+    size_t nesting_;                    ///< Active parseExpression() calls
+    bool enableUnaryOperators_;         ///< Enable unary operator detection
+};
+
+} // namespace calc
+
+#endif // CALC_CORE_PRATT_PARSER_H
@@ -28,7 +28,7 @@ namespace calc {
  * power        ::= unary | postfix '^' power
  * unary        ::= ('+' | '-') unary | postfix
  * postfix      ::= primary ( '(' arguments? ')' )?
- * primary      ::= NUMBER | '(' expression ')' | FUNCTION
+ * primary      ::= NUMBER | '(' expression ')' | VARIABLE | FUNCTION
  * arguments    ::= expression (',' expression)*
  *
  * This implementation handles:
@@ -181,7 +181,7 @@ private:
 
     /**
      * @brief Parse a primary expression
-     * primary ::= NUMBER | '(' expression ')' | FUNCTION
+     * primary ::= NUMBER | '(' expression ')' | VARIABLE | FUNCTION
      */
     std::unique_ptr<ASTNode> parsePrimary();
 
@@ -190,7 +190,7 @@ private:
      * arguments ::= expression (',' expression)*
      * @return Vector of argument AST nodes
      */
-    std::vector<std::unique_ptr<ASTNode>> parseArguments();
+    ASTNodeList parseArguments();
 
     /**
      * @brief Check if a token is a binary operator
@@ -217,6 +217,7 @@ private:
 
     std::vector<Token> tokens_;      ///< Token stream being parsed
     size_t current_;                ///< Current position in token stream
+    size_t nesting_;                ///< Active recursive grammar calls
     bool enableUnaryOperators_;     ///< Enable unary + and - detection
 };
 
@@ -7,17 +7,20 @@
 #define CALC_CORE_TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <cstddef>
+#include <cstdint>
 
 namespace calc {
 
 /**
  * @brief Enumeration of token types for lexical analysis
  */
-enum class TokenType {
+enum class TokenType : uint8_t {
     NUMBER,          ///< Numeric literal (integer or floating-point)
     OPERATOR,        ///< Arithmetic operator (+, -, *, /, ^, etc.)
-    FUNCTION,        ///< Function name (sin, cos, sqrt, etc.)
+    FUNCTION,        ///< Function name followed by '(' (sin, cos, sqrt, etc.)
+    VARIABLE,        ///< Identifier not followed by '(' (x, rate, PI, etc.)
     LPAREN,          ///< Left parenthesis '('
     RPAREN,          ///< Right parenthesis ')'
     COMMA,           ///< Comma separator for function arguments
@@ -25,10 +28,84 @@ enum class TokenType {
     UNKNOWN          ///< Unrecognized token
 };
 
+/**
+ * @brief Operator classification, resolved once by the tokenizer
+ *
+ * Binary operators are listed first so that precedence and dispatch
+ * tables can be indexed directly by the enum value. Parsers rewrite
+ * ADD, SUB and BIT_NOT to their unary forms when they appear in
+ * prefix position.
+ */
+enum class OpCode : uint8_t {
+    NONE,       ///< Not an operator, or an unrecognized one
+    ADD,        ///< Binary '+'
+    SUB,        ///< Binary '-'
+    MUL,        ///< '*'
+    DIV,        ///< '/'
+    MOD,        ///< '%'
+    POW,        ///< '^' (power, or XOR in programmer mode)
+    BIT_AND,    ///< '&'
+    BIT_OR,     ///< '|'
+    SHL,        ///< '<<'
+    SHR,        ///< '>>'
+    PLUS,       ///< Unary '+'
+    NEG,        ///< Unary '-'
+    BIT_NOT,    ///< Unary '~'
+    COUNT_      ///< Number of opcodes (table size, not an operator)
+};
+
+/**
+ * @brief Classify an operator symbol
+ * @param symbol The operator text (e.g. "+", "<<")
+ * @return The binary (or, for "~", unary) opcode, or OpCode::NONE
+ */
+OpCode classifyOperator(const std::string& symbol) noexcept;
+
+/**
+ * @brief Get the source symbol of an opcode
+ * @param op The opcode
+ * @return Symbol such as "+" or "<<"; unary forms share the binary symbol
+ */
+const char* opCodeSymbol(OpCode op) noexcept;
+
+/**
+ * @brief Check whether an opcode is a prefix (unary) operator
+ */
+constexpr bool isUnaryOpCode(OpCode op) noexcept {
+    return op == OpCode::PLUS || op == OpCode::NEG || op == OpCode::BIT_NOT;
+}
+
+/**
+ * @brief Check whether an opcode is an infix (binary) operator
+ */
+constexpr bool isBinaryOpCode(OpCode op) noexcept {
+    return op >= OpCode::ADD && op <= OpCode::SHR;
+}
+
+/**
+ * @brief Map an operator to its prefix form
+ * @param op The opcode as classified by the tokenizer
+ * @return PLUS for ADD, NEG for SUB, unary opcodes unchanged, otherwise NONE
+ */
+constexpr OpCode toUnaryOpCode(OpCode op) noexcept {
+    switch (op) {
+        case OpCode::ADD:
+        case OpCode::PLUS:
+            return OpCode::PLUS;
+        case OpCode::SUB:
+        case OpCode::NEG:
+            return OpCode::NEG;
+        case OpCode::BIT_NOT:
+            return OpCode::BIT_NOT;
+        default:
+            return OpCode::NONE;
+    }
+}
+
 /**
  * @brief Number base enumeration for programmer mode
  */
-enum class NumberBase {
+enum class NumberBase : uint8_t {
     DECIMAL,    ///< Default: 42, 3.14
     BINARY,     ///< 0b1010, 0B1010
     OCTAL,      ///< 0o77, 0o17
@@ -51,6 +128,8 @@ struct Token {
     size_t position;     ///< Starting position in original input string
     size_t argCount;     ///< Number of arguments for function tokens (default 0)
     NumberBase numberBase; ///< Number base for number tokens (default: DECIMAL)
+    OpCode opcode;       ///< Operator classification for operator tokens (default: NONE)
+    double number;       ///< Value of a number token (NaN if value is not a valid literal)
 
     /**
      * @brief Construct a default token
@@ -62,18 +141,38 @@ struct Token {
      * @param t The token type
      * @param v The token value string
      * @param pos The starting position
+     * @note Operator tokens are classified and number tokens converted from their value
      */
     Token(TokenType t, const std::string& v, size_t pos);
 
+    /**
+     * @brief Construct an operator token with a known opcode
+     * @param t The token type
+     * @param v The token value string
+     * @param pos The starting position
+     * @param op The operator classification
+     */
+    Token(TokenType t, const std::string& v, size_t pos, OpCode op);
+
     /**
      * @brief Construct a token with number base
      * @param t The token type
      * @param v The token value string
      * @param pos The starting position
      * @param base The number base (for number tokens)
+     * @note Number tokens are converted from their value in the given base
      */
     Token(TokenType t, const std::string& v, size_t pos, NumberBase base);
 
+    /**
+     * @brief Construct a number token whose value is already known
+     * @param v The literal's digits, without base prefix
+     * @param pos The starting position
+     * @param base The number base
+     * @param numericValue The literal's value
+     */
+    Token(std::string v, size_t pos, NumberBase base, double numericValue);
+
     /**
      * @brief Check if this token is an operator
      * @return true if type is OPERATOR
@@ -117,6 +216,31 @@ struct Token {
     bool operator!=(const Token& other) const noexcept;
 };
 
+/**
+ * @brief A token that refers into the input instead of owning its text
+ *
+ * Produced by Tokenizer::tokenize(std::string_view, std::vector<CompactToken>&).
+ * The lexeme is input[offset, offset + length), including any base prefix.
+ * Number literals are converted once by the tokenizer; prefixed literals
+ * wrap to 64 bits like Converter::fromBase.
+ */
+struct CompactToken {
+    double number;          ///< Value of a NUMBER token (0 otherwise)
+    uint32_t offset;        ///< Starting position in the input
+    uint32_t length;        ///< Length of the lexeme
+    TokenType type;         ///< The type of this token
+    OpCode opcode;          ///< Operator classification for operator tokens
+    NumberBase numberBase;  ///< Number base for number tokens
+
+    /**
+     * @brief Get the lexeme
+     * @param input The input this token was read from
+     */
+    std::string_view text(std::string_view input) const noexcept {
+        return input.substr(offset, length);
+    }
+};
+
 } // namespace calc
 
 // ============================================================================
@@ -131,7 +255,7 @@ namespace calc {
  * @param pos Position in string
  * @return true if binary prefix found
  */
-inline bool isBinaryPrefix(const std::string& str, size_t pos) {
+inline bool isBinaryPrefix(std::string_view str, size_t pos) noexcept {
     return (pos + 1 < str.length() && str[pos] == '0' &&
             (str[pos + 1] == 'b' || str[pos + 1] == 'B'));
 }
@@ -142,7 +266,7 @@ inline bool isBinaryPrefix(const std::string& str, size_t pos) {
  * @param pos Position in string
  * @return true if hex prefix found
  */
-inline bool isHexPrefix(const std::string& str, size_t pos) {
+inline bool isHexPrefix(std::string_view str, size_t pos) noexcept {
     return (pos + 1 < str.length() && str[pos] == '0' &&
             (str[pos + 1] == 'x' || str[pos + 1] == 'X'));
 }
@@ -153,7 +277,7 @@ inline bool isHexPrefix(const std::string& str, size_t pos) {
  * @param pos Position in string
  * @return true if octal prefix found
  */
-inline bool isOctalPrefix(const std::string& str, size_t pos) {
+inline bool isOctalPrefix(std::string_view str, size_t pos) noexcept {
     return (pos + 1 < str.length() && str[pos] == '0' &&
             (str[pos + 1] == 'o' || str[pos + 1] == 'O'));
 }
@@ -0,0 +1,271 @@
+/**
+ * @file big_float.h
+ * @brief Arbitrary-precision binary floating point for precision mode
+ */
+
+#ifndef CALC_MATH_BIG_FLOAT_H
+#define CALC_MATH_BIG_FLOAT_H
+
+#include "calc/math/big_integer.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace calc {
+
+/**
+ * @brief Arbitrary-precision binary floating-point number
+ *
+ * A value is mantissa * 2^exponent with a BigInteger mantissa, kept odd
+ * (or zero) so every value has one representation. There is no infinity
+ * or NaN: operations without a finite result throw.
+ *
+ * Values carry no precision of their own. The exact operators (+, -, *)
+ * keep every bit; add(), subtract(), multiply(), divide(), sqrt() and
+ * cbrt() take a precision in bits and round the exact result to nearest,
+ * ties to even, as IEEE 754 does for double. Decimal conversion in both
+ * directions is correctly rounded as well.
+ *
+ * @code
+ *   const size_t bits = BigFloat::precisionForDigits(50);
+ *   BigFloat tenth = BigFloat::fromString("0.1", bits);
+ *   std::string digits = BigFloat::divide(BigFloat(BigInteger(1)), tenth, bits).toString(50);
+ * @endcode
+ */
+class BigFloat {
+public:
+    /// Fewest bits a rounding operation accepts
+    static constexpr size_t MIN_PRECISION = 2;
+
+    /// Largest decimal exponent fromString() accepts, beyond which 10^e is too costly to form
+    static constexpr int64_t MAX_DECIMAL_EXPONENT = 1000000;
+
+    /**
+     * @brief Construct zero
+     */
+    BigFloat() = default;
+
+    /**
+     * @brief Construct an integer, exactly
+     */
+    explicit BigFloat(BigInteger value);
+
+    /**
+     * @brief Construct mantissa * 2^exponent, exactly
+     */
+    BigFloat(BigInteger mantissa, int64_t exponent);
+
+    /**
+     * @brief Construct from a double, exactly
+     * @throws std::invalid_argument if @p value is not finite
+     */
+    static BigFloat fromDouble(double value);
+
+    /**
+     * @brief Read a decimal number, correctly rounded
+     * @param text Digits with an optional sign, fraction and exponent, e.g. "-12.5e-3"
+     * @param precision Precision of the result in bits
+     * @throws std::invalid_argument if @p text is not a decimal number
+     * @throws std::out_of_range if the exponent exceeds MAX_DECIMAL_EXPONENT
+     */
+    static BigFloat fromString(std::string_view text, size_t precision);
+
+    /**
+     * @brief Get the precision in bits that holds @p digits significant decimal digits
+     */
+    static size_t precisionForDigits(size_t digits) noexcept;
+
+    /**
+     * @brief Write the value to @p digits significant decimal digits
+     *
+     * Correctly rounded, ties to even, with trailing zeros removed. Plain
+     * notation is used for decimal exponents from -5 to digits - 1, as
+     * printf's %g does, and scientific notation ("1.5e+300") otherwise.
+     */
+    std::string toString(size_t digits) const;
+
+    /**
+     * @brief Round to the nearest double
+     *
+     * Values beyond the double range give an infinity, and values below it zero.
+     */
+    double toDouble() const;
+
+    bool isZero() const noexcept { return mantissa_.isZero(); }
+    bool isNegative() const noexcept { return mantissa_.isNegative(); }
+    int sign() const noexcept { return mantissa_.sign(); }
+
+    /**
+     * @brief Get the odd mantissa (zero for zero)
+     */
+    const BigInteger& getMantissa() const noexcept { return mantissa_; }
+
+    /**
+     * @brief Get the power of two the mantissa is scaled by
+     */
+    int64_t getExponent() const noexcept { return exponent_; }
+
+    /**
+     * @brief Get the binary order: e with 2^(e-1) <= |value| < 2^e, 0 for zero
+     */
+    int64_t order() const noexcept;
+
+    /**
+     * @brief Check whether the value is a whole number
+     */
+    bool isInteger() const noexcept { return exponent_ >= 0; }
+
+    /**
+     * @brief Get the integer part, truncated toward zero
+     */
+    BigInteger toInteger() const;
+
+    /**
+     * @brief Round to @p precision bits, to nearest with ties to even
+     */
+    BigFloat roundToPrecision(size_t precision) const;
+
+    /**
+     * @brief Multiply by 2^@p count, exactly
+     */
+    BigFloat scaled(int64_t count) const;
+
+    BigFloat operator-() const;
+    BigFloat abs() const;
+
+    // Rounding to integers, exact
+    BigFloat trunc() const;
+    BigFloat floor() const;
+    BigFloat ceil() const;
+
+    /**
+     * @brief Round to the nearest integer, halfway cases away from zero, as std::round
+     */
+    BigFloat round() const;
+
+    // Exact arithmetic
+    friend BigFloat operator+(const BigFloat& a, const BigFloat& b);
+    friend BigFloat operator-(const BigFloat& a, const BigFloat& b);
+    friend BigFloat operator*(const BigFloat& a, const BigFloat& b);
+
+    // Correctly rounded arithmetic at @p precision bits
+    static BigFloat add(const BigFloat& a, const BigFloat& b, size_t precision);
+    static BigFloat subtract(const BigFloat& a, const BigFloat& b, size_t precision);
+    static BigFloat multiply(const BigFloat& a, const BigFloat& b, size_t precision);
+
+    /**
+     * @throws std::domain_error if @p b is zero
+     */
+    static BigFloat divide(const BigFloat& a, const BigFloat& b, size_t precision);
+
+    /**
+     * @throws std::domain_error if @p a is negative
+     */
+    static BigFloat sqrt(const BigFloat& a, size_t precision);
+
+    static BigFloat cbrt(const BigFloat& a, size_t precision);
+
+    /**
+     * @brief a - trunc(a / b) * b, exactly, as std::fmod
+     * @throws std::domain_error if @p b is zero
+     */
+    static BigFloat fmod(const BigFloat& a, const BigFloat& b);
+
+    /**
+     * @brief a - n * b with n the nearest integer to a / b, ties to even, exactly, as std::remainder
+     * @throws std::domain_error if @p b is zero
+     */
+    static BigFloat remainder(const BigFloat& a, const BigFloat& b);
+
+    /**
+     * @brief Compare two values
+     * @return Negative, zero or positive as @p a is less than, equal to or greater than @p b
+     */
+    static int compare(const BigFloat& a, const BigFloat& b);
+
+    friend bool operator==(const BigFloat& a, const BigFloat& b) { return compare(a, b) == 0; }
+    friend bool operator!=(const BigFloat& a, const BigFloat& b) { return compare(a, b) != 0; }
+    friend bool operator<(const BigFloat& a, const BigFloat& b) { return compare(a, b) < 0; }
+    friend bool operator<=(const BigFloat& a, const BigFloat& b) { return compare(a, b) <= 0; }
+    friend bool operator>(const BigFloat& a, const BigFloat& b) { return compare(a, b) > 0; }
+    friend bool operator>=(const BigFloat& a, const BigFloat& b) { return compare(a, b) >= 0; }
+
+private:
+    BigInteger mantissa_;
+    int64_t exponent_ = 0;
+
+    /**
+     * @brief Strip trailing zero bits from the mantissa into the exponent
+     */
+    void normalize();
+
+    /**
+     * @brief Round mantissa * 2^exponent to @p precision bits
+     * @param sticky The exact value lies strictly beyond mantissa * 2^exponent,
+     *               by less than 2^exponent; the mantissa must then have more
+     *               than @p precision bits
+     */
+    static BigFloat roundExact(BigInteger mantissa, int64_t exponent, size_t precision, bool sticky);
+};
+
+/**
+ * @brief Elementary functions on BigFloat
+ *
+ * The arbitrary-precision counterparts of MathFunctions. Results are
+ * within one unit in the last place at the requested precision
+ * (faithfully rounded); sqrt, cbrt and hypot are correctly rounded.
+ *
+ * Each function works at the requested precision plus guard bits, after
+ * reducing its argument to where a power series converges quickly:
+ *   - exp: x = k ln 2 + r, then r / 2^s, a Taylor series, and s squarings.
+ *   - log: Halley's iteration on exp, with the precision tripling each step.
+ *   - sin, cos, tan: x = k pi/2 + r, then r / 2^s, one Taylor series
+ *     giving both sin and cos, and s double-angle steps.
+ *   - atan: 1/x above 1, then s argument halvings and a Taylor series;
+ *     asin and acos are written in terms of atan.
+ *   - pi by Machin's formula and ln 2 by a three-term atanh formula, both
+ *     in fixed point and cached per thread at the largest precision used.
+ *
+ * Arguments are reduced at a precision that grows with their magnitude,
+ * so sin(1e1000) is as accurate as sin(1), at the cost of pi to a few
+ * thousand more bits. Functions throw std::domain_error outside their
+ * domain and std::overflow_error when a result or an argument to reduce
+ * has an order beyond MAX_ORDER; results below -MAX_ORDER flush to zero.
+ */
+class BigFloatFunctions {
+public:
+    /// Largest binary order (see BigFloat::order()) of a result or of an argument to reduce
+    static constexpr int64_t MAX_ORDER = int64_t{1} << 20;
+
+    static BigFloat pi(size_t precision);
+    static BigFloat e(size_t precision);
+    static BigFloat ln2(size_t precision);
+
+    static BigFloat exp(const BigFloat& x, size_t precision);
+    static BigFloat log(const BigFloat& x, size_t precision);
+    static BigFloat log10(const BigFloat& x, size_t precision);
+
+    static BigFloat sin(const BigFloat& x, size_t precision);
+    static BigFloat cos(const BigFloat& x, size_t precision);
+    static BigFloat tan(const BigFloat& x, size_t precision);
+    static BigFloat asin(const BigFloat& x, size_t precision);
+    static BigFloat acos(const BigFloat& x, size_t precision);
+    static BigFloat atan(const BigFloat& x, size_t precision);
+
+    static BigFloat sinh(const BigFloat& x, size_t precision);
+    static BigFloat cosh(const BigFloat& x, size_t precision);
+    static BigFloat tanh(const BigFloat& x, size_t precision);
+
+    /**
+     * @brief x^y; integer exponents are computed by repeated squaring
+     * @throws std::domain_error for 0 to a negative power or a negative base to a fractional one
+     */
+    static BigFloat pow(const BigFloat& x, const BigFloat& y, size_t precision);
+
+    static BigFloat hypot(const BigFloat& x, const BigFloat& y, size_t precision);
+};
+
+} // namespace calc
+
+#endif // CALC_MATH_BIG_FLOAT_H
@@ -0,0 +1,217 @@
+/**
+ * @file big_float_evaluator.h
+ * @brief Arbitrary-precision floating-point evaluation for precision mode
+ */
+
+#ifndef CALC_MATH_BIG_FLOAT_EVALUATOR_H
+#define CALC_MATH_BIG_FLOAT_EVALUATOR_H
+
+#include "calc/core/ast.h"
+#include "calc/core/evaluator.h"
+#include "calc/math/big_float.h"
+#include <string>
+#include <vector>
+
+namespace calc {
+
+/**
+ * @brief Result of an arbitrary-precision floating-point evaluation: a value, or an error
+ */
+class BigFloatResult {
+public:
+    /**
+     * @brief Construct a successful result
+     * @param value The value
+     * @param precision The precision it was computed at, in bits
+     */
+    BigFloatResult(BigFloat value, size_t precision);
+
+    /**
+     * @brief Construct an error result
+     * @param code The error code
+     * @param message The error message
+     * @param position Optional position in input where error occurred
+     */
+    BigFloatResult(ErrorCode code, const std::string& message, size_t position = 0);
+
+    /**
+     * @brief Check if evaluation was successful
+     */
+    bool isSuccess() const noexcept { return !isError_; }
+
+    /**
+     * @brief Check if evaluation resulted in an error
+     */
+    bool isError() const noexcept { return isError_; }
+
+    /**
+     * @brief Get the value
+     * @throws std::runtime_error if result is an error
+     */
+    const BigFloat& getValue() const;
+
+    /**
+     * @brief Get the precision the value was computed at, in bits
+     */
+    size_t getPrecision() const noexcept { return precision_; }
+
+    /**
+     * @brief Get the error code
+     * @throws std::runtime_error if result is successful
+     */
+    ErrorCode getErrorCode() const;
+
+    /**
+     * @brief Get the error message
+     * @throws std::runtime_error if result is successful
+     */
+    const std::string& getErrorMessage() const;
+
+    /**
+     * @brief Get the error position
+     * @throws std::runtime_error if result is successful
+     */
+    size_t getErrorPosition() const;
+
+    /**
+     * @brief Convert to a floating-point result
+     *
+     * Values are rounded to the nearest double; values beyond the double
+     * range are a NUMERIC_OVERFLOW error.
+     */
+    EvaluationResult toEvaluationResult() const;
+
+private:
+    BigFloat value_;
+    size_t precision_;
+    bool isError_;
+    ErrorCode errorCode_;
+    std::string errorMessage_;
+    size_t errorPosition_;
+};
+
+/**
+ * @brief Evaluates expressions on arbitrary-precision binary floating point
+ *
+ * The arbitrary-precision counterpart of the double evaluator, with the
+ * same operators and errors. Every operation is computed at the
+ * evaluator's precision (setPrecision(), in bits): +, -, *, / and sqrt
+ * are correctly rounded, and the functions of MathFunctions are replaced
+ * by their BigFloatFunctions versions, faithful to the last bit. So are
+ * the constants PI and E. The context still decides which functions
+ * exist and how many arguments they take; functions without a precise
+ * version are called on doubles.
+ *
+ * Decimal literals are read from their digits when the parser kept them
+ * (Parser::setKeepLiteralDigits()), so 0.1 is 0.1 to the full precision
+ * rather than the double nearest it. Variables are doubles and convert
+ * exactly.
+ *
+ * Bitwise operators and shifts act on the integer parts. Results of
+ * binary order beyond MAX_ORDER are a NUMERIC_OVERFLOW error; results
+ * below -MAX_ORDER flush to zero.
+ *
+ * @code
+ *   BigFloatEvaluator evaluator(BigFloat::precisionForDigits(100));
+ *   BigFloatResult result = evaluator.evaluate(*ast, context);
+ *   std::string digits = result.getValue().toString(100);
+ * @endcode
+ */
+class BigFloatEvaluator : public ASTVisitor {
+public:
+    /// Largest precision, in bits (about 5 million decimal digits)
+    static constexpr size_t MAX_PRECISION = size_t{1} << 24;
+
+    /// Largest binary order of a result (about 10^19728)
+    static constexpr int64_t MAX_ORDER = int64_t{1} << 16;
+
+    /**
+     * @brief Construct an evaluator
+     * @param precision The precision in bits
+     * @throws std::invalid_argument if @p precision is out of range
+     */
+    explicit BigFloatEvaluator(size_t precision = BigFloat::precisionForDigits(50));
+
+    /**
+     * @brief Evaluate a tree
+     * @param root The root node
+     * @param context Variables, functions and operator semantics
+     * @return The value, or the first error in evaluation order
+     */
+    BigFloatResult evaluate(const ASTNode& root, const EvaluationContext& context);
+
+    /**
+     * @brief Set the precision
+     * @param precision The precision in bits, from BigFloat::MIN_PRECISION to MAX_PRECISION
+     * @throws std::invalid_argument if @p precision is out of range
+     */
+    void setPrecision(size_t precision);
+
+    /**
+     * @brief Get the precision in bits
+     */
+    size_t getPrecision() const noexcept { return precision_; }
+
+    // ASTVisitor implementation
+    void visit(LiteralNode& node) override;
+    void visit(VariableNode& node) override;
+    void visit(BinaryOpNode& node) override;
+    void visit(UnaryOpNode& node) override;
+    void visit(FunctionCallNode& node) override;
+
+private:
+    size_t precision_;
+    bool xor_ = false;               ///< '^' is XOR in the current context
+    const EvaluationContext* context_ = nullptr;
+    PostOrderWalker walker_;
+    std::vector<BigFloat> values_;   ///< Values of visited subtrees not yet consumed, innermost last
+    std::vector<double> arguments_;  ///< Call arguments converted for the function registry
+    BigFloatResult error_{ErrorCode::UNKNOWN_ERROR, std::string()};
+    bool failed_ = false;
+
+    /**
+     * @brief Stop the walk with an error as the result
+     */
+    void fail(ErrorCode code, const std::string& message, size_t position);
+
+    /**
+     * @brief Push a value, or fail if its order is beyond MAX_ORDER
+     */
+    void push(BigFloat value, size_t position);
+
+    /**
+     * @brief Pop the innermost value
+     */
+    BigFloat pop();
+
+    /**
+     * @brief Push a double from the context, or fail if it is not finite
+     */
+    void pushDouble(double value, const std::string& name, size_t position);
+
+    /**
+     * @brief Call a function, precisely if it has a BigFloatFunctions version
+     * @param arguments The first of @p count arguments
+     * @return false after fail() if the call has no result
+     */
+    bool call(const std::string& name, const FunctionEntry& entry, const BigFloat* arguments,
+              size_t count, size_t position, BigFloat& result);
+
+    /**
+     * @brief Apply a binary operator
+     * @return false after fail() if the operation has no result
+     */
+    bool applyBinary(OpCode op, size_t position, const BigFloat& left, const BigFloat& right,
+                     BigFloat& result);
+
+    /**
+     * @brief Run an operation, turning the exceptions of BigFloat into errors
+     * @return false after fail() if the operation threw
+     */
+    template <typename Operation>
+    bool guard(size_t position, Operation&& operation);
+};
+
+} // namespace calc
+
+#endif // CALC_MATH_BIG_FLOAT_EVALUATOR_H
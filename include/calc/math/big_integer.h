@@ -0,0 +1,295 @@
+/**
+ * @file big_integer.h
+ * @brief Arbitrary-precision integers for programmer mode
+ */
+
+#ifndef CALC_MATH_BIG_INTEGER_H
+#define CALC_MATH_BIG_INTEGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace calc {
+
+/**
+ * @brief Arbitrary-precision signed integer
+ *
+ * Stored as a sign and a magnitude of 32-bit limbs, least significant
+ * first. Magnitudes of up to INLINE_LIMBS limbs (128 bits) live inside the
+ * object, so small values never allocate; larger ones move to the heap.
+ *
+ * Algorithms:
+ *   - Multiplication is schoolbook below KARATSUBA_THRESHOLD limbs and
+ *     Karatsuba above; very unbalanced operands are multiplied in slices
+ *     of the shorter one.
+ *   - Division by a single limb is a short division, with the divisor a
+ *     compile-time constant where conversion uses one (10^9), so the
+ *     compiler replaces the hardware divide by a multiply and shift.
+ *     Longer divisors use Knuth's algorithm D.
+ *   - Conversion to and from power-of-two bases moves bits directly.
+ *     Other bases split the number in halves by precomputed powers of the
+ *     base, down to pieces of CONVERSION_THRESHOLD limbs that are handled
+ *     a limb at a time.
+ *
+ * Division truncates toward zero and the remainder takes the dividend's
+ * sign, as for built-in integers. Bitwise operators and shifts treat
+ * values as infinitely sign-extended two's complement: ~x is -x - 1 and
+ * -1 >> 1 is -1.
+ *
+ * @code
+ *   BigInteger p = BigInteger::fromString("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", 16);
+ *   std::string digits = (p * p + 1).toString(10);
+ * @endcode
+ */
+class BigInteger {
+public:
+    using Limb = uint32_t;
+
+    /// Bits per limb
+    static constexpr unsigned LIMB_BITS = 32;
+
+    /// Limbs stored inside the object before the magnitude moves to the heap
+    static constexpr size_t INLINE_LIMBS = 4;
+
+    /// Shorter operand length, in limbs, from which multiplication uses Karatsuba
+    static constexpr size_t KARATSUBA_THRESHOLD = 32;
+
+    /// Length, in limbs, below which base conversion works a limb at a time
+    static constexpr size_t CONVERSION_THRESHOLD = 24;
+
+    /**
+     * @brief Construct zero
+     */
+    BigInteger() noexcept;
+
+    /**
+     * @brief Construct from a built-in integer
+     * @param value The value
+     */
+    BigInteger(long long value) noexcept;  // Implicit, like the built-in integer conversions
+
+    /**
+     * @brief Construct from an unsigned built-in integer
+     * @param value The value
+     */
+    static BigInteger fromUnsigned(unsigned long long value) noexcept;
+
+    /**
+     * @brief Construct from a whole double, exactly
+     * @param value The value
+     * @throws std::invalid_argument if @p value is not finite or has a fractional part
+     */
+    static BigInteger fromDouble(double value);
+
+    /**
+     * @brief Parse digits in a base
+     * @param digits Digits, case-insensitive, with an optional leading '-'
+     * @param base The base (2-36)
+     * @return The value
+     * @throws std::invalid_argument if the base is out of range or a digit is invalid
+     */
+    static BigInteger fromString(std::string_view digits, int base = 10);
+
+    /**
+     * @brief Get 2 raised to a power
+     * @param exponent The exponent
+     */
+    static BigInteger powerOfTwo(size_t exponent);
+
+    BigInteger(const BigInteger& other);
+    BigInteger(BigInteger&& other) noexcept;
+    BigInteger& operator=(const BigInteger& other);
+    BigInteger& operator=(BigInteger&& other) noexcept;
+    ~BigInteger();
+
+    /**
+     * @brief Convert to digits in a base
+     * @param base The base (2-36)
+     * @return Uppercase digits, with a leading '-' if negative and no prefix
+     * @throws std::invalid_argument if the base is out of range
+     */
+    std::string toString(int base = 10) const;
+
+    /**
+     * @brief Check whether the value is zero
+     */
+    bool isZero() const noexcept { return size_ == 0; }
+
+    /**
+     * @brief Check whether the value is below zero
+     */
+    bool isNegative() const noexcept { return negative_; }
+
+    /**
+     * @brief Get -1, 0 or 1 following the sign
+     */
+    int sign() const noexcept { return negative_ ? -1 : (size_ == 0 ? 0 : 1); }
+
+    /**
+     * @brief Get the number of bits of the magnitude (0 for zero)
+     */
+    size_t bitLength() const noexcept;
+
+    /**
+     * @brief Check a bit of the magnitude
+     * @param index The bit, counting from the least significant
+     */
+    bool testBit(size_t index) const noexcept;
+
+    /**
+     * @brief Get the index of the lowest set bit of the magnitude (0 for zero)
+     */
+    size_t lowestSetBit() const noexcept;
+
+    /**
+     * @brief Get the number of limbs of the magnitude
+     */
+    size_t getLimbCount() const noexcept { return size_; }
+
+    /**
+     * @brief Check whether the magnitude is stored inside the object
+     */
+    bool isInline() const noexcept { return capacity_ == INLINE_LIMBS; }
+
+    /**
+     * @brief Check whether the value fits in a signed 64-bit integer
+     */
+    bool fitsInt64() const noexcept;
+
+    /**
+     * @brief Get the low 64 bits as two's complement
+     *
+     * Exact when fitsInt64() is true.
+     */
+    int64_t toInt64() const noexcept;
+
+    /**
+     * @brief Get the nearest double
+     *
+     * Rounds to nearest, ties to even; values beyond the double range give
+     * an infinity of the value's sign.
+     */
+    double toDouble() const noexcept;
+
+    /**
+     * @brief Reduce to a word of a fixed number of bits
+     *
+     * Keeps the low @p bits bits of the two's complement value. Signed
+     * words are then read as two's complement, so 255 in 8 signed bits is
+     * -1; unsigned words lie in [0, 2^bits).
+     *
+     * @param bits The word size; 0 returns the value unchanged
+     * @param isSigned Whether the word is read as two's complement
+     */
+    BigInteger wrap(size_t bits, bool isSigned) const;
+
+    /**
+     * @brief Raise to a power
+     * @param base The base
+     * @param exponent The exponent
+     */
+    static BigInteger pow(const BigInteger& base, uint64_t exponent);
+
+    /**
+     * @brief Divide, giving quotient and remainder at once
+     * @param dividend The dividend
+     * @param divisor The divisor
+     * @param quotient Set to the quotient, truncated toward zero
+     * @param remainder Set to the remainder, with the sign of the dividend
+     * @throws std::domain_error if @p divisor is zero
+     */
+    static void divMod(const BigInteger& dividend, const BigInteger& divisor,
+                       BigInteger& quotient, BigInteger& remainder);
+
+    /**
+     * @brief Compare two values
+     * @return Negative, zero or positive as @p a is less than, equal to or greater than @p b
+     */
+    static int compare(const BigInteger& a, const BigInteger& b) noexcept;
+
+    BigInteger operator-() const;
+    BigInteger operator~() const;
+
+    BigInteger& operator+=(const BigInteger& other);
+    BigInteger& operator-=(const BigInteger& other);
+    BigInteger& operator*=(const BigInteger& other);
+    BigInteger& operator/=(const BigInteger& other);
+    BigInteger& operator%=(const BigInteger& other);
+    BigInteger& operator&=(const BigInteger& other);
+    BigInteger& operator|=(const BigInteger& other);
+    BigInteger& operator^=(const BigInteger& other);
+    BigInteger& operator<<=(size_t count);
+    BigInteger& operator>>=(size_t count);
+
+    friend BigInteger operator+(BigInteger a, const BigInteger& b) { a += b; return a; }
+    friend BigInteger operator-(BigInteger a, const BigInteger& b) { a -= b; return a; }
+    friend BigInteger operator*(const BigInteger& a, const BigInteger& b);
+    friend BigInteger operator/(BigInteger a, const BigInteger& b) { a /= b; return a; }
+    friend BigInteger operator%(BigInteger a, const BigInteger& b) { a %= b; return a; }
+    friend BigInteger operator&(BigInteger a, const BigInteger& b) { a &= b; return a; }
+    friend BigInteger operator|(BigInteger a, const BigInteger& b) { a |= b; return a; }
+    friend BigInteger operator^(BigInteger a, const BigInteger& b) { a ^= b; return a; }
+    friend BigInteger operator<<(BigInteger a, size_t count) { a <<= count; return a; }
+    friend BigInteger operator>>(BigInteger a, size_t count) { a >>= count; return a; }
+
+    friend bool operator==(const BigInteger& a, const BigInteger& b) noexcept { return compare(a, b) == 0; }
+    friend bool operator!=(const BigInteger& a, const BigInteger& b) noexcept { return compare(a, b) != 0; }
+    friend bool operator<(const BigInteger& a, const BigInteger& b) noexcept { return compare(a, b) < 0; }
+    friend bool operator<=(const BigInteger& a, const BigInteger& b) noexcept { return compare(a, b) <= 0; }
+    friend bool operator>(const BigInteger& a, const BigInteger& b) noexcept { return compare(a, b) > 0; }
+    friend bool operator>=(const BigInteger& a, const BigInteger& b) noexcept { return compare(a, b) >= 0; }
+
+private:
+    uint32_t size_;      ///< Limbs in use; the top one is nonzero
+    uint32_t capacity_;  ///< INLINE_LIMBS while inline, else the heap block's length
+    bool negative_;      ///< Never set for zero
+    union {
+        Limb inline_[INLINE_LIMBS];
+        Limb* heap_;
+    };
+
+    Limb* limbs() noexcept { return capacity_ == INLINE_LIMBS ? inline_ : heap_; }
+    const Limb* limbs() const noexcept { return capacity_ == INLINE_LIMBS ? inline_ : heap_; }
+
+    /**
+     * @brief Make room for @p count limbs, keeping the current ones
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Set the length to @p count limbs, zeroing new ones
+     */
+    void resize(size_t count);
+
+    /**
+     * @brief Drop zero limbs from the top, and the sign of zero
+     */
+    void normalize() noexcept;
+
+    /**
+     * @brief Build a value from a magnitude
+     */
+    static BigInteger fromLimbs(const Limb* limbs, size_t count, bool negative);
+
+    /**
+     * @brief Add (@p subtract false) or subtract @p other's magnitude, with its sign flipped when subtracting
+     */
+    void addSigned(const BigInteger& other, bool subtract);
+
+    /**
+     * @brief Apply a bitwise operator in two's complement
+     * @param op '&', '|' or '^'
+     */
+    void bitwise(const BigInteger& other, char op);
+
+    /**
+     * @brief Write the magnitude's digits in a base that is not a power of two
+     */
+    void appendDigits(std::string& out, int base) const;
+};
+
+} // namespace calc
+
+#endif // CALC_MATH_BIG_INTEGER_H
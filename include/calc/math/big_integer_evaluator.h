@@ -0,0 +1,226 @@
+/**
+ * @file big_integer_evaluator.h
+ * @brief Arbitrary-precision integer evaluation for programmer mode
+ */
+
+#ifndef CALC_MATH_BIG_INTEGER_EVALUATOR_H
+#define CALC_MATH_BIG_INTEGER_EVALUATOR_H
+
+#include "calc/core/ast.h"
+#include "calc/core/evaluator.h"
+#include "calc/math/big_integer.h"
+#include <string>
+#include <vector>
+
+namespace calc {
+
+/**
+ * @brief Result of an arbitrary-precision evaluation: a value, or an error
+ */
+class BigIntegerResult {
+public:
+    /**
+     * @brief Construct a successful result
+     * @param value The value, already reduced to the word
+     * @param wordBits The word size in bits, 0 if unbounded
+     * @param isSigned Whether the word is read as two's complement
+     */
+    BigIntegerResult(BigInteger value, size_t wordBits, bool isSigned);
+
+    /**
+     * @brief Construct an error result
+     * @param code The error code
+     * @param message The error message
+     * @param position Optional position in input where error occurred
+     */
+    BigIntegerResult(ErrorCode code, const std::string& message, size_t position = 0);
+
+    /**
+     * @brief Check if evaluation was successful
+     */
+    bool isSuccess() const noexcept { return !isError_; }
+
+    /**
+     * @brief Check if evaluation resulted in an error
+     */
+    bool isError() const noexcept { return isError_; }
+
+    /**
+     * @brief Get the value
+     * @throws std::runtime_error if result is an error
+     */
+    const BigInteger& getValue() const;
+
+    /**
+     * @brief Get the word size in bits, 0 if unbounded
+     */
+    size_t getWordBits() const noexcept { return wordBits_; }
+
+    /**
+     * @brief Check whether the word is read as two's complement
+     */
+    bool isSigned() const noexcept { return isSigned_; }
+
+    /**
+     * @brief Get the error code
+     * @throws std::runtime_error if result is successful
+     */
+    ErrorCode getErrorCode() const;
+
+    /**
+     * @brief Get the error message
+     * @throws std::runtime_error if result is successful
+     */
+    const std::string& getErrorMessage() const;
+
+    /**
+     * @brief Get the error position
+     * @throws std::runtime_error if result is successful
+     */
+    size_t getErrorPosition() const;
+
+    /**
+     * @brief Convert to a floating-point result
+     *
+     * Values are rounded to the nearest double; values beyond the double
+     * range are a NUMERIC_OVERFLOW error.
+     */
+    EvaluationResult toEvaluationResult() const;
+
+private:
+    BigInteger value_;
+    size_t wordBits_;
+    bool isSigned_;
+    bool isError_;
+    ErrorCode errorCode_;
+    std::string errorMessage_;
+    size_t errorPosition_;
+};
+
+/**
+ * @brief Evaluates expressions on arbitrary-precision integers
+ *
+ * The arbitrary-precision counterpart of IntegerEvaluator, with the same
+ * operators and errors. With a word size (setWordBits()), every result is
+ * reduced to a word of that many bits, signed or unsigned, so 128- to
+ * 4096-bit registers wrap around as 64-bit ones do. With word size 0,
+ * values are unbounded; results past MAX_BITS are a NUMERIC_OVERFLOW
+ * error rather than an attempt to allocate them.
+ *
+ * Literals wider than 64 bits are read from their digits
+ * (LiteralNode::getDigits()). Variables, constants and calls go through
+ * the context's doubles, as in IntegerEvaluator.
+ *
+ * It lives in calc_math, beside BigInteger, since calc_core does not
+ * depend on calc_math.
+ *
+ * @code
+ *   BigIntegerEvaluator evaluator(256, false);
+ *   BigIntegerResult result = evaluator.evaluate(*ast, context);
+ *   std::string hex = Converter::format(result.getValue(), NumberBase::HEXADECIMAL);
+ * @endcode
+ */
+class BigIntegerEvaluator : public ASTVisitor {
+public:
+    /// Largest word size, and largest unbounded result, in bits
+    static constexpr size_t MAX_BITS = size_t{1} << 20;
+
+    /**
+     * @brief Construct an evaluator
+     * @param wordBits The word size in bits, 0 for unbounded
+     * @param isSigned Whether words are read as two's complement
+     * @throws std::invalid_argument if @p wordBits exceeds MAX_BITS
+     */
+    explicit BigIntegerEvaluator(size_t wordBits = 0, bool isSigned = true);
+
+    /**
+     * @brief Evaluate a tree
+     * @param root The root node
+     * @param context Variables, functions and operator semantics
+     * @return The value, or the first error in evaluation order
+     */
+    BigIntegerResult evaluate(const ASTNode& root, const EvaluationContext& context);
+
+    /**
+     * @brief Set the word size
+     * @param wordBits The word size in bits, 0 for unbounded
+     * @throws std::invalid_argument if @p wordBits exceeds MAX_BITS
+     */
+    void setWordBits(size_t wordBits);
+
+    /**
+     * @brief Get the word size in bits, 0 if unbounded
+     */
+    size_t getWordBits() const noexcept { return wordBits_; }
+
+    /**
+     * @brief Set whether words are read as two's complement
+     */
+    void setSigned(bool isSigned) noexcept { isSigned_ = isSigned; }
+
+    /**
+     * @brief Check whether words are read as two's complement
+     */
+    bool isSigned() const noexcept { return isSigned_; }
+
+    // ASTVisitor implementation
+    void visit(LiteralNode& node) override;
+    void visit(VariableNode& node) override;
+    void visit(BinaryOpNode& node) override;
+    void visit(UnaryOpNode& node) override;
+    void visit(FunctionCallNode& node) override;
+
+private:
+    size_t wordBits_;
+    bool isSigned_;
+    bool xor_ = false;               ///< '^' is XOR in the current context
+    const EvaluationContext* context_ = nullptr;
+    PostOrderWalker walker_;
+    std::vector<BigInteger> values_;  ///< Values of visited subtrees not yet consumed, innermost last
+    std::vector<double> arguments_;   ///< Call arguments converted for the function registry
+    BigIntegerResult error_{ErrorCode::UNKNOWN_ERROR, std::string()};
+    bool failed_ = false;
+
+    /**
+     * @brief Stop the walk with an error as the result
+     */
+    void fail(ErrorCode code, const std::string& message, size_t position);
+
+    /**
+     * @brief Reduce a value to the word and push it
+     */
+    void push(BigInteger value);
+
+    /**
+     * @brief Pop the innermost value
+     */
+    BigInteger pop();
+
+    /**
+     * @brief Push a double from the context
+     * @return false, pushing nothing, if it is not a whole number
+     */
+    bool pushWhole(double value);
+
+    /**
+     * @brief Apply a binary operator
+     * @return false after fail() if the operation has no result
+     */
+    bool applyBinary(OpCode op, size_t position, const BigInteger& left, const BigInteger& right,
+                     BigInteger& result);
+
+    /**
+     * @brief Raise to a power, reducing to the word as it goes
+     */
+    bool power(size_t position, const BigInteger& base, const BigInteger& exponent, BigInteger& result);
+
+    /**
+     * @brief Shift left or right by a count that is not negative
+     */
+    bool shift(OpCode op, size_t position, const BigInteger& value, const BigInteger& count,
+               BigInteger& result);
+};
+
+} // namespace calc
+
+#endif // CALC_MATH_BIG_INTEGER_EVALUATOR_H
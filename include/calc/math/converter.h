@@ -6,24 +6,42 @@
 #ifndef CALC_MATH_CONVERTER_H
 #define CALC_MATH_CONVERTER_H
 
+#include "calc/math/big_integer.h"
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <stdexcept>
 #include <cctype>
+#include <cstdint>
 
 namespace calc {
 
 // Forward declaration of NumberBase (defined in token.h)
-enum class NumberBase;
+enum class NumberBase : uint8_t;
 
 /**
  * @brief Base conversion utilities for programmer mode
  *
  * Provides conversion between decimal, binary, octal, and hexadecimal representations.
  * Supports both direct conversions and validation of number strings.
+ *
+ * Conversion is table-driven and writes into fixed buffers: power-of-two
+ * bases take digits by bit extraction, decimal goes through std::to_chars,
+ * and parsing looks each character up in one 256-entry digit table. The
+ * bulk overloads convert whole arrays to and from separated text, reusing
+ * the caller's string, without allocating per value.
+ *
+ * @code
+ *   std::string text;
+ *   Converter::convertToBase(ids.data(), ids.size(), 16, text);   // "1F\n2A\n..."
+ *   size_t count = Converter::fromBase(text, 16, parsed.data(), parsed.size());
+ * @endcode
  */
 class Converter {
 public:
+    /// Most characters toChars() writes: a sign and 64 binary digits
+    static constexpr size_t MAX_CHARS = 65;
+
     // ========================================================================
     // Decimal to other bases
     // ========================================================================
@@ -96,8 +114,109 @@ public:
      * @param base The source base (2-36)
      * @return Decimal value
      * @throws std::invalid_argument if base is not in range [2, 36] or string is invalid
+     * @throws std::out_of_range if the value does not fit in a long long; use fromBaseBig()
+     */
+    static long long fromBase(std::string_view value, int base);
+
+    /**
+     * @brief Convert string in arbitrary base to an unsigned 64-bit value
+     * @param value The string to convert, without sign
+     * @param base The source base (2-36)
+     * @return The value
+     * @throws std::invalid_argument if base is not in range [2, 36] or string is invalid
+     * @throws std::out_of_range if the value does not fit in 64 bits
+     */
+    static unsigned long long fromBaseUnsigned(std::string_view value, int base);
+
+    /**
+     * @brief Write a value in a base into a buffer, without allocating
+     * @param value The value to convert
+     * @param base The target base (2-36)
+     * @param out Buffer with room for at least MAX_CHARS characters; not terminated
+     * @return The number of characters written
+     * @throws std::invalid_argument if base is not in range [2, 36]
+     */
+    static size_t toChars(long long value, int base, char* out);
+
+    /**
+     * @brief Write an unsigned value in a base into a buffer, without allocating
+     * @see toChars(long long, int, char*)
+     */
+    static size_t toCharsUnsigned(unsigned long long value, int base, char* out);
+
+    // ========================================================================
+    // Bulk conversion
+    // ========================================================================
+
+    /**
+     * @brief Append an array of values to a string, each followed by a separator
+     *
+     * The string grows at most once, so reusing it across calls converts
+     * without allocating.
+     *
+     * @param values The first of @p count values
+     * @param count Number of values
+     * @param base The target base (2-36)
+     * @param out String the digits are appended to
+     * @param separator Character written after each value
+     * @throws std::invalid_argument if base is not in range [2, 36]
+     */
+    static void convertToBase(const long long* values, size_t count, int base, std::string& out,
+                              char separator = '\n');
+
+    /**
+     * @brief Append an array of unsigned values to a string, each followed by a separator
+     * @see convertToBase(const long long*, size_t, int, std::string&, char)
+     */
+    static void convertToBase(const unsigned long long* values, size_t count, int base,
+                              std::string& out, char separator = '\n');
+
+    /**
+     * @brief Parse separated values into an array
+     *
+     * A separator after the last value is optional.
+     *
+     * @param text Values in @p base, each followed by @p separator
+     * @param base The source base (2-36)
+     * @param out Array receiving the values
+     * @param capacity Number of values @p out has room for
+     * @param separator Character between values
+     * @return The number of values parsed
+     * @throws std::invalid_argument if base is not in range [2, 36] or a value is invalid
+     * @throws std::out_of_range if a value does not fit in a long long
+     * @throws std::length_error if @p text holds more than @p capacity values
+     */
+    static size_t fromBase(std::string_view text, int base, long long* out, size_t capacity,
+                           char separator = '\n');
+
+    /**
+     * @brief Parse separated unsigned values into an array
+     * @see fromBase(std::string_view, int, long long*, size_t, char)
+     */
+    static size_t fromBase(std::string_view text, int base, unsigned long long* out, size_t capacity,
+                           char separator = '\n');
+
+    // ========================================================================
+    // Arbitrary precision
+    // ========================================================================
+
+    /**
+     * @brief Convert an arbitrary-precision value to a base
+     * @param value The value to convert
+     * @param base The target base (2-36)
+     * @return String representation in specified base, with '-' if negative
+     * @throws std::invalid_argument if base is not in range [2, 36]
+     */
+    static std::string convertToBase(const BigInteger& value, int base);
+
+    /**
+     * @brief Convert a string in a base to an arbitrary-precision value
+     * @param value The string to convert, with an optional leading '-'
+     * @param base The source base (2-36)
+     * @return The value, however many digits the string has
+     * @throws std::invalid_argument if base is not in range [2, 36] or string is invalid
      */
-    static long long fromBase(const std::string& value, int base);
+    static BigInteger fromBaseBig(const std::string& value, int base);
 
     // ========================================================================
     // Validation functions
@@ -157,6 +276,26 @@ public:
      */
     static std::string format(long long value, NumberBase base);
 
+    /**
+     * @brief Format an unsigned value to specified base with appropriate prefix
+     *
+     * Unlike format(), values are never negative: a word's two's complement
+     * bits print as they are, so ~0 in 64 bits is 0xFFFFFFFFFFFFFFFF.
+     *
+     * @param value The value
+     * @param base The target base
+     * @return Formatted string with prefix
+     */
+    static std::string formatUnsigned(unsigned long long value, NumberBase base);
+
+    /**
+     * @brief Format an arbitrary-precision value to specified base with appropriate prefix
+     * @param value The value
+     * @param base The target base
+     * @return Formatted string with prefix, after the sign if negative
+     */
+    static std::string format(const BigInteger& value, NumberBase base);
+
 private:
     /**
      * @brief Convert digit character to its numeric value
@@ -181,6 +320,33 @@ private:
      * @return true if valid, false otherwise
      */
     static bool isValidDigitForBase(char c, int base);
+
+    /**
+     * @brief Check that a string is an optional '-' and at least one digit in @p base
+     */
+    static bool isValidForBase(const std::string& value, int base);
+
+    /**
+     * @brief Write a non-negative value with the prefix of @p base ("0x" etc., none for decimal)
+     * @param out Buffer with room for 2 + MAX_CHARS characters
+     * @return The number of characters written
+     */
+    static size_t prefixedDigits(unsigned long long value, NumberBase base, char* out);
+
+    /**
+     * @brief Parse the magnitude of a value, up to @p limit
+     * @throws std::invalid_argument if @p value has no digits or an invalid one
+     * @throws std::out_of_range if the magnitude exceeds @p limit
+     */
+    static unsigned long long parseMagnitude(std::string_view value, int base,
+                                             unsigned long long limit);
+
+    /**
+     * @brief Parse separated values, converting each with @p parse
+     */
+    template <typename T, typename Parse>
+    static size_t parseAll(std::string_view text, T* out, size_t capacity, char separator,
+                           Parse&& parse);
 };
 
 } // namespace calc
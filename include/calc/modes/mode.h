@@ -6,7 +6,9 @@
 #ifndef CALC_MODES_MODE_H
 #define CALC_MODES_MODE_H
 
+#include "calc/core/compiled_expression.h"
 #include "calc/core/evaluator.h"
+#include "calc/core/expression_cache.h"
 #include <string>
 
 namespace calc {
@@ -40,6 +42,23 @@ public:
      */
     virtual EvaluationResult evaluate(const std::string& expression) = 0;
 
+    /**
+     * @brief Evaluate one expression over struct-of-arrays input columns
+     *
+     * The expression is parsed and compiled once; each column binds a
+     * variable name for the whole batch, shadowing context variables.
+     * Other identifiers resolve to context variables and constants.
+     *
+     * @param expression The expression string to evaluate
+     * @param columns Input columns, each with at least @p rows values
+     * @param rows Number of rows to evaluate
+     * @param out Output buffer with room for @p rows values
+     * @return Row and error counts; failed rows are written as NaN
+     */
+    virtual BatchResult evaluateBatch(const std::string& expression,
+                                      const std::vector<BatchColumn>& columns,
+                                      size_t rows, double* out) = 0;
+
     /**
      * @brief Get the evaluation context used by this mode
      * @return Reference to the evaluation context
@@ -51,6 +70,23 @@ public:
      * @return Const reference to the evaluation context
      */
     virtual const EvaluationContext& getContext() const = 0;
+
+    /**
+     * @brief Get the parsed-expression cache counters
+     * @return Hits, misses, evictions, size and capacity
+     */
+    virtual CacheStats getCacheStats() const = 0;
+
+    /**
+     * @brief Set the number of parsed expressions this mode keeps
+     * @param capacity Maximum number of entries (0 disables caching)
+     */
+    virtual void setCacheCapacity(size_t capacity) = 0;
+
+    /**
+     * @brief Drop all cached parsed expressions
+     */
+    virtual void clearCache() = 0;
 };
 
 } // namespace calc
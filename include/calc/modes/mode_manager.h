@@ -7,23 +7,36 @@
 #define CALC_MODES_MODE_MANAGER_H
 
 #include "calc/modes/mode.h"
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace calc {
 
+/**
+ * @brief Builds a mode the first time it is requested
+ */
+using ModeFactory = std::function<std::unique_ptr<Mode>()>;
+
 /**
  * @brief Manager for registering and retrieving calculator modes
  *
  * Maintains a registry of available modes and provides methods
- * to query and access them by name.
+ * to query and access them by name. Modes registered through a factory
+ * are built on first use, so a process that evaluates in one mode never
+ * builds the others; names can be listed and checked without building
+ * anything.
  */
 class ModeManager {
 public:
     /**
      * @brief Construct a mode manager
+     *
+     * Registers factories for the standard, scientific, programmer and
+     * precision modes; none of them is built yet.
      */
     ModeManager();
 
@@ -44,9 +57,20 @@ public:
     bool registerMode(std::unique_ptr<Mode> mode);
 
     /**
-     * @brief Get a mode by name
+     * @brief Register a mode to be built on first use
+     * @param name The mode name, which the built mode should report
+     * @param factory Builds the mode; called at most once
+     * @return true if registration succeeded, false if the factory is empty
+     *         or a mode with the same name exists
+     */
+    bool registerModeFactory(const std::string& name, ModeFactory factory);
+
+    /**
+     * @brief Get a mode by name, building it if needed
      * @param name The mode name
-     * @return Pointer to the mode, or nullptr if not found
+     * @return Pointer to the mode, or nullptr if not found or its factory
+     *         returned nullptr
+     * @throws Whatever the mode's factory throws; it is tried again next time
      */
     Mode* getMode(const std::string& name);
 
@@ -78,10 +102,17 @@ public:
     /**
      * @brief Check if a mode is registered
      * @param name The mode name
-     * @return true if mode exists
+     * @return true if mode exists, built or not
      */
     bool hasMode(const std::string& name) const;
 
+    /**
+     * @brief Check whether a registered mode has been built
+     * @param name The mode name
+     * @return true if the mode exists and has been built
+     */
+    bool isModeBuilt(const std::string& name) const;
+
     /**
      * @brief Get the number of registered modes
      * @return Number of modes
@@ -89,7 +120,16 @@ public:
     size_t getModeCount() const;
 
 private:
-    std::unordered_map<std::string, std::unique_ptr<Mode>> modes_;
+    struct ModeSlot {
+        ModeFactory factory;         ///< Empty once the mode is built
+        std::unique_ptr<Mode> mode;  ///< Null until first use
+    };
+
+    // Find a mode, building it if needed
+    Mode* findMode(const std::string& name) const;
+
+    mutable std::mutex mutex_;  ///< Guards modes_, which getMode() const may fill in
+    mutable std::unordered_map<std::string, ModeSlot> modes_;
     std::string defaultModeName_;
 };
 
@@ -0,0 +1,118 @@
+/**
+ * @file precision_mode.h
+ * @brief Arbitrary-precision calculator mode
+ */
+
+#ifndef CALC_MODES_PRECISION_MODE_H
+#define CALC_MODES_PRECISION_MODE_H
+
+#include "calc/modes/mode.h"
+#include "calc/core/parser.h"
+#include "calc/core/evaluator.h"
+#include "calc/math/big_float_evaluator.h"
+#include <memory>
+
+namespace calc {
+
+/**
+ * @brief Arbitrary-precision calculator mode
+ *
+ * Scientific mode's operators and functions on BigFloat instead of
+ * double, at the context's precision in significant decimal digits
+ * (EvaluationContext::getPrecision(), 50 by default). Literals are read
+ * from their digits, so 0.1 + 0.2 is 0.3; +, -, *, / and sqrt are
+ * correctly rounded and the other functions faithful, each at
+ * GUARD_BITS beyond the digits shown so that formatResult() prints every
+ * digit correctly rounded in all but the rarest of cases.
+ *
+ * evaluatePrecise() returns the full value for formatResult();
+ * evaluate() rounds it to a double for the Mode interface, and
+ * evaluateBatch() does the same per row.
+ */
+class PrecisionMode : public Mode {
+public:
+    /// Default number of significant decimal digits
+    static constexpr int DEFAULT_DIGITS = 50;
+
+    /// Most significant decimal digits a result can be computed to
+    static constexpr int MAX_DIGITS = 1000000;
+
+    /// Bits computed beyond the digits shown
+    static constexpr size_t GUARD_BITS = 16;
+
+    /**
+     * @brief Construct a precision mode
+     * @param precision Significant decimal digits (default: 50)
+     */
+    explicit PrecisionMode(int precision = DEFAULT_DIGITS);
+
+    /**
+     * @brief Destructor
+     */
+    ~PrecisionMode() override = default;
+
+    // Mode implementation
+    std::string getName() const override;
+    std::string getDescription() const override;
+    EvaluationResult evaluate(const std::string& expression) override;
+    BatchResult evaluateBatch(const std::string& expression,
+                              const std::vector<BatchColumn>& columns,
+                              size_t rows, double* out) override;
+    EvaluationContext& getContext() override;
+    const EvaluationContext& getContext() const override;
+    CacheStats getCacheStats() const override;
+    void setCacheCapacity(size_t capacity) override;
+    void clearCache() override;
+
+    /**
+     * @brief Evaluate an expression at the context's precision
+     * @param expression The expression string to evaluate
+     * @return The value, or an error (including a parse error)
+     */
+    BigFloatResult evaluatePrecise(const std::string& expression);
+
+    /**
+     * @brief Format a result to the context's precision
+     *
+     * Correctly rounded to that many significant digits, without trailing
+     * zeros; very large and very small values use scientific notation.
+     *
+     * @param result A successful result of evaluatePrecise()
+     * @return The digits, e.g. "3.1415926535897932384626433832795028841971693993751"
+     */
+    std::string formatResult(const BigFloatResult& result) const;
+
+    /**
+     * @brief Set the number of significant decimal digits
+     * @param precision The new precision, from 1 to MAX_DIGITS
+     * @throws std::invalid_argument if @p precision is out of range
+     */
+    void setPrecision(int precision);
+
+    /**
+     * @brief Get the number of significant decimal digits
+     */
+    int getPrecision() const;
+
+private:
+    EvaluationContext context_;
+    BigFloatEvaluator evaluator_;
+    ExpressionCache cache_;
+
+    /**
+     * @brief Get the digits to compute to, at least 1
+     */
+    size_t getDigits() const;
+
+    /**
+     * @brief Tokenize and parse an expression, keeping literal digits and reusing cached trees
+     * @param expression The expression string
+     * @return The parsed tree
+     * @throws CalculatorException if the expression cannot be parsed
+     */
+    std::shared_ptr<const ASTNode> parse(const std::string& expression);
+};
+
+} // namespace calc
+
+#endif // CALC_MODES_PRECISION_MODE_H
@@ -9,8 +9,10 @@
 #include "calc/modes/mode.h"
 #include "calc/core/parser.h"
 #include "calc/core/evaluator.h"
+#include "calc/core/integer_evaluator.h"
 #include "calc/core/token.h"
 #include "calc/math/converter.h"
+#include "calc/math/big_integer_evaluator.h"
 #include <memory>
 
 namespace calc {
@@ -21,6 +23,17 @@ namespace calc {
  * Supports base conversions (binary, octal, hexadecimal, decimal)
  * and bitwise operations: &, |, ^, ~, <<, >>
  * Operator precedence: <<, >> > & > ^ > |, +, -
+ *
+ * Expressions are evaluated on fixed-width integers by an
+ * IntegerEvaluator: 64-bit two's complement by default, or 8, 16 or 32
+ * bits, signed or unsigned, with wraparound (see setWordSize() and
+ * setSigned()). evaluateInteger() returns the exact word for
+ * formatResult(); evaluate() converts it to a double for the Mode
+ * interface. evaluateBatch() works on double columns and runs on the
+ * bytecode VM.
+ *
+ * Wider registers, 128 to 4096 bits or unbounded, are evaluated on
+ * BigInteger by evaluateBigInteger() (see setBigWordSize()).
  */
 class ProgrammerMode : public Mode {
 public:
@@ -39,8 +52,67 @@ public:
     std::string getName() const override;
     std::string getDescription() const override;
     EvaluationResult evaluate(const std::string& expression) override;
+    BatchResult evaluateBatch(const std::string& expression,
+                              const std::vector<BatchColumn>& columns,
+                              size_t rows, double* out) override;
     EvaluationContext& getContext() override;
     const EvaluationContext& getContext() const override;
+    CacheStats getCacheStats() const override;
+    void setCacheCapacity(size_t capacity) override;
+    void clearCache() override;
+
+    /**
+     * @brief Evaluate an expression as a fixed-width integer
+     * @param expression The expression string to evaluate
+     * @return The exact word, in the current word size and signedness,
+     *         or the error, parse errors included
+     */
+    IntegerResult evaluateInteger(const std::string& expression);
+
+    /**
+     * @brief Set the word size results wrap around at
+     * @param size 8, 16, 32 or 64 bits
+     */
+    void setWordSize(WordSize size);
+
+    /**
+     * @brief Get the word size
+     */
+    WordSize getWordSize() const;
+
+    /**
+     * @brief Evaluate an expression on arbitrary-precision integers
+     * @param expression The expression string to evaluate
+     * @return The value, in the current big word size and signedness,
+     *         or the error, parse errors included
+     */
+    BigIntegerResult evaluateBigInteger(const std::string& expression);
+
+    /**
+     * @brief Set the word size evaluateBigInteger() results wrap around at
+     * @param bits The word size in bits, e.g. 128 or 4096; 0 for unbounded
+     * @throws std::invalid_argument if @p bits exceeds BigIntegerEvaluator::MAX_BITS
+     */
+    void setBigWordSize(size_t bits);
+
+    /**
+     * @brief Get the big word size in bits, 0 if unbounded
+     */
+    size_t getBigWordSize() const;
+
+    /**
+     * @brief Set whether words are read as two's complement
+     *
+     * Applies to both evaluateInteger() and evaluateBigInteger().
+     *
+     * @param isSigned true for signed (the default), false for unsigned
+     */
+    void setSigned(bool isSigned);
+
+    /**
+     * @brief Check whether words are read as two's complement
+     */
+    bool isSigned() const;
 
     /**
      * @brief Set the display base for results
@@ -62,6 +134,47 @@ public:
      */
     std::string formatResult(long long value) const;
 
+    /**
+     * @brief Format an integer result based on display base
+     *
+     * Decimal shows the value as signed or unsigned, following the result;
+     * binary, octal and hexadecimal show the word's bits, so -1 in 8 bits
+     * is 0xFF.
+     *
+     * @param result A successful result of evaluateInteger()
+     * @return Formatted string with appropriate prefix
+     */
+    std::string formatResult(const IntegerResult& result) const;
+
+    /**
+     * @brief Format an integer result in a given base
+     *
+     * What formatResult(const IntegerResult&) shows for that display base,
+     * for callers that evaluate without a ProgrammerMode (SharedEngine).
+     *
+     * @param result A successful integer result
+     * @param base The display base
+     * @return Formatted string with appropriate prefix
+     */
+    static std::string formatInteger(const IntegerResult& result, NumberBase base);
+
+    /**
+     * @brief Map the display base to a NumberBase
+     */
+    NumberBase getDisplayNumberBase() const;
+
+    /**
+     * @brief Format an arbitrary-precision result based on display base
+     *
+     * As for IntegerResult: decimal shows the value, other bases show the
+     * word's bits. Unbounded results have no word, so negative values show
+     * a sign and their magnitude.
+     *
+     * @param result A successful result of evaluateBigInteger()
+     * @return Formatted string with appropriate prefix
+     */
+    std::string formatResult(const BigIntegerResult& result) const;
+
     /**
      * @brief Get list of supported display bases
      * @return Vector of supported base numbers
@@ -82,7 +195,10 @@ public:
 
 private:
     EvaluationContext context_;
-    EvaluatorVisitor evaluator_;
+    IntegerEvaluator evaluator_;
+    BigIntegerEvaluator bigEvaluator_;
+    ExpressionCache cache_;
+    VirtualMachine vm_;
     int displayBase_;
     int precision_;
 
@@ -92,6 +208,14 @@ private:
      */
     std::unique_ptr<Parser> createParser() const;
 
+    /**
+     * @brief Tokenize and parse an expression, reusing cached trees
+     * @param expression The expression string
+     * @return The parsed tree
+     * @throws CalculatorException if the expression cannot be parsed
+     */
+    std::shared_ptr<const ASTNode> parse(const std::string& expression);
+
     /**
      * @brief Check if a base value is valid
      * @param base The base to check
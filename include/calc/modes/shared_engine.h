@@ -0,0 +1,269 @@
+/**
+ * @file shared_engine.h
+ * @brief Thread-safe evaluation engine shared by concurrent callers
+ */
+
+#ifndef CALC_MODES_SHARED_ENGINE_H
+#define CALC_MODES_SHARED_ENGINE_H
+
+#include "calc/core/expression_archive.h"
+#include "calc/core/integer_evaluator.h"
+#include "calc/math/big_float_evaluator.h"
+#include "calc/modes/mode.h"
+#include "calc/modes/standard_mode.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace calc {
+
+class SharedEngine;
+
+/**
+ * @brief Mutable state one thread needs to evaluate with a SharedEngine
+ *
+ * Holds the register machine and a small table of programs this thread
+ * has used recently, so repeated expressions are found without taking
+ * the engine's lock. A scratch may be used with any engine (switching
+ * engines drops the table), but by only one thread at a time.
+ */
+class EvaluationScratch {
+public:
+    /// Programs remembered per thread before the table is cleared
+    static constexpr size_t LOCAL_CAPACITY = 64;
+
+    EvaluationScratch() = default;
+
+    EvaluationScratch(const EvaluationScratch&) = delete;
+    EvaluationScratch& operator=(const EvaluationScratch&) = delete;
+
+    /**
+     * @brief Get the register machine used for evaluation
+     */
+    VirtualMachine& getVirtualMachine() noexcept { return vm_; }
+
+private:
+    friend class SharedEngine;
+
+    struct Program;
+
+    VirtualMachine vm_;
+    IntegerEvaluator integer_;  ///< Evaluates the programs of integer engines
+    BigFloatEvaluator precise_; ///< Evaluates the programs of precise engines
+    uint64_t engineId_ = 0;  ///< Engine whose programs are in programs_ (0 = none)
+    std::unordered_map<std::string, std::shared_ptr<const Program>> programs_;
+    std::string key_;        ///< Lookup key, reused so string_view lookups do not allocate
+};
+
+/**
+ * @brief Evaluation engine that many threads can use at once
+ *
+ * The engine takes a snapshot of a mode's evaluation context (functions,
+ * variables and operator semantics) when it is constructed and never
+ * changes it afterwards. Expressions are parsed and compiled once into
+ * immutable programs, kept in a cache shared by all threads; each thread
+ * runs them with its own EvaluationScratch. Values and errors are the
+ * same as EvaluatorVisitor gives with the snapshotted context. A
+ * StandardMode's parser choice (setParserType()) is snapshotted too.
+ *
+ * An engine built from a ProgrammerMode is an integer engine (see
+ * isInteger()): it evaluates on fixed-width integers with the mode's word
+ * size and signedness, as ProgrammerMode::evaluateInteger() does, so
+ * 7 / 2 is 3 and words above 2^53 stay exact. An engine built from a
+ * PrecisionMode is a precise engine (see isPrecise()): it keeps literal
+ * digits and evaluates on BigFloat at the mode's precision, as
+ * PrecisionMode::evaluatePrecise() does, so 0.1 + 0.2 is 0.3. Both kinds
+ * still run evaluateBatch() on doubles.
+ *
+ * When the shared cache is full, an eighth of it is dropped to make room;
+ * programs are cheap to rebuild, so recency is not tracked.
+ *
+ * @code
+ *   ScientificMode mode;
+ *   SharedEngine engine(mode);
+ *   // From any number of threads:
+ *   EvaluationResult result = engine.evaluate("sin(1) + 2");
+ * @endcode
+ */
+class SharedEngine {
+public:
+    /**
+     * @brief Construct an engine from a mode's current context
+     * @param mode The mode to snapshot; later changes to it are not seen
+     * @param cacheCapacity Compiled programs kept in the shared cache
+     */
+    explicit SharedEngine(const Mode& mode,
+                          size_t cacheCapacity = ExpressionCache::DEFAULT_CAPACITY);
+
+    /**
+     * @brief Construct an engine from an evaluation context
+     * @param name Name reported by getName()
+     * @param context The context to copy
+     * @param cacheCapacity Compiled programs kept in the shared cache
+     * @param parserType Parser to build programs with
+     */
+    SharedEngine(std::string name, const EvaluationContext& context,
+                 size_t cacheCapacity = ExpressionCache::DEFAULT_CAPACITY,
+                 ParserType parserType = ParserType::SHUNTING_YARD);
+
+    SharedEngine(const SharedEngine&) = delete;
+    SharedEngine& operator=(const SharedEngine&) = delete;
+
+    /**
+     * @brief Get the name of the mode this engine was built from
+     */
+    const std::string& getName() const noexcept { return name_; }
+
+    /**
+     * @brief Get the frozen evaluation context
+     */
+    const EvaluationContext& getContext() const noexcept { return context_; }
+
+    /**
+     * @brief Evaluate an expression using the caller's scratch state
+     *
+     * The expression is only read, so it may point into a larger buffer
+     * such as a mapped file; a cached program is found without copying
+     * it into a new string.
+     *
+     * @param expression The expression to evaluate
+     * @param scratch State owned by the calling thread
+     * @return Evaluation result containing value or error
+     */
+    EvaluationResult evaluate(std::string_view expression, EvaluationScratch& scratch) const;
+
+    /**
+     * @brief Evaluate an expression using a scratch owned by the calling thread
+     * @param expression The expression to evaluate
+     * @return Evaluation result containing value or error
+     */
+    EvaluationResult evaluate(std::string_view expression) const;
+
+    /**
+     * @brief Check whether this engine evaluates on fixed-width integers
+     *
+     * True for engines built from a ProgrammerMode. Their evaluate()
+     * returns the word of evaluateInteger() converted to a double.
+     */
+    bool isInteger() const noexcept { return integer_; }
+
+    /**
+     * @brief Evaluate an expression as a fixed-width integer
+     *
+     * Uses the word size and signedness of the ProgrammerMode the engine
+     * was built from, or 64-bit signed words for other engines.
+     *
+     * @param expression The expression to evaluate
+     * @param scratch State owned by the calling thread
+     * @return The exact word, or the error
+     */
+    IntegerResult evaluateInteger(std::string_view expression, EvaluationScratch& scratch) const;
+
+    /**
+     * @brief Format a successful integer result in the mode's display base
+     * @param result A successful result of evaluateInteger()
+     * @return What ProgrammerMode::formatResult() shows for it
+     */
+    std::string formatInteger(const IntegerResult& result) const;
+
+    /**
+     * @brief Check whether this engine evaluates on BigFloat
+     *
+     * True for engines built from a PrecisionMode. Their evaluate()
+     * returns the value of evaluatePrecise() rounded to a double.
+     */
+    bool isPrecise() const noexcept { return precise_; }
+
+    /**
+     * @brief Evaluate an expression at the snapshotted precision
+     * @param expression The expression to evaluate
+     * @param scratch State owned by the calling thread
+     * @return The value, or the error
+     */
+    BigFloatResult evaluatePrecise(std::string_view expression, EvaluationScratch& scratch) const;
+
+    /**
+     * @brief Format a successful precise result to the snapshotted precision
+     * @param result A successful result of evaluatePrecise()
+     * @return What PrecisionMode::formatResult() shows for it
+     */
+    std::string formatPrecise(const BigFloatResult& result) const;
+
+    /**
+     * @brief Evaluate one expression over struct-of-arrays input columns
+     * @param expression The expression string to evaluate
+     * @param columns Input columns, each with at least @p rows values
+     * @param rows Number of rows to evaluate
+     * @param out Output buffer with room for @p rows values
+     * @param scratch State owned by the calling thread
+     * @return Row and error counts; failed rows are written as NaN
+     * @see Mode::evaluateBatch()
+     */
+    BatchResult evaluateBatch(const std::string& expression,
+                              const std::vector<BatchColumn>& columns,
+                              size_t rows, double* out, EvaluationScratch& scratch) const;
+
+    /**
+     * @brief Fill the shared cache from an archive instead of parsing
+     *
+     * Each expression stored with its source text is loaded, compiled and
+     * cached under that text, so the first evaluate() of it is a cache hit.
+     * Expressions without a source, or already cached, are skipped; loading
+     * stops once the cache is full.
+     *
+     * @param archive The archive to load from
+     * @return Number of programs added to the cache
+     * @throws CalculatorException if an expression in the archive is malformed
+     */
+    size_t preload(const ExpressionArchive& archive);
+
+    /**
+     * @brief Get shared cache counters
+     *
+     * Hits count lookups served by the shared cache; lookups served by a
+     * thread's own table are not counted.
+     */
+    CacheStats getCacheStats() const;
+
+private:
+    using Program = EvaluationScratch::Program;
+
+    const uint64_t id_;
+    const std::string name_;
+    const EvaluationContext context_;
+    const size_t capacity_;
+    const ParserType parserType_;
+    bool integer_ = false;            ///< Built from a ProgrammerMode
+    WordSize wordSize_ = WordSize::BITS_64;
+    bool signed_ = true;
+    NumberBase displayBase_ = NumberBase::DECIMAL;
+    bool precise_ = false;            ///< Built from a PrecisionMode
+    size_t digits_ = 0;               ///< Significant digits of a precise engine
+
+    mutable std::shared_mutex mutex_;  ///< Guards programs_
+    mutable std::unordered_map<std::string, std::shared_ptr<const Program>> programs_;
+    mutable std::atomic<size_t> hits_{0};
+    mutable std::atomic<size_t> misses_{0};
+    mutable std::atomic<size_t> evictions_{0};
+
+    /**
+     * @brief Find or build the program for an expression
+     * @return The program, owned by the scratch's table
+     * @throws CalculatorException if the expression cannot be parsed
+     */
+    const Program& lookup(std::string_view expression, EvaluationScratch& scratch) const;
+
+    /**
+     * @brief Tokenize, parse and compile an expression
+     * @throws CalculatorException if the expression cannot be parsed
+     */
+    std::shared_ptr<const Program> build(std::string_view expression) const;
+};
+
+} // namespace calc
+
+#endif // CALC_MODES_SHARED_ENGINE_H
@@ -13,6 +13,22 @@
 
 namespace calc {
 
+/**
+ * @brief Parser implementations StandardMode can use
+ */
+enum class ParserType {
+    SHUNTING_YARD,      ///< ShuntingYardParser (default)
+    RECURSIVE_DESCENT,  ///< RecursiveDescentParser
+    PRATT               ///< PrattParser
+};
+
+/**
+ * @brief Create a parser
+ * @param type The parser implementation
+ * @return The new parser
+ */
+std::unique_ptr<Parser> createParser(ParserType type);
+
 /**
  * @brief Standard calculator mode
  *
@@ -20,6 +36,12 @@ namespace calc {
  * Supports parentheses for grouping
  * Supports negative numbers (unary minus)
  * Operator precedence: ^ (right-assoc) > *,/ > +,-
+ *
+ * Each cached expression is compiled to bytecode on first use and run on
+ * the mode's VirtualMachine afterwards; it is recompiled when a function,
+ * variable or operator is added or redefined. With caching disabled there
+ * is nothing to reuse the bytecode for, so the tree is walked with
+ * EvaluatorVisitor instead.
  */
 class StandardMode : public Mode {
 public:
@@ -38,8 +60,14 @@ public:
     std::string getName() const override;
     std::string getDescription() const override;
     EvaluationResult evaluate(const std::string& expression) override;
+    BatchResult evaluateBatch(const std::string& expression,
+                              const std::vector<BatchColumn>& columns,
+                              size_t rows, double* out) override;
     EvaluationContext& getContext() override;
     const EvaluationContext& getContext() const override;
+    CacheStats getCacheStats() const override;
+    void setCacheCapacity(size_t capacity) override;
+    void clearCache() override;
 
     /**
      * @brief Set the output precision
@@ -55,26 +83,48 @@ public:
 
     /**
      * @brief Get the parser type being used
-     * @return Parser type name ("shunting-yard" or "recursive-descent")
+     * @return Parser type name ("shunting-yard", "recursive-descent" or "pratt")
      */
     std::string getParserType() const;
 
+    /**
+     * @brief Get the parser implementation being used
+     */
+    ParserType getParserKind() const noexcept;
+
     /**
      * @brief Set the parser type to use
      * @param useRecursiveDescent If true, use recursive descent parser; otherwise shunting-yard
      */
     void setParserType(bool useRecursiveDescent);
 
+    /**
+     * @brief Set the parser type to use
+     * @param type The parser implementation
+     */
+    void setParserType(ParserType type);
+
 private:
     EvaluationContext context_;
     EvaluatorVisitor evaluator_;
-    bool useRecursiveDescentParser_;
+    ExpressionCache cache_;
+    VirtualMachine vm_;
+    ParserType parserType_;
+    CachedExpression uncached_;  ///< Holds the last tree while caching is disabled
 
     /**
      * @brief Create the appropriate parser based on current setting
      * @return Unique pointer to the parser
      */
     std::unique_ptr<Parser> createParser() const;
+
+    /**
+     * @brief Tokenize and parse an expression, reusing cached trees
+     * @param expression The expression string
+     * @return The cache entry holding the tree, valid until the next call
+     * @throws CalculatorException if the expression cannot be parsed
+     */
+    CachedExpression& parse(const std::string& expression);
 };
 
 } // namespace calc
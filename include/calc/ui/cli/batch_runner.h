@@ -0,0 +1,141 @@
+/**
+ * @file batch_runner.h
+ * @brief Parallel evaluation of expression files for the CLI
+ */
+
+#ifndef CALC_UI_CLI_BATCH_RUNNER_H
+#define CALC_UI_CLI_BATCH_RUNNER_H
+
+#include "calc/modes/shared_engine.h"
+#include "calc/ui/cli/command_parser.h"
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief Counters reported after a batch run
+ */
+struct BatchStats {
+    size_t lines = 0;        ///< Input lines read, including blank ones
+    size_t evaluated = 0;    ///< Non-blank lines evaluated
+    size_t failed = 0;       ///< Evaluated lines that produced an error
+    size_t bytesRead = 0;    ///< Input bytes, excluding line terminators
+    double seconds = 0.0;    ///< Wall-clock time of the run
+    unsigned workers = 0;    ///< Worker threads used
+
+    /**
+     * @brief Format the counters and throughput for display
+     */
+    std::string toString() const;
+};
+
+/**
+ * @brief Evaluate one input line and append its output record
+ *
+ * Appends the record OutputFormatter::appendRecord() writes for the
+ * result, or appendBlankRecord() for a blank line, including its
+ * terminator. Shared by the batch and streaming runners so all of them
+ * answer a line the same way. For integer engines (programmer mode) a
+ * successful TEXT record is the exact word formatted by
+ * SharedEngine::formatInteger(), and for precise engines (precision
+ * mode) the digits of SharedEngine::formatPrecise(), as a single
+ * expression prints them. JSONL, CSV and TSV records of integer engines
+ * carry the word in decimal; only BINARY rounds it to a double.
+ *
+ * @param engine The engine to evaluate with
+ * @param line The input line
+ * @param scratch The calling thread's scratch
+ * @param out Output to append to
+ * @param format The output format
+ * @return true if the line failed
+ */
+bool appendLineResult(const SharedEngine& engine, std::string_view line,
+                      EvaluationScratch& scratch, std::string& out,
+                      ResultFormat format = ResultFormat::TEXT);
+
+/**
+ * @brief Check whether an input line holds no expression
+ */
+bool isBlankLine(std::string_view line);
+
+/**
+ * @brief Evaluates one expression per input line on a pool of workers
+ *
+ * The workers are started once per run. The calling thread reads the
+ * input in chunks of lines, each stored back to back in one buffer with
+ * the offset of every line end, and writes finished chunks in input
+ * order; workers take chunks in order and append each line's record to
+ * the chunk's output buffer. Chunk buffers are reused from chunk to
+ * chunk, and at most a few chunks per worker are in flight, as in
+ * MappedRunner.
+ *
+ * Each output line is either the value or "Error: ..." for the matching
+ * input line; blank input lines produce blank output lines, so line N of
+ * the output always answers line N of the input. Other formats are
+ * chosen with setFormat(). Output is written a chunk at a time and never
+ * flushed per line.
+ */
+class BatchRunner {
+public:
+    /// Lines read and evaluated per chunk
+    static constexpr size_t DEFAULT_CHUNK_LINES = 1024;
+
+    /// Chunks in flight per worker, read but not yet written
+    static constexpr size_t CHUNKS_PER_WORKER = 4;
+
+    /**
+     * @brief Construct a runner
+     * @param engine The engine to evaluate with; must outlive the runner
+     * @param workers Worker threads (0 = one per hardware thread)
+     * @param chunkLines Lines per chunk (0 = DEFAULT_CHUNK_LINES)
+     */
+    explicit BatchRunner(const SharedEngine& engine, unsigned workers = 0,
+                         size_t chunkLines = DEFAULT_CHUNK_LINES);
+
+    ~BatchRunner();
+
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+
+    /**
+     * @brief Get the number of worker threads
+     */
+    unsigned getWorkerCount() const noexcept { return static_cast<unsigned>(scratch_.size()); }
+
+    /**
+     * @brief Set the format of the output records (default: TEXT)
+     */
+    void setFormat(ResultFormat format) noexcept { format_ = format; }
+
+    /**
+     * @brief Evaluate every line of a stream
+     * @param in Input, one expression per line
+     * @param out Output, one result per line
+     * @return Counters for the run
+     */
+    BatchStats run(std::istream& in, std::ostream& out);
+
+private:
+    struct Chunk;
+
+    const SharedEngine& engine_;
+    size_t chunkLines_;
+    ResultFormat format_ = ResultFormat::TEXT;
+    std::vector<std::unique_ptr<EvaluationScratch>> scratch_;  ///< One per worker, kept across runs
+
+    /**
+     * @brief Evaluate every line of one chunk into its output buffer
+     */
+    void evaluateChunk(Chunk& chunk, EvaluationScratch& scratch) const;
+};
+
+} // namespace cli
+} // namespace calc
+
+#endif // CALC_UI_CLI_BATCH_RUNNER_H
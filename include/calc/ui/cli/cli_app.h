@@ -10,6 +10,8 @@
 #include "calc/ui/cli/command_parser.h"
 #include "calc/ui/cli/output_formatter.h"
 #include "calc/ui/cli/history_manager.h"
+#include <fstream>
+#include <optional>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -74,6 +76,7 @@ private:
     ModeManager modeManager_;
     OutputFormatter formatter_;
     Mode* currentMode_;
+    bool bigWords_;  ///< Programmer mode evaluates on --bits words
 
     /**
      * @brief Process command-line arguments
@@ -90,6 +93,76 @@ private:
      */
     int evaluateExpression(const std::string& expression, const CommandLineOptions& options);
 
+    /**
+     * @brief Print the result of a single expression
+     * @param expression The expression
+     * @param result Its result
+     * @param digits The formatted value, if not the one formatValue() gives
+     * @param options Command-line options; format selects the output
+     * @param word The exact decimal value for JSONL, CSV and TSV, if the
+     *        double would round it
+     * @return Exit code
+     */
+    int reportResult(const std::string& expression, const EvaluationResult& result,
+                     const std::optional<std::string>& digits, const CommandLineOptions& options,
+                     const std::optional<std::string>& word = std::nullopt);
+
+    /**
+     * @brief Evaluate an expression in the current mode
+     * @param expression The expression to evaluate
+     * @param digits Set to the full-precision value in precision mode, and
+     *        to the exact word in programmer mode (of --bits bits if given)
+     * @param word If given, set to that word in decimal in programmer mode
+     * @return The result, rounded to a double in precision and programmer mode
+     */
+    EvaluationResult evaluateInCurrentMode(const std::string& expression,
+                                           std::optional<std::string>& digits,
+                                           std::optional<std::string>* word = nullptr);
+
+    /**
+     * @brief Evaluate every line of a file (or stdin) on worker threads
+     *
+     * Files are memory-mapped and evaluated in place by a MappedRunner;
+     * stdin is read in chunks of lines by a BatchRunner.
+     *
+     * @param options Command-line options; batchInput names the input
+     * @return Exit code (non-zero if the input cannot be read or any line failed)
+     */
+    int runBatchMode(const CommandLineOptions& options);
+
+    /**
+     * @brief Open the output named by --output, or select stdout
+     * @param options Command-line options
+     * @param file Stream to open if a file is named
+     * @return The stream to write results to, or nullptr if the file cannot be opened
+     */
+    std::ostream* openOutput(const CommandLineOptions& options, std::ofstream& file);
+
+    /**
+     * @brief Evaluate stdin line by line as a filter, writing results to stdout
+     * @param options Command-line options; flushEvery sets the flush interval
+     * @return Exit code (non-zero if any line failed)
+     */
+    int runStreamMode(const CommandLineOptions& options);
+
+    /**
+     * @brief Serve evaluation requests on a Unix domain socket until interrupted
+     * @param options Command-line options; servePath names the socket, jobs the workers
+     * @return Exit code (non-zero if the socket cannot be served)
+     */
+    int runServeMode(const CommandLineOptions& options);
+
+    /**
+     * @brief Evaluate on a running daemon instead of in this process
+     *
+     * Sends the expression, or the lines of --stdin or --batch, to the
+     * daemon at connectPath and prints the results as a local run would.
+     *
+     * @param options Command-line options
+     * @return Exit code (non-zero if the daemon cannot be reached or any expression failed)
+     */
+    int runClientMode(const CommandLineOptions& options);
+
     /**
      * @brief Run interactive REPL mode
      * @param options Command-line options
@@ -182,6 +255,12 @@ private:
      * @param filepath Path to export file
      */
     void handleExportCommand(const REPLState& state, const std::string& filepath);
+
+    /**
+     * @brief Handle cache command
+     * @param args Empty to show statistics, "clear", or "size <n>"
+     */
+    void handleCacheCommand(const std::string& args);
 };
 
 } // namespace cli
@@ -22,6 +22,17 @@ enum class ColorMode {
     NEVER    ///< Never use colors
 };
 
+/**
+ * @brief Output format for evaluation results
+ */
+enum class ResultFormat {
+    TEXT,    ///< Human-readable text (default)
+    JSONL,   ///< One JSON object per result
+    CSV,     ///< Comma-separated values after a header row
+    TSV,     ///< Tab-separated values after a header row
+    BINARY   ///< Packed records: little-endian double and a status byte
+};
+
 /**
  * @brief Parsed command-line options
  */
@@ -32,9 +43,19 @@ struct CommandLineOptions {
     bool showHelp = false;                   ///< Show help message
     bool showVersion = false;                 ///< Show version information
     bool useRecursiveDescent = false;          ///< Use recursive descent parser
+    std::string parser = "shunting-yard";     ///< Parser for standard/scientific modes
     bool interactive = false;                  ///< Interactive mode
     ColorMode colorMode = ColorMode::AUTO;    ///< Color output mode
     std::vector<std::string> expressions;     ///< Multiple expressions to evaluate
+    std::optional<std::string> batchInput;    ///< File of expressions to evaluate ("-" = stdin)
+    unsigned jobs = 0;                        ///< Batch worker threads (0 = one per core)
+    bool streamInput = false;                 ///< Stream stdin to stdout, one result per line
+    size_t flushEvery = 0;                    ///< Flush streamed output every N lines (0 = when full)
+    std::optional<std::string> outputPath;    ///< File for batch and streamed results (default: stdout)
+    ResultFormat format = ResultFormat::TEXT; ///< Format of evaluation results
+    std::optional<std::string> servePath;     ///< Socket to serve evaluation requests on
+    std::optional<std::string> connectPath;   ///< Socket of a daemon to evaluate on
+    std::optional<size_t> bigWordBits;        ///< Programmer-mode word size above 64 bits (0 = unbounded)
 };
 
 /**
@@ -0,0 +1,102 @@
+/**
+ * @file daemon_client.h
+ * @brief Client side of the calc daemon protocol
+ */
+
+#ifndef CALC_UI_CLI_DAEMON_CLIENT_H
+#define CALC_UI_CLI_DAEMON_CLIENT_H
+
+#include "calc/ui/cli/batch_runner.h"
+#include "calc/ui/cli/command_parser.h"
+#include "calc/ui/cli/daemon_protocol.h"
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief A connection to a DaemonServer
+ *
+ * Sends requests and reads their responses over a Unix domain socket.
+ * send() and receive() may be interleaved freely: responses arrive in the
+ * order the requests were sent, so several requests can be in flight.
+ */
+class DaemonClient {
+public:
+    /// Input lines sent per request by run()
+    static constexpr size_t LINES_PER_REQUEST = 1024;
+
+    /// Requests run() keeps in flight before reading a response
+    static constexpr size_t REQUESTS_IN_FLIGHT = 8;
+
+    /**
+     * @brief Construct an unconnected client
+     */
+    DaemonClient() = default;
+
+    ~DaemonClient();
+
+    DaemonClient(DaemonClient&& other) noexcept;
+    DaemonClient& operator=(DaemonClient&& other) noexcept;
+
+    DaemonClient(const DaemonClient&) = delete;
+    DaemonClient& operator=(const DaemonClient&) = delete;
+
+    /**
+     * @brief Connect to a daemon
+     * @param path Filesystem path of the daemon's socket
+     * @throws std::runtime_error if nothing listens on the socket
+     */
+    static DaemonClient connect(const std::string& path);
+
+    /**
+     * @brief Send a request without waiting for its response
+     * @throws std::runtime_error if the connection fails
+     */
+    void send(const DaemonRequest& request);
+
+    /**
+     * @brief Wait for the response to the oldest unanswered request
+     * @throws std::runtime_error if the connection closes or the response is malformed
+     */
+    DaemonResponse receive();
+
+    /**
+     * @brief Send a request and wait for its response
+     * @throws std::runtime_error if the connection fails
+     */
+    DaemonResponse evaluate(const DaemonRequest& request);
+
+    /**
+     * @brief Evaluate one expression per input line on the daemon
+     *
+     * Lines are sent in requests of LINES_PER_REQUEST, with up to
+     * REQUESTS_IN_FLIGHT unanswered at a time, and answered in the same
+     * records StreamRunner writes; values in text records are the daemon's
+     * formatted text, so precision mode keeps all of its digits. With
+     * @p flushLines, requests carry that many lines and each is answered,
+     * written and flushed before more input is read, for consumers reading
+     * while input still arrives.
+     *
+     * @param in Input, one expression per line
+     * @param out Output, one record per line
+     * @param settings Mode and precision of every request; its expressions are ignored
+     * @param format The output format
+     * @param flushLines Lines per flushed request (0 = pipeline and flush at the end)
+     * @return Counters for the run
+     * @throws std::runtime_error if the connection fails or the daemon rejects a request
+     */
+    BatchStats run(std::istream& in, std::ostream& out, const DaemonRequest& settings,
+                   ResultFormat format = ResultFormat::TEXT, size_t flushLines = 0);
+
+private:
+    int fd_ = -1;
+    std::string buffer_;   ///< Received bytes not yet returned by receive()
+};
+
+} // namespace cli
+} // namespace calc
+
+#endif // CALC_UI_CLI_DAEMON_CLIENT_H
@@ -0,0 +1,131 @@
+/**
+ * @file daemon_protocol.h
+ * @brief Length-prefixed request/response protocol of the calc daemon
+ */
+
+#ifndef CALC_UI_CLI_DAEMON_PROTOCOL_H
+#define CALC_UI_CLI_DAEMON_PROTOCOL_H
+
+#include "calc/core/evaluator.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief One request: expressions to evaluate in a mode
+ */
+struct DaemonRequest {
+    std::string mode;                      ///< Mode to evaluate in ("" = the daemon's default)
+    int precision = -1;                    ///< Digits of the formatted values (-1 = the mode's)
+    std::vector<std::string> expressions;  ///< Expressions, answered in order
+};
+
+/**
+ * @brief The answer to one expression of a request
+ */
+struct DaemonResult {
+    uint8_t status = 0;     ///< 0 = value, otherwise 1 + the ErrorCode
+    double value = 0.0;     ///< Value, rounded to a double in precision mode
+    uint32_t position = 0;  ///< Error position
+    std::string text;       ///< Value formatted at the request's precision, or the error message
+
+    /**
+     * @brief Check whether the expression produced a value
+     */
+    bool isSuccess() const noexcept { return status == 0; }
+
+    /**
+     * @brief Build the result of an evaluation
+     * @param result The evaluation result
+     * @param text The formatted value, ignored for errors
+     */
+    static DaemonResult fromEvaluation(const EvaluationResult& result, std::string text);
+
+    /**
+     * @brief Convert back to an evaluation result
+     */
+    EvaluationResult toEvaluationResult() const;
+};
+
+/**
+ * @brief The answer to one request
+ */
+struct DaemonResponse {
+    std::string error;                  ///< Why the whole request failed ("" = it did not)
+    std::vector<DaemonResult> results;  ///< One per expression of the request
+};
+
+/**
+ * @brief Encoding of daemon requests and responses
+ *
+ * Every message is a frame: a 32-bit little-endian body length followed
+ * by the body. Integers in a body are little-endian and strings are a
+ * 32-bit length followed by their bytes.
+ *
+ * Request body: version byte (PROTOCOL_VERSION), mode string, signed
+ * 32-bit precision, expression count, then each expression string.
+ *
+ * Response body: a kind byte; for RESPONSE_ERROR, the message string;
+ * for RESPONSE_RESULTS, the result count, then per result the status
+ * byte, the value as a 64-bit IEEE double, the 32-bit error position and
+ * the text string.
+ *
+ * A client may send many requests before reading any response;
+ * responses come back in the order of the requests on each connection.
+ */
+class DaemonProtocol {
+public:
+    /// Version byte at the start of every request body
+    static constexpr uint8_t PROTOCOL_VERSION = 1;
+
+    /// Bytes in a frame's length prefix
+    static constexpr size_t HEADER_BYTES = 4;
+
+    /// Largest body accepted; longer frames are a protocol error
+    static constexpr size_t MAX_FRAME_BYTES = 64 * 1024 * 1024;
+
+    /// Response kinds
+    static constexpr uint8_t RESPONSE_RESULTS = 0;
+    static constexpr uint8_t RESPONSE_ERROR = 1;
+
+    /**
+     * @brief Get the body length of the frame at the start of a buffer
+     * @param buffer Bytes received so far
+     * @return The body length, or nothing if the length prefix is incomplete
+     * @throws std::runtime_error if the length exceeds MAX_FRAME_BYTES
+     */
+    static std::optional<size_t> frameLength(std::string_view buffer);
+
+    /**
+     * @brief Append a request frame
+     */
+    static void appendRequest(std::string& out, const DaemonRequest& request);
+
+    /**
+     * @brief Decode a request body
+     * @throws std::runtime_error if the body is malformed
+     */
+    static DaemonRequest parseRequest(std::string_view body);
+
+    /**
+     * @brief Append a response frame
+     */
+    static void appendResponse(std::string& out, const DaemonResponse& response);
+
+    /**
+     * @brief Decode a response body
+     * @throws std::runtime_error if the body is malformed
+     */
+    static DaemonResponse parseResponse(std::string_view body);
+};
+
+} // namespace cli
+} // namespace calc
+
+#endif // CALC_UI_CLI_DAEMON_PROTOCOL_H
@@ -0,0 +1,174 @@
+/**
+ * @file daemon_server.h
+ * @brief Persistent evaluation daemon on a Unix domain socket
+ */
+
+#ifndef CALC_UI_CLI_DAEMON_SERVER_H
+#define CALC_UI_CLI_DAEMON_SERVER_H
+
+#include "calc/modes/mode_manager.h"
+#include "calc/ui/cli/daemon_protocol.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief Serves DaemonProtocol requests on a Unix domain socket
+ *
+ * One thread runs an epoll loop that accepts connections, reads request
+ * frames and writes response frames, never blocking on a client. Each
+ * request is handed to a pool of workers, which evaluate its expressions
+ * and encode the response; the loop writes responses back in request
+ * order per connection, so clients may pipeline as many requests as
+ * they like. A connection with MAX_PENDING_REQUESTS unanswered requests
+ * is not read from until some are answered.
+ *
+ * Modes come from a ModeManager and are snapshotted into a SharedEngine
+ * the first time a request names them; precision mode is evaluated by a
+ * PrecisionMode owned by each worker, at the precision of the request.
+ * Linux only: elsewhere listen() throws.
+ */
+class DaemonServer {
+public:
+    /// Unanswered requests per connection before it stops being read
+    static constexpr size_t MAX_PENDING_REQUESTS = 64;
+
+    /// Largest precision accepted for modes that evaluate in double precision
+    static constexpr int MAX_DOUBLE_PRECISION = 100;
+
+    /**
+     * @brief Construct a server
+     * @param modes Modes to serve; must outlive the server and is only used by run()'s thread
+     * @param defaultMode Mode of requests that name none
+     * @param workers Worker threads (0 = one per hardware thread)
+     */
+    DaemonServer(ModeManager& modes, std::string defaultMode, unsigned workers = 0);
+
+    ~DaemonServer();
+
+    DaemonServer(const DaemonServer&) = delete;
+    DaemonServer& operator=(const DaemonServer&) = delete;
+
+    /**
+     * @brief Get the number of worker threads
+     */
+    unsigned getWorkerCount() const noexcept { return workerCount_; }
+
+    /**
+     * @brief Bind the socket and start listening
+     *
+     * A leftover socket file that no daemon answers on is replaced; the
+     * file is removed again when the server is destroyed.
+     *
+     * @param path Filesystem path of the socket
+     * @throws std::runtime_error if the socket cannot be created or is in use
+     */
+    void listen(const std::string& path);
+
+    /**
+     * @brief Serve connections until stop() is called
+     * @throws std::runtime_error if listen() has not succeeded
+     */
+    void run();
+
+    /**
+     * @brief Make run() return; safe from other threads and signal handlers
+     */
+    void stop() noexcept;
+
+private:
+    struct Connection;
+    struct ModeEngine;
+    struct Job;
+    struct Completion;
+    struct WorkerState;
+
+    ModeManager& modes_;
+    const std::string defaultMode_;
+    const unsigned workerCount_;
+    std::string socketPath_;
+
+    int listenFd_ = -1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;     ///< eventfd written by workers and stop()
+    std::atomic<bool> stopping_{false};
+
+    // Owned by run()'s thread
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections_;
+    std::unordered_map<std::string, std::unique_ptr<ModeEngine>> engines_;
+    uint64_t nextConnectionId_;  ///< epoll tokens below it are the listening socket and wakeFd_
+
+    // Shared with the workers
+    std::mutex mutex_;
+    std::condition_variable jobReady_;
+    std::deque<std::unique_ptr<Job>> jobs_;
+    std::vector<Completion> completions_;
+    bool shutdown_ = false;
+    std::vector<std::thread> workers_;
+
+    void acceptConnections();
+
+    /**
+     * @brief Read what a connection has sent and start its complete requests
+     * @return false if the connection was closed
+     */
+    bool readConnection(Connection& connection, uint32_t events);
+
+    /**
+     * @brief Queue the connection's complete requests, write its responses
+     *        and update what it waits for
+     * @return false if the connection was closed
+     */
+    bool serviceConnection(Connection& connection);
+
+    /**
+     * @brief Parse buffered request frames and queue them for the workers
+     * @throws std::runtime_error if a frame is malformed
+     */
+    void dispatchRequests(Connection& connection);
+
+    /**
+     * @brief Hand finished responses to their connections
+     */
+    void collectCompletions();
+
+    /**
+     * @brief Queue a response for writing once those before it are written
+     */
+    void deliver(Connection& connection, uint64_t sequence, std::string response);
+
+    void closeConnection(uint64_t id);
+
+    /**
+     * @brief Stop the workers and drop every connection and queued job
+     */
+    void stopWorkers();
+
+    /**
+     * @brief Find or build the engine for a mode named in a request
+     * @return The engine, or nullptr if no such mode exists
+     */
+    const ModeEngine* findEngine(const std::string& name);
+
+    void workerLoop(WorkerState& state);
+
+    /**
+     * @brief Evaluate a request and append its response frame
+     */
+    void evaluate(const Job& job, WorkerState& state, std::string& out) const;
+};
+
+} // namespace cli
+} // namespace calc
+
+#endif // CALC_UI_CLI_DAEMON_SERVER_H
@@ -0,0 +1,129 @@
+/**
+ * @file mapped_runner.h
+ * @brief Parallel evaluation of memory-mapped expression files for the CLI
+ */
+
+#ifndef CALC_UI_CLI_MAPPED_RUNNER_H
+#define CALC_UI_CLI_MAPPED_RUNNER_H
+
+#include "calc/modes/shared_engine.h"
+#include "calc/ui/cli/batch_runner.h"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief A whole file, read-only, mapped into memory
+ *
+ * Uses mmap where available and reads the file into memory otherwise.
+ * Copies share the mapping, which stays valid until the last copy is
+ * destroyed.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Construct an empty file
+     */
+    MappedFile() = default;
+
+    /**
+     * @brief Map a file
+     * @param path The file to map
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    static MappedFile open(const std::string& path);
+
+    /**
+     * @brief Get the file's contents; valid while the file is
+     */
+    std::string_view view() const noexcept { return std::string_view(data_, size_); }
+
+    /**
+     * @brief Get the file's size in bytes
+     */
+    size_t size() const noexcept { return size_; }
+
+private:
+    std::shared_ptr<const void> storage_;  ///< Keeps the mapping or buffer alive
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Evaluates one expression per line of a buffer on a pool of workers
+ *
+ * Meant for multi-gigabyte files mapped with MappedFile. The buffer is
+ * cut into chunks of about the chunk size, each ending on a line
+ * boundary; the boundaries are found independently per chunk, so there
+ * is no serial splitting pass. Workers take chunks in order and evaluate
+ * each line in place, as a view into the buffer, through the
+ * string_view path of SharedEngine. Each chunk's results go to a buffer
+ * of their own, which the calling thread writes in input order while
+ * later chunks are still being evaluated; at most a few chunks per
+ * worker are in flight, so memory stays bounded however large the input.
+ *
+ * Output lines answer input lines exactly as BatchRunner answers them.
+ */
+class MappedRunner {
+public:
+    /// Input bytes per chunk
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 1024 * 1024;
+
+    /// Chunks in flight per worker, evaluated but not yet written
+    static constexpr size_t CHUNKS_PER_WORKER = 4;
+
+    /**
+     * @brief Construct a runner
+     * @param engine The engine to evaluate with; must outlive the runner
+     * @param workers Worker threads (0 = one per hardware thread)
+     * @param chunkBytes Input bytes per chunk (0 = DEFAULT_CHUNK_BYTES)
+     */
+    explicit MappedRunner(const SharedEngine& engine, unsigned workers = 0,
+                          size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+
+    ~MappedRunner();
+
+    MappedRunner(const MappedRunner&) = delete;
+    MappedRunner& operator=(const MappedRunner&) = delete;
+
+    /**
+     * @brief Get the number of worker threads
+     */
+    unsigned getWorkerCount() const noexcept { return static_cast<unsigned>(scratch_.size()); }
+
+    /**
+     * @brief Set the format of the output records (default: TEXT)
+     */
+    void setFormat(ResultFormat format) noexcept { format_ = format; }
+
+    /**
+     * @brief Evaluate every line of a buffer
+     * @param input Input, one expression per line; the last line may lack a terminator
+     * @param out Output, one result per line
+     * @return Counters for the run
+     */
+    BatchStats run(std::string_view input, std::ostream& out);
+
+private:
+    struct Chunk;
+
+    const SharedEngine& engine_;
+    size_t chunkBytes_;
+    ResultFormat format_ = ResultFormat::TEXT;
+    std::vector<std::unique_ptr<EvaluationScratch>> scratch_;  ///< One per worker, kept across runs
+
+    /**
+     * @brief Evaluate every line of one chunk into its output buffer
+     */
+    void evaluateChunk(std::string_view lines, Chunk& chunk, EvaluationScratch& scratch) const;
+};
+
+} // namespace cli
+} // namespace calc
+
+#endif // CALC_UI_CLI_MAPPED_RUNNER_H
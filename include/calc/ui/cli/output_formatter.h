@@ -9,6 +9,7 @@
 #include "calc/core/evaluator.h"
 #include "calc/ui/cli/command_parser.h"
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
 
@@ -61,6 +62,14 @@ public:
      */
     std::string formatResult(const EvaluationResult& result);
 
+    /**
+     * @brief Format a successful result whose value is already formatted
+     * @param expression The original expression
+     * @param value The formatted value, e.g. the digits of a precision mode result
+     * @return Formatted output string
+     */
+    std::string formatResult(const std::string& expression, const std::string& value);
+
     /**
      * @brief Format an expression for display
      * @param expression The expression string
@@ -76,6 +85,90 @@ public:
      */
     std::string formatSeparator(size_t length = 40, char character = '-');
 
+    /**
+     * @brief Format a double value
+     * @param value The value to format
+     * @param precision The precision to use
+     * @return Formatted string, without color
+     */
+    static std::string formatValue(double value, int precision = 6);
+
+    /**
+     * @brief Append a double value formatted as by formatValue()
+     * @param out String to append to
+     * @param value The value to format
+     * @param precision The precision to use
+     */
+    static void appendValue(std::string& out, double value, int precision = 6);
+
+    /**
+     * @brief Append the shortest decimal form that reads back as the same double
+     * @param out String to append to
+     * @param value The value to format; infinities and NaN as "inf", "-inf" and "nan"
+     */
+    static void appendShortest(std::string& out, double value);
+
+    /// Bytes in one ResultFormat::BINARY record
+    static constexpr size_t BINARY_RECORD_BYTES = 9;
+
+    /// Status byte of a successful BINARY record; errors store 1 + the ErrorCode
+    static constexpr unsigned char BINARY_STATUS_OK = 0;
+
+    /// Status byte of the BINARY record for a blank input line
+    static constexpr unsigned char BINARY_STATUS_BLANK = 255;
+
+    /**
+     * @brief Get the header that starts a result stream
+     * @param format The output format
+     * @return The header row for CSV and TSV, empty for the other formats
+     */
+    static std::string_view recordHeader(ResultFormat format);
+
+    /**
+     * @brief Append one result as a record, including its line terminator
+     *
+     * TEXT writes the value formatted by appendValue() or "Error: ...";
+     * JSONL, CSV and TSV write the expression with either the shortest
+     * round-trip value or the error code, message and position; BINARY
+     * writes the value (or, for an error, its position) as a little-endian
+     * double followed by a status byte.
+     *
+     * @param out String to append to
+     * @param format The output format
+     * @param expression The evaluated expression
+     * @param result The result to append
+     * @param precision Digits after the point for TEXT
+     */
+    static void appendRecord(std::string& out, ResultFormat format, std::string_view expression,
+                             const EvaluationResult& result, int precision = 6);
+
+    /**
+     * @brief Append one result whose value is already written out exactly
+     *
+     * As appendRecord() above, except that a successful TEXT, JSONL, CSV
+     * or TSV record carries @p value verbatim, such as a programmer word
+     * past 2^53 that the double would round. BINARY writes the double.
+     *
+     * @param out String to append to
+     * @param format The output format
+     * @param expression The evaluated expression
+     * @param result The result to append
+     * @param value The exact value; a valid JSON number for JSONL
+     */
+    static void appendRecord(std::string& out, ResultFormat format, std::string_view expression,
+                             const EvaluationResult& result, std::string_view value);
+
+    /**
+     * @brief Append the record for a blank input line
+     *
+     * An empty line in TEXT, a NaN with BINARY_STATUS_BLANK in BINARY, and
+     * nothing in the formats whose records carry their expression.
+     *
+     * @param out String to append to
+     * @param format The output format
+     */
+    static void appendBlankRecord(std::string& out, ResultFormat format);
+
     /**
      * @brief Enable or disable colored output
      * @param enabled Whether to enable colors
@@ -156,14 +249,6 @@ private:
      * @return ANSI color code
      */
     std::string getErrorColorCode(ErrorCode code);
-
-    /**
-     * @brief Format a double value
-     * @param value The value to format
-     * @param precision The precision to use
-     * @return Formatted string
-     */
-    std::string formatValue(double value, int precision = 6);
 };
 
 } // namespace cli
@@ -0,0 +1,70 @@
+/**
+ * @file stream_runner.h
+ * @brief Line-at-a-time evaluation of standard input for the CLI
+ */
+
+#ifndef CALC_UI_CLI_STREAM_RUNNER_H
+#define CALC_UI_CLI_STREAM_RUNNER_H
+
+#include "calc/modes/shared_engine.h"
+#include "calc/ui/cli/batch_runner.h"
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief Evaluates an unbounded stream of expressions, one per line
+ *
+ * Meant for use as a Unix filter: there is no banner, prompt or history.
+ * Each line is read into one reused string and answered exactly as by
+ * BatchRunner, so memory stays constant however long the input runs.
+ * Results collect in an output buffer that is written when it fills and
+ * at the end of input, never flushed per line. Consumers that read
+ * results while input is still arriving can ask for a flush every N
+ * lines instead.
+ */
+class StreamRunner {
+public:
+    /// Output bytes collected before a write
+    static constexpr size_t DEFAULT_BUFFER_BYTES = 256 * 1024;
+
+    /**
+     * @brief Construct a runner
+     * @param engine The engine to evaluate with; must outlive the runner
+     * @param flushLines Write and flush every this many lines (0 = only when the buffer fills)
+     * @param bufferBytes Output buffer size (0 = DEFAULT_BUFFER_BYTES)
+     */
+    explicit StreamRunner(const SharedEngine& engine, size_t flushLines = 0,
+                          size_t bufferBytes = DEFAULT_BUFFER_BYTES);
+
+    StreamRunner(const StreamRunner&) = delete;
+    StreamRunner& operator=(const StreamRunner&) = delete;
+
+    /**
+     * @brief Set the format of the output records (default: TEXT)
+     */
+    void setFormat(ResultFormat format) noexcept { format_ = format; }
+
+    /**
+     * @brief Evaluate every line of a stream until end of input
+     * @param in Input, one expression per line
+     * @param out Output, one result per line
+     * @return Counters for the run
+     */
+    BatchStats run(std::istream& in, std::ostream& out);
+
+private:
+    const SharedEngine& engine_;
+    size_t flushLines_;
+    size_t bufferBytes_;
+    ResultFormat format_ = ResultFormat::TEXT;
+    EvaluationScratch scratch_;
+};
+
+} // namespace cli
+} // namespace calc
+
+#endif // CALC_UI_CLI_STREAM_RUNNER_H
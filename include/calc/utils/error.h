@@ -25,6 +25,7 @@ enum class ErrorCode {
     INVALID_BASE, ///< Invalid numeric base for conversion
     PARSE_ERROR,        ///< General parsing error
     EVALUATION_ERROR,   ///< General evaluation error
+    UNDEFINED_VARIABLE, ///< Variable referenced but never assigned
     UNKNOWN_ERROR       ///< Unknown error type
 };
 
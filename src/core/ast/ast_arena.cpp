@@ -0,0 +1,98 @@
+/**
+ * @file ast_arena.cpp
+ * @brief ASTArena and ASTNode allocation implementation
+ */
+
+#include "calc/core/ast_arena.h"
+#include "calc/core/ast.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace calc {
+
+// ============================================================================
+// ASTArena Implementation
+// ============================================================================
+
+ASTArena::ASTArena(size_t blockSize)
+    : cursor_(nullptr)
+    , end_(nullptr)
+    , nextBlockSize_(std::max<size_t>(blockSize, 64))
+    , bytesUsed_(0)
+    , bytesReserved_(0) {
+}
+
+void* ASTArena::allocate(size_t size, size_t alignment) {
+    auto address = reinterpret_cast<std::uintptr_t>(cursor_);
+    size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+
+    if (cursor_ == nullptr || padding + size > static_cast<size_t>(end_ - cursor_)) {
+        // Oversized requests get a block of their own size; the next
+        // ordinary block keeps growing geometrically
+        size_t blockSize = std::max(nextBlockSize_, size + alignment);
+        blocks_.push_back(std::make_unique<unsigned char[]>(blockSize));
+        cursor_ = blocks_.back().get();
+        end_ = cursor_ + blockSize;
+        bytesReserved_ += blockSize;
+        nextBlockSize_ = std::min(nextBlockSize_ * 2, MAX_BLOCK_SIZE);
+
+        address = reinterpret_cast<std::uintptr_t>(cursor_);
+        padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+    }
+
+    unsigned char* result = cursor_ + padding;
+    cursor_ = result + size;
+    bytesUsed_ += padding + size;
+    return result;
+}
+
+// ============================================================================
+// ASTNode Allocation
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Prefix stored in front of every node, recording where it lives
+ *
+ * operator delete runs after the node's destructor, so the owner cannot
+ * be kept in the node itself.
+ */
+struct alignas(std::max_align_t) NodeHeader {
+    ASTArena* arena;  ///< Owning arena, or nullptr for heap nodes
+};
+
+inline NodeHeader* headerOf(void* node) {
+    return static_cast<NodeHeader*>(node) - 1;
+}
+
+} // anonymous namespace
+
+void* ASTNode::operator new(std::size_t size) {
+    auto* header = static_cast<NodeHeader*>(::operator new(sizeof(NodeHeader) + size));
+    header->arena = nullptr;
+    return header + 1;
+}
+
+void* ASTNode::operator new(std::size_t size, ASTArena& arena) {
+    auto* header = static_cast<NodeHeader*>(
+        arena.allocate(sizeof(NodeHeader) + size, alignof(NodeHeader)));
+    header->arena = &arena;
+    return header + 1;
+}
+
+void ASTNode::operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    NodeHeader* header = headerOf(ptr);
+    if (header->arena == nullptr) {
+        ::operator delete(header);
+    }
+}
+
+void ASTNode::operator delete(void*, ASTArena&) noexcept {
+    // Arena memory is released with the arena
+}
+
+} // namespace calc
@@ -0,0 +1,127 @@
+/**
+ * @file ast_walker.cpp
+ * @brief Non-recursive tree traversal, cloning and teardown
+ */
+
+#include "calc/core/ast.h"
+
+namespace calc {
+
+// ============================================================================
+// PostOrderWalker Implementation
+// ============================================================================
+
+bool PostOrderWalker::walk(ASTNode& root, ASTVisitor& visitor) {
+    stopped_ = false;
+    stack_.clear();
+    stack_.push_back({&root, 0, root.getChildCount()});
+
+    while (!stack_.empty()) {
+        Frame& top = stack_.back();
+        if (top.nextChild < top.childCount) {
+            ASTNode* child = top.node->getChild(top.nextChild++);
+            size_t childCount = child->getChildCount();
+            if (childCount == 0) {
+                // Leaves are visited at once rather than pushed and popped
+                child->accept(visitor);
+            } else {
+                stack_.push_back({child, 0, childCount});
+                continue;
+            }
+        } else {
+            ASTNode* node = top.node;
+            stack_.pop_back();
+            node->accept(visitor);
+        }
+
+        if (stopped_) {
+            stack_.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Cloning
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Rebuilds each node on the heap from its already cloned children
+ */
+class TreeCloner : public ASTVisitor {
+public:
+    std::vector<std::unique_ptr<ASTNode>> results;
+
+    void visit(LiteralNode& node) override {
+        results.push_back(node.clone());
+    }
+
+    void visit(VariableNode& node) override {
+        results.push_back(node.clone());
+    }
+
+    void visit(BinaryOpNode& node) override {
+        std::unique_ptr<ASTNode> right = pop();
+        std::unique_ptr<ASTNode> left = pop();
+        results.push_back(std::make_unique<BinaryOpNode>(
+            std::move(left), node.getOpCode(), node.getPosition(), std::move(right)));
+    }
+
+    void visit(UnaryOpNode& node) override {
+        std::unique_ptr<ASTNode> operand = pop();
+        results.push_back(std::make_unique<UnaryOpNode>(
+            node.getOpCode(), node.getPosition(), std::move(operand)));
+    }
+
+    void visit(FunctionCallNode& node) override {
+        auto first = results.end() - static_cast<std::ptrdiff_t>(node.getArgumentCount());
+        ASTNodeList args;
+        args.reserve(node.getArgumentCount());
+        for (auto it = first; it != results.end(); ++it) {
+            args.push_back(std::move(*it));
+        }
+        results.erase(first, results.end());
+        results.push_back(std::make_unique<FunctionCallNode>(
+            node.getName(), node.getPosition(), std::move(args)));
+    }
+
+private:
+    std::unique_ptr<ASTNode> pop() {
+        std::unique_ptr<ASTNode> node = std::move(results.back());
+        results.pop_back();
+        return node;
+    }
+};
+
+} // anonymous namespace
+
+std::unique_ptr<ASTNode> ASTNode::cloneTree(const ASTNode& root) {
+    TreeCloner cloner;
+    PostOrderWalker walker;
+    walker.walk(const_cast<ASTNode&>(root), cloner);
+    return std::move(cloner.results.back());
+}
+
+// ============================================================================
+// Teardown
+// ============================================================================
+
+void ASTNode::destroySubtrees(ASTNode& node) noexcept {
+    std::vector<std::unique_ptr<ASTNode>> pending;
+    try {
+        node.detachChildren(pending);
+        while (!pending.empty()) {
+            std::unique_ptr<ASTNode> next = std::move(pending.back());
+            pending.pop_back();
+            // Once its inner children are detached, destroying next cannot recurse
+            next->detachChildren(pending);
+        }
+    } catch (...) {
+        // Out of memory for the stack: what is left is destroyed recursively
+    }
+}
+
+} // namespace calc
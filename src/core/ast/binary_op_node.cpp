@@ -7,11 +7,23 @@
 
 namespace calc {
 
-BinaryOpNode::BinaryOpNode(std::unique_ptr<ASTNode> left, Token op, std::unique_ptr<ASTNode> right)
-    : left_(std::move(left)), op_(op), right_(std::move(right)) {}
+BinaryOpNode::BinaryOpNode(std::unique_ptr<ASTNode> left, const Token& op, std::unique_ptr<ASTNode> right)
+    : left_(std::move(left)), right_(std::move(right)), position_(op.position), op_(op.opcode) {}
+
+BinaryOpNode::BinaryOpNode(std::unique_ptr<ASTNode> left, OpCode op, size_t position,
+                           std::unique_ptr<ASTNode> right)
+    : left_(std::move(left)), right_(std::move(right)), position_(position), op_(op) {}
+
+BinaryOpNode::~BinaryOpNode() {
+    destroySubtrees(*this);
+}
+
+Token BinaryOpNode::getOperator() const {
+    return Token(TokenType::OPERATOR, opCodeSymbol(op_), position_, op_);
+}
 
 std::unique_ptr<ASTNode> BinaryOpNode::clone() const {
-    return std::make_unique<BinaryOpNode>(left_->clone(), op_, right_->clone());
+    return cloneTree(*this);
 }
 
 void BinaryOpNode::accept(ASTVisitor& visitor) {
@@ -19,7 +31,7 @@ void BinaryOpNode::accept(ASTVisitor& visitor) {
 }
 
 std::string BinaryOpNode::toString() const {
-    return "(" + left_->toString() + " " + op_.value + " " + right_->toString() + ")";
+    return "(" + left_->toString() + " " + opCodeSymbol(op_) + " " + right_->toString() + ")";
 }
 
 std::unique_ptr<ASTNode> BinaryOpNode::releaseLeft() {
@@ -30,4 +42,13 @@ std::unique_ptr<ASTNode> BinaryOpNode::releaseRight() {
     return std::move(right_);
 }
 
+void BinaryOpNode::detachChildren(std::vector<std::unique_ptr<ASTNode>>& out) {
+    if (left_ && left_->getChildCount() > 0) {
+        out.push_back(std::move(left_));
+    }
+    if (right_ && right_->getChildCount() > 0) {
+        out.push_back(std::move(right_));
+    }
+}
+
 } // namespace calc
@@ -4,14 +4,23 @@
  */
 
 #include "calc/core/ast.h"
+#include <iterator>
 #include <sstream>
 
 namespace calc {
 
 FunctionCallNode::FunctionCallNode(const std::string& name, size_t position,
                                    std::vector<std::unique_ptr<ASTNode>> args)
+    : name_(name), position_(position),
+      args_(std::make_move_iterator(args.begin()), std::make_move_iterator(args.end())) {}
+
+FunctionCallNode::FunctionCallNode(const std::string& name, size_t position, ASTNodeList args)
     : name_(name), position_(position), args_(std::move(args)) {}
 
+FunctionCallNode::~FunctionCallNode() {
+    destroySubtrees(*this);
+}
+
 ASTNode* FunctionCallNode::getArgument(size_t index) const {
     if (index >= args_.size()) {
         throw std::out_of_range("FunctionCallNode::getArgument: index out of range");
@@ -20,12 +29,7 @@ ASTNode* FunctionCallNode::getArgument(size_t index) const {
 }
 
 std::unique_ptr<ASTNode> FunctionCallNode::clone() const {
-    std::vector<std::unique_ptr<ASTNode>> clonedArgs;
-    clonedArgs.reserve(args_.size());
-    for (const auto& arg : args_) {
-        clonedArgs.push_back(arg->clone());
-    }
-    return std::make_unique<FunctionCallNode>(name_, position_, std::move(clonedArgs));
+    return cloneTree(*this);
 }
 
 void FunctionCallNode::accept(ASTVisitor& visitor) {
@@ -46,7 +50,18 @@ std::string FunctionCallNode::toString() const {
 }
 
 std::vector<std::unique_ptr<ASTNode>> FunctionCallNode::releaseArguments() {
-    return std::move(args_);
+    std::vector<std::unique_ptr<ASTNode>> released(std::make_move_iterator(args_.begin()),
+                                                   std::make_move_iterator(args_.end()));
+    args_.clear();
+    return released;
+}
+
+void FunctionCallNode::detachChildren(std::vector<std::unique_ptr<ASTNode>>& out) {
+    for (auto& arg : args_) {
+        if (arg && arg->getChildCount() > 0) {
+            out.push_back(std::move(arg));
+        }
+    }
 }
 
 } // namespace calc
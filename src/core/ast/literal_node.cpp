@@ -5,12 +5,51 @@
 
 #include "calc/core/ast.h"
 #include <sstream>
+#include <stdexcept>
 
 namespace calc {
 
-LiteralNode::LiteralNode(double value) : value_(value) {}
+LiteralNode::LiteralNode(double value) : value_(value), integer_(0), hasInteger_(false) {}
+
+LiteralNode::LiteralNode(double value, uint64_t integer)
+    : value_(value), integer_(integer), hasInteger_(true) {}
+
+LiteralNode::LiteralNode(double value, uint64_t integer, std::string digits, NumberBase base)
+    : value_(value)
+    , integer_(integer)
+    , hasInteger_(true)
+    , digits_(std::make_unique<const Digits>(Digits{std::move(digits), base})) {}
+
+LiteralNode::LiteralNode(double value, std::string digits)
+    : value_(value)
+    , integer_(0)
+    , hasInteger_(false)
+    , digits_(std::make_unique<const Digits>(Digits{std::move(digits), NumberBase::DECIMAL})) {}
+
+const std::string& LiteralNode::getDigits() const {
+    if (!digits_) {
+        throw std::logic_error("Literal has no digits");
+    }
+    return digits_->digits;
+}
+
+NumberBase LiteralNode::getBase() const {
+    if (!digits_) {
+        throw std::logic_error("Literal has no digits");
+    }
+    return digits_->base;
+}
 
 std::unique_ptr<ASTNode> LiteralNode::clone() const {
+    if (digits_) {
+        if (hasInteger_) {
+            return std::make_unique<LiteralNode>(value_, integer_, digits_->digits, digits_->base);
+        }
+        return std::make_unique<LiteralNode>(value_, digits_->digits);
+    }
+    if (hasInteger_) {
+        return std::make_unique<LiteralNode>(value_, integer_);
+    }
     return std::make_unique<LiteralNode>(value_);
 }
 
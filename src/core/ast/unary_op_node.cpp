@@ -7,11 +7,22 @@
 
 namespace calc {
 
-UnaryOpNode::UnaryOpNode(Token op, std::unique_ptr<ASTNode> operand)
-    : op_(op), operand_(std::move(operand)) {}
+UnaryOpNode::UnaryOpNode(const Token& op, std::unique_ptr<ASTNode> operand)
+    : operand_(std::move(operand)), position_(op.position), op_(toUnaryOpCode(op.opcode)) {}
+
+UnaryOpNode::UnaryOpNode(OpCode op, size_t position, std::unique_ptr<ASTNode> operand)
+    : operand_(std::move(operand)), position_(position), op_(toUnaryOpCode(op)) {}
+
+UnaryOpNode::~UnaryOpNode() {
+    destroySubtrees(*this);
+}
+
+Token UnaryOpNode::getOperator() const {
+    return Token(TokenType::OPERATOR, opCodeSymbol(op_), position_, op_);
+}
 
 std::unique_ptr<ASTNode> UnaryOpNode::clone() const {
-    return std::make_unique<UnaryOpNode>(op_, operand_->clone());
+    return cloneTree(*this);
 }
 
 void UnaryOpNode::accept(ASTVisitor& visitor) {
@@ -19,11 +30,17 @@ void UnaryOpNode::accept(ASTVisitor& visitor) {
 }
 
 std::string UnaryOpNode::toString() const {
-    return "(" + op_.value + operand_->toString() + ")";
+    return "(" + std::string(opCodeSymbol(op_)) + operand_->toString() + ")";
 }
 
 std::unique_ptr<ASTNode> UnaryOpNode::releaseOperand() {
     return std::move(operand_);
 }
 
+void UnaryOpNode::detachChildren(std::vector<std::unique_ptr<ASTNode>>& out) {
+    if (operand_ && operand_->getChildCount() > 0) {
+        out.push_back(std::move(operand_));
+    }
+}
+
 } // namespace calc
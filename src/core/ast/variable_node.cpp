@@ -0,0 +1,25 @@
+/**
+ * @file variable_node.cpp
+ * @brief VariableNode implementation
+ */
+
+#include "calc/core/ast.h"
+
+namespace calc {
+
+VariableNode::VariableNode(const std::string& name, size_t position)
+    : name_(name), position_(position) {}
+
+std::unique_ptr<ASTNode> VariableNode::clone() const {
+    return std::make_unique<VariableNode>(name_, position_);
+}
+
+void VariableNode::accept(ASTVisitor& visitor) {
+    visitor.visit(*this);
+}
+
+std::string VariableNode::toString() const {
+    return name_;
+}
+
+} // namespace calc
@@ -0,0 +1,308 @@
+/**
+ * @file batch_kernels.cpp
+ * @brief Block kernels compiled once per SIMD level, with run-time dispatch
+ */
+
+#include "batch_kernels.h"
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CALC_X86_KERNELS 1
+#define CALC_ALWAYS_INLINE inline __attribute__((always_inline))
+#define CALC_RESTRICT __restrict__
+#else
+#define CALC_ALWAYS_INLINE inline
+#define CALC_RESTRICT
+#endif
+
+namespace calc {
+
+namespace {
+
+//=============================================================================
+// Element operations
+//=============================================================================
+
+// Every operand outside (-2^63, 2^63) is flagged and re-run by the scalar
+// interpreter, so clamping it here only avoids an undefined conversion.
+constexpr double INTEGER_LIMIT = 9223372036854775808.0;
+
+CALC_ALWAYS_INLINE long long toInteger(double value) {
+    return std::fabs(value) < INTEGER_LIMIT ? static_cast<long long>(value) : 0;
+}
+
+CALC_ALWAYS_INLINE unsigned long long toShiftCount(double value) {
+    return value >= 0.0 && value < 64.0 ? static_cast<unsigned long long>(value) : 0;
+}
+
+struct AddOp { static double apply(double a, double b) { return a + b; } };
+struct SubOp { static double apply(double a, double b) { return a - b; } };
+struct MulOp { static double apply(double a, double b) { return a * b; } };
+struct DivOp { static double apply(double a, double b) { return a / b; } };
+struct ModOp { static double apply(double a, double b) { return std::fmod(a, b); } };
+struct PowOp { static double apply(double a, double b) { return std::pow(a, b); } };
+
+struct BitAndOp {
+    static double apply(double a, double b) {
+        return static_cast<double>(toInteger(a) & toInteger(b));
+    }
+};
+
+struct BitOrOp {
+    static double apply(double a, double b) {
+        return static_cast<double>(toInteger(a) | toInteger(b));
+    }
+};
+
+struct BitXorOp {
+    static double apply(double a, double b) {
+        return static_cast<double>(toInteger(a) ^ toInteger(b));
+    }
+};
+
+// Shift in unsigned arithmetic to get the two's complement result the
+// scalar interpreter produces without shifting a negative value
+struct ShlOp {
+    static double apply(double a, double b) {
+        return static_cast<double>(static_cast<long long>(
+            static_cast<unsigned long long>(toInteger(a)) << toShiftCount(b)));
+    }
+};
+
+struct ShrOp {
+    static double apply(double a, double b) {
+        return static_cast<double>(toInteger(a) >> toShiftCount(b));
+    }
+};
+
+struct NegOp { static double apply(double a) { return -a; } };
+struct BitNotOp { static double apply(double a) { return static_cast<double>(~toInteger(a)); } };
+
+// abs, sqrt and the rounding functions become vector instructions (the
+// rounding ones from AVX2 up, which has vroundpd). The transcendental
+// functions, like pow and fmod above, remain one libm call per element in
+// every set: vector variants would need -ffast-math and libmvec and would
+// not round like the scalar path.
+template <BuiltinFunction F>
+struct MathOp {
+    static double apply(double x) {
+        switch (F) {
+            case BuiltinFunction::SIN:   return std::sin(x);
+            case BuiltinFunction::COS:   return std::cos(x);
+            case BuiltinFunction::TAN:   return std::tan(x);
+            case BuiltinFunction::ASIN:  return std::asin(x);
+            case BuiltinFunction::ACOS:  return std::acos(x);
+            case BuiltinFunction::ATAN:  return std::atan(x);
+            case BuiltinFunction::SINH:  return std::sinh(x);
+            case BuiltinFunction::COSH:  return std::cosh(x);
+            case BuiltinFunction::TANH:  return std::tanh(x);
+            case BuiltinFunction::LOG:   return std::log(x);
+            case BuiltinFunction::LOG10: return std::log10(x);
+            case BuiltinFunction::EXP:   return std::exp(x);
+            case BuiltinFunction::SQRT:  return std::sqrt(x);
+            case BuiltinFunction::CBRT:  return std::cbrt(x);
+            case BuiltinFunction::ABS:   return std::fabs(x);
+            case BuiltinFunction::FLOOR: return std::floor(x);
+            case BuiltinFunction::CEIL:  return std::ceil(x);
+            case BuiltinFunction::ROUND: return std::round(x);
+            case BuiltinFunction::TRUNC: return std::trunc(x);
+            default:                     return x;
+        }
+    }
+};
+
+// Checks return 1 for rows the scalar interpreter must decide
+struct NonFiniteCheck {
+    static uint8_t test(double v) { return static_cast<uint8_t>(!(std::fabs(v) <= 1.7976931348623157e308)); }
+};
+
+struct ZeroDivisorCheck {
+    // Same threshold as EvaluatorVisitor::approxEqual(right, 0.0)
+    static uint8_t test(double v) { return static_cast<uint8_t>(std::fabs(v) < 1e-10); }
+};
+
+struct IntegerRangeCheck {
+    static uint8_t test(double v) { return static_cast<uint8_t>(!(std::fabs(v) < INTEGER_LIMIT)); }
+};
+
+struct ShiftRangeCheck {
+    static uint8_t test(double v) { return static_cast<uint8_t>(!(v >= 0.0 && v < 64.0)); }
+};
+
+//=============================================================================
+// Loops
+//=============================================================================
+
+template <typename Op>
+CALC_ALWAYS_INLINE void binaryLoop(double* CALC_RESTRICT a, const double* CALC_RESTRICT b, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = Op::apply(a[i], b[i]);
+    }
+}
+
+template <typename Op>
+CALC_ALWAYS_INLINE void unaryLoop(double* CALC_RESTRICT a, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = Op::apply(a[i]);
+    }
+}
+
+template <typename Check>
+CALC_ALWAYS_INLINE void checkLoop(const double* CALC_RESTRICT values, size_t n,
+                                  uint8_t* CALC_RESTRICT flags) {
+    for (size_t i = 0; i < n; ++i) {
+        flags[i] = static_cast<uint8_t>(flags[i] | Check::test(values[i]));
+    }
+}
+
+/**
+ * @brief Build the kernel table from a set of target-specific entry points
+ *
+ * @p Set provides static member templates binary<Op>, unary<Op> and
+ * check<Check>, each compiled for one instruction set.
+ */
+template <typename Set>
+BatchKernels makeKernels() {
+    BatchKernels k{};
+    k.add = &Set::template binary<AddOp>;
+    k.sub = &Set::template binary<SubOp>;
+    k.mul = &Set::template binary<MulOp>;
+    k.div = &Set::template binary<DivOp>;
+    k.mod = &Set::template binary<ModOp>;
+    k.pow = &Set::template binary<PowOp>;
+    k.bitAnd = &Set::template binary<BitAndOp>;
+    k.bitOr = &Set::template binary<BitOrOp>;
+    k.bitXor = &Set::template binary<BitXorOp>;
+    k.shl = &Set::template binary<ShlOp>;
+    k.shr = &Set::template binary<ShrOp>;
+    k.neg = &Set::template unary<NegOp>;
+    k.bitNot = &Set::template unary<BitNotOp>;
+
+    using F = BuiltinFunction;
+    k.math[static_cast<size_t>(F::SIN)] = &Set::template unary<MathOp<F::SIN>>;
+    k.math[static_cast<size_t>(F::COS)] = &Set::template unary<MathOp<F::COS>>;
+    k.math[static_cast<size_t>(F::TAN)] = &Set::template unary<MathOp<F::TAN>>;
+    k.math[static_cast<size_t>(F::ASIN)] = &Set::template unary<MathOp<F::ASIN>>;
+    k.math[static_cast<size_t>(F::ACOS)] = &Set::template unary<MathOp<F::ACOS>>;
+    k.math[static_cast<size_t>(F::ATAN)] = &Set::template unary<MathOp<F::ATAN>>;
+    k.math[static_cast<size_t>(F::SINH)] = &Set::template unary<MathOp<F::SINH>>;
+    k.math[static_cast<size_t>(F::COSH)] = &Set::template unary<MathOp<F::COSH>>;
+    k.math[static_cast<size_t>(F::TANH)] = &Set::template unary<MathOp<F::TANH>>;
+    k.math[static_cast<size_t>(F::LOG)] = &Set::template unary<MathOp<F::LOG>>;
+    k.math[static_cast<size_t>(F::LOG10)] = &Set::template unary<MathOp<F::LOG10>>;
+    k.math[static_cast<size_t>(F::EXP)] = &Set::template unary<MathOp<F::EXP>>;
+    k.math[static_cast<size_t>(F::SQRT)] = &Set::template unary<MathOp<F::SQRT>>;
+    k.math[static_cast<size_t>(F::CBRT)] = &Set::template unary<MathOp<F::CBRT>>;
+    k.math[static_cast<size_t>(F::ABS)] = &Set::template unary<MathOp<F::ABS>>;
+    k.math[static_cast<size_t>(F::FLOOR)] = &Set::template unary<MathOp<F::FLOOR>>;
+    k.math[static_cast<size_t>(F::CEIL)] = &Set::template unary<MathOp<F::CEIL>>;
+    k.math[static_cast<size_t>(F::ROUND)] = &Set::template unary<MathOp<F::ROUND>>;
+    k.math[static_cast<size_t>(F::TRUNC)] = &Set::template unary<MathOp<F::TRUNC>>;
+
+    k.markNonFinite = &Set::template check<NonFiniteCheck>;
+    k.markZeroDivisor = &Set::template check<ZeroDivisorCheck>;
+    k.markIntegerRange = &Set::template check<IntegerRangeCheck>;
+    k.markShiftRange = &Set::template check<ShiftRangeCheck>;
+    return k;
+}
+
+#ifdef CALC_X86_KERNELS
+
+// The loops are inlined into these entry points and vectorized for the
+// entry point's target, so each set uses its own vector width. That relies
+// on the per-file options in src/CMakeLists.txt: with GCC's default -O2 cost
+// model none of these loops is vectorized.
+#define CALC_KERNEL_SET(NAME, TARGET)                                                         \
+    struct NAME {                                                                             \
+        template <typename Op>                                                                \
+        __attribute__((target(TARGET))) static void binary(double* a, const double* b,        \
+                                                           size_t n) {                        \
+            binaryLoop<Op>(a, b, n);                                                          \
+        }                                                                                     \
+        template <typename Op>                                                                \
+        __attribute__((target(TARGET))) static void unary(double* a, size_t n) {              \
+            unaryLoop<Op>(a, n);                                                              \
+        }                                                                                     \
+        template <typename Check>                                                             \
+        __attribute__((target(TARGET))) static void check(const double* values, size_t n,     \
+                                                          uint8_t* flags) {                   \
+            checkLoop<Check>(values, n, flags);                                               \
+        }                                                                                     \
+    }
+
+CALC_KERNEL_SET(Sse2Kernels, "sse2");
+CALC_KERNEL_SET(Avx2Kernels, "avx2");
+CALC_KERNEL_SET(Avx512Kernels, "avx512f,avx512dq");
+
+#undef CALC_KERNEL_SET
+
+#endif // CALC_X86_KERNELS
+
+} // anonymous namespace
+
+//=============================================================================
+// Dispatch
+//=============================================================================
+
+std::string simdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return "scalar";
+        case SimdLevel::SSE2:   return "sse2";
+        case SimdLevel::AVX2:   return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default:                return "unknown";
+    }
+}
+
+bool isSimdLevelSupported(SimdLevel level) noexcept {
+#ifdef CALC_X86_KERNELS
+    __builtin_cpu_init();
+    switch (level) {
+        case SimdLevel::SCALAR: return true;
+        case SimdLevel::SSE2:   return __builtin_cpu_supports("sse2");
+        case SimdLevel::AVX2:   return __builtin_cpu_supports("avx2");
+        case SimdLevel::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq");
+        default:                return false;
+    }
+#else
+    return level == SimdLevel::SCALAR;
+#endif
+}
+
+SimdLevel detectSimdLevel() noexcept {
+    for (SimdLevel level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE2}) {
+        if (isSimdLevelSupported(level)) {
+            return level;
+        }
+    }
+    return SimdLevel::SCALAR;
+}
+
+const BatchKernels* getBatchKernels(SimdLevel level) noexcept {
+    if (!isSimdLevelSupported(level)) {
+        return nullptr;
+    }
+#ifdef CALC_X86_KERNELS
+    // Function-local tables, so a VM used during static initialization still sees them
+    switch (level) {
+        case SimdLevel::SSE2: {
+            static const BatchKernels kernels = makeKernels<Sse2Kernels>();
+            return &kernels;
+        }
+        case SimdLevel::AVX2: {
+            static const BatchKernels kernels = makeKernels<Avx2Kernels>();
+            return &kernels;
+        }
+        case SimdLevel::AVX512: {
+            static const BatchKernels kernels = makeKernels<Avx512Kernels>();
+            return &kernels;
+        }
+        default:
+            break;
+    }
+#endif
+    return nullptr;
+}
+
+} // namespace calc
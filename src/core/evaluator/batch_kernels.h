@@ -0,0 +1,66 @@
+/**
+ * @file batch_kernels.h
+ * @brief Per-instruction block kernels used by VirtualMachine batch evaluation
+ *
+ * Internal header: each kernel applies one operation to a block of rows
+ * held in contiguous registers. One kernel set is compiled per SIMD level
+ * and selected at run time.
+ */
+
+#ifndef CALC_CORE_BATCH_KERNELS_H
+#define CALC_CORE_BATCH_KERNELS_H
+
+#include "calc/core/compiled_expression.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace calc {
+
+/// a[i] = a[i] op b[i]
+using BinaryKernel = void (*)(double* a, const double* b, size_t n);
+
+/// a[i] = op(a[i])
+using UnaryKernel = void (*)(double* a, size_t n);
+
+/// flags[i] |= 1 for every row the scalar interpreter must re-run
+using CheckKernel = void (*)(const double* values, size_t n, uint8_t* flags);
+
+/**
+ * @brief Kernels for one SIMD level
+ *
+ * Kernels never fail. Rows on which the scalar interpreter could report
+ * an error, or whose integer conversion would be undefined, are flagged
+ * by the check kernels instead and re-evaluated row by row.
+ */
+struct BatchKernels {
+    BinaryKernel add;
+    BinaryKernel sub;
+    BinaryKernel mul;
+    BinaryKernel div;
+    BinaryKernel mod;
+    BinaryKernel pow;
+    BinaryKernel bitAnd;
+    BinaryKernel bitOr;
+    BinaryKernel bitXor;
+    BinaryKernel shl;
+    BinaryKernel shr;
+    UnaryKernel neg;
+    UnaryKernel bitNot;
+    UnaryKernel math[static_cast<size_t>(BuiltinFunction::COUNT_)];  ///< Indexed by BuiltinFunction
+
+    CheckKernel markNonFinite;        ///< Result is NaN or infinite
+    CheckKernel markZeroDivisor;      ///< Divisor the scalar path rejects
+    CheckKernel markIntegerRange;     ///< Operand does not fit a long long
+    CheckKernel markShiftRange;       ///< Shift count outside [0, 63]
+};
+
+/**
+ * @brief Get the kernel set for a SIMD level
+ * @return The kernels, or nullptr for SimdLevel::SCALAR and for levels
+ *         this build or CPU cannot run
+ */
+const BatchKernels* getBatchKernels(SimdLevel level) noexcept;
+
+} // namespace calc
+
+#endif // CALC_CORE_BATCH_KERNELS_H
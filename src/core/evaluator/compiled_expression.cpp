@@ -0,0 +1,741 @@
+/**
+ * @file compiled_expression.cpp
+ * @brief Bytecode compiler and register VM implementation
+ */
+
+#include "calc/core/compiled_expression.h"
+#include "batch_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace calc {
+
+//=============================================================================
+// ExpressionCompiler
+//=============================================================================
+
+/**
+ * @brief Lowers an AST or an ExpressionDag into a CompiledExpression
+ *
+ * Nodes are compiled in post-order, which is the order their instructions
+ * run in. Each node writes its value into the register numbered by the
+ * height of the operand stack below it, so a binary node finds its left
+ * operand in r[h] and its right operand in r[h + 1] and combines them
+ * into r[h]; depth_ tracks that height as the walk goes.
+ *
+ * A DAG is compiled as the tree it stands for, except that a node with
+ * several parents copies its value into a register of its own above the
+ * operand stack the first time it is computed; later occurrences copy
+ * that value back instead of recomputing it.
+ */
+class ExpressionCompiler : public ASTVisitor {
+public:
+    ExpressionCompiler(const EvaluationContext& context, const std::vector<std::string>& columns)
+        : context_(context), columns_(columns), depth_(0) {}
+
+    CompiledExpression compile(const ASTNode& root) {
+        program_.context_ = &context_;
+        program_.columnCount_ = columns_.size();
+        PostOrderWalker walker;
+        walker.walk(const_cast<ASTNode&>(root), *this);
+        return std::move(program_);
+    }
+
+    CompiledExpression compile(const ExpressionDag& dag) {
+        program_.context_ = &context_;
+        program_.columnCount_ = columns_.size();
+
+        constexpr uint32_t NOT_SAVED = UINT32_MAX;
+        const std::vector<ExpressionDag::Node>& nodes = dag.getNodes();
+        std::vector<uint32_t> saved(nodes.size(), NOT_SAVED);  // Shared register of each node
+        uint32_t sharedCount = 0;
+
+        struct Frame {
+            uint32_t id;
+            uint32_t nextOperand;
+        };
+        std::vector<Frame> stack;
+
+        // Shared registers are numbered from 0 here and moved above the
+        // operand stack once its height is known
+        auto enter = [&](uint32_t id) {
+            if (saved[id] == NOT_SAVED) {
+                stack.push_back({id, 0});
+                return;
+            }
+            emitLoadShared(saved[id], nodes[id].position);
+            ++depth_;
+        };
+
+        enter(dag.getRoot());
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            const ExpressionDag::Node& node = nodes[top.id];
+            if (top.nextOperand < node.operandCount) {
+                enter(dag.getOperand(node, top.nextOperand++));
+                continue;
+            }
+
+            const uint32_t id = top.id;
+            stack.pop_back();
+            switch (node.kind) {
+                case ExpressionDag::Kind::LITERAL:  compileLiteral(node.value); break;
+                case ExpressionDag::Kind::VARIABLE: compileVariable(node.name, node.position); break;
+                case ExpressionDag::Kind::BINARY:   compileBinary(node.op, node.position); break;
+                case ExpressionDag::Kind::UNARY:    compileUnary(node.op, node.position); break;
+                case ExpressionDag::Kind::CALL:
+                    compileCall(node.name, node.operandCount, node.position);
+                    break;
+            }
+
+            if (node.parents > 1) {
+                saved[id] = sharedCount++;
+                emitSaveShared(saved[id], node.position);
+            }
+        }
+
+        // The operand stack is complete: place the shared registers above it
+        const auto base = static_cast<uint32_t>(program_.registerCount_);
+        for (size_t index : sharedCopies_) {
+            Instruction& ins = program_.instructions_[index];
+            if (ins.imm.index == COPY_TO_SHARED) {
+                ins.a += base;
+            } else {
+                ins.b += base;
+            }
+        }
+        program_.registerCount_ += sharedCount;
+        return std::move(program_);
+    }
+
+    void visit(LiteralNode& node) override {
+        compileLiteral(node.getValue());
+    }
+
+    void visit(VariableNode& node) override {
+        compileVariable(node.getName(), node.getPosition());
+    }
+
+    void visit(BinaryOpNode& node) override {
+        compileBinary(node.getOpCode(), node.getPosition());
+    }
+
+    void visit(UnaryOpNode& node) override {
+        compileUnary(node.getOpCode(), node.getPosition());
+    }
+
+    void visit(FunctionCallNode& node) override {
+        compileCall(node.getName(), node.getArgumentCount(), node.getPosition());
+    }
+
+private:
+    const EvaluationContext& context_;
+    const std::vector<std::string>& columns_;
+    CompiledExpression program_;
+    size_t depth_;  ///< Values on the operand stack before the node being compiled
+    std::vector<size_t> sharedCopies_;  ///< COPY instructions naming a shared register
+
+    /// COPY immediate marking a copy into a shared register rather than out of one
+    static constexpr uint32_t COPY_TO_SHARED = 1;
+
+    void compileLiteral(double value) {
+        Instruction ins = makeInstruction(BytecodeOp::LOAD_CONST, 0);
+        ins.imm.value = value;
+        emit(ins, 0);
+        ++depth_;
+    }
+
+    void compileVariable(const std::string& name, size_t position) {
+        emitVariable(name, position);
+        ++depth_;
+    }
+
+    void compileBinary(OpCode op, size_t position) {
+        depth_ -= 2;
+
+        BytecodeOp code;
+        if (resolveBinary(op, code)) {
+            Instruction ins = makeInstruction(code, 0);
+            ins.b = static_cast<uint32_t>(depth_ + 1);
+            emit(ins, position);
+        } else {
+            emitFail(ErrorCode::EVALUATION_ERROR,
+                     std::string("Unknown binary operator: ") + opCodeSymbol(op), position);
+        }
+        ++depth_;
+    }
+
+    void compileUnary(OpCode op, size_t position) {
+        depth_ -= 1;
+
+        switch (op) {
+            case OpCode::PLUS:
+                break;  // Identity: the operand already sits in the result register
+            case OpCode::NEG:
+                emit(makeInstruction(BytecodeOp::NEG, 0), position);
+                break;
+            case OpCode::BIT_NOT:
+                emit(makeInstruction(BytecodeOp::BIT_NOT, 0), position);
+                break;
+            default:
+                emitFail(ErrorCode::EVALUATION_ERROR,
+                         std::string("Unknown unary operator: ") + opCodeSymbol(op), position);
+                break;
+        }
+        ++depth_;
+    }
+
+    void compileCall(const std::string& name, size_t argCount, size_t position) {
+        depth_ -= argCount;
+        reserveRegister(0);
+
+        const FunctionEntry* entry = context_.findFunction(name);
+        if (entry == nullptr) {
+            emitFail(ErrorCode::INVALID_FUNCTION, "Unknown function: " + name, position);
+        } else {
+            emitCall(entry, name, argCount, position);
+        }
+        ++depth_;
+    }
+
+    void emitVariable(const std::string& name, size_t position) {
+        // Batch columns shadow context variables of the same name
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            if (columns_[i] == name) {
+                Instruction ins = makeInstruction(BytecodeOp::LOAD_COLUMN, 0);
+                ins.imm.index = static_cast<uint32_t>(i);
+                emit(ins, position);
+                return;
+            }
+        }
+
+        size_t slot = context_.findVariableSlot(name);
+        if (slot != EvaluationContext::NO_SLOT) {
+            Instruction ins = makeInstruction(BytecodeOp::LOAD_VAR, 0);
+            ins.imm.index = static_cast<uint32_t>(slot);
+            emit(ins, position);
+            return;
+        }
+
+        // Constants such as PI and E are zero-argument functions
+        const FunctionEntry* entry = context_.findFunction(name);
+        if (entry != nullptr) {
+            emitCall(entry, name, 0, position);
+            return;
+        }
+
+        emitFail(ErrorCode::UNDEFINED_VARIABLE, "Undefined variable: " + name, position);
+    }
+
+    // Shared registers are numbered from 0 until compile() renumbers them;
+    // the immediate of a COPY tells which of its operands to renumber
+
+    void emitSaveShared(uint32_t shared, size_t position) {
+        Instruction ins{};
+        ins.op = BytecodeOp::COPY;
+        ins.a = shared;
+        ins.b = static_cast<uint32_t>(depth_ - 1);
+        ins.imm.index = COPY_TO_SHARED;
+        sharedCopies_.push_back(program_.instructions_.size());
+        emit(ins, position);
+    }
+
+    void emitLoadShared(uint32_t shared, size_t position) {
+        Instruction ins = makeInstruction(BytecodeOp::COPY, 0);
+        ins.b = shared;
+        ins.imm.index = 0;
+        sharedCopies_.push_back(program_.instructions_.size());
+        emit(ins, position);
+    }
+
+    void reserveRegister(size_t offset) {
+        if (depth_ + offset + 1 > program_.registerCount_) {
+            program_.registerCount_ = depth_ + offset + 1;
+        }
+    }
+
+    Instruction makeInstruction(BytecodeOp op, size_t offset) {
+        reserveRegister(offset);
+        Instruction ins{};
+        ins.op = op;
+        ins.a = static_cast<uint32_t>(depth_ + offset);
+        return ins;
+    }
+
+    void emit(const Instruction& ins, size_t position) {
+        program_.instructions_.push_back(ins);
+        program_.positions_.push_back(position);
+    }
+
+    void emitCall(const FunctionEntry* entry, const std::string& name,
+                  size_t argCount, size_t position) {
+        // The argument count is checked once here rather than on every call
+        if (!entry->acceptsArgumentCount(argCount)) {
+            emitFail(ErrorCode::EVALUATION_ERROR, entry->arityMessage(name), position);
+            return;
+        }
+
+        Instruction ins = makeInstruction(BytecodeOp::CALL, 0);
+        ins.b = static_cast<uint32_t>(argCount);
+        ins.imm.index = static_cast<uint32_t>(program_.functions_.size());
+        program_.functions_.push_back({entry, name});
+        emit(ins, position);
+    }
+
+    void emitFail(ErrorCode code, const std::string& message, size_t position) {
+        Instruction ins = makeInstruction(BytecodeOp::FAIL, 0);
+        ins.imm.index = static_cast<uint32_t>(program_.errors_.size());
+        program_.errors_.push_back({code, message});
+        emit(ins, position);
+    }
+
+    bool resolveBinary(OpCode op, BytecodeOp& code) const {
+        switch (op) {
+            case OpCode::ADD:     code = BytecodeOp::ADD; break;
+            case OpCode::SUB:     code = BytecodeOp::SUB; break;
+            case OpCode::MUL:     code = BytecodeOp::MUL; break;
+            case OpCode::DIV:     code = BytecodeOp::DIV; break;
+            case OpCode::MOD:     code = BytecodeOp::MOD; break;
+            case OpCode::BIT_AND: code = BytecodeOp::BIT_AND; break;
+            case OpCode::BIT_OR:  code = BytecodeOp::BIT_OR; break;
+            case OpCode::SHL:     code = BytecodeOp::SHL; break;
+            case OpCode::SHR:     code = BytecodeOp::SHR; break;
+            case OpCode::POW:
+                code = context_.getOperatorSemantics("^") == OperatorSemantics::BITWISE_XOR
+                    ? BytecodeOp::BIT_XOR
+                    : BytecodeOp::POW;
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+};
+
+CompiledExpression CompiledExpression::compile(const ASTNode& root, const EvaluationContext& context,
+                                               const std::vector<std::string>& columns) {
+    ExpressionCompiler compiler(context, columns);
+    return compiler.compile(root);
+}
+
+CompiledExpression CompiledExpression::compile(const ExpressionDag& dag, const EvaluationContext& context,
+                                               const std::vector<std::string>& columns) {
+    ExpressionCompiler compiler(context, columns);
+    return compiler.compile(dag);
+}
+
+//=============================================================================
+// VirtualMachine Implementation
+//=============================================================================
+
+namespace {
+
+// Same threshold as EvaluatorVisitor::approxEqual(right, 0.0)
+inline bool isZeroDivisor(double value) {
+    return std::abs(value) < 1e-10;
+}
+
+inline long long toInteger(double value) {
+    return static_cast<long long>(value);
+}
+
+inline const double* variablesOf(const CompiledExpression& program) {
+    const EvaluationContext* context = program.getContext();
+    return context != nullptr ? context->getVariables().data() : nullptr;
+}
+
+} // namespace
+
+VirtualMachine::VirtualMachine()
+    : simdLevel_(detectSimdLevel()) {
+}
+
+void VirtualMachine::setSimdLevel(SimdLevel level) {
+    if (!isSimdLevelSupported(level)) {
+        throw std::invalid_argument("SIMD level not supported: " + simdLevelToString(level));
+    }
+    simdLevel_ = level;
+}
+
+EvaluationResult VirtualMachine::execute(const CompiledExpression& program) {
+    if (program.getInstructions().empty()) {
+        return EvaluationResult(ErrorCode::EVALUATION_ERROR, "Cannot evaluate empty program");
+    }
+    if (program.getColumnCount() != 0) {
+        return EvaluationResult(ErrorCode::EVALUATION_ERROR,
+            "Expression was compiled for batch columns; use executeBatch");
+    }
+    if (registers_.size() < program.getRegisterCount()) {
+        registers_.resize(program.getRegisterCount());
+    }
+
+    std::optional<EvaluationResult> error = run(program, variablesOf(program), nullptr, 0);
+    if (error) {
+        return std::move(*error);
+    }
+    return EvaluationResult(registers_[0]);
+}
+
+BatchResult VirtualMachine::executeBatch(const CompiledExpression& program,
+                                         const std::vector<const double*>& columns,
+                                         size_t rows, double* out) {
+    BatchResult result;
+    result.rows = rows;
+    if (rows == 0) {
+        return result;
+    }
+
+    if (program.getInstructions().empty()) {
+        return VirtualMachine::failBatch(EvaluationResult(ErrorCode::EVALUATION_ERROR,
+            "Cannot evaluate empty program"), rows, out);
+    }
+    if (columns.size() != program.getColumnCount()) {
+        return VirtualMachine::failBatch(EvaluationResult(ErrorCode::EVALUATION_ERROR,
+            "Expected " + std::to_string(program.getColumnCount()) + " columns, got " +
+            std::to_string(columns.size())), rows, out);
+    }
+    if (registers_.size() < program.getRegisterCount()) {
+        registers_.resize(program.getRegisterCount());
+    }
+
+    const double* variables = variablesOf(program);
+    const double* const* columnData = columns.data();
+
+    // Programs with deferred errors fail on every row; leave them to the scalar path
+    const BatchKernels* kernels = program.getErrors().empty() ? getBatchKernels(simdLevel_) : nullptr;
+    if (kernels == nullptr) {
+        for (size_t row = 0; row < rows; ++row) {
+            finishRow(program, variables, columnData, row, out, result);
+        }
+        return result;
+    }
+
+    blockRegisters_.resize(program.getRegisterCount() * BLOCK_ROWS);
+    blockFlags_.resize(BLOCK_ROWS);
+
+    for (size_t start = 0; start < rows; start += BLOCK_ROWS) {
+        const size_t count = std::min(BLOCK_ROWS, rows - start);
+        runBlock(program, *kernels, variables, columnData, start, count);
+
+        const double* values = blockRegisters_.data();
+        for (size_t i = 0; i < count; ++i) {
+            if (blockFlags_[i] == 0) {
+                out[start + i] = values[i];
+            } else {
+                finishRow(program, variables, columnData, start + i, out, result);
+            }
+        }
+    }
+    return result;
+}
+
+BatchResult VirtualMachine::evaluateBatch(const ASTNode& root, const EvaluationContext& context,
+                                          const std::vector<BatchColumn>& columns,
+                                          size_t rows, double* out) {
+    std::vector<std::string> names;
+    std::vector<const double*> data;
+    names.reserve(columns.size());
+    data.reserve(columns.size());
+    for (const auto& column : columns) {
+        names.push_back(column.name);
+        data.push_back(column.data);
+    }
+
+    CompiledExpression program = CompiledExpression::compile(root, context, names);
+    return executeBatch(program, data, rows, out);
+}
+
+BatchResult VirtualMachine::failBatch(EvaluationResult error, size_t rows, double* out) {
+    std::fill(out, out + rows, std::numeric_limits<double>::quiet_NaN());
+    BatchResult result;
+    result.rows = rows;
+    result.failedRows = rows;
+    if (rows != 0) {
+        result.firstError = std::move(error);
+    }
+    return result;
+}
+
+void VirtualMachine::finishRow(const CompiledExpression& program, const double* variables,
+                               const double* const* columns, size_t row, double* out,
+                               BatchResult& result) {
+    std::optional<EvaluationResult> error = run(program, variables, columns, row);
+    if (!error) {
+        out[row] = registers_[0];
+        return;
+    }
+    out[row] = std::numeric_limits<double>::quiet_NaN();
+    if (result.failedRows++ == 0) {
+        result.firstFailedRow = row;
+        result.firstError = std::move(error);
+    }
+}
+
+void VirtualMachine::runBlock(const CompiledExpression& program, const BatchKernels& kernels,
+                              const double* variables, const double* const* columns,
+                              size_t start, size_t count) {
+    double* base = blockRegisters_.data();
+    uint8_t* flags = blockFlags_.data();
+    std::fill(flags, flags + count, uint8_t{0});
+
+    for (const Instruction& ins : program.getInstructions()) {
+        double* a = base + ins.a * BLOCK_ROWS;
+        const double* b = base + ins.b * BLOCK_ROWS;  // Only meaningful for binary operators
+
+        switch (ins.op) {
+            case BytecodeOp::LOAD_CONST:
+                std::fill(a, a + count, ins.imm.value);
+                break;
+            case BytecodeOp::LOAD_VAR:
+                std::fill(a, a + count, variables[ins.imm.index]);
+                break;
+            case BytecodeOp::LOAD_COLUMN:
+                std::copy(columns[ins.imm.index] + start, columns[ins.imm.index] + start + count, a);
+                break;
+            case BytecodeOp::COPY:
+                std::copy(b, b + count, a);
+                break;
+
+            // Arithmetic results are checked like EvaluatorVisitor::evaluateBinaryOp
+            case BytecodeOp::ADD:
+                kernels.add(a, b, count);
+                kernels.markNonFinite(a, count, flags);
+                break;
+            case BytecodeOp::SUB:
+                kernels.sub(a, b, count);
+                kernels.markNonFinite(a, count, flags);
+                break;
+            case BytecodeOp::MUL:
+                kernels.mul(a, b, count);
+                kernels.markNonFinite(a, count, flags);
+                break;
+            case BytecodeOp::DIV:
+                kernels.markZeroDivisor(b, count, flags);
+                kernels.div(a, b, count);
+                kernels.markNonFinite(a, count, flags);
+                break;
+            case BytecodeOp::MOD:
+                kernels.markZeroDivisor(b, count, flags);
+                kernels.mod(a, b, count);
+                kernels.markNonFinite(a, count, flags);
+                break;
+            case BytecodeOp::POW:
+                kernels.pow(a, b, count);
+                kernels.markNonFinite(a, count, flags);
+                break;
+
+            // Bitwise results are always finite; only the integer conversions are checked
+            case BytecodeOp::BIT_AND:
+                kernels.markIntegerRange(a, count, flags);
+                kernels.markIntegerRange(b, count, flags);
+                kernels.bitAnd(a, b, count);
+                break;
+            case BytecodeOp::BIT_OR:
+                kernels.markIntegerRange(a, count, flags);
+                kernels.markIntegerRange(b, count, flags);
+                kernels.bitOr(a, b, count);
+                break;
+            case BytecodeOp::BIT_XOR:
+                kernels.markIntegerRange(a, count, flags);
+                kernels.markIntegerRange(b, count, flags);
+                kernels.bitXor(a, b, count);
+                break;
+            case BytecodeOp::SHL:
+                kernels.markIntegerRange(a, count, flags);
+                kernels.markShiftRange(b, count, flags);
+                kernels.shl(a, b, count);
+                break;
+            case BytecodeOp::SHR:
+                kernels.markIntegerRange(a, count, flags);
+                kernels.markShiftRange(b, count, flags);
+                kernels.shr(a, b, count);
+                break;
+
+            case BytecodeOp::NEG:
+                kernels.neg(a, count);
+                break;
+            case BytecodeOp::BIT_NOT:
+                kernels.markIntegerRange(a, count, flags);
+                kernels.bitNot(a, count);
+                break;
+
+            case BytecodeOp::CALL: {
+                // Entries are replaced in place, so a function replaced since
+                // compile() is seen here with its current tag and arity
+                const FunctionEntry& entry = *program.getFunctions()[ins.imm.index].entry;
+                if (!entry.acceptsArgumentCount(ins.b)) {
+                    std::fill(flags, flags + count, uint8_t{1});
+                    return;
+                }
+                if (entry.builtin != BuiltinFunction::NONE && ins.b == 1) {
+                    // Built-in functions fail only where the result is NaN or infinite
+                    kernels.math[static_cast<size_t>(entry.builtin)](a, count);
+                    kernels.markNonFinite(a, count, flags);
+                    break;
+                }
+
+                callArgs_.resize(ins.b);
+                for (size_t i = 0; i < count; ++i) {
+                    if (flags[i] != 0) {
+                        continue;
+                    }
+                    for (size_t arg = 0; arg < ins.b; ++arg) {
+                        callArgs_[arg] = a[arg * BLOCK_ROWS + i];
+                    }
+                    try {
+                        a[i] = entry.arity == FunctionArity::CALLBACK
+                            ? entry.callback(callArgs_)
+                            : entry.invoke(callArgs_.data(), ins.b);
+                    } catch (const std::exception&) {
+                        flags[i] = 1;  // The scalar re-run reports the error
+                    }
+                }
+                break;
+            }
+
+            default:
+                // FAIL is left to the scalar path by executeBatch()
+                std::fill(flags, flags + count, uint8_t{1});
+                return;
+        }
+    }
+}
+
+std::optional<EvaluationResult> VirtualMachine::run(const CompiledExpression& program,
+                                                    const double* variables,
+                                                    const double* const* columns, size_t row) {
+    double* r = registers_.data();
+
+    const std::vector<Instruction>& code = program.getInstructions();
+    const size_t count = code.size();
+
+    for (size_t pc = 0; pc < count; ++pc) {
+        const Instruction& ins = code[pc];
+        const double left = r[ins.a];
+        double result;
+
+        switch (ins.op) {
+            case BytecodeOp::LOAD_CONST:
+                r[ins.a] = ins.imm.value;
+                continue;
+
+            case BytecodeOp::LOAD_VAR:
+                r[ins.a] = variables[ins.imm.index];
+                continue;
+
+            case BytecodeOp::LOAD_COLUMN:
+                r[ins.a] = columns[ins.imm.index][row];
+                continue;
+
+            case BytecodeOp::COPY:
+                r[ins.a] = r[ins.b];
+                continue;
+
+            case BytecodeOp::NEG:
+                r[ins.a] = -left;
+                continue;
+
+            case BytecodeOp::BIT_NOT:
+                r[ins.a] = static_cast<double>(~toInteger(left));
+                continue;
+
+            case BytecodeOp::ADD:
+                result = left + r[ins.b];
+                break;
+            case BytecodeOp::SUB:
+                result = left - r[ins.b];
+                break;
+            case BytecodeOp::MUL:
+                result = left * r[ins.b];
+                break;
+            case BytecodeOp::DIV:
+                if (isZeroDivisor(r[ins.b])) {
+                    return EvaluationResult(ErrorCode::DIVISION_BY_ZERO, "Division by zero",
+                                            program.getPosition(pc));
+                }
+                result = left / r[ins.b];
+                break;
+            case BytecodeOp::MOD:
+                if (isZeroDivisor(r[ins.b])) {
+                    return EvaluationResult(ErrorCode::DIVISION_BY_ZERO, "Division by zero",
+                                            program.getPosition(pc));
+                }
+                result = std::fmod(left, r[ins.b]);
+                break;
+            case BytecodeOp::POW:
+                result = std::pow(left, r[ins.b]);
+                break;
+            case BytecodeOp::BIT_AND:
+                result = static_cast<double>(toInteger(left) & toInteger(r[ins.b]));
+                break;
+            case BytecodeOp::BIT_OR:
+                result = static_cast<double>(toInteger(left) | toInteger(r[ins.b]));
+                break;
+            case BytecodeOp::BIT_XOR:
+                result = static_cast<double>(toInteger(left) ^ toInteger(r[ins.b]));
+                break;
+            case BytecodeOp::SHL:
+                result = static_cast<double>(toInteger(left) << toInteger(r[ins.b]));
+                break;
+            case BytecodeOp::SHR:
+                result = static_cast<double>(toInteger(left) >> toInteger(r[ins.b]));
+                break;
+
+            case BytecodeOp::CALL: {
+                const CompiledExpression::FunctionRef& fn = program.getFunctions()[ins.imm.index];
+                const FunctionEntry& entry = *fn.entry;
+                if (!entry.acceptsArgumentCount(ins.b)) {
+                    // Replaced since compile() with a function of another arity
+                    return EvaluationResult(ErrorCode::EVALUATION_ERROR,
+                        entry.arityMessage(fn.name), program.getPosition(pc));
+                }
+                try {
+                    if (entry.arity == FunctionArity::CALLBACK) {
+                        callArgs_.assign(r + ins.a, r + ins.a + ins.b);
+                        r[ins.a] = entry.callback(callArgs_);
+                    } else {
+                        // Arguments are read in place from consecutive registers
+                        r[ins.a] = entry.invoke(r + ins.a, ins.b);
+                    }
+                } catch (const CalculatorException& e) {
+                    size_t position = e.getPosition() != 0 ? e.getPosition() : program.getPosition(pc);
+                    return EvaluationResult(e.getErrorCode(), e.what(), position);
+                } catch (const std::exception& e) {
+                    return EvaluationResult(ErrorCode::EVALUATION_ERROR,
+                        "Error calling function '" + fn.name + "': " + e.what(),
+                        program.getPosition(pc));
+                }
+                continue;
+            }
+
+            case BytecodeOp::FAIL: {
+                const CompiledExpression::DeferredError& err = program.getErrors()[ins.imm.index];
+                return EvaluationResult(err.code, err.message, program.getPosition(pc));
+            }
+
+            default:
+                return EvaluationResult(ErrorCode::EVALUATION_ERROR,
+                    "Invalid instruction", program.getPosition(pc));
+        }
+
+        // Binary arithmetic result checks, mirroring EvaluatorVisitor::evaluateBinaryOp
+        if (!std::isfinite(result)) {
+            const double right = r[ins.b];
+            if (std::isinf(result) && !std::isinf(left) && !std::isinf(right)) {
+                return EvaluationResult(ErrorCode::NUMERIC_OVERFLOW, "Numeric overflow",
+                                        program.getPosition(pc));
+            }
+            if (std::isnan(result)) {
+                return EvaluationResult(ErrorCode::DOMAIN_ERROR,
+                    "Result is NaN (Not a Number) - possible domain error", program.getPosition(pc));
+            }
+        }
+        r[ins.a] = result;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace calc
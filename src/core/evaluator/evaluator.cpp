@@ -5,8 +5,9 @@
 
 #include "calc/core/evaluator.h"
 #include "calc/utils/error.h"
+#include <algorithm>
+#include <charconv>
 #include <cmath>
-#include <sstream>
 
 namespace calc {
 
@@ -60,24 +61,53 @@ size_t EvaluationResult::getErrorPosition() const {
 
 std::string EvaluationResult::toString() const {
     if (isSuccess()) {
-        std::ostringstream oss;
-        oss << std::get<Success>(data_).value;
-        return oss.str();
+        // Six significant digits, as operator<< writes a double by default
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), std::get<Success>(data_).value,
+                                    std::chars_format::general, 6);
+        return std::string(buffer, result.ptr);
     } else {
         const auto& err = std::get<Error>(data_);
-        std::ostringstream oss;
-        oss << "[" << errorCodeToString(err.code) << "] " << err.message;
+        std::string text = "[" + errorCodeToString(err.code) + "] " + err.message;
         if (err.position > 0) {
-            oss << " (position " << err.position << ")";
+            text += " (position " + std::to_string(err.position) + ")";
         }
-        return oss.str();
+        return text;
     }
 }
 
+//=============================================================================
+// FunctionEntry Implementation
+//=============================================================================
+
+std::string FunctionEntry::arityMessage(const std::string& name) const {
+    size_t expected = 0;
+    const char* quantifier = "exactly ";
+    switch (arity) {
+        case FunctionArity::NULLARY:  expected = 0; break;
+        case FunctionArity::UNARY:    expected = 1; break;
+        case FunctionArity::BINARY:   expected = 2; break;
+        case FunctionArity::VARIADIC: expected = minArgs; quantifier = "at least "; break;
+        default:
+            return name + " does not accept these arguments";
+    }
+    return name + " requires " + quantifier + std::to_string(expected) +
+           (expected == 1 ? " argument" : " arguments");
+}
+
 //=============================================================================
 // EvaluationContext Implementation
 //=============================================================================
 
+namespace {
+
+constexpr size_t NO_BUILTIN = static_cast<size_t>(-1);
+
+// Position of a built-in in the MathFunctions table, or NO_BUILTIN
+size_t findBuiltinIndex(std::string_view name) noexcept;
+
+} // anonymous namespace
+
 EvaluationContext::EvaluationContext(int precision)
     : precision_(precision), operatorSemantics_()
 {}
@@ -94,29 +124,134 @@ void EvaluationContext::setPrecision(int precision) {
 }
 
 bool EvaluationContext::hasFunction(const std::string& name) const {
-    return functions_.find(name) != functions_.end();
+    return findFunction(name) != nullptr;
+}
+
+void EvaluationContext::storeFunction(const std::string& name, FunctionEntry entry) {
+    ++bindingRevision_;
+    auto it = functions_.find(name);
+    if (it != functions_.end()) {
+        it->second = std::move(entry);
+        return;
+    }
+    if (!builtins_.empty()) {
+        size_t index = findBuiltinIndex(name);
+        if (index != NO_BUILTIN) {
+            builtins_[index] = std::move(entry);
+            return;
+        }
+    }
+    functions_.emplace(name, std::move(entry));
 }
 
 void EvaluationContext::addFunction(
     const std::string& name,
-    std::function<double(const std::vector<double>&)> callback)
+    FunctionCallback callback,
+    BuiltinFunction builtin,
+    bool pure)
 {
-    functions_[name] = std::move(callback);
+    FunctionEntry entry;
+    entry.callback = std::move(callback);
+    entry.builtin = builtin;
+    entry.pure = pure || builtin != BuiltinFunction::NONE;
+    storeFunction(name, std::move(entry));
+}
+
+void EvaluationContext::addFunction(const std::string& name, NullaryFunction function, bool pure) {
+    FunctionEntry entry;
+    entry.arity = FunctionArity::NULLARY;
+    entry.fn.nullary = function;
+    entry.pure = pure;
+    storeFunction(name, std::move(entry));
+}
+
+void EvaluationContext::addFunction(
+    const std::string& name,
+    UnaryFunction function,
+    BuiltinFunction builtin,
+    bool pure)
+{
+    FunctionEntry entry;
+    entry.arity = FunctionArity::UNARY;
+    entry.fn.unary = function;
+    entry.builtin = builtin;
+    entry.pure = pure || builtin != BuiltinFunction::NONE;
+    storeFunction(name, std::move(entry));
+}
+
+void EvaluationContext::addFunction(const std::string& name, BinaryFunction function, bool pure) {
+    FunctionEntry entry;
+    entry.arity = FunctionArity::BINARY;
+    entry.fn.binary = function;
+    entry.pure = pure;
+    storeFunction(name, std::move(entry));
+}
+
+void EvaluationContext::addVariadicFunction(
+    const std::string& name,
+    VariadicFunction function,
+    size_t minArgs,
+    bool pure)
+{
+    FunctionEntry entry;
+    entry.arity = FunctionArity::VARIADIC;
+    entry.fn.variadic = function;
+    entry.minArgs = minArgs;
+    entry.pure = pure;
+    storeFunction(name, std::move(entry));
+}
+
+bool EvaluationContext::isPureFunction(const std::string& name) const {
+    const FunctionEntry* entry = findFunction(name);
+    return entry != nullptr && entry->pure;
+}
+
+BuiltinFunction EvaluationContext::findBuiltin(const std::string& name) const {
+    const FunctionEntry* entry = findFunction(name);
+    return entry != nullptr ? entry->builtin : BuiltinFunction::NONE;
+}
+
+const FunctionEntry* EvaluationContext::findFunction(const std::string& name) const {
+    // Names added before the built-ins were registered stay in functions_
+    if (!functions_.empty()) {
+        auto it = functions_.find(name);
+        if (it != functions_.end()) {
+            return &it->second;
+        }
+    }
+    if (!builtins_.empty()) {
+        size_t index = findBuiltinIndex(name);
+        if (index != NO_BUILTIN) {
+            return &builtins_[index];
+        }
+    }
+    return nullptr;
 }
 
 EvaluationResult EvaluationContext::callFunction(
     const std::string& name,
-    const std::vector<double>& args)
+    const std::vector<double>& args) const
 {
-    auto it = functions_.find(name);
-    if (it == functions_.end()) {
+    const FunctionEntry* entry = findFunction(name);
+    if (entry == nullptr) {
         return EvaluationResult(ErrorCode::INVALID_FUNCTION,
             "Unknown function: " + name);
     }
+    return callFunction(*entry, name, args.data(), args.size());
+}
+
+EvaluationResult EvaluationContext::callFunction(
+    const FunctionEntry& entry,
+    const std::string& name,
+    const double* args,
+    size_t count)
+{
+    if (!entry.acceptsArgumentCount(count)) {
+        return EvaluationResult(ErrorCode::EVALUATION_ERROR, entry.arityMessage(name));
+    }
 
     try {
-        double result = it->second(args);
-        return EvaluationResult(result);
+        return EvaluationResult(entry.invoke(args, count));
     } catch (const CalculatorException& e) {
         // Preserve the original error code from CalculatorException
         return EvaluationResult(e.getErrorCode(), e.what(), e.getPosition());
@@ -126,6 +261,32 @@ EvaluationResult EvaluationContext::callFunction(
     }
 }
 
+size_t EvaluationContext::setVariable(const std::string& name, double value) {
+    auto it = variableSlots_.find(name);
+    if (it != variableSlots_.end()) {
+        variables_[it->second] = value;
+        return it->second;
+    }
+
+    size_t slot = variables_.size();
+    variables_.push_back(value);
+    variableSlots_.emplace(name, slot);
+    ++bindingRevision_;
+    return slot;
+}
+
+bool EvaluationContext::hasVariable(const std::string& name) const {
+    return variableSlots_.find(name) != variableSlots_.end();
+}
+
+size_t EvaluationContext::findVariableSlot(const std::string& name) const {
+    auto it = variableSlots_.find(name);
+    if (it == variableSlots_.end()) {
+        return NO_SLOT;
+    }
+    return it->second;
+}
+
 OperatorSemantics EvaluationContext::getOperatorSemantics(const std::string& op) const {
     auto it = operatorSemantics_.find(op);
     if (it != operatorSemantics_.end()) {
@@ -140,6 +301,7 @@ void EvaluationContext::setOperatorSemantics(
     OperatorSemantics semantics)
 {
     operatorSemantics_[op] = semantics;
+    ++bindingRevision_;
 }
 
 //=============================================================================
@@ -155,216 +317,190 @@ EvaluationResult Evaluator::evaluate(const ASTNode* node) {
 // MathFunctions Implementation
 //=============================================================================
 
-void MathFunctions::registerBuiltInFunctions(EvaluationContext& context) {
-    // Trigonometric functions
-    context.addFunction("sin", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("sin requires exactly 1 argument");
-        }
-        return std::sin(args[0]);
-    });
+namespace {
 
-    context.addFunction("cos", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("cos requires exactly 1 argument");
-        }
-        return std::cos(args[0]);
-    });
-
-    context.addFunction("tan", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("tan requires exactly 1 argument");
-        }
-        return std::tan(args[0]);
-    });
+// Built-ins with a restricted domain reject arguments outside it instead of
+// returning NaN, so errors name the function rather than the operation.
 
-    context.addFunction("asin", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("asin requires exactly 1 argument");
-        }
-        if (args[0] < -1.0 || args[0] > 1.0) {
-            throw CalculatorException(ErrorCode::DOMAIN_ERROR, "asin argument must be in [-1, 1]", 0);
-        }
-        return std::asin(args[0]);
-    });
-
-    context.addFunction("acos", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("acos requires exactly 1 argument");
-        }
-        if (args[0] < -1.0 || args[0] > 1.0) {
-            throw CalculatorException(ErrorCode::DOMAIN_ERROR, "acos argument must be in [-1, 1]", 0);
-        }
-        return std::acos(args[0]);
-    });
-
-    context.addFunction("atan", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("atan requires exactly 1 argument");
-        }
-        return std::atan(args[0]);
-    });
+double checkedAsin(double x) {
+    if (x < -1.0 || x > 1.0) {
+        throw CalculatorException(ErrorCode::DOMAIN_ERROR, "asin argument must be in [-1, 1]", 0);
+    }
+    return std::asin(x);
+}
 
-    // Hyperbolic functions
-    context.addFunction("sinh", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("sinh requires exactly 1 argument");
-        }
-        return std::sinh(args[0]);
-    });
+double checkedAcos(double x) {
+    if (x < -1.0 || x > 1.0) {
+        throw CalculatorException(ErrorCode::DOMAIN_ERROR, "acos argument must be in [-1, 1]", 0);
+    }
+    return std::acos(x);
+}
 
-    context.addFunction("cosh", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("cosh requires exactly 1 argument");
-        }
-        return std::cosh(args[0]);
-    });
+double checkedLog(double x) {
+    if (x <= 0.0) {
+        throw CalculatorException(ErrorCode::DOMAIN_ERROR, "log argument must be positive", 0);
+    }
+    return std::log(x);
+}
 
-    context.addFunction("tanh", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("tanh requires exactly 1 argument");
-        }
-        return std::tanh(args[0]);
-    });
+double checkedLog10(double x) {
+    if (x <= 0.0) {
+        throw std::domain_error("log10 argument must be positive");
+    }
+    return std::log10(x);
+}
 
-    // Logarithmic and exponential functions
-    context.addFunction("log", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("log requires exactly 1 argument");
-        }
-        if (args[0] <= 0.0) {
-            throw CalculatorException(ErrorCode::DOMAIN_ERROR, "log argument must be positive", 0);
-        }
-        return std::log(args[0]);
-    });
+double checkedSqrt(double x) {
+    if (x < 0.0) {
+        throw CalculatorException(ErrorCode::DOMAIN_ERROR, "sqrt argument must be non-negative", 0);
+    }
+    return std::sqrt(x);
+}
 
-    context.addFunction("log10", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("log10 requires exactly 1 argument");
-        }
-        if (args[0] <= 0.0) {
-            throw std::domain_error("log10 argument must be positive");
-        }
-        return std::log10(args[0]);
-    });
+double checkedFmod(double x, double y) {
+    if (y == 0.0) {
+        throw std::domain_error("fmod divisor cannot be zero");
+    }
+    return std::fmod(x, y);
+}
 
-    context.addFunction("exp", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("exp requires exactly 1 argument");
-        }
-        return std::exp(args[0]);
-    });
+double checkedRemainder(double x, double y) {
+    if (y == 0.0) {
+        throw std::domain_error("remainder divisor cannot be zero");
+    }
+    return std::remainder(x, y);
+}
 
-    context.addFunction("sqrt", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("sqrt requires exactly 1 argument");
-        }
-        if (args[0] < 0.0) {
-            throw CalculatorException(ErrorCode::DOMAIN_ERROR, "sqrt argument must be non-negative", 0);
-        }
-        return std::sqrt(args[0]);
-    });
+double maxOf(const double* args, size_t count) {
+    return *std::max_element(args, args + count);
+}
 
-    context.addFunction("cbrt", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("cbrt requires exactly 1 argument");
-        }
-        return std::cbrt(args[0]);
-    });
+double minOf(const double* args, size_t count) {
+    return *std::min_element(args, args + count);
+}
 
-    context.addFunction("pow", [](const std::vector<double>& args) -> double {
-        if (args.size() != 2) {
-            throw std::invalid_argument("pow requires exactly 2 arguments");
-        }
-        return std::pow(args[0], args[1]);
-    });
+double pi() { return M_PI; }
+double e() { return M_E; }
+
+// One built-in function; every built-in is pure
+struct BuiltinDefinition {
+    std::string_view name;
+    FunctionArity arity;
+    NullaryFunction nullary;
+    UnaryFunction unary;
+    BinaryFunction binary;
+    VariadicFunction variadic;
+    size_t minArgs;
+    BuiltinFunction builtin;
+};
+
+constexpr BuiltinDefinition constant(std::string_view name, NullaryFunction function) {
+    return {name, FunctionArity::NULLARY, function, nullptr, nullptr, nullptr, 0, BuiltinFunction::NONE};
+}
 
-    // Rounding and absolute functions
-    context.addFunction("abs", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("abs requires exactly 1 argument");
-        }
-        return std::abs(args[0]);
-    });
+constexpr BuiltinDefinition unary(std::string_view name, UnaryFunction function, BuiltinFunction builtin) {
+    return {name, FunctionArity::UNARY, nullptr, function, nullptr, nullptr, 0, builtin};
+}
 
-    context.addFunction("floor", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("floor requires exactly 1 argument");
-        }
-        return std::floor(args[0]);
-    });
+constexpr BuiltinDefinition binary(std::string_view name, BinaryFunction function) {
+    return {name, FunctionArity::BINARY, nullptr, nullptr, function, nullptr, 0, BuiltinFunction::NONE};
+}
 
-    context.addFunction("ceil", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("ceil requires exactly 1 argument");
-        }
-        return std::ceil(args[0]);
-    });
+constexpr BuiltinDefinition variadic(std::string_view name, VariadicFunction function, size_t minArgs) {
+    return {name, FunctionArity::VARIADIC, nullptr, nullptr, nullptr, function, minArgs, BuiltinFunction::NONE};
+}
 
-    context.addFunction("round", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("round requires exactly 1 argument");
+// Sorted by name (byte order), so lookups are a binary search
+constexpr BuiltinDefinition BUILTINS[] = {
+    constant("E", &e),
+    constant("PI", &pi),
+    unary("abs", &MathFunctions::abs, BuiltinFunction::ABS),
+    unary("acos", &checkedAcos, BuiltinFunction::ACOS),
+    unary("asin", &checkedAsin, BuiltinFunction::ASIN),
+    unary("atan", &MathFunctions::atan, BuiltinFunction::ATAN),
+    unary("cbrt", &MathFunctions::cbrt, BuiltinFunction::CBRT),
+    unary("ceil", &MathFunctions::ceil, BuiltinFunction::CEIL),
+    unary("cos", &MathFunctions::cos, BuiltinFunction::COS),
+    unary("cosh", &MathFunctions::cosh, BuiltinFunction::COSH),
+    unary("exp", &MathFunctions::exp, BuiltinFunction::EXP),
+    unary("floor", &MathFunctions::floor, BuiltinFunction::FLOOR),
+    binary("fmod", &checkedFmod),
+    binary("hypot", &MathFunctions::hypot),
+    unary("log", &checkedLog, BuiltinFunction::LOG),
+    unary("log10", &checkedLog10, BuiltinFunction::LOG10),
+    variadic("max", &maxOf, 2),
+    variadic("min", &minOf, 2),
+    binary("pow", &MathFunctions::pow),
+    binary("remainder", &checkedRemainder),
+    unary("round", &MathFunctions::round, BuiltinFunction::ROUND),
+    unary("sin", &MathFunctions::sin, BuiltinFunction::SIN),
+    unary("sinh", &MathFunctions::sinh, BuiltinFunction::SINH),
+    unary("sqrt", &checkedSqrt, BuiltinFunction::SQRT),
+    unary("tan", &MathFunctions::tan, BuiltinFunction::TAN),
+    unary("tanh", &MathFunctions::tanh, BuiltinFunction::TANH),
+    unary("trunc", &MathFunctions::trunc, BuiltinFunction::TRUNC),
+};
+
+constexpr size_t BUILTIN_COUNT = sizeof(BUILTINS) / sizeof(BUILTINS[0]);
+
+constexpr bool builtinsSorted() {
+    for (size_t i = 1; i < BUILTIN_COUNT; ++i) {
+        if (!(BUILTINS[i - 1].name < BUILTINS[i].name)) {
+            return false;
         }
-        return std::round(args[0]);
-    });
+    }
+    return true;
+}
 
-    context.addFunction("trunc", [](const std::vector<double>& args) -> double {
-        if (args.size() != 1) {
-            throw std::invalid_argument("trunc requires exactly 1 argument");
-        }
-        return std::trunc(args[0]);
-    });
+static_assert(builtinsSorted(), "BUILTINS must be sorted by name without duplicates");
 
-    // Other functions
-    context.addFunction("fmod", [](const std::vector<double>& args) -> double {
-        if (args.size() != 2) {
-            throw std::invalid_argument("fmod requires exactly 2 arguments");
-        }
-        if (args[1] == 0.0) {
-            throw std::domain_error("fmod divisor cannot be zero");
-        }
-        return std::fmod(args[0], args[1]);
-    });
+size_t findBuiltinIndex(std::string_view name) noexcept {
+    const BuiltinDefinition* end = BUILTINS + BUILTIN_COUNT;
+    const BuiltinDefinition* it = std::lower_bound(BUILTINS, end, name,
+        [](const BuiltinDefinition& definition, std::string_view key) { return definition.name < key; });
+    if (it == end || it->name != name) {
+        return NO_BUILTIN;
+    }
+    return static_cast<size_t>(it - BUILTINS);
+}
 
-    context.addFunction("remainder", [](const std::vector<double>& args) -> double {
-        if (args.size() != 2) {
-            throw std::invalid_argument("remainder requires exactly 2 arguments");
-        }
-        if (args[1] == 0.0) {
-            throw std::domain_error("remainder divisor cannot be zero");
-        }
-        return std::remainder(args[0], args[1]);
-    });
+FunctionEntry makeEntry(const BuiltinDefinition& definition) {
+    FunctionEntry entry;
+    entry.arity = definition.arity;
+    switch (definition.arity) {
+        case FunctionArity::NULLARY:  entry.fn.nullary = definition.nullary; break;
+        case FunctionArity::UNARY:    entry.fn.unary = definition.unary; break;
+        case FunctionArity::BINARY:   entry.fn.binary = definition.binary; break;
+        default:                      entry.fn.variadic = definition.variadic; break;
+    }
+    entry.minArgs = definition.minArgs;
+    entry.builtin = definition.builtin;
+    entry.pure = true;
+    return entry;
+}
 
-    context.addFunction("max", [](const std::vector<double>& args) -> double {
-        if (args.size() < 2) {
-            throw std::invalid_argument("max requires at least 2 arguments");
-        }
-        return *std::max_element(args.begin(), args.end());
-    });
+} // anonymous namespace
 
-    context.addFunction("min", [](const std::vector<double>& args) -> double {
-        if (args.size() < 2) {
-            throw std::invalid_argument("min requires at least 2 arguments");
-        }
-        return *std::min_element(args.begin(), args.end());
-    });
+void MathFunctions::registerBuiltInFunctions(EvaluationContext& context) {
+    // Assigned element by element, so pointers from findFunction() stay valid
+    // when the built-ins are registered again
+    ++context.bindingRevision_;
+    context.builtins_.resize(BUILTIN_COUNT);
+    for (size_t i = 0; i < BUILTIN_COUNT; ++i) {
+        context.builtins_[i] = makeEntry(BUILTINS[i]);
+    }
 
-    context.addFunction("hypot", [](const std::vector<double>& args) -> double {
-        if (args.size() != 2) {
-            throw std::invalid_argument("hypot requires exactly 2 arguments");
+    // Functions added under a built-in name before now are replaced as well
+    for (auto& [name, entry] : context.functions_) {
+        size_t index = findBuiltinIndex(name);
+        if (index != NO_BUILTIN) {
+            entry = context.builtins_[index];
         }
-        return std::hypot(args[0], args[1]);
-    });
-
-    // Constants (as functions with no arguments)
-    context.addFunction("PI", [](const std::vector<double>&) -> double {
-        return M_PI;
-    });
+    }
+}
 
-    context.addFunction("E", [](const std::vector<double>&) -> double {
-        return M_E;
-    });
+bool MathFunctions::isBuiltInFunction(std::string_view name) noexcept {
+    return findBuiltinIndex(name) != NO_BUILTIN;
 }
 
 // Standalone function implementations for direct use
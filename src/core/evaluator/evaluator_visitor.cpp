@@ -19,7 +19,7 @@ EvaluatorVisitor::EvaluatorVisitor()
 
 EvaluationResult EvaluatorVisitor::evaluate(
     const ASTNode* node,
-    EvaluationContext& context)
+    const EvaluationContext& context)
 {
     if (node == nullptr) {
         return EvaluationResult(ErrorCode::EVALUATION_ERROR,
@@ -27,14 +27,18 @@ EvaluationResult EvaluatorVisitor::evaluate(
     }
 
     // Save and set current context
-    EvaluationContext* prevContext = context_;
+    const EvaluationContext* prevContext = context_;
     context_ = &context;
 
     // Reset result state
     result_ = EvaluationResult(0.0);
+    values_.clear();
 
-    // Accept visitor to trigger evaluation
-    const_cast<ASTNode*>(node)->accept(*this);
+    // Walk the tree; the root's value is the only one left on the stack
+    if (walker_.walk(const_cast<ASTNode&>(*node), *this)) {
+        result_ = EvaluationResult(values_.back());
+    }
+    values_.clear();
 
     // Restore previous context
     context_ = prevContext;
@@ -42,67 +46,89 @@ EvaluationResult EvaluatorVisitor::evaluate(
     return result_;
 }
 
+void EvaluatorVisitor::fail(EvaluationResult error) {
+    result_ = std::move(error);
+    walker_.stop();
+}
+
 void EvaluatorVisitor::visit(LiteralNode& node) {
-    result_ = EvaluationResult(node.getValue());
+    values_.push_back(node.getValue());
 }
 
-void EvaluatorVisitor::visit(BinaryOpNode& node) {
-    // Evaluate left operand
-    EvaluationResult leftResult = evaluate(node.getLeft(), *context_);
-    if (leftResult.isError()) {
-        result_ = leftResult;
+void EvaluatorVisitor::visit(VariableNode& node) {
+    size_t slot = context_->findVariableSlot(node.getName());
+    if (slot != EvaluationContext::NO_SLOT) {
+        values_.push_back(context_->getVariable(slot));
         return;
     }
 
-    // Evaluate right operand
-    EvaluationResult rightResult = evaluate(node.getRight(), *context_);
-    if (rightResult.isError()) {
-        result_ = rightResult;
+    // Constants such as PI and E are zero-argument functions
+    if (const FunctionEntry* entry = context_->findFunction(node.getName())) {
+        EvaluationResult result = EvaluationContext::callFunction(*entry, node.getName(), nullptr, 0);
+        if (result.isError()) {
+            size_t position = result.getErrorPosition() == 0 ? node.getPosition() : result.getErrorPosition();
+            fail(EvaluationResult(result.getErrorCode(), result.getErrorMessage(), position));
+            return;
+        }
+        values_.push_back(result.getValue());
         return;
     }
 
-    // Perform binary operation
-    result_ = evaluateBinaryOp(leftResult.getValue(), node.getOperator(),
-                               rightResult.getValue());
+    fail(EvaluationResult(ErrorCode::UNDEFINED_VARIABLE,
+        "Undefined variable: " + node.getName(), node.getPosition()));
 }
 
-void EvaluatorVisitor::visit(UnaryOpNode& node) {
-    // Evaluate operand
-    EvaluationResult operandResult = evaluate(node.getOperand(), *context_);
-    if (operandResult.isError()) {
-        result_ = operandResult;
+void EvaluatorVisitor::visit(BinaryOpNode& node) {
+    // Both operands have been evaluated, left first
+    double right = values_.back();
+    values_.pop_back();
+    double left = values_.back();
+    values_.pop_back();
+
+    EvaluationResult result = evaluateBinaryOp(left, node.getOpCode(), node.getPosition(), right);
+    if (result.isError()) {
+        fail(std::move(result));
         return;
     }
+    values_.push_back(result.getValue());
+}
+
+void EvaluatorVisitor::visit(UnaryOpNode& node) {
+    double operand = values_.back();
+    values_.pop_back();
 
-    // Perform unary operation
-    result_ = evaluateUnaryOp(node.getOperator(), operandResult.getValue());
+    EvaluationResult result = evaluateUnaryOp(node.getOpCode(), node.getPosition(), operand);
+    if (result.isError()) {
+        fail(std::move(result));
+        return;
+    }
+    values_.push_back(result.getValue());
 }
 
 void EvaluatorVisitor::visit(FunctionCallNode& node) {
-    // Evaluate all arguments
-    std::vector<double> args;
-    args.reserve(node.getArgumentCount());
-
-    for (size_t i = 0; i < node.getArgumentCount(); ++i) {
-        EvaluationResult argResult = evaluate(node.getArgument(i), *context_);
-        if (argResult.isError()) {
-            result_ = argResult;
-            return;
-        }
-        args.push_back(argResult.getValue());
-    }
+    // The arguments are the top values of the stack, in order, so they
+    // are passed in place without copying
+    size_t frame = values_.size() - node.getArgumentCount();
 
     // Call function through context
-    result_ = context_->callFunction(node.getName(), args);
+    EvaluationResult result(0.0);
+    const FunctionEntry* entry = context_->findFunction(node.getName());
+    if (entry == nullptr) {
+        result = EvaluationResult(ErrorCode::INVALID_FUNCTION,
+            "Unknown function: " + node.getName());
+    } else {
+        result = EvaluationContext::callFunction(*entry, node.getName(),
+                                                 values_.data() + frame, node.getArgumentCount());
+    }
+    values_.resize(frame);
 
     // If the function failed, add position information
-    if (result_.isError() && result_.getErrorPosition() == 0) {
-        // Create a new result with the function's position
-        result_ = EvaluationResult(
-            result_.getErrorCode(),
-            result_.getErrorMessage(),
-            node.getPosition());
+    if (result.isError()) {
+        size_t position = result.getErrorPosition() == 0 ? node.getPosition() : result.getErrorPosition();
+        fail(EvaluationResult(result.getErrorCode(), result.getErrorMessage(), position));
+        return;
     }
+    values_.push_back(result.getValue());
 }
 
 EvaluationResult EvaluatorVisitor::getResult() const {
@@ -116,15 +142,13 @@ void EvaluatorVisitor::reset() {
 
 EvaluationResult EvaluatorVisitor::evaluateBinaryOp(
     double left,
-    const Token& op,
+    OpCode op,
+    size_t position,
     double right)
 {
-    const std::string& opStr = op.value;
-    size_t position = op.position;
-
     try {
         // Check for division by zero
-        if ((opStr == "/" || opStr == "%") && approxEqual(right, 0.0)) {
+        if ((op == OpCode::DIV || op == OpCode::MOD) && approxEqual(right, 0.0)) {
             return EvaluationResult(ErrorCode::DIVISION_BY_ZERO,
                 "Division by zero", position);
         }
@@ -132,42 +156,48 @@ EvaluationResult EvaluatorVisitor::evaluateBinaryOp(
         // Perform operation
         double result = 0.0;
 
-        if (opStr == "+") {
-            result = left + right;
-        } else if (opStr == "-") {
-            result = left - right;
-        } else if (opStr == "*") {
-            result = left * right;
-        } else if (opStr == "/") {
-            result = left / right;
-        } else if (opStr == "%") {
-            result = std::fmod(left, right);
-        } else if (opStr == "^") {
-            // Check operator semantics from context
-            OperatorSemantics semantics = context_->getOperatorSemantics("^");
-            if (semantics == OperatorSemantics::BITWISE_XOR) {
-                // Programmer mode: Bitwise XOR
-                result = static_cast<double>(
-                    static_cast<long long>(left) ^ static_cast<long long>(right));
-            } else {
-                // Standard/Scientific mode: Power operation (exponentiation)
-                result = std::pow(left, right);
-            }
-        } else if (opStr == "&") {
-            // Bitwise AND
-            result = static_cast<double>(static_cast<long long>(left) & static_cast<long long>(right));
-        } else if (opStr == "|") {
-            // Bitwise OR
-            result = static_cast<double>(static_cast<long long>(left) | static_cast<long long>(right));
-        } else if (opStr == "<<") {
-            // Left shift
-            result = static_cast<double>(static_cast<long long>(left) << static_cast<long long>(right));
-        } else if (opStr == ">>") {
-            // Right shift
-            result = static_cast<double>(static_cast<long long>(left) >> static_cast<long long>(right));
-        } else {
-            return EvaluationResult(ErrorCode::EVALUATION_ERROR,
-                "Unknown binary operator: " + opStr, position);
+        switch (op) {
+            case OpCode::ADD:
+                result = left + right;
+                break;
+            case OpCode::SUB:
+                result = left - right;
+                break;
+            case OpCode::MUL:
+                result = left * right;
+                break;
+            case OpCode::DIV:
+                result = left / right;
+                break;
+            case OpCode::MOD:
+                result = std::fmod(left, right);
+                break;
+            case OpCode::POW:
+                // Check operator semantics from context
+                if (context_->getOperatorSemantics("^") == OperatorSemantics::BITWISE_XOR) {
+                    // Programmer mode: Bitwise XOR
+                    result = static_cast<double>(
+                        static_cast<long long>(left) ^ static_cast<long long>(right));
+                } else {
+                    // Standard/Scientific mode: Power operation (exponentiation)
+                    result = std::pow(left, right);
+                }
+                break;
+            case OpCode::BIT_AND:
+                result = static_cast<double>(static_cast<long long>(left) & static_cast<long long>(right));
+                break;
+            case OpCode::BIT_OR:
+                result = static_cast<double>(static_cast<long long>(left) | static_cast<long long>(right));
+                break;
+            case OpCode::SHL:
+                result = static_cast<double>(static_cast<long long>(left) << static_cast<long long>(right));
+                break;
+            case OpCode::SHR:
+                result = static_cast<double>(static_cast<long long>(left) >> static_cast<long long>(right));
+                break;
+            default:
+                return EvaluationResult(ErrorCode::EVALUATION_ERROR,
+                    std::string("Unknown binary operator: ") + opCodeSymbol(op), position);
         }
 
         // Check for overflow/underflow
@@ -204,26 +234,27 @@ EvaluationResult EvaluatorVisitor::evaluateBinaryOp(
 }
 
 EvaluationResult EvaluatorVisitor::evaluateUnaryOp(
-    const Token& op,
+    OpCode op,
+    size_t position,
     double operand)
 {
-    const std::string& opStr = op.value;
-    size_t position = op.position;
-
     try {
         double result = 0.0;
 
-        if (opStr == "+") {
-            result = operand;
-        } else if (opStr == "-") {
-            result = -operand;
-        } else if (opStr == "~" || opStr == "u~") {
-            // Bitwise NOT (for integer-like values)
-            // Tokenizer marks ~ as u~ for unary operator
-            result = ~static_cast<long long>(operand);
-        } else {
-            return EvaluationResult(ErrorCode::EVALUATION_ERROR,
-                "Unknown unary operator: " + opStr, position);
+        switch (op) {
+            case OpCode::PLUS:
+                result = operand;
+                break;
+            case OpCode::NEG:
+                result = -operand;
+                break;
+            case OpCode::BIT_NOT:
+                // Bitwise NOT (for integer-like values)
+                result = static_cast<double>(~static_cast<long long>(operand));
+                break;
+            default:
+                return EvaluationResult(ErrorCode::EVALUATION_ERROR,
+                    std::string("Unknown unary operator: ") + opCodeSymbol(op), position);
         }
 
         // Check for overflow
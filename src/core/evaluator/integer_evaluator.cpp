@@ -0,0 +1,348 @@
+/**
+ * @file integer_evaluator.cpp
+ * @brief Fixed-width integer evaluation for programmer mode
+ */
+
+#include "calc/core/integer_evaluator.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace calc {
+
+namespace {
+
+/// 2^63 and 2^64 as doubles, the bounds of 64-bit conversion
+constexpr double TWO_POW_63 = 9223372036854775808.0;
+constexpr double TWO_POW_64 = 18446744073709551616.0;
+
+} // anonymous namespace
+
+//=============================================================================
+// IntegerResult Implementation
+//=============================================================================
+
+IntegerResult::IntegerResult(uint64_t bits, WordSize size, bool isSigned) noexcept
+    : bits_(bits & wordMask(size))
+    , wordSize_(size)
+    , isSigned_(isSigned)
+    , isError_(false)
+    , errorCode_(ErrorCode::UNKNOWN_ERROR)
+    , errorPosition_(0)
+{}
+
+IntegerResult::IntegerResult(ErrorCode code, const std::string& message, size_t position)
+    : bits_(0)
+    , wordSize_(WordSize::BITS_64)
+    , isSigned_(true)
+    , isError_(true)
+    , errorCode_(code)
+    , errorMessage_(message)
+    , errorPosition_(position)
+{}
+
+int64_t IntegerResult::getSigned() const noexcept {
+    const unsigned unused = 64 - static_cast<unsigned>(wordSize_);
+    return static_cast<int64_t>(bits_ << unused) >> unused;
+}
+
+ErrorCode IntegerResult::getErrorCode() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error code from successful result");
+    }
+    return errorCode_;
+}
+
+const std::string& IntegerResult::getErrorMessage() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error message from successful result");
+    }
+    return errorMessage_;
+}
+
+size_t IntegerResult::getErrorPosition() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error position from successful result");
+    }
+    return errorPosition_;
+}
+
+EvaluationResult IntegerResult::toEvaluationResult() const {
+    if (isError_) {
+        return EvaluationResult(errorCode_, errorMessage_, errorPosition_);
+    }
+    return EvaluationResult(isSigned_ ? static_cast<double>(getSigned())
+                                      : static_cast<double>(bits_));
+}
+
+//=============================================================================
+// IntegerEvaluator Implementation
+//=============================================================================
+
+IntegerEvaluator::IntegerEvaluator(WordSize size, bool isSigned)
+    : wordSize_(size)
+    , mask_(wordMask(size))
+    , isSigned_(isSigned)
+{}
+
+void IntegerEvaluator::setWordSize(WordSize size) noexcept {
+    wordSize_ = size;
+    mask_ = wordMask(size);
+}
+
+IntegerResult IntegerEvaluator::evaluate(const ASTNode& root, const EvaluationContext& context) {
+    context_ = &context;
+    xor_ = context.getOperatorSemantics("^") == OperatorSemantics::BITWISE_XOR;
+    failed_ = false;
+    values_.clear();
+
+    walker_.walk(const_cast<ASTNode&>(root), *this);
+    context_ = nullptr;
+
+    if (failed_) {
+        return error_;
+    }
+    return IntegerResult(values_.back(), wordSize_, isSigned_);
+}
+
+void IntegerEvaluator::fail(ErrorCode code, const std::string& message, size_t position) {
+    error_ = IntegerResult(code, message, position);
+    failed_ = true;
+    walker_.stop();
+}
+
+int64_t IntegerEvaluator::toSigned(uint64_t word) const noexcept {
+    const unsigned unused = 64 - static_cast<unsigned>(wordSize_);
+    return static_cast<int64_t>(word << unused) >> unused;
+}
+
+double IntegerEvaluator::toDouble(uint64_t word) const noexcept {
+    return isSigned_ ? static_cast<double>(toSigned(word)) : static_cast<double>(word);
+}
+
+bool IntegerEvaluator::fromDouble(double value, uint64_t& word) const noexcept {
+    if (!(std::trunc(value) == value) || value < -TWO_POW_63 || value >= TWO_POW_64) {
+        return false;  // Fractional, infinite, NaN or out of range
+    }
+    word = value < 0.0 ? static_cast<uint64_t>(static_cast<int64_t>(value))
+                       : static_cast<uint64_t>(value);
+    word &= mask_;
+    return true;
+}
+
+void IntegerEvaluator::visit(LiteralNode& node) {
+    if (node.hasInteger()) {
+        values_.push_back(node.getInteger() & mask_);
+        return;
+    }
+
+    uint64_t word = 0;
+    if (!fromDouble(node.getValue(), word)) {
+        fail(ErrorCode::DOMAIN_ERROR, "Not an integer: " + node.toString(), 0);
+        return;
+    }
+    values_.push_back(word);
+}
+
+void IntegerEvaluator::visit(VariableNode& node) {
+    double value = 0.0;
+    size_t slot = context_->findVariableSlot(node.getName());
+    if (slot != EvaluationContext::NO_SLOT) {
+        value = context_->getVariable(slot);
+    } else if (const FunctionEntry* entry = context_->findFunction(node.getName())) {
+        // Constants are zero-argument functions
+        EvaluationResult result = EvaluationContext::callFunction(*entry, node.getName(), nullptr, 0);
+        if (result.isError()) {
+            size_t position = result.getErrorPosition() == 0 ? node.getPosition() : result.getErrorPosition();
+            fail(result.getErrorCode(), result.getErrorMessage(), position);
+            return;
+        }
+        value = result.getValue();
+    } else {
+        fail(ErrorCode::UNDEFINED_VARIABLE, "Undefined variable: " + node.getName(), node.getPosition());
+        return;
+    }
+
+    uint64_t word = 0;
+    if (!fromDouble(value, word)) {
+        fail(ErrorCode::DOMAIN_ERROR, "Not an integer: " + node.getName(), node.getPosition());
+        return;
+    }
+    values_.push_back(word);
+}
+
+void IntegerEvaluator::visit(BinaryOpNode& node) {
+    uint64_t right = values_.back();
+    values_.pop_back();
+    uint64_t left = values_.back();
+    values_.pop_back();
+
+    uint64_t result = 0;
+    if (applyBinary(node.getOpCode(), node.getPosition(), left, right, result)) {
+        values_.push_back(result & mask_);
+    }
+}
+
+void IntegerEvaluator::visit(UnaryOpNode& node) {
+    uint64_t operand = values_.back();
+    values_.pop_back();
+
+    switch (node.getOpCode()) {
+        case OpCode::PLUS:
+            values_.push_back(operand);
+            break;
+        case OpCode::NEG:
+            values_.push_back((0 - operand) & mask_);
+            break;
+        case OpCode::BIT_NOT:
+            values_.push_back(~operand & mask_);
+            break;
+        default:
+            fail(ErrorCode::EVALUATION_ERROR,
+                 std::string("Unknown unary operator: ") + opCodeSymbol(node.getOpCode()),
+                 node.getPosition());
+            break;
+    }
+}
+
+void IntegerEvaluator::visit(FunctionCallNode& node) {
+    const size_t count = node.getArgumentCount();
+    const size_t frame = values_.size() - count;
+
+    const FunctionEntry* entry = context_->findFunction(node.getName());
+    if (entry == nullptr) {
+        fail(ErrorCode::INVALID_FUNCTION, "Unknown function: " + node.getName(), node.getPosition());
+        return;
+    }
+
+    // The function registry works on doubles
+    arguments_.clear();
+    for (size_t i = frame; i < values_.size(); ++i) {
+        arguments_.push_back(toDouble(values_[i]));
+    }
+    values_.resize(frame);
+
+    EvaluationResult result = EvaluationContext::callFunction(*entry, node.getName(),
+                                                              arguments_.data(), count);
+    if (result.isError()) {
+        size_t position = result.getErrorPosition() == 0 ? node.getPosition() : result.getErrorPosition();
+        fail(result.getErrorCode(), result.getErrorMessage(), position);
+        return;
+    }
+
+    uint64_t word = 0;
+    if (!fromDouble(result.getValue(), word)) {
+        fail(ErrorCode::DOMAIN_ERROR, node.getName() + " did not return an integer", node.getPosition());
+        return;
+    }
+    values_.push_back(word);
+}
+
+bool IntegerEvaluator::applyBinary(OpCode op, size_t position, uint64_t left, uint64_t right,
+                                   uint64_t& result) {
+    const unsigned bits = static_cast<unsigned>(wordSize_);
+
+    switch (op) {
+        case OpCode::ADD:
+            result = left + right;
+            return true;
+        case OpCode::SUB:
+            result = left - right;
+            return true;
+        case OpCode::MUL:
+            result = left * right;
+            return true;
+
+        case OpCode::DIV:
+        case OpCode::MOD: {
+            if (right == 0) {
+                fail(ErrorCode::DIVISION_BY_ZERO, "Division by zero", position);
+                return false;
+            }
+            if (!isSigned_) {
+                result = op == OpCode::DIV ? left / right : left % right;
+                return true;
+            }
+            int64_t l = toSigned(left);
+            int64_t r = toSigned(right);
+            if (r == -1) {
+                // INT64_MIN / -1 overflows; negation wraps to the same word
+                result = op == OpCode::DIV ? 0 - left : 0;
+                return true;
+            }
+            result = static_cast<uint64_t>(op == OpCode::DIV ? l / r : l % r);
+            return true;
+        }
+
+        case OpCode::POW:
+            if (xor_) {
+                result = left ^ right;
+                return true;
+            }
+            return power(position, left, right, result);
+
+        case OpCode::BIT_AND:
+            result = left & right;
+            return true;
+        case OpCode::BIT_OR:
+            result = left | right;
+            return true;
+
+        case OpCode::SHL:
+        case OpCode::SHR: {
+            if (isSigned_ && toSigned(right) < 0) {
+                fail(ErrorCode::DOMAIN_ERROR, "Negative shift count", position);
+                return false;
+            }
+            const bool negative = isSigned_ && toSigned(left) < 0;
+            if (right >= bits) {
+                result = (op == OpCode::SHR && negative) ? ~uint64_t{0} : 0;
+                return true;
+            }
+            const auto count = static_cast<unsigned>(right);
+            if (op == OpCode::SHL) {
+                result = left << count;
+            } else if (negative) {
+                result = ~(~static_cast<uint64_t>(toSigned(left)) >> count);  // Arithmetic shift
+            } else {
+                result = left >> count;
+            }
+            return true;
+        }
+
+        default:
+            fail(ErrorCode::EVALUATION_ERROR,
+                 std::string("Unknown binary operator: ") + opCodeSymbol(op), position);
+            return false;
+    }
+}
+
+bool IntegerEvaluator::power(size_t position, uint64_t base, uint64_t exponent, uint64_t& result) {
+    if (isSigned_ && toSigned(exponent) < 0) {
+        // Only 1 and -1 have integer reciprocals
+        int64_t b = toSigned(base);
+        if (b == 0) {
+            fail(ErrorCode::DIVISION_BY_ZERO, "Division by zero", position);
+            return false;
+        }
+        if (b == 1 || b == -1) {
+            result = (b == -1 && (exponent & 1) != 0) ? base : 1;
+        } else {
+            result = 0;
+        }
+        return true;
+    }
+
+    // Square and multiply; the low bits of a product only depend on the
+    // low bits of its factors, so wrapping at 64 bits is exact for any word
+    result = 1;
+    while (exponent != 0) {
+        if ((exponent & 1) != 0) {
+            result *= base;
+        }
+        base *= base;
+        exponent >>= 1;
+    }
+    return true;
+}
+
+} // namespace calc
@@ -0,0 +1,112 @@
+/**
+ * @file expression_cache.cpp
+ * @brief Bounded LRU cache of parsed expressions
+ */
+
+#include "calc/core/expression_cache.h"
+
+namespace calc {
+
+ExpressionCache::ExpressionCache(size_t capacity)
+    : capacity_(capacity)
+    , hits_(0)
+    , misses_(0)
+    , evictions_(0) {
+}
+
+std::shared_ptr<const ASTNode> ExpressionCache::find(const std::string& mode,
+                                                     const std::string& parser,
+                                                     const std::string& expression) {
+    CachedExpression* entry = lookup(mode, parser, expression);
+    return entry != nullptr ? entry->ast : nullptr;
+}
+
+CachedExpression* ExpressionCache::lookup(const std::string& mode,
+                                          const std::string& parser,
+                                          const std::string& expression) {
+    if (capacity_ == 0) {
+        ++misses_;
+        return nullptr;
+    }
+
+    auto it = index_.find(makeKey(mode, parser, expression));
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+
+    ++hits_;
+    // Move to the front; list iterators (and the key views) stay valid
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->expression;
+}
+
+CachedExpression* ExpressionCache::insert(const std::string& mode,
+                                          const std::string& parser,
+                                          const std::string& expression,
+                                          std::shared_ptr<const ASTNode> ast) {
+    if (capacity_ == 0 || !ast) {
+        return nullptr;
+    }
+
+    const std::string& key = makeKey(mode, parser, expression);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        // A new tree invalidates bytecode compiled from the old one
+        it->second->expression = CachedExpression{std::move(ast), std::nullopt, 0};
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->expression;
+    }
+
+    entries_.push_front(Entry{key, CachedExpression{std::move(ast), std::nullopt, 0}});
+    index_.emplace(entries_.front().key, entries_.begin());
+    evictToCapacity();
+    return &entries_.front().expression;
+}
+
+void ExpressionCache::setCapacity(size_t capacity) {
+    capacity_ = capacity;
+    evictToCapacity();
+}
+
+void ExpressionCache::clear() {
+    index_.clear();
+    entries_.clear();
+}
+
+CacheStats ExpressionCache::getStats() const noexcept {
+    CacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.size = entries_.size();
+    stats.capacity = capacity_;
+    return stats;
+}
+
+void ExpressionCache::resetStats() noexcept {
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+const std::string& ExpressionCache::makeKey(const std::string& mode, const std::string& parser,
+                                            const std::string& expression) {
+    // '\0' cannot appear in mode or parser names, so the fields never run together
+    keyBuffer_.assign(mode);
+    keyBuffer_.push_back('\0');
+    keyBuffer_.append(parser);
+    keyBuffer_.push_back('\0');
+    keyBuffer_.append(expression);
+    return keyBuffer_;
+}
+
+void ExpressionCache::evictToCapacity() {
+    while (entries_.size() > capacity_) {
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+        ++evictions_;
+    }
+}
+
+} // namespace calc
@@ -0,0 +1,251 @@
+/**
+ * @file ast_optimizer.cpp
+ * @brief AST rewriting pass implementation
+ */
+
+#include "calc/core/ast_optimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace calc {
+
+namespace {
+
+/**
+ * @brief Counts the nodes of a tree
+ */
+class NodeCounter : public ASTVisitor {
+public:
+    size_t count = 0;
+
+    void visit(LiteralNode&) override { ++count; }
+    void visit(VariableNode&) override { ++count; }
+    void visit(BinaryOpNode&) override { ++count; }
+    void visit(UnaryOpNode&) override { ++count; }
+    void visit(FunctionCallNode&) override { ++count; }
+};
+
+inline const LiteralNode* asLiteral(const ASTNode* node) {
+    return dynamic_cast<const LiteralNode*>(node);
+}
+
+inline bool isLiteral(const ASTNode* node, double value) {
+    const LiteralNode* literal = asLiteral(node);
+    return literal != nullptr && literal->getValue() == value;
+}
+
+} // anonymous namespace
+
+//=============================================================================
+// ASTOptimizer Implementation
+//=============================================================================
+
+ASTOptimizer::ASTOptimizer(const EvaluationContext& context, OptimizerOptions options)
+    : context_(context), options_(options), columns_(nullptr) {
+}
+
+std::unique_ptr<ASTNode> ASTOptimizer::optimize(const ASTNode& root,
+                                                const std::vector<std::string>& columns) {
+    stats_ = OptimizationStats{};
+    stats_.nodesBefore = countNodes(root);
+    columns_ = &columns;
+
+    // Children are rewritten before their parents, which pop the results
+    results_.clear();
+    PostOrderWalker walker;
+    walker.walk(const_cast<ASTNode&>(root), *this);
+    std::unique_ptr<ASTNode> optimized = popResult();
+
+    columns_ = nullptr;
+    stats_.nodesAfter = countNodes(*optimized);
+    return optimized;
+}
+
+size_t ASTOptimizer::countNodes(const ASTNode& root) {
+    NodeCounter counter;
+    PostOrderWalker walker;
+    walker.walk(const_cast<ASTNode&>(root), counter);
+    return counter.count;
+}
+
+void ASTOptimizer::visit(LiteralNode& node) {
+    results_.push_back(node.clone());
+}
+
+void ASTOptimizer::visit(VariableNode& node) {
+    const std::string& name = node.getName();
+    if (!isColumn(name) && !context_.hasVariable(name) && context_.isPureFunction(name)) {
+        results_.push_back(fold(node.clone()));
+        return;
+    }
+    results_.push_back(node.clone());
+}
+
+void ASTOptimizer::visit(BinaryOpNode& node) {
+    std::unique_ptr<ASTNode> right = popResult();
+    std::unique_ptr<ASTNode> left = popResult();
+    const bool constant = asLiteral(left.get()) != nullptr && asLiteral(right.get()) != nullptr;
+
+    auto rebuilt = std::make_unique<BinaryOpNode>(std::move(left), node.getOperator(), std::move(right));
+    if (constant) {
+        results_.push_back(fold(std::move(rebuilt)));
+        return;
+    }
+    results_.push_back(simplifyBinary(std::move(rebuilt)));
+}
+
+void ASTOptimizer::visit(UnaryOpNode& node) {
+    std::unique_ptr<ASTNode> operand = popResult();
+    if (node.getOpCode() == OpCode::PLUS) {
+        ++stats_.identitiesRemoved;
+        results_.push_back(std::move(operand));
+        return;
+    }
+
+    const bool constant = asLiteral(operand.get()) != nullptr;
+    auto rebuilt = std::make_unique<UnaryOpNode>(node.getOperator(), std::move(operand));
+    results_.push_back(constant ? fold(std::move(rebuilt)) : std::move(rebuilt));
+}
+
+void ASTOptimizer::visit(FunctionCallNode& node) {
+    // The rewritten arguments are the top results, in order
+    auto first = results_.end() - static_cast<std::ptrdiff_t>(node.getArgumentCount());
+    std::vector<std::unique_ptr<ASTNode>> args(std::make_move_iterator(first),
+                                               std::make_move_iterator(results_.end()));
+    results_.erase(first, results_.end());
+
+    bool constant = true;
+    for (const auto& arg : args) {
+        constant = constant && asLiteral(arg.get()) != nullptr;
+    }
+
+    auto rebuilt = std::make_unique<FunctionCallNode>(node.getName(), node.getPosition(), std::move(args));
+    if (constant && context_.isPureFunction(node.getName())) {
+        results_.push_back(fold(std::move(rebuilt)));
+        return;
+    }
+    results_.push_back(std::move(rebuilt));
+}
+
+std::unique_ptr<ASTNode> ASTOptimizer::popResult() {
+    std::unique_ptr<ASTNode> node = std::move(results_.back());
+    results_.pop_back();
+    return node;
+}
+
+std::unique_ptr<ASTNode> ASTOptimizer::fold(std::unique_ptr<ASTNode> node) {
+    EvaluatorVisitor evaluator;
+    EvaluationResult value = evaluator.evaluate(node.get(), context_);
+    if (value.isError()) {
+        return node;  // Keep the subtree so evaluation reports the error where it occurs
+    }
+    ++stats_.constantsFolded;
+    return std::make_unique<LiteralNode>(value.getValue());
+}
+
+std::unique_ptr<ASTNode> ASTOptimizer::simplifyBinary(std::unique_ptr<BinaryOpNode> node) {
+    const Token& op = node->getOperator();
+    const ASTNode* left = node->getLeft();
+    const ASTNode* right = node->getRight();
+
+    // Powers of a variable: x ^ 2 is exactly x * x
+    if (isPowerOperator(*node) && dynamic_cast<const VariableNode*>(left) != nullptr) {
+        if (isLiteral(right, 2.0)) {
+            ++stats_.strengthReduced;
+            return expandPower(*left, 2, op);
+        }
+        const LiteralNode* exponent = asLiteral(right);
+        if (options_.fastMath && exponent != nullptr &&
+            exponent->getValue() > 2.0 &&
+            exponent->getValue() <= static_cast<double>(options_.maxExpandedExponent) &&
+            std::trunc(exponent->getValue()) == exponent->getValue()) {
+            ++stats_.strengthReduced;
+            return expandPower(*left, static_cast<long long>(exponent->getValue()), op);
+        }
+    }
+
+    if (!options_.fastMath) {
+        return node;
+    }
+
+    switch (op.opcode) {
+        case OpCode::ADD:
+            if (isLiteral(right, 0.0)) {
+                ++stats_.identitiesRemoved;
+                return node->releaseLeft();
+            }
+            if (isLiteral(left, 0.0)) {
+                ++stats_.identitiesRemoved;
+                return node->releaseRight();
+            }
+            break;
+        case OpCode::SUB:
+            if (isLiteral(right, 0.0)) {
+                ++stats_.identitiesRemoved;
+                return node->releaseLeft();
+            }
+            break;
+        case OpCode::MUL:
+            if (isLiteral(right, 1.0)) {
+                ++stats_.identitiesRemoved;
+                return node->releaseLeft();
+            }
+            if (isLiteral(left, 1.0)) {
+                ++stats_.identitiesRemoved;
+                return node->releaseRight();
+            }
+            break;
+        case OpCode::DIV: {
+            if (isLiteral(right, 1.0)) {
+                ++stats_.identitiesRemoved;
+                return node->releaseLeft();
+            }
+            const LiteralNode* divisor = asLiteral(right);
+            // Zero divisors are left alone so the division still reports the error
+            if (divisor != nullptr && std::abs(divisor->getValue()) >= 1e-10 &&
+                std::isfinite(1.0 / divisor->getValue())) {
+                ++stats_.strengthReduced;
+                Token mul(TokenType::OPERATOR, "*", op.position, OpCode::MUL);
+                return std::make_unique<BinaryOpNode>(node->releaseLeft(), mul,
+                    std::make_unique<LiteralNode>(1.0 / divisor->getValue()));
+            }
+            break;
+        }
+        case OpCode::POW:
+            if (isPowerOperator(*node) && isLiteral(right, 1.0)) {
+                ++stats_.identitiesRemoved;
+                return node->releaseLeft();
+            }
+            break;
+        default:
+            break;
+    }
+    return node;
+}
+
+std::unique_ptr<ASTNode> ASTOptimizer::expandPower(const ASTNode& base, long long exponent,
+                                                   const Token& op) {
+    // Repeated squaring: x^(2k) = x^k * x^k, x^(2k+1) = x^(2k) * x
+    Token mul(TokenType::OPERATOR, "*", op.position, OpCode::MUL);
+    if (exponent == 1) {
+        return base.clone();
+    }
+    if (exponent % 2 == 0) {
+        std::unique_ptr<ASTNode> half = expandPower(base, exponent / 2, op);
+        std::unique_ptr<ASTNode> copy = half->clone();
+        return std::make_unique<BinaryOpNode>(std::move(half), mul, std::move(copy));
+    }
+    return std::make_unique<BinaryOpNode>(expandPower(base, exponent - 1, op), mul, base.clone());
+}
+
+bool ASTOptimizer::isColumn(const std::string& name) const {
+    return columns_ != nullptr && std::find(columns_->begin(), columns_->end(), name) != columns_->end();
+}
+
+bool ASTOptimizer::isPowerOperator(const BinaryOpNode& node) const {
+    return node.getOpCode() == OpCode::POW &&
+           context_.getOperatorSemantics("^") == OperatorSemantics::POWER;
+}
+
+} // namespace calc
@@ -0,0 +1,166 @@
+/**
+ * @file expression_dag.cpp
+ * @brief Lowering of ASTs into hash-consed DAGs
+ */
+
+#include "calc/core/expression_dag.h"
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+namespace calc {
+
+namespace {
+
+/**
+ * @brief Structural identity of a pure node: its own fields and the
+ *        identities of its operands, which are already hash-consed
+ */
+struct NodeKey {
+    ExpressionDag::Kind kind;
+    OpCode op;
+    uint64_t valueBits;  ///< Literal value by bit pattern, so 0.0 and -0.0 stay apart
+    std::string name;
+    std::vector<uint32_t> operands;
+
+    bool operator==(const NodeKey& other) const {
+        return kind == other.kind && op == other.op && valueBits == other.valueBits &&
+               name == other.name && operands == other.operands;
+    }
+};
+
+struct NodeKeyHash {
+    size_t operator()(const NodeKey& key) const noexcept {
+        size_t hash = std::hash<std::string>()(key.name);
+        auto mix = [&hash](uint64_t value) {
+            hash ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        };
+        mix(static_cast<uint64_t>(key.kind));
+        mix(static_cast<uint64_t>(key.op));
+        mix(key.valueBits);
+        for (uint32_t operand : key.operands) {
+            mix(operand);
+        }
+        return hash;
+    }
+};
+
+} // anonymous namespace
+
+/**
+ * @brief Builds an ExpressionDag from a post-order walk of the tree
+ *
+ * Each visited node pops the DAG indices of its operands off ids_,
+ * looks itself up by structure and pushes the index of the existing
+ * node, or of a new one.
+ */
+class DagBuilder : public ASTVisitor {
+public:
+    explicit DagBuilder(const EvaluationContext& context) : context_(context) {}
+
+    ExpressionDag build(const ASTNode& root) {
+        PostOrderWalker walker;
+        walker.walk(const_cast<ASTNode&>(root), *this);
+
+        DagStats& stats = dag_.stats_;
+        stats.dagNodes = dag_.nodes_.size();
+        stats.nodesDeduplicated = stats.treeNodes - stats.dagNodes;
+        for (const ExpressionDag::Node& node : dag_.nodes_) {
+            if (node.parents > 1) {
+                ++stats.sharedNodes;
+            }
+        }
+        return std::move(dag_);
+    }
+
+    void visit(LiteralNode& node) override {
+        ExpressionDag::Node entry = makeNode(ExpressionDag::Kind::LITERAL, 0);
+        entry.value = node.getValue();
+        add(std::move(entry), 0, true);
+    }
+
+    void visit(VariableNode& node) override {
+        ExpressionDag::Node entry = makeNode(ExpressionDag::Kind::VARIABLE, node.getPosition());
+        entry.name = node.getName();
+
+        // Variables shadow functions; constants such as PI are zero-argument functions
+        bool pure = context_.findVariableSlot(entry.name) != EvaluationContext::NO_SLOT ||
+                    isPureFunction(entry.name);
+        add(std::move(entry), 0, pure);
+    }
+
+    void visit(BinaryOpNode& node) override {
+        ExpressionDag::Node entry = makeNode(ExpressionDag::Kind::BINARY, node.getPosition());
+        entry.op = node.getOpCode();
+        add(std::move(entry), 2, true);
+    }
+
+    void visit(UnaryOpNode& node) override {
+        ExpressionDag::Node entry = makeNode(ExpressionDag::Kind::UNARY, node.getPosition());
+        entry.op = node.getOpCode();
+        add(std::move(entry), 1, true);
+    }
+
+    void visit(FunctionCallNode& node) override {
+        ExpressionDag::Node entry = makeNode(ExpressionDag::Kind::CALL, node.getPosition());
+        entry.name = node.getName();
+        bool pure = isPureFunction(entry.name);
+        add(std::move(entry), node.getArgumentCount(), pure);
+    }
+
+private:
+    const EvaluationContext& context_;
+    ExpressionDag dag_;
+    std::vector<uint32_t> ids_;  ///< DAG indices of visited subtrees not yet consumed, innermost last
+    std::unordered_map<NodeKey, uint32_t, NodeKeyHash> index_;
+
+    static ExpressionDag::Node makeNode(ExpressionDag::Kind kind, size_t position) {
+        ExpressionDag::Node node;
+        node.kind = kind;
+        node.position = position;
+        return node;
+    }
+
+    // Unknown names fail wherever they occur, so merging them changes nothing
+    bool isPureFunction(const std::string& name) const {
+        const FunctionEntry* entry = context_.findFunction(name);
+        return entry == nullptr || entry->pure;
+    }
+
+    void add(ExpressionDag::Node node, size_t operandCount, bool pure) {
+        ++dag_.stats_.treeNodes;
+
+        const auto first = ids_.end() - static_cast<std::ptrdiff_t>(operandCount);
+        NodeKey key{node.kind, node.op, 0, node.name, std::vector<uint32_t>(first, ids_.end())};
+        ids_.erase(first, ids_.end());
+        std::memcpy(&key.valueBits, &node.value, sizeof(key.valueBits));
+
+        if (pure) {
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                ids_.push_back(it->second);
+                return;
+            }
+        }
+
+        const auto id = static_cast<uint32_t>(dag_.nodes_.size());
+        node.firstOperand = static_cast<uint32_t>(dag_.operands_.size());
+        node.operandCount = static_cast<uint32_t>(operandCount);
+        for (uint32_t operand : key.operands) {
+            dag_.operands_.push_back(operand);
+            ++dag_.nodes_[operand].parents;
+        }
+        dag_.nodes_.push_back(std::move(node));
+        if (pure) {
+            index_.emplace(std::move(key), id);
+        }
+        ids_.push_back(id);
+    }
+};
+
+ExpressionDag ExpressionDag::build(const ASTNode& root, const EvaluationContext& context) {
+    DagBuilder builder(context);
+    return builder.build(root);
+}
+
+} // namespace calc
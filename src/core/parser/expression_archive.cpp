@@ -0,0 +1,483 @@
+/**
+ * @file expression_archive.cpp
+ * @brief Writing, mapping and loading expression archives
+ */
+
+#include "calc/core/expression_archive.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace calc {
+
+// ============================================================================
+// Record Layout
+// ============================================================================
+
+namespace {
+
+struct Header {
+    char magic[4];
+    uint16_t version;
+    uint16_t byteOrder;  ///< BYTE_ORDER_MARK as written; swapped on a foreign host
+    uint32_t expressionCount;
+    uint32_t nodeCount;
+    uint32_t constantCount;
+    uint32_t stringCount;
+    uint32_t stringBytes;
+    uint32_t reserved;
+};
+
+} // anonymous namespace
+
+struct ArchiveExpressionRecord {
+    uint32_t firstNode;
+    uint32_t nodeCount;
+    uint32_t source;  ///< String index, or NO_STRING
+    uint32_t reserved;
+};
+
+struct ArchiveNodeRecord {
+    uint8_t kind;
+    uint8_t op;
+    uint16_t reserved;
+    uint32_t operand;
+    uint32_t argCount;
+    uint32_t position;
+};
+
+namespace {
+
+using ExpressionRecord = ArchiveExpressionRecord;
+using NodeRecord = ArchiveNodeRecord;
+
+static_assert(sizeof(Header) == 32, "archive header must be 32 bytes");
+static_assert(sizeof(ExpressionRecord) == 16, "expression record must be 16 bytes");
+static_assert(sizeof(NodeRecord) == 16, "node record must be 16 bytes");
+static_assert(std::is_trivially_copyable<NodeRecord>::value, "records are copied as bytes");
+
+constexpr char MAGIC[4] = {'C', 'X', 'P', 'R'};
+constexpr uint16_t BYTE_ORDER_MARK = 0x0102;
+constexpr uint32_t NO_STRING = std::numeric_limits<uint32_t>::max();
+
+/// Rough arena bytes per node, so a loaded tree fits in the first block
+constexpr size_t ARENA_BYTES_PER_NODE = 96;
+
+enum NodeKind : uint8_t {
+    KIND_LITERAL,
+    KIND_VARIABLE,
+    KIND_BINARY,
+    KIND_UNARY,
+    KIND_CALL
+};
+
+/**
+ * @brief Byte offsets of the sections that follow the header
+ */
+struct Layout {
+    uint64_t constants;
+    uint64_t expressions;
+    uint64_t nodes;
+    uint64_t stringOffsets;
+    uint64_t strings;
+    uint64_t end;
+
+    Layout(uint64_t expressionCount, uint64_t nodeCount, uint64_t constantCount,
+           uint64_t stringCount, uint64_t stringBytes) {
+        // Sections before the offset table are multiples of 8 bytes long,
+        // so each one starts aligned for its records
+        constants = sizeof(Header);
+        expressions = constants + constantCount * sizeof(double);
+        nodes = expressions + expressionCount * sizeof(ExpressionRecord);
+        stringOffsets = nodes + nodeCount * sizeof(NodeRecord);
+        strings = stringOffsets + (stringCount + 1) * sizeof(uint32_t);
+        end = strings + stringBytes;
+    }
+};
+
+[[noreturn]] void invalidArchive(const std::string& reason) {
+    throw CalculatorException(ErrorCode::PARSE_ERROR, "Invalid expression archive: " + reason);
+}
+
+uint32_t checkedIndex(size_t value, const char* what) {
+    if (value >= NO_STRING) {
+        throw CalculatorException(ErrorCode::PARSE_ERROR,
+                                  std::string("Expression archive too large: ") + what);
+    }
+    return static_cast<uint32_t>(value);
+}
+
+bool isBinaryOp(uint8_t op) {
+    return op >= static_cast<uint8_t>(OpCode::ADD) && op <= static_cast<uint8_t>(OpCode::SHR);
+}
+
+bool isUnaryOp(uint8_t op) {
+    return op >= static_cast<uint8_t>(OpCode::PLUS) && op <= static_cast<uint8_t>(OpCode::BIT_NOT);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// ExpressionArchiveWriter Implementation
+// ============================================================================
+
+/**
+ * @brief Appends the records of a tree in post-order
+ */
+class ArchiveNodeWriter : public ASTVisitor {
+public:
+    explicit ArchiveNodeWriter(ExpressionArchiveWriter& writer) : writer_(writer) {}
+
+    void visit(LiteralNode& node) override {
+        add(KIND_LITERAL, OpCode::NONE, writer_.internConstant(node.getValue()), 0, 0);
+    }
+
+    void visit(VariableNode& node) override {
+        add(KIND_VARIABLE, OpCode::NONE, writer_.internString(node.getName()), 0,
+            node.getPosition());
+    }
+
+    void visit(BinaryOpNode& node) override {
+        add(KIND_BINARY, node.getOpCode(), 0, 0, node.getPosition());
+    }
+
+    void visit(UnaryOpNode& node) override {
+        add(KIND_UNARY, node.getOpCode(), 0, 0, node.getPosition());
+    }
+
+    void visit(FunctionCallNode& node) override {
+        add(KIND_CALL, OpCode::NONE, writer_.internString(node.getName()),
+            checkedIndex(node.getArgumentCount(), "argument count"), node.getPosition());
+    }
+
+private:
+    ExpressionArchiveWriter& writer_;
+
+    void add(NodeKind kind, OpCode op, uint32_t operand, uint32_t argCount, size_t position) {
+        checkedIndex(writer_.nodes_.size(), "node count");
+        writer_.nodes_.push_back({static_cast<uint8_t>(kind), static_cast<uint8_t>(op), operand,
+                                  argCount, checkedIndex(position, "source position")});
+    }
+};
+
+size_t ExpressionArchiveWriter::add(const ASTNode& root, const std::string& source) {
+    const size_t firstNode = nodes_.size();
+    try {
+        ArchiveNodeWriter nodeWriter(*this);
+        PostOrderWalker walker;
+        walker.walk(const_cast<ASTNode&>(root), nodeWriter);
+    } catch (...) {
+        nodes_.resize(firstNode);
+        throw;
+    }
+
+    Expression expression;
+    expression.firstNode = static_cast<uint32_t>(firstNode);
+    expression.nodeCount = static_cast<uint32_t>(nodes_.size() - firstNode);
+    expression.source = source.empty() ? NO_STRING : internString(source);
+    expressions_.push_back(expression);
+    return expressions_.size() - 1;
+}
+
+uint32_t ExpressionArchiveWriter::internConstant(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    auto it = constantIndex_.find(bits);
+    if (it != constantIndex_.end()) {
+        return it->second;
+    }
+    uint32_t index = checkedIndex(constants_.size(), "constant count");
+    constants_.push_back(value);
+    constantIndex_.emplace(bits, index);
+    return index;
+}
+
+uint32_t ExpressionArchiveWriter::internString(const std::string& text) {
+    auto it = stringIndex_.find(text);
+    if (it != stringIndex_.end()) {
+        return it->second;
+    }
+    uint32_t index = checkedIndex(stringIndex_.size(), "string count");
+    checkedIndex(stringBytes_.size() + text.size(), "string bytes");
+    stringBytes_ += text;
+    stringOffsets_.push_back(static_cast<uint32_t>(stringBytes_.size()));
+    stringIndex_.emplace(text, index);
+    return index;
+}
+
+std::vector<unsigned char> ExpressionArchiveWriter::serialize() const {
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = ExpressionArchive::VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.expressionCount = static_cast<uint32_t>(expressions_.size());
+    header.nodeCount = static_cast<uint32_t>(nodes_.size());
+    header.constantCount = static_cast<uint32_t>(constants_.size());
+    header.stringCount = static_cast<uint32_t>(stringOffsets_.size() - 1);
+    header.stringBytes = static_cast<uint32_t>(stringBytes_.size());
+
+    const Layout layout(header.expressionCount, header.nodeCount, header.constantCount,
+                        header.stringCount, header.stringBytes);
+    std::vector<unsigned char> bytes(static_cast<size_t>(layout.end));
+    unsigned char* out = bytes.data();
+
+    std::memcpy(out, &header, sizeof(header));
+    if (!constants_.empty()) {
+        std::memcpy(out + layout.constants, constants_.data(), constants_.size() * sizeof(double));
+    }
+
+    for (size_t i = 0; i < expressions_.size(); ++i) {
+        const Expression& expression = expressions_[i];
+        ExpressionRecord record{expression.firstNode, expression.nodeCount, expression.source, 0};
+        std::memcpy(out + layout.expressions + i * sizeof(record), &record, sizeof(record));
+    }
+
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const Node& node = nodes_[i];
+        NodeRecord record{node.kind, node.op, 0, node.operand, node.argCount, node.position};
+        std::memcpy(out + layout.nodes + i * sizeof(record), &record, sizeof(record));
+    }
+
+    std::memcpy(out + layout.stringOffsets, stringOffsets_.data(),
+                stringOffsets_.size() * sizeof(uint32_t));
+    if (!stringBytes_.empty()) {
+        std::memcpy(out + layout.strings, stringBytes_.data(), stringBytes_.size());
+    }
+    return bytes;
+}
+
+void ExpressionArchiveWriter::save(const std::string& path) const {
+    std::vector<unsigned char> bytes = serialize();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (file) {
+        file.write(reinterpret_cast<const char*>(bytes.data()),
+                   static_cast<std::streamsize>(bytes.size()));
+    }
+    if (!file) {
+        throw CalculatorException(ErrorCode::PARSE_ERROR, "Cannot write expression archive: " + path);
+    }
+}
+
+// ============================================================================
+// ExpressionArchive Implementation
+// ============================================================================
+
+ExpressionArchive ExpressionArchive::open(const std::string& path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw CalculatorException(ErrorCode::PARSE_ERROR, "Cannot open expression archive: " + path);
+    }
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)),
+                                     std::istreambuf_iterator<char>());
+    return fromBuffer(std::move(bytes));
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw CalculatorException(ErrorCode::PARSE_ERROR, "Cannot open expression archive: " + path);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw CalculatorException(ErrorCode::PARSE_ERROR, "Cannot open expression archive: " + path);
+    }
+    const auto size = static_cast<size_t>(info.st_size);
+    if (size < sizeof(Header)) {
+        ::close(fd);
+        invalidArchive("truncated header");
+    }
+
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file open
+    if (mapping == MAP_FAILED) {
+        throw CalculatorException(ErrorCode::PARSE_ERROR, "Cannot map expression archive: " + path);
+    }
+
+    std::shared_ptr<const void> storage(mapping, [size](const void* data) {
+        ::munmap(const_cast<void*>(data), size);
+    });
+    return attach(std::move(storage), static_cast<const unsigned char*>(mapping), size);
+#endif
+}
+
+ExpressionArchive ExpressionArchive::fromBuffer(std::vector<unsigned char> bytes) {
+    auto owned = std::make_shared<const std::vector<unsigned char>>(std::move(bytes));
+    const unsigned char* data = owned->data();
+    const size_t size = owned->size();
+    return attach(std::move(owned), data, size);
+}
+
+ExpressionArchive ExpressionArchive::attach(std::shared_ptr<const void> storage,
+                                            const unsigned char* data, size_t size) {
+    if (size < sizeof(Header)) {
+        invalidArchive("truncated header");
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(double) != 0) {
+        invalidArchive("misaligned data");
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        invalidArchive("bad magic number");
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        invalidArchive("written on a host of the other byte order");
+    }
+    if (header.version != VERSION) {
+        invalidArchive("unsupported version " + std::to_string(header.version));
+    }
+
+    const Layout layout(header.expressionCount, header.nodeCount, header.constantCount,
+                        header.stringCount, header.stringBytes);
+    if (layout.end != size) {
+        invalidArchive(layout.end > size ? "truncated data" : "trailing data");
+    }
+
+    ExpressionArchive archive;
+    archive.storage_ = std::move(storage);
+    archive.constants_ = reinterpret_cast<const double*>(data + layout.constants);
+    archive.expressions_ = reinterpret_cast<const ExpressionRecord*>(data + layout.expressions);
+    archive.nodes_ = reinterpret_cast<const NodeRecord*>(data + layout.nodes);
+    archive.stringOffsets_ = reinterpret_cast<const uint32_t*>(data + layout.stringOffsets);
+    archive.strings_ = reinterpret_cast<const char*>(data + layout.strings);
+    archive.expressionCount_ = header.expressionCount;
+    archive.constantCount_ = header.constantCount;
+    archive.stringCount_ = header.stringCount;
+
+    if (archive.stringOffsets_[0] != 0 ||
+        archive.stringOffsets_[header.stringCount] != header.stringBytes) {
+        invalidArchive("bad string table");
+    }
+    for (size_t i = 0; i < header.stringCount; ++i) {
+        if (archive.stringOffsets_[i] > archive.stringOffsets_[i + 1]) {
+            invalidArchive("bad string table");
+        }
+    }
+
+    for (size_t i = 0; i < header.expressionCount; ++i) {
+        const ExpressionRecord& record = archive.expressions_[i];
+        if (record.nodeCount == 0 ||
+            static_cast<uint64_t>(record.firstNode) + record.nodeCount > header.nodeCount) {
+            invalidArchive("expression " + std::to_string(i) + " has a bad node range");
+        }
+        if (record.source != NO_STRING && record.source >= header.stringCount) {
+            invalidArchive("expression " + std::to_string(i) + " has a bad source string");
+        }
+    }
+    return archive;
+}
+
+size_t ExpressionArchive::getNodeCount(size_t index) const noexcept {
+    return expressions_[index].nodeCount;
+}
+
+std::string_view ExpressionArchive::getSource(size_t index) const noexcept {
+    uint32_t source = expressions_[index].source;
+    return source == NO_STRING ? std::string_view() : getString(source);
+}
+
+std::string_view ExpressionArchive::getString(uint32_t index) const noexcept {
+    uint32_t begin = stringOffsets_[index];
+    return std::string_view(strings_ + begin, stringOffsets_[index + 1] - begin);
+}
+
+ParsedExpression ExpressionArchive::load(size_t index) const {
+    const ExpressionRecord& expression = expressions_[index];
+    const NodeRecord* node = nodes_ + expression.firstNode;
+    const NodeRecord* end = node + expression.nodeCount;
+
+    // Declaration order matters: partial trees on the stack go before the arena
+    auto arena = std::make_unique<ASTArena>(expression.nodeCount * ARENA_BYTES_PER_NODE);
+    std::vector<std::unique_ptr<ASTNode>> stack;
+    stack.reserve(expression.nodeCount);  // Never reallocates while holding a raw node
+
+    auto fail = [index](const char* reason) {
+        invalidArchive("expression " + std::to_string(index) + " has " + reason);
+    };
+    auto pop = [&stack]() {
+        std::unique_ptr<ASTNode> top = std::move(stack.back());
+        stack.pop_back();
+        return top;
+    };
+    auto name = [&](uint32_t operand) {
+        if (operand >= stringCount_) {
+            fail("a bad name");
+        }
+        return std::string(getString(operand));
+    };
+
+    for (; node != end; ++node) {
+        const size_t position = node->position;
+        const auto op = static_cast<OpCode>(node->op);
+
+        switch (node->kind) {
+        case KIND_LITERAL:
+            if (node->operand >= constantCount_) {
+                fail("a bad constant");
+            }
+            stack.emplace_back(new (*arena) LiteralNode(constants_[node->operand]));
+            break;
+
+        case KIND_VARIABLE:
+            stack.emplace_back(new (*arena) VariableNode(name(node->operand), position));
+            break;
+
+        case KIND_BINARY: {
+            if (!isBinaryOp(node->op) || stack.size() < 2) {
+                fail("a bad binary operator");
+            }
+            std::unique_ptr<ASTNode> right = pop();
+            std::unique_ptr<ASTNode> left = pop();
+            stack.emplace_back(new (*arena)
+                                   BinaryOpNode(std::move(left), op, position, std::move(right)));
+            break;
+        }
+
+        case KIND_UNARY: {
+            if (!isUnaryOp(node->op) || stack.empty()) {
+                fail("a bad unary operator");
+            }
+            std::unique_ptr<ASTNode> operand = pop();
+            stack.emplace_back(new (*arena) UnaryOpNode(op, position, std::move(operand)));
+            break;
+        }
+
+        case KIND_CALL: {
+            if (node->argCount > stack.size()) {
+                fail("a bad argument count");
+            }
+            ASTNodeList args{ArenaAllocator<std::unique_ptr<ASTNode>>(arena.get())};
+            args.reserve(node->argCount);
+            auto first = stack.end() - static_cast<std::ptrdiff_t>(node->argCount);
+            std::move(first, stack.end(), std::back_inserter(args));
+            stack.erase(first, stack.end());
+            stack.emplace_back(new (*arena)
+                                   FunctionCallNode(name(node->operand), position, std::move(args)));
+            break;
+        }
+
+        default:
+            fail("a bad node kind");
+        }
+    }
+
+    if (stack.size() != 1) {
+        fail("unbalanced operands");
+    }
+    std::unique_ptr<ASTNode> root = pop();
+    return ParsedExpression(std::move(arena), std::move(root));
+}
+
+} // namespace calc
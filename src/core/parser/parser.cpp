@@ -0,0 +1,112 @@
+/**
+ * @file parser.cpp
+ * @brief Parser base class implementation
+ */
+
+#include "calc/core/parser.h"
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+namespace calc {
+
+namespace {
+
+/// Rough arena bytes per token, so typical trees fit in the first block
+constexpr size_t ARENA_BYTES_PER_TOKEN = 64;
+
+/// Every whole number of smaller magnitude is exact as a double
+constexpr double EXACT_INTEGER_LIMIT = 9007199254740992.0;  // 2^53
+
+/// How much of a literal's exact value fits in a LiteralNode's integer
+enum class IntegerWidth {
+    NONE,  ///< Not a whole number written as digits
+    FITS,  ///< Exact in 64 bits
+    WIDE   ///< Needs more than 64 bits; the low 64 are kept
+};
+
+/**
+ * @brief Read a literal's digits as an unsigned integer
+ *
+ * The value wraps to 64 bits, as prefixed literals do in the tokenizer;
+ * the result tells whether anything was lost.
+ */
+IntegerWidth readInteger(const Token& token, uint64_t& value) {
+    unsigned radix = 10;
+    if (token.numberBase == NumberBase::BINARY) {
+        radix = 2;
+    } else if (token.numberBase == NumberBase::OCTAL) {
+        radix = 8;
+    } else if (token.numberBase == NumberBase::HEXADECIMAL) {
+        radix = 16;
+    }
+
+    const uint64_t limit = UINT64_MAX / radix;
+    bool wide = false;
+    value = 0;
+    for (char c : token.value) {
+        unsigned digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<unsigned>(c - '0');
+        } else if (radix == 16) {
+            // The tokenizer has already checked the digits against the base
+            digit = static_cast<unsigned>((c | 0x20) - 'a' + 10);
+        } else {
+            return IntegerWidth::NONE;  // Fraction or exponent
+        }
+        wide = wide || value > limit || value * radix > UINT64_MAX - digit;
+        value = value * radix + digit;
+    }
+    return wide ? IntegerWidth::WIDE : IntegerWidth::FITS;
+}
+
+} // anonymous namespace
+
+ParsedExpression Parser::parseToArena(const std::vector<Token>& tokens) {
+    auto arena = std::make_unique<ASTArena>(
+        std::max(ASTArena::DEFAULT_BLOCK_SIZE, tokens.size() * ARENA_BYTES_PER_TOKEN));
+
+    std::unique_ptr<ASTNode> root;
+    arena_ = arena.get();
+    try {
+        root = parse(tokens);
+    } catch (...) {
+        // Partial trees were destroyed while unwinding out of parse()
+        arena_ = nullptr;
+        throw;
+    }
+    arena_ = nullptr;
+
+    return ParsedExpression(std::move(arena), std::move(root));
+}
+
+std::unique_ptr<ASTNode> Parser::makeLiteral(const Token& token) const {
+    // Converted once by the tokenizer, whatever the base
+    const double value = token.number;
+    if (std::isnan(value)) {
+        throw SyntaxError("Invalid number: " + token.value, token.position);
+    }
+
+    // Prefixed literals may have wrapped to a small value, so only decimals skip the digits
+    if (token.numberBase == NumberBase::DECIMAL && std::trunc(value) == value &&
+        std::fabs(value) < EXACT_INTEGER_LIMIT) {
+        auto integer = static_cast<uint64_t>(static_cast<int64_t>(value));
+        return makeNode<LiteralNode>(value, integer);
+    }
+
+    uint64_t integer = 0;
+    switch (readInteger(token, integer)) {
+        case IntegerWidth::FITS:
+            return makeNode<LiteralNode>(value, integer);
+        case IntegerWidth::WIDE:
+            return makeNode<LiteralNode>(value, integer, token.value, token.numberBase);
+        case IntegerWidth::NONE:
+        default:
+            if (keepLiteralDigits_) {
+                return makeNode<LiteralNode>(value, token.value);
+            }
+            return makeNode<LiteralNode>(value);
+    }
+}
+
+} // namespace calc
@@ -0,0 +1,352 @@
+/**
+ * @file pratt_parser.cpp
+ * @brief Precedence climbing (Pratt) parser implementation
+ */
+
+#include "calc/core/pratt_parser.h"
+
+namespace calc {
+
+namespace {
+
+// Binary precedence indexed by OpCode (higher = binds tighter, 0 = not a
+// binary operator). Matches ShuntingYardParser so both build the same trees.
+constexpr int BINARY_PRECEDENCE[static_cast<size_t>(OpCode::COUNT_)] = {
+    0,  // NONE
+    1,  // ADD
+    1,  // SUB
+    2,  // MUL
+    2,  // DIV
+    2,  // MOD
+    3,  // POW (right-associative)
+    2,  // BIT_AND
+    1,  // BIT_OR
+    3,  // SHL
+    3,  // SHR
+    0,  // PLUS
+    0,  // NEG
+    0,  // BIT_NOT
+};
+
+// Unary operators share the precedence of exponentiation: -2^3 = -(2^3)
+constexpr int UNARY_PRECEDENCE = 3;
+
+} // anonymous namespace
+
+// ============================================================================
+// Construction / Entry Point
+// ============================================================================
+
+PrattParser::PrattParser(bool enableUnaryOperators)
+    : tokens_(nullptr), current_(0), depth_(0), nesting_(0), enableUnaryOperators_(enableUnaryOperators) {}
+
+std::unique_ptr<ASTNode> PrattParser::parse(const std::vector<Token>& tokens) {
+    tokens_ = &tokens;
+    current_ = 0;
+    depth_ = 0;
+    nesting_ = 0;
+
+    if (peek().type == TokenType::EOF_TOKEN) {
+        throw SyntaxError("Empty expression", 0);
+    }
+
+    auto result = parseExpression(0, nullptr);
+
+    if (peek().type != TokenType::EOF_TOKEN) {
+        unexpectedAfterOperand();
+    }
+
+    return result;
+}
+
+const Token& PrattParser::peek() const noexcept {
+    if (current_ >= tokens_->size()) {
+        static const Token eofToken(TokenType::EOF_TOKEN, "", 0);
+        return eofToken;
+    }
+    return (*tokens_)[current_];
+}
+
+// ============================================================================
+// Grammar
+// ============================================================================
+
+std::unique_ptr<ASTNode> PrattParser::parseExpression(int minPrecedence, const Token* caller) {
+    NestingGuard guard(nesting_, peek().position);
+    auto left = parseOperand(caller);
+
+    for (;;) {
+        const Token& op = peek();
+        if (op.type != TokenType::OPERATOR) {
+            return left;
+        }
+
+        int precedence = BINARY_PRECEDENCE[static_cast<size_t>(op.opcode)];
+        if (precedence == 0) {
+            throw CalculatorException(ErrorCode::PARSE_ERROR, "Unknown operator: " + op.value, op.position);
+        }
+
+        // Stop at operators that bind no tighter than the caller, except that
+        // '^' groups to the right: 2^3^2 = 2^(3^2)
+        bool binds = precedence > minPrecedence ||
+                     (op.opcode == OpCode::POW && precedence == minPrecedence);
+        if (!binds) {
+            return left;
+        }
+
+        ++current_;
+        auto right = parseExpression(precedence, &op);
+        left = makeNode<BinaryOpNode>(std::move(left), op.opcode, op.position, std::move(right));
+    }
+}
+
+std::unique_ptr<ASTNode> PrattParser::parseOperand(const Token* caller) {
+    const Token& token = peek();
+
+    switch (token.type) {
+        case TokenType::NUMBER:
+            ++current_;
+            return makeLiteral(token);
+
+        case TokenType::VARIABLE:
+            ++current_;
+            return makeNode<VariableNode>(token.value, token.position);
+
+        case TokenType::FUNCTION:
+            return parseCall(caller);
+
+        case TokenType::LPAREN: {
+            size_t end = emptyGroupEnd();
+            if (end != current_) {
+                checkEmptyGroup(caller, end);
+            }
+            ++current_;
+            ++depth_;
+            // An empty group leaves the caller without an operand: 1 + ()
+            auto inner = parseExpression(0, caller);
+            if (peek().type != TokenType::RPAREN) {
+                unexpectedAfterOperand();
+            }
+            ++current_;
+            --depth_;
+            return inner;
+        }
+
+        case TokenType::OPERATOR: {
+            if (current_ > 0 && (*tokens_)[current_ - 1].type == TokenType::OPERATOR) {
+                checkConsecutiveOperators(current_);
+            }
+
+            // An operator that cannot be unary leaves the caller without an
+            // operand (1 + * 2), or has none of its own (* 2)
+            OpCode unary = enableUnaryOperators_ ? toUnaryOpCode(token.opcode) : OpCode::NONE;
+            if (unary == OpCode::NONE) {
+                const Token& op = caller != nullptr ? *caller : token;
+                throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN,
+                    "Not enough operands for operator: " + op.value, op.position);
+            }
+            ++current_;
+
+            TokenType next = peek().type;
+            if (next == TokenType::EOF_TOKEN || next == TokenType::RPAREN || next == TokenType::COMMA) {
+                // Unbalanced parentheses and stray commas take priority, as in
+                // ShuntingYardParser's validation pass
+                if ((next == TokenType::EOF_TOKEN) == (depth_ > 0)) {
+                    missingOperand(nullptr);
+                }
+                throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN,
+                    "Missing operand for unary operator", token.position);
+            }
+
+            // -() leaves the unary operator, or the caller it takes one from, short
+            if (next == TokenType::LPAREN && emptyGroupEnd() != current_) {
+                if (caller != nullptr) {
+                    missingOperand(caller);
+                }
+                throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN,
+                    "Missing operand for unary operator", token.position);
+            }
+
+            auto operand = parseExpression(UNARY_PRECEDENCE, nullptr);
+            return makeNode<UnaryOpNode>(unary, token.position, std::move(operand));
+        }
+
+        default:
+            missingOperand(caller);
+    }
+}
+
+std::unique_ptr<ASTNode> PrattParser::parseCall(const Token* caller) {
+    const Token& name = peek();
+    ++current_;
+
+    ASTNodeList args = makeNodeList();
+
+    // A function name without parentheses is a zero-argument call (PI, E)
+    if (peek().type != TokenType::LPAREN) {
+        return makeNode<FunctionCallNode>(name.value, name.position, std::move(args));
+    }
+    ++current_;
+    ++depth_;
+
+    // Empty arguments (max(1,,2), max((), 1)) are reported once the call is
+    // closed, as ShuntingYardParser reports them when it builds the call
+    bool emptyArgument = false;
+    if (peek().type != TokenType::RPAREN) {
+        for (;;) {
+            size_t end = emptyGroupEnd();
+            TokenType next = end < tokens_->size() ? (*tokens_)[end].type : TokenType::EOF_TOKEN;
+            if (next == TokenType::COMMA || next == TokenType::RPAREN) {
+                emptyArgument = true;
+                current_ = end;
+            } else {
+                args.push_back(parseExpression(0, nullptr));
+            }
+            if (peek().type == TokenType::COMMA) {
+                ++current_;
+            } else if (peek().type == TokenType::RPAREN) {
+                break;
+            } else {
+                unexpectedAfterOperand();
+            }
+        }
+    }
+    ++current_;
+    --depth_;
+
+    if (emptyArgument) {
+        if (caller != nullptr) {
+            throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN,
+                "Not enough operands for operator: " + caller->value, caller->position);
+        }
+        if (args.empty()) {
+            throw SyntaxError("Missing arguments for function: " + name.value, name.position);
+        }
+        throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN,
+            "Not enough arguments for function: " + name.value, name.position);
+    }
+
+    return makeNode<FunctionCallNode>(name.value, name.position, std::move(args));
+}
+
+size_t PrattParser::emptyGroupEnd() const noexcept {
+    size_t open = 0;
+    for (size_t i = current_; i < tokens_->size(); ++i) {
+        TokenType type = (*tokens_)[i].type;
+        if (type == TokenType::LPAREN) {
+            ++open;
+        } else if (type == TokenType::RPAREN && open > 0) {
+            if (--open == 0) {
+                return i + 1;
+            }
+        } else {
+            break;
+        }
+    }
+    return current_;
+}
+
+// ============================================================================
+// Error Reporting
+// ============================================================================
+
+void PrattParser::missingOperand(const Token* caller) const {
+    const Token& token = peek();
+
+    if (token.type == TokenType::EOF_TOKEN && depth_ > 0) {
+        throw SyntaxError("Unbalanced parentheses: missing closing ')'",
+                          tokens_->empty() ? 0 : tokens_->back().position);
+    }
+    if (token.type == TokenType::RPAREN && depth_ == 0) {
+        throw SyntaxError("Unbalanced parentheses: too many closing ')'", token.position);
+    }
+    if (token.type == TokenType::COMMA && depth_ == 0) {
+        throw SyntaxError("Misplaced comma in function arguments", token.position);
+    }
+    if (token.type == TokenType::UNKNOWN) {
+        throw SyntaxError("Unknown token in input", token.position);
+    }
+    if (caller != nullptr) {
+        throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN,
+            "Not enough operands for operator: " + caller->value, caller->position);
+    }
+
+    throw SyntaxError("Expected number, '(', variable, or function, found: " + token.value,
+                      token.position);
+}
+
+void PrattParser::checkEmptyGroup(const Token* caller, size_t end) const {
+    if (caller != nullptr) {
+        throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN,
+            "Not enough operands for operator: " + caller->value, caller->position);
+    }
+
+    const Token* next = end < tokens_->size() ? &(*tokens_)[end] : nullptr;
+    const bool atEnd = next == nullptr || next->type == TokenType::EOF_TOKEN;
+    if (atEnd && depth_ > 0) {
+        throw SyntaxError("Unbalanced parentheses: missing closing ')'", tokens_->back().position);
+    }
+    if (next != nullptr && next->type == TokenType::RPAREN && depth_ == 0) {
+        throw SyntaxError("Unbalanced parentheses: too many closing ')'", next->position);
+    }
+    if (next != nullptr && next->type == TokenType::OPERATOR) {
+        throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN,
+            "Not enough operands for operator: " + next->value, next->position);
+    }
+    if (current_ == 0 && atEnd) {
+        throw SyntaxError("Empty expression", 0);
+    }
+}
+
+void PrattParser::unexpectedAfterOperand() const {
+    const Token& token = peek();
+
+    switch (token.type) {
+        case TokenType::EOF_TOKEN:
+            throw SyntaxError("Unbalanced parentheses: missing closing ')'",
+                              tokens_->empty() ? 0 : tokens_->back().position);
+
+        case TokenType::RPAREN:
+            throw SyntaxError("Unbalanced parentheses: too many closing ')'", token.position);
+
+        case TokenType::COMMA:
+            if (depth_ == 0) {
+                throw SyntaxError("Misplaced comma in function arguments", token.position);
+            }
+            break;
+
+        case TokenType::UNKNOWN:
+            throw SyntaxError("Unknown token in input", token.position);
+
+        default:
+            break;
+    }
+
+    // An operand directly after an operand, or a comma inside plain parentheses
+    throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN, "Too many operands in expression", 0);
+}
+
+void PrattParser::checkConsecutiveOperators(size_t index) const {
+    // Operators at the very start are both unary: +-5, --5
+    if (index == 1) {
+        return;
+    }
+
+    const Token& current = (*tokens_)[index];
+    const Token& prev = (*tokens_)[index - 1];
+
+    // Only + and - can follow another operator: 5*-3 is fine, 1**2 is not
+    bool currentCanBeUnary = (current.opcode == OpCode::ADD || current.opcode == OpCode::SUB);
+    bool prevCanBeUnary = (prev.opcode == OpCode::ADD || prev.opcode == OpCode::SUB);
+    if (!currentCanBeUnary && !prevCanBeUnary) {
+        throw SyntaxError("Consecutive operators are not allowed", current.position);
+    }
+
+    // 1++2 reads like an increment, so it is rejected; +5 + +3 is not
+    if (current.opcode == OpCode::ADD && (*tokens_)[index - 2].type == TokenType::NUMBER &&
+        (index == 2 || (*tokens_)[index - 3].type == TokenType::NUMBER)) {
+        throw SyntaxError("Consecutive operators are not allowed: ambiguous unary '+'", current.position);
+    }
+}
+
+} // namespace calc
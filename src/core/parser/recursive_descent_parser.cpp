@@ -13,11 +13,12 @@ namespace calc {
 // ============================================================================
 
 RecursiveDescentParser::RecursiveDescentParser(bool enableUnaryOperators)
-    : current_(0), enableUnaryOperators_(enableUnaryOperators) {}
+    : current_(0), nesting_(0), enableUnaryOperators_(enableUnaryOperators) {}
 
 std::unique_ptr<ASTNode> RecursiveDescentParser::parse(const std::vector<Token>& tokens) {
     tokens_ = tokens;
     current_ = 0;
+    nesting_ = 0;
 
     if (isAtEnd()) {
         throw SyntaxError("Empty expression", 0);
@@ -97,14 +98,15 @@ const Token& RecursiveDescentParser::expect(TokenType type, const std::string& e
 
 // expression ::= term (( '+' | '-' ) term)*
 std::unique_ptr<ASTNode> RecursiveDescentParser::parseExpression() {
+    NestingGuard guard(nesting_, peek().position);
     auto left = parseTerm();
 
     while (match(TokenType::OPERATOR) &&
-           (peek().value == "+" || peek().value == "-")) {
+           (peek().opcode == OpCode::ADD || peek().opcode == OpCode::SUB)) {
         Token op = peek();
         advance();
         auto right = parseTerm();
-        left = std::make_unique<BinaryOpNode>(std::move(left), op, std::move(right));
+        left = makeNode<BinaryOpNode>(std::move(left), op, std::move(right));
     }
 
     return left;
@@ -115,11 +117,11 @@ std::unique_ptr<ASTNode> RecursiveDescentParser::parseTerm() {
     auto left = parseFactor();
 
     while (match(TokenType::OPERATOR) &&
-           (peek().value == "*" || peek().value == "/" || peek().value == "%")) {
+           (peek().opcode == OpCode::MUL || peek().opcode == OpCode::DIV || peek().opcode == OpCode::MOD)) {
         Token op = peek();
         advance();
         auto right = parseFactor();
-        left = std::make_unique<BinaryOpNode>(std::move(left), op, std::move(right));
+        left = makeNode<BinaryOpNode>(std::move(left), op, std::move(right));
     }
 
     return left;
@@ -140,14 +142,15 @@ std::unique_ptr<ASTNode> RecursiveDescentParser::parseUnary() {
     }
 
     // Check for unary + or -
-    if (match(TokenType::OPERATOR) && (peek().value == "+" || peek().value == "-")) {
+    if (match(TokenType::OPERATOR) && (peek().opcode == OpCode::ADD || peek().opcode == OpCode::SUB)) {
         Token op = peek();
         advance();
 
         // Parse the operand (which will handle power, postfix, etc.)
         // This ensures unary operators bind tighter than exponentiation
+        NestingGuard guard(nesting_, op.position);
         auto operand = parseUnary();  // Recurse for nested unary like --5
-        return std::make_unique<UnaryOpNode>(op, std::move(operand));
+        return makeNode<UnaryOpNode>(op, std::move(operand));
     }
 
     return parsePower();
@@ -158,7 +161,7 @@ std::unique_ptr<ASTNode> RecursiveDescentParser::parseUnary() {
 std::unique_ptr<ASTNode> RecursiveDescentParser::parsePower() {
     auto left = parsePostfix();
 
-    if (match(TokenType::OPERATOR) && peek().value == "^") {
+    if (match(TokenType::OPERATOR) && peek().opcode == OpCode::POW) {
         Token op = peek();
         advance();
         // For the right side of '^', we need to allow unary operators
@@ -167,7 +170,7 @@ std::unique_ptr<ASTNode> RecursiveDescentParser::parsePower() {
         // Solution: Parse the right side starting from the lowest precedence that
         // allows unary operators, which is parseUnary()
         auto right = parsePowerRightSide();
-        return std::make_unique<BinaryOpNode>(std::move(left), op, std::move(right));
+        return makeNode<BinaryOpNode>(std::move(left), op, std::move(right));
     }
 
     return left;
@@ -177,24 +180,26 @@ std::unique_ptr<ASTNode> RecursiveDescentParser::parsePower() {
 // This allows unary operators and maintains right-associativity
 // For 2^3^4, this returns PowerNode(3, 4), and for 2^-2, this returns UnaryOpNode(-, 2)
 std::unique_ptr<ASTNode> RecursiveDescentParser::parsePowerRightSide() {
+    NestingGuard guard(nesting_, peek().position);
+
     // Check for unary + or - (same as in parseUnary)
     if (enableUnaryOperators_ &&
-        match(TokenType::OPERATOR) && (peek().value == "+" || peek().value == "-")) {
+        match(TokenType::OPERATOR) && (peek().opcode == OpCode::ADD || peek().opcode == OpCode::SUB)) {
         Token op = peek();
         advance();
         auto operand = parseUnary();
-        return std::make_unique<UnaryOpNode>(op, std::move(operand));
+        return makeNode<UnaryOpNode>(op, std::move(operand));
     }
 
     // Parse postfix (which handles numbers, parentheses, functions)
     auto node = parsePostfix();
 
     // Check for another '^' to maintain right-associativity
-    if (match(TokenType::OPERATOR) && peek().value == "^") {
+    if (match(TokenType::OPERATOR) && peek().opcode == OpCode::POW) {
         Token op = peek();
         advance();
         auto right = parsePowerRightSide();
-        return std::make_unique<BinaryOpNode>(std::move(node), op, std::move(right));
+        return makeNode<BinaryOpNode>(std::move(node), op, std::move(right));
     }
 
     return node;
@@ -217,7 +222,7 @@ std::unique_ptr<ASTNode> RecursiveDescentParser::parsePostfix() {
             expect(TokenType::RPAREN, "Expected ')' after function arguments");
 
             // Create new function call node with parsed arguments
-            node = std::make_unique<FunctionCallNode>(
+            node = makeNode<FunctionCallNode>(
                 funcNode->getName(),
                 funcNode->getPosition(),
                 std::move(args)
@@ -242,18 +247,13 @@ std::unique_ptr<ASTNode> RecursiveDescentParser::parsePostfix() {
     return node;
 }
 
-// primary ::= NUMBER | '(' expression ')' | FUNCTION
+// primary ::= NUMBER | '(' expression ')' | VARIABLE | FUNCTION
 std::unique_ptr<ASTNode> RecursiveDescentParser::parsePrimary() {
     // Number literal
     if (match(TokenType::NUMBER)) {
         const Token& token = peek();
         advance();
-        try {
-            double value = std::stod(token.value);
-            return std::make_unique<LiteralNode>(value);
-        } catch (const std::exception&) {
-            throw SyntaxError("Invalid number: " + token.value, token.position);
-        }
+        return makeLiteral(token);
     }
 
     // Parenthesized expression
@@ -264,27 +264,34 @@ std::unique_ptr<ASTNode> RecursiveDescentParser::parsePrimary() {
         return expr;
     }
 
+    // Variable reference
+    if (match(TokenType::VARIABLE)) {
+        const Token& token = peek();
+        advance();
+        return makeNode<VariableNode>(token.value, token.position);
+    }
+
     // Function name (will be followed by '(' in parsePostfix)
     if (match(TokenType::FUNCTION)) {
         const Token& token = peek();
         advance();
         // Create a placeholder function call node with no arguments
         // parsePostfix will fill in the arguments
-        return std::make_unique<FunctionCallNode>(
+        return makeNode<FunctionCallNode>(
             token.value, token.position,
-            std::vector<std::unique_ptr<ASTNode>>{}
+            makeNodeList()
         );
     }
 
     // Unexpected token
     std::ostringstream oss;
-    oss << "Expected number, '(', or function, found: " << peek().value;
+    oss << "Expected number, '(', variable, or function, found: " << peek().value;
     throw SyntaxError(oss.str(), peek().position);
 }
 
 // arguments ::= expression (',' expression)*
-std::vector<std::unique_ptr<ASTNode>> RecursiveDescentParser::parseArguments() {
-    std::vector<std::unique_ptr<ASTNode>> args;
+ASTNodeList RecursiveDescentParser::parseArguments() {
+    ASTNodeList args = makeNodeList();
 
     // Check if we have any arguments (empty argument list is valid)
     if (match(TokenType::RPAREN)) {
@@ -310,9 +317,17 @@ bool RecursiveDescentParser::isBinaryOperator(const Token& token) noexcept {
     if (token.type != TokenType::OPERATOR) {
         return false;
     }
-    return token.value == "+" || token.value == "-" ||
-           token.value == "*" || token.value == "/" ||
-           token.value == "%" || token.value == "^";
+    switch (token.opcode) {
+        case OpCode::ADD:
+        case OpCode::SUB:
+        case OpCode::MUL:
+        case OpCode::DIV:
+        case OpCode::MOD:
+        case OpCode::POW:
+            return true;
+        default:
+            return false;
+    }
 }
 
 int RecursiveDescentParser::getPrecedence(const Token& op) {
@@ -320,20 +335,24 @@ int RecursiveDescentParser::getPrecedence(const Token& op) {
         return 0;
     }
 
-    if (op.value == "^") {
-        return 4;  // Exponentiation (highest)
-    } else if (op.value == "*" || op.value == "/" || op.value == "%") {
-        return 3;  // Multiplication, division, modulo
-    } else if (op.value == "+" || op.value == "-") {
-        return 2;  // Addition, subtraction
+    switch (op.opcode) {
+        case OpCode::POW:
+            return 4;  // Exponentiation (highest)
+        case OpCode::MUL:
+        case OpCode::DIV:
+        case OpCode::MOD:
+            return 3;  // Multiplication, division, modulo
+        case OpCode::ADD:
+        case OpCode::SUB:
+            return 2;  // Addition, subtraction
+        default:
+            return 0;
     }
-
-    return 0;
 }
 
 bool RecursiveDescentParser::isRightAssociative(const Token& op) noexcept {
     // Only exponentiation is right-associative
-    return op.type == TokenType::OPERATOR && op.value == "^";
+    return op.type == TokenType::OPERATOR && op.opcode == OpCode::POW;
 }
 
 } // namespace calc
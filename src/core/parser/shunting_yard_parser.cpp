@@ -4,7 +4,6 @@
  */
 
 #include "calc/core/shunting_yard_parser.h"
-#include "calc/math/converter.h"
 
 namespace calc {
 
@@ -36,7 +35,7 @@ bool ShuntingYardParser::isUnaryOperator(const std::vector<Token>& tokens, size_
     }
 
     // +, -, ~ can be unary
-    if (token.value != "+" && token.value != "-" && token.value != "~") {
+    if (toUnaryOpCode(token.opcode) == OpCode::NONE) {
         return false;
     }
 
@@ -60,34 +59,40 @@ bool ShuntingYardParser::isUnaryOperator(const std::vector<Token>& tokens, size_
            prev.type == TokenType::COMMA;
 }
 
+namespace {
+
+// Precedence indexed by OpCode (higher = binds tighter, 0 = unknown operator).
+// Unary operators share the precedence of exponentiation, which lets '^'
+// bind tighter than a leading minus: -2^3 = -(2^3), not (-2)^3.
+constexpr int SHUNTING_YARD_PRECEDENCE[static_cast<size_t>(OpCode::COUNT_)] = {
+    0,  // NONE
+    1,  // ADD
+    1,  // SUB
+    2,  // MUL
+    2,  // DIV
+    2,  // MOD
+    3,  // POW (right-associative)
+    2,  // BIT_AND (same precedence as mult/div)
+    1,  // BIT_OR (same precedence as add/sub)
+    3,  // SHL (same precedence as power)
+    3,  // SHR
+    3,  // PLUS
+    3,  // NEG
+    3,  // BIT_NOT
+};
+
+} // anonymous namespace
+
 int ShuntingYardParser::getPrecedence(const Token& op) const {
     if (op.type != TokenType::OPERATOR) {
         throw CalculatorException(ErrorCode::PARSE_ERROR, "Cannot get precedence of non-operator token", op.position);
     }
 
-    // Unary operators have the same precedence as exponentiation
-    // This allows exponentiation to bind tighter than unary minus
-    // e.g., -2^3 = -(2^3), not (-2)^3
-    if (op.value == "u+" || op.value == "u-") {
-        return 3;  // Same precedence as exponentiation
-    }
-
-    // Binary operators (lower number = higher precedence)
-    if (op.value == "^") {
-        return 3;  // Exponentiation (right-associative)
-    } else if (op.value == "<<" || op.value == ">>") {
-        return 3;  // Shift operators (same precedence as power)
-    } else if (op.value == "&") {
-        return 2;  // Bitwise AND (same precedence as mult/div)
-    } else if (op.value == "*" || op.value == "/" || op.value == "%") {
-        return 2;  // Multiplication, division, modulo
-    } else if (op.value == "|") {
-        return 1;  // Bitwise OR (same precedence as add/sub)
-    } else if (op.value == "+" || op.value == "-") {
-        return 1;  // Addition, subtraction
+    int precedence = SHUNTING_YARD_PRECEDENCE[static_cast<size_t>(op.opcode)];
+    if (precedence == 0) {
+        throw CalculatorException(ErrorCode::PARSE_ERROR, "Unknown operator: " + op.value, op.position);
     }
-
-    throw CalculatorException(ErrorCode::PARSE_ERROR, "Unknown operator: " + op.value, op.position);
+    return precedence;
 }
 
 bool ShuntingYardParser::isRightAssociative(const Token& op) const {
@@ -97,7 +102,7 @@ bool ShuntingYardParser::isRightAssociative(const Token& op) const {
 
     // Only exponentiation is right-associative
     // Unary operators are prefix operators, not right-associative
-    return op.value == "^";
+    return op.opcode == OpCode::POW;
 }
 
 void ShuntingYardParser::validateParentheses(const std::vector<Token>& tokens) const {
@@ -140,10 +145,10 @@ void ShuntingYardParser::validateOperators(const std::vector<Token>& tokens) con
         }
 
         // Check if current can be unary
-        bool currentCanBeUnary = (current.value == "+" || current.value == "-");
+        bool currentCanBeUnary = (current.opcode == OpCode::ADD || current.opcode == OpCode::SUB);
 
         // Check if prev can be unary
-        bool prevCanBeUnary = (prev.value == "+" || prev.value == "-");
+        bool prevCanBeUnary = (prev.opcode == OpCode::ADD || prev.opcode == OpCode::SUB);
 
         // If neither operator can be unary, it's an error
         if (!currentCanBeUnary && !prevCanBeUnary) {
@@ -165,7 +170,7 @@ void ShuntingYardParser::validateOperators(const std::vector<Token>& tokens) con
             // The difference: in 1++2, prevPrev (1) is an operand
             // In +5 + +3, prevPrev (5) is also an operand, BUT the middle + is between operands
             // Actually wait, we need to check if there's an operand on BOTH sides of prev
-            if (prevPrev.type == TokenType::NUMBER && current.value == "+") {
+            if (prevPrev.type == TokenType::NUMBER && current.opcode == OpCode::ADD) {
                 // Check if there's a NUMBER (or similar operand) after prevPrev to see if prev is binary
                 // For 1++2: prevPrev=1 (NUM), prev=+, current=+ - prev is NOT binary
                 // For +5 + +3: prevPrev=5 (NUM), prev=+, current=+ - prev IS binary
@@ -229,6 +234,7 @@ std::vector<Token> ShuntingYardParser::toPostfix(const std::vector<Token>& token
 
         switch (token.type) {
             case TokenType::NUMBER:
+            case TokenType::VARIABLE:
                 output.push_back(token);
                 break;
 
@@ -263,7 +269,7 @@ std::vector<Token> ShuntingYardParser::toPostfix(const std::vector<Token>& token
                 // Check if this should be treated as a unary operator
                 if (isUnaryOperator(tokens, i)) {
                     Token unaryOp(token);
-                    unaryOp.value = "u" + token.value;  // Mark as unary (e.g., "u+", "u-")
+                    unaryOp.opcode = toUnaryOpCode(token.opcode);  // Mark as unary (PLUS, NEG, BIT_NOT)
                     operatorStack.push_back(unaryOp);
                 } else {
                     // Binary operator
@@ -343,35 +349,24 @@ std::unique_ptr<ASTNode> ShuntingYardParser::buildAST(const std::vector<Token>&
 
     for (const auto& token : postfixTokens) {
         switch (token.type) {
-            case TokenType::NUMBER: {
-                double value;
-                // Handle different number bases
-                if (token.numberBase == NumberBase::BINARY) {
-                    value = static_cast<double>(Converter::binaryToDecimal(token.value));
-                } else if (token.numberBase == NumberBase::OCTAL) {
-                    value = static_cast<double>(Converter::octalToDecimal(token.value));
-                } else if (token.numberBase == NumberBase::HEXADECIMAL) {
-                    value = static_cast<double>(Converter::hexToDecimal(token.value));
-                } else {
-                    // Default: decimal
-                    value = std::stod(token.value);
-                }
-                operandStack.push(std::make_unique<LiteralNode>(value));
+            case TokenType::NUMBER:
+                operandStack.push(makeLiteral(token));
+                break;
+
+            case TokenType::VARIABLE:
+                operandStack.push(makeNode<VariableNode>(token.value, token.position));
                 break;
-            }
 
             case TokenType::OPERATOR: {
                 // Check if it's a unary operator
-                if (token.value == "u+" || token.value == "u-" || token.value == "u~") {
+                if (isUnaryOpCode(token.opcode)) {
                     // Unary operator
                     if (operandStack.empty()) {
                         throw CalculatorException(ErrorCode::UNEXPECTED_TOKEN, "Missing operand for unary operator", token.position);
                     }
                     auto operand = std::move(const_cast<std::unique_ptr<ASTNode>&>(operandStack.top()));
                     operandStack.pop();
-                    Token unaryOp(token);
-                    unaryOp.value = token.value.substr(1);  // Remove 'u' prefix
-                    operandStack.push(createUnaryOp(unaryOp, std::move(operand)));
+                    operandStack.push(createUnaryOp(token, std::move(operand)));
                 } else {
                     // Binary operator
                     applyOperator(token, operandStack);
@@ -429,7 +424,7 @@ void ShuntingYardParser::applyOperator(const Token& op,
     auto left = std::move(const_cast<std::unique_ptr<ASTNode>&>(operands.top()));
     operands.pop();
 
-    operands.push(std::make_unique<BinaryOpNode>(std::move(left), op, std::move(right)));
+    operands.push(makeNode<BinaryOpNode>(std::move(left), op, std::move(right)));
 }
 
 std::unique_ptr<FunctionCallNode> ShuntingYardParser::buildFunctionCall(
@@ -443,21 +438,21 @@ std::unique_ptr<FunctionCallNode> ShuntingYardParser::buildFunctionCall(
             "Not enough arguments for function: " + name, position);
     }
 
-    std::vector<std::unique_ptr<ASTNode>> args;
-    args.reserve(operandCount);
+    ASTNodeList args = makeNodeList();
+    args.resize(operandCount);
 
-    // Pop arguments in reverse order (they were pushed in LIFO order)
-    for (size_t i = 0; i < operandCount; ++i) {
-        args.insert(args.begin(), std::move(const_cast<std::unique_ptr<ASTNode>&>(operands.top())));
+    // Pop arguments into place from the back (they were pushed in LIFO order)
+    for (size_t i = operandCount; i > 0; --i) {
+        args[i - 1] = std::move(const_cast<std::unique_ptr<ASTNode>&>(operands.top()));
         operands.pop();
     }
 
-    return std::make_unique<FunctionCallNode>(name, position, std::move(args));
+    return makeNode<FunctionCallNode>(name, position, std::move(args));
 }
 
 std::unique_ptr<UnaryOpNode> ShuntingYardParser::createUnaryOp(Token op,
                                                                  std::unique_ptr<ASTNode> operand) {
-    return std::make_unique<UnaryOpNode>(op, std::move(operand));
+    return makeNode<UnaryOpNode>(op, std::move(operand));
 }
 
 } // namespace calc
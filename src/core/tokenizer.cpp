@@ -4,8 +4,10 @@
  */
 
 #include "calc/core/tokenizer.h"
-#include <stdexcept>
+#include <charconv>
 #include <cctype>
+#include <limits>
+#include <stdexcept>
 
 namespace calc {
 
@@ -13,11 +15,76 @@ namespace calc {
 // Token Implementation
 // ============================================================================
 
+namespace {
+
+bool isDigit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+unsigned radixOf(NumberBase base) noexcept {
+    switch (base) {
+        case NumberBase::BINARY:      return 2;
+        case NumberBase::OCTAL:       return 8;
+        case NumberBase::HEXADECIMAL: return 16;
+        default:                      return 10;
+    }
+}
+
+bool isDigitForRadix(char c, unsigned radix) noexcept {
+    switch (radix) {
+        case 2:  return c == '0' || c == '1';
+        case 8:  return c >= '0' && c <= '7';
+        default: return std::isxdigit(static_cast<unsigned char>(c)) != 0;
+    }
+}
+
+/**
+ * @brief Convert a literal's digits (without base prefix) to its value
+ *
+ * Decimal literals go through std::from_chars, which neither allocates
+ * nor depends on the locale. Prefixed literals wrap to 64 bits, as
+ * Converter::fromBase does.
+ *
+ * @return false if @p digits is not a whole literal or is out of range
+ */
+bool convertLiteral(std::string_view digits, NumberBase base, double& value) noexcept {
+    if (digits.empty()) {
+        return false;
+    }
+
+    if (base == NumberBase::DECIMAL) {
+        const char* end = digits.data() + digits.size();
+        std::from_chars_result result = std::from_chars(digits.data(), end, value);
+        return result.ec == std::errc() && result.ptr == end;
+    }
+
+    const unsigned radix = radixOf(base);
+    uint64_t accumulated = 0;
+    for (char c : digits) {
+        if (!isDigitForRadix(c, radix)) {
+            return false;
+        }
+        unsigned digit = isDigit(c) ? static_cast<unsigned>(c - '0')
+                                    : static_cast<unsigned>((c | 0x20) - 'a' + 10);
+        accumulated = accumulated * radix + digit;
+    }
+    value = static_cast<double>(static_cast<int64_t>(accumulated));
+    return true;
+}
+
+double parseNumberLiteral(const std::string& digits, NumberBase base) noexcept {
+    double value = 0.0;
+    return convertLiteral(digits, base, value) ? value : std::numeric_limits<double>::quiet_NaN();
+}
+
+} // anonymous namespace
+
 std::string tokenTypeToString(TokenType type) {
     switch (type) {
         case TokenType::NUMBER:    return "NUMBER";
         case TokenType::OPERATOR:  return "OPERATOR";
         case TokenType::FUNCTION:  return "FUNCTION";
+        case TokenType::VARIABLE:  return "VARIABLE";
         case TokenType::LPAREN:    return "LPAREN";
         case TokenType::RPAREN:    return "RPAREN";
         case TokenType::COMMA:     return "COMMA";
@@ -27,13 +94,68 @@ std::string tokenTypeToString(TokenType type) {
     }
 }
 
-Token::Token() : type(TokenType::UNKNOWN), value(""), position(0), argCount(0), numberBase(NumberBase::DECIMAL) {}
+OpCode classifyOperator(const std::string& symbol) noexcept {
+    if (symbol.size() == 1) {
+        switch (symbol[0]) {
+            case '+': return OpCode::ADD;
+            case '-': return OpCode::SUB;
+            case '*': return OpCode::MUL;
+            case '/': return OpCode::DIV;
+            case '%': return OpCode::MOD;
+            case '^': return OpCode::POW;
+            case '&': return OpCode::BIT_AND;
+            case '|': return OpCode::BIT_OR;
+            case '~': return OpCode::BIT_NOT;
+            default:  return OpCode::NONE;
+        }
+    }
+    if (symbol == "<<") {
+        return OpCode::SHL;
+    }
+    if (symbol == ">>") {
+        return OpCode::SHR;
+    }
+    return OpCode::NONE;
+}
+
+const char* opCodeSymbol(OpCode op) noexcept {
+    switch (op) {
+        case OpCode::ADD:
+        case OpCode::PLUS:    return "+";
+        case OpCode::SUB:
+        case OpCode::NEG:     return "-";
+        case OpCode::MUL:     return "*";
+        case OpCode::DIV:     return "/";
+        case OpCode::MOD:     return "%";
+        case OpCode::POW:     return "^";
+        case OpCode::BIT_AND: return "&";
+        case OpCode::BIT_OR:  return "|";
+        case OpCode::SHL:     return "<<";
+        case OpCode::SHR:     return ">>";
+        case OpCode::BIT_NOT: return "~";
+        default:              return "";
+    }
+}
+
+Token::Token()
+    : type(TokenType::UNKNOWN), value(""), position(0), argCount(0),
+      numberBase(NumberBase::DECIMAL), opcode(OpCode::NONE), number(0.0) {}
 
 Token::Token(TokenType t, const std::string& v, size_t pos)
-    : type(t), value(v), position(pos), argCount(0), numberBase(NumberBase::DECIMAL) {}
+    : Token(t, v, pos, NumberBase::DECIMAL) {}
+
+Token::Token(TokenType t, const std::string& v, size_t pos, OpCode op)
+    : type(t), value(v), position(pos), argCount(0), numberBase(NumberBase::DECIMAL), opcode(op),
+      number(0.0) {}
 
 Token::Token(TokenType t, const std::string& v, size_t pos, NumberBase base)
-    : type(t), value(v), position(pos), argCount(0), numberBase(base) {}
+    : type(t), value(v), position(pos), argCount(0), numberBase(base),
+      opcode(t == TokenType::OPERATOR ? classifyOperator(v) : OpCode::NONE),
+      number(t == TokenType::NUMBER ? parseNumberLiteral(v, base) : 0.0) {}
+
+Token::Token(std::string v, size_t pos, NumberBase base, double numericValue)
+    : type(TokenType::NUMBER), value(std::move(v)), position(pos), argCount(0), numberBase(base),
+      opcode(OpCode::NONE), number(numericValue) {}
 
 bool Token::isOperator() const noexcept {
     return type == TokenType::OPERATOR;
@@ -47,26 +169,38 @@ bool Token::isFunction() const noexcept {
     return type == TokenType::FUNCTION;
 }
 
+namespace {
+
+// Binary operator precedence indexed by OpCode (higher = binds tighter, 0 = not binary)
+constexpr int TOKEN_PRECEDENCE[static_cast<size_t>(OpCode::COUNT_)] = {
+    0,  // NONE
+    2,  // ADD
+    2,  // SUB
+    3,  // MUL
+    3,  // DIV
+    3,  // MOD
+    4,  // POW
+    3,  // BIT_AND
+    3,  // BIT_OR
+    4,  // SHL
+    4,  // SHR
+    0,  // PLUS
+    0,  // NEG
+    0,  // BIT_NOT
+};
+
+} // anonymous namespace
+
 int Token::getPrecedence() const {
     if (!isOperator()) {
         return 0;  // For non-operators, return 0 instead of throwing
     }
 
-    // Operator precedence table
-    // Higher number = higher precedence
-    if (value == "^") {
-        return 4;  // Power (exponentiation) - highest precedence for arithmetic
-    } else if (value == "<<" || value == ">>") {
-        return 4;  // Shift operators - same as power
-    } else if (value == "&") {
-        return 3;  // Bitwise AND
-    } else if (value == "|" || value == "*" || value == "/" || value == "%") {
-        return 3;  // Bitwise OR, Multiplication, Division, Modulo
-    } else if (value == "+" || value == "-") {
-        return 2;  // Addition, subtraction
+    int precedence = TOKEN_PRECEDENCE[static_cast<size_t>(opcode)];
+    if (precedence == 0) {
+        throw std::runtime_error("Unknown operator: " + value);
     }
-
-    throw std::runtime_error("Unknown operator: " + value);
+    return precedence;
 }
 
 bool Token::isRightAssociative() const {
@@ -75,7 +209,7 @@ bool Token::isRightAssociative() const {
     }
 
     // Only exponentiation is right-associative
-    return value == "^";
+    return opcode == OpCode::POW;
 }
 
 bool Token::operator==(const Token& other) const noexcept {
@@ -90,328 +224,233 @@ bool Token::operator!=(const Token& other) const noexcept {
 // Tokenizer Implementation
 // ============================================================================
 
-Tokenizer::Tokenizer(const std::string& input) : input_(input), pos_(0) {}
-
-bool Tokenizer::isAtEnd() const noexcept {
-    return pos_ >= input_.length();
-}
-
-char Tokenizer::current() const noexcept {
-    if (isAtEnd()) {
-        return '\0';
-    }
-    return input_[pos_];
-}
-
-char Tokenizer::peek(size_t offset) const noexcept {
-    size_t newPos = pos_ + offset;
-    if (newPos >= input_.length()) {
-        return '\0';
-    }
-    return input_[newPos];
-}
-
-char Tokenizer::advance() noexcept {
-    char c = current();
-    if (!isAtEnd()) {
-        ++pos_;
-    }
-    return c;
-}
+namespace {
 
-bool Tokenizer::isWhitespace(char c) noexcept {
+bool isWhitespace(char c) noexcept {
     return c == ' ' || c == '\t' || c == '\n' || c == '\r';
 }
 
-bool Tokenizer::isDigit(char c) noexcept {
-    return c >= '0' && c <= '9';
-}
-
-bool Tokenizer::isLetter(char c) noexcept {
+bool isLetter(char c) noexcept {
     return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
 }
 
-bool Tokenizer::isOperator(char c) noexcept {
+bool isOperator(char c) noexcept {
     return c == '+' || c == '-' || c == '*' || c == '/' || c == '^' || c == '%' ||
            c == '&' || c == '|' || c == '~' || c == '<' || c == '>';
 }
 
-void Tokenizer::skipWhitespace() {
-    while (!isAtEnd() && isWhitespace(current())) {
-        advance();
-    }
-}
-
-Token Tokenizer::readNumberWithPrefix() {
-    size_t startPos = pos_;
-
-    // Check for base prefix
-    NumberBase base = NumberBase::DECIMAL;
-
-    if (isBinaryPrefix(input_, pos_)) {
-        base = NumberBase::BINARY;
-        pos_ += 2;  // Skip "0b" or "0B"
-    } else if (isHexPrefix(input_, pos_)) {
-        base = NumberBase::HEXADECIMAL;
-        pos_ += 2;  // Skip "0x" or "0X"
-    } else if (isOctalPrefix(input_, pos_)) {
-        base = NumberBase::OCTAL;
-        pos_ += 2;  // Skip "0o" or "0O"
-    }
-
-    // Read the number part (digits only, no decimal points for hex/binary/octal)
-    std::string number;
-
-    if (base == NumberBase::BINARY) {
-        while (!isAtEnd() && (current() == '0' || current() == '1')) {
-            number += advance();
-        }
-    } else if (base == NumberBase::OCTAL) {
-        while (!isAtEnd() && current() >= '0' && current() <= '7') {
-            number += advance();
-        }
-    } else if (base == NumberBase::HEXADECIMAL) {
-        while (!isAtEnd() && std::isxdigit(static_cast<unsigned char>(current()))) {
-            number += advance();
-        }
-    } else {
-        // Decimal - allow decimal point and scientific notation
-        bool hasDecimal = false;
-
-        // Integer part
-        while (!isAtEnd() && isDigit(current())) {
-            number += advance();
+/**
+ * @brief Single pass over the input, handing each token to a sink
+ *
+ * Shared by both tokenize() overloads so they accept exactly the same
+ * language and report the same errors.
+ */
+template <typename Sink>
+class Scanner {
+public:
+    Scanner(std::string_view input, Sink& sink) : input_(input), sink_(sink) {}
+
+    void run() {
+        if (input_.size() > UINT32_MAX) {
+            throw SyntaxError("Input too long to tokenize", 0);
         }
 
-        // Decimal part (only one decimal point allowed)
-        if (!isAtEnd() && current() == '.') {
-            if (hasDecimal) {
-                throw SyntaxError("Invalid number format: multiple decimal points", startPos);
+        while (pos_ < input_.size()) {
+            char c = input_[pos_];
+            if (isWhitespace(c)) {
+                ++pos_;
+                continue;
             }
-            hasDecimal = true;
-            number += advance();
 
-            // Must have at least one digit after decimal point
-            if (isAtEnd() || !isDigit(current())) {
-                throw SyntaxError("Invalid number format: decimal point without digits", startPos);
-            }
+            size_t start = pos_;
 
-            while (!isAtEnd() && isDigit(current())) {
-                number += advance();
+            if (isBinaryPrefix(input_, pos_)) {
+                readPrefixed(NumberBase::BINARY);
+            } else if (isHexPrefix(input_, pos_)) {
+                readPrefixed(NumberBase::HEXADECIMAL);
+            } else if (isOctalPrefix(input_, pos_)) {
+                readPrefixed(NumberBase::OCTAL);
+            } else if (isDigit(c) || (c == '.' && isDigit(peek(1)))) {
+                // A number directly followed by ".5" has a second decimal point
+                if (c == '.' && lastType_ == TokenType::NUMBER) {
+                    throw SyntaxError("Invalid number format: multiple decimal points", start);
+                }
+                readDecimal();
+            } else if (c == '.') {
+                throw SyntaxError("Unexpected character: '.'", start);
+            } else if (isLetter(c)) {
+                readIdentifier();
+            } else if (isOperator(c)) {
+                readOperator();
+            } else if (c == '(') {
+                emit(TokenType::LPAREN, start, 1);
+            } else if (c == ')') {
+                emit(TokenType::RPAREN, start, 1);
+            } else if (c == ',') {
+                emit(TokenType::COMMA, start, 1);
+            } else {
+                throw SyntaxError(std::string("Unexpected character: '") + c + "'", start);
             }
         }
 
-        // Scientific notation
-        if (!isAtEnd() && (current() == 'e' || current() == 'E')) {
-            number += advance();
+        emit(TokenType::EOF_TOKEN, pos_, 0);
+    }
 
-            // Optional sign
-            if (!isAtEnd() && (current() == '+' || current() == '-')) {
-                number += advance();
-            }
+private:
+    std::string_view input_;
+    Sink& sink_;
+    size_t pos_ = 0;
+    TokenType lastType_ = TokenType::UNKNOWN;
 
-            // Must have at least one digit after 'e' or 'E'
-            if (isAtEnd() || !isDigit(current())) {
-                throw SyntaxError("Invalid number format: exponent without digits", startPos);
-            }
+    char peek(size_t offset) const noexcept {
+        return pos_ + offset < input_.size() ? input_[pos_ + offset] : '\0';
+    }
 
-            while (!isAtEnd() && isDigit(current())) {
-                number += advance();
-            }
+    void skipDigits() noexcept {
+        while (pos_ < input_.size() && isDigit(input_[pos_])) {
+            ++pos_;
         }
     }
 
-    if (number.empty()) {
-        throw SyntaxError("Expected digits after base prefix", startPos);
+    // Emit a token of @p length characters at @p start and move past it
+    void emit(TokenType type, size_t start, size_t length, OpCode op = OpCode::NONE,
+              NumberBase base = NumberBase::DECIMAL, double number = 0.0) {
+        CompactToken token;
+        token.number = number;
+        token.offset = static_cast<uint32_t>(start);
+        token.length = static_cast<uint32_t>(length);
+        token.type = type;
+        token.opcode = op;
+        token.numberBase = base;
+        sink_(token);
+        lastType_ = type;
+        pos_ = start + length;
     }
 
-    return Token(TokenType::NUMBER, number, startPos, base);
-}
-
-Token Tokenizer::readNumber() {
-    size_t startPos = pos_;
-
-    std::string number;
-    bool hasDecimal = false;
+    void readPrefixed(NumberBase base) {
+        size_t start = pos_;
+        pos_ += 2;  // Skip "0b", "0o" or "0x"
 
-    // Integer part
-    while (!isAtEnd() && isDigit(current())) {
-        number += advance();
-    }
-
-    // Decimal part (only one decimal point allowed)
-    if (!isAtEnd() && current() == '.') {
-        if (hasDecimal) {
-            throw SyntaxError("Invalid number format: multiple decimal points", startPos);
+        const unsigned radix = radixOf(base);
+        while (pos_ < input_.size() && isDigitForRadix(input_[pos_], radix)) {
+            ++pos_;
         }
-        hasDecimal = true;
-        number += advance();
 
-        // Must have at least one digit after decimal point
-        if (isAtEnd() || !isDigit(current())) {
-            throw SyntaxError("Invalid number format: decimal point without digits", startPos);
+        double value = 0.0;
+        if (!convertLiteral(input_.substr(start + 2, pos_ - start - 2), base, value)) {
+            throw SyntaxError("Expected digits after base prefix", start);
         }
 
-        while (!isAtEnd() && isDigit(current())) {
-            number += advance();
-        }
+        emit(TokenType::NUMBER, start, pos_ - start, OpCode::NONE, base, value);
     }
 
-    // Scientific notation
-    if (!isAtEnd() && (current() == 'e' || current() == 'E')) {
-        number += advance();
+    void readDecimal() {
+        size_t start = pos_;
 
-        // Optional sign
-        if (!isAtEnd() && (current() == '+' || current() == '-')) {
-            number += advance();
-        }
+        // Integer part
+        skipDigits();
 
-        // Must have at least one digit after 'e' or 'E'
-        if (isAtEnd() || !isDigit(current())) {
-            throw SyntaxError("Invalid number format: exponent without digits", startPos);
+        // Fractional part
+        if (peek(0) == '.') {
+            ++pos_;
+            if (!isDigit(peek(0))) {
+                throw SyntaxError("Invalid number format: decimal point without digits", start);
+            }
+            skipDigits();
         }
 
-        while (!isAtEnd() && isDigit(current())) {
-            number += advance();
+        // Scientific notation
+        if (peek(0) == 'e' || peek(0) == 'E') {
+            ++pos_;
+            if (peek(0) == '+' || peek(0) == '-') {
+                ++pos_;
+            }
+            if (!isDigit(peek(0))) {
+                throw SyntaxError("Invalid number format: exponent without digits", start);
+            }
+            skipDigits();
         }
-    }
-
-    return Token(TokenType::NUMBER, number, startPos);
-}
 
-Token Tokenizer::readIdentifier() {
-    size_t startPos = pos_;
-    std::string identifier;
+        // The lexeme is already validated, so conversion only fails on range
+        std::string_view text = input_.substr(start, pos_ - start);
+        double value = 0.0;
+        if (!convertLiteral(text, NumberBase::DECIMAL, value)) {
+            throw SyntaxError("Number out of range: " + std::string(text), start);
+        }
 
-    // First character must be a letter
-    if (!isLetter(current())) {
-        throw SyntaxError("Function names must start with a letter", startPos);
+        emit(TokenType::NUMBER, start, pos_ - start, OpCode::NONE, NumberBase::DECIMAL, value);
     }
 
-    identifier += advance();
-
-    // Rest can be letters or digits
-    while (!isAtEnd() && (isLetter(current()) || isDigit(current()))) {
-        identifier += advance();
-    }
+    void readIdentifier() {
+        size_t start = pos_;
+        while (pos_ < input_.size() && (isLetter(input_[pos_]) || isDigit(input_[pos_]))) {
+            ++pos_;
+        }
 
-    return Token(TokenType::FUNCTION, identifier, startPos);
-}
+        // An identifier is a function call only when an argument list follows
+        size_t next = pos_;
+        while (next < input_.size() && isWhitespace(input_[next])) {
+            ++next;
+        }
+        bool isCall = next < input_.size() && input_[next] == '(';
 
-Token Tokenizer::readOperator() {
-    size_t startPos = pos_;
-    std::string op;
-
-    // Check for multi-character operators (<<, >>)
-    char c1 = current();
-    char c2 = peek(1);
-
-    if (c1 == '<' && c2 == '<') {
-        op += advance();
-        op += advance();
-        return Token(TokenType::OPERATOR, op, startPos);
-    } else if (c1 == '>' && c2 == '>') {
-        op += advance();
-        op += advance();
-        return Token(TokenType::OPERATOR, op, startPos);
-    } else if (c1 == '<' && c2 == '=') {
-        // Not supported yet, but prevent it from being interpreted as < and =
-        throw SyntaxError("Unsupported operator '<='", startPos);
-    } else if (c1 == '>' && c2 == '=') {
-        // Not supported yet, but prevent it from being interpreted as > and =
-        throw SyntaxError("Unsupported operator '>='", startPos);
+        emit(isCall ? TokenType::FUNCTION : TokenType::VARIABLE, start, pos_ - start);
     }
 
-    // Single character operators
-    op += advance();
-
-    return Token(TokenType::OPERATOR, op, startPos);
-}
+    void readOperator() {
+        size_t start = pos_;
+        char c1 = peek(0);
+        char c2 = peek(1);
+
+        if (c1 == '<' && c2 == '<') {
+            emit(TokenType::OPERATOR, start, 2, OpCode::SHL);
+        } else if (c1 == '>' && c2 == '>') {
+            emit(TokenType::OPERATOR, start, 2, OpCode::SHR);
+        } else if (c1 == '<' && c2 == '=') {
+            // Not supported yet, but prevent it from being interpreted as < and =
+            throw SyntaxError("Unsupported operator '<='", start);
+        } else if (c1 == '>' && c2 == '=') {
+            // Not supported yet, but prevent it from being interpreted as > and =
+            throw SyntaxError("Unsupported operator '>='", start);
+        } else {
+            emit(TokenType::OPERATOR, start, 1, classifyOperator(std::string(1, c1)));
+        }
+    }
+};
 
-Token Tokenizer::readLeftParen() {
-    size_t startPos = pos_;
-    advance();
-    return Token(TokenType::LPAREN, "(", startPos);
-}
+} // anonymous namespace
 
-Token Tokenizer::readRightParen() {
-    size_t startPos = pos_;
-    advance();
-    return Token(TokenType::RPAREN, ")", startPos);
-}
+Tokenizer::Tokenizer(const std::string& input) : input_(input) {}
 
-Token Tokenizer::readComma() {
-    size_t startPos = pos_;
-    advance();
-    return Token(TokenType::COMMA, ",", startPos);
+std::vector<Token> Tokenizer::tokenize() {
+    return tokenize(std::string_view(input_));
 }
 
-std::vector<Token> Tokenizer::tokenize() {
+std::vector<Token> Tokenizer::tokenize(std::string_view input) {
     std::vector<Token> tokens;
 
-    while (!isAtEnd()) {
-        skipWhitespace();
-
-        if (isAtEnd()) {
-            break;
-        }
-
-        char c = current();
-        size_t startPos = pos_;
-
-        // Check for base prefixes (0b, 0x, 0o)
-        if (c == '0' && peek(1) != '\0') {
-            if (isBinaryPrefix(input_, pos_)) {
-                tokens.push_back(readNumberWithPrefix());
-                continue;
-            } else if (isHexPrefix(input_, pos_)) {
-                tokens.push_back(readNumberWithPrefix());
-                continue;
-            } else if (isOctalPrefix(input_, pos_)) {
-                tokens.push_back(readNumberWithPrefix());
-                continue;
+    auto sink = [&](const CompactToken& token) {
+        std::string_view text = token.text(input);
+        if (token.type == TokenType::NUMBER) {
+            if (token.numberBase != NumberBase::DECIMAL) {
+                text.remove_prefix(2);  // Token::value holds the digits without "0x"
             }
-        }
-
-        // Handle shift operators (<<, >>) - let readOperator handle them
-        if ((c == '<' || c == '>') && peek(1) == c) {
-            tokens.push_back(readOperator());
-            continue;
-        }
-
-        if (isDigit(c) || (c == '.' && isDigit(peek(1)))) {
-            // Check if previous token was a number - if so, this might be an error
-            if (!tokens.empty() && tokens.back().type == TokenType::NUMBER) {
-                // If we have a number followed by something that looks like a number,
-                // and it starts with '.', this is an invalid multiple decimal
-                if (c == '.') {
-                    throw SyntaxError("Invalid number format: multiple decimal points", startPos);
-                }
-            }
-            tokens.push_back(readNumber());
-        } else if (c == '.') {
-            // Lone decimal point - check if it's a valid number like ".5"
-            // But this is handled by readNumber, so fall through to error
-            throw SyntaxError("Unexpected character: '.'", startPos);
-        } else if (isLetter(c)) {
-            tokens.push_back(readIdentifier());
-        } else if (isOperator(c)) {
-            tokens.push_back(readOperator());
-        } else if (c == '(') {
-            tokens.push_back(readLeftParen());
-        } else if (c == ')') {
-            tokens.push_back(readRightParen());
-        } else if (c == ',') {
-            tokens.push_back(readComma());
+            tokens.emplace_back(std::string(text), token.offset, token.numberBase, token.number);
         } else {
-            throw SyntaxError(std::string("Unexpected character: '") + c + "'", startPos);
+            tokens.emplace_back(token.type, std::string(text), token.offset, token.opcode);
         }
-    }
-
-    // Add EOF token
-    tokens.push_back(Token(TokenType::EOF_TOKEN, "", pos_));
+    };
+    Scanner<decltype(sink)> scanner(input, sink);
+    scanner.run();
 
     return tokens;
 }
 
+void Tokenizer::tokenize(std::string_view input, std::vector<CompactToken>& tokens) {
+    tokens.clear();
+    auto sink = [&](const CompactToken& token) { tokens.push_back(token); };
+    Scanner<decltype(sink)> scanner(input, sink);
+    scanner.run();
+}
+
 } // namespace calc
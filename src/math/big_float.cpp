@@ -0,0 +1,596 @@
+/**
+ * @file big_float.cpp
+ * @brief Arbitrary-precision binary floating-point implementation
+ */
+
+#include "calc/math/big_float.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace calc {
+
+namespace {
+
+constexpr double LOG2_10 = 3.321928094887362;
+constexpr double LOG10_2 = 0.30102999566398120;
+
+BigInteger magnitudeOf(const BigInteger& value) {
+    return value.isNegative() ? -value : value;
+}
+
+BigInteger withSign(BigInteger magnitude, bool negative) {
+    return negative ? -magnitude : magnitude;
+}
+
+size_t toSize(int64_t value) {
+    return static_cast<size_t>(value);
+}
+
+BigInteger powerOfFive(size_t exponent) {
+    return BigInteger::pow(BigInteger(5), exponent);
+}
+
+/// floor(sqrt(n)) for n >= 0
+BigInteger isqrt(const BigInteger& n) {
+    const size_t bits = n.bitLength();
+    if (bits <= 52) {
+        const auto value = static_cast<uint64_t>(n.toInt64());
+        auto root = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+        while (root * root > value) {
+            --root;
+        }
+        while ((root + 1) * (root + 1) <= value) {
+            ++root;
+        }
+        return BigInteger(static_cast<long long>(root));
+    }
+
+    // The root of the top half of the bits, scaled back, is at least the
+    // root and already has half its bits right, so Newton's method
+    // descends to it in a step or two
+    const size_t k = (bits - 1) / 4;
+    BigInteger x = (isqrt(n >> (2 * k)) + 1) << k;
+    for (;;) {
+        BigInteger y = (x + n / x) >> 1;
+        if (y >= x) {
+            return x;
+        }
+        x = std::move(y);
+    }
+}
+
+/// floor(cbrt(n)) for n >= 0
+BigInteger icbrt(const BigInteger& n) {
+    const size_t bits = n.bitLength();
+    if (bits <= 52) {
+        const auto value = static_cast<uint64_t>(n.toInt64());
+        auto root = static_cast<uint64_t>(std::cbrt(static_cast<double>(value)));
+        while (root * root * root > value) {
+            --root;
+        }
+        while ((root + 1) * (root + 1) * (root + 1) <= value) {
+            ++root;
+        }
+        return BigInteger(static_cast<long long>(root));
+    }
+
+    const size_t k = (bits - 1) / 6;
+    BigInteger x = (icbrt(n >> (3 * k)) + 1) << k;
+    for (;;) {
+        BigInteger y = ((x << 1) + n / (x * x)) / 3;
+        if (y >= x) {
+            return x;
+        }
+        x = std::move(y);
+    }
+}
+
+} // anonymous namespace
+
+//=============================================================================
+// Construction and conversion
+//=============================================================================
+
+BigFloat::BigFloat(BigInteger value)
+    : mantissa_(std::move(value)) {
+    normalize();
+}
+
+BigFloat::BigFloat(BigInteger mantissa, int64_t exponent)
+    : mantissa_(std::move(mantissa)), exponent_(exponent) {
+    normalize();
+}
+
+void BigFloat::normalize() {
+    if (mantissa_.isZero()) {
+        exponent_ = 0;
+        return;
+    }
+    const size_t zeros = mantissa_.lowestSetBit();
+    if (zeros > 0) {
+        mantissa_ >>= zeros;
+        exponent_ += static_cast<int64_t>(zeros);
+    }
+}
+
+BigFloat BigFloat::fromDouble(double value) {
+    if (!std::isfinite(value)) {
+        throw std::invalid_argument("Not a finite number");
+    }
+    if (value == 0.0) {
+        return BigFloat();
+    }
+    int exponent = 0;
+    const double fraction = std::frexp(value, &exponent);
+    return BigFloat(BigInteger(static_cast<long long>(std::ldexp(fraction, 53))), exponent - 53);
+}
+
+BigFloat BigFloat::fromString(std::string_view text, size_t precision) {
+    precision = std::max(precision, MIN_PRECISION);
+
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+        negative = text[pos] == '-';
+        ++pos;
+    }
+
+    // Significant digits without leading zeros, and the power of ten they scale by
+    std::string digits;
+    int64_t exponent = 0;
+    bool seenDigit = false;
+    bool seenPoint = false;
+    for (; pos < text.size(); ++pos) {
+        const char c = text[pos];
+        if (c >= '0' && c <= '9') {
+            seenDigit = true;
+            if (!digits.empty() || c != '0') {
+                digits += c;
+            }
+            if (seenPoint) {
+                --exponent;
+            }
+        } else if (c == '.' && !seenPoint) {
+            seenPoint = true;
+        } else {
+            break;
+        }
+    }
+    if (!seenDigit) {
+        throw std::invalid_argument("Not a decimal number");
+    }
+
+    if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        ++pos;
+        bool exponentNegative = false;
+        if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+            exponentNegative = text[pos] == '-';
+            ++pos;
+        }
+        int64_t value = 0;
+        bool seenExponentDigit = false;
+        for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+            seenExponentDigit = true;
+            if (value <= MAX_DECIMAL_EXPONENT) {
+                value = value * 10 + (text[pos] - '0');
+            }
+        }
+        if (!seenExponentDigit) {
+            throw std::invalid_argument("Not a decimal number");
+        }
+        exponent += exponentNegative ? -value : value;
+    }
+    if (pos != text.size()) {
+        throw std::invalid_argument("Not a decimal number");
+    }
+    if (digits.empty()) {
+        return BigFloat();
+    }
+
+    while (digits.back() == '0') {
+        digits.pop_back();
+        ++exponent;
+    }
+    if (exponent > MAX_DECIMAL_EXPONENT || exponent < -MAX_DECIMAL_EXPONENT) {
+        throw std::out_of_range("Decimal exponent out of range");
+    }
+
+    // digits * 10^e = digits * 5^e * 2^e, leaving only the power of five to multiply or divide by
+    const BigInteger mantissa = BigInteger::fromString(digits, 10);
+    if (exponent >= 0) {
+        return roundExact(withSign(mantissa * powerOfFive(toSize(exponent)), negative),
+                          exponent, precision, false);
+    }
+    const BigInteger divisor = powerOfFive(toSize(-exponent));
+    const int64_t shift = std::max<int64_t>(
+        0, static_cast<int64_t>(precision + 2 + divisor.bitLength()) -
+               static_cast<int64_t>(mantissa.bitLength()));
+    BigInteger quotient;
+    BigInteger remainder;
+    BigInteger::divMod(mantissa << toSize(shift), divisor, quotient, remainder);
+    return roundExact(withSign(std::move(quotient), negative), exponent - shift, precision,
+                      !remainder.isZero());
+}
+
+size_t BigFloat::precisionForDigits(size_t digits) noexcept {
+    return static_cast<size_t>(std::ceil(static_cast<double>(digits) * LOG2_10)) + 1;
+}
+
+std::string BigFloat::toString(size_t digits) const {
+    if (isZero()) {
+        return "0";
+    }
+    digits = std::max<size_t>(digits, 1);
+
+    const BigInteger magnitude = magnitudeOf(mantissa_);
+    const BigInteger low = BigInteger::pow(BigInteger(10), digits - 1);
+    const BigInteger high = low * 10;
+
+    // 2^(order - 1) <= |x| < 2^order, so this is floor(log10 |x|) or one
+    // less; the loop below corrects it
+    auto exp10 = static_cast<int64_t>(std::floor(static_cast<double>(order() - 1) * LOG10_2));
+    BigInteger scaled;
+    for (;;) {
+        // scaled = |x| / 10^power, with 10^power split into 5^power 2^power
+        const int64_t power = exp10 - static_cast<int64_t>(digits) + 1;
+        BigInteger numerator = magnitude;
+        BigInteger denominator(1);
+        if (power < 0) {
+            numerator *= powerOfFive(toSize(-power));
+        } else {
+            denominator = powerOfFive(toSize(power));
+        }
+        const int64_t binary = exponent_ - power;
+        if (binary >= 0) {
+            numerator <<= toSize(binary);
+        } else {
+            denominator <<= toSize(-binary);
+        }
+
+        BigInteger remainder;
+        BigInteger::divMod(numerator, denominator, scaled, remainder);
+        if (scaled >= high) {
+            ++exp10;
+            continue;
+        }
+        if (scaled < low) {
+            --exp10;
+            continue;
+        }
+        const int half = BigInteger::compare(remainder << 1, denominator);
+        if (half > 0 || (half == 0 && scaled.testBit(0))) {
+            scaled += 1;
+            if (scaled == high) {
+                scaled = low;
+                ++exp10;
+            }
+        }
+        break;
+    }
+
+    std::string text = scaled.toString(10);
+    text.erase(text.find_last_not_of('0') + 1);
+
+    std::string result = isNegative() ? "-" : "";
+    if (exp10 < -5 || exp10 >= static_cast<int64_t>(digits)) {
+        result += text[0];
+        if (text.size() > 1) {
+            result += '.';
+            result.append(text, 1, std::string::npos);
+        }
+        result += exp10 < 0 ? "e-" : "e+";
+        const std::string exponentText = std::to_string(exp10 < 0 ? -exp10 : exp10);
+        if (exponentText.size() < 2) {
+            result += '0';
+        }
+        result += exponentText;
+    } else if (exp10 < 0) {
+        result += "0.";
+        result.append(toSize(-exp10 - 1), '0');
+        result += text;
+    } else {
+        const size_t integerDigits = toSize(exp10) + 1;
+        if (text.size() <= integerDigits) {
+            result += text;
+            result.append(integerDigits - text.size(), '0');
+        } else {
+            result.append(text, 0, integerDigits);
+            result += '.';
+            result.append(text, integerDigits, std::string::npos);
+        }
+    }
+    return result;
+}
+
+double BigFloat::toDouble() const {
+    if (isZero()) {
+        return 0.0;
+    }
+    const double sign = isNegative() ? -1.0 : 1.0;
+    const int64_t bits = order();
+    if (bits > std::numeric_limits<double>::max_exponent) {
+        return sign * std::numeric_limits<double>::infinity();
+    }
+    // Half the smallest subnormal, 2^-1075, has order -1074
+    if (bits < -1074) {
+        return sign * 0.0;
+    }
+
+    // Subnormals keep fewer bits; the two lowest binades round twice
+    const auto precision =
+        static_cast<size_t>(std::clamp<int64_t>(bits + 1074, static_cast<int64_t>(MIN_PRECISION), 53));
+    const BigFloat rounded = roundToPrecision(precision);
+    return std::ldexp(rounded.mantissa_.toDouble(), static_cast<int>(rounded.exponent_));
+}
+
+//=============================================================================
+// Queries and rounding
+//=============================================================================
+
+int64_t BigFloat::order() const noexcept {
+    return isZero() ? 0 : exponent_ + static_cast<int64_t>(mantissa_.bitLength());
+}
+
+BigInteger BigFloat::toInteger() const {
+    if (exponent_ >= 0) {
+        return mantissa_ << toSize(exponent_);
+    }
+    const size_t shift = toSize(-exponent_);
+    if (shift >= mantissa_.bitLength()) {
+        return BigInteger();
+    }
+    return withSign(magnitudeOf(mantissa_) >> shift, mantissa_.isNegative());
+}
+
+BigFloat BigFloat::roundExact(BigInteger mantissa, int64_t exponent, size_t precision, bool sticky) {
+    precision = std::max(precision, MIN_PRECISION);
+    const bool negative = mantissa.isNegative();
+    BigInteger magnitude = magnitudeOf(mantissa);
+    if (sticky) {
+        // With more bits than the precision, no rounding boundary lies
+        // strictly between the mantissa and the next integer, so any point
+        // between them rounds as the exact value does
+        magnitude = (magnitude << 1) + 1;
+        --exponent;
+    }
+
+    const size_t bits = magnitude.bitLength();
+    if (bits > precision) {
+        const size_t shift = bits - precision;
+        const bool half = magnitude.testBit(shift - 1);
+        const bool below = magnitude.lowestSetBit() < shift - 1;
+        magnitude >>= shift;
+        exponent += static_cast<int64_t>(shift);
+        if (half && (below || magnitude.testBit(0))) {
+            magnitude += 1;
+        }
+    }
+    return BigFloat(withSign(std::move(magnitude), negative), exponent);
+}
+
+BigFloat BigFloat::roundToPrecision(size_t precision) const {
+    return roundExact(mantissa_, exponent_, precision, false);
+}
+
+BigFloat BigFloat::scaled(int64_t count) const {
+    BigFloat result(*this);
+    if (!isZero()) {
+        result.exponent_ += count;
+    }
+    return result;
+}
+
+BigFloat BigFloat::operator-() const {
+    return BigFloat(-mantissa_, exponent_);
+}
+
+BigFloat BigFloat::abs() const {
+    return isNegative() ? -*this : *this;
+}
+
+BigFloat BigFloat::trunc() const {
+    return isInteger() ? *this : BigFloat(toInteger());
+}
+
+BigFloat BigFloat::floor() const {
+    if (isInteger()) {
+        return *this;
+    }
+    BigInteger truncated = toInteger();
+    return BigFloat(isNegative() ? truncated - 1 : truncated);
+}
+
+BigFloat BigFloat::ceil() const {
+    if (isInteger()) {
+        return *this;
+    }
+    BigInteger truncated = toInteger();
+    return BigFloat(isNegative() ? truncated : truncated + 1);
+}
+
+BigFloat BigFloat::round() const {
+    if (isInteger()) {
+        return *this;
+    }
+    BigInteger truncated = toInteger();
+    const BigFloat fraction = (*this - BigFloat(truncated)).abs();
+    if (fraction >= BigFloat(BigInteger(1), -1)) {
+        truncated += sign();
+    }
+    return BigFloat(std::move(truncated));
+}
+
+//=============================================================================
+// Arithmetic
+//=============================================================================
+
+BigFloat operator+(const BigFloat& a, const BigFloat& b) {
+    if (a.isZero()) {
+        return b;
+    }
+    if (b.isZero()) {
+        return a;
+    }
+    const int64_t exponent = std::min(a.exponent_, b.exponent_);
+    return BigFloat((a.mantissa_ << toSize(a.exponent_ - exponent)) +
+                        (b.mantissa_ << toSize(b.exponent_ - exponent)),
+                    exponent);
+}
+
+BigFloat operator-(const BigFloat& a, const BigFloat& b) {
+    return a + -b;
+}
+
+BigFloat operator*(const BigFloat& a, const BigFloat& b) {
+    return BigFloat(a.mantissa_ * b.mantissa_, a.exponent_ + b.exponent_);
+}
+
+BigFloat BigFloat::add(const BigFloat& a, const BigFloat& b, size_t precision) {
+    precision = std::max(precision, MIN_PRECISION);
+    if (a.isZero()) {
+        return b.roundToPrecision(precision);
+    }
+    if (b.isZero()) {
+        return a.roundToPrecision(precision);
+    }
+
+    const bool aLarger = a.order() >= b.order();
+    const BigFloat& large = aLarger ? a : b;
+    const BigFloat& small = aLarger ? b : a;
+
+    // Below 2^cut the small operand only decides which way the sum rounds:
+    // the large one is a multiple of 2^cut and the rounding boundaries are
+    // multiples of 2^(cut + 1), even if the sum loses its top bit. A single
+    // bit below the cut stands in for it, so a huge gap in exponents never
+    // turns into a huge shift.
+    const int64_t cut = std::min(large.exponent_, large.order() - static_cast<int64_t>(precision) - 3);
+    if (small.order() <= cut) {
+        return (large + BigFloat(BigInteger(small.sign()), cut - 1)).roundToPrecision(precision);
+    }
+    return (a + b).roundToPrecision(precision);
+}
+
+BigFloat BigFloat::subtract(const BigFloat& a, const BigFloat& b, size_t precision) {
+    return add(a, -b, precision);
+}
+
+BigFloat BigFloat::multiply(const BigFloat& a, const BigFloat& b, size_t precision) {
+    return (a * b).roundToPrecision(precision);
+}
+
+BigFloat BigFloat::divide(const BigFloat& a, const BigFloat& b, size_t precision) {
+    if (b.isZero()) {
+        throw std::domain_error("Division by zero");
+    }
+    if (a.isZero()) {
+        return BigFloat();
+    }
+    precision = std::max(precision, MIN_PRECISION);
+
+    // Scale the dividend so the quotient has two bits beyond the precision
+    const int64_t shift = std::max<int64_t>(
+        0, static_cast<int64_t>(precision + 2 + b.mantissa_.bitLength()) -
+               static_cast<int64_t>(a.mantissa_.bitLength()));
+    BigInteger quotient;
+    BigInteger remainder;
+    BigInteger::divMod(magnitudeOf(a.mantissa_) << toSize(shift), magnitudeOf(b.mantissa_),
+                       quotient, remainder);
+    return roundExact(withSign(std::move(quotient), a.isNegative() != b.isNegative()),
+                      a.exponent_ - b.exponent_ - shift, precision, !remainder.isZero());
+}
+
+BigFloat BigFloat::sqrt(const BigFloat& a, size_t precision) {
+    if (a.isNegative()) {
+        throw std::domain_error("Square root of a negative number");
+    }
+    if (a.isZero()) {
+        return BigFloat();
+    }
+    precision = std::max(precision, MIN_PRECISION);
+
+    // An even exponent, and enough bits for a root two beyond the precision
+    int64_t shift = std::max<int64_t>(0, static_cast<int64_t>(2 * (precision + 2)) -
+                                             static_cast<int64_t>(a.mantissa_.bitLength()));
+    if ((a.exponent_ - shift) % 2 != 0) {
+        ++shift;
+    }
+    const BigInteger n = a.mantissa_ << toSize(shift);
+    BigInteger root = isqrt(n);
+    const bool inexact = root * root != n;
+    return roundExact(std::move(root), (a.exponent_ - shift) / 2, precision, inexact);
+}
+
+BigFloat BigFloat::cbrt(const BigFloat& a, size_t precision) {
+    if (a.isZero()) {
+        return BigFloat();
+    }
+    precision = std::max(precision, MIN_PRECISION);
+
+    int64_t shift = std::max<int64_t>(0, static_cast<int64_t>(3 * (precision + 2)) -
+                                             static_cast<int64_t>(a.mantissa_.bitLength()));
+    while ((a.exponent_ - shift) % 3 != 0) {
+        ++shift;
+    }
+    const BigInteger n = magnitudeOf(a.mantissa_) << toSize(shift);
+    BigInteger root = icbrt(n);
+    const bool inexact = root * root * root != n;
+    return roundExact(withSign(std::move(root), a.isNegative()), (a.exponent_ - shift) / 3,
+                      precision, inexact);
+}
+
+BigFloat BigFloat::fmod(const BigFloat& a, const BigFloat& b) {
+    if (b.isZero()) {
+        throw std::domain_error("Division by zero");
+    }
+    if (a.order() < b.order()) {
+        return a;
+    }
+    const int64_t exponent = std::min(a.exponent_, b.exponent_);
+    BigInteger quotient;
+    BigInteger remainder;
+    BigInteger::divMod(a.mantissa_ << toSize(a.exponent_ - exponent),
+                       b.mantissa_ << toSize(b.exponent_ - exponent), quotient, remainder);
+    return BigFloat(std::move(remainder), exponent);
+}
+
+BigFloat BigFloat::remainder(const BigFloat& a, const BigFloat& b) {
+    if (b.isZero()) {
+        throw std::domain_error("Division by zero");
+    }
+    if (a.isZero()) {
+        return a;
+    }
+    const int64_t exponent = std::min(a.exponent_, b.exponent_);
+    const BigInteger divisor = magnitudeOf(b.mantissa_) << toSize(b.exponent_ - exponent);
+    BigInteger quotient;
+    BigInteger remainder;
+    BigInteger::divMod(a.mantissa_ << toSize(a.exponent_ - exponent), divisor, quotient, remainder);
+
+    // Step to the nearer multiple, or to the even one at a tie
+    const int half = BigInteger::compare(magnitudeOf(remainder) << 1, divisor);
+    if (half > 0 || (half == 0 && quotient.testBit(0))) {
+        remainder = remainder.isNegative() ? remainder + divisor : remainder - divisor;
+    }
+    return BigFloat(std::move(remainder), exponent);
+}
+
+int BigFloat::compare(const BigFloat& a, const BigFloat& b) {
+    if (a.sign() != b.sign()) {
+        return a.sign() < b.sign() ? -1 : 1;
+    }
+    if (a.isZero()) {
+        return 0;
+    }
+    const int64_t aOrder = a.order();
+    const int64_t bOrder = b.order();
+    if (aOrder != bOrder) {
+        return (aOrder < bOrder ? -1 : 1) * a.sign();
+    }
+    const int64_t exponent = std::min(a.exponent_, b.exponent_);
+    return BigInteger::compare(a.mantissa_ << toSize(a.exponent_ - exponent),
+                               b.mantissa_ << toSize(b.exponent_ - exponent));
+}
+
+} // namespace calc
@@ -0,0 +1,455 @@
+/**
+ * @file big_float_evaluator.cpp
+ * @brief Arbitrary-precision floating-point evaluation for precision mode
+ */
+
+#include "calc/math/big_float_evaluator.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace calc {
+
+namespace {
+
+int radixOf(NumberBase base) noexcept {
+    switch (base) {
+        case NumberBase::BINARY:      return 2;
+        case NumberBase::OCTAL:       return 8;
+        case NumberBase::HEXADECIMAL: return 16;
+        case NumberBase::DECIMAL:
+        default:                      return 10;
+    }
+}
+
+using PreciseNullary = BigFloat (*)(size_t);
+using PreciseUnary = BigFloat (*)(const BigFloat&, size_t);
+using PreciseBinary = BigFloat (*)(const BigFloat&, const BigFloat&, size_t);
+
+struct PreciseNullaryEntry {
+    const char* name;
+    PreciseNullary function;
+};
+
+struct PreciseUnaryEntry {
+    const char* name;
+    PreciseUnary function;
+};
+
+struct PreciseBinaryEntry {
+    const char* name;
+    PreciseBinary function;
+};
+
+/// The functions MathFunctions registers, at the evaluator's precision
+const PreciseNullaryEntry PRECISE_CONSTANTS[] = {
+    {"PI", &BigFloatFunctions::pi},
+    {"E", &BigFloatFunctions::e},
+};
+
+const PreciseUnaryEntry PRECISE_UNARY[] = {
+    {"sin", &BigFloatFunctions::sin},
+    {"cos", &BigFloatFunctions::cos},
+    {"tan", &BigFloatFunctions::tan},
+    {"asin", &BigFloatFunctions::asin},
+    {"acos", &BigFloatFunctions::acos},
+    {"atan", &BigFloatFunctions::atan},
+    {"sinh", &BigFloatFunctions::sinh},
+    {"cosh", &BigFloatFunctions::cosh},
+    {"tanh", &BigFloatFunctions::tanh},
+    {"log", &BigFloatFunctions::log},
+    {"log10", &BigFloatFunctions::log10},
+    {"exp", &BigFloatFunctions::exp},
+    {"sqrt", &BigFloat::sqrt},
+    {"cbrt", &BigFloat::cbrt},
+    {"abs", [](const BigFloat& x, size_t) { return x.abs(); }},
+    {"floor", [](const BigFloat& x, size_t) { return x.floor(); }},
+    {"ceil", [](const BigFloat& x, size_t) { return x.ceil(); }},
+    {"round", [](const BigFloat& x, size_t) { return x.round(); }},
+    {"trunc", [](const BigFloat& x, size_t) { return x.trunc(); }},
+};
+
+const PreciseBinaryEntry PRECISE_BINARY[] = {
+    {"pow", &BigFloatFunctions::pow},
+    {"hypot", &BigFloatFunctions::hypot},
+    {"fmod", [](const BigFloat& x, const BigFloat& y, size_t) { return BigFloat::fmod(x, y); }},
+    {"remainder", [](const BigFloat& x, const BigFloat& y, size_t) { return BigFloat::remainder(x, y); }},
+};
+
+template <typename Entry, size_t N>
+const Entry* findPrecise(const Entry (&table)[N], const std::string& name) noexcept {
+    for (const Entry& entry : table) {
+        if (name == entry.name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // anonymous namespace
+
+//=============================================================================
+// BigFloatResult Implementation
+//=============================================================================
+
+BigFloatResult::BigFloatResult(BigFloat value, size_t precision)
+    : value_(std::move(value))
+    , precision_(precision)
+    , isError_(false)
+    , errorCode_(ErrorCode::UNKNOWN_ERROR)
+    , errorPosition_(0)
+{}
+
+BigFloatResult::BigFloatResult(ErrorCode code, const std::string& message, size_t position)
+    : precision_(0)
+    , isError_(true)
+    , errorCode_(code)
+    , errorMessage_(message)
+    , errorPosition_(position)
+{}
+
+const BigFloat& BigFloatResult::getValue() const {
+    if (isError_) {
+        throw std::runtime_error("Cannot get value from error result");
+    }
+    return value_;
+}
+
+ErrorCode BigFloatResult::getErrorCode() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error code from successful result");
+    }
+    return errorCode_;
+}
+
+const std::string& BigFloatResult::getErrorMessage() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error message from successful result");
+    }
+    return errorMessage_;
+}
+
+size_t BigFloatResult::getErrorPosition() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error position from successful result");
+    }
+    return errorPosition_;
+}
+
+EvaluationResult BigFloatResult::toEvaluationResult() const {
+    if (isError_) {
+        return EvaluationResult(errorCode_, errorMessage_, errorPosition_);
+    }
+    double value = value_.toDouble();
+    if (std::isinf(value)) {
+        return EvaluationResult(ErrorCode::NUMERIC_OVERFLOW, "Numeric overflow", 0);
+    }
+    return EvaluationResult(value);
+}
+
+//=============================================================================
+// BigFloatEvaluator Implementation
+//=============================================================================
+
+BigFloatEvaluator::BigFloatEvaluator(size_t precision)
+    : precision_(0)
+{
+    setPrecision(precision);
+}
+
+void BigFloatEvaluator::setPrecision(size_t precision) {
+    if (precision < BigFloat::MIN_PRECISION || precision > MAX_PRECISION) {
+        throw std::invalid_argument("Precision must be from " + std::to_string(BigFloat::MIN_PRECISION) +
+                                    " to " + std::to_string(MAX_PRECISION) + " bits");
+    }
+    precision_ = precision;
+}
+
+BigFloatResult BigFloatEvaluator::evaluate(const ASTNode& root, const EvaluationContext& context) {
+    context_ = &context;
+    xor_ = context.getOperatorSemantics("^") == OperatorSemantics::BITWISE_XOR;
+    failed_ = false;
+    values_.clear();
+
+    walker_.walk(const_cast<ASTNode&>(root), *this);
+    context_ = nullptr;
+
+    if (failed_) {
+        return error_;
+    }
+    return BigFloatResult(pop(), precision_);
+}
+
+void BigFloatEvaluator::fail(ErrorCode code, const std::string& message, size_t position) {
+    error_ = BigFloatResult(code, message, position);
+    failed_ = true;
+    walker_.stop();
+}
+
+template <typename Operation>
+bool BigFloatEvaluator::guard(size_t position, Operation&& operation) {
+    try {
+        operation();
+        return true;
+    } catch (const std::domain_error& e) {
+        fail(ErrorCode::DOMAIN_ERROR, e.what(), position);
+    } catch (const std::overflow_error& e) {
+        fail(ErrorCode::NUMERIC_OVERFLOW, e.what(), position);
+    } catch (const std::out_of_range& e) {
+        fail(ErrorCode::NUMERIC_OVERFLOW, e.what(), position);
+    } catch (const std::invalid_argument& e) {
+        fail(ErrorCode::DOMAIN_ERROR, e.what(), position);
+    }
+    return false;
+}
+
+void BigFloatEvaluator::push(BigFloat value, size_t position) {
+    const int64_t order = value.order();
+    if (order > MAX_ORDER) {
+        fail(ErrorCode::NUMERIC_OVERFLOW, "Numeric overflow", position);
+    } else if (order < -MAX_ORDER) {
+        values_.emplace_back();
+    } else {
+        values_.push_back(std::move(value));
+    }
+}
+
+BigFloat BigFloatEvaluator::pop() {
+    BigFloat value = std::move(values_.back());
+    values_.pop_back();
+    return value;
+}
+
+void BigFloatEvaluator::pushDouble(double value, const std::string& name, size_t position) {
+    if (std::isnan(value)) {
+        fail(ErrorCode::DOMAIN_ERROR, "Result is NaN (Not a Number) - possible domain error: " + name,
+             position);
+    } else if (std::isinf(value)) {
+        fail(ErrorCode::NUMERIC_OVERFLOW, "Numeric overflow: " + name, position);
+    } else {
+        push(BigFloat::fromDouble(value).roundToPrecision(precision_), position);
+    }
+}
+
+void BigFloatEvaluator::visit(LiteralNode& node) {
+    BigFloat value;
+    const bool ok = guard(0, [&] {
+        if (!node.hasDigits()) {
+            value = node.hasInteger() ? BigFloat(BigInteger::fromUnsigned(node.getInteger()))
+                                      : BigFloat::fromDouble(node.getValue());
+        } else if (node.isWide()) {
+            value = BigFloat(BigInteger::fromString(node.getDigits(), radixOf(node.getBase())));
+        } else {
+            value = BigFloat::fromString(node.getDigits(), precision_);
+        }
+    });
+    if (ok) {
+        push(value.roundToPrecision(precision_), 0);
+    }
+}
+
+void BigFloatEvaluator::visit(VariableNode& node) {
+    size_t slot = context_->findVariableSlot(node.getName());
+    if (slot != EvaluationContext::NO_SLOT) {
+        pushDouble(context_->getVariable(slot), node.getName(), node.getPosition());
+        return;
+    }
+
+    // Constants are zero-argument functions
+    const FunctionEntry* entry = context_->findFunction(node.getName());
+    if (entry == nullptr) {
+        fail(ErrorCode::UNDEFINED_VARIABLE, "Undefined variable: " + node.getName(), node.getPosition());
+        return;
+    }
+    BigFloat result;
+    if (call(node.getName(), *entry, nullptr, 0, node.getPosition(), result)) {
+        push(std::move(result), node.getPosition());
+    }
+}
+
+void BigFloatEvaluator::visit(BinaryOpNode& node) {
+    BigFloat right = pop();
+    BigFloat left = pop();
+
+    BigFloat result;
+    if (applyBinary(node.getOpCode(), node.getPosition(), left, right, result)) {
+        push(std::move(result), node.getPosition());
+    }
+}
+
+void BigFloatEvaluator::visit(UnaryOpNode& node) {
+    BigFloat operand = pop();
+
+    switch (node.getOpCode()) {
+        case OpCode::PLUS:
+            push(std::move(operand), node.getPosition());
+            break;
+        case OpCode::NEG:
+            push(-operand, node.getPosition());
+            break;
+        case OpCode::BIT_NOT:
+            push(BigFloat(~operand.toInteger()), node.getPosition());
+            break;
+        default:
+            fail(ErrorCode::EVALUATION_ERROR,
+                 std::string("Unknown unary operator: ") + opCodeSymbol(node.getOpCode()),
+                 node.getPosition());
+            break;
+    }
+}
+
+void BigFloatEvaluator::visit(FunctionCallNode& node) {
+    const size_t count = node.getArgumentCount();
+    const size_t frame = values_.size() - count;
+
+    const FunctionEntry* entry = context_->findFunction(node.getName());
+    if (entry == nullptr) {
+        fail(ErrorCode::INVALID_FUNCTION, "Unknown function: " + node.getName(), node.getPosition());
+        return;
+    }
+
+    BigFloat result;
+    const bool ok = call(node.getName(), *entry, values_.data() + frame, count, node.getPosition(), result);
+    values_.resize(frame);
+    if (ok) {
+        push(std::move(result), node.getPosition());
+    }
+}
+
+bool BigFloatEvaluator::call(const std::string& name, const FunctionEntry& entry,
+                             const BigFloat* arguments, size_t count, size_t position,
+                             BigFloat& result) {
+    if (!entry.acceptsArgumentCount(count)) {
+        fail(ErrorCode::EVALUATION_ERROR, entry.arityMessage(name), position);
+        return false;
+    }
+
+    if (count == 0) {
+        if (const PreciseNullaryEntry* precise = findPrecise(PRECISE_CONSTANTS, name)) {
+            result = precise->function(precision_);
+            return true;
+        }
+    } else if (count == 1) {
+        if (const PreciseUnaryEntry* precise = findPrecise(PRECISE_UNARY, name)) {
+            return guard(position, [&] { result = precise->function(arguments[0], precision_); });
+        }
+    } else if (count == 2) {
+        if (const PreciseBinaryEntry* precise = findPrecise(PRECISE_BINARY, name)) {
+            return guard(position, [&] {
+                result = precise->function(arguments[0], arguments[1], precision_);
+            });
+        }
+    }
+    if (count >= 1 && (name == "max" || name == "min")) {
+        const bool isMax = name == "max";
+        result = arguments[0];
+        for (size_t i = 1; i < count; ++i) {
+            if (isMax ? arguments[i] > result : arguments[i] < result) {
+                result = arguments[i];
+            }
+        }
+        return true;
+    }
+
+    // No precise version: the function registry works on doubles
+    arguments_.clear();
+    for (size_t i = 0; i < count; ++i) {
+        arguments_.push_back(arguments[i].toDouble());
+    }
+    EvaluationResult value = EvaluationContext::callFunction(entry, name, arguments_.data(), count);
+    if (value.isError()) {
+        fail(value.getErrorCode(), value.getErrorMessage(),
+             value.getErrorPosition() == 0 ? position : value.getErrorPosition());
+        return false;
+    }
+    if (!std::isfinite(value.getValue())) {
+        fail(std::isnan(value.getValue()) ? ErrorCode::DOMAIN_ERROR : ErrorCode::NUMERIC_OVERFLOW,
+             name + " did not return a finite number", position);
+        return false;
+    }
+    result = BigFloat::fromDouble(value.getValue()).roundToPrecision(precision_);
+    return true;
+}
+
+bool BigFloatEvaluator::applyBinary(OpCode op, size_t position, const BigFloat& left,
+                                    const BigFloat& right, BigFloat& result) {
+    switch (op) {
+        case OpCode::ADD:
+            result = BigFloat::add(left, right, precision_);
+            return true;
+        case OpCode::SUB:
+            result = BigFloat::subtract(left, right, precision_);
+            return true;
+        case OpCode::MUL:
+            if (left.order() + right.order() > MAX_ORDER + 1) {
+                fail(ErrorCode::NUMERIC_OVERFLOW, "Numeric overflow", position);
+                return false;
+            }
+            result = BigFloat::multiply(left, right, precision_);
+            return true;
+
+        case OpCode::DIV:
+        case OpCode::MOD:
+            if (right.isZero()) {
+                fail(ErrorCode::DIVISION_BY_ZERO, "Division by zero", position);
+                return false;
+            }
+            if (op == OpCode::DIV) {
+                result = BigFloat::divide(left, right, precision_);
+            } else {
+                result = BigFloat::fmod(left, right).roundToPrecision(precision_);
+            }
+            return true;
+
+        case OpCode::POW:
+            if (xor_) {
+                result = BigFloat(left.toInteger() ^ right.toInteger());
+                return true;
+            }
+            if (left.isZero() && right.isNegative()) {
+                fail(ErrorCode::DIVISION_BY_ZERO, "Division by zero", position);
+                return false;
+            }
+            return guard(position, [&] { result = BigFloatFunctions::pow(left, right, precision_); });
+
+        case OpCode::BIT_AND:
+            result = BigFloat(left.toInteger() & right.toInteger());
+            return true;
+        case OpCode::BIT_OR:
+            result = BigFloat(left.toInteger() | right.toInteger());
+            return true;
+
+        case OpCode::SHL:
+        case OpCode::SHR: {
+            const BigInteger value = left.toInteger();
+            const BigInteger count = right.toInteger();
+            if (count.isNegative()) {
+                fail(ErrorCode::DOMAIN_ERROR, "Negative shift count", position);
+                return false;
+            }
+            if (value.isZero()) {
+                result = BigFloat();
+                return true;
+            }
+            // Past MAX_ORDER a left shift overflows, and a right shift leaves 0 or -1
+            if (!count.fitsInt64() || count.toInt64() > MAX_ORDER) {
+                if (op == OpCode::SHL) {
+                    fail(ErrorCode::NUMERIC_OVERFLOW, "Numeric overflow", position);
+                    return false;
+                }
+                result = BigFloat(BigInteger(value.isNegative() ? -1 : 0));
+                return true;
+            }
+            const int64_t bits = count.toInt64();
+            result = op == OpCode::SHL ? BigFloat(value).scaled(bits)
+                                       : BigFloat(value >> static_cast<size_t>(bits));
+            return true;
+        }
+
+        default:
+            fail(ErrorCode::EVALUATION_ERROR,
+                 std::string("Unknown binary operator: ") + opCodeSymbol(op), position);
+            return false;
+    }
+}
+
+} // namespace calc
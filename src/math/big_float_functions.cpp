@@ -0,0 +1,570 @@
+/**
+ * @file big_float_functions.cpp
+ * @brief Elementary functions on BigFloat
+ *
+ * Series are summed in fixed point: an integer holding the value times
+ * 2^bits, where every term's truncation costs at most one unit in the
+ * last place. Each function works with enough bits beyond the requested
+ * precision to absorb those errors, the ones squaring and doubling steps
+ * amplify, and the ones cancellation exposes.
+ */
+
+#include "calc/math/big_float.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace calc {
+
+namespace {
+
+/// Bits carried beyond the requested precision through each function
+constexpr size_t GUARD_BITS = 32;
+
+/// exp's arguments above 2^this have results beyond 2^MAX_ORDER (MAX_ORDER ln 2 < 2^21)
+constexpr int64_t EXP_ARGUMENT_ORDER = 21;
+
+static_assert(BigFloatFunctions::MAX_ORDER == int64_t{1} << 20,
+              "EXP_ARGUMENT_ORDER follows MAX_ORDER");
+
+size_t toSize(int64_t value) {
+    return static_cast<size_t>(value);
+}
+
+/// -order, the leading zero bits of a value below one, or 0
+size_t leadingZeros(const BigFloat& x) {
+    return x.order() < 0 ? toSize(-x.order()) : 0;
+}
+
+size_t bitLength(uint64_t value) {
+    size_t bits = 0;
+    for (; value != 0; value >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+/// Halvings for a series of @p precision bits: balancing about sqrt(precision)
+/// halvings against the terms they save
+size_t halvingsFor(size_t precision, int64_t order) {
+    const auto base = static_cast<int64_t>(std::sqrt(static_cast<double>(precision)));
+    return toSize(std::max<int64_t>(0, base + order));
+}
+
+BigFloat one() {
+    return BigFloat(BigInteger(1));
+}
+
+/// a * b / 2^bits, truncated toward zero so positive and negative errors cancel
+BigInteger fixedMultiply(const BigInteger& a, const BigInteger& b, size_t bits) {
+    BigInteger product = a * b;
+    if (product.isNegative()) {
+        return -((-product) >> bits);
+    }
+    return product >> bits;
+}
+
+BigInteger toFixed(const BigFloat& value, size_t bits) {
+    return value.scaled(static_cast<int64_t>(bits)).toInteger();
+}
+
+BigFloat fromFixed(BigInteger value, size_t bits) {
+    return BigFloat(std::move(value), -static_cast<int64_t>(bits));
+}
+
+/// atan(1/n), or atanh(1/n) when @p hyperbolic, times 2^bits
+BigInteger inverseArctanFixed(long long n, size_t bits, bool hyperbolic) {
+    const BigInteger square(n * n);
+    BigInteger power = BigInteger::powerOfTwo(bits) / BigInteger(n);
+    BigInteger sum = power;
+    for (long long k = 3;; k += 2) {
+        power /= square;
+        BigInteger term = power / BigInteger(k);
+        if (term.isZero()) {
+            break;
+        }
+        if (hyperbolic || k % 4 == 1) {
+            sum += term;
+        } else {
+            sum -= term;
+        }
+    }
+    return sum;
+}
+
+BigInteger piFixed(size_t bits) {
+    // Machin: pi = 16 atan(1/5) - 4 atan(1/239)
+    return (inverseArctanFixed(5, bits, false) << 4) - (inverseArctanFixed(239, bits, false) << 2);
+}
+
+BigInteger ln2Fixed(size_t bits) {
+    // ln 2 = 18 atanh(1/26) - 2 atanh(1/4801) + 8 atanh(1/8749)
+    return inverseArctanFixed(26, bits, true) * 18 - (inverseArctanFixed(4801, bits, true) << 1) +
+           (inverseArctanFixed(8749, bits, true) << 3);
+}
+
+/// A constant times 2^bits, kept at the most bits asked for so far
+struct ConstantCache {
+    size_t bits = 0;
+    BigInteger fixed;
+};
+
+BigFloat cachedConstant(ConstantCache& cache, size_t precision, BigInteger (*compute)(size_t)) {
+    const size_t bits = precision + GUARD_BITS;
+    if (cache.bits < bits) {
+        // Each series truncates every term, so sum past the bits kept
+        const size_t working = bits + 64;
+        cache.fixed = compute(working) >> (working - bits);
+        cache.bits = bits;
+    }
+    return fromFixed(cache.fixed >> (cache.bits - bits), bits).roundToPrecision(precision);
+}
+
+/// e^r for |r| < 1, to about @p precision bits
+BigFloat expSmall(const BigFloat& r, size_t precision) {
+    if (r.isZero()) {
+        return one();
+    }
+    // e^r = (e^(r / 2^s))^(2^s): the halvings shorten the series and each
+    // squaring doubles the error, so the fixed point carries s more bits
+    const size_t halvings = halvingsFor(precision, r.order());
+    const size_t bits = precision + halvings + 16;
+    const BigInteger y = toFixed(r.scaled(-static_cast<int64_t>(halvings)), bits);
+
+    BigInteger sum = BigInteger::powerOfTwo(bits) + y;
+    BigInteger term = y;
+    for (long long n = 2; !term.isZero(); ++n) {
+        term = fixedMultiply(term, y, bits) / BigInteger(n);
+        sum += term;
+    }
+    for (size_t i = 0; i < halvings; ++i) {
+        sum = fixedMultiply(sum, sum, bits);
+    }
+    return fromFixed(std::move(sum), bits);
+}
+
+/// sin r and cos r for |r| < 1, each to about @p precision significant bits
+void sinCosSmall(const BigFloat& r, size_t precision, BigFloat& sine, BigFloat& cosine) {
+    // sin r = r - r^3/6 and cos r = 1 - r^2/2 agree with r and 1 to precision
+    if (r.isZero() || r.order() * -2 > static_cast<int64_t>(precision)) {
+        sine = r;
+        cosine = one();
+        return;
+    }
+
+    // Sum both series of r / 2^s at once, then double the angle s times:
+    // sin 2a = 2 sin a cos a, cos 2a = 1 - 2 sin^2 a. A small r needs its
+    // leading zeros as extra bits, since sin r is about as small.
+    const size_t halvings = halvingsFor(precision, r.order()) / 2;
+    const size_t bits = precision + halvings + 16 + leadingZeros(r);
+    const BigInteger y = toFixed(r.scaled(-static_cast<int64_t>(halvings)), bits);
+
+    BigInteger s = y;
+    BigInteger c = BigInteger::powerOfTwo(bits);
+    BigInteger term = y;
+    for (long long n = 2; !term.isZero(); ++n) {
+        term = fixedMultiply(term, y, bits) / BigInteger(n);
+        switch (n % 4) {
+            case 0: c += term; break;
+            case 1: s += term; break;
+            case 2: c -= term; break;
+            default: s -= term; break;
+        }
+    }
+
+    const BigInteger unit = BigInteger::powerOfTwo(bits);
+    for (size_t i = 0; i < halvings; ++i) {
+        BigInteger doubled = fixedMultiply(s, c, bits) << 1;
+        c = unit - (fixedMultiply(s, s, bits) << 1);
+        s = std::move(doubled);
+    }
+    sine = fromFixed(std::move(s), bits);
+    cosine = fromFixed(std::move(c), bits);
+}
+
+/**
+ * x = k pi/2 + r: returns r to about @p precision significant bits and
+ * sets @p quadrant to k mod 4. Pi carries the bits of k, and more when x
+ * lies so close to a multiple of pi/2 that r cancels.
+ */
+BigFloat reduceQuarterTurns(const BigFloat& x, size_t precision, int& quadrant) {
+    quadrant = 0;
+    if (x.order() <= 0) {
+        return x;
+    }
+    if (x.order() > BigFloatFunctions::MAX_ORDER) {
+        throw std::overflow_error("Numeric overflow");
+    }
+
+    const size_t integerBits = toSize(x.order());
+    size_t extra = 0;
+    for (;;) {
+        const BigFloat halfPi = BigFloatFunctions::pi(precision + integerBits + extra + 8).scaled(-1);
+        const BigInteger k = BigFloat::divide(x, halfPi, integerBits + 8).round().toInteger();
+        const BigFloat r = x - BigFloat(k) * halfPi;
+        // r is good to 2^-(precision + extra + 8) absolutely
+        if (!r.isZero() && r.order() >= -static_cast<int64_t>(extra) - 4) {
+            quadrant = static_cast<int>((k & BigInteger(3)).toInt64());
+            return r.roundToPrecision(precision + 8);
+        }
+        extra = r.isZero() ? extra + precision : leadingZeros(r) + 8;
+    }
+}
+
+/// atan x for |x| < 1, to about @p precision significant bits
+BigFloat atanSmall(const BigFloat& x, size_t precision) {
+    // atan x = x - x^3/3 agrees with x to precision
+    if (x.isZero() || x.order() * -2 > static_cast<int64_t>(precision)) {
+        return x;
+    }
+
+    // atan x = 2 atan(x / (1 + sqrt(1 + x^2))); a halving costs a square
+    // root and a division, so take fewer than for exp
+    const size_t halvings = halvingsFor(precision, x.order()) / 4;
+    const size_t bits = precision + halvings + 16 + leadingZeros(x);
+    BigFloat y = x;
+    for (size_t i = 0; i < halvings; ++i) {
+        const BigFloat root = BigFloat::sqrt(BigFloat::add(one(), BigFloat::multiply(y, y, bits), bits), bits);
+        y = BigFloat::divide(y, BigFloat::add(one(), root, bits), bits);
+    }
+
+    // y - y^3/3 + y^5/5 - ...
+    const BigInteger fixed = toFixed(y, bits);
+    const BigInteger square = fixedMultiply(fixed, fixed, bits);
+    BigInteger power = fixed;
+    BigInteger sum = fixed;
+    for (long long n = 3;; n += 2) {
+        power = fixedMultiply(power, square, bits);
+        BigInteger term = power / BigInteger(n);
+        if (term.isZero()) {
+            break;
+        }
+        if (n % 4 == 1) {
+            sum += term;
+        } else {
+            sum -= term;
+        }
+    }
+    return fromFixed(std::move(sum), bits).scaled(static_cast<int64_t>(halvings));
+}
+
+} // anonymous namespace
+
+//=============================================================================
+// Constants
+//=============================================================================
+
+BigFloat BigFloatFunctions::pi(size_t precision) {
+    static thread_local ConstantCache cache;
+    return cachedConstant(cache, precision, &piFixed);
+}
+
+BigFloat BigFloatFunctions::ln2(size_t precision) {
+    static thread_local ConstantCache cache;
+    return cachedConstant(cache, precision, &ln2Fixed);
+}
+
+BigFloat BigFloatFunctions::e(size_t precision) {
+    return exp(one(), precision);
+}
+
+//=============================================================================
+// Exponentials and logarithms
+//=============================================================================
+
+BigFloat BigFloatFunctions::exp(const BigFloat& x, size_t precision) {
+    if (x.isZero()) {
+        return one();
+    }
+    if (x.order() > EXP_ARGUMENT_ORDER) {
+        if (x.isNegative()) {
+            return BigFloat();
+        }
+        throw std::overflow_error("Numeric overflow");
+    }
+
+    // x = k ln 2 + r with |r| <= ln 2 / 2, and e^x = e^r 2^k
+    const size_t working = precision + GUARD_BITS;
+    const long long k = std::llround(x.toDouble() / std::log(2.0));
+    if (k > MAX_ORDER) {
+        throw std::overflow_error("Numeric overflow");
+    }
+    if (k < -MAX_ORDER) {
+        return BigFloat();
+    }
+    BigFloat r = x;
+    if (k != 0) {
+        const BigFloat ln2Value = ln2(working + bitLength(static_cast<uint64_t>(std::llabs(k))) + 8);
+        r = BigFloat::subtract(x, BigFloat(BigInteger(k)) * ln2Value, working + 8);
+    }
+    return expSmall(r, working).scaled(k).roundToPrecision(precision);
+}
+
+BigFloat BigFloatFunctions::log(const BigFloat& x, size_t precision) {
+    if (x.sign() <= 0) {
+        throw std::domain_error("Logarithm of a non-positive number");
+    }
+    if (x == one()) {
+        return BigFloat();
+    }
+    const size_t working = precision + GUARD_BITS;
+
+    // x = m 2^e with 3/4 < m <= 3/2, so log x = e ln 2 + log m with |log m| < 0.41
+    int64_t e = x.order() - 1;
+    BigFloat m = x.scaled(-e);
+    if (m > BigFloat(BigInteger(3), -1)) {
+        ++e;
+        m = m.scaled(-1);
+    }
+
+    BigFloat y;
+    const BigFloat delta = m - one();
+    if (!delta.isZero()) {
+        // log m is about m - 1, so a leading zero of m - 1 is a bit lost to cancellation
+        const size_t zeros = leadingZeros(delta);
+        y = delta.order() < -1000 ? delta : BigFloat::fromDouble(std::log1p(delta.toDouble()));
+
+        // Halley's iteration y += 2 (m - e^y) / (m + e^y) triples the correct bits per step
+        for (size_t correct = 48; correct < working;) {
+            correct = std::min(correct * 3, working);
+            const size_t bits = correct + zeros + 16;
+            const BigFloat power = exp(y, bits);
+            const BigFloat step = BigFloat::divide(BigFloat::subtract(m, power, bits),
+                                                   BigFloat::add(m, power, bits), bits);
+            y = BigFloat::add(y, step.scaled(1), bits);
+        }
+    }
+
+    if (e == 0) {
+        return y.roundToPrecision(precision);
+    }
+    const BigFloat ln2Value = ln2(working + bitLength(static_cast<uint64_t>(e < 0 ? -e : e)) + 4);
+    return BigFloat::add(BigFloat(BigInteger(e)) * ln2Value, y, working).roundToPrecision(precision);
+}
+
+BigFloat BigFloatFunctions::log10(const BigFloat& x, size_t precision) {
+    // 10^n = 5^n 2^n, odd part 5^n: give exact powers of ten exact results
+    if (x.sign() > 0 && x.getExponent() >= 0) {
+        const int64_t n = x.getExponent();
+        const double fiveBits = static_cast<double>(n) * std::log2(5.0);
+        if (std::fabs(static_cast<double>(x.getMantissa().bitLength()) - fiveBits) < 2.0 &&
+            x.getMantissa() == BigInteger::pow(BigInteger(5), static_cast<uint64_t>(n))) {
+            return BigFloat(BigInteger(n));
+        }
+    }
+    const size_t working = precision + GUARD_BITS;
+    return BigFloat::divide(log(x, working), log(BigFloat(BigInteger(10)), working), precision);
+}
+
+BigFloat BigFloatFunctions::pow(const BigFloat& x, const BigFloat& y, size_t precision) {
+    if (y.isZero()) {
+        return one();
+    }
+    if (x.isZero()) {
+        if (y.isNegative()) {
+            throw std::domain_error("Zero to a negative power");
+        }
+        return BigFloat();
+    }
+    const size_t working = precision + GUARD_BITS;
+
+    if (y.isInteger() && y.order() <= 32) {
+        const int64_t n = y.toInteger().toInt64();
+        const auto count = static_cast<uint64_t>(n < 0 ? -n : n);
+
+        // |log2 |x|| is at least this, so the result's order is at least count times it
+        const int64_t order = x.order();
+        const int64_t minimumBits = order >= 2 ? order - 1 : (order <= 0 ? -order : 0);
+        if (static_cast<double>(minimumBits) * static_cast<double>(count) >
+            static_cast<double>(MAX_ORDER)) {
+            if ((order >= 2) != (n < 0)) {
+                throw std::overflow_error("Numeric overflow");
+            }
+            return BigFloat();
+        }
+
+        // Repeated squaring, exact while the powers fit; each rounding costs a bit
+        const size_t bits = working + 2 * bitLength(count);
+        BigFloat result = one();
+        BigFloat square = x;
+        for (uint64_t remaining = count; remaining != 0; remaining >>= 1) {
+            if ((remaining & 1) != 0) {
+                result = BigFloat::multiply(result, square, bits);
+            }
+            if (remaining > 1) {
+                square = BigFloat::multiply(square, square, bits);
+            }
+        }
+        return n < 0 ? BigFloat::divide(one(), result, precision) : result.roundToPrecision(precision);
+    }
+
+    BigFloat base = x;
+    bool negate = false;
+    if (x.isNegative()) {
+        if (!y.isInteger()) {
+            throw std::domain_error("Negative base to a fractional power");
+        }
+        // Normalized, only an odd integer has exponent zero
+        negate = y.getExponent() == 0;
+        base = -x;
+    }
+
+    // x^y = e^(y log x): the integer bits of y log x are lost from the
+    // result's precision, so the logarithm carries them as well
+    BigFloat product = BigFloat::multiply(y, log(base, working), working);
+    if (product.order() > EXP_ARGUMENT_ORDER) {
+        if (product.isNegative()) {
+            return BigFloat();
+        }
+        throw std::overflow_error("Numeric overflow");
+    }
+    if (product.order() > 0) {
+        const size_t bits = working + toSize(product.order());
+        product = BigFloat::multiply(y, log(base, bits), bits);
+    }
+    BigFloat result = exp(product, precision);
+    return negate ? -result : result;
+}
+
+BigFloat BigFloatFunctions::hypot(const BigFloat& x, const BigFloat& y, size_t precision) {
+    return BigFloat::sqrt(x * x + y * y, precision);
+}
+
+//=============================================================================
+// Trigonometric functions
+//=============================================================================
+
+BigFloat BigFloatFunctions::sin(const BigFloat& x, size_t precision) {
+    const size_t working = precision + GUARD_BITS;
+    int quadrant = 0;
+    const BigFloat r = reduceQuarterTurns(x, working, quadrant);
+    BigFloat sine;
+    BigFloat cosine;
+    sinCosSmall(r, working, sine, cosine);
+    switch (quadrant) {
+        case 0: return sine.roundToPrecision(precision);
+        case 1: return cosine.roundToPrecision(precision);
+        case 2: return (-sine).roundToPrecision(precision);
+        default: return (-cosine).roundToPrecision(precision);
+    }
+}
+
+BigFloat BigFloatFunctions::cos(const BigFloat& x, size_t precision) {
+    const size_t working = precision + GUARD_BITS;
+    int quadrant = 0;
+    const BigFloat r = reduceQuarterTurns(x, working, quadrant);
+    BigFloat sine;
+    BigFloat cosine;
+    sinCosSmall(r, working, sine, cosine);
+    switch (quadrant) {
+        case 0: return cosine.roundToPrecision(precision);
+        case 1: return (-sine).roundToPrecision(precision);
+        case 2: return (-cosine).roundToPrecision(precision);
+        default: return sine.roundToPrecision(precision);
+    }
+}
+
+BigFloat BigFloatFunctions::tan(const BigFloat& x, size_t precision) {
+    const size_t working = precision + GUARD_BITS;
+    int quadrant = 0;
+    const BigFloat r = reduceQuarterTurns(x, working, quadrant);
+    BigFloat sine;
+    BigFloat cosine;
+    sinCosSmall(r, working, sine, cosine);
+    // tan(r + pi/2) = -cos r / sin r
+    if (quadrant % 2 == 0) {
+        return BigFloat::divide(sine, cosine, precision);
+    }
+    return BigFloat::divide(-cosine, sine, precision);
+}
+
+BigFloat BigFloatFunctions::atan(const BigFloat& x, size_t precision) {
+    const size_t working = precision + GUARD_BITS;
+    const int comparison = BigFloat::compare(x.abs(), one());
+    if (comparison < 0) {
+        return atanSmall(x, working).roundToPrecision(precision);
+    }
+
+    BigFloat quarterPi = pi(working).scaled(-2);
+    if (x.isNegative()) {
+        quarterPi = -quarterPi;
+    }
+    if (comparison == 0) {
+        return quarterPi.roundToPrecision(precision);
+    }
+    // atan x = +-pi/2 - atan(1/x)
+    const BigFloat inverse = BigFloat::divide(one(), x, working + 8);
+    return BigFloat::subtract(quarterPi.scaled(1), atanSmall(inverse, working), precision);
+}
+
+BigFloat BigFloatFunctions::asin(const BigFloat& x, size_t precision) {
+    const int comparison = BigFloat::compare(x.abs(), one());
+    if (comparison > 0) {
+        throw std::domain_error("Argument out of domain");
+    }
+    if (comparison == 0) {
+        const BigFloat halfPi = pi(precision).scaled(-1);
+        return x.isNegative() ? -halfPi : halfPi;
+    }
+    // asin x = atan(x / sqrt((1 - x)(1 + x)))
+    const size_t working = precision + GUARD_BITS;
+    const BigFloat cosine = BigFloat::sqrt((one() - x) * (one() + x), working);
+    return atan(BigFloat::divide(x, cosine, working), precision);
+}
+
+BigFloat BigFloatFunctions::acos(const BigFloat& x, size_t precision) {
+    const int comparison = BigFloat::compare(x.abs(), one());
+    if (comparison > 0) {
+        throw std::domain_error("Argument out of domain");
+    }
+    if (comparison == 0) {
+        return x.isNegative() ? pi(precision) : BigFloat();
+    }
+    // acos x = 2 atan(sqrt((1 - x) / (1 + x)))
+    const size_t working = precision + GUARD_BITS;
+    const BigFloat ratio = BigFloat::divide(one() - x, one() + x, working);
+    return atan(BigFloat::sqrt(ratio, working), precision).scaled(1);
+}
+
+//=============================================================================
+// Hyperbolic functions
+//=============================================================================
+
+BigFloat BigFloatFunctions::sinh(const BigFloat& x, size_t precision) {
+    const size_t working = precision + GUARD_BITS;
+    // sinh x = x + x^3/6 agrees with x to precision
+    if (x.isZero() || x.order() * -2 > static_cast<int64_t>(working)) {
+        return x.roundToPrecision(precision);
+    }
+    // (e^x - e^-x) / 2 cancels the leading zeros of a small x
+    const size_t bits = working + leadingZeros(x);
+    const BigFloat power = exp(x.abs(), bits);
+    const BigFloat result =
+        BigFloat::subtract(power, BigFloat::divide(one(), power, bits), precision).scaled(-1);
+    return x.isNegative() ? -result : result;
+}
+
+BigFloat BigFloatFunctions::cosh(const BigFloat& x, size_t precision) {
+    const size_t working = precision + GUARD_BITS;
+    const BigFloat power = exp(x.abs(), working);
+    return BigFloat::add(power, BigFloat::divide(one(), power, working), precision).scaled(-1);
+}
+
+BigFloat BigFloatFunctions::tanh(const BigFloat& x, size_t precision) {
+    const size_t working = precision + GUARD_BITS;
+    if (x.isZero() || x.order() * -2 > static_cast<int64_t>(working)) {
+        return x.roundToPrecision(precision);
+    }
+    // 1 - tanh |x| is about 2 e^(-2|x|), below the precision once |x| exceeds it
+    if (x.order() > static_cast<int64_t>(bitLength(working))) {
+        return x.isNegative() ? -one() : one();
+    }
+    // (e^2x - 1) / (e^2x + 1)
+    const size_t bits = working + leadingZeros(x);
+    const BigFloat power = exp(x.abs().scaled(1), bits);
+    const BigFloat result = BigFloat::divide(BigFloat::subtract(power, one(), bits),
+                                             BigFloat::add(power, one(), bits), precision);
+    return x.isNegative() ? -result : result;
+}
+
+} // namespace calc
@@ -0,0 +1,1085 @@
+/**
+ * @file big_integer.cpp
+ * @brief Arbitrary-precision integer implementation
+ */
+
+#include "calc/math/big_integer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace calc {
+
+namespace {
+
+using Limb = BigInteger::Limb;
+using Wide = uint64_t;
+using LimbVector = std::vector<Limb>;
+
+constexpr unsigned LIMB_BITS = BigInteger::LIMB_BITS;
+constexpr Wide LIMB_BASE = Wide{1} << LIMB_BITS;
+
+/// 10^9, the largest power of ten in a limb
+constexpr Limb DECIMAL_LIMB_BASE = 1000000000;
+
+constexpr const char* DIGIT_CHARS = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+//=============================================================================
+// Limb array primitives
+//
+// Magnitudes are (pointer, length) pairs, least significant limb first.
+// Outputs may alias the first input where noted.
+//=============================================================================
+
+size_t trimmedLength(const Limb* a, size_t n) noexcept {
+    while (n > 0 && a[n - 1] == 0) {
+        --n;
+    }
+    return n;
+}
+
+unsigned leadingZeros(Limb x) noexcept {
+    unsigned count = 0;
+    for (Limb bit = Limb{1} << (LIMB_BITS - 1); bit != 0 && (x & bit) == 0; bit >>= 1) {
+        ++count;
+    }
+    return count;
+}
+
+/// Compare two trimmed magnitudes
+int compareLimbs(const Limb* a, size_t an, const Limb* b, size_t bn) noexcept {
+    if (an != bn) {
+        return an < bn ? -1 : 1;
+    }
+    for (size_t i = an; i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/// r[0, an) = a + b for an >= bn, returning the carry out; r may alias a or b
+Limb addLimbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) noexcept {
+    Wide carry = 0;
+    size_t i = 0;
+    for (; i < bn; ++i) {
+        carry += Wide{a[i]} + b[i];
+        r[i] = static_cast<Limb>(carry);
+        carry >>= LIMB_BITS;
+    }
+    for (; i < an; ++i) {
+        carry += a[i];
+        r[i] = static_cast<Limb>(carry);
+        carry >>= LIMB_BITS;
+    }
+    return static_cast<Limb>(carry);
+}
+
+/// r[0, an) = a - b for a >= b and an >= bn, returning the borrow out; r may alias a or b
+Limb subLimbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) noexcept {
+    Limb borrow = 0;
+    size_t i = 0;
+    for (; i < bn; ++i) {
+        Wide diff = Wide{a[i]} - b[i] - borrow;
+        r[i] = static_cast<Limb>(diff);
+        borrow = static_cast<Limb>(diff >> 63);  // Wrapped below zero
+    }
+    for (; i < an; ++i) {
+        Wide diff = Wide{a[i]} - borrow;
+        r[i] = static_cast<Limb>(diff);
+        borrow = static_cast<Limb>(diff >> 63);
+    }
+    return borrow;
+}
+
+/// r[0, rn) += b for bn <= rn; the sum must fit
+void addInto(Limb* r, size_t rn, const Limb* b, size_t bn) noexcept {
+    Limb carry = addLimbs(r, r, bn, b, bn);
+    for (size_t i = bn; carry != 0 && i < rn; ++i) {
+        carry = ++r[i] == 0 ? 1 : 0;
+    }
+}
+
+/// r[0, rn) -= b for bn <= rn; the difference must not be negative
+void subtractFrom(Limb* r, size_t rn, const Limb* b, size_t bn) noexcept {
+    Limb borrow = subLimbs(r, r, bn, b, bn);
+    for (size_t i = bn; borrow != 0 && i < rn; ++i) {
+        borrow = r[i]-- == 0 ? 1 : 0;
+    }
+}
+
+/// r[0, n) = a * m + add, returning the carry out; r may alias a
+Limb multiplySmall(Limb* r, const Limb* a, size_t n, Limb m, Limb add) noexcept {
+    Wide carry = add;
+    for (size_t i = 0; i < n; ++i) {
+        carry += Wide{a[i]} * m;
+        r[i] = static_cast<Limb>(carry);
+        carry >>= LIMB_BITS;
+    }
+    return static_cast<Limb>(carry);
+}
+
+/// r[0, n) += a * m, returning the carry out
+Limb multiplyAddSmall(Limb* r, const Limb* a, size_t n, Limb m) noexcept {
+    Wide carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        carry += Wide{a[i]} * m + r[i];
+        r[i] = static_cast<Limb>(carry);
+        carry >>= LIMB_BITS;
+    }
+    return static_cast<Limb>(carry);
+}
+
+/// q[0, n) = a / d, returning a % d; q may alias a
+Limb divideSmall(Limb* q, const Limb* a, size_t n, Limb d) noexcept {
+    Wide remainder = 0;
+    for (size_t i = n; i-- > 0;) {
+        Wide current = (remainder << LIMB_BITS) | a[i];
+        q[i] = static_cast<Limb>(current / d);
+        remainder = current % d;
+    }
+    return static_cast<Limb>(remainder);
+}
+
+/// divideSmall() by a compile-time constant, which the compiler turns into a multiply and shift
+template <Limb D>
+Limb divideByConstant(Limb* q, const Limb* a, size_t n) noexcept {
+    Wide remainder = 0;
+    for (size_t i = n; i-- > 0;) {
+        Wide current = (remainder << LIMB_BITS) | a[i];
+        q[i] = static_cast<Limb>(current / D);
+        remainder = current % D;
+    }
+    return static_cast<Limb>(remainder);
+}
+
+void multiplyLimbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn);
+
+/// r[0, an + bn) = a * b, one row per limb of b
+void multiplySchoolbook(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    std::fill(r, r + an + bn, 0);
+    for (size_t j = 0; j < bn; ++j) {
+        r[j + an] = multiplyAddSmall(r + j, a, an, b[j]);
+    }
+}
+
+/**
+ * @brief r[0, an + bn) = a * b by Karatsuba, for bn <= an < 2 * bn
+ *
+ * With a = a1 B^m + a0 and b = b1 B^m + b0, the product is
+ * z2 B^2m + z1 B^m + z0 where z0 = a0 b0, z2 = a1 b1 and
+ * z1 = (a0 + a1)(b0 + b1) - z0 - z2: three half-size products instead of four.
+ */
+void multiplyKaratsuba(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    const size_t m = an / 2;
+    const size_t rn = an + bn;
+    const Limb* a1 = a + m;
+    const Limb* b1 = b + m;
+    const size_t a1n = an - m;
+    const size_t b1n = bn - m;
+    const size_t a0n = trimmedLength(a, m);
+    const size_t b0n = trimmedLength(b, m);
+
+    // z0 and z2 go straight to their places in r
+    multiplyLimbs(r, a, a0n, b, b0n);
+    std::fill(r + a0n + b0n, r + 2 * m, 0);
+    multiplyLimbs(r + 2 * m, a1, a1n, b1, b1n);
+
+    LimbVector sumA(a1n + 1);
+    sumA[a1n] = addLimbs(sumA.data(), a1, a1n, a, a0n);
+    LimbVector sumB(std::max(b1n, b0n) + 1);
+    if (b1n >= b0n) {
+        sumB[b1n] = addLimbs(sumB.data(), b1, b1n, b, b0n);
+    } else {
+        sumB[b0n] = addLimbs(sumB.data(), b, b0n, b1, b1n);
+    }
+    const size_t sumAn = trimmedLength(sumA.data(), sumA.size());
+    const size_t sumBn = trimmedLength(sumB.data(), sumB.size());
+
+    LimbVector middle(sumAn + sumBn);
+    multiplyLimbs(middle.data(), sumA.data(), sumAn, sumB.data(), sumBn);
+    subtractFrom(middle.data(), middle.size(), r, trimmedLength(r, 2 * m));
+    subtractFrom(middle.data(), middle.size(), r + 2 * m, trimmedLength(r + 2 * m, rn - 2 * m));
+    addInto(r + m, rn - m, middle.data(), trimmedLength(middle.data(), middle.size()));
+}
+
+/// r[0, an + bn) = a * b; r must not overlap a or b
+void multiplyLimbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    if (bn == 0) {
+        std::fill(r, r + an, 0);
+        return;
+    }
+    if (bn < BigInteger::KARATSUBA_THRESHOLD) {
+        multiplySchoolbook(r, a, an, b, bn);
+        return;
+    }
+    if (an >= 2 * bn) {
+        // Karatsuba needs halves of similar size: take a in slices of bn limbs
+        std::fill(r, r + an + bn, 0);
+        LimbVector slice(2 * bn);
+        for (size_t offset = 0; offset < an; offset += bn) {
+            const size_t sliceLength = trimmedLength(a + offset, std::min(bn, an - offset));
+            multiplyLimbs(slice.data(), a + offset, sliceLength, b, bn);
+            addInto(r + offset, an + bn - offset, slice.data(), sliceLength + bn);
+        }
+        return;
+    }
+    multiplyKaratsuba(r, a, an, b, bn);
+}
+
+/**
+ * @brief Knuth's algorithm D: q = u / v and r = u % v
+ *
+ * For un >= vn >= 2 with v's top limb nonzero. q gets un - vn + 1 limbs
+ * and r gets vn.
+ */
+void divideKnuth(Limb* q, Limb* r, const Limb* u, size_t un, const Limb* v, size_t vn) {
+    // Normalize so the divisor's top bit is set, which keeps each
+    // quotient limb estimate at most two too large
+    const unsigned shift = leadingZeros(v[vn - 1]);
+    LimbVector vs(vn);
+    LimbVector us(un + 1);
+    if (shift == 0) {
+        std::copy(v, v + vn, vs.begin());
+        std::copy(u, u + un, us.begin());
+        us[un] = 0;
+    } else {
+        for (size_t i = vn - 1; i > 0; --i) {
+            vs[i] = (v[i] << shift) | (v[i - 1] >> (LIMB_BITS - shift));
+        }
+        vs[0] = v[0] << shift;
+        us[un] = u[un - 1] >> (LIMB_BITS - shift);
+        for (size_t i = un - 1; i > 0; --i) {
+            us[i] = (u[i] << shift) | (u[i - 1] >> (LIMB_BITS - shift));
+        }
+        us[0] = u[0] << shift;
+    }
+
+    const Wide top = vs[vn - 1];
+    const Wide next = vs[vn - 2];
+    for (size_t j = un - vn + 1; j-- > 0;) {
+        // Estimate from the top two limbs, then correct with the third
+        Wide numerator = (Wide{us[j + vn]} << LIMB_BITS) | us[j + vn - 1];
+        Wide qhat = numerator / top;
+        Wide rhat = numerator % top;
+        while (qhat >= LIMB_BASE || qhat * next > ((rhat << LIMB_BITS) | us[j + vn - 2])) {
+            --qhat;
+            rhat += top;
+            if (rhat >= LIMB_BASE) {
+                break;
+            }
+        }
+
+        // Multiply and subtract
+        int64_t borrow = 0;
+        int64_t difference = 0;
+        for (size_t i = 0; i < vn; ++i) {
+            Wide product = qhat * vs[i];
+            difference = static_cast<int64_t>(us[i + j]) - borrow
+                       - static_cast<int64_t>(product & 0xFFFFFFFFu);
+            us[i + j] = static_cast<Limb>(difference);
+            borrow = static_cast<int64_t>(product >> LIMB_BITS) - (difference >> LIMB_BITS);
+        }
+        difference = static_cast<int64_t>(us[j + vn]) - borrow;
+        us[j + vn] = static_cast<Limb>(difference);
+
+        q[j] = static_cast<Limb>(qhat);
+        if (difference < 0) {
+            // The estimate was one too large: add the divisor back
+            --q[j];
+            Wide carry = 0;
+            for (size_t i = 0; i < vn; ++i) {
+                carry += Wide{us[i + j]} + vs[i];
+                us[i + j] = static_cast<Limb>(carry);
+                carry >>= LIMB_BITS;
+            }
+            us[j + vn] = static_cast<Limb>(us[j + vn] + carry);
+        }
+    }
+
+    for (size_t i = 0; i < vn; ++i) {
+        r[i] = shift == 0 ? us[i] : (us[i] >> shift) | (us[i + 1] << (LIMB_BITS - shift));
+    }
+}
+
+/// 64 bits of a magnitude starting at bit @p position, zero past the top
+Wide bitsAt(const Limb* a, size_t n, size_t position) noexcept {
+    auto limbAt = [&](size_t i) -> Wide { return i < n ? a[i] : 0; };
+    const size_t index = position / LIMB_BITS;
+    const unsigned offset = static_cast<unsigned>(position % LIMB_BITS);
+    Wide bits = limbAt(index) | (limbAt(index + 1) << LIMB_BITS);
+    if (offset != 0) {
+        bits = (bits >> offset) | (limbAt(index + 2) << (2 * LIMB_BITS - offset));
+    }
+    return bits;
+}
+
+/// Two's complement negation in place, modulo 2^(32 * size)
+void negateTwos(LimbVector& limbs) noexcept {
+    Limb carry = 1;
+    for (Limb& limb : limbs) {
+        limb = ~limb + carry;
+        carry = (carry != 0 && limb == 0) ? 1 : 0;
+    }
+}
+
+/// Digit value of a character in any base up to 36, or 36 if it is not a digit
+unsigned digitValue(char c) noexcept {
+    if (c >= '0' && c <= '9') {
+        return static_cast<unsigned>(c - '0');
+    }
+    if (c >= 'a' && c <= 'z') {
+        return static_cast<unsigned>(c - 'a') + 10;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<unsigned>(c - 'A') + 10;
+    }
+    return 36;
+}
+
+/// Bits per digit of a power-of-two base, or 0 for other bases
+unsigned bitsPerDigit(int base) noexcept {
+    switch (base) {
+        case 2:  return 1;
+        case 4:  return 2;
+        case 8:  return 3;
+        case 16: return 4;
+        case 32: return 5;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief How a base that is not a power of two packs into limbs
+ *
+ * A limb holds digitsPerLimb digits: limbBase = base^digitsPerLimb is the
+ * largest such power below 2^32.
+ */
+struct Radix {
+    Limb base;
+    Limb limbBase;
+    size_t digitsPerLimb;
+
+    explicit Radix(int radix) : base(static_cast<Limb>(radix)), limbBase(1), digitsPerLimb(0) {
+        while (Wide{limbBase} * base < LIMB_BASE) {
+            limbBase *= base;
+            ++digitsPerLimb;
+        }
+    }
+};
+
+void checkBase(int base) {
+    if (base < 2 || base > 36) {
+        throw std::invalid_argument("Base must be between 2 and 36");
+    }
+}
+
+} // anonymous namespace
+
+//=============================================================================
+// Construction and storage
+//=============================================================================
+
+BigInteger::BigInteger() noexcept
+    : size_(0), capacity_(INLINE_LIMBS), negative_(false), inline_{} {}
+
+BigInteger::BigInteger(long long value) noexcept
+    : size_(2), capacity_(INLINE_LIMBS), negative_(value < 0), inline_{} {
+    const auto magnitude = negative_ ? 0 - static_cast<unsigned long long>(value)
+                                     : static_cast<unsigned long long>(value);
+    inline_[0] = static_cast<Limb>(magnitude);
+    inline_[1] = static_cast<Limb>(magnitude >> LIMB_BITS);
+    normalize();
+}
+
+BigInteger BigInteger::fromUnsigned(unsigned long long value) noexcept {
+    BigInteger result;
+    result.size_ = 2;
+    result.inline_[0] = static_cast<Limb>(value);
+    result.inline_[1] = static_cast<Limb>(value >> LIMB_BITS);
+    result.normalize();
+    return result;
+}
+
+BigInteger BigInteger::fromDouble(double value) {
+    if (!std::isfinite(value) || std::trunc(value) != value) {
+        throw std::invalid_argument("Not an integer");
+    }
+
+    constexpr double TWO_POW_63 = 9223372036854775808.0;
+    if (std::fabs(value) < TWO_POW_63) {
+        return BigInteger(static_cast<long long>(value));
+    }
+
+    // value = fraction * 2^exponent with the fraction's 53 bits whole after scaling
+    int exponent = 0;
+    double fraction = std::frexp(std::fabs(value), &exponent);
+    BigInteger result = fromUnsigned(static_cast<unsigned long long>(std::ldexp(fraction, 53)));
+    result <<= static_cast<size_t>(exponent - 53);
+    if (value < 0.0) {
+        result.negative_ = true;
+    }
+    return result;
+}
+
+BigInteger BigInteger::fromLimbs(const Limb* limbs, size_t count, bool negative) {
+    BigInteger result;
+    result.resize(count);
+    std::copy(limbs, limbs + count, result.limbs());
+    result.negative_ = negative;
+    result.normalize();
+    return result;
+}
+
+BigInteger BigInteger::powerOfTwo(size_t exponent) {
+    BigInteger result;
+    result.resize(exponent / LIMB_BITS + 1);
+    result.limbs()[exponent / LIMB_BITS] = Limb{1} << (exponent % LIMB_BITS);
+    return result;
+}
+
+BigInteger::BigInteger(const BigInteger& other)
+    : size_(other.size_), capacity_(INLINE_LIMBS), negative_(other.negative_), inline_{} {
+    if (size_ > INLINE_LIMBS) {
+        heap_ = new Limb[size_];
+        capacity_ = size_;
+    }
+    std::copy(other.limbs(), other.limbs() + size_, limbs());
+}
+
+BigInteger::BigInteger(BigInteger&& other) noexcept
+    : size_(other.size_), capacity_(other.capacity_), negative_(other.negative_), inline_{} {
+    if (other.isInline()) {
+        std::copy(other.inline_, other.inline_ + size_, inline_);
+    } else {
+        heap_ = other.heap_;
+        other.capacity_ = INLINE_LIMBS;
+    }
+    other.size_ = 0;
+    other.negative_ = false;
+}
+
+BigInteger& BigInteger::operator=(const BigInteger& other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (other.size_ > capacity_) {
+        *this = BigInteger(other);
+        return *this;
+    }
+    std::copy(other.limbs(), other.limbs() + other.size_, limbs());
+    size_ = other.size_;
+    negative_ = other.negative_;
+    return *this;
+}
+
+BigInteger& BigInteger::operator=(BigInteger&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    if (!isInline()) {
+        delete[] heap_;
+    }
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    negative_ = other.negative_;
+    if (other.isInline()) {
+        std::copy(other.inline_, other.inline_ + size_, inline_);
+    } else {
+        heap_ = other.heap_;
+        other.capacity_ = INLINE_LIMBS;
+    }
+    other.size_ = 0;
+    other.negative_ = false;
+    return *this;
+}
+
+BigInteger::~BigInteger() {
+    if (!isInline()) {
+        delete[] heap_;
+    }
+}
+
+void BigInteger::reserve(size_t count) {
+    if (count <= capacity_) {
+        return;
+    }
+    if (count > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Integer too large");
+    }
+    const size_t capacity = std::min<size_t>(std::max<size_t>(count, size_t{2} * capacity_),
+                                             std::numeric_limits<uint32_t>::max());
+    Limb* block = new Limb[capacity];
+    std::copy(limbs(), limbs() + size_, block);
+    if (!isInline()) {
+        delete[] heap_;
+    }
+    heap_ = block;
+    capacity_ = static_cast<uint32_t>(capacity);
+}
+
+void BigInteger::resize(size_t count) {
+    reserve(count);
+    if (count > size_) {
+        std::fill(limbs() + size_, limbs() + count, 0);
+    }
+    size_ = static_cast<uint32_t>(count);
+}
+
+void BigInteger::normalize() noexcept {
+    size_ = static_cast<uint32_t>(trimmedLength(limbs(), size_));
+    if (size_ == 0) {
+        negative_ = false;
+    }
+}
+
+//=============================================================================
+// Queries
+//=============================================================================
+
+size_t BigInteger::bitLength() const noexcept {
+    if (size_ == 0) {
+        return 0;
+    }
+    return size_t{size_} * LIMB_BITS - leadingZeros(limbs()[size_ - 1]);
+}
+
+bool BigInteger::testBit(size_t index) const noexcept {
+    const size_t limb = index / LIMB_BITS;
+    return limb < size_ && ((limbs()[limb] >> (index % LIMB_BITS)) & 1) != 0;
+}
+
+size_t BigInteger::lowestSetBit() const noexcept {
+    const Limb* magnitude = limbs();
+    for (size_t i = 0; i < size_; ++i) {
+        if (magnitude[i] != 0) {
+            size_t index = i * LIMB_BITS;
+            for (Limb limb = magnitude[i]; (limb & 1) == 0; limb >>= 1) {
+                ++index;
+            }
+            return index;
+        }
+    }
+    return 0;
+}
+
+bool BigInteger::fitsInt64() const noexcept {
+    if (size_ <= 1) {
+        return true;
+    }
+    if (size_ > 2) {
+        return false;
+    }
+    const Wide magnitude = bitsAt(limbs(), size_, 0);
+    const Wide limit = Wide{1} << 63;
+    return negative_ ? magnitude <= limit : magnitude < limit;
+}
+
+int64_t BigInteger::toInt64() const noexcept {
+    const Wide magnitude = bitsAt(limbs(), size_, 0);
+    return static_cast<int64_t>(negative_ ? 0 - magnitude : magnitude);
+}
+
+double BigInteger::toDouble() const noexcept {
+    double magnitude = 0.0;
+    const size_t bits = bitLength();
+    if (bits <= 64) {
+        magnitude = static_cast<double>(bitsAt(limbs(), size_, 0));
+    } else if (bits > static_cast<size_t>(std::numeric_limits<double>::max_exponent)) {
+        magnitude = std::numeric_limits<double>::infinity();
+    } else {
+        // The top 64 bits, with the lowest set if anything below them is,
+        // round to 53 bits exactly as the whole value would
+        const size_t shift = bits - 64;
+        Wide top = bitsAt(limbs(), size_, shift);
+        const Limb* low = limbs();
+        bool sticky = (low[shift / LIMB_BITS] & ((Limb{1} << (shift % LIMB_BITS)) - 1)) != 0;
+        for (size_t i = 0; !sticky && i < shift / LIMB_BITS; ++i) {
+            sticky = low[i] != 0;
+        }
+        if (sticky) {
+            top |= 1;
+        }
+        magnitude = std::ldexp(static_cast<double>(top), static_cast<int>(shift));
+    }
+    return negative_ ? -magnitude : magnitude;
+}
+
+int BigInteger::compare(const BigInteger& a, const BigInteger& b) noexcept {
+    if (a.negative_ != b.negative_) {
+        return a.negative_ ? -1 : 1;
+    }
+    int magnitude = compareLimbs(a.limbs(), a.size_, b.limbs(), b.size_);
+    return a.negative_ ? -magnitude : magnitude;
+}
+
+BigInteger BigInteger::wrap(size_t bits, bool isSigned) const {
+    if (bits == 0) {
+        return *this;
+    }
+
+    // The low bits of the two's complement value
+    const size_t count = (bits + LIMB_BITS - 1) / LIMB_BITS;
+    const unsigned topBits = static_cast<unsigned>(bits - (count - 1) * LIMB_BITS);
+    const Limb topMask = topBits == LIMB_BITS ? ~Limb{0} : (Limb{1} << topBits) - 1;
+    LimbVector word(count, 0);
+    std::copy(limbs(), limbs() + std::min<size_t>(size_, count), word.begin());
+    if (negative_) {
+        negateTwos(word);
+    }
+    word[count - 1] &= topMask;
+
+    const bool signBit = ((word[count - 1] >> (topBits - 1)) & 1) != 0;
+    if (isSigned && signBit) {
+        // word - 2^bits = -(2^bits - word)
+        negateTwos(word);
+        word[count - 1] &= topMask;
+        return fromLimbs(word.data(), count, true);
+    }
+    return fromLimbs(word.data(), count, false);
+}
+
+//=============================================================================
+// Arithmetic
+//=============================================================================
+
+BigInteger BigInteger::operator-() const {
+    BigInteger result(*this);
+    if (result.size_ != 0) {
+        result.negative_ = !result.negative_;
+    }
+    return result;
+}
+
+BigInteger BigInteger::operator~() const {
+    BigInteger result = -*this;
+    result -= 1;
+    return result;
+}
+
+void BigInteger::addSigned(const BigInteger& other, bool subtract) {
+    if (other.size_ == 0) {
+        return;
+    }
+    if (this == &other) {
+        BigInteger copy(other);
+        addSigned(copy, subtract);
+        return;
+    }
+
+    const bool otherNegative = other.negative_ != subtract;
+    const size_t an = size_;
+    const size_t bn = other.size_;
+
+    if (an == 0 || negative_ == otherNegative) {
+        // Same signs: add magnitudes
+        resize(std::max(an, bn) + 1);
+        Limb* r = limbs();
+        if (an >= bn) {
+            r[an] = addLimbs(r, r, an, other.limbs(), bn);
+        } else {
+            r[bn] = addLimbs(r, other.limbs(), bn, r, an);
+        }
+        negative_ = otherNegative;
+        normalize();
+        return;
+    }
+
+    // Opposite signs: subtract the smaller magnitude from the larger
+    int order = compareLimbs(limbs(), an, other.limbs(), bn);
+    if (order == 0) {
+        size_ = 0;
+        negative_ = false;
+    } else if (order > 0) {
+        subLimbs(limbs(), limbs(), an, other.limbs(), bn);
+        normalize();
+    } else {
+        resize(bn);
+        subLimbs(limbs(), other.limbs(), bn, limbs(), an);
+        negative_ = otherNegative;
+        normalize();
+    }
+}
+
+BigInteger& BigInteger::operator+=(const BigInteger& other) {
+    addSigned(other, false);
+    return *this;
+}
+
+BigInteger& BigInteger::operator-=(const BigInteger& other) {
+    addSigned(other, true);
+    return *this;
+}
+
+BigInteger operator*(const BigInteger& a, const BigInteger& b) {
+    BigInteger result;
+    if (a.size_ == 0 || b.size_ == 0) {
+        return result;
+    }
+    result.resize(size_t{a.size_} + b.size_);
+    multiplyLimbs(result.limbs(), a.limbs(), a.size_, b.limbs(), b.size_);
+    result.negative_ = a.negative_ != b.negative_;
+    result.normalize();
+    return result;
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger& other) {
+    *this = *this * other;
+    return *this;
+}
+
+void BigInteger::divMod(const BigInteger& dividend, const BigInteger& divisor,
+                        BigInteger& quotient, BigInteger& remainder) {
+    if (divisor.size_ == 0) {
+        throw std::domain_error("Division by zero");
+    }
+
+    const size_t an = dividend.size_;
+    const size_t bn = divisor.size_;
+    if (compareLimbs(dividend.limbs(), an, divisor.limbs(), bn) < 0) {
+        remainder = dividend;
+        quotient = BigInteger();
+        return;
+    }
+
+    BigInteger q;
+    BigInteger r;
+    if (bn == 1) {
+        q.resize(an);
+        r = fromUnsigned(divideSmall(q.limbs(), dividend.limbs(), an, divisor.limbs()[0]));
+    } else {
+        q.resize(an - bn + 1);
+        r.resize(bn);
+        divideKnuth(q.limbs(), r.limbs(), dividend.limbs(), an, divisor.limbs(), bn);
+    }
+    q.negative_ = dividend.negative_ != divisor.negative_;
+    q.normalize();
+    r.negative_ = dividend.negative_;
+    r.normalize();
+
+    quotient = std::move(q);
+    remainder = std::move(r);
+}
+
+BigInteger& BigInteger::operator/=(const BigInteger& other) {
+    BigInteger remainder;
+    divMod(*this, other, *this, remainder);
+    return *this;
+}
+
+BigInteger& BigInteger::operator%=(const BigInteger& other) {
+    BigInteger quotient;
+    divMod(*this, other, quotient, *this);
+    return *this;
+}
+
+BigInteger BigInteger::pow(const BigInteger& base, uint64_t exponent) {
+    BigInteger result(1);
+    BigInteger square(base);
+    while (exponent != 0) {
+        if ((exponent & 1) != 0) {
+            result *= square;
+        }
+        exponent >>= 1;
+        if (exponent != 0) {
+            square *= square;
+        }
+    }
+    return result;
+}
+
+//=============================================================================
+// Bitwise operators and shifts
+//=============================================================================
+
+void BigInteger::bitwise(const BigInteger& other, char op) {
+    // One limb beyond either magnitude holds the sign
+    const size_t count = std::max(size_, other.size_) + size_t{1};
+    LimbVector a(count, 0);
+    LimbVector b(count, 0);
+    std::copy(limbs(), limbs() + size_, a.begin());
+    std::copy(other.limbs(), other.limbs() + other.size_, b.begin());
+    if (negative_) {
+        negateTwos(a);
+    }
+    if (other.negative_) {
+        negateTwos(b);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        switch (op) {
+            case '&': a[i] &= b[i]; break;
+            case '|': a[i] |= b[i]; break;
+            default:  a[i] ^= b[i]; break;
+        }
+    }
+
+    const bool negative = (a[count - 1] >> (LIMB_BITS - 1)) != 0;
+    if (negative) {
+        negateTwos(a);
+    }
+    *this = fromLimbs(a.data(), count, negative);
+}
+
+BigInteger& BigInteger::operator&=(const BigInteger& other) {
+    bitwise(other, '&');
+    return *this;
+}
+
+BigInteger& BigInteger::operator|=(const BigInteger& other) {
+    bitwise(other, '|');
+    return *this;
+}
+
+BigInteger& BigInteger::operator^=(const BigInteger& other) {
+    bitwise(other, '^');
+    return *this;
+}
+
+BigInteger& BigInteger::operator<<=(size_t count) {
+    if (size_ == 0 || count == 0) {
+        return *this;
+    }
+
+    const size_t limbShift = count / LIMB_BITS;
+    const unsigned bitShift = static_cast<unsigned>(count % LIMB_BITS);
+    const size_t n = size_;
+    resize(n + limbShift + 1);
+    Limb* r = limbs();
+
+    if (bitShift == 0) {
+        for (size_t i = n; i-- > 0;) {
+            r[i + limbShift] = r[i];
+        }
+    } else {
+        r[n + limbShift] = r[n - 1] >> (LIMB_BITS - bitShift);
+        for (size_t i = n - 1; i > 0; --i) {
+            r[i + limbShift] = (r[i] << bitShift) | (r[i - 1] >> (LIMB_BITS - bitShift));
+        }
+        r[limbShift] = r[0] << bitShift;
+    }
+    std::fill(r, r + limbShift, 0);
+    normalize();
+    return *this;
+}
+
+BigInteger& BigInteger::operator>>=(size_t count) {
+    if (negative_) {
+        // Floor division by 2^count: for negative x, ~x = -x - 1 is not negative
+        BigInteger complement = ~*this;
+        complement >>= count;
+        *this = ~complement;
+        return *this;
+    }
+
+    const size_t limbShift = count / LIMB_BITS;
+    if (limbShift >= size_) {
+        size_ = 0;
+        return *this;
+    }
+
+    const unsigned bitShift = static_cast<unsigned>(count % LIMB_BITS);
+    const size_t n = size_ - limbShift;
+    Limb* r = limbs();
+    for (size_t i = 0; i < n; ++i) {
+        Limb high = (bitShift != 0 && i + limbShift + 1 < size_)
+                        ? r[i + limbShift + 1] << (LIMB_BITS - bitShift) : 0;
+        r[i] = (r[i + limbShift] >> bitShift) | high;
+    }
+    size_ = static_cast<uint32_t>(n);
+    normalize();
+    return *this;
+}
+
+//=============================================================================
+// Base conversion
+//=============================================================================
+
+BigInteger BigInteger::fromString(std::string_view digits, int base) {
+    checkBase(base);
+
+    bool negative = false;
+    if (!digits.empty() && digits[0] == '-') {
+        negative = true;
+        digits.remove_prefix(1);
+    }
+    if (digits.empty()) {
+        throw std::invalid_argument("Cannot convert empty string");
+    }
+    for (char c : digits) {
+        if (digitValue(c) >= static_cast<unsigned>(base)) {
+            throw std::invalid_argument("Invalid digit for base " + std::to_string(base) + ": '" +
+                                        std::string(1, c) + "'");
+        }
+    }
+
+    BigInteger result;
+    if (const unsigned width = bitsPerDigit(base)) {
+        // Each digit is a group of bits, least significant digit last
+        result.resize((digits.size() * width + LIMB_BITS - 1) / LIMB_BITS);
+        Limb* r = result.limbs();
+        size_t position = 0;
+        for (size_t i = digits.size(); i-- > 0; position += width) {
+            const Limb value = digitValue(digits[i]);
+            const unsigned offset = static_cast<unsigned>(position % LIMB_BITS);
+            r[position / LIMB_BITS] |= value << offset;
+            if (offset + width > LIMB_BITS) {
+                r[position / LIMB_BITS + 1] |= value >> (LIMB_BITS - offset);
+            }
+        }
+        result.negative_ = negative;
+        result.normalize();
+        return result;
+    }
+
+    // Read digitsPerLimb digits at a time into chunks, least significant first
+    const Radix radix(base);
+    const size_t chunkCount = (digits.size() + radix.digitsPerLimb - 1) / radix.digitsPerLimb;
+    LimbVector chunks(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const size_t end = digits.size() - i * radix.digitsPerLimb;
+        const size_t begin = end > radix.digitsPerLimb ? end - radix.digitsPerLimb : 0;
+        Limb value = 0;
+        for (size_t j = begin; j < end; ++j) {
+            value = value * radix.base + digitValue(digits[j]);
+        }
+        chunks[i] = value;
+    }
+
+    // powers[i] = limbBase^(2^i), the weight of the upper half of 2^(i+1) chunks
+    std::vector<BigInteger> powers{fromUnsigned(radix.limbBase)};
+
+    // The value of chunks[first, first + count): halves joined by a power
+    // of the base, down to short runs read a chunk at a time
+    struct Combiner {
+        const LimbVector& chunks;
+        const Radix& radix;
+        std::vector<BigInteger>& powers;
+
+        BigInteger combine(size_t first, size_t count) {
+            if (count <= CONVERSION_THRESHOLD) {
+                LimbVector value(count, 0);
+                size_t length = 0;
+                for (size_t i = first + count; i-- > first;) {
+                    Limb carry = multiplySmall(value.data(), value.data(), length, radix.limbBase, chunks[i]);
+                    if (carry != 0) {
+                        value[length++] = carry;
+                    }
+                }
+                return fromLimbs(value.data(), length, false);
+            }
+
+            size_t level = 0;
+            while ((size_t{2} << level) < count) {
+                ++level;
+            }
+            while (powers.size() <= level) {
+                powers.push_back(powers.back() * powers.back());
+            }
+            const size_t half = size_t{1} << level;
+            BigInteger result = combine(first + half, count - half) * powers[level];
+            result += combine(first, half);
+            return result;
+        }
+    };
+
+    result = Combiner{chunks, radix, powers}.combine(0, chunkCount);
+    if (negative && !result.isZero()) {
+        result.negative_ = true;
+    }
+    return result;
+}
+
+std::string BigInteger::toString(int base) const {
+    checkBase(base);
+    if (size_ == 0) {
+        return "0";
+    }
+
+    std::string out;
+    if (negative_) {
+        out.push_back('-');
+    }
+
+    if (const unsigned width = bitsPerDigit(base)) {
+        const Wide digitMask = (Wide{1} << width) - 1;
+        const size_t count = (bitLength() + width - 1) / width;
+        out.reserve(out.size() + count);
+        for (size_t i = count; i-- > 0;) {
+            out.push_back(DIGIT_CHARS[bitsAt(limbs(), size_, i * width) & digitMask]);
+        }
+        return out;
+    }
+
+    appendDigits(out, base);
+    return out;
+}
+
+void BigInteger::appendDigits(std::string& out, int base) const {
+    const Radix radix(base);
+
+    // powers[i] = limbBase^(2^i), which splits off digitsPerLimb * 2^i digits
+    std::vector<BigInteger> powers{fromUnsigned(radix.limbBase)};
+    while (size_t{powers.back().size_} * 2 <= size_) {
+        powers.push_back(powers.back() * powers.back());
+    }
+
+    struct Writer {
+        std::string& out;
+        const Radix& radix;
+        const std::vector<BigInteger>& powers;
+
+        // Append a magnitude's digits, zero-padded to width (0: no padding)
+        void write(const BigInteger& value, size_t width) {
+            if (value.size_ <= CONVERSION_THRESHOLD) {
+                writeShort(value, width);
+                return;
+            }
+
+            // The largest power of at most half the value's length splits
+            // it into a quotient and a remainder of similar size
+            size_t level = 0;
+            while (level + 1 < powers.size() && size_t{powers[level + 1].size_} * 2 <= size_t{value.size_} + 1) {
+                ++level;
+            }
+            BigInteger quotient;
+            BigInteger remainder;
+            divMod(value, powers[level], quotient, remainder);
+            const size_t lowWidth = radix.digitsPerLimb << level;
+            write(quotient, width > lowWidth ? width - lowWidth : 0);
+            write(remainder, lowWidth);
+        }
+
+        // A limb of digits at a time, dividing by limbBase
+        void writeShort(const BigInteger& value, size_t width) {
+            LimbVector quotient(value.limbs(), value.limbs() + value.size_);
+            size_t length = quotient.size();
+            std::string reversed;
+            while (length != 0) {
+                Limb chunk = radix.base == 10
+                    ? divideByConstant<DECIMAL_LIMB_BASE>(quotient.data(), quotient.data(), length)
+                    : divideSmall(quotient.data(), quotient.data(), length, radix.limbBase);
+                length = trimmedLength(quotient.data(), length);
+                for (size_t i = 0; i < radix.digitsPerLimb && (length != 0 || chunk != 0); ++i) {
+                    reversed.push_back(DIGIT_CHARS[chunk % radix.base]);
+                    chunk /= radix.base;
+                }
+            }
+            if (reversed.size() < width) {
+                out.append(width - reversed.size(), '0');
+            }
+            out.append(reversed.rbegin(), reversed.rend());
+        }
+    };
+
+    Writer{out, radix, powers}.write(*this, 0);
+}
+
+} // namespace calc
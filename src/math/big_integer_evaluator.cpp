@@ -0,0 +1,380 @@
+/**
+ * @file big_integer_evaluator.cpp
+ * @brief Arbitrary-precision integer evaluation for programmer mode
+ */
+
+#include "calc/math/big_integer_evaluator.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace calc {
+
+namespace {
+
+int radixOf(NumberBase base) noexcept {
+    switch (base) {
+        case NumberBase::BINARY:      return 2;
+        case NumberBase::OCTAL:       return 8;
+        case NumberBase::HEXADECIMAL: return 16;
+        case NumberBase::DECIMAL:
+        default:                      return 10;
+    }
+}
+
+} // anonymous namespace
+
+//=============================================================================
+// BigIntegerResult Implementation
+//=============================================================================
+
+BigIntegerResult::BigIntegerResult(BigInteger value, size_t wordBits, bool isSigned)
+    : value_(std::move(value))
+    , wordBits_(wordBits)
+    , isSigned_(isSigned)
+    , isError_(false)
+    , errorCode_(ErrorCode::UNKNOWN_ERROR)
+    , errorPosition_(0)
+{}
+
+BigIntegerResult::BigIntegerResult(ErrorCode code, const std::string& message, size_t position)
+    : wordBits_(0)
+    , isSigned_(true)
+    , isError_(true)
+    , errorCode_(code)
+    , errorMessage_(message)
+    , errorPosition_(position)
+{}
+
+const BigInteger& BigIntegerResult::getValue() const {
+    if (isError_) {
+        throw std::runtime_error("Cannot get value from error result");
+    }
+    return value_;
+}
+
+ErrorCode BigIntegerResult::getErrorCode() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error code from successful result");
+    }
+    return errorCode_;
+}
+
+const std::string& BigIntegerResult::getErrorMessage() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error message from successful result");
+    }
+    return errorMessage_;
+}
+
+size_t BigIntegerResult::getErrorPosition() const {
+    if (isSuccess()) {
+        throw std::runtime_error("Cannot get error position from successful result");
+    }
+    return errorPosition_;
+}
+
+EvaluationResult BigIntegerResult::toEvaluationResult() const {
+    if (isError_) {
+        return EvaluationResult(errorCode_, errorMessage_, errorPosition_);
+    }
+    double value = value_.toDouble();
+    if (std::isinf(value)) {
+        return EvaluationResult(ErrorCode::NUMERIC_OVERFLOW, "Numeric overflow", 0);
+    }
+    return EvaluationResult(value);
+}
+
+//=============================================================================
+// BigIntegerEvaluator Implementation
+//=============================================================================
+
+BigIntegerEvaluator::BigIntegerEvaluator(size_t wordBits, bool isSigned)
+    : wordBits_(0)
+    , isSigned_(isSigned)
+{
+    setWordBits(wordBits);
+}
+
+void BigIntegerEvaluator::setWordBits(size_t wordBits) {
+    if (wordBits > MAX_BITS) {
+        throw std::invalid_argument("Word size must be at most " + std::to_string(MAX_BITS) + " bits");
+    }
+    wordBits_ = wordBits;
+}
+
+BigIntegerResult BigIntegerEvaluator::evaluate(const ASTNode& root, const EvaluationContext& context) {
+    context_ = &context;
+    xor_ = context.getOperatorSemantics("^") == OperatorSemantics::BITWISE_XOR;
+    failed_ = false;
+    values_.clear();
+
+    walker_.walk(const_cast<ASTNode&>(root), *this);
+    context_ = nullptr;
+
+    if (failed_) {
+        return error_;
+    }
+    return BigIntegerResult(pop(), wordBits_, isSigned_);
+}
+
+void BigIntegerEvaluator::fail(ErrorCode code, const std::string& message, size_t position) {
+    error_ = BigIntegerResult(code, message, position);
+    failed_ = true;
+    walker_.stop();
+}
+
+void BigIntegerEvaluator::push(BigInteger value) {
+    if (wordBits_ == 0) {
+        values_.push_back(std::move(value));
+    } else {
+        values_.push_back(value.wrap(wordBits_, isSigned_));
+    }
+}
+
+BigInteger BigIntegerEvaluator::pop() {
+    BigInteger value = std::move(values_.back());
+    values_.pop_back();
+    return value;
+}
+
+bool BigIntegerEvaluator::pushWhole(double value) {
+    if (!std::isfinite(value) || std::trunc(value) != value) {
+        return false;
+    }
+    push(BigInteger::fromDouble(value));
+    return true;
+}
+
+void BigIntegerEvaluator::visit(LiteralNode& node) {
+    if (node.isWide()) {
+        push(BigInteger::fromString(node.getDigits(), radixOf(node.getBase())));
+    } else if (node.hasInteger()) {
+        push(BigInteger::fromUnsigned(node.getInteger()));
+    } else {
+        if (!pushWhole(node.getValue())) {
+            fail(ErrorCode::DOMAIN_ERROR, "Not an integer: " + node.toString(), 0);
+        }
+    }
+}
+
+void BigIntegerEvaluator::visit(VariableNode& node) {
+    double value = 0.0;
+    size_t slot = context_->findVariableSlot(node.getName());
+    if (slot != EvaluationContext::NO_SLOT) {
+        value = context_->getVariable(slot);
+    } else if (const FunctionEntry* entry = context_->findFunction(node.getName())) {
+        // Constants are zero-argument functions
+        EvaluationResult result = EvaluationContext::callFunction(*entry, node.getName(), nullptr, 0);
+        if (result.isError()) {
+            size_t position = result.getErrorPosition() == 0 ? node.getPosition() : result.getErrorPosition();
+            fail(result.getErrorCode(), result.getErrorMessage(), position);
+            return;
+        }
+        value = result.getValue();
+    } else {
+        fail(ErrorCode::UNDEFINED_VARIABLE, "Undefined variable: " + node.getName(), node.getPosition());
+        return;
+    }
+
+    if (!pushWhole(value)) {
+        fail(ErrorCode::DOMAIN_ERROR, "Not an integer: " + node.getName(), node.getPosition());
+    }
+}
+
+void BigIntegerEvaluator::visit(BinaryOpNode& node) {
+    BigInteger right = pop();
+    BigInteger left = pop();
+
+    BigInteger result;
+    if (applyBinary(node.getOpCode(), node.getPosition(), left, right, result)) {
+        push(std::move(result));
+    }
+}
+
+void BigIntegerEvaluator::visit(UnaryOpNode& node) {
+    BigInteger operand = pop();
+
+    switch (node.getOpCode()) {
+        case OpCode::PLUS:
+            push(std::move(operand));
+            break;
+        case OpCode::NEG:
+            push(-operand);
+            break;
+        case OpCode::BIT_NOT:
+            push(~operand);
+            break;
+        default:
+            fail(ErrorCode::EVALUATION_ERROR,
+                 std::string("Unknown unary operator: ") + opCodeSymbol(node.getOpCode()),
+                 node.getPosition());
+            break;
+    }
+}
+
+void BigIntegerEvaluator::visit(FunctionCallNode& node) {
+    const size_t count = node.getArgumentCount();
+    const size_t frame = values_.size() - count;
+
+    const FunctionEntry* entry = context_->findFunction(node.getName());
+    if (entry == nullptr) {
+        fail(ErrorCode::INVALID_FUNCTION, "Unknown function: " + node.getName(), node.getPosition());
+        return;
+    }
+
+    // The function registry works on doubles
+    arguments_.clear();
+    for (size_t i = frame; i < values_.size(); ++i) {
+        arguments_.push_back(values_[i].toDouble());
+    }
+    values_.resize(frame);
+
+    EvaluationResult result = EvaluationContext::callFunction(*entry, node.getName(),
+                                                              arguments_.data(), count);
+    if (result.isError()) {
+        size_t position = result.getErrorPosition() == 0 ? node.getPosition() : result.getErrorPosition();
+        fail(result.getErrorCode(), result.getErrorMessage(), position);
+        return;
+    }
+
+    if (!pushWhole(result.getValue())) {
+        fail(ErrorCode::DOMAIN_ERROR, node.getName() + " did not return an integer", node.getPosition());
+    }
+}
+
+bool BigIntegerEvaluator::applyBinary(OpCode op, size_t position, const BigInteger& left,
+                                      const BigInteger& right, BigInteger& result) {
+    switch (op) {
+        case OpCode::ADD:
+            result = left + right;
+            return true;
+        case OpCode::SUB:
+            result = left - right;
+            return true;
+        case OpCode::MUL:
+            if (wordBits_ == 0 && left.bitLength() + right.bitLength() > MAX_BITS) {
+                fail(ErrorCode::NUMERIC_OVERFLOW, "Result too large", position);
+                return false;
+            }
+            result = left * right;
+            return true;
+
+        case OpCode::DIV:
+        case OpCode::MOD: {
+            if (right.isZero()) {
+                fail(ErrorCode::DIVISION_BY_ZERO, "Division by zero", position);
+                return false;
+            }
+            BigInteger quotient;
+            BigInteger remainder;
+            BigInteger::divMod(left, right, quotient, remainder);
+            result = op == OpCode::DIV ? std::move(quotient) : std::move(remainder);
+            return true;
+        }
+
+        case OpCode::POW:
+            if (xor_) {
+                result = left ^ right;
+                return true;
+            }
+            return power(position, left, right, result);
+
+        case OpCode::BIT_AND:
+            result = left & right;
+            return true;
+        case OpCode::BIT_OR:
+            result = left | right;
+            return true;
+
+        case OpCode::SHL:
+        case OpCode::SHR:
+            if (right.isNegative()) {
+                fail(ErrorCode::DOMAIN_ERROR, "Negative shift count", position);
+                return false;
+            }
+            return shift(op, position, left, right, result);
+
+        default:
+            fail(ErrorCode::EVALUATION_ERROR,
+                 std::string("Unknown binary operator: ") + opCodeSymbol(op), position);
+            return false;
+    }
+}
+
+bool BigIntegerEvaluator::power(size_t position, const BigInteger& base, const BigInteger& exponent,
+                                BigInteger& result) {
+    if (exponent.isNegative()) {
+        // Only 1 and -1 have integer reciprocals
+        if (base.isZero()) {
+            fail(ErrorCode::DIVISION_BY_ZERO, "Division by zero", position);
+            return false;
+        }
+        if (base == 1 || base == -1) {
+            result = (base == -1 && exponent.testBit(0)) ? base : BigInteger(1);
+        } else {
+            result = BigInteger();
+        }
+        return true;
+    }
+
+    if (wordBits_ != 0) {
+        // Square and multiply, keeping only the word's bits at each step
+        result = BigInteger(1);
+        BigInteger square = base.wrap(wordBits_, false);
+        const size_t bits = exponent.bitLength();
+        for (size_t i = 0; i < bits; ++i) {
+            if (exponent.testBit(i)) {
+                result = (result * square).wrap(wordBits_, false);
+            }
+            if (i + 1 < bits) {
+                square = (square * square).wrap(wordBits_, false);
+            }
+        }
+        return true;
+    }
+
+    // Unbounded: 0, 1 and -1 stay small whatever the exponent
+    if (base.isZero() || base == 1 || base == -1) {
+        if (exponent.isZero() || (base == -1 && !exponent.testBit(0))) {
+            result = BigInteger(1);
+        } else {
+            result = base;
+        }
+        return true;
+    }
+
+    // Any other base has |base| >= 2^growth, so the result has at least
+    // exponent * growth bits
+    const uint64_t growth = base.bitLength() - 1;
+    if (!exponent.fitsInt64() || static_cast<uint64_t>(exponent.toInt64()) > MAX_BITS / growth) {
+        fail(ErrorCode::NUMERIC_OVERFLOW, "Result too large", position);
+        return false;
+    }
+    result = BigInteger::pow(base, static_cast<uint64_t>(exponent.toInt64()));
+    return true;
+}
+
+bool BigIntegerEvaluator::shift(OpCode op, size_t position, const BigInteger& value,
+                                const BigInteger& count, BigInteger& result) {
+    // Counts past every bit of the value give 0, or -1 for >> of a negative value
+    const size_t limit = op == OpCode::SHR ? value.bitLength() + 1
+                       : (wordBits_ != 0 ? wordBits_ : MAX_BITS);
+    if (!count.fitsInt64() || static_cast<uint64_t>(count.toInt64()) >= limit) {
+        if (op == OpCode::SHL && wordBits_ == 0 && !value.isZero()) {
+            fail(ErrorCode::NUMERIC_OVERFLOW, "Result too large", position);
+            return false;
+        }
+        result = (op == OpCode::SHR && value.isNegative()) ? BigInteger(-1) : BigInteger();
+        return true;
+    }
+
+    const auto bits = static_cast<size_t>(count.toInt64());
+    if (op == OpCode::SHL && wordBits_ == 0 && value.bitLength() + bits > MAX_BITS) {
+        fail(ErrorCode::NUMERIC_OVERFLOW, "Result too large", position);
+        return false;
+    }
+    result = op == OpCode::SHL ? value << bits : value >> bits;
+    return true;
+}
+
+} // namespace calc
@@ -8,9 +8,179 @@
 #include <algorithm>
 #include <stdexcept>
 #include <cctype>
+#include <charconv>
+#include <cstring>
+#include <limits>
 
 namespace calc {
 
+namespace {
+
+constexpr char DIGIT_CHARS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// Marks characters that are not digits in any base
+constexpr uint8_t NOT_A_DIGIT = 0xFF;
+
+struct DigitTable {
+    uint8_t values[256];
+};
+
+// Value of every character as a digit: 0-9, A-Z and a-z, or NOT_A_DIGIT
+constexpr DigitTable makeDigitTable() {
+    DigitTable table{};
+    for (int c = 0; c < 256; ++c) {
+        table.values[c] = NOT_A_DIGIT;
+    }
+    for (int digit = 0; digit < 36; ++digit) {
+        table.values[static_cast<unsigned char>(DIGIT_CHARS[digit])] = static_cast<uint8_t>(digit);
+        if (digit >= 10) {
+            table.values['a' + digit - 10] = static_cast<uint8_t>(digit);
+        }
+    }
+    return table;
+}
+
+constexpr DigitTable DIGIT_VALUES = makeDigitTable();
+
+inline unsigned digitValue(char c) {
+    return DIGIT_VALUES.values[static_cast<unsigned char>(c)];
+}
+
+struct WidthTable {
+    size_t digits[37];
+};
+
+// Digits of the largest 64-bit value in each base, the most any value takes
+constexpr WidthTable makeWidthTable() {
+    WidthTable table{};
+    for (unsigned base = 2; base <= 36; ++base) {
+        size_t count = 0;
+        for (unsigned long long value = std::numeric_limits<unsigned long long>::max(); value != 0;
+             value /= base) {
+            ++count;
+        }
+        table.digits[base] = count;
+    }
+    return table;
+}
+
+constexpr WidthTable MAX_DIGITS = makeWidthTable();
+
+// Most digits in each base that cannot exceed LLONG_MAX, so need no overflow check
+constexpr WidthTable makeSafeWidthTable() {
+    WidthTable table{};
+    for (unsigned base = 2; base <= 36; ++base) {
+        size_t count = 0;
+        for (unsigned long long power = 1; power <= (1ULL << 63) / base; power *= base) {
+            ++count;
+        }
+        table.digits[base] = count;
+    }
+    return table;
+}
+
+constexpr WidthTable SAFE_DIGITS = makeSafeWidthTable();
+
+// Every byte as 2 hexadecimal and 8 binary digits, so those bases write a byte at a time
+struct ByteDigits {
+    char hex[256 * 2];
+    char binary[256 * 8];
+};
+
+constexpr ByteDigits makeByteDigits() {
+    ByteDigits table{};
+    for (int byte = 0; byte < 256; ++byte) {
+        table.hex[2 * byte] = DIGIT_CHARS[byte >> 4];
+        table.hex[2 * byte + 1] = DIGIT_CHARS[byte & 0xF];
+        for (int bit = 0; bit < 8; ++bit) {
+            table.binary[8 * byte + bit] = ((byte >> (7 - bit)) & 1) != 0 ? '1' : '0';
+        }
+    }
+    return table;
+}
+
+constexpr ByteDigits BYTE_DIGITS = makeByteDigits();
+
+void checkBase(int base) {
+    if (base < 2 || base > 36) {
+        throw std::invalid_argument("Base must be between 2 and 36");
+    }
+}
+
+// Bits per digit of a power-of-two base, or 0
+inline unsigned bitsPerDigit(int base) {
+    switch (base) {
+        case 2: return 1;
+        case 4: return 2;
+        case 8: return 3;
+        case 16: return 4;
+        case 32: return 5;
+        default: return 0;
+    }
+}
+
+// Number of significant bits in @p value, by halving rather than a bit at a time
+inline unsigned bitLength(unsigned long long value) {
+    unsigned bits = 0;
+    for (unsigned half = 32; half != 0; half >>= 1) {
+        if ((value >> half) != 0) {
+            value >>= half;
+            bits += half;
+        }
+    }
+    return bits + static_cast<unsigned>(value);
+}
+
+// Write the digits of @p value; the base is already checked
+size_t writeDigits(unsigned long long value, int base, char* out) {
+    if (base == 10) {
+        return static_cast<size_t>(std::to_chars(out, out + Converter::MAX_CHARS, value).ptr - out);
+    }
+
+    if (const unsigned shift = bitsPerDigit(base)) {
+        // The digit count is known from the bits, so write straight into place
+        const size_t count = std::max<size_t>(1, (bitLength(value) + shift - 1) / shift);
+        char* next = out + count;
+        if (shift == 4) {
+            for (; next - out >= 2; value >>= 8) {
+                next -= 2;
+                std::memcpy(next, BYTE_DIGITS.hex + 2 * (value & 0xFF), 2);
+            }
+        } else if (shift == 1) {
+            for (; next - out >= 8; value >>= 8) {
+                next -= 8;
+                std::memcpy(next, BYTE_DIGITS.binary + 8 * (value & 0xFF), 8);
+            }
+        }
+        const unsigned long long mask = (1ULL << shift) - 1;
+        for (; next != out; value >>= shift) {
+            *--next = DIGIT_CHARS[value & mask];
+        }
+        return count;
+    }
+
+    // Digits come least significant first, so fill a buffer from its end
+    char digits[64];
+    char* first = digits + sizeof(digits);
+    const auto radix = static_cast<unsigned long long>(base);
+    do {
+        *--first = DIGIT_CHARS[value % radix];
+        value /= radix;
+    } while (value != 0);
+    const auto count = static_cast<size_t>(digits + sizeof(digits) - first);
+    std::memcpy(out, first, count);
+    return count;
+}
+
+// Magnitude of a signed value; unsigned so that LLONG_MIN has one
+inline unsigned long long magnitudeOf(long long value) {
+    return value < 0 ? 0 - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+}
+
+constexpr auto LLONG_MAX_MAGNITUDE = static_cast<unsigned long long>(std::numeric_limits<long long>::max());
+
+} // anonymous namespace
+
 // ============================================================================
 // Decimal to other bases
 // ============================================================================
@@ -20,10 +190,8 @@ std::string Converter::decimalToBinary(long long value) {
 }
 
 std::string Converter::decimalToHex(long long value) {
-    std::string hex = convertToBase(value, 16);
-    // Convert to uppercase
-    std::transform(hex.begin(), hex.end(), hex.begin(), ::toupper);
-    return hex;
+    // Digits are already uppercase
+    return convertToBase(value, 16);
 }
 
 std::string Converter::decimalToOctal(long long value) {
@@ -51,136 +219,133 @@ long long Converter::octalToDecimal(const std::string& octal) {
 // ============================================================================
 
 std::string Converter::convertToBase(long long value, int base) {
-    if (base < 2 || base > 36) {
-        throw std::invalid_argument("Base must be between 2 and 36");
-    }
-
-    if (value == 0) {
-        return "0";
-    }
+    char buffer[MAX_CHARS];
+    return std::string(buffer, toChars(value, base, buffer));
+}
 
-    // Handle negative numbers
-    bool isNegative = value < 0;
-    if (isNegative) {
-        value = -value;
-    }
+long long Converter::fromBase(std::string_view value, int base) {
+    checkBase(base);
 
-    std::string result;
-    while (value > 0) {
-        int remainder = static_cast<int>(value % base);
-        result.insert(result.begin(), digitToChar(remainder));
-        value /= base;
+    if (value.empty()) {
+        throw std::invalid_argument("Cannot convert empty string");
     }
 
-    if (isNegative) {
-        result.insert(result.begin(), '-');
+    // LLONG_MIN's magnitude is one past LLONG_MAX
+    if (value[0] == '-') {
+        unsigned long long magnitude = parseMagnitude(value.substr(1), base, LLONG_MAX_MAGNITUDE + 1);
+        return static_cast<long long>(0 - magnitude);
     }
-
-    return result;
+    return static_cast<long long>(parseMagnitude(value, base, LLONG_MAX_MAGNITUDE));
 }
 
-long long Converter::fromBase(const std::string& value, int base) {
-    if (base < 2 || base > 36) {
-        throw std::invalid_argument("Base must be between 2 and 36");
-    }
+unsigned long long Converter::fromBaseUnsigned(std::string_view value, int base) {
+    checkBase(base);
 
     if (value.empty()) {
         throw std::invalid_argument("Cannot convert empty string");
     }
+    return parseMagnitude(value, base, std::numeric_limits<unsigned long long>::max());
+}
 
-    // Check if string is valid for the base
-    if (!isValidDigitForBase(value[0], base) && value[0] != '-') {
-        throw std::invalid_argument("Invalid digit for base " + std::to_string(base) + ": '" + std::string(1, value[0]) + "'");
-    }
-
-    size_t start = 0;
-    bool isNegative = false;
-
-    if (value[0] == '-') {
-        isNegative = true;
-        start = 1;
-    }
+size_t Converter::toChars(long long value, int base, char* out) {
+    checkBase(base);
 
-    long long result = 0;
-    for (size_t i = start; i < value.length(); ++i) {
-        char c = value[i];
-        if (!isValidDigitForBase(c, base)) {
-            throw std::invalid_argument("Invalid digit for base " + std::to_string(base) + ": '" + std::string(1, c) + "'");
-        }
-        result = result * base + charToDigit(c);
+    if (value < 0) {
+        *out = '-';
+        return 1 + writeDigits(magnitudeOf(value), base, out + 1);
     }
+    return writeDigits(static_cast<unsigned long long>(value), base, out);
+}
 
-    return isNegative ? -result : result;
+size_t Converter::toCharsUnsigned(unsigned long long value, int base, char* out) {
+    checkBase(base);
+    return writeDigits(value, base, out);
 }
 
 // ============================================================================
-// Validation functions
+// Bulk conversion
 // ============================================================================
 
-bool Converter::isValidBinary(const std::string& value) {
-    if (value.empty()) {
-        return false;
-    }
-
-    size_t start = 0;
-    if (value[0] == '-') {
-        start = 1;
+void Converter::convertToBase(const long long* values, size_t count, int base, std::string& out,
+                              char separator) {
+    checkBase(base);
+
+    // Grow once to the widest the values can be, then trim
+    const size_t width = MAX_DIGITS.digits[base] + 2;  // Sign and separator
+    size_t used = out.size();
+    out.resize(used + count * width);
+    char* first = &out[0];
+    for (size_t i = 0; i < count; ++i) {
+        char* next = first + used;
+        if (values[i] < 0) {
+            *next++ = '-';
+        }
+        next += writeDigits(magnitudeOf(values[i]), base, next);
+        *next++ = separator;
+        used = static_cast<size_t>(next - first);
     }
+    out.resize(used);
+}
 
-    if (start == value.length()) {
-        return false;
+void Converter::convertToBase(const unsigned long long* values, size_t count, int base,
+                              std::string& out, char separator) {
+    checkBase(base);
+
+    const size_t width = MAX_DIGITS.digits[base] + 1;  // Separator
+    size_t used = out.size();
+    out.resize(used + count * width);
+    char* first = &out[0];
+    for (size_t i = 0; i < count; ++i) {
+        char* next = first + used;
+        next += writeDigits(values[i], base, next);
+        *next++ = separator;
+        used = static_cast<size_t>(next - first);
     }
+    out.resize(used);
+}
 
-    for (size_t i = start; i < value.length(); ++i) {
-        if (value[i] != '0' && value[i] != '1') {
-            return false;
-        }
-    }
-    return true;
+size_t Converter::fromBase(std::string_view text, int base, long long* out, size_t capacity,
+                           char separator) {
+    checkBase(base);
+    return parseAll(text, out, capacity, separator, [base](std::string_view value) {
+        return fromBase(value, base);
+    });
 }
 
-bool Converter::isValidHex(const std::string& value) {
-    if (value.empty()) {
-        return false;
-    }
+size_t Converter::fromBase(std::string_view text, int base, unsigned long long* out, size_t capacity,
+                           char separator) {
+    checkBase(base);
+    return parseAll(text, out, capacity, separator, [base](std::string_view value) {
+        return fromBaseUnsigned(value, base);
+    });
+}
 
-    size_t start = 0;
-    if (value[0] == '-') {
-        start = 1;
-    }
+// ============================================================================
+// Arbitrary precision
+// ============================================================================
 
-    if (start == value.length()) {
-        return false;
-    }
+std::string Converter::convertToBase(const BigInteger& value, int base) {
+    return value.toString(base);
+}
 
-    for (size_t i = start; i < value.length(); ++i) {
-        if (!std::isxdigit(static_cast<unsigned char>(value[i]))) {
-            return false;
-        }
-    }
-    return true;
+BigInteger Converter::fromBaseBig(const std::string& value, int base) {
+    return BigInteger::fromString(value, base);
 }
 
-bool Converter::isValidOctal(const std::string& value) {
-    if (value.empty()) {
-        return false;
-    }
+// ============================================================================
+// Validation functions
+// ============================================================================
 
-    size_t start = 0;
-    if (value[0] == '-') {
-        start = 1;
-    }
+bool Converter::isValidBinary(const std::string& value) {
+    return isValidForBase(value, 2);
+}
 
-    if (start == value.length()) {
-        return false;
-    }
+bool Converter::isValidHex(const std::string& value) {
+    return isValidForBase(value, 16);
+}
 
-    for (size_t i = start; i < value.length(); ++i) {
-        if (value[i] < '0' || value[i] > '7') {
-            return false;
-        }
-    }
-    return true;
+bool Converter::isValidOctal(const std::string& value) {
+    return isValidForBase(value, 8);
 }
 
 // ============================================================================
@@ -202,26 +367,51 @@ std::string Converter::formatOctal(const std::string& octal) {
 }
 
 std::string Converter::format(long long value, NumberBase base) {
+    if (base == NumberBase::BINARY || base == NumberBase::OCTAL || base == NumberBase::HEXADECIMAL) {
+        // The sign goes before the prefix: -0xFF
+        char buffer[1 + 2 + MAX_CHARS];
+        size_t length = 0;
+        if (value < 0) {
+            buffer[length++] = '-';
+        }
+        length += prefixedDigits(magnitudeOf(value), base, buffer + length);
+        return std::string(buffer, length);
+    }
+    char buffer[MAX_CHARS];
+    return std::string(buffer, toChars(value, 10, buffer));
+}
+
+std::string Converter::format(const BigInteger& value, NumberBase base) {
+    const char* prefix = "";
+    int radix = 10;
     switch (base) {
         case NumberBase::BINARY:
-            if (value < 0) {
-                return "-" + formatBinary(decimalToBinary(-value));
-            }
-            return formatBinary(decimalToBinary(value));
+            prefix = "0b";
+            radix = 2;
+            break;
         case NumberBase::OCTAL:
-            if (value < 0) {
-                return "-" + formatOctal(decimalToOctal(-value));
-            }
-            return formatOctal(decimalToOctal(value));
+            prefix = "0o";
+            radix = 8;
+            break;
         case NumberBase::HEXADECIMAL:
-            if (value < 0) {
-                return "-" + formatHex(decimalToHex(-value));
-            }
-            return formatHex(decimalToHex(value));
+            prefix = "0x";
+            radix = 16;
+            break;
         case NumberBase::DECIMAL:
         default:
-            return std::to_string(value);
+            return value.toString(10);
     }
+
+    std::string result = value.isNegative() ? "-" : "";
+    result += prefix;
+    result += (value.isNegative() ? -value : value).toString(radix);
+    return result;
+}
+
+std::string Converter::formatUnsigned(unsigned long long value, NumberBase base) {
+    // Values are never negative: a word's two's complement bits print as they are
+    char buffer[2 + MAX_CHARS];
+    return std::string(buffer, prefixedDigits(value, base, buffer));
 }
 
 // ============================================================================
@@ -229,37 +419,111 @@ std::string Converter::format(long long value, NumberBase base) {
 // ============================================================================
 
 int Converter::charToDigit(char c) {
-    if (c >= '0' && c <= '9') {
-        return c - '0';
-    } else if (c >= 'A' && c <= 'Z') {
-        return 10 + (c - 'A');
-    } else if (c >= 'a' && c <= 'z') {
-        return 10 + (c - 'a');
+    const unsigned digit = digitValue(c);
+    if (digit == NOT_A_DIGIT) {
+        throw std::invalid_argument("Invalid digit character: '" + std::string(1, c) + "'");
     }
-    throw std::invalid_argument("Invalid digit character: '" + std::string(1, c) + "'");
+    return static_cast<int>(digit);
 }
 
 char Converter::digitToChar(int value) {
-    if (value >= 0 && value <= 9) {
-        return static_cast<char>('0' + value);
-    } else if (value >= 10 && value <= 35) {
-        return static_cast<char>('A' + value - 10);
+    if (value < 0 || value > 35) {
+        throw std::invalid_argument("Invalid digit value: " + std::to_string(value));
     }
-    throw std::invalid_argument("Invalid digit value: " + std::to_string(value));
+    return DIGIT_CHARS[value];
 }
 
 bool Converter::isValidDigitForBase(char c, int base) {
-    if (base <= 10) {
-        return c >= '0' && c < ('0' + base);
+    return digitValue(c) < static_cast<unsigned>(base);
+}
+
+bool Converter::isValidForBase(const std::string& value, int base) {
+    const size_t start = (!value.empty() && value[0] == '-') ? 1 : 0;
+    if (start == value.length()) {
+        return false;
     }
-    if (c >= '0' && c <= '9') {
-        return true;
+    return std::all_of(value.begin() + static_cast<std::ptrdiff_t>(start), value.end(),
+                       [base](char c) { return isValidDigitForBase(c, base); });
+}
+
+size_t Converter::prefixedDigits(unsigned long long value, NumberBase base, char* out) {
+    int radix = 10;
+    switch (base) {
+        case NumberBase::BINARY:
+            radix = 2;
+            std::memcpy(out, "0b", 2);
+            break;
+        case NumberBase::OCTAL:
+            radix = 8;
+            std::memcpy(out, "0o", 2);
+            break;
+        case NumberBase::HEXADECIMAL:
+            radix = 16;
+            std::memcpy(out, "0x", 2);
+            break;
+        case NumberBase::DECIMAL:
+        default:
+            return writeDigits(value, 10, out);
+    }
+    return 2 + writeDigits(value, radix, out + 2);
+}
+
+unsigned long long Converter::parseMagnitude(std::string_view value, int base, unsigned long long limit) {
+    if (value.empty()) {
+        throw std::invalid_argument("Missing digits for base " + std::to_string(base));
+    }
+
+    const auto radix = static_cast<unsigned long long>(base);
+    unsigned long long magnitude = 0;
+    if (value.size() <= SAFE_DIGITS.digits[base]) {
+        // Too few digits to exceed any limit
+        for (char c : value) {
+            const unsigned digit = digitValue(c);
+            if (digit >= static_cast<unsigned>(base)) {
+                throw std::invalid_argument("Invalid digit for base " + std::to_string(base) + ": '" + std::string(1, c) + "'");
+            }
+            magnitude = magnitude * radix + digit;
+        }
+        return magnitude;
     }
-    char upperC = static_cast<char>(::toupper(static_cast<unsigned char>(c)));
-    if (upperC >= 'A' && upperC < ('A' + base - 10)) {
-        return true;
+
+    // Overflow is checked against limit / base once, not divided per digit
+    const unsigned long long cutoff = limit / radix;
+    const unsigned long long lastDigit = limit % radix;
+    for (char c : value) {
+        const unsigned digit = digitValue(c);
+        if (digit >= static_cast<unsigned>(base)) {
+            throw std::invalid_argument("Invalid digit for base " + std::to_string(base) + ": '" + std::string(1, c) + "'");
+        }
+        if (magnitude > cutoff || (magnitude == cutoff && digit > lastDigit)) {
+            throw std::out_of_range("Value out of range for 64 bits: " + std::string(value));
+        }
+        magnitude = magnitude * radix + digit;
+    }
+    return magnitude;
+}
+
+template <typename T, typename Parse>
+size_t Converter::parseAll(std::string_view text, T* out, size_t capacity, char separator, Parse&& parse) {
+    size_t count = 0;
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find(separator, position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        if (count == capacity) {
+            throw std::length_error("More than " + std::to_string(capacity) + " values to convert");
+        }
+        try {
+            out[count] = parse(text.substr(position, end - position));
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument(std::string(e.what()) + " in value " + std::to_string(count + 1));
+        }
+        ++count;
+        position = end + 1;
     }
-    return false;
+    return count;
 }
 
 } // namespace calc
@@ -7,23 +7,19 @@
 #include "calc/modes/standard_mode.h"
 #include "calc/modes/scientific_mode.h"
 #include "calc/modes/programmer_mode.h"
+#include "calc/modes/precision_mode.h"
 #include <algorithm>
 
 namespace calc {
 
 ModeManager::ModeManager()
     : defaultModeName_("standard") {
-    // Register StandardMode as default
-    auto standardMode = std::make_unique<StandardMode>();
-    registerMode(std::move(standardMode));
-
-    // Register ScientificMode
-    auto scientificMode = std::make_unique<ScientificMode>();
-    registerMode(std::move(scientificMode));
-
-    // Register ProgrammerMode
-    auto programmerMode = std::make_unique<ProgrammerMode>();
-    registerMode(std::move(programmerMode));
+    // Captureless lambdas, so registering costs no allocation and no mode
+    // is built until it is asked for
+    registerModeFactory("standard", [] { return std::make_unique<StandardMode>(); });
+    registerModeFactory("scientific", [] { return std::make_unique<ScientificMode>(); });
+    registerModeFactory("programmer", [] { return std::make_unique<ProgrammerMode>(); });
+    registerModeFactory("precision", [] { return std::make_unique<PrecisionMode>(); });
 }
 
 bool ModeManager::registerMode(std::unique_ptr<Mode> mode) {
@@ -31,29 +27,51 @@ bool ModeManager::registerMode(std::unique_ptr<Mode> mode) {
         return false;
     }
 
+    std::lock_guard<std::mutex> lock(mutex_);
     const std::string& name = mode->getName();
     if (modes_.find(name) != modes_.end()) {
         return false;  // Mode with this name already exists
     }
 
-    modes_[name] = std::move(mode);
+    modes_[name].mode = std::move(mode);
     return true;
 }
 
-Mode* ModeManager::getMode(const std::string& name) {
-    auto it = modes_.find(name);
-    if (it != modes_.end()) {
-        return it->second.get();
+bool ModeManager::registerModeFactory(const std::string& name, ModeFactory factory) {
+    if (!factory) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (modes_.find(name) != modes_.end()) {
+        return false;  // Mode with this name already exists
     }
-    return nullptr;
+
+    modes_[name].factory = std::move(factory);
+    return true;
 }
 
-const Mode* ModeManager::getMode(const std::string& name) const {
+Mode* ModeManager::findMode(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = modes_.find(name);
-    if (it != modes_.end()) {
-        return it->second.get();
+    if (it == modes_.end()) {
+        return nullptr;
     }
-    return nullptr;
+
+    ModeSlot& slot = it->second;
+    if (!slot.mode && slot.factory) {
+        slot.mode = slot.factory();
+        slot.factory = nullptr;
+    }
+    return slot.mode.get();
+}
+
+Mode* ModeManager::getMode(const std::string& name) {
+    return findMode(name);
+}
+
+const Mode* ModeManager::getMode(const std::string& name) const {
+    return findMode(name);
 }
 
 Mode* ModeManager::getDefaultMode() {
@@ -65,6 +83,7 @@ const Mode* ModeManager::getDefaultMode() const {
 }
 
 std::vector<std::string> ModeManager::getAvailableModes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<std::string> names;
     names.reserve(modes_.size());
 
@@ -78,10 +97,18 @@ std::vector<std::string> ModeManager::getAvailableModes() const {
 }
 
 bool ModeManager::hasMode(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return modes_.find(name) != modes_.end();
 }
 
+bool ModeManager::isModeBuilt(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = modes_.find(name);
+    return it != modes_.end() && it->second.mode != nullptr;
+}
+
 size_t ModeManager::getModeCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return modes_.size();
 }
 
@@ -0,0 +1,199 @@
+/**
+ * @file precision_mode.cpp
+ * @brief Arbitrary-precision calculator mode implementation
+ */
+
+#include "calc/modes/precision_mode.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace calc {
+
+namespace {
+
+// Precision mode always parses with the shunting-yard parser
+const std::string PARSER_TYPE = "shunting-yard";
+
+} // anonymous namespace
+
+PrecisionMode::PrecisionMode(int precision)
+    : context_(precision) {
+    // '^' is power, as in Standard and Scientific modes
+    context_.setOperatorSemantics("^", OperatorSemantics::POWER);
+
+    // The evaluator computes these precisely; the context says which exist
+    MathFunctions::registerBuiltInFunctions(context_);
+}
+
+//=============================================================================
+// Mode Implementation
+//=============================================================================
+
+std::string PrecisionMode::getName() const {
+    return "precision";
+}
+
+std::string PrecisionMode::getDescription() const {
+    return "Precision mode: scientific functions to any number of significant digits";
+}
+
+EvaluationResult PrecisionMode::evaluate(const std::string& expression) {
+    if (expression.empty()) {
+        return EvaluationResult(ErrorCode::INVALID_SYNTAX, "Empty expression", 0);
+    }
+
+    return evaluatePrecise(expression).toEvaluationResult();
+}
+
+BigFloatResult PrecisionMode::evaluatePrecise(const std::string& expression) {
+    if (expression.empty()) {
+        return BigFloatResult(ErrorCode::INVALID_SYNTAX, "Empty expression", 0);
+    }
+
+    std::shared_ptr<const ASTNode> ast;
+    try {
+        ast = parse(expression);
+    } catch (const CalculatorException& e) {
+        return BigFloatResult(e.getErrorCode(), e.what(), e.getPosition());
+    } catch (const std::exception& e) {
+        return BigFloatResult(ErrorCode::PARSE_ERROR, e.what(), 0);
+    }
+
+    // The context's precision may have been set directly, past MAX_DIGITS
+    const size_t digits = getDigits();
+    if (digits > static_cast<size_t>(MAX_DIGITS)) {
+        return BigFloatResult(ErrorCode::EVALUATION_ERROR,
+                              "Precision must be at most " + std::to_string(MAX_DIGITS) + " digits");
+    }
+    evaluator_.setPrecision(BigFloat::precisionForDigits(digits) + GUARD_BITS);
+    return evaluator_.evaluate(*ast, context_);
+}
+
+BatchResult PrecisionMode::evaluateBatch(const std::string& expression,
+                                         const std::vector<BatchColumn>& columns,
+                                         size_t rows, double* out) {
+    if (expression.empty()) {
+        return VirtualMachine::failBatch(
+            EvaluationResult(ErrorCode::INVALID_SYNTAX, "Empty expression", 0), rows, out);
+    }
+
+    std::shared_ptr<const ASTNode> ast;
+    try {
+        ast = parse(expression);
+    } catch (const CalculatorException& e) {
+        return VirtualMachine::failBatch(
+            EvaluationResult(e.getErrorCode(), e.what(), e.getPosition()), rows, out);
+    } catch (const std::exception& e) {
+        return VirtualMachine::failBatch(
+            EvaluationResult(ErrorCode::PARSE_ERROR, e.what(), 0), rows, out);
+    }
+    const size_t digits = getDigits();
+    if (digits > static_cast<size_t>(MAX_DIGITS)) {
+        return VirtualMachine::failBatch(
+            EvaluationResult(ErrorCode::EVALUATION_ERROR,
+                             "Precision must be at most " + std::to_string(MAX_DIGITS) + " digits"),
+            rows, out);
+    }
+    evaluator_.setPrecision(BigFloat::precisionForDigits(digits) + GUARD_BITS);
+
+    // Columns shadow context variables, so bind them in a copy of the context
+    EvaluationContext rowContext = context_;
+    std::vector<size_t> slots;
+    slots.reserve(columns.size());
+    for (const auto& column : columns) {
+        slots.push_back(rowContext.setVariable(column.name, 0.0));
+    }
+
+    BatchResult result;
+    result.rows = rows;
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            rowContext.setVariable(slots[i], columns[i].data[row]);
+        }
+        EvaluationResult value = evaluator_.evaluate(*ast, rowContext).toEvaluationResult();
+        if (value.isSuccess()) {
+            out[row] = value.getValue();
+            continue;
+        }
+        out[row] = std::numeric_limits<double>::quiet_NaN();
+        if (result.failedRows == 0) {
+            result.firstFailedRow = row;
+            result.firstError = value;
+        }
+        ++result.failedRows;
+    }
+    return result;
+}
+
+EvaluationContext& PrecisionMode::getContext() {
+    return context_;
+}
+
+const EvaluationContext& PrecisionMode::getContext() const {
+    return context_;
+}
+
+CacheStats PrecisionMode::getCacheStats() const {
+    return cache_.getStats();
+}
+
+void PrecisionMode::setCacheCapacity(size_t capacity) {
+    cache_.setCapacity(capacity);
+}
+
+void PrecisionMode::clearCache() {
+    cache_.clear();
+}
+
+//=============================================================================
+// Precision and Formatting
+//=============================================================================
+
+std::string PrecisionMode::formatResult(const BigFloatResult& result) const {
+    return result.getValue().toString(getDigits());
+}
+
+void PrecisionMode::setPrecision(int precision) {
+    if (precision < 1 || precision > MAX_DIGITS) {
+        throw std::invalid_argument("Precision must be from 1 to " + std::to_string(MAX_DIGITS) + " digits");
+    }
+    context_.setPrecision(precision);
+}
+
+int PrecisionMode::getPrecision() const {
+    return context_.getPrecision();
+}
+
+//=============================================================================
+// Private Methods
+//=============================================================================
+
+size_t PrecisionMode::getDigits() const {
+    return std::max<size_t>(1, static_cast<size_t>(context_.getPrecision()));
+}
+
+std::shared_ptr<const ASTNode> PrecisionMode::parse(const std::string& expression) {
+    std::shared_ptr<const ASTNode> ast = cache_.find(getName(), PARSER_TYPE, expression);
+    if (ast) {
+        return ast;
+    }
+
+    // Keep literal digits so that 0.1 is read as 0.1, not the double nearest it
+    ShuntingYardParser parser;
+    parser.setKeepLiteralDigits(true);
+
+    Tokenizer tokenizer(expression);
+    std::vector<Token> tokens = tokenizer.tokenize();
+
+    // Parse tokens into an arena-backed AST; the shared pointer keeps the
+    // arena alive for as long as the tree is in use
+    auto parsed = std::make_shared<ParsedExpression>(parser.parseToArena(tokens));
+    ast = std::shared_ptr<const ASTNode>(parsed, parsed->get());
+    cache_.insert(getName(), PARSER_TYPE, expression, ast);
+    return ast;
+}
+
+} // namespace calc
@@ -6,12 +6,21 @@
 #include "calc/modes/programmer_mode.h"
 #include "calc/core/shunting_yard_parser.h"
 #include "calc/core/tokenizer.h"
+#include "calc/core/ast_optimizer.h"
 
 namespace calc {
 
+namespace {
+
+// Programmer mode always parses with the shunting-yard parser
+const std::string PARSER_TYPE = "shunting-yard";
+
+} // anonymous namespace
+
 ProgrammerMode::ProgrammerMode(int precision)
     : context_(precision)
     , evaluator_()
+    , bigEvaluator_()
     , displayBase_(10)
     , precision_(precision)
 {
@@ -39,22 +48,68 @@ EvaluationResult ProgrammerMode::evaluate(const std::string& expression) {
         return EvaluationResult(ErrorCode::INVALID_SYNTAX, "Empty expression", 0);
     }
 
-    // Create parser
-    auto parser = createParser();
+    return evaluateInteger(expression).toEvaluationResult();
+}
 
-    // Create tokenizer
-    Tokenizer tokenizer(expression);
+IntegerResult ProgrammerMode::evaluateInteger(const std::string& expression) {
+    if (expression.empty()) {
+        return IntegerResult(ErrorCode::INVALID_SYNTAX, "Empty expression", 0);
+    }
 
-    // Tokenize the input
-    std::vector<Token> tokens = tokenizer.tokenize();
+    try {
+        std::shared_ptr<const ASTNode> ast = parse(expression);
+        return evaluator_.evaluate(*ast, context_);
+    } catch (const CalculatorException& e) {
+        return IntegerResult(e.getErrorCode(), e.what(), e.getPosition());
+    } catch (const std::exception& e) {
+        return IntegerResult(ErrorCode::PARSE_ERROR, e.what(), 0);
+    }
+}
+
+BigIntegerResult ProgrammerMode::evaluateBigInteger(const std::string& expression) {
+    if (expression.empty()) {
+        return BigIntegerResult(ErrorCode::INVALID_SYNTAX, "Empty expression", 0);
+    }
 
-    // Parse tokens into AST
-    std::unique_ptr<ASTNode> ast = parser->parse(tokens);
+    try {
+        std::shared_ptr<const ASTNode> ast = parse(expression);
+        return bigEvaluator_.evaluate(*ast, context_);
+    } catch (const CalculatorException& e) {
+        return BigIntegerResult(e.getErrorCode(), e.what(), e.getPosition());
+    } catch (const std::exception& e) {
+        return BigIntegerResult(ErrorCode::PARSE_ERROR, e.what(), 0);
+    }
+}
 
-    // Evaluate the AST
-    EvaluationResult result = evaluator_.evaluate(ast.get(), context_);
+BatchResult ProgrammerMode::evaluateBatch(const std::string& expression,
+                                          const std::vector<BatchColumn>& columns,
+                                          size_t rows, double* out) {
+    if (expression.empty()) {
+        return VirtualMachine::failBatch(
+            EvaluationResult(ErrorCode::INVALID_SYNTAX, "Empty expression", 0), rows, out);
+    }
 
-    return result;
+    std::shared_ptr<const ASTNode> ast;
+    try {
+        ast = parse(expression);
+    } catch (const CalculatorException& e) {
+        return VirtualMachine::failBatch(
+            EvaluationResult(e.getErrorCode(), e.what(), e.getPosition()), rows, out);
+    } catch (const std::exception& e) {
+        return VirtualMachine::failBatch(
+            EvaluationResult(ErrorCode::PARSE_ERROR, e.what(), 0), rows, out);
+    }
+
+    // Fold constant subexpressions once instead of once per row
+    std::vector<std::string> names;
+    names.reserve(columns.size());
+    for (const auto& column : columns) {
+        names.push_back(column.name);
+    }
+    ASTOptimizer optimizer(context_);
+    std::unique_ptr<ASTNode> optimized = optimizer.optimize(*ast, names);
+
+    return vm_.evaluateBatch(*optimized, context_, columns, rows, out);
 }
 
 EvaluationContext& ProgrammerMode::getContext() {
@@ -65,6 +120,18 @@ const EvaluationContext& ProgrammerMode::getContext() const {
     return context_;
 }
 
+CacheStats ProgrammerMode::getCacheStats() const {
+    return cache_.getStats();
+}
+
+void ProgrammerMode::setCacheCapacity(size_t capacity) {
+    cache_.setCapacity(capacity);
+}
+
+void ProgrammerMode::clearCache() {
+    cache_.clear();
+}
+
 //=============================================================================
 // Display Base Management
 //=============================================================================
@@ -85,24 +152,56 @@ std::vector<int> ProgrammerMode::getSupportedBases() const {
 }
 
 std::string ProgrammerMode::formatResult(long long value) const {
-    // Map base integer to NumberBase enum
-    NumberBase base;
-    switch (displayBase_) {
-        case 2:
-            base = NumberBase::BINARY;
-            break;
-        case 8:
-            base = NumberBase::OCTAL;
-            break;
-        case 16:
-            base = NumberBase::HEXADECIMAL;
-            break;
-        case 10:
-        default:
-            base = NumberBase::DECIMAL;
-            break;
+    return Converter::format(value, getDisplayNumberBase());
+}
+
+std::string ProgrammerMode::formatResult(const IntegerResult& result) const {
+    return formatInteger(result, getDisplayNumberBase());
+}
+
+std::string ProgrammerMode::formatInteger(const IntegerResult& result, NumberBase base) {
+    if (base == NumberBase::DECIMAL && result.isSigned()) {
+        return Converter::format(result.getSigned(), base);
     }
-    return Converter::format(value, base);
+    return Converter::formatUnsigned(result.getUnsigned(), base);
+}
+
+std::string ProgrammerMode::formatResult(const BigIntegerResult& result) const {
+    NumberBase base = getDisplayNumberBase();
+    const BigInteger& value = result.getValue();
+    if (base == NumberBase::DECIMAL || result.getWordBits() == 0) {
+        return Converter::format(value, base);
+    }
+    return Converter::format(value.wrap(result.getWordBits(), false), base);
+}
+
+//=============================================================================
+// Word Size Management
+//=============================================================================
+
+void ProgrammerMode::setWordSize(WordSize size) {
+    evaluator_.setWordSize(size);
+}
+
+WordSize ProgrammerMode::getWordSize() const {
+    return evaluator_.getWordSize();
+}
+
+void ProgrammerMode::setBigWordSize(size_t bits) {
+    bigEvaluator_.setWordBits(bits);
+}
+
+size_t ProgrammerMode::getBigWordSize() const {
+    return bigEvaluator_.getWordBits();
+}
+
+void ProgrammerMode::setSigned(bool isSigned) {
+    evaluator_.setSigned(isSigned);
+    bigEvaluator_.setSigned(isSigned);
+}
+
+bool ProgrammerMode::isSigned() const {
+    return evaluator_.isSigned();
 }
 
 //=============================================================================
@@ -130,6 +229,43 @@ std::unique_ptr<Parser> ProgrammerMode::createParser() const {
     return std::make_unique<ShuntingYardParser>();
 }
 
+std::shared_ptr<const ASTNode> ProgrammerMode::parse(const std::string& expression) {
+    std::shared_ptr<const ASTNode> ast = cache_.find(getName(), PARSER_TYPE, expression);
+    if (ast) {
+        return ast;
+    }
+
+    // Create parser
+    auto parser = createParser();
+
+    // Create tokenizer
+    Tokenizer tokenizer(expression);
+
+    // Tokenize the input
+    std::vector<Token> tokens = tokenizer.tokenize();
+
+    // Parse tokens into an arena-backed AST; the shared pointer keeps the
+    // arena alive for as long as the tree is in use
+    auto parsed = std::make_shared<ParsedExpression>(parser->parseToArena(tokens));
+    ast = std::shared_ptr<const ASTNode>(parsed, parsed->get());
+    cache_.insert(getName(), PARSER_TYPE, expression, ast);
+    return ast;
+}
+
+NumberBase ProgrammerMode::getDisplayNumberBase() const {
+    switch (displayBase_) {
+        case 2:
+            return NumberBase::BINARY;
+        case 8:
+            return NumberBase::OCTAL;
+        case 16:
+            return NumberBase::HEXADECIMAL;
+        case 10:
+        default:
+            return NumberBase::DECIMAL;
+    }
+}
+
 bool ProgrammerMode::isValidBase(int base) {
     return base == 2 || base == 8 || base == 10 || base == 16;
 }
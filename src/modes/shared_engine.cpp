@@ -0,0 +1,270 @@
+/**
+ * @file shared_engine.cpp
+ * @brief Thread-safe evaluation engine implementation
+ */
+
+#include "calc/modes/shared_engine.h"
+#include "calc/core/ast_optimizer.h"
+#include "calc/core/tokenizer.h"
+#include "calc/modes/precision_mode.h"
+#include "calc/modes/programmer_mode.h"
+#include <algorithm>
+#include <mutex>
+
+namespace calc {
+
+/**
+ * @brief A parsed and compiled expression, immutable once built
+ */
+struct EvaluationScratch::Program {
+    ParsedExpression parsed;      ///< Tree, kept for batch evaluation
+    CompiledExpression compiled;  ///< Bytecode for scalar evaluation
+};
+
+namespace {
+
+// Parser of the mode an engine is built from
+ParserType parserTypeOf(const Mode& mode) {
+    const auto* standard = dynamic_cast<const StandardMode*>(&mode);
+    return standard != nullptr ? standard->getParserKind() : ParserType::SHUNTING_YARD;
+}
+
+uint64_t nextEngineId() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+} // anonymous namespace
+
+SharedEngine::SharedEngine(const Mode& mode, size_t cacheCapacity)
+    : SharedEngine(mode.getName(), mode.getContext(), cacheCapacity, parserTypeOf(mode)) {
+    if (const auto* programmer = dynamic_cast<const ProgrammerMode*>(&mode)) {
+        integer_ = true;
+        wordSize_ = programmer->getWordSize();
+        signed_ = programmer->isSigned();
+        displayBase_ = programmer->getDisplayNumberBase();
+    } else if (dynamic_cast<const PrecisionMode*>(&mode) != nullptr) {
+        precise_ = true;
+        digits_ = std::max<size_t>(1, static_cast<size_t>(context_.getPrecision()));
+    }
+}
+
+SharedEngine::SharedEngine(std::string name, const EvaluationContext& context,
+                           size_t cacheCapacity, ParserType parserType)
+    : id_(nextEngineId())
+    , name_(std::move(name))
+    , context_(context)
+    , capacity_(cacheCapacity)
+    , parserType_(parserType) {
+}
+
+EvaluationResult SharedEngine::evaluate(std::string_view expression,
+                                        EvaluationScratch& scratch) const {
+    if (integer_) {
+        return evaluateInteger(expression, scratch).toEvaluationResult();
+    }
+    if (precise_) {
+        return evaluatePrecise(expression, scratch).toEvaluationResult();
+    }
+
+    try {
+        const Program& program = lookup(expression, scratch);
+        return scratch.vm_.execute(program.compiled);
+    } catch (const CalculatorException& e) {
+        return EvaluationResult(e.getErrorCode(), e.what(), e.getPosition());
+    } catch (const std::exception& e) {
+        return EvaluationResult(ErrorCode::EVALUATION_ERROR, e.what(), 0);
+    }
+}
+
+EvaluationResult SharedEngine::evaluate(std::string_view expression) const {
+    thread_local EvaluationScratch scratch;
+    return evaluate(expression, scratch);
+}
+
+IntegerResult SharedEngine::evaluateInteger(std::string_view expression,
+                                            EvaluationScratch& scratch) const {
+    try {
+        const Program& program = lookup(expression, scratch);
+        scratch.integer_.setWordSize(wordSize_);
+        scratch.integer_.setSigned(signed_);
+        return scratch.integer_.evaluate(*program.parsed, context_);
+    } catch (const CalculatorException& e) {
+        return IntegerResult(e.getErrorCode(), e.what(), e.getPosition());
+    } catch (const std::exception& e) {
+        return IntegerResult(ErrorCode::EVALUATION_ERROR, e.what(), 0);
+    }
+}
+
+std::string SharedEngine::formatInteger(const IntegerResult& result) const {
+    return ProgrammerMode::formatInteger(result, displayBase_);
+}
+
+BigFloatResult SharedEngine::evaluatePrecise(std::string_view expression,
+                                            EvaluationScratch& scratch) const {
+    // The context's precision may have been set directly, past MAX_DIGITS
+    if (digits_ > static_cast<size_t>(PrecisionMode::MAX_DIGITS)) {
+        return BigFloatResult(ErrorCode::EVALUATION_ERROR, "Precision must be at most " +
+                              std::to_string(PrecisionMode::MAX_DIGITS) + " digits");
+    }
+
+    try {
+        const Program& program = lookup(expression, scratch);
+        scratch.precise_.setPrecision(BigFloat::precisionForDigits(digits_) + PrecisionMode::GUARD_BITS);
+        return scratch.precise_.evaluate(*program.parsed, context_);
+    } catch (const CalculatorException& e) {
+        return BigFloatResult(e.getErrorCode(), e.what(), e.getPosition());
+    } catch (const std::exception& e) {
+        return BigFloatResult(ErrorCode::EVALUATION_ERROR, e.what(), 0);
+    }
+}
+
+std::string SharedEngine::formatPrecise(const BigFloatResult& result) const {
+    return result.getValue().toString(digits_);
+}
+
+BatchResult SharedEngine::evaluateBatch(const std::string& expression,
+                                        const std::vector<BatchColumn>& columns,
+                                        size_t rows, double* out,
+                                        EvaluationScratch& scratch) const {
+    const Program* program = nullptr;
+    try {
+        program = &lookup(expression, scratch);
+    } catch (const CalculatorException& e) {
+        return VirtualMachine::failBatch(
+            EvaluationResult(e.getErrorCode(), e.what(), e.getPosition()), rows, out);
+    }
+
+    // Fold constant subexpressions once instead of once per row
+    std::vector<std::string> names;
+    names.reserve(columns.size());
+    for (const auto& column : columns) {
+        names.push_back(column.name);
+    }
+    ASTOptimizer optimizer(context_);
+    std::unique_ptr<ASTNode> optimized = optimizer.optimize(*program->parsed, names);
+
+    return scratch.vm_.evaluateBatch(*optimized, context_, columns, rows, out);
+}
+
+size_t SharedEngine::preload(const ExpressionArchive& archive) {
+    size_t added = 0;
+    for (size_t i = 0; i < archive.size(); ++i) {
+        std::string source(archive.getSource(i));
+        if (source.empty()) {
+            continue;
+        }
+
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            if (programs_.size() >= capacity_) {
+                break;
+            }
+            if (programs_.count(source) != 0) {
+                continue;
+            }
+        }
+
+        ParsedExpression parsed = archive.load(i);
+        CompiledExpression compiled = CompiledExpression::compile(*parsed, context_);
+        auto program = std::make_shared<const Program>(Program{std::move(parsed), std::move(compiled)});
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (programs_.size() < capacity_ && programs_.emplace(std::move(source), std::move(program)).second) {
+            ++added;
+        }
+    }
+    return added;
+}
+
+CacheStats SharedEngine::getCacheStats() const {
+    CacheStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.capacity = capacity_;
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    stats.size = programs_.size();
+    return stats;
+}
+
+const SharedEngine::Program& SharedEngine::lookup(std::string_view expression,
+                                                  EvaluationScratch& scratch) const {
+    if (scratch.engineId_ != id_) {
+        scratch.programs_.clear();
+        scratch.engineId_ = id_;
+    }
+
+    // The maps are keyed by std::string; copy into the reused key, not a new string
+    scratch.key_.assign(expression.data(), expression.size());
+    const std::string& key = scratch.key_;
+
+    // Thread-local table first: no lock and no reference count traffic
+    auto local = scratch.programs_.find(key);
+    if (local != scratch.programs_.end()) {
+        return *local->second;
+    }
+
+    std::shared_ptr<const Program> program;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = programs_.find(key);
+        if (it != programs_.end()) {
+            program = it->second;
+        }
+    }
+
+    if (program) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        program = build(key);
+
+        if (capacity_ > 0) {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            if (programs_.size() >= capacity_ && programs_.find(key) == programs_.end()) {
+                // Programs are cheap to rebuild; drop an eighth rather than track recency
+                size_t evict = std::max<size_t>(1, capacity_ / 8);
+                evictions_.fetch_add(evict, std::memory_order_relaxed);
+                for (size_t i = 0; i < evict; ++i) {
+                    programs_.erase(programs_.begin());
+                }
+            }
+            // Keep the first program built if another thread raced us
+            program = programs_.emplace(key, program).first->second;
+        }
+    }
+
+    if (scratch.programs_.size() >= EvaluationScratch::LOCAL_CAPACITY) {
+        scratch.programs_.clear();
+    }
+    return *scratch.programs_.emplace(key, std::move(program)).first->second;
+}
+
+std::shared_ptr<const SharedEngine::Program> SharedEngine::build(std::string_view expression) const {
+    try {
+        std::vector<Token> tokens = Tokenizer::tokenize(expression);
+
+        if (tokens.empty() || (tokens.size() == 1 && tokens[0].type == TokenType::EOF_TOKEN)) {
+            throw CalculatorException(ErrorCode::PARSE_ERROR, "Empty expression", 0);
+        }
+
+        std::unique_ptr<Parser> parser = createParser(parserType_);
+        // Precise engines read 0.1 from its digits, not the double nearest it
+        parser->setKeepLiteralDigits(precise_);
+        ParsedExpression parsed = parser->parseToArena(tokens);
+        if (!parsed) {
+            throw CalculatorException(ErrorCode::PARSE_ERROR, "Failed to parse expression", 0);
+        }
+
+        CompiledExpression compiled = CompiledExpression::compile(*parsed, context_);
+        return std::make_shared<const Program>(Program{std::move(parsed), std::move(compiled)});
+    } catch (const CalculatorException&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw CalculatorException(ErrorCode::PARSE_ERROR, e.what(), 0);
+    }
+}
+
+} // namespace calc
@@ -5,14 +5,17 @@
 
 #include "calc/modes/standard_mode.h"
 #include "calc/core/tokenizer.h"
+#include "calc/core/ast_optimizer.h"
+#include "calc/core/expression_dag.h"
 #include "calc/core/shunting_yard_parser.h"
 #include "calc/core/recursive_descent_parser.h"
+#include "calc/core/pratt_parser.h"
 
 namespace calc {
 
 StandardMode::StandardMode(int precision)
     : context_(precision)
-    , useRecursiveDescentParser_(false) {
+    , parserType_(ParserType::SHUNTING_YARD) {
     // Configure operator semantics for Standard mode
     // '^' is power/exponentiation in Standard and Scientific modes
     context_.setOperatorSemantics("^", OperatorSemantics::POWER);
@@ -31,44 +34,65 @@ std::string StandardMode::getDescription() const {
 }
 
 EvaluationResult StandardMode::evaluate(const std::string& expression) {
-    // Step 1: Tokenize the expression
-    Tokenizer tokenizer(expression);
-    std::vector<Token> tokens;
+    // Steps 1-2: Tokenize and parse (skipped when this expression was parsed recently)
+    CachedExpression* cached = nullptr;
     try {
-        tokens = tokenizer.tokenize();
+        cached = &parse(expression);
     } catch (const CalculatorException& e) {
         return EvaluationResult(e.getErrorCode(), e.what(), e.getPosition());
-    } catch (const std::exception& e) {
-        return EvaluationResult(ErrorCode::PARSE_ERROR, e.what(), 0);
-    }
-
-    // Check for empty token list
-    if (tokens.empty() || (tokens.size() == 1 && tokens[0].type == TokenType::EOF_TOKEN)) {
-        return EvaluationResult(ErrorCode::PARSE_ERROR, "Empty expression", 0);
     }
 
-    // Step 2: Parse tokens into AST
-    auto parser = createParser();
-    std::unique_ptr<ASTNode> ast;
     try {
-        ast = parser->parse(tokens);
-        if (!ast) {
-            return EvaluationResult(ErrorCode::PARSE_ERROR, "Failed to parse expression", 0);
+        if (cache_.getCapacity() == 0) {
+            return evaluator_.evaluate(cached->ast.get(), context_);
+        }
+
+        // Step 3: Compile the tree, once per entry while the context's bindings hold
+        uint64_t revision = context_.getBindingRevision();
+        if (!cached->program || cached->revision != revision) {
+            cached->program = CompiledExpression::compile(*cached->ast, context_);
+            cached->revision = revision;
         }
+
+        // Step 4: Run the bytecode
+        return vm_.execute(*cached->program);
     } catch (const CalculatorException& e) {
         return EvaluationResult(e.getErrorCode(), e.what(), e.getPosition());
     } catch (const std::exception& e) {
-        return EvaluationResult(ErrorCode::PARSE_ERROR, e.what(), 0);
+        return EvaluationResult(ErrorCode::EVALUATION_ERROR, e.what(), 0);
     }
+}
 
-    // Step 3: Evaluate the AST
+BatchResult StandardMode::evaluateBatch(const std::string& expression,
+                                        const std::vector<BatchColumn>& columns,
+                                        size_t rows, double* out) {
+    std::shared_ptr<const ASTNode> ast;
     try {
-        return evaluator_.evaluate(ast.get(), context_);
+        ast = parse(expression).ast;
     } catch (const CalculatorException& e) {
-        return EvaluationResult(e.getErrorCode(), e.what(), e.getPosition());
-    } catch (const std::exception& e) {
-        return EvaluationResult(ErrorCode::EVALUATION_ERROR, e.what(), 0);
+        return VirtualMachine::failBatch(
+            EvaluationResult(e.getErrorCode(), e.what(), e.getPosition()), rows, out);
     }
+
+    // Fold constant subexpressions once instead of once per row
+    std::vector<std::string> names;
+    names.reserve(columns.size());
+    for (const auto& column : columns) {
+        names.push_back(column.name);
+    }
+    ASTOptimizer optimizer(context_);
+    std::unique_ptr<ASTNode> optimized = optimizer.optimize(*ast, names);
+
+    // Evaluate repeated subexpressions once per row rather than once per occurrence
+    ExpressionDag dag = ExpressionDag::build(*optimized, context_);
+    CompiledExpression program = CompiledExpression::compile(dag, context_, names);
+
+    std::vector<const double*> data;
+    data.reserve(columns.size());
+    for (const auto& column : columns) {
+        data.push_back(column.data);
+    }
+    return vm_.executeBatch(program, data, rows, out);
 }
 
 EvaluationContext& StandardMode::getContext() {
@@ -79,6 +103,18 @@ const EvaluationContext& StandardMode::getContext() const {
     return context_;
 }
 
+CacheStats StandardMode::getCacheStats() const {
+    return cache_.getStats();
+}
+
+void StandardMode::setCacheCapacity(size_t capacity) {
+    cache_.setCapacity(capacity);
+}
+
+void StandardMode::clearCache() {
+    cache_.clear();
+}
+
 void StandardMode::setPrecision(int precision) {
     context_.setPrecision(precision);
 }
@@ -88,16 +124,83 @@ int StandardMode::getPrecision() const {
 }
 
 std::string StandardMode::getParserType() const {
-    return useRecursiveDescentParser_ ? "recursive-descent" : "shunting-yard";
+    switch (parserType_) {
+        case ParserType::RECURSIVE_DESCENT:
+            return "recursive-descent";
+        case ParserType::PRATT:
+            return "pratt";
+        case ParserType::SHUNTING_YARD:
+            break;
+    }
+    return "shunting-yard";
+}
+
+ParserType StandardMode::getParserKind() const noexcept {
+    return parserType_;
 }
 
 void StandardMode::setParserType(bool useRecursiveDescent) {
-    useRecursiveDescentParser_ = useRecursiveDescent;
+    setParserType(useRecursiveDescent ? ParserType::RECURSIVE_DESCENT : ParserType::SHUNTING_YARD);
+}
+
+void StandardMode::setParserType(ParserType type) {
+    parserType_ = type;
+}
+
+CachedExpression& StandardMode::parse(const std::string& expression) {
+    const std::string modeName = getName();
+    const std::string parserType = getParserType();
+
+    CachedExpression* cached = cache_.lookup(modeName, parserType, expression);
+    if (cached != nullptr) {
+        return *cached;
+    }
+
+    std::shared_ptr<const ASTNode> ast;
+    try {
+        // Step 1: Tokenize the expression
+        Tokenizer tokenizer(expression);
+        std::vector<Token> tokens = tokenizer.tokenize();
+
+        // Check for empty token list
+        if (tokens.empty() || (tokens.size() == 1 && tokens[0].type == TokenType::EOF_TOKEN)) {
+            throw CalculatorException(ErrorCode::PARSE_ERROR, "Empty expression", 0);
+        }
+
+        // Step 2: Parse tokens into an arena-backed AST; the shared pointer
+        // keeps the arena alive for as long as the tree is in use
+        auto parser = createParser();
+        auto parsed = std::make_shared<ParsedExpression>(parser->parseToArena(tokens));
+        ast = std::shared_ptr<const ASTNode>(parsed, parsed->get());
+        if (!ast) {
+            throw CalculatorException(ErrorCode::PARSE_ERROR, "Failed to parse expression", 0);
+        }
+    } catch (const CalculatorException&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw CalculatorException(ErrorCode::PARSE_ERROR, e.what(), 0);
+    }
+
+    cached = cache_.insert(modeName, parserType, expression, ast);
+    if (cached != nullptr) {
+        return *cached;
+    }
+    uncached_.ast = std::move(ast);
+    return uncached_;
 }
 
 std::unique_ptr<Parser> StandardMode::createParser() const {
-    if (useRecursiveDescentParser_) {
-        return std::make_unique<RecursiveDescentParser>();
+    return calc::createParser(parserType_);
+}
+
+std::unique_ptr<Parser> createParser(ParserType type) {
+    switch (type) {
+        case ParserType::RECURSIVE_DESCENT:
+            return std::make_unique<RecursiveDescentParser>();
+        case ParserType::PRATT:
+            return std::make_unique<PrattParser>();
+        case ParserType::SHUNTING_YARD:
+            break;
     }
     return std::make_unique<ShuntingYardParser>();
 }
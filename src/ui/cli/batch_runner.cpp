@@ -0,0 +1,250 @@
+/**
+ * @file batch_runner.cpp
+ * @brief Parallel batch evaluation implementation
+ */
+
+#include "calc/ui/cli/batch_runner.h"
+#include "calc/ui/cli/output_formatter.h"
+#include "calc/modes/programmer_mode.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief One chunk of input lines and their results, waiting to be written
+ */
+struct BatchRunner::Chunk {
+    std::string input;          ///< Lines back to back, without terminators
+    std::vector<size_t> ends;   ///< Offset in input just past each line
+    std::string output;         ///< Output records, reused from chunk to chunk
+    size_t evaluated = 0;
+    size_t failed = 0;
+    bool done = false;          ///< Evaluated and not yet written; guarded by the run's mutex
+};
+
+namespace {
+
+// Read up to @p count lines into @p input and @p ends, reusing their storage
+size_t readChunk(std::istream& in, std::string& input, std::vector<size_t>& ends, size_t count,
+                 std::string& line, size_t& bytesRead) {
+    input.clear();
+    ends.clear();
+    while (ends.size() < count && std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        input += line;
+        ends.push_back(input.size());
+    }
+    bytesRead += input.size();
+    return ends.size();
+}
+
+} // anonymous namespace
+
+bool isBlankLine(std::string_view line) {
+    return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+bool appendLineResult(const SharedEngine& engine, std::string_view line,
+                      EvaluationScratch& scratch, std::string& out, ResultFormat format) {
+    if (isBlankLine(line)) {
+        OutputFormatter::appendBlankRecord(out, format);
+        return false;
+    }
+
+    if (engine.isInteger()) {
+        IntegerResult integer = engine.evaluateInteger(line, scratch);
+        if (format == ResultFormat::TEXT && integer.isSuccess()) {
+            out += engine.formatInteger(integer);
+            out += '\n';
+            return false;
+        }
+        if (integer.isSuccess() && format != ResultFormat::BINARY) {
+            // Decimal, so that words past 2^53 are not rounded through a double
+            OutputFormatter::appendRecord(out, format, line, integer.toEvaluationResult(),
+                                          ProgrammerMode::formatInteger(integer, NumberBase::DECIMAL));
+            return false;
+        }
+        OutputFormatter::appendRecord(out, format, line, integer.toEvaluationResult());
+        return integer.isError();
+    }
+
+    if (engine.isPrecise()) {
+        BigFloatResult precise = engine.evaluatePrecise(line, scratch);
+        if (format == ResultFormat::TEXT && precise.isSuccess()) {
+            out += engine.formatPrecise(precise);
+            out += '\n';
+            return false;
+        }
+        OutputFormatter::appendRecord(out, format, line, precise.toEvaluationResult());
+        return precise.isError();
+    }
+
+    EvaluationResult result = engine.evaluate(line, scratch);
+    OutputFormatter::appendRecord(out, format, line, result, engine.getContext().getPrecision());
+    return result.isError();
+}
+
+std::string BatchStats::toString() const {
+    std::ostringstream oss;
+    oss << lines << " lines, " << evaluated << " evaluated, " << failed << " failed in "
+        << std::fixed << std::setprecision(3) << seconds << " s";
+    if (seconds > 0.0) {
+        oss << " (" << std::setprecision(0) << static_cast<double>(evaluated) / seconds
+            << " expr/s, " << std::setprecision(1)
+            << static_cast<double>(bytesRead) / seconds / (1024.0 * 1024.0) << " MiB/s";
+        oss << ", " << workers << (workers == 1 ? " worker)" : " workers)");
+    }
+    return oss.str();
+}
+
+BatchRunner::BatchRunner(const SharedEngine& engine, unsigned workers, size_t chunkLines)
+    : engine_(engine)
+    , chunkLines_(chunkLines > 0 ? chunkLines : DEFAULT_CHUNK_LINES) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    scratch_.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) {
+        scratch_.push_back(std::make_unique<EvaluationScratch>());
+    }
+}
+
+BatchRunner::~BatchRunner() = default;
+
+BatchStats BatchRunner::run(std::istream& in, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+
+    BatchStats stats;
+    stats.workers = getWorkerCount();
+
+    // Chunk k is read into slot k % slots.size() once chunk k - slots.size() is written
+    std::vector<Chunk> slots(CHUNKS_PER_WORKER * scratch_.size());
+    std::mutex mutex;
+    std::condition_variable read;
+    std::condition_variable evaluated;
+    size_t nextRead = 0;   // Written by the calling thread, under the mutex
+    size_t nextChunk = 0;
+    size_t nextWrite = 0;
+    bool inputDone = false;
+
+    auto work = [&](EvaluationScratch& scratch) {
+        for (;;) {
+            size_t k;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                read.wait(lock, [&] { return nextChunk < nextRead || inputDone; });
+                if (nextChunk >= nextRead) {
+                    return;
+                }
+                k = nextChunk++;
+            }
+
+            Chunk& chunk = slots[k % slots.size()];
+            evaluateChunk(chunk, scratch);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunk.done = true;
+            }
+            evaluated.notify_one();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(scratch_.size());
+    for (auto& scratch : scratch_) {
+        threads.emplace_back(work, std::ref(*scratch));
+    }
+
+    const std::string_view header = OutputFormatter::recordHeader(format_);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // Write the oldest chunk once it is evaluated, and read ahead until then
+    std::string line;
+    for (;;) {
+        bool oldestDone;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            oldestDone = nextWrite < nextRead && slots[nextWrite % slots.size()].done;
+        }
+
+        if (!oldestDone && !inputDone && nextRead < nextWrite + slots.size()) {
+            Chunk& chunk = slots[nextRead % slots.size()];
+            size_t lines = readChunk(in, chunk.input, chunk.ends, chunkLines_, line, stats.bytesRead);
+            stats.lines += lines;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (lines > 0) {
+                    ++nextRead;
+                } else {
+                    inputDone = true;
+                }
+            }
+            if (lines > 0) {
+                read.notify_one();
+            } else {
+                read.notify_all();
+            }
+            continue;
+        }
+
+        if (nextWrite == nextRead) {
+            break;
+        }
+
+        Chunk& chunk = slots[nextWrite % slots.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            evaluated.wait(lock, [&] { return chunk.done; });
+        }
+
+        out.write(chunk.output.data(), static_cast<std::streamsize>(chunk.output.size()));
+        stats.evaluated += chunk.evaluated;
+        stats.failed += chunk.failed;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk.done = false;
+        }
+        ++nextWrite;
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    out.flush();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+void BatchRunner::evaluateChunk(Chunk& chunk, EvaluationScratch& scratch) const {
+    chunk.output.clear();
+    chunk.evaluated = 0;
+    chunk.failed = 0;
+
+    const std::string_view input = chunk.input;
+    size_t begin = 0;
+    for (size_t end : chunk.ends) {
+        std::string_view line = input.substr(begin, end - begin);
+        if (!isBlankLine(line)) {
+            ++chunk.evaluated;
+        }
+        if (appendLineResult(engine_, line, scratch, chunk.output, format_)) {
+            ++chunk.failed;
+        }
+        begin = end;
+    }
+}
+
+} // namespace cli
+} // namespace calc
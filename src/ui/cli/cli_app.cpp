@@ -4,20 +4,46 @@
  */
 
 #include "calc/ui/cli/cli_app.h"
+#include "calc/ui/cli/batch_runner.h"
+#include "calc/ui/cli/mapped_runner.h"
+#include "calc/ui/cli/stream_runner.h"
 #include "calc/ui/cli/command_parser.h"
+#include "calc/ui/cli/daemon_client.h"
+#include "calc/ui/cli/daemon_server.h"
+#include "calc/modes/shared_engine.h"
 #include "calc/modes/standard_mode.h"
+#include "calc/modes/precision_mode.h"
+#include "calc/modes/programmer_mode.h"
+#include <fstream>
 #include <iostream>
+#include <iomanip>
 #include <algorithm>
+#include <atomic>
+#include <csignal>
 #include <sstream>
 
 namespace calc {
 namespace cli {
 
+namespace {
+
+// Daemon stopped by SIGINT and SIGTERM
+std::atomic<DaemonServer*> servingDaemon{nullptr};
+
+extern "C" void stopServingDaemon(int) {
+    if (DaemonServer* daemon = servingDaemon.load()) {
+        daemon->stop();
+    }
+}
+
+} // anonymous namespace
+
 CliApp::CliApp(int argc, char* argv[])
     : argc_(argc)
     , argv_(argv)
     , formatter_(ColorMode::AUTO, true, true)  // Auto color, show expression, enable syntax highlight
-    , currentMode_(nullptr) {
+    , currentMode_(nullptr)
+    , bigWords_(false) {
 }
 
 int CliApp::run() {
@@ -38,14 +64,32 @@ int CliApp::run() {
         return 0;
     }
 
+    // Wide words are evaluated by ProgrammerMode itself, not by the shared engines
+    if (options.bigWordBits.has_value() && (options.connectPath.has_value() || options.servePath.has_value() ||
+                                            options.batchInput.has_value() || options.streamInput)) {
+        std::cerr << "Error: --bits applies to single expressions and interactive mode only" << std::endl;
+        return 1;
+    }
+
+    // A thin client needs no modes of its own
+    if (options.connectPath.has_value()) {
+        return runClientMode(options);
+    }
+
     // Process options and get mode
     int result = processOptions(options);
     if (result != 0) {
         return result;
     }
 
-    // Run in interactive mode or evaluate expression
-    if (options.interactive) {
+    // Run as a daemon, in batch mode, streaming mode, interactive mode or evaluate expression
+    if (options.servePath.has_value()) {
+        return runServeMode(options);
+    } else if (options.batchInput.has_value()) {
+        return runBatchMode(options);
+    } else if (options.streamInput) {
+        return runStreamMode(options);
+    } else if (options.interactive) {
         return runInteractiveMode(options);
     } else if (options.expression.has_value()) {
         return evaluateExpression(options.expression.value(), options);
@@ -79,10 +123,28 @@ int CliApp::processOptions(const CommandLineOptions& options) {
         currentMode_->getContext().setPrecision(options.precision.value());
     }
 
-    // Set parser type
-    if (options.mode == "standard") {
-        auto* stdMode = dynamic_cast<calc::StandardMode*>(currentMode_);
-        if (stdMode) {
+    // Programmer words wider than 64 bits
+    if (options.bigWordBits.has_value()) {
+        auto* programmerMode = dynamic_cast<ProgrammerMode*>(currentMode_);
+        if (programmerMode == nullptr) {
+            std::cerr << "Error: --bits requires programmer mode" << std::endl;
+            return 1;
+        }
+        try {
+            programmerMode->setBigWordSize(options.bigWordBits.value());
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        bigWords_ = true;
+    }
+
+    // Set parser type (standard mode and the modes built on it)
+    auto* stdMode = dynamic_cast<calc::StandardMode*>(currentMode_);
+    if (stdMode) {
+        if (options.parser == "pratt") {
+            stdMode->setParserType(ParserType::PRATT);
+        } else {
             stdMode->setParserType(options.useRecursiveDescent);
         }
     }
@@ -91,10 +153,31 @@ int CliApp::processOptions(const CommandLineOptions& options) {
 }
 
 int CliApp::evaluateExpression(const std::string& expression, const CommandLineOptions& options) {
-    EvaluationResult result = currentMode_->evaluate(expression);
+    std::optional<std::string> digits;
+    std::optional<std::string> word;
+    EvaluationResult result = evaluateInCurrentMode(expression, digits, &word);
+    return reportResult(expression, result, digits, options, word);
+}
+
+int CliApp::reportResult(const std::string& expression, const EvaluationResult& result,
+                         const std::optional<std::string>& digits, const CommandLineOptions& options,
+                         const std::optional<std::string>& word) {
+    // Machine-readable records go to stdout, errors included
+    if (options.format != ResultFormat::TEXT) {
+        std::string record(OutputFormatter::recordHeader(options.format));
+        if (word) {
+            OutputFormatter::appendRecord(record, options.format, expression, result, *word);
+        } else {
+            OutputFormatter::appendRecord(record, options.format, expression, result);
+        }
+        std::cout.write(record.data(), static_cast<std::streamsize>(record.size()));
+        std::cout.flush();
+        return result.isSuccess() ? 0 : 1;
+    }
 
     if (result.isSuccess()) {
-        std::cout << formatter_.formatResult(expression, result) << std::endl;
+        std::cout << (digits ? formatter_.formatResult(expression, *digits)
+                             : formatter_.formatResult(expression, result)) << std::endl;
         return 0;
     } else {
         std::cerr << formatter_.formatError(expression, result) << std::endl;
@@ -102,6 +185,210 @@ int CliApp::evaluateExpression(const std::string& expression, const CommandLineO
     }
 }
 
+EvaluationResult CliApp::evaluateInCurrentMode(const std::string& expression,
+                                               std::optional<std::string>& digits,
+                                               std::optional<std::string>* word) {
+    // Programmer words are printed exactly, not through a double
+    if (auto* programmerMode = dynamic_cast<ProgrammerMode*>(currentMode_)) {
+        if (bigWords_) {
+            BigIntegerResult result = programmerMode->evaluateBigInteger(expression);
+            if (result.isError()) {
+                return result.toEvaluationResult();
+            }
+            // The digits are exact; the double may round, or overflow to infinity
+            digits = programmerMode->formatResult(result);
+            if (word != nullptr) {
+                *word = result.getValue().toString();
+            }
+            return EvaluationResult(result.getValue().toDouble());
+        }
+        IntegerResult result = programmerMode->evaluateInteger(expression);
+        if (result.isSuccess()) {
+            digits = programmerMode->formatResult(result);
+            if (word != nullptr) {
+                *word = ProgrammerMode::formatInteger(result, NumberBase::DECIMAL);
+            }
+        }
+        return result.toEvaluationResult();
+    }
+
+    auto* precisionMode = dynamic_cast<PrecisionMode*>(currentMode_);
+    if (!precisionMode) {
+        return currentMode_->evaluate(expression);
+    }
+
+    BigFloatResult result = precisionMode->evaluatePrecise(expression);
+    if (result.isError()) {
+        return result.toEvaluationResult();
+    }
+    digits = precisionMode->formatResult(result);
+    return EvaluationResult(result.getValue().toDouble());
+}
+
+int CliApp::runBatchMode(const CommandLineOptions& options) {
+    const std::string& path = options.batchInput.value();
+
+    // Nothing else writes to the standard streams during a batch run
+    std::ios::sync_with_stdio(false);
+
+    std::ofstream outputFile;
+    std::ostream* out = openOutput(options, outputFile);
+    if (out == nullptr) {
+        return 1;
+    }
+
+    SharedEngine engine(*currentMode_);
+    BatchStats stats;
+    if (path == "-") {
+        BatchRunner runner(engine, options.jobs);
+        runner.setFormat(options.format);
+        stats = runner.run(std::cin, *out);
+    } else {
+        MappedFile input;
+        try {
+            input = MappedFile::open(path);
+        } catch (const std::runtime_error&) {
+            std::cerr << "Error: Cannot open batch input '" << path << "'" << std::endl;
+            return 1;
+        }
+        MappedRunner runner(engine, options.jobs);
+        runner.setFormat(options.format);
+        stats = runner.run(input.view(), *out);
+    }
+
+    if (!*out) {
+        std::cerr << "Error: Cannot write batch output" << std::endl;
+        return 1;
+    }
+    std::cerr << stats.toString() << std::endl;
+    return stats.failed > 0 ? 1 : 0;
+}
+
+std::ostream* CliApp::openOutput(const CommandLineOptions& options, std::ofstream& file) {
+    if (!options.outputPath.has_value()) {
+        return &std::cout;
+    }
+
+    file.open(options.outputPath.value(), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Error: Cannot open output '" << options.outputPath.value() << "'" << std::endl;
+        return nullptr;
+    }
+    return &file;
+}
+
+int CliApp::runStreamMode(const CommandLineOptions& options) {
+    // Nothing else writes to the standard streams while streaming
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    std::ofstream outputFile;
+    std::ostream* out = openOutput(options, outputFile);
+    if (out == nullptr) {
+        return 1;
+    }
+
+    SharedEngine engine(*currentMode_);
+    StreamRunner runner(engine, options.flushEvery);
+    runner.setFormat(options.format);
+    BatchStats stats = runner.run(std::cin, *out);
+
+    return stats.failed > 0 ? 1 : 0;
+}
+
+int CliApp::runServeMode(const CommandLineOptions& options) {
+    const std::string& path = options.servePath.value();
+    int result = 0;
+    try {
+        DaemonServer server(modeManager_, currentMode_->getName(), options.jobs);
+        server.listen(path);
+
+        servingDaemon.store(&server);
+        auto previousInterrupt = std::signal(SIGINT, stopServingDaemon);
+        auto previousTerminate = std::signal(SIGTERM, stopServingDaemon);
+
+        std::cerr << "Serving " << currentMode_->getName() << " mode on " << path << " with "
+                  << server.getWorkerCount() << (server.getWorkerCount() == 1 ? " worker" : " workers")
+                  << std::endl;
+        try {
+            server.run();
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            result = 1;
+        }
+
+        std::signal(SIGINT, previousInterrupt);
+        std::signal(SIGTERM, previousTerminate);
+        servingDaemon.store(nullptr);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        result = 1;
+    }
+    return result;
+}
+
+int CliApp::runClientMode(const CommandLineOptions& options) {
+    formatter_.setColorMode(options.colorMode);
+
+    DaemonRequest request;
+    request.mode = options.mode;
+    request.precision = options.precision.value_or(-1);
+
+    try {
+        DaemonClient client = DaemonClient::connect(options.connectPath.value());
+
+        if (options.batchInput.has_value() || options.streamInput) {
+            std::ios::sync_with_stdio(false);
+            std::cin.tie(nullptr);
+
+            std::ifstream inputFile;
+            std::istream* in = &std::cin;
+            if (options.batchInput.has_value() && options.batchInput.value() != "-") {
+                inputFile.open(options.batchInput.value(), std::ios::binary);
+                if (!inputFile) {
+                    std::cerr << "Error: Cannot open batch input '" << options.batchInput.value() << "'" << std::endl;
+                    return 1;
+                }
+                in = &inputFile;
+            }
+
+            std::ofstream outputFile;
+            std::ostream* out = openOutput(options, outputFile);
+            if (out == nullptr) {
+                return 1;
+            }
+
+            BatchStats stats = client.run(*in, *out, request, options.format,
+                                          options.batchInput.has_value() ? 0 : options.flushEvery);
+            if (options.batchInput.has_value()) {
+                std::cerr << stats.toString() << std::endl;
+            }
+            return stats.failed > 0 ? 1 : 0;
+        }
+
+        if (!options.expression.has_value()) {
+            std::cout << CommandParser::getHelpMessage() << std::endl;
+            return 0;
+        }
+
+        const std::string& expression = options.expression.value();
+        request.expressions.push_back(expression);
+        DaemonResponse response = client.evaluate(request);
+        if (!response.error.empty() || response.results.size() != 1) {
+            std::cerr << "Error: " << (response.error.empty() ? "Calc daemon sent no result" : response.error)
+                      << std::endl;
+            return 1;
+        }
+
+        const DaemonResult& result = response.results.front();
+        return reportResult(expression, result.toEvaluationResult(),
+                            std::optional<std::string>(result.text), options);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
 int CliApp::runInteractiveMode(const CommandLineOptions& options) {
     printBanner();
 
@@ -149,7 +436,8 @@ bool CliApp::evaluateREPLExpression(REPLState& state, const std::string& line, c
     auto expanded = state.historyManager.expandHistoryReference(line);
     std::string expressionToEval = expanded.has_value() ? *expanded : line;
 
-    EvaluationResult result = currentMode_->evaluate(expressionToEval);
+    std::optional<std::string> digits;
+    EvaluationResult result = evaluateInCurrentMode(expressionToEval, digits);
 
     if (result.isSuccess()) {
         state.lastResult = result.getValue();
@@ -160,7 +448,8 @@ bool CliApp::evaluateREPLExpression(REPLState& state, const std::string& line, c
 
         std::cout << "  [" << state.historyManager.size() << "] ";
         std::cout << formatter_.formatExpression(line) << std::endl;
-        std::cout << "  = " << formatter_.formatResult(result) << std::endl;
+        std::cout << "  = " << (digits ? formatter_.formatResult("", *digits)
+                                       : formatter_.formatResult(result)) << std::endl;
         std::cout << std::endl;
     } else {
         // Add failure to history
@@ -209,6 +498,7 @@ void CliApp::printREPLHelp() {
     std::cout << "  history [N]    - Show calculation history (N entries or all)" << std::endl;
     std::cout << "  search <kw>    - Search history by keyword" << std::endl;
     std::cout << "  export <file>  - Export history to file" << std::endl;
+    std::cout << "  cache [clear|size <n>] - Show or manage the parsed-expression cache" << std::endl;
     std::cout << std::endl;
     std::cout << "History references:" << std::endl;
     std::cout << "  !!             - Use last result" << std::endl;
@@ -250,6 +540,8 @@ bool CliApp::processREPLCommand(const std::string& command, REPLState& state, co
         handleSearchCommand(state, args);
     } else if (cmd == "export") {
         handleExportCommand(state, args);
+    } else if (cmd == "cache") {
+        handleCacheCommand(args);
     } else {
         std::cout << "Unknown command: " << cmd << std::endl;
         std::cout << "Type 'help' for available commands." << std::endl;
@@ -405,6 +697,48 @@ void CliApp::handleExportCommand(const REPLState& state, const std::string& file
     std::cout << std::endl;
 }
 
+void CliApp::handleCacheCommand(const std::string& args) {
+    if (args == "clear") {
+        currentMode_->clearCache();
+        std::cout << "Expression cache cleared." << std::endl;
+        return;
+    }
+
+    if (args.rfind("size", 0) == 0) {
+        std::string value = trim(args.substr(4));
+        try {
+            if (value.empty() || value[0] == '-') {
+                throw std::invalid_argument(value);
+            }
+            size_t capacity = std::stoull(value);
+            currentMode_->setCacheCapacity(capacity);
+            std::cout << "Cache size set to " << capacity << "." << std::endl;
+        } catch (const std::exception&) {
+            std::cout << "Error: Invalid cache size: " << value << std::endl;
+        }
+        return;
+    }
+
+    if (!args.empty()) {
+        std::cout << "Usage: cache [clear|size <n>]" << std::endl;
+        return;
+    }
+
+    CacheStats stats = currentMode_->getCacheStats();
+    size_t lookups = stats.hits + stats.misses;
+    double hitRate = lookups == 0 ? 0.0
+        : 100.0 * static_cast<double>(stats.hits) / static_cast<double>(lookups);
+
+    std::cout << "Expression cache (" << currentMode_->getName() << " mode):" << std::endl;
+    std::cout << "  Entries:   " << stats.size << " / " << stats.capacity << std::endl;
+    std::cout << "  Hits:      " << stats.hits << std::endl;
+    std::cout << "  Misses:    " << stats.misses << std::endl;
+    std::cout << "  Evictions: " << stats.evictions << std::endl;
+    std::ostringstream rate;
+    rate << std::fixed << std::setprecision(1) << hitRate << "%";
+    std::cout << "  Hit rate:  " << rate.str() << std::endl;
+}
+
 std::string CliApp::trim(const std::string& str) {
     size_t first = str.find_first_not_of(" \t\n\r");
     if (first == std::string::npos) {
@@ -432,7 +766,7 @@ bool CliApp::isREPLCommand(const std::string& line) {
     return cmd == "quit" || cmd == "exit" || cmd == "help" || cmd == "?" ||
            cmd == "clear" || cmd == "mode" || cmd == "precision" ||
            cmd == "prec" || cmd == "history" || cmd == "hist" ||
-           cmd == "search" || cmd == "export";
+           cmd == "search" || cmd == "export" || cmd == "cache";
 }
 
 } // namespace cli
@@ -32,12 +32,33 @@ std::string CommandParser::getHelpMessage() {
         << "  -h, --help              Show this help message and exit\n"
         << "  -v, --version           Show version information and exit\n"
         << "  -m, --mode <mode>      Set calculator mode (default: standard)\n"
-        << "                          Available modes: standard\n"
-        << "  -p, --precision <num>   Set output precision (default: 6)\n"
+        << "                          Available modes: standard,\n"
+        << "                          scientific, programmer, precision\n"
+        << "  -p, --precision <num>   Set output precision (default: 6), or the\n"
+        << "                          significant digits in precision mode (default: 50)\n"
+        << "  --bits <num>            Evaluate programmer mode on <num>-bit words,\n"
+        << "                          e.g. 128 or 4096 (0 = unbounded)\n"
         << "  -r, --recursive         Use recursive descent parser\n"
+        << "  --parser <name>         Parser to use: shunting-yard (default),\n"
+        << "                          recursive-descent or pratt\n"
         << "  -i, --interactive      Run in interactive (REPL) mode\n"
         << "  --color[=MODE]         Enable colored output\n"
         << "                          MODE: auto (default), always, never\n"
+        << "  --batch <file|->        Evaluate one expression per line of a file\n"
+        << "                          (or stdin) and print one result per line;\n"
+        << "                          files are memory-mapped and split across workers\n"
+        << "  -j, --jobs <num>        Batch worker threads (default: one per core)\n"
+        << "  --stdin                 Filter stdin to stdout, one result per line,\n"
+        << "                          with no prompt and buffered output\n"
+        << "  --flush-every <num>     Flush streamed output every <num> lines\n"
+        << "  -o, --output <file>     Write --batch or --stdin results to a file\n"
+        << "  --format <name>         Result format: text (default), jsonl, csv, tsv\n"
+        << "                          or binary (9-byte records: little-endian double,\n"
+        << "                          then 0 = value, 1 + error code, 255 = blank line)\n"
+        << "  --serve <socket>        Run as a daemon answering evaluation requests on\n"
+        << "                          a Unix domain socket (-j sets its workers)\n"
+        << "  --connect <socket>      Evaluate on the daemon at <socket> instead of\n"
+        << "                          in this process (expression, --stdin or --batch)\n"
         << "\n"
         << "Standard Mode Operations:\n"
         << "  +  -  *  /  ^          Basic arithmetic operations\n"
@@ -50,6 +71,12 @@ std::string CommandParser::getHelpMessage() {
         << "  calc -i\n"
         << "  calc -m standard \"(2 + 3) * 4\"\n"
         << "  calc --color=always \"sin(PI/2)\"\n"
+        << "  calc -m programmer --bits 128 \"0xFFFFFFFFFFFFFFFF << 64\"\n"
+        << "  calc -m scientific -j 4 --batch input.txt -o results.txt\n"
+        << "  generate_expressions | calc --stdin --flush-every 100 | consumer\n"
+        << "  calc --format=jsonl --batch input.txt -o results.jsonl\n"
+        << "  calc -m scientific --serve /tmp/calc.sock &\n"
+        << "  calc --connect /tmp/calc.sock -m scientific \"sin(PI/2)\"\n"
         << "\n"
         << "For more information, visit: https://github.com/yourusername/calc";
     return oss.str();
@@ -97,8 +124,127 @@ CommandLineOptions CommandParser::parse() {
                 options.showHelp = true;
             }
         }
+        else if (arg == "--bits") {
+            if (i + 1 < argc_) {
+                auto bits = parseNumber(argv_[++i]);
+                if (bits.has_value()) {
+                    options.bigWordBits = static_cast<size_t>(bits.value());
+                } else {
+                    std::cerr << "Error: Invalid word size\n";
+                    options.showHelp = true;
+                }
+            } else {
+                std::cerr << "Error: --bits requires an argument\n";
+                options.showHelp = true;
+            }
+        }
+        else if (arg == "--batch") {
+            if (i + 1 < argc_) {
+                options.batchInput = argv_[++i];
+            } else {
+                std::cerr << "Error: --batch requires an argument\n";
+                options.showHelp = true;
+            }
+        }
+        else if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 < argc_) {
+                auto jobs = parseNumber(argv_[++i]);
+                if (jobs.has_value()) {
+                    options.jobs = static_cast<unsigned>(jobs.value());
+                } else {
+                    std::cerr << "Error: Invalid number of jobs\n";
+                    options.showHelp = true;
+                }
+            } else {
+                std::cerr << "Error: --jobs requires an argument\n";
+                options.showHelp = true;
+            }
+        }
+        else if (arg == "-o" || arg == "--output") {
+            if (i + 1 < argc_) {
+                options.outputPath = argv_[++i];
+            } else {
+                std::cerr << "Error: --output requires an argument\n";
+                options.showHelp = true;
+            }
+        }
+        else if (arg == "--format" && i + 1 >= argc_) {
+            std::cerr << "Error: --format requires an argument\n";
+            options.showHelp = true;
+        }
+        else if (arg == "--format" || arg.find("--format=") == 0) {
+            std::string name = (arg == "--format") ? argv_[++i] : arg.substr(9);  // Skip "--format="
+            if (name == "text") {
+                options.format = ResultFormat::TEXT;
+            } else if (name == "jsonl") {
+                options.format = ResultFormat::JSONL;
+            } else if (name == "csv") {
+                options.format = ResultFormat::CSV;
+            } else if (name == "tsv") {
+                options.format = ResultFormat::TSV;
+            } else if (name == "binary") {
+                options.format = ResultFormat::BINARY;
+            } else {
+                std::cerr << "Error: Invalid format: " << name << "\n";
+                std::cerr << "Valid values: text, jsonl, csv, tsv, binary\n";
+                options.showHelp = true;
+            }
+        }
+        else if (arg == "--serve") {
+            if (i + 1 < argc_) {
+                options.servePath = argv_[++i];
+            } else {
+                std::cerr << "Error: --serve requires an argument\n";
+                options.showHelp = true;
+            }
+        }
+        else if (arg == "--connect") {
+            if (i + 1 < argc_) {
+                options.connectPath = argv_[++i];
+            } else {
+                std::cerr << "Error: --connect requires an argument\n";
+                options.showHelp = true;
+            }
+        }
+        else if (arg == "--stdin") {
+            options.streamInput = true;
+        }
+        else if (arg == "--flush-every") {
+            if (i + 1 < argc_) {
+                auto lines = parseNumber(argv_[++i]);
+                if (lines.has_value() && lines.value() > 0) {
+                    options.flushEvery = static_cast<size_t>(lines.value());
+                } else {
+                    std::cerr << "Error: Invalid number of lines to flush after\n";
+                    options.showHelp = true;
+                }
+            } else {
+                std::cerr << "Error: --flush-every requires an argument\n";
+                options.showHelp = true;
+            }
+        }
         else if (arg == "-r" || arg == "--recursive") {
             options.useRecursiveDescent = true;
+            options.parser = "recursive-descent";
+        }
+        else if (arg == "--parser") {
+            if (i + 1 < argc_) {
+                std::string name = argv_[++i];
+                if (name == "recursive") {
+                    name = "recursive-descent";
+                }
+                if (name == "shunting-yard" || name == "recursive-descent" || name == "pratt") {
+                    options.parser = name;
+                    options.useRecursiveDescent = (name == "recursive-descent");
+                } else {
+                    std::cerr << "Error: Invalid parser: " << name << "\n";
+                    std::cerr << "Valid values: shunting-yard, recursive-descent, pratt\n";
+                    options.showHelp = true;
+                }
+            } else {
+                std::cerr << "Error: --parser requires an argument\n";
+                options.showHelp = true;
+            }
         }
         else if (arg == "-i" || arg == "--interactive") {
             options.interactive = true;
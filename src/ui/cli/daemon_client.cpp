@@ -0,0 +1,224 @@
+/**
+ * @file daemon_client.cpp
+ * @brief Daemon client implementation
+ */
+
+#include "calc/ui/cli/daemon_client.h"
+#include "calc/ui/cli/output_formatter.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace calc {
+namespace cli {
+
+namespace {
+
+[[noreturn]] void throwSystemError(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+} // anonymous namespace
+
+DaemonClient::~DaemonClient() {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+DaemonClient::DaemonClient(DaemonClient&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1))
+    , buffer_(std::move(other.buffer_)) {
+}
+
+DaemonClient& DaemonClient::operator=(DaemonClient&& other) noexcept {
+    if (this != &other) {
+        DaemonClient closed(std::move(*this));
+        fd_ = std::exchange(other.fd_, -1);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+DaemonClient DaemonClient::connect(const std::string& path) {
+#ifndef _WIN32
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path '" + path + "'");
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    DaemonClient client;
+    client.fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client.fd_ < 0) {
+        throwSystemError("Cannot create socket");
+    }
+    if (::connect(client.fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        throwSystemError("Cannot connect to calc daemon at '" + path + "'");
+    }
+    return client;
+#else
+    (void)path;
+    throw std::runtime_error("The calc daemon is not supported on this platform");
+#endif
+}
+
+void DaemonClient::send(const DaemonRequest& request) {
+    std::string frame;
+    DaemonProtocol::appendRequest(frame, request);
+#ifndef _WIN32
+    size_t written = 0;
+    while (written < frame.size()) {
+        ssize_t count = ::write(fd_, frame.data() + written, frame.size() - written);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwSystemError("Cannot send to calc daemon");
+        }
+        written += static_cast<size_t>(count);
+    }
+#endif
+}
+
+DaemonResponse DaemonClient::receive() {
+#ifndef _WIN32
+    char chunk[64 * 1024];
+    for (;;) {
+        std::optional<size_t> length = DaemonProtocol::frameLength(buffer_);
+        if (length && buffer_.size() - DaemonProtocol::HEADER_BYTES >= *length) {
+            std::string_view body = std::string_view(buffer_).substr(DaemonProtocol::HEADER_BYTES, *length);
+            DaemonResponse response = DaemonProtocol::parseResponse(body);
+            buffer_.erase(0, DaemonProtocol::HEADER_BYTES + *length);
+            return response;
+        }
+
+        ssize_t count = ::read(fd_, chunk, sizeof(chunk));
+        if (count > 0) {
+            buffer_.append(chunk, static_cast<size_t>(count));
+        } else if (count == 0) {
+            throw std::runtime_error("Calc daemon closed the connection");
+        } else if (errno != EINTR) {
+            throwSystemError("Cannot receive from calc daemon");
+        }
+    }
+#else
+    throw std::runtime_error("The calc daemon is not supported on this platform");
+#endif
+}
+
+DaemonResponse DaemonClient::evaluate(const DaemonRequest& request) {
+    send(request);
+    return receive();
+}
+
+BatchStats DaemonClient::run(std::istream& in, std::ostream& out, const DaemonRequest& settings,
+                             ResultFormat format, size_t flushLines) {
+    auto start = std::chrono::steady_clock::now();
+
+    BatchStats stats;
+    stats.workers = 1;
+
+    const size_t linesPerRequest = flushLines > 0 ? std::min(flushLines, LINES_PER_REQUEST) : LINES_PER_REQUEST;
+    const size_t inFlightLimit = flushLines > 0 ? 1 : REQUESTS_IN_FLIGHT;
+
+    DaemonRequest request;
+    request.mode = settings.mode;
+    request.precision = settings.precision;
+
+    std::deque<std::vector<std::string>> inFlight;  // Lines of each unanswered request, blank ones included
+    std::vector<std::string> lines;
+    std::string buffer(OutputFormatter::recordHeader(format));
+
+    // Write the records of the oldest unanswered request
+    auto answer = [&] {
+        DaemonResponse response = receive();
+        if (!response.error.empty()) {
+            throw std::runtime_error(response.error);
+        }
+        size_t next = 0;
+        for (const auto& line : inFlight.front()) {
+            if (isBlankLine(line)) {
+                OutputFormatter::appendBlankRecord(buffer, format);
+                continue;
+            }
+            if (next >= response.results.size()) {
+                throw std::runtime_error("Calc daemon sent too few results");
+            }
+            const DaemonResult& result = response.results[next++];
+            if (!result.isSuccess()) {
+                ++stats.failed;
+            }
+            if (format == ResultFormat::TEXT && result.isSuccess()) {
+                buffer += result.text;
+                buffer += '\n';
+            } else {
+                OutputFormatter::appendRecord(buffer, format, line, result.toEvaluationResult());
+            }
+        }
+        inFlight.pop_front();
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+        if (flushLines > 0) {
+            out.flush();
+        }
+    };
+
+    // Send the lines read so far as one request
+    auto dispatch = [&] {
+        request.expressions.clear();
+        for (const auto& line : lines) {
+            if (!isBlankLine(line)) {
+                request.expressions.push_back(line);
+            }
+        }
+        stats.evaluated += request.expressions.size();
+        send(request);
+        inFlight.push_back(std::move(lines));
+        lines.clear();
+        if (inFlight.size() >= inFlightLimit) {
+            answer();
+        }
+    };
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        ++stats.lines;
+        stats.bytesRead += line.size();
+        lines.push_back(line);
+        if (lines.size() == linesPerRequest) {
+            dispatch();
+        }
+    }
+    if (!lines.empty()) {
+        dispatch();
+    }
+    while (!inFlight.empty()) {
+        answer();
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+} // namespace cli
+} // namespace calc
@@ -0,0 +1,210 @@
+/**
+ * @file daemon_protocol.cpp
+ * @brief Daemon protocol encoding implementation
+ */
+
+#include "calc/ui/cli/daemon_protocol.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace calc {
+namespace cli {
+
+namespace {
+
+// Little-endian whatever the host's byte order
+void appendInteger(std::string& out, uint64_t value, size_t bytes) {
+    char buffer[8];
+    for (size_t i = 0; i < bytes; ++i) {
+        buffer[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+    out.append(buffer, bytes);
+}
+
+void appendString(std::string& out, std::string_view text) {
+    appendInteger(out, text.size(), 4);
+    out += text;
+}
+
+// Start a frame, leaving room for the length written by endFrame()
+size_t beginFrame(std::string& out) {
+    size_t start = out.size();
+    out.append(DaemonProtocol::HEADER_BYTES, '\0');
+    return start;
+}
+
+void endFrame(std::string& out, size_t start) {
+    size_t length = out.size() - start - DaemonProtocol::HEADER_BYTES;
+    for (size_t i = 0; i < DaemonProtocol::HEADER_BYTES; ++i) {
+        out[start + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief Reads the fields of a body in order, checking every length
+ */
+class BodyReader {
+public:
+    explicit BodyReader(std::string_view body) : body_(body) {}
+
+    uint64_t integer(size_t bytes) {
+        require(bytes);
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(body_[offset_ + i])) << (8 * i);
+        }
+        offset_ += bytes;
+        return value;
+    }
+
+    std::string_view string() {
+        size_t length = integer(4);
+        require(length);
+        std::string_view text = body_.substr(offset_, length);
+        offset_ += length;
+        return text;
+    }
+
+    // Each element of a count takes at least @p minBytes, so a count the
+    // body cannot hold is rejected before anything is allocated for it
+    size_t count(size_t minBytes) {
+        size_t value = integer(4);
+        if (value > (body_.size() - offset_) / minBytes) {
+            throw std::runtime_error("Malformed daemon message: count exceeds body");
+        }
+        return value;
+    }
+
+    void finish() const {
+        if (offset_ != body_.size()) {
+            throw std::runtime_error("Malformed daemon message: trailing bytes");
+        }
+    }
+
+private:
+    void require(size_t bytes) const {
+        if (bytes > body_.size() - offset_) {
+            throw std::runtime_error("Malformed daemon message: truncated body");
+        }
+    }
+
+    std::string_view body_;
+    size_t offset_ = 0;
+};
+
+} // anonymous namespace
+
+DaemonResult DaemonResult::fromEvaluation(const EvaluationResult& result, std::string text) {
+    DaemonResult daemonResult;
+    if (result.isSuccess()) {
+        daemonResult.value = result.getValue();
+        daemonResult.text = std::move(text);
+    } else {
+        daemonResult.status = static_cast<uint8_t>(1 + static_cast<int>(result.getErrorCode()));
+        daemonResult.position = static_cast<uint32_t>(
+            std::min<size_t>(result.getErrorPosition(), std::numeric_limits<uint32_t>::max()));
+        daemonResult.text = result.getErrorMessage();
+    }
+    return daemonResult;
+}
+
+EvaluationResult DaemonResult::toEvaluationResult() const {
+    if (isSuccess()) {
+        return EvaluationResult(value);
+    }
+    int code = status - 1;
+    if (code > static_cast<int>(ErrorCode::UNKNOWN_ERROR)) {
+        code = static_cast<int>(ErrorCode::UNKNOWN_ERROR);
+    }
+    return EvaluationResult(static_cast<ErrorCode>(code), text, position);
+}
+
+std::optional<size_t> DaemonProtocol::frameLength(std::string_view buffer) {
+    if (buffer.size() < HEADER_BYTES) {
+        return std::nullopt;
+    }
+    size_t length = BodyReader(buffer.substr(0, HEADER_BYTES)).integer(HEADER_BYTES);
+    if (length > MAX_FRAME_BYTES) {
+        throw std::runtime_error("Daemon message too large");
+    }
+    return length;
+}
+
+void DaemonProtocol::appendRequest(std::string& out, const DaemonRequest& request) {
+    size_t start = beginFrame(out);
+    appendInteger(out, PROTOCOL_VERSION, 1);
+    appendString(out, request.mode);
+    appendInteger(out, static_cast<uint32_t>(request.precision), 4);
+    appendInteger(out, request.expressions.size(), 4);
+    for (const auto& expression : request.expressions) {
+        appendString(out, expression);
+    }
+    endFrame(out, start);
+}
+
+DaemonRequest DaemonProtocol::parseRequest(std::string_view body) {
+    BodyReader reader(body);
+    if (reader.integer(1) != PROTOCOL_VERSION) {
+        throw std::runtime_error("Unsupported daemon protocol version");
+    }
+
+    DaemonRequest request;
+    request.mode = std::string(reader.string());
+    request.precision = static_cast<int32_t>(static_cast<uint32_t>(reader.integer(4)));
+    request.expressions.resize(reader.count(4));
+    for (auto& expression : request.expressions) {
+        expression = std::string(reader.string());
+    }
+    reader.finish();
+    return request;
+}
+
+void DaemonProtocol::appendResponse(std::string& out, const DaemonResponse& response) {
+    size_t start = beginFrame(out);
+    if (!response.error.empty()) {
+        appendInteger(out, RESPONSE_ERROR, 1);
+        appendString(out, response.error);
+    } else {
+        appendInteger(out, RESPONSE_RESULTS, 1);
+        appendInteger(out, response.results.size(), 4);
+        for (const auto& result : response.results) {
+            uint64_t bits;
+            std::memcpy(&bits, &result.value, sizeof(bits));
+            appendInteger(out, result.status, 1);
+            appendInteger(out, bits, 8);
+            appendInteger(out, result.position, 4);
+            appendString(out, result.text);
+        }
+    }
+    endFrame(out, start);
+}
+
+DaemonResponse DaemonProtocol::parseResponse(std::string_view body) {
+    BodyReader reader(body);
+    DaemonResponse response;
+    uint64_t kind = reader.integer(1);
+    if (kind == RESPONSE_ERROR) {
+        response.error = std::string(reader.string());
+        if (response.error.empty()) {
+            response.error = "Request failed";
+        }
+    } else if (kind == RESPONSE_RESULTS) {
+        response.results.resize(reader.count(17));  // Status, value, position, text length
+        for (auto& result : response.results) {
+            result.status = static_cast<uint8_t>(reader.integer(1));
+            uint64_t bits = reader.integer(8);
+            std::memcpy(&result.value, &bits, sizeof(bits));
+            result.position = static_cast<uint32_t>(reader.integer(4));
+            result.text = std::string(reader.string());
+        }
+    } else {
+        throw std::runtime_error("Malformed daemon message: unknown response kind");
+    }
+    reader.finish();
+    return response;
+}
+
+} // namespace cli
+} // namespace calc
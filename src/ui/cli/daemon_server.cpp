@@ -0,0 +1,606 @@
+/**
+ * @file daemon_server.cpp
+ * @brief Unix domain socket daemon implementation
+ */
+
+#include "calc/ui/cli/daemon_server.h"
+#include "calc/modes/precision_mode.h"
+#include "calc/modes/shared_engine.h"
+#include "calc/ui/cli/output_formatter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief A client connection, owned by the event loop
+ */
+struct DaemonServer::Connection {
+    uint64_t id = 0;
+    int fd = -1;
+    std::string input;                         ///< Received bytes not yet parsed into requests
+    std::string output;                        ///< Responses ready to write, in request order
+    size_t written = 0;                        ///< Bytes of output already written
+    uint64_t nextSequence = 0;                 ///< Sequence number of the next request read
+    uint64_t nextToWrite = 0;                  ///< Sequence number of the next response to write
+    std::map<uint64_t, std::string> finished;  ///< Responses waiting for earlier ones
+    bool peerClosed = false;                   ///< The client will send nothing more
+    uint32_t events = 0;                       ///< epoll events currently registered
+
+    /// Requests read and not yet answered
+    size_t pending() const { return nextSequence - nextToWrite; }
+};
+
+/**
+ * @brief How requests naming one mode are evaluated
+ */
+struct DaemonServer::ModeEngine {
+    std::unique_ptr<SharedEngine> engine;  ///< nullptr for precision mode
+    int precision = 0;                     ///< Precision of requests that give none
+};
+
+/**
+ * @brief A request waiting for a worker
+ */
+struct DaemonServer::Job {
+    uint64_t connection = 0;
+    uint64_t sequence = 0;
+    const ModeEngine* mode = nullptr;
+    DaemonRequest request;
+};
+
+/**
+ * @brief A response waiting for the event loop
+ */
+struct DaemonServer::Completion {
+    uint64_t connection = 0;
+    uint64_t sequence = 0;
+    std::string response;
+};
+
+/**
+ * @brief What one worker keeps from request to request
+ */
+struct DaemonServer::WorkerState {
+    EvaluationScratch scratch;
+    std::unique_ptr<PrecisionMode> precise;  ///< Built on the first precision mode request
+    DaemonResponse response;
+};
+
+namespace {
+
+constexpr uint64_t LISTEN_TOKEN = 0;
+constexpr uint64_t WAKE_TOKEN = 1;
+constexpr size_t READ_BYTES = 64 * 1024;
+constexpr int MAX_EVENTS = 64;
+
+[[noreturn]] void throwSystemError(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+} // anonymous namespace
+
+DaemonServer::DaemonServer(ModeManager& modes, std::string defaultMode, unsigned workers)
+    : modes_(modes)
+    , defaultMode_(std::move(defaultMode))
+    , workerCount_(workers > 0 ? workers : std::max(1u, std::thread::hardware_concurrency()))
+    , nextConnectionId_(WAKE_TOKEN + 1) {
+#ifdef __linux__
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        throwSystemError("Cannot create epoll instance");
+    }
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        int error = errno;
+        ::close(epollFd_);
+        errno = error;
+        throwSystemError("Cannot create eventfd");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_TOKEN;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+#endif
+}
+
+DaemonServer::~DaemonServer() {
+#ifdef __linux__
+    stopWorkers();
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(socketPath_.c_str());
+    }
+    if (wakeFd_ >= 0) {
+        ::close(wakeFd_);
+    }
+    if (epollFd_ >= 0) {
+        ::close(epollFd_);
+    }
+#endif
+}
+
+void DaemonServer::listen(const std::string& path) {
+#ifdef __linux__
+    if (listenFd_ >= 0) {
+        throw std::runtime_error("Daemon is already listening on '" + socketPath_ + "'");
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path '" + path + "'");
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    const auto* name = reinterpret_cast<const sockaddr*>(&address);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throwSystemError("Cannot create socket");
+    }
+    if (::bind(fd, name, sizeof(address)) < 0) {
+        bool bound = false;
+        if (errno == EADDRINUSE) {
+            // Replace the file only if no daemon answers on it
+            int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            bool stale = probe >= 0 && ::connect(probe, name, sizeof(address)) < 0 && errno == ECONNREFUSED;
+            if (probe >= 0) {
+                ::close(probe);
+            }
+            if (!stale) {
+                ::close(fd);
+                throw std::runtime_error("Socket '" + path + "' is already in use");
+            }
+            ::unlink(path.c_str());
+            bound = ::bind(fd, name, sizeof(address)) == 0;
+        }
+        if (!bound) {
+            int error = errno;
+            ::close(fd);
+            errno = error;
+            throwSystemError("Cannot bind '" + path + "'");
+        }
+    }
+    if (::listen(fd, SOMAXCONN) < 0) {
+        int error = errno;
+        ::close(fd);
+        ::unlink(path.c_str());
+        errno = error;
+        throwSystemError("Cannot listen on '" + path + "'");
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_TOKEN;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event);
+    listenFd_ = fd;
+    socketPath_ = path;
+#else
+    (void)path;
+    throw std::runtime_error("The calc daemon is only supported on Linux");
+#endif
+}
+
+void DaemonServer::run() {
+#ifdef __linux__
+    if (listenFd_ < 0) {
+        throw std::runtime_error("Daemon is not listening");
+    }
+
+    shutdown_ = false;
+    std::vector<std::unique_ptr<WorkerState>> states;
+    states.reserve(workerCount_);
+    workers_.reserve(workerCount_);
+    for (unsigned i = 0; i < workerCount_; ++i) {
+        states.push_back(std::make_unique<WorkerState>());
+        workers_.emplace_back(&DaemonServer::workerLoop, this, std::ref(*states.back()));
+    }
+
+    epoll_event events[MAX_EVENTS];
+    while (!stopping_.load(std::memory_order_acquire)) {
+        int count = epoll_wait(epollFd_, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int error = errno;
+            stopWorkers();
+            errno = error;
+            throwSystemError("epoll_wait failed");
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const uint64_t token = events[i].data.u64;
+            if (token == LISTEN_TOKEN) {
+                acceptConnections();
+            } else if (token == WAKE_TOKEN) {
+                uint64_t value;
+                while (::read(wakeFd_, &value, sizeof(value)) < 0 && errno == EINTR) {
+                }
+                collectCompletions();
+            } else {
+                auto it = connections_.find(token);
+                if (it != connections_.end() && readConnection(*it->second, events[i].events)) {
+                    serviceConnection(*it->second);
+                }
+            }
+        }
+    }
+
+    stopWorkers();
+    stopping_.store(false, std::memory_order_release);
+#endif
+}
+
+void DaemonServer::stop() noexcept {
+    stopping_.store(true, std::memory_order_release);
+#ifdef __linux__
+    // write() is async-signal-safe, so this may run in a signal handler
+    uint64_t one = 1;
+    ssize_t written = ::write(wakeFd_, &one, sizeof(one));
+    (void)written;
+#endif
+}
+
+void DaemonServer::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+        jobs_.clear();
+        completions_.clear();
+    }
+    jobReady_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    while (!connections_.empty()) {
+        closeConnection(connections_.begin()->first);
+    }
+}
+
+void DaemonServer::acceptConnections() {
+#ifdef __linux__
+    for (;;) {
+        int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;  // EAGAIN, or out of descriptors until a connection closes
+        }
+
+        auto connection = std::make_unique<Connection>();
+        connection->id = nextConnectionId_++;
+        connection->fd = fd;
+        connection->events = EPOLLIN;
+
+        epoll_event event{};
+        event.events = connection->events;
+        event.data.u64 = connection->id;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            continue;
+        }
+        connections_.emplace(connection->id, std::move(connection));
+    }
+#endif
+}
+
+bool DaemonServer::readConnection(Connection& connection, uint32_t events) {
+#ifdef __linux__
+    // Hang-up means the client closed both directions: nobody is left to answer
+    if (events & (EPOLLHUP | EPOLLERR)) {
+        closeConnection(connection.id);
+        return false;
+    }
+    if (!(events & EPOLLIN)) {
+        return true;
+    }
+
+    char buffer[READ_BYTES];
+    for (;;) {
+        ssize_t count = ::read(connection.fd, buffer, sizeof(buffer));
+        if (count > 0) {
+            connection.input.append(buffer, static_cast<size_t>(count));
+            if (static_cast<size_t>(count) < sizeof(buffer)) {
+                break;
+            }
+        } else if (count == 0) {
+            connection.peerClosed = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN) {
+            break;
+        } else {
+            closeConnection(connection.id);
+            return false;
+        }
+    }
+#else
+    (void)events;
+#endif
+    return true;
+}
+
+bool DaemonServer::serviceConnection(Connection& connection) {
+#ifdef __linux__
+    try {
+        dispatchRequests(connection);
+    } catch (const std::runtime_error&) {
+        closeConnection(connection.id);  // Malformed frame: the stream cannot be resynchronized
+        return false;
+    }
+
+    while (connection.written < connection.output.size()) {
+        ssize_t count = ::send(connection.fd, connection.output.data() + connection.written,
+                               connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if (count > 0) {
+            connection.written += static_cast<size_t>(count);
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0 && (errno == EAGAIN)) {
+            break;
+        } else {
+            closeConnection(connection.id);
+            return false;
+        }
+    }
+    if (connection.written == connection.output.size()) {
+        connection.output.clear();
+        connection.written = 0;
+    }
+
+    if (connection.peerClosed && connection.pending() == 0 && connection.output.empty()) {
+        closeConnection(connection.id);
+        return false;
+    }
+
+    // Read while under the pending limit; wait for writability while output is left
+    uint32_t events = 0;
+    if (!connection.peerClosed && connection.pending() < MAX_PENDING_REQUESTS) {
+        events |= EPOLLIN;
+    }
+    if (!connection.output.empty()) {
+        events |= EPOLLOUT;
+    }
+    if (events != connection.events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = connection.id;
+        epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+#endif
+    return true;
+}
+
+void DaemonServer::dispatchRequests(Connection& connection) {
+    const std::string_view input = connection.input;
+    std::vector<std::unique_ptr<Job>> ready;
+    size_t offset = 0;
+
+    while (connection.pending() < MAX_PENDING_REQUESTS) {
+        std::optional<size_t> length = DaemonProtocol::frameLength(input.substr(offset));
+        if (!length || input.size() - offset - DaemonProtocol::HEADER_BYTES < *length) {
+            break;
+        }
+        std::string_view body = input.substr(offset + DaemonProtocol::HEADER_BYTES, *length);
+        offset += DaemonProtocol::HEADER_BYTES + *length;
+
+        auto job = std::make_unique<Job>();
+        job->connection = connection.id;
+        job->sequence = connection.nextSequence++;
+        job->request = DaemonProtocol::parseRequest(body);
+
+        const std::string& name = job->request.mode.empty() ? defaultMode_ : job->request.mode;
+        job->mode = findEngine(name);
+
+        DaemonResponse rejection;
+        const int precision = job->request.precision;
+        if (job->mode == nullptr) {
+            rejection.error = "Unknown mode '" + name + "'";
+        } else if (job->mode->engine == nullptr && precision != -1 &&
+                   (precision < 1 || precision > PrecisionMode::MAX_DIGITS)) {
+            rejection.error = "Precision must be between 1 and " + std::to_string(PrecisionMode::MAX_DIGITS);
+        } else if (job->mode->engine != nullptr && precision != -1 &&
+                   (precision < 0 || precision > MAX_DOUBLE_PRECISION)) {
+            rejection.error = "Precision must be between 0 and " + std::to_string(MAX_DOUBLE_PRECISION);
+        }
+
+        if (!rejection.error.empty()) {
+            std::string response;
+            DaemonProtocol::appendResponse(response, rejection);
+            deliver(connection, job->sequence, std::move(response));
+        } else {
+            ready.push_back(std::move(job));
+        }
+    }
+    connection.input.erase(0, offset);
+
+    if (ready.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& job : ready) {
+            jobs_.push_back(std::move(job));
+        }
+    }
+    if (ready.size() == 1) {
+        jobReady_.notify_one();
+    } else {
+        jobReady_.notify_all();
+    }
+}
+
+void DaemonServer::collectCompletions() {
+    std::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        completions.swap(completions_);
+    }
+
+    std::vector<uint64_t> touched;
+    for (auto& completion : completions) {
+        auto it = connections_.find(completion.connection);
+        if (it == connections_.end()) {
+            continue;  // Closed while the request was evaluated
+        }
+        deliver(*it->second, completion.sequence, std::move(completion.response));
+        touched.push_back(completion.connection);
+    }
+
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (uint64_t id : touched) {
+        auto it = connections_.find(id);
+        if (it != connections_.end()) {
+            serviceConnection(*it->second);
+        }
+    }
+}
+
+void DaemonServer::deliver(Connection& connection, uint64_t sequence, std::string response) {
+    if (sequence != connection.nextToWrite) {
+        connection.finished.emplace(sequence, std::move(response));
+        return;
+    }
+
+    connection.output += response;
+    ++connection.nextToWrite;
+    for (auto it = connection.finished.begin();
+         it != connection.finished.end() && it->first == connection.nextToWrite;
+         it = connection.finished.erase(it)) {
+        connection.output += it->second;
+        ++connection.nextToWrite;
+    }
+}
+
+void DaemonServer::closeConnection(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) {
+        return;
+    }
+#ifdef __linux__
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->second->fd, nullptr);
+    ::close(it->second->fd);
+#endif
+    connections_.erase(it);
+}
+
+const DaemonServer::ModeEngine* DaemonServer::findEngine(const std::string& name) {
+    auto it = engines_.find(name);
+    if (it != engines_.end()) {
+        return it->second.get();
+    }
+
+    const Mode* mode = modes_.getMode(name);
+    if (mode == nullptr) {
+        return nullptr;
+    }
+    auto engine = std::make_unique<ModeEngine>();
+    if (dynamic_cast<const PrecisionMode*>(mode) == nullptr) {
+        engine->engine = std::make_unique<SharedEngine>(*mode);
+    }
+    engine->precision = mode->getContext().getPrecision();
+    return engines_.emplace(name, std::move(engine)).first->second.get();
+}
+
+void DaemonServer::workerLoop(WorkerState& state) {
+    for (;;) {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobReady_.wait(lock, [this] { return shutdown_ || !jobs_.empty(); });
+            if (shutdown_) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        std::string response;
+        evaluate(*job, state, response);
+
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake = completions_.empty();  // Otherwise the loop is already due to collect
+            completions_.push_back(Completion{job->connection, job->sequence, std::move(response)});
+        }
+#ifdef __linux__
+        if (wake) {
+            uint64_t one = 1;
+            ssize_t written = ::write(wakeFd_, &one, sizeof(one));
+            (void)written;
+        }
+#else
+        (void)wake;
+#endif
+    }
+}
+
+void DaemonServer::evaluate(const Job& job, WorkerState& state, std::string& out) const {
+    DaemonResponse& response = state.response;
+    response.error.clear();
+    response.results.clear();
+
+    const ModeEngine& mode = *job.mode;
+    const int precision = job.request.precision >= 0 ? job.request.precision : mode.precision;
+    try {
+        if (mode.engine != nullptr && mode.engine->isInteger()) {
+            // Programmer mode: the exact word, as a local run prints it
+            for (const auto& expression : job.request.expressions) {
+                IntegerResult result = mode.engine->evaluateInteger(expression, state.scratch);
+                response.results.push_back(DaemonResult::fromEvaluation(
+                    result.toEvaluationResult(),
+                    result.isSuccess() ? mode.engine->formatInteger(result) : std::string()));
+            }
+        } else if (mode.engine != nullptr) {
+            for (const auto& expression : job.request.expressions) {
+                EvaluationResult result = mode.engine->evaluate(expression, state.scratch);
+                response.results.push_back(DaemonResult::fromEvaluation(
+                    result, result.isSuccess() ? OutputFormatter::formatValue(result.getValue(), precision)
+                                               : std::string()));
+            }
+        } else {
+            if (!state.precise) {
+                state.precise = std::make_unique<PrecisionMode>(precision);
+            } else if (state.precise->getPrecision() != precision) {
+                state.precise->setPrecision(precision);
+            }
+            for (const auto& expression : job.request.expressions) {
+                BigFloatResult result = state.precise->evaluatePrecise(expression);
+                if (result.isError()) {
+                    response.results.push_back(DaemonResult::fromEvaluation(result.toEvaluationResult(), {}));
+                } else {
+                    response.results.push_back(DaemonResult::fromEvaluation(
+                        EvaluationResult(result.getValue().toDouble()), state.precise->formatResult(result)));
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        response.results.clear();
+        response.error = e.what();
+    }
+
+    DaemonProtocol::appendResponse(out, response);
+}
+
+} // namespace cli
+} // namespace calc
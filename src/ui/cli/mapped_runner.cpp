@@ -0,0 +1,236 @@
+/**
+ * @file mapped_runner.cpp
+ * @brief Memory-mapped parallel evaluation implementation
+ */
+
+#include "calc/ui/cli/mapped_runner.h"
+#include "calc/ui/cli/output_formatter.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace calc {
+namespace cli {
+
+/**
+ * @brief One chunk's results, waiting to be written
+ */
+struct MappedRunner::Chunk {
+    std::string output;    ///< Output lines, reused from chunk to chunk
+    size_t lines = 0;
+    size_t evaluated = 0;
+    size_t failed = 0;
+    size_t bytesRead = 0;
+    bool done = false;     ///< Evaluated and not yet written; guarded by the run's mutex
+};
+
+namespace {
+
+// Offset of the first line starting at or after @p offset
+size_t lineBoundary(std::string_view input, size_t offset) {
+    if (offset == 0 || offset >= input.size()) {
+        return std::min(offset, input.size());
+    }
+    // A line starts at offset if the byte before it ends one
+    const void* newline = std::memchr(input.data() + offset - 1, '\n', input.size() - offset + 1);
+    if (newline == nullptr) {
+        return input.size();
+    }
+    return static_cast<size_t>(static_cast<const char*>(newline) - input.data()) + 1;
+}
+
+} // anonymous namespace
+
+MappedFile MappedFile::open(const std::string& path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open '" + path + "'");
+    }
+    auto bytes = std::make_shared<const std::string>((std::istreambuf_iterator<char>(file)),
+                                                     std::istreambuf_iterator<char>());
+    MappedFile mapped;
+    mapped.data_ = bytes->data();
+    mapped.size_ = bytes->size();
+    mapped.storage_ = std::move(bytes);
+    return mapped;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open '" + path + "'");
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot open '" + path + "'");
+    }
+    const auto size = static_cast<size_t>(info.st_size);
+
+    MappedFile mapped;
+    if (size == 0) {
+        ::close(fd);  // Nothing to map, and mmap rejects a zero length
+        return mapped;
+    }
+
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file open
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map '" + path + "'");
+    }
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+
+    mapped.storage_ = std::shared_ptr<const void>(mapping, [size](const void* data) {
+        ::munmap(const_cast<void*>(data), size);
+    });
+    mapped.data_ = static_cast<const char*>(mapping);
+    mapped.size_ = size;
+    return mapped;
+#endif
+}
+
+MappedRunner::MappedRunner(const SharedEngine& engine, unsigned workers, size_t chunkBytes)
+    : engine_(engine)
+    , chunkBytes_(chunkBytes > 0 ? chunkBytes : DEFAULT_CHUNK_BYTES) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    scratch_.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) {
+        scratch_.push_back(std::make_unique<EvaluationScratch>());
+    }
+}
+
+MappedRunner::~MappedRunner() = default;
+
+BatchStats MappedRunner::run(std::string_view input, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+
+    const size_t chunkCount = (input.size() + chunkBytes_ - 1) / chunkBytes_;
+    const size_t threadCount = std::min<size_t>(scratch_.size(), chunkCount);
+
+    BatchStats stats;
+    stats.workers = static_cast<unsigned>(std::max<size_t>(threadCount, 1));
+
+    // Chunk k is evaluated into slot k % slots.size() once chunk k - slots.size() is written
+    std::vector<Chunk> slots(std::min(chunkCount, CHUNKS_PER_WORKER * stats.workers));
+    std::mutex mutex;
+    std::condition_variable evaluated;
+    std::condition_variable written;
+    size_t nextChunk = 0;
+    size_t nextWrite = 0;
+
+    auto work = [&](EvaluationScratch& scratch) {
+        for (;;) {
+            size_t k;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                written.wait(lock, [&] {
+                    return nextChunk >= chunkCount || nextChunk < nextWrite + slots.size();
+                });
+                if (nextChunk >= chunkCount) {
+                    return;
+                }
+                k = nextChunk++;
+            }
+
+            const size_t begin = lineBoundary(input, k * chunkBytes_);
+            const size_t end = lineBoundary(input, (k + 1) * chunkBytes_);
+            Chunk& chunk = slots[k % slots.size()];
+            evaluateChunk(input.substr(begin, end - begin), chunk, scratch);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunk.done = true;
+            }
+            evaluated.notify_one();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back(work, std::ref(*scratch_[t]));
+    }
+
+    const std::string_view header = OutputFormatter::recordHeader(format_);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // Write chunks in input order while later ones are evaluated
+    for (size_t k = 0; k < chunkCount; ++k) {
+        Chunk& chunk = slots[k % slots.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            evaluated.wait(lock, [&] { return chunk.done; });
+        }
+
+        out.write(chunk.output.data(), static_cast<std::streamsize>(chunk.output.size()));
+        stats.lines += chunk.lines;
+        stats.evaluated += chunk.evaluated;
+        stats.failed += chunk.failed;
+        stats.bytesRead += chunk.bytesRead;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk.done = false;
+            ++nextWrite;
+        }
+        written.notify_all();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    out.flush();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+void MappedRunner::evaluateChunk(std::string_view lines, Chunk& chunk,
+                                 EvaluationScratch& scratch) const {
+    chunk.output.clear();
+    chunk.lines = 0;
+    chunk.evaluated = 0;
+    chunk.failed = 0;
+    chunk.bytesRead = 0;
+
+    size_t pos = 0;
+    while (pos < lines.size()) {
+        const void* newline = std::memchr(lines.data() + pos, '\n', lines.size() - pos);
+        const size_t end = newline != nullptr
+            ? static_cast<size_t>(static_cast<const char*>(newline) - lines.data())
+            : lines.size();
+
+        std::string_view line = lines.substr(pos, end - pos);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        ++chunk.lines;
+        chunk.bytesRead += line.size();
+        if (!isBlankLine(line)) {
+            ++chunk.evaluated;
+        }
+
+        if (appendLineResult(engine_, line, scratch, chunk.output, format_)) {
+            ++chunk.failed;
+        }
+        pos = end + 1;
+    }
+}
+
+} // namespace cli
+} // namespace calc
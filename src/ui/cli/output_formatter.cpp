@@ -10,6 +10,11 @@
 #include <cmath>
 #include <cstdlib>
 #include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
 
 // Platform-specific includes for isatty
 #if defined(__unix__) || defined(__unix) || defined(__linux__) || defined(__APPLE__)
@@ -38,6 +43,95 @@ constexpr const char* COLOR_BRIGHT_BLUE = "\033[94m";
 constexpr const char* COLOR_BRIGHT_MAGENTA = "\033[95m";
 constexpr const char* COLOR_BRIGHT_CYAN = "\033[96m";
 
+namespace {
+
+// Stable names for machine-readable error records
+const char* errorCodeName(ErrorCode code) {
+    switch (code) {
+        case ErrorCode::INVALID_SYNTAX:     return "INVALID_SYNTAX";
+        case ErrorCode::UNEXPECTED_TOKEN:   return "UNEXPECTED_TOKEN";
+        case ErrorCode::DIVISION_BY_ZERO:   return "DIVISION_BY_ZERO";
+        case ErrorCode::INVALID_FUNCTION:   return "INVALID_FUNCTION";
+        case ErrorCode::DOMAIN_ERROR:       return "DOMAIN_ERROR";
+        case ErrorCode::NUMERIC_OVERFLOW:   return "NUMERIC_OVERFLOW";
+        case ErrorCode::NUMERIC_UNDERFLOW:  return "NUMERIC_UNDERFLOW";
+        case ErrorCode::INVALID_BASE:       return "INVALID_BASE";
+        case ErrorCode::PARSE_ERROR:        return "PARSE_ERROR";
+        case ErrorCode::EVALUATION_ERROR:   return "EVALUATION_ERROR";
+        case ErrorCode::UNDEFINED_VARIABLE: return "UNDEFINED_VARIABLE";
+        case ErrorCode::UNKNOWN_ERROR:
+        default:                            return "UNKNOWN_ERROR";
+    }
+}
+
+void appendUnsigned(std::string& out, size_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, static_cast<size_t>(result.ptr - buffer));
+}
+
+void appendJsonString(std::string& out, std::string_view text) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    out += '"';
+    for (char c : text) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (byte < 0x20) {
+            out += "\\u00";
+            out += HEX[byte >> 4];
+            out += HEX[byte & 0xF];
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Quote a CSV field only if it holds a separator, quote or line break
+void appendCsvField(std::string& out, std::string_view text) {
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out += text;
+        return;
+    }
+    out += '"';
+    for (char c : text) {
+        if (c == '"') {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+// TSV has no quoting; tabs, line breaks and backslashes are escaped instead
+void appendTsvField(std::string& out, std::string_view text) {
+    for (char c : text) {
+        switch (c) {
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\\': out += "\\\\"; break;
+            default:   out += c; break;
+        }
+    }
+}
+
+// Little-endian whatever the host's byte order
+void appendBinaryRecord(std::string& out, double value, unsigned char status) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    char bytes[OutputFormatter::BINARY_RECORD_BYTES];
+    for (size_t i = 0; i < sizeof(bits); ++i) {
+        bytes[i] = static_cast<char>((bits >> (8 * i)) & 0xFF);
+    }
+    bytes[sizeof(bits)] = static_cast<char>(status);
+    out.append(bytes, sizeof(bytes));
+}
+
+} // anonymous namespace
+
 OutputFormatter::OutputFormatter(ColorMode colorMode, bool showExpression, bool enableSyntaxHighlight)
     : colorMode_(colorMode)
     , useColor_(false)
@@ -237,6 +331,17 @@ std::string OutputFormatter::formatResult(const EvaluationResult& result) {
     return formatResult("", result);
 }
 
+std::string OutputFormatter::formatResult(const std::string& expression, const std::string& value) {
+    std::ostringstream oss;
+
+    if (showExpression_ && !expression.empty()) {
+        oss << formatExpression(expression) << "\n";
+    }
+
+    oss << "Result: " << colorText(value, COLOR_GREEN);
+    return oss.str();
+}
+
 std::string OutputFormatter::formatExpression(const std::string& expression) {
     std::ostringstream oss;
     oss << "Expression: " << applySyntaxHighlight(expression);
@@ -303,44 +408,190 @@ std::string OutputFormatter::getErrorColorCode(ErrorCode code) {
 }
 
 std::string OutputFormatter::formatValue(double value, int precision) {
-    std::ostringstream oss;
+    std::string text;
+    appendValue(text, value, precision);
+    return text;
+}
 
+void OutputFormatter::appendValue(std::string& out, double value, int precision) {
     // Handle special cases
     if (std::isinf(value)) {
-        if (value > 0) {
-            return "Infinity";
-        } else {
-            return "-Infinity";
-        }
+        out += value > 0 ? "Infinity" : "-Infinity";
+        return;
     }
 
     if (std::isnan(value)) {
-        return "NaN";
+        out += "NaN";
+        return;
     }
 
-    // Check if the value is effectively an integer
-    if (std::abs(value - std::round(value)) < std::pow(10, -precision - 1)) {
-        oss << std::fixed << std::setprecision(0) << value;
+    // Integers print without a fraction; others drop trailing zeros
+    bool integral = std::abs(value - std::round(value)) < std::pow(10, -precision - 1);
+    int digits = integral ? 0 : precision;
+
+    // Same digits as std::fixed, without a stream; DBL_MAX takes 309 integer digits
+    char buffer[512];
+    std::to_chars_result result{buffer, std::errc::value_too_large};
+    if (digits >= 0) {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, digits);
+    }
+
+    std::string_view text;
+    std::string streamed;
+    if (result.ec == std::errc()) {
+        text = std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
     } else {
-        oss << std::fixed << std::setprecision(precision) << value;
-
-        // Remove trailing zeros after decimal point
-        std::string str = oss.str();
-        size_t decimalPos = str.find('.');
-        if (decimalPos != std::string::npos) {
-            size_t lastNonZero = str.find_last_not_of('0');
-            if (lastNonZero != std::string::npos) {
-                if (str[lastNonZero] == '.') {
-                    str = str.substr(0, lastNonZero);
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(digits) << value;
+        streamed = oss.str();
+        text = streamed;
+    }
+
+    if (!integral && text.find('.') != std::string_view::npos) {
+        size_t lastNonZero = text.find_last_not_of('0');
+        text = text.substr(0, text[lastNonZero] == '.' ? lastNonZero : lastNonZero + 1);
+    }
+    out += text;
+}
+
+void OutputFormatter::appendShortest(std::string& out, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, static_cast<size_t>(result.ptr - buffer));
+}
+
+std::string_view OutputFormatter::recordHeader(ResultFormat format) {
+    switch (format) {
+        case ResultFormat::CSV:
+            return "expression,value,error,message,position\n";
+        case ResultFormat::TSV:
+            return "expression\tvalue\terror\tmessage\tposition\n";
+        default:
+            return {};
+    }
+}
+
+void OutputFormatter::appendRecord(std::string& out, ResultFormat format, std::string_view expression,
+                                   const EvaluationResult& result, int precision) {
+    const bool success = result.isSuccess();
+    switch (format) {
+        case ResultFormat::TEXT:
+            if (success) {
+                appendValue(out, result.getValue(), precision);
+            } else {
+                out += "Error: ";
+                out += result.getErrorMessage();
+                if (result.getErrorPosition() > 0) {
+                    out += " at position ";
+                    appendUnsigned(out, result.getErrorPosition());
+                }
+            }
+            out += '\n';
+            break;
+
+        case ResultFormat::JSONL:
+            out += "{\"expression\":";
+            appendJsonString(out, expression);
+            if (success) {
+                out += ",\"value\":";
+                if (std::isfinite(result.getValue())) {
+                    appendShortest(out, result.getValue());
                 } else {
-                    str = str.substr(0, lastNonZero + 1);
+                    out += '"';  // JSON has no infinities or NaN
+                    appendShortest(out, result.getValue());
+                    out += '"';
                 }
+            } else {
+                out += ",\"error\":\"";
+                out += errorCodeName(result.getErrorCode());
+                out += "\",\"message\":";
+                appendJsonString(out, result.getErrorMessage());
+                out += ",\"position\":";
+                appendUnsigned(out, result.getErrorPosition());
             }
+            out += "}\n";
+            break;
+
+        case ResultFormat::CSV:
+        case ResultFormat::TSV: {
+            const bool csv = format == ResultFormat::CSV;
+            const char separator = csv ? ',' : '\t';
+            auto appendField = csv ? appendCsvField : appendTsvField;
+            appendField(out, expression);
+            out += separator;
+            if (success) {
+                appendShortest(out, result.getValue());
+                out += separator;
+                out += separator;
+                out += separator;
+            } else {
+                out += separator;
+                out += errorCodeName(result.getErrorCode());
+                out += separator;
+                appendField(out, result.getErrorMessage());
+                out += separator;
+                appendUnsigned(out, result.getErrorPosition());
+            }
+            out += '\n';
+            break;
         }
-        return str;
+
+        case ResultFormat::BINARY:
+            if (success) {
+                appendBinaryRecord(out, result.getValue(), BINARY_STATUS_OK);
+            } else {
+                appendBinaryRecord(out, static_cast<double>(result.getErrorPosition()),
+                                   static_cast<unsigned char>(1 + static_cast<int>(result.getErrorCode())));
+            }
+            break;
+    }
+}
+
+void OutputFormatter::appendRecord(std::string& out, ResultFormat format, std::string_view expression,
+                                   const EvaluationResult& result, std::string_view value) {
+    if (!result.isSuccess() || format == ResultFormat::BINARY) {
+        appendRecord(out, format, expression, result);
+        return;
     }
 
-    return oss.str();
+    switch (format) {
+        case ResultFormat::TEXT:
+            out += value;
+            out += '\n';
+            break;
+
+        case ResultFormat::JSONL:
+            out += "{\"expression\":";
+            appendJsonString(out, expression);
+            out += ",\"value\":";
+            out += value;
+            out += "}\n";
+            break;
+
+        case ResultFormat::CSV:
+        case ResultFormat::TSV: {
+            const char separator = format == ResultFormat::CSV ? ',' : '\t';
+            (format == ResultFormat::CSV ? appendCsvField : appendTsvField)(out, expression);
+            out += separator;
+            out += value;
+            out += separator;
+            out += separator;
+            out += separator;
+            out += '\n';
+            break;
+        }
+
+        case ResultFormat::BINARY:
+            break;
+    }
+}
+
+void OutputFormatter::appendBlankRecord(std::string& out, ResultFormat format) {
+    if (format == ResultFormat::TEXT) {
+        out += '\n';
+    } else if (format == ResultFormat::BINARY) {
+        appendBinaryRecord(out, std::numeric_limits<double>::quiet_NaN(), BINARY_STATUS_BLANK);
+    }
 }
 
 } // namespace cli
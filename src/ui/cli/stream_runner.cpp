@@ -0,0 +1,70 @@
+/**
+ * @file stream_runner.cpp
+ * @brief Streaming evaluation implementation
+ */
+
+#include "calc/ui/cli/stream_runner.h"
+#include "calc/ui/cli/output_formatter.h"
+#include <chrono>
+
+namespace calc {
+namespace cli {
+
+namespace {
+
+void writeBuffer(std::ostream& out, std::string& buffer) {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+} // anonymous namespace
+
+StreamRunner::StreamRunner(const SharedEngine& engine, size_t flushLines, size_t bufferBytes)
+    : engine_(engine)
+    , flushLines_(flushLines)
+    , bufferBytes_(bufferBytes > 0 ? bufferBytes : DEFAULT_BUFFER_BYTES) {
+}
+
+BatchStats StreamRunner::run(std::istream& in, std::ostream& out) {
+    auto start = std::chrono::steady_clock::now();
+
+    BatchStats stats;
+    stats.workers = 1;
+
+    std::string line;
+    std::string buffer;
+    buffer.reserve(bufferBytes_);
+    buffer += OutputFormatter::recordHeader(format_);
+    size_t sinceFlush = 0;
+
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        ++stats.lines;
+        stats.bytesRead += line.size();
+        if (!isBlankLine(line)) {
+            ++stats.evaluated;
+        }
+
+        if (appendLineResult(engine_, line, scratch_, buffer, format_)) {
+            ++stats.failed;
+        }
+
+        if (flushLines_ > 0 && ++sinceFlush == flushLines_) {
+            writeBuffer(out, buffer);
+            out.flush();
+            sinceFlush = 0;
+        } else if (buffer.size() >= bufferBytes_) {
+            writeBuffer(out, buffer);
+        }
+    }
+    writeBuffer(out, buffer);
+    out.flush();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+} // namespace cli
+} // namespace calc
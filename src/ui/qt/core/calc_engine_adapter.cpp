@@ -4,9 +4,6 @@
  */
 
 #include "calc/ui/qt/calc_engine_adapter.h"
-#include "calc/modes/standard_mode.h"
-#include "calc/modes/scientific_mode.h"
-#include "calc/modes/programmer_mode.h"
 
 namespace calc::ui::qt {
 
@@ -15,10 +12,7 @@ CalcEngineAdapter::CalcEngineAdapter()
     , currentMode_("standard")
     , precision_(6)
 {
-    // 注册默认模式
-    modeManager_->registerMode(std::make_unique<StandardMode>());
-    modeManager_->registerMode(std::make_unique<ScientificMode>());
-    modeManager_->registerMode(std::make_unique<ProgrammerMode>());
+    // ModeManager 已注册默认模式，首次使用时才构建
 }
 
 CalcEngineAdapter::~CalcEngineAdapter() = default;
@@ -30,6 +30,8 @@ std::string errorCodeToString(ErrorCode code) {
             return "Parse Error";
         case ErrorCode::EVALUATION_ERROR:
             return "Evaluation Error";
+        case ErrorCode::UNDEFINED_VARIABLE:
+            return "Undefined Variable";
         case ErrorCode::UNKNOWN_ERROR:
         default:
             return "Unknown Error";
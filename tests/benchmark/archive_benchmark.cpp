@@ -0,0 +1,118 @@
+/**
+ * @file archive_benchmark.cpp
+ * @brief Cold-start load times: parsing formulas versus loading an archive
+ *
+ * Builds a corpus of 200,000 formulas, the size a worker loads at start,
+ * and compares tokenizing and parsing every one of them with opening an
+ * ExpressionArchive of the same trees and loading each from the mapping.
+ */
+
+#include "calc/core/expression_archive.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace calc;
+
+static constexpr int REPETITIONS = 3;
+static constexpr size_t FORMULAS = 200000;
+
+static const std::vector<std::string> TEMPLATES = {
+    "price * (1 + rate) ^ years - fee",
+    "sin(2 * PI * t / period) * amplitude + offset",
+    "max(a, b, c) - min(a, b, c)",
+    "sqrt(x ^ 2 + y ^ 2) / (1 + abs(z))",
+    "log(volume + 1) * weight + bias",
+    "(high - low) / close * 100",
+};
+
+// TEMPLATES with a distinct constant appended, so no two formulas are equal
+static std::vector<std::string> makeCorpus() {
+    std::vector<std::string> corpus;
+    corpus.reserve(FORMULAS);
+    for (size_t i = 0; i < FORMULAS; ++i) {
+        corpus.push_back(TEMPLATES[i % TEMPLATES.size()] + " + " + std::to_string(i) + ".25");
+    }
+    return corpus;
+}
+
+// Best of REPETITIONS runs of work(), in milliseconds
+template <typename Work>
+static double bestOf(Work&& work) {
+    double best = 0.0;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        best = (i == 0) ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+static void printRow(const std::string& label, double ms) {
+    std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << ms << " ms" << std::setw(10)
+              << ms * 1e6 / static_cast<double>(FORMULAS) << " ns/formula\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Expression Archive Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << FORMULAS << " formulas, best of " << REPETITIONS << " runs\n\n";
+
+    const std::vector<std::string> corpus = makeCorpus();
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "calc_archive_benchmark.cxa").string();
+
+    ShuntingYardParser parser;
+    std::vector<ParsedExpression> trees(FORMULAS);
+    double parseMs = bestOf([&] {
+        for (size_t i = 0; i < FORMULAS; ++i) {
+            Tokenizer tokenizer(corpus[i]);
+            trees[i] = parser.parseToArena(tokenizer.tokenize());
+        }
+    });
+
+    double saveMs = bestOf([&] {
+        ExpressionArchiveWriter writer;
+        for (size_t i = 0; i < FORMULAS; ++i) {
+            writer.add(*trees[i], corpus[i]);
+        }
+        writer.save(path);
+    });
+
+    double loadMs = bestOf([&] {
+        ExpressionArchive archive = ExpressionArchive::open(path);
+        for (size_t i = 0; i < archive.size(); ++i) {
+            trees[i] = archive.load(i);
+        }
+    });
+
+    std::cout << "Cold start\n";
+    printRow("tokenize + parse", parseMs);
+    printRow("open + load archive", loadMs);
+    printRow("write archive", saveMs);
+    std::cout << "  Speedup: " << std::setprecision(1) << parseMs / loadMs << "x\n";
+    std::cout << "  Archive size: " << std::filesystem::file_size(path) / 1024 << " KiB ("
+              << std::filesystem::file_size(path) / FORMULAS << " bytes/formula)\n\n";
+
+    std::filesystem::remove(path);
+
+    std::cout << "========================================\n";
+    std::cout << "All archive benchmarks completed!\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
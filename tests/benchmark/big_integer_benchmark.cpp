@@ -0,0 +1,95 @@
+/**
+ * @file big_integer_benchmark.cpp
+ * @brief Arbitrary-precision multiplication and base conversion times
+ *
+ * Times BigInteger multiplication, division and conversion to and from
+ * decimal and hexadecimal for operands from 128 bits, the smallest wide
+ * programmer-mode register, up to 65536 bits, where Karatsuba and
+ * divide-and-conquer conversion dominate.
+ */
+
+#include "calc/math/big_integer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace calc;
+
+static constexpr int REPETITIONS = 5;
+static constexpr size_t BIT_SIZES[] = {128, 256, 1024, 4096, 16384, 65536};
+
+// A random value of @p bits bits, top bit set
+static BigInteger randomValue(std::mt19937_64& random, size_t bits) {
+    BigInteger value = BigInteger::powerOfTwo(bits - 1);
+    for (size_t i = 0; i + 64 <= bits - 1; i += 64) {
+        value |= BigInteger::fromUnsigned(random()) << i;
+    }
+    return value;
+}
+
+// Best of REPETITIONS runs of @p iterations calls of work(), in ns per call
+template <typename Work>
+static double bestOf(size_t iterations, Work&& work) {
+    double best = 0.0;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < iterations; ++j) {
+            work();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() /
+                    static_cast<double>(iterations);
+        best = (i == 0) ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+static void printRow(size_t bits, double multiply, double divide, double toDecimal,
+                     double fromDecimal, double toHex) {
+    std::cout << "  " << std::right << std::setw(7) << bits << std::fixed << std::setprecision(0)
+              << std::setw(13) << multiply << std::setw(13) << divide << std::setw(13) << toDecimal
+              << std::setw(13) << fromDecimal << std::setw(13) << toHex << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "BigInteger Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << "ns per operation, best of " << REPETITIONS << " runs\n\n";
+    std::cout << "  " << std::right << std::setw(7) << "bits" << std::setw(13) << "a * b"
+              << std::setw(13) << "2n / n" << std::setw(13) << "to dec" << std::setw(13) << "from dec"
+              << std::setw(13) << "to hex" << "\n";
+
+    std::mt19937_64 random(42);
+    size_t sink = 0;
+    for (size_t bits : BIT_SIZES) {
+        const BigInteger a = randomValue(random, bits);
+        const BigInteger b = randomValue(random, bits);
+        const BigInteger product = a * b;
+        const std::string decimal = a.toString(10);
+        // Fewer iterations for larger operands, so each size takes similar time
+        const size_t iterations = std::max<size_t>(1, (1u << 24) / (bits * bits / 64 + bits));
+
+        double multiply = bestOf(iterations, [&] { sink += (a * b).getLimbCount(); });
+        double divide = bestOf(iterations, [&] { sink += (product / a).getLimbCount(); });
+        double toDecimal = bestOf(iterations, [&] { sink += a.toString(10).size(); });
+        double fromDecimal = bestOf(iterations, [&] {
+            sink += BigInteger::fromString(decimal, 10).getLimbCount();
+        });
+        double toHex = bestOf(iterations, [&] { sink += a.toString(16).size(); });
+        printRow(bits, multiply, divide, toDecimal, fromDecimal, toHex);
+    }
+
+    std::cout << "\n========================================\n";
+    std::cout << "All BigInteger benchmarks completed! (" << sink % 10 << ")\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file converter_benchmark.cpp
+ * @brief Base conversion throughput, one value at a time and in bulk
+ *
+ * Converts a million random 64-bit IDs to and from binary, octal,
+ * decimal, hexadecimal and base 36, once through the std::string-per-value
+ * API (convertToBase/fromBase) and once through the bulk array API, which
+ * reuses one buffer for the whole batch.
+ */
+
+#include "calc/math/converter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace calc;
+
+static constexpr int REPETITIONS = 5;
+static constexpr size_t VALUE_COUNT = 1000000;
+static constexpr int BASES[] = {2, 8, 10, 16, 36};
+
+// Best of REPETITIONS runs of work(), in millions of values per second
+template <typename Work>
+static double bestOf(Work&& work) {
+    double best = 0.0;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        best = std::max(best, static_cast<double>(VALUE_COUNT) / seconds / 1e6);
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Converter Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << VALUE_COUNT << " random 64-bit values, million values/second, best of "
+              << REPETITIONS << " runs\n\n";
+    std::cout << "  " << std::right << std::setw(5) << "base" << std::setw(14) << "to (string)"
+              << std::setw(14) << "to (bulk)" << std::setw(14) << "from (string)" << std::setw(14)
+              << "from (bulk)" << "\n";
+
+    std::mt19937_64 random(42);
+    std::vector<long long> values(VALUE_COUNT);
+    for (long long& value : values) {
+        value = static_cast<long long>(random());
+    }
+
+    std::vector<long long> parsed(VALUE_COUNT);
+    std::vector<std::string> strings(VALUE_COUNT);
+    std::string text;
+    size_t sink = 0;
+    for (int base : BASES) {
+        double toString = bestOf([&] {
+            for (size_t i = 0; i < VALUE_COUNT; ++i) {
+                strings[i] = Converter::convertToBase(values[i], base);
+            }
+        });
+        double toBulk = bestOf([&] {
+            text.clear();
+            Converter::convertToBase(values.data(), values.size(), base, text);
+        });
+        double fromString = bestOf([&] {
+            for (size_t i = 0; i < VALUE_COUNT; ++i) {
+                parsed[i] = Converter::fromBase(strings[i], base);
+            }
+        });
+        double fromBulk = bestOf([&] {
+            sink += Converter::fromBase(text, base, parsed.data(), parsed.size());
+        });
+        if (parsed != values) {
+            std::cerr << "Round trip failed in base " << base << "\n";
+            return 1;
+        }
+
+        std::cout << "  " << std::right << std::setw(5) << base << std::fixed << std::setprecision(1)
+                  << std::setw(14) << toString << std::setw(14) << toBulk << std::setw(14)
+                  << fromString << std::setw(14) << fromBulk << "\n";
+    }
+
+    std::cout << "\n========================================\n";
+    std::cout << "All converter benchmarks completed! (" << sink % 10 << ")\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file daemon_benchmark.cpp
+ * @brief Cost of one evaluation through a new process versus a running daemon
+ *
+ * Serves scientific mode from a DaemonServer on a temporary socket and
+ * times a short expression evaluated by spawning calc_cli, by spawning
+ * calc_cli --connect, by connecting to the daemon for each expression,
+ * by one request per expression on a kept connection, and by pipelined
+ * requests of many expressions, next to a SharedEngine in this process.
+ */
+
+#include "calc/modes/scientific_mode.h"
+#include "calc/modes/shared_engine.h"
+#include "calc/ui/cli/daemon_client.h"
+#include "calc/ui/cli/daemon_server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+using namespace calc;
+using namespace calc::cli;
+
+static constexpr int REPETITIONS = 3;
+static const std::string EXPRESSION = "sin(PI / 4) * 2";
+
+// Best of REPETITIONS runs of @p iterations calls of work(), in us per call
+template <typename Work>
+static double bestOf(size_t iterations, Work&& work) {
+    double best = 0.0;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < iterations; ++j) {
+            work();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count() /
+                    static_cast<double>(iterations);
+        best = (i == 0) ? us : std::min(best, us);
+    }
+    return best;
+}
+
+// Run calc_cli with @p args, output discarded; false if it could not be run
+static bool spawnCli(const std::vector<std::string>& args) {
+    std::vector<char*> argv;
+    std::string program = CALC_CLI_PATH;
+    argv.push_back(program.data());
+    std::vector<std::string> copies(args);
+    for (auto& arg : copies) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    pid_t pid;
+    int spawned = posix_spawn(&pid, program.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (spawned != 0) {
+        return false;
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void printCost(const std::string& label, double us) {
+    std::cout << "  " << std::left << std::setw(44) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << us << " us/expression\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Daemon Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << "\"" << EXPRESSION << "\" in scientific mode, best of " << REPETITIONS << " runs\n\n";
+
+    const std::string path = "/tmp/calc_daemon_benchmark_" + std::to_string(::getpid()) + ".sock";
+    ModeManager modes;
+    DaemonServer server(modes, "scientific");
+    server.listen(path);
+    std::thread serving([&] { server.run(); });
+
+    DaemonRequest one;
+    one.mode = "scientific";
+    one.expressions = {EXPRESSION};
+    size_t sink = 0;
+
+    double spawnLocal = bestOf(100, [&] {
+        sink += spawnCli({"-m", "scientific", "--no-color", EXPRESSION});
+    });
+    printCost("spawn calc_cli", spawnLocal);
+
+    double spawnClient = bestOf(100, [&] {
+        sink += spawnCli({"--connect", path, "-m", "scientific", "--no-color", EXPRESSION});
+    });
+    printCost("spawn calc_cli --connect", spawnClient);
+
+    double connectEach = bestOf(2000, [&] {
+        DaemonClient client = DaemonClient::connect(path);
+        sink += client.evaluate(one).results.size();
+    });
+    printCost("connect and request per expression", connectEach);
+
+    DaemonClient client = DaemonClient::connect(path);
+    double roundTrip = bestOf(5000, [&] {
+        sink += client.evaluate(one).results.size();
+    });
+    printCost("request per expression, kept connection", roundTrip);
+
+    DaemonRequest many;
+    many.mode = "scientific";
+    many.expressions.assign(DaemonClient::LINES_PER_REQUEST, EXPRESSION);
+    const size_t requests = 100;
+    double pipelined = bestOf(1, [&] {
+        size_t inFlight = 0;
+        for (size_t i = 0; i < requests; ++i) {
+            client.send(many);
+            if (++inFlight == DaemonClient::REQUESTS_IN_FLIGHT) {
+                sink += client.receive().results.size();
+                --inFlight;
+            }
+        }
+        for (; inFlight > 0; --inFlight) {
+            sink += client.receive().results.size();
+        }
+    }) / static_cast<double>(requests * DaemonClient::LINES_PER_REQUEST);
+    printCost("pipelined requests of " + std::to_string(DaemonClient::LINES_PER_REQUEST), pipelined);
+
+    ScientificMode mode;
+    SharedEngine engine(mode);
+    EvaluationScratch scratch;
+    double local = bestOf(100000, [&] {
+        sink += engine.evaluate(EXPRESSION, scratch).isSuccess();
+    });
+    printCost("SharedEngine in this process", local);
+
+    server.stop();
+    serving.join();
+
+    std::cout << "\n  spawning calc_cli --connect is " << std::setprecision(1) << spawnLocal / spawnClient
+              << "x faster than spawning calc_cli; a kept connection is "
+              << spawnLocal / roundTrip << "x faster\n";
+
+    std::cout << "\n========================================\n";
+    std::cout << "All daemon benchmarks completed! (" << sink % 10 << ")\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file depth_scaling_benchmark.cpp
+ * @brief Parse, evaluate, clone and destroy times over nesting depth and chain length
+ *
+ * Every phase walks the tree with an explicit stack, so the time per node
+ * should stay flat from a thousand nodes to a million, whether the tree is
+ * a long left-leaning chain (1+1+...+1) or deeply nested (1+(1+(...))).
+ */
+
+#include "calc/core/compiled_expression.h"
+#include "calc/core/evaluator.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace calc;
+
+static constexpr int REPETITIONS = 3;
+
+static const std::vector<size_t> SIZES = {1000, 10000, 100000, 1000000};
+
+// 1+1+...+1 with n terms: a left-deep tree, no parentheses
+static std::string chainExpression(size_t n) {
+    std::string expr = "1";
+    for (size_t i = 1; i < n; ++i) {
+        expr += "+1";
+    }
+    return expr;
+}
+
+// 1+(1+(...(1))) with n terms: a right-deep tree, n - 1 levels of parentheses
+static std::string nestedExpression(size_t n) {
+    std::string expr;
+    for (size_t i = 1; i < n; ++i) {
+        expr += "1+(";
+    }
+    expr += "1";
+    expr.append(n - 1, ')');
+    return expr;
+}
+
+// One run of work(), in nanoseconds
+template <typename Work>
+static double timeOnce(Work&& work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    auto end = std::chrono::steady_clock::now();
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Best of REPETITIONS runs of work(), in nanoseconds
+template <typename Work>
+static double bestOf(Work&& work) {
+    double best = timeOnce(work);
+    for (int i = 1; i < REPETITIONS; ++i) {
+        best = std::min(best, timeOnce(work));
+    }
+    return best;
+}
+
+static void printHeader(const std::string& title) {
+    std::cout << title << " (ns per node)\n";
+    std::cout << "  " << std::right << std::setw(9) << "nodes" << std::setw(10) << "parse"
+              << std::setw(10) << "evaluate" << std::setw(10) << "compile" << std::setw(10)
+              << "execute" << std::setw(10) << "clone" << std::setw(10) << "destroy" << "\n";
+}
+
+static void benchmark_shape(const std::string& title, std::string (*makeExpression)(size_t)) {
+    printHeader(title);
+
+    for (size_t n : SIZES) {
+        const std::string expr = makeExpression(n);
+        const double nodes = static_cast<double>(2 * n - 1);
+        EvaluationContext context;
+
+        ShuntingYardParser parser;
+        std::unique_ptr<ASTNode> ast;
+        double parseNs = bestOf([&] {
+            Tokenizer tokenizer(expr);
+            ast = parser.parse(tokenizer.tokenize());
+        });
+
+        EvaluatorVisitor evaluator;
+        double evaluateNs = bestOf([&] { (void)evaluator.evaluate(ast.get(), context); });
+
+        std::unique_ptr<CompiledExpression> program;
+        double compileNs = bestOf([&] {
+            program = std::make_unique<CompiledExpression>(CompiledExpression::compile(*ast, context));
+        });
+
+        VirtualMachine vm;
+        double executeNs = bestOf([&] { (void)vm.execute(*program); });
+
+        std::unique_ptr<ASTNode> copy;
+        double cloneNs = bestOf([&] { copy = ast->clone(); });
+
+        // Each run destroys a fresh copy made outside the timed region
+        double destroyNs = 0.0;
+        for (int i = 0; i < REPETITIONS; ++i) {
+            copy = ast->clone();
+            double ns = timeOnce([&] { copy.reset(); });
+            destroyNs = (i == 0) ? ns : std::min(destroyNs, ns);
+        }
+
+        std::cout << "  " << std::setw(9) << static_cast<size_t>(nodes) << std::fixed
+                  << std::setprecision(1) << std::setw(10) << parseNs / nodes << std::setw(10)
+                  << evaluateNs / nodes << std::setw(10) << compileNs / nodes << std::setw(10)
+                  << executeNs / nodes << std::setw(10) << cloneNs / nodes << std::setw(10)
+                  << destroyNs / nodes << "\n";
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Depth Scaling Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << "Best of " << REPETITIONS << " runs per phase\n\n";
+
+    benchmark_shape("Chain length, 1+1+...+1", chainExpression);
+    benchmark_shape("Nesting depth, 1+(1+(...))", nestedExpression);
+
+    std::cout << "========================================\n";
+    std::cout << "All depth scaling benchmarks completed!\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
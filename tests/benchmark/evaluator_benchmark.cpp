@@ -6,11 +6,16 @@
 #include "calc/core/tokenizer.h"
 #include "calc/core/shunting_yard_parser.h"
 #include "calc/core/evaluator.h"
+#include "calc/core/compiled_expression.h"
+#include "calc/core/ast_optimizer.h"
+#include "calc/core/expression_dag.h"
 #include "calc/modes/standard_mode.h"
 #include "calc/modes/scientific_mode.h"
 #include "calc/modes/programmer_mode.h"
 #include "calc/benchmark/benchmark.h"
 
+#include <cmath>
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -71,7 +76,7 @@ static const std::vector<std::string> COMPLEX_EXPRESSIONS = {
     "pow(sqrt(x^2 + y^2), 0.5)",
     "log10(exp(x) + exp(y))",
     "(1 + 2 * 3 - 4 / 5 + 6 ^ 7) * (8 - 9)",
-    "sin(cos(tan(asin(acos(atan(x)))))"
+    "sin(cos(tan(asin(acos(atan(x))))))"
 };
 
 void benchmark_arithmetic_standard_mode() {
@@ -169,6 +174,25 @@ void benchmark_repeated_evaluation() {
     }));
 }
 
+void benchmark_expression_cache() {
+    const std::string expr = "(1 + 2) * (3 - 4) / 5";
+
+    StandardMode cached;
+    StandardMode uncached;
+    uncached.setCacheCapacity(0);
+
+    Benchmark b("Evaluator - Parsed Expression Cache (Same Expression)");
+    b.compare("Cached", [&] {
+        for (int i = 0; i < 100; ++i) {
+            (void)cached.evaluate(expr);
+        }
+    }, "Uncached", [&] {
+        for (int i = 0; i < 100; ++i) {
+            (void)uncached.evaluate(expr);
+        }
+    });
+}
+
 void benchmark_variable_expressions() {
     Benchmark b("Evaluator - Variable-like Expressions");
     std::vector<std::string> exprs;
@@ -254,6 +278,215 @@ void benchmark_error_handling() {
     }));
 }
 
+/**
+ * @brief Compare tree walking against the bytecode VM on pre-parsed expressions
+ *
+ * Parsing is done once up front so that only evaluation is timed.
+ */
+void benchmark_compiled_vs_visitor(const std::string& name,
+                                   const std::vector<std::string>& expressions,
+                                   OperatorSemantics caretSemantics = OperatorSemantics::POWER) {
+    EvaluationContext context;
+    MathFunctions::registerBuiltInFunctions(context);
+    context.setOperatorSemantics("^", caretSemantics);
+
+    std::vector<std::unique_ptr<ASTNode>> trees;
+    std::vector<CompiledExpression> programs;
+    ShuntingYardParser parser;
+    for (const auto& expr : expressions) {
+        Tokenizer tokenizer(expr);
+        trees.push_back(parser.parse(tokenizer.tokenize()));
+        programs.push_back(CompiledExpression::compile(*trees.back(), context));
+    }
+
+    EvaluatorVisitor visitor;
+    VirtualMachine vm;
+
+    Benchmark b("Compiled vs Visitor - " + name);
+    b.compare("VirtualMachine", [&] {
+        for (int i = 0; i < 100; ++i) {
+            for (const auto& program : programs) {
+                (void)vm.execute(program);
+            }
+        }
+    }, "EvaluatorVisitor", [&] {
+        for (int i = 0; i < 100; ++i) {
+            for (const auto& tree : trees) {
+                (void)visitor.evaluate(tree.get(), context);
+            }
+        }
+    });
+}
+
+// Rows per second for one expression applied to struct-of-arrays columns
+void benchmark_batch_columns(const std::string& expr) {
+    constexpr size_t ROWS = 100000;
+    std::vector<double> x(ROWS);
+    std::vector<double> y(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        x[i] = 0.001 * static_cast<double>(i);
+        y[i] = 1.0 + 0.0005 * static_cast<double>(i);
+    }
+    std::vector<double> out(ROWS);
+
+    ScientificMode batchMode;
+    Benchmark batch("Batch Columns - evaluateBatch(\"" + expr + "\")");
+    BenchmarkResult batchResult = batch.run([&] {
+        (void)batchMode.evaluateBatch(expr, {{"x", x.data()}, {"y", y.data()}}, ROWS, out.data());
+    });
+    batch.print_result(batchResult);
+
+    ScientificMode rowMode;
+    size_t xSlot = rowMode.getContext().setVariable("x", 0.0);
+    size_t ySlot = rowMode.getContext().setVariable("y", 0.0);
+    Benchmark perRow("Batch Columns - evaluate() per row (\"" + expr + "\")");
+    BenchmarkResult perRowResult = perRow.run([&] {
+        for (size_t i = 0; i < ROWS; ++i) {
+            rowMode.getContext().setVariable(xSlot, x[i]);
+            rowMode.getContext().setVariable(ySlot, y[i]);
+            EvaluationResult result = rowMode.evaluate(expr);
+            out[i] = result.isSuccess() ? result.getValue() : std::nan("");
+        }
+    });
+    perRow.print_result(perRowResult);
+
+    std::cout << "  Rows/sec:       evaluateBatch " << static_cast<double>(ROWS) * 1e9 / batchResult.mean_ns
+              << ", per row " << static_cast<double>(ROWS) * 1e9 / perRowResult.mean_ns << "\n\n";
+}
+
+// Batch rows per second with and without the AST optimizer
+void benchmark_optimizer(const std::string& expr) {
+    constexpr size_t ROWS = 100000;
+    std::vector<double> x(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        x[i] = 0.001 * static_cast<double>(i);
+    }
+    std::vector<double> out(ROWS);
+
+    EvaluationContext context;
+    MathFunctions::registerBuiltInFunctions(context);
+    Tokenizer tokenizer(expr);
+    ShuntingYardParser parser;
+    auto ast = parser.parse(tokenizer.tokenize());
+
+    ASTOptimizer optimizer(context);
+    auto optimized = optimizer.optimize(*ast, {"x"});
+    const OptimizationStats& stats = optimizer.getStats();
+
+    VirtualMachine vm;
+    CompiledExpression plain = CompiledExpression::compile(*ast, context, {"x"});
+    CompiledExpression folded = CompiledExpression::compile(*optimized, context, {"x"});
+
+    Benchmark plainBench("Optimizer - unoptimized (\"" + expr + "\")");
+    BenchmarkResult plainResult = plainBench.run([&] {
+        (void)vm.executeBatch(plain, {x.data()}, ROWS, out.data());
+    });
+    plainBench.print_result(plainResult);
+
+    Benchmark foldedBench("Optimizer - optimized (\"" + expr + "\")");
+    BenchmarkResult foldedResult = foldedBench.run([&] {
+        (void)vm.executeBatch(folded, {x.data()}, ROWS, out.data());
+    });
+    foldedBench.print_result(foldedResult);
+
+    std::cout << "  Nodes:          " << stats.nodesBefore << " -> " << stats.nodesAfter
+              << " (" << stats.constantsFolded << " folded, " << stats.strengthReduced
+              << " strength-reduced)\n";
+    std::cout << "  Rows/sec:       optimized " << static_cast<double>(ROWS) * 1e9 / foldedResult.mean_ns
+              << ", unoptimized " << static_cast<double>(ROWS) * 1e9 / plainResult.mean_ns << "\n\n";
+}
+
+// Batch rows per second compiled from the tree and from its hash-consed DAG
+void benchmark_common_subexpressions(const std::string& expr) {
+    constexpr size_t ROWS = 100000;
+    std::vector<double> x(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        x[i] = 0.001 * static_cast<double>(i);
+    }
+    std::vector<double> out(ROWS);
+
+    EvaluationContext context;
+    MathFunctions::registerBuiltInFunctions(context);
+    Tokenizer tokenizer(expr);
+    ShuntingYardParser parser;
+    auto ast = parser.parse(tokenizer.tokenize());
+
+    ExpressionDag dag = ExpressionDag::build(*ast, context);
+    const DagStats& stats = dag.getStats();
+
+    VirtualMachine vm;
+    CompiledExpression tree = CompiledExpression::compile(*ast, context, {"x"});
+    CompiledExpression shared = CompiledExpression::compile(dag, context, {"x"});
+
+    Benchmark treeBench("CSE - tree (\"" + expr + "\")");
+    BenchmarkResult treeResult = treeBench.run([&] {
+        (void)vm.executeBatch(tree, {x.data()}, ROWS, out.data());
+    });
+    treeBench.print_result(treeResult);
+
+    Benchmark dagBench("CSE - DAG (\"" + expr + "\")");
+    BenchmarkResult dagResult = dagBench.run([&] {
+        (void)vm.executeBatch(shared, {x.data()}, ROWS, out.data());
+    });
+    dagBench.print_result(dagResult);
+
+    std::cout << "  Nodes:          " << stats.treeNodes << " -> " << stats.dagNodes
+              << " (" << stats.nodesDeduplicated << " deduplicated, " << stats.sharedNodes
+              << " shared)\n";
+    std::cout << "  Rows/sec:       DAG " << static_cast<double>(ROWS) * 1e9 / dagResult.mean_ns
+              << ", tree " << static_cast<double>(ROWS) * 1e9 / treeResult.mean_ns << "\n\n";
+}
+
+/**
+ * @brief Compare fixed-arity function entries against vector callbacks
+ *
+ * Both contexts compute the same functions; the second registers them the
+ * way custom functions are, so every call builds an argument vector.
+ */
+void benchmark_function_dispatch(const std::vector<std::string>& expressions) {
+    EvaluationContext typed;
+    MathFunctions::registerBuiltInFunctions(typed);
+
+    EvaluationContext callbacks;
+    MathFunctions::registerBuiltInFunctions(callbacks);
+    const std::vector<std::pair<std::string, double (*)(double)>> unary = {
+        {"sin", &MathFunctions::sin}, {"cos", &MathFunctions::cos}, {"tan", &MathFunctions::tan},
+        {"exp", &MathFunctions::exp}, {"log", &MathFunctions::log}, {"sqrt", &MathFunctions::sqrt}
+    };
+    for (const auto& fn : unary) {
+        auto function = fn.second;
+        callbacks.addFunction(fn.first, [function](const std::vector<double>& args) {
+            return function(args.at(0));
+        });
+    }
+    callbacks.addFunction("pow", [](const std::vector<double>& args) {
+        return std::pow(args.at(0), args.at(1));
+    });
+
+    std::vector<std::unique_ptr<ASTNode>> trees;
+    ShuntingYardParser parser;
+    for (const auto& expr : expressions) {
+        Tokenizer tokenizer(expr);
+        trees.push_back(parser.parse(tokenizer.tokenize()));
+    }
+
+    EvaluatorVisitor visitor;
+    Benchmark b("Function Dispatch - EvaluatorVisitor");
+    b.compare("Fixed-arity entries", [&] {
+        for (int i = 0; i < 100; ++i) {
+            for (const auto& tree : trees) {
+                (void)visitor.evaluate(tree.get(), typed);
+            }
+        }
+    }, "Vector callbacks", [&] {
+        for (int i = 0; i < 100; ++i) {
+            for (const auto& tree : trees) {
+                (void)visitor.evaluate(tree.get(), callbacks);
+            }
+        }
+    });
+}
+
 int main(int argc, char* argv[]) {
     (void)argc;
     (void)argv;
@@ -271,12 +504,36 @@ int main(int argc, char* argv[]) {
     benchmark_complex_expressions();
     benchmark_mode_comparison();
     benchmark_repeated_evaluation();
+    benchmark_expression_cache();
     benchmark_variable_expressions();
     benchmark_full_pipeline();
     benchmark_constants();
     benchmark_rounding_functions();
     benchmark_error_handling();
 
+    benchmark_compiled_vs_visitor("Arithmetic", ARITHMETIC_EXPRESSIONS);
+    benchmark_compiled_vs_visitor("Power", EXPRESSION_EXPRESSIONS);
+    benchmark_compiled_vs_visitor("Trigonometric", TRIG_EXPRESSIONS);
+    benchmark_compiled_vs_visitor("Nested Functions", NESTED_EXPRESSIONS);
+    benchmark_compiled_vs_visitor("Bitwise", BITWISE_EXPRESSIONS, OperatorSemantics::BITWISE_XOR);
+
+    benchmark_function_dispatch({
+        "sin(0.5) * cos(0.5) + tan(0.25)",
+        "log(exp(1.5)) + sqrt(2) * log(10)",
+        "pow(sin(1), 2) + pow(cos(1), 2)",
+        "exp(-sqrt(log(100))) * sin(cos(tan(0.1)))"
+    });
+
+    for (const auto& expr : COMPLEX_EXPRESSIONS) {
+        benchmark_batch_columns(expr);
+    }
+
+    benchmark_optimizer("x * (2 * PI / 360) + sin(PI / 4) * cos(PI / 3)");
+    benchmark_optimizer("x ^ 2 + 2 * (1 + sqrt(2)) * x + log(10) ^ 2");
+
+    benchmark_common_subexpressions("sin(2 * PI * x) + sin(2 * PI * x) ^ 2 * cos(2 * PI * x)");
+    benchmark_common_subexpressions("sqrt(x ^ 2 + 1) / (1 + sqrt(x ^ 2 + 1)) + log(sqrt(x ^ 2 + 1))");
+
     std::cout << "========================================\n";
     std::cout << "All evaluator benchmarks completed!\n";
     std::cout << "========================================\n";
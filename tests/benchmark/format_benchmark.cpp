@@ -0,0 +1,123 @@
+/**
+ * @file format_benchmark.cpp
+ * @brief Result formatting cost per format, next to the cost of evaluating
+ *
+ * Formats a million random results through a std::ostringstream, as
+ * OutputFormatter::formatValue used to, and through every ResultFormat
+ * of OutputFormatter::appendRecord into one reused buffer. A cached
+ * SharedEngine evaluation is timed alongside for scale.
+ */
+
+#include "calc/modes/scientific_mode.h"
+#include "calc/modes/shared_engine.h"
+#include "calc/ui/cli/output_formatter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace calc;
+using namespace calc::cli;
+
+static constexpr int REPETITIONS = 5;
+static constexpr size_t VALUE_COUNT = 1000000;
+
+// Best of REPETITIONS runs of work(), in ns per value
+template <typename Work>
+static double bestOf(Work&& work) {
+    double best = 0.0;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() /
+                    static_cast<double>(VALUE_COUNT);
+        best = (i == 0) ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+static void printCost(const std::string& label, double ns) {
+    std::cout << "  " << std::left << std::setw(30) << label << std::right << std::fixed
+              << std::setprecision(1) << std::setw(8) << ns << " ns/value\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Format Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << VALUE_COUNT << " results (one in ten an error), best of " << REPETITIONS << " runs\n\n";
+
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    std::vector<EvaluationResult> results;
+    results.reserve(VALUE_COUNT);
+    for (size_t i = 0; i < VALUE_COUNT; ++i) {
+        if (i % 10 == 9) {
+            results.emplace_back(ErrorCode::DIVISION_BY_ZERO, "Division by zero", 4);
+        } else {
+            results.emplace_back(distribution(random));
+        }
+    }
+
+    const std::string expression = "x / y";
+    std::string buffer;
+    size_t sink = 0;
+
+    double streamed = bestOf([&] {
+        for (const auto& result : results) {
+            std::ostringstream oss;
+            if (result.isSuccess()) {
+                oss << std::fixed << std::setprecision(6) << result.getValue();
+            } else {
+                oss << "Error: " << result.getErrorMessage() << " at position " << result.getErrorPosition();
+            }
+            sink += oss.str().size();
+        }
+    });
+    printCost("std::ostringstream", streamed);
+
+    const std::pair<const char*, ResultFormat> formats[] = {
+        {"appendRecord text", ResultFormat::TEXT},
+        {"appendRecord jsonl", ResultFormat::JSONL},
+        {"appendRecord csv", ResultFormat::CSV},
+        {"appendRecord tsv", ResultFormat::TSV},
+        {"appendRecord binary", ResultFormat::BINARY}
+    };
+    for (const auto& [label, format] : formats) {
+        double ns = bestOf([&, format = format] {
+            buffer.clear();
+            for (const auto& result : results) {
+                OutputFormatter::appendRecord(buffer, format, expression, result);
+            }
+            sink += buffer.size();
+        });
+        printCost(label, ns);
+    }
+
+    ScientificMode mode;
+    mode.getContext().setVariable("x", 3.0);
+    mode.getContext().setVariable("y", 7.0);
+    SharedEngine engine(mode);
+    EvaluationScratch scratch;
+    double evaluate = bestOf([&] {
+        for (size_t i = 0; i < VALUE_COUNT; ++i) {
+            sink += engine.evaluate(expression, scratch).isSuccess();
+        }
+    });
+    printCost("evaluate \"x / y\" (cached)", evaluate);
+
+    std::cout << "\n========================================\n";
+    std::cout << "All format benchmarks completed! (" << sink % 10 << ")\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file mapped_benchmark.cpp
+ * @brief Batch file throughput: streamed lines versus a mapped buffer
+ *
+ * Evaluates a generated file of a million expressions once through
+ * BatchRunner, which reads a std::string per line from a stream, and
+ * once through MappedRunner, which splits the mapped file into chunks
+ * and evaluates views into it, on one thread and on every core.
+ */
+
+#include "calc/modes/scientific_mode.h"
+#include "calc/modes/shared_engine.h"
+#include "calc/ui/cli/batch_runner.h"
+#include "calc/ui/cli/mapped_runner.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace calc;
+using namespace calc::cli;
+
+static constexpr int REPETITIONS = 3;
+static constexpr size_t LINE_COUNT = 1000000;
+static constexpr const char* INPUT_PATH = "mapped_benchmark.txt";
+
+static const char* const EXPRESSIONS[] = {
+    "sin(%) * cos(%)",
+    "% * 2 + 1",
+    "sqrt(%) + log(% + 1)",
+    "max(%, 3) ^ 2",
+    "(% + 1) / (% - 0.5)"
+};
+
+// Best of REPETITIONS runs of work(), which returns the run's counters
+template <typename Work>
+static BatchStats bestOf(Work&& work) {
+    BatchStats best;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        BatchStats stats = work();
+        if (i == 0 || stats.seconds < best.seconds) {
+            best = stats;
+        }
+    }
+    return best;
+}
+
+static void printStats(const std::string& label, const BatchStats& stats) {
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::fixed
+              << std::setprecision(0) << std::setw(12)
+              << static_cast<double>(stats.evaluated) / stats.seconds << " expr/s"
+              << std::setprecision(1) << std::setw(10)
+              << static_cast<double>(stats.bytesRead) / stats.seconds / (1024.0 * 1024.0)
+              << " MiB/s\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Mapped Batch Benchmarks\n";
+    std::cout << "========================================\n";
+
+    // A few hundred distinct expressions, so the program cache holds them all
+    {
+        std::ofstream file(INPUT_PATH, std::ios::binary | std::ios::trunc);
+        std::string line;
+        for (size_t i = 0; i < LINE_COUNT; ++i) {
+            line = EXPRESSIONS[i % 5];
+            const std::string value = std::to_string(i % 40);
+            for (size_t at = line.find('%'); at != std::string::npos; at = line.find('%', at)) {
+                line.replace(at, 1, value);
+            }
+            file << line << '\n';
+        }
+    }
+
+    MappedFile input = MappedFile::open(INPUT_PATH);
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << LINE_COUNT << " lines, " << input.size() / (1024 * 1024) << " MiB, best of "
+              << REPETITIONS << " runs\n\n";
+
+    ScientificMode mode;
+    SharedEngine engine(mode);
+    std::ostringstream sink;
+
+    BatchStats streamed = bestOf([&] {
+        std::ifstream in(INPUT_PATH, std::ios::binary);
+        sink.str("");
+        return BatchRunner(engine, 1).run(in, sink);
+    });
+    BatchStats mappedOne = bestOf([&] {
+        sink.str("");
+        return MappedRunner(engine, 1).run(input.view(), sink);
+    });
+    BatchStats mappedAll = bestOf([&] {
+        sink.str("");
+        return MappedRunner(engine, cores).run(input.view(), sink);
+    });
+    std::remove(INPUT_PATH);
+
+    printStats("BatchRunner, 1 worker", streamed);
+    printStats("MappedRunner, 1 worker", mappedOne);
+    printStats("MappedRunner, " + std::to_string(cores) + (cores == 1 ? " worker" : " workers"), mappedAll);
+
+    std::cout << "\n========================================\n";
+    std::cout << "All mapped batch benchmarks completed!\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -6,9 +6,11 @@
 #include "calc/core/tokenizer.h"
 #include "calc/core/shunting_yard_parser.h"
 #include "calc/core/recursive_descent_parser.h"
+#include "calc/core/pratt_parser.h"
 #include "calc/core/ast.h"
 #include "calc/benchmark/benchmark.h"
 
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -42,7 +44,7 @@ static const std::vector<std::string> COMPLEX_EXPRESSIONS = {
 
 static const std::vector<std::string> NESTED_EXPRESSIONS = {
     "(((((1)))))*(((((2)))))",
-    "sin(cos(tan(asin(acos(atan(x)))))",
+    "sin(cos(tan(asin(acos(atan(x))))))",
     "pow(pow(pow(pow(x, 2), 3), 4), 5)",
     "log(log(log(log(log(x)))))",
     "((((((1 + 2) * 3) - 4) / 5) ^ 6) + 7)"
@@ -50,8 +52,8 @@ static const std::vector<std::string> NESTED_EXPRESSIONS = {
 
 static const std::vector<std::string> FUNCTION_CHAIN_EXPRESSIONS = {
     "sin(cos(tan(x)))",
-    "abs(round(floor(ceil(sqrt(100))))",
-    "asin(acos(atan(sinh(cosh(tanh(x)))))",
+    "abs(round(floor(ceil(sqrt(100)))))",
+    "asin(acos(atan(sinh(cosh(tanh(x))))))",
     "log10(log(exp(pow(x, 2))))",
     "max(min(x, 100), abs(x))"
 };
@@ -233,7 +235,7 @@ void benchmark_single_complex_expression() {
     for (int i = 0; i < 100; ++i) {
         complex_expr += "(sin(" + std::to_string(i) + ")+cos(" + std::to_string(i+1) + "))*";
     }
-    complex_expr.back() = ')';  // Replace last '*'
+    complex_expr.pop_back();  // Drop the trailing '*'
 
     Benchmark b("Parser - Single 100-term Complex Expression");
     b.compare("ShuntingYard", [&] {
@@ -249,6 +251,108 @@ void benchmark_single_complex_expression() {
     });
 }
 
+void benchmark_arena_parse() {
+    std::string large_expr = "x";
+    for (int i = 0; i < 2000; ++i) {
+        large_expr += " + " + std::to_string(i) + " * max(x, " + std::to_string(i) + ") - -y";
+    }
+    Tokenizer tokenizer(large_expr);
+    auto tokens = tokenizer.tokenize();
+
+    Benchmark shunting("ShuntingYardParser - 2000-term Expression (heap vs arena)");
+    shunting.compare("Heap", [&] {
+        ShuntingYardParser parser;
+        (void)parser.parse(tokens);
+    }, "Arena", [&] {
+        ShuntingYardParser parser;
+        (void)parser.parseToArena(tokens);
+    });
+
+    Benchmark descent("RecursiveDescentParser - 2000-term Expression (heap vs arena)");
+    descent.compare("Heap", [&] {
+        RecursiveDescentParser parser;
+        (void)parser.parse(tokens);
+    }, "Arena", [&] {
+        RecursiveDescentParser parser;
+        (void)parser.parseToArena(tokens);
+    });
+}
+
+void benchmark_number_heavy() {
+    // CSV-like argument list: almost all of the input is number literals
+    std::string csv = "max(";
+    for (int i = 0; i < 5000; ++i) {
+        csv += std::to_string(i) + "." + std::to_string(i % 97) + "e-2, ";
+    }
+    csv += "0x7FFF)";
+
+    Benchmark b("Tokenize + Parse - max() of 5000 Literals");
+    b.compare("ShuntingYard", [&] {
+        ShuntingYardParser parser;
+        Tokenizer tokenizer(csv);
+        auto tokens = tokenizer.tokenize();
+        (void)parser.parseToArena(tokens);
+    }, "RecursiveDescent", [&] {
+        RecursiveDescentParser parser;
+        Tokenizer tokenizer(csv);
+        auto tokens = tokenizer.tokenize();
+        (void)parser.parseToArena(tokens);
+    });
+}
+
+// Time each parser on the same pre-tokenized input, so only parsing is measured
+static void compareAllParsers(const std::string& name, const std::vector<std::vector<Token>>& inputs) {
+    auto parseAll = [&](Parser& parser) {
+        for (const auto& tokens : inputs) {
+            (void)parser.parseToArena(tokens);
+        }
+    };
+
+    Benchmark shunting(name + " - ShuntingYard");
+    BenchmarkResult shuntingResult = shunting.run([&] {
+        ShuntingYardParser parser;
+        parseAll(parser);
+    });
+    Benchmark descent(name + " - RecursiveDescent");
+    BenchmarkResult descentResult = descent.run([&] {
+        RecursiveDescentParser parser;
+        parseAll(parser);
+    });
+    Benchmark pratt(name + " - Pratt");
+    BenchmarkResult prattResult = pratt.run([&] {
+        PrattParser parser;
+        parseAll(parser);
+    });
+
+    std::cout << shuntingResult.format() << descentResult.format() << prattResult.format();
+    std::cout << "  Pratt vs ShuntingYard:     " << shuntingResult.mean_ns / prattResult.mean_ns << "x\n";
+    std::cout << "  Pratt vs RecursiveDescent: " << descentResult.mean_ns / prattResult.mean_ns << "x\n\n";
+}
+
+static std::vector<std::vector<Token>> tokenizeAll(const std::vector<std::string>& expressions) {
+    std::vector<std::vector<Token>> inputs;
+    for (const auto& expr : expressions) {
+        Tokenizer tokenizer(expr);
+        inputs.push_back(tokenizer.tokenize());
+    }
+    return inputs;
+}
+
+void benchmark_all_parsers() {
+    std::vector<std::string> mixed;
+    for (const auto* set : {&SIMPLE_EXPRESSIONS, &MEDIUM_EXPRESSIONS, &COMPLEX_EXPRESSIONS,
+                            &NESTED_EXPRESSIONS, &FUNCTION_CHAIN_EXPRESSIONS}) {
+        mixed.insert(mixed.end(), set->begin(), set->end());
+    }
+    compareAllParsers("All Parsers - 25 Mixed Expressions", tokenizeAll(mixed));
+
+    std::string large_expr = "x";
+    for (int i = 0; i < 2000; ++i) {
+        large_expr += " + " + std::to_string(i) + " * max(x, " + std::to_string(i) + ") ^ -y";
+    }
+    compareAllParsers("All Parsers - 2000-term Expression", tokenizeAll({large_expr}));
+}
+
 int main(int argc, char* argv[]) {
     (void)argc;
     (void)argv;
@@ -275,6 +379,9 @@ int main(int argc, char* argv[]) {
     benchmark_parser_comparison_nested();
     benchmark_function_calls();
     benchmark_single_complex_expression();
+    benchmark_arena_parse();
+    benchmark_number_heavy();
+    benchmark_all_parsers();
 
     std::cout << "========================================\n";
     std::cout << "All parser benchmarks completed!\n";
@@ -0,0 +1,108 @@
+/**
+ * @file precision_benchmark.cpp
+ * @brief Arbitrary-precision floating-point cost versus digits
+ *
+ * Times the correctly rounded BigFloat operations, the BigFloatFunctions
+ * series and a whole precision-mode evaluation at 50, 100, 1000 and
+ * 10000 significant digits, to show how cost grows with precision.
+ */
+
+#include "calc/math/big_float.h"
+#include "calc/modes/precision_mode.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace calc;
+
+static constexpr int REPETITIONS = 5;
+static constexpr size_t DIGITS[] = {50, 100, 1000, 10000};
+
+// Best of REPETITIONS runs of @p iterations calls of work(), in us per call
+template <typename Work>
+static double bestOf(size_t iterations, Work&& work) {
+    double best = 0.0;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < iterations; ++j) {
+            work();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count() /
+                    static_cast<double>(iterations);
+        best = (i == 0) ? us : std::min(best, us);
+    }
+    return best;
+}
+
+static void printHeader() {
+    std::cout << "  " << std::right << std::setw(6) << "digits";
+    for (const char* name : {"a * b", "a / b", "sqrt", "exp", "log", "sin", "atan", "mode"}) {
+        std::cout << std::setw(11) << name;
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Precision Mode Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << "us per operation, best of " << REPETITIONS << " runs\n";
+    std::cout << "mode: PrecisionMode::evaluatePrecise(\"sqrt(2) * exp(0.5) / 3\") and formatResult()\n\n";
+    printHeader();
+
+    size_t sink = 0;
+    for (size_t digits : DIGITS) {
+        const size_t bits = BigFloat::precisionForDigits(digits) + PrecisionMode::GUARD_BITS;
+        const BigFloat a = BigFloat::sqrt(BigFloat(BigInteger(2)), bits);
+        const BigFloat b = BigFloat::divide(BigFloat(BigInteger(1)), BigFloat(BigInteger(3)), bits);
+        // Fewer iterations at more digits, so each size takes similar time
+        const size_t iterations = std::max<size_t>(1, 200000 / (digits * digits / 50 + digits));
+
+        PrecisionMode mode(static_cast<int>(digits));
+        const std::string expression = "sqrt(2) * exp(0.5) / 3";
+
+        double multiply = bestOf(iterations * 20, [&] {
+            sink += BigFloat::multiply(a, b, bits).getMantissa().getLimbCount();
+        });
+        double divide = bestOf(iterations * 4, [&] {
+            sink += BigFloat::divide(a, b, bits).getMantissa().getLimbCount();
+        });
+        double sqrt = bestOf(iterations * 4, [&] {
+            sink += BigFloat::sqrt(b, bits).getMantissa().getLimbCount();
+        });
+        double exp = bestOf(iterations, [&] {
+            sink += BigFloatFunctions::exp(b, bits).getMantissa().getLimbCount();
+        });
+        double log = bestOf(iterations, [&] {
+            sink += BigFloatFunctions::log(a, bits).getMantissa().getLimbCount();
+        });
+        double sin = bestOf(iterations, [&] {
+            sink += BigFloatFunctions::sin(a, bits).getMantissa().getLimbCount();
+        });
+        double atan = bestOf(iterations, [&] {
+            sink += BigFloatFunctions::atan(b, bits).getMantissa().getLimbCount();
+        });
+        double evaluate = bestOf(iterations, [&] {
+            sink += mode.formatResult(mode.evaluatePrecise(expression)).size();
+        });
+
+        std::cout << "  " << std::right << std::setw(6) << digits << std::fixed << std::setprecision(1);
+        for (double us : {multiply, divide, sqrt, exp, log, sin, atan, evaluate}) {
+            std::cout << std::setw(11) << us;
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "\n========================================\n";
+    std::cout << "All precision benchmarks completed! (" << sink % 10 << ")\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file simd_benchmark.cpp
+ * @brief Rows per second of batch evaluation at each SIMD level
+ */
+
+#include "calc/core/tokenizer.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/compiled_expression.h"
+#include "calc/benchmark/benchmark.h"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace calc;
+using namespace calc::benchmark;
+
+static constexpr size_t ROWS = 1'000'000;
+
+static const std::vector<std::string> ARITHMETIC_EXPRESSIONS = {
+    "x + y",
+    "x * y + x / y - 3",
+    "(x - y) * (x + y) / (x * x + 1) ^ 2"
+};
+
+static const std::vector<std::string> FUNCTION_EXPRESSIONS = {
+    "sqrt(x) + abs(y)",
+    "floor(x) + ceil(y) + trunc(x * y)",
+    "sin(x) * cos(y) + exp(y / 100)"
+};
+
+static const std::vector<std::string> BITWISE_EXPRESSIONS = {
+    "(x & 0xFF) | (y << 3)",
+    "~x ^ (y >> 2)"
+};
+
+static std::unique_ptr<ASTNode> parse(const std::string& expr) {
+    Tokenizer tokenizer(expr);
+    auto tokens = tokenizer.tokenize();
+    ShuntingYardParser parser;
+    return parser.parse(tokens);
+}
+
+void benchmark_simd_levels(const std::string& category, const std::vector<std::string>& expressions,
+                           OperatorSemantics caretSemantics = OperatorSemantics::POWER) {
+    std::vector<double> x(ROWS);
+    std::vector<double> y(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        x[i] = 1.0 + 0.001 * static_cast<double>(i % 100000);
+        y[i] = 2.0 + static_cast<double>(i % 61);
+    }
+    std::vector<double> out(ROWS);
+
+    EvaluationContext context;
+    MathFunctions::registerBuiltInFunctions(context);
+    context.setOperatorSemantics("^", caretSemantics);
+
+    BenchmarkConfig config;
+    config.min_iterations = 5;
+    config.warmup_iterations = 2;
+
+    for (const auto& expr : expressions) {
+        auto ast = parse(expr);
+        CompiledExpression program = CompiledExpression::compile(*ast, context, {"x", "y"});
+        std::cout << category << " - " << expr << "\n";
+
+        double scalarRowsPerSec = 0.0;
+        for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (!isSimdLevelSupported(level)) {
+                std::cout << "  " << std::left << std::setw(8) << simdLevelToString(level)
+                          << "not supported\n";
+                continue;
+            }
+
+            VirtualMachine vm;
+            vm.setSimdLevel(level);
+            Benchmark bench(simdLevelToString(level), config);
+            BenchmarkResult result = bench.run([&] {
+                (void)vm.executeBatch(program, {x.data(), y.data()}, ROWS, out.data());
+            });
+
+            double rowsPerSec = static_cast<double>(ROWS) * 1e9 / result.mean_ns;
+            if (level == SimdLevel::SCALAR) {
+                scalarRowsPerSec = rowsPerSec;
+            }
+            std::cout << "  " << std::left << std::setw(8) << simdLevelToString(level)
+                      << std::right << std::setw(14) << std::fixed << std::setprecision(0)
+                      << rowsPerSec << " rows/s  (" << std::setprecision(2)
+                      << rowsPerSec / scalarRowsPerSec << "x scalar)\n";
+        }
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "SIMD Batch Evaluation Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << "Rows per batch: " << ROWS << ", detected level: "
+              << simdLevelToString(detectSimdLevel()) << "\n\n";
+
+    benchmark_simd_levels("Arithmetic", ARITHMETIC_EXPRESSIONS);
+    benchmark_simd_levels("Functions", FUNCTION_EXPRESSIONS);
+    benchmark_simd_levels("Bitwise", BITWISE_EXPRESSIONS, OperatorSemantics::BITWISE_XOR);
+
+    std::cout << "========================================\n";
+    std::cout << "All SIMD benchmarks completed!\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file startup_benchmark.cpp
+ * @brief Time to first result of a short-lived calc_cli
+ *
+ * Times `calc_cli "1+1"` end to end next to spawning a program that does
+ * nothing, then the calculator's own share of it in this process: building
+ * a ModeManager, registering the built-in functions, and building a mode and
+ * evaluating the first expression with it, compared with building every
+ * mode up front.
+ */
+
+#include "calc/modes/mode_manager.h"
+#include "calc/modes/precision_mode.h"
+#include "calc/modes/programmer_mode.h"
+#include "calc/modes/scientific_mode.h"
+#include "calc/modes/standard_mode.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+using namespace calc;
+
+static constexpr int REPETITIONS = 3;
+static const std::string EXPRESSION = "1+1";
+
+// Calculator work before the first result is printed, in us
+static constexpr double TARGET_FIRST_RESULT_US = 5.0;
+
+// Best of REPETITIONS runs of @p iterations calls of work(), in us per call
+template <typename Work>
+static double bestOf(size_t iterations, Work&& work) {
+    double best = 0.0;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < iterations; ++j) {
+            work();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count() /
+                    static_cast<double>(iterations);
+        best = (i == 0) ? us : std::min(best, us);
+    }
+    return best;
+}
+
+// Run @p program with @p args, output discarded; false if it did not exit with 0
+static bool spawn(std::string program, const std::vector<std::string>& args) {
+    std::vector<char*> argv;
+    argv.push_back(program.data());
+    std::vector<std::string> copies(args);
+    for (auto& arg : copies) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    pid_t pid;
+    int spawned = posix_spawn(&pid, program.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (spawned != 0) {
+        return false;
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void printCost(const std::string& label, double us) {
+    std::cout << "  " << std::left << std::setw(44) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << us << " us\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Startup Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << "\"" << EXPRESSION << "\", best of " << REPETITIONS << " runs\n\n";
+
+    size_t sink = 0;
+
+    std::cout << "End to end:\n";
+    double floor = bestOf(100, [&] { sink += spawn("/bin/true", {}); });
+    printCost("spawn /bin/true", floor);
+    double version = bestOf(100, [&] { sink += spawn(CALC_CLI_PATH, {"--version"}); });
+    printCost("spawn calc_cli --version", version);
+    double cli = bestOf(100, [&] { sink += spawn(CALC_CLI_PATH, {"--no-color", EXPRESSION}); });
+    printCost("spawn calc_cli \"" + EXPRESSION + "\"", cli);
+
+    std::cout << "\nIn this process:\n";
+    double manager = bestOf(10000, [&] {
+        ModeManager modes;
+        sink += modes.getModeCount();
+    });
+    printCost("ModeManager, no mode built", manager);
+
+    double builtins = bestOf(10000, [&] {
+        EvaluationContext context;
+        MathFunctions::registerBuiltInFunctions(context);
+        sink += context.hasFunction("sin");
+    });
+    printCost("EvaluationContext with built-ins", builtins);
+
+    double firstResult = bestOf(1000, [&] {
+        ModeManager modes;
+        sink += modes.getDefaultMode()->evaluate(EXPRESSION).isSuccess();
+    });
+    printCost("first result, standard mode built on use", firstResult);
+
+    double everyMode = bestOf(1000, [&] {
+        StandardMode standard;
+        ScientificMode scientific;
+        ProgrammerMode programmer;
+        PrecisionMode precision;
+        sink += standard.evaluate(EXPRESSION).isSuccess();
+    });
+    printCost("first result, every mode built up front", everyMode);
+
+    std::cout << "\n  calc_cli \"" << EXPRESSION << "\" takes " << std::setprecision(0) << cli - floor
+              << " us more than a process that does nothing\n";
+    std::cout << "  time to first result: " << std::setprecision(2) << firstResult << " us (target "
+              << TARGET_FIRST_RESULT_US << " us) - "
+              << (firstResult <= TARGET_FIRST_RESULT_US ? "met" : "MISSED") << "\n";
+
+    std::cout << "\n========================================\n";
+    std::cout << "All startup benchmarks completed! (" << sink % 10 << ")\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file stream_benchmark.cpp
+ * @brief Lines per second through the --stdin filter versus per-line flushing
+ *
+ * Evaluates the same input once the way the REPL answers a line (mode
+ * evaluation, OutputFormatter and std::endl per result) and once through
+ * StreamRunner with its default buffering and with a flush every 1000
+ * lines. Output goes to a scratch file so the flushes reach the kernel.
+ */
+
+#include "calc/modes/scientific_mode.h"
+#include "calc/modes/shared_engine.h"
+#include "calc/ui/cli/output_formatter.h"
+#include "calc/ui/cli/stream_runner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace calc;
+using namespace calc::cli;
+
+static constexpr int REPETITIONS = 3;
+static constexpr size_t LINE_COUNT = 500000;
+static constexpr const char* OUTPUT_PATH = "stream_benchmark.out";
+
+// Best of REPETITIONS runs of work(in, out), in million lines per second
+template <typename Work>
+static double bestOf(const std::string& input, Work&& work) {
+    double best = 0.0;
+    for (int i = 0; i < REPETITIONS; ++i) {
+        std::istringstream in(input);
+        std::ofstream out(OUTPUT_PATH, std::ios::binary | std::ios::trunc);
+        auto start = std::chrono::steady_clock::now();
+        work(in, out);
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        best = std::max(best, static_cast<double>(LINE_COUNT) / seconds / 1e6);
+    }
+    return best;
+}
+
+static void printRate(const std::string& label, double rate) {
+    std::cout << "  " << std::left << std::setw(28) << label << std::right << std::fixed
+              << std::setprecision(2) << std::setw(8) << rate << " M lines/s\n";
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Stream Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << LINE_COUNT << " lines, scientific mode, best of " << REPETITIONS << " runs\n\n";
+
+    // A small set of repeated expressions, as from a log or a generator
+    std::string input;
+    for (size_t i = 0; i < LINE_COUNT; ++i) {
+        input += std::to_string(i % 50) + " * 2 + 1\n";
+    }
+
+    ScientificMode mode;
+    SharedEngine engine(mode);
+    OutputFormatter formatter(ColorMode::NEVER, false, false);
+
+    double perLine = bestOf(input, [&](std::istream& in, std::ostream& out) {
+        std::string line;
+        while (std::getline(in, line)) {
+            out << formatter.formatResult(line, mode.evaluate(line)) << std::endl;
+        }
+    });
+    double flushEvery = bestOf(input, [&](std::istream& in, std::ostream& out) {
+        StreamRunner(engine, 1000).run(in, out);
+    });
+    double buffered = bestOf(input, [&](std::istream& in, std::ostream& out) {
+        StreamRunner(engine).run(in, out);
+    });
+    std::remove(OUTPUT_PATH);
+
+    printRate("std::endl per line", perLine);
+    printRate("StreamRunner, flush 1000", flushEvery);
+    printRate("StreamRunner, buffered", buffered);
+
+    std::cout << "\n========================================\n";
+    std::cout << "All stream benchmarks completed!\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
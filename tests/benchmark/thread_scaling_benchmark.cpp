@@ -0,0 +1,159 @@
+/**
+ * @file thread_scaling_benchmark.cpp
+ * @brief Evaluations per second of one SharedEngine from 1 to N threads
+ */
+
+#include "calc/modes/scientific_mode.h"
+#include "calc/modes/shared_engine.h"
+#include "calc/benchmark/benchmark.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace calc;
+using namespace calc::benchmark;
+
+static constexpr size_t EVALUATIONS_PER_THREAD = 20000;
+
+static const std::vector<std::string> EXPRESSIONS = {
+    "1 + 2 * 3 - 4 / 5",
+    "sin(0.5) * cos(0.5) + tan(0.25)",
+    "sqrt(2) * log(10) + exp(1.5)",
+    "max(1, 2, 3) ^ 2 - min(4, 5)",
+    "(1 + 2) * (3 + 4) * (5 + 6) / 7",
+    "hypot(3, 4) + abs(-5) + floor(2.5)"
+};
+
+// Thread counts to measure: powers of two up to the core count, then the core count
+static std::vector<unsigned> threadCounts() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned n = 1; n < cores; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(cores);
+    return counts;
+}
+
+// Run work(thread index) on n threads and wait for all of them
+template <typename Work>
+static void runThreads(unsigned n, Work&& work) {
+    std::vector<std::thread> threads;
+    threads.reserve(n);
+    for (unsigned t = 0; t < n; ++t) {
+        threads.emplace_back([&work, t] { work(t); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+static void printRate(const std::string& label, unsigned threads, const BenchmarkResult& result,
+                      double singleThreadRate) {
+    double rate = static_cast<double>(threads * EVALUATIONS_PER_THREAD) * 1e9 / result.mean_ns;
+    std::cout << "  " << std::left << std::setw(18) << label << std::right << std::setw(3)
+              << threads << " threads " << std::setw(14) << std::fixed << std::setprecision(0)
+              << rate << " evals/s";
+    if (singleThreadRate > 0.0) {
+        std::cout << "  (" << std::setprecision(2) << rate / singleThreadRate << "x 1 thread)";
+    }
+    std::cout << "\n";
+}
+
+void benchmark_shared_engine() {
+    ScientificMode mode;
+    SharedEngine engine(mode);
+
+    BenchmarkConfig config;
+    config.min_iterations = 5;
+    config.warmup_iterations = 1;
+
+    std::cout << "Shared engine, one EvaluationScratch per thread\n";
+    double singleThreadRate = 0.0;
+    for (unsigned n : threadCounts()) {
+        Benchmark bench("SharedEngine", config);
+        BenchmarkResult result = bench.run([&] {
+            runThreads(n, [&](unsigned t) {
+                EvaluationScratch scratch;
+                for (size_t i = 0; i < EVALUATIONS_PER_THREAD; ++i) {
+                    (void)engine.evaluate(EXPRESSIONS[(i + t) % EXPRESSIONS.size()], scratch);
+                }
+            });
+        });
+        printRate("SharedEngine", n, result, singleThreadRate);
+        if (n == 1) {
+            singleThreadRate = static_cast<double>(EVALUATIONS_PER_THREAD) * 1e9 / result.mean_ns;
+        }
+    }
+    std::cout << "\n";
+}
+
+void benchmark_mode_per_thread() {
+    BenchmarkConfig config;
+    config.min_iterations = 5;
+    config.warmup_iterations = 1;
+
+    std::cout << "One ScientificMode per thread (built outside the timed region)\n";
+    double singleThreadRate = 0.0;
+    for (unsigned n : threadCounts()) {
+        std::vector<std::unique_ptr<ScientificMode>> modes;
+        for (unsigned t = 0; t < n; ++t) {
+            modes.push_back(std::make_unique<ScientificMode>());
+        }
+
+        Benchmark bench("ModePerThread", config);
+        BenchmarkResult result = bench.run([&] {
+            runThreads(n, [&](unsigned t) {
+                for (size_t i = 0; i < EVALUATIONS_PER_THREAD; ++i) {
+                    (void)modes[t]->evaluate(EXPRESSIONS[(i + t) % EXPRESSIONS.size()]);
+                }
+            });
+        });
+        printRate("ScientificMode", n, result, singleThreadRate);
+        if (n == 1) {
+            singleThreadRate = static_cast<double>(EVALUATIONS_PER_THREAD) * 1e9 / result.mean_ns;
+        }
+    }
+    std::cout << "\n";
+}
+
+// What a worker pays before its first evaluation
+void benchmark_worker_setup() {
+    ScientificMode mode;
+    SharedEngine engine(mode);
+
+    Benchmark b("Worker Setup");
+    b.compare("EvaluationScratch", [&] {
+        EvaluationScratch scratch;
+        (void)engine.evaluate(EXPRESSIONS[0], scratch);
+    }, "ScientificMode", [&] {
+        ScientificMode perWorker;
+        (void)perWorker.evaluate(EXPRESSIONS[0]);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    std::cout << "========================================\n";
+    std::cout << "Thread Scaling Benchmarks\n";
+    std::cout << "========================================\n";
+    std::cout << "Evaluations per thread: " << EVALUATIONS_PER_THREAD << ", hardware threads: "
+              << std::thread::hardware_concurrency() << "\n\n";
+
+    benchmark_shared_engine();
+    benchmark_mode_per_thread();
+    benchmark_worker_setup();
+
+    std::cout << "========================================\n";
+    std::cout << "All thread scaling benchmarks completed!\n";
+    std::cout << "========================================\n";
+
+    return 0;
+}
@@ -155,6 +155,25 @@ void benchmark_function_expressions() {
     }));
 }
 
+void benchmark_generated_expression() {
+    // Multi-megabyte machine-generated input, as produced by code generators
+    std::string generated;
+    for (int i = 0; generated.size() < 2 * 1024 * 1024; ++i) {
+        generated += "max(" + std::to_string(i) + ".25, x" + std::to_string(i % 10) +
+                     ") * 0x" + std::to_string(i % 100) + " + ";
+    }
+    generated += "1";
+
+    std::vector<CompactToken> buffer;
+    Benchmark b("Tokenizer - 2 MiB Generated Expression");
+    b.compare("Token", [&] {
+        Tokenizer tokenizer(generated);
+        (void)tokenizer.tokenize();
+    }, "CompactToken", [&] {
+        Tokenizer::tokenize(generated, buffer);
+    });
+}
+
 int main(int argc, char* argv[]) {
     (void)argc;
     (void)argv;
@@ -171,6 +190,7 @@ int main(int argc, char* argv[]) {
     benchmark_scientific_expressions();
     benchmark_single_long_tokenization();
     benchmark_function_expressions();
+    benchmark_generated_expression();
 
     std::cout << "========================================\n";
     std::cout << "All tokenizer benchmarks completed!\n";
@@ -26,7 +26,7 @@ TEST_F(ProgrammerModeIntegrationTest, ModeManagerRegistration) {
     EXPECT_TRUE(modeManager_->hasMode("standard"));
     EXPECT_TRUE(modeManager_->hasMode("scientific"));
     EXPECT_TRUE(modeManager_->hasMode("programmer"));
-    EXPECT_EQ(modeManager_->getModeCount(), 3);
+    EXPECT_EQ(modeManager_->getModeCount(), 4);
 }
 
 TEST_F(ProgrammerModeIntegrationTest, ProgrammerModeAvailable) {
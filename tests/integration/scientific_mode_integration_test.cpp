@@ -24,7 +24,7 @@ TEST_F(ScientificModeIntegrationTest, ModeManagerRegistration) {
     EXPECT_TRUE(modeManager_->hasMode("standard"));
     EXPECT_TRUE(modeManager_->hasMode("scientific"));
     EXPECT_TRUE(modeManager_->hasMode("programmer"));  // programmer mode added in phase 6
-    EXPECT_EQ(modeManager_->getModeCount(), 3);
+    EXPECT_EQ(modeManager_->getModeCount(), 4);
 }
 
 // Test mode name and description
@@ -0,0 +1,151 @@
+/**
+ * @file ast_arena_test.cpp
+ * @brief Unit tests for ASTArena and arena-backed parsing
+ */
+
+#include <gtest/gtest.h>
+#include "calc/core/ast_arena.h"
+#include "calc/core/evaluator.h"
+#include "calc/core/recursive_descent_parser.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <cstdint>
+
+using namespace calc;
+
+namespace {
+
+std::vector<Token> tokenize(const std::string& expr) {
+    Tokenizer tokenizer(expr);
+    return tokenizer.tokenize();
+}
+
+} // anonymous namespace
+
+TEST(ASTArenaTest, AllocationsAreAlignedAndCounted) {
+    ASTArena arena(128);
+    EXPECT_EQ(arena.getBlockCount(), 0u);
+
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 8);
+    void* c = arena.allocate(16, 16);
+
+    EXPECT_NE(a, b);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 8, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % 16, 0u);
+    EXPECT_EQ(arena.getBlockCount(), 1u);
+    EXPECT_GE(arena.getBytesUsed(), 27u);
+    EXPECT_LE(arena.getBytesUsed(), arena.getBytesReserved());
+}
+
+TEST(ASTArenaTest, GrowsWithNewBlocks) {
+    ASTArena arena(64);
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate(32, 8);
+    }
+    EXPECT_GT(arena.getBlockCount(), 1u);
+    EXPECT_GE(arena.getBytesReserved(), 3200u);
+
+    // Requests larger than a block get a block of their own
+    void* big = arena.allocate(ASTArena::MAX_BLOCK_SIZE * 2, 8);
+    EXPECT_NE(big, nullptr);
+}
+
+TEST(ASTArenaTest, ArenaNodesCanBeOwnedByUniquePtr) {
+    ASTArena arena;
+    {
+        std::unique_ptr<ASTNode> node(new (arena) BinaryOpNode(
+            std::unique_ptr<ASTNode>(new (arena) LiteralNode(1.0)),
+            OpCode::ADD, 2,
+            std::make_unique<LiteralNode>(2.0)));  // Heap and arena nodes may be mixed
+        EXPECT_EQ(node->toString(), "(1 + 2)");
+    }
+    EXPECT_GT(arena.getBytesUsed(), 0u);
+}
+
+TEST(ASTArenaTest, ArenaAllocatorFallsBackToHeap) {
+    ASTNodeList heapList;
+    heapList.push_back(std::make_unique<LiteralNode>(1.0));
+    EXPECT_EQ(heapList.get_allocator().getArena(), nullptr);
+
+    ASTArena arena;
+    ASTNodeList arenaList{ArenaAllocator<std::unique_ptr<ASTNode>>(&arena)};
+    arenaList.push_back(std::make_unique<LiteralNode>(2.0));
+    EXPECT_EQ(arenaList.get_allocator().getArena(), &arena);
+    EXPECT_GT(arena.getBytesUsed(), 0u);
+}
+
+TEST(ParsedExpressionTest, BothParsersBuildTheSameTree) {
+    const std::string expr = "-x + 2 * sin(3, y) ^ 2 - (4 % z)";
+    ShuntingYardParser shunting;
+    RecursiveDescentParser descent;
+
+    ParsedExpression fromShunting = shunting.parseToArena(tokenize(expr));
+    ParsedExpression fromDescent = descent.parseToArena(tokenize(expr));
+
+    ASSERT_TRUE(fromShunting);
+    ASSERT_TRUE(fromDescent);
+    EXPECT_EQ(fromShunting->toString(), shunting.parse(tokenize(expr))->toString());
+    EXPECT_EQ(fromDescent->toString(), descent.parse(tokenize(expr))->toString());
+    EXPECT_GT(fromShunting.getArena()->getBytesUsed(), 0u);
+    EXPECT_EQ(fromShunting.getArena()->getBlockCount(), 1u);
+}
+
+TEST(ParsedExpressionTest, EvaluatesLikeAHeapTree) {
+    EvaluationContext context;
+    MathFunctions::registerBuiltInFunctions(context);
+    ShuntingYardParser parser;
+    ParsedExpression parsed = parser.parseToArena(tokenize("sqrt(16) + 2 ^ 3 * -1"));
+
+    EvaluatorVisitor evaluator;
+    EvaluationResult result = evaluator.evaluate(parsed.get(), context);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), -4.0);
+}
+
+TEST(ParsedExpressionTest, CloneOutlivesTheArena) {
+    std::unique_ptr<ASTNode> copy;
+    {
+        RecursiveDescentParser parser;
+        ParsedExpression parsed = parser.parseToArena(tokenize("max(1, 2, 3) * 4"));
+        copy = parsed->clone();
+    }
+    EXPECT_EQ(copy->toString(), "(max(1, 2, 3) * 4)");
+}
+
+TEST(ParsedExpressionTest, MoveTransfersOwnership) {
+    ShuntingYardParser parser;
+    ParsedExpression first = parser.parseToArena(tokenize("1 + 2"));
+    ParsedExpression second = parser.parseToArena(tokenize("3 * 4"));
+
+    second = std::move(first);
+    EXPECT_EQ(second->toString(), "(1 + 2)");
+    EXPECT_NE(second.getArena(), nullptr);
+}
+
+TEST(ParsedExpressionTest, ParseErrorsPropagate) {
+    ShuntingYardParser shunting;
+    RecursiveDescentParser descent;
+    EXPECT_THROW(shunting.parseToArena(tokenize("1 + (2 * 3")), CalculatorException);
+    EXPECT_THROW(descent.parseToArena(tokenize("max(1, 2")), CalculatorException);
+
+    // The parsers still build heap trees afterwards
+    EXPECT_EQ(shunting.parse(tokenize("1 + 2"))->toString(), "(1 + 2)");
+}
+
+TEST(ParsedExpressionTest, CompactOperatorsKeepPosition) {
+    ShuntingYardParser parser;
+    ParsedExpression parsed = parser.parseToArena(tokenize("1 + -2"));
+
+    auto* binary = dynamic_cast<BinaryOpNode*>(parsed.get());
+    ASSERT_NE(binary, nullptr);
+    EXPECT_EQ(binary->getOpCode(), OpCode::ADD);
+    EXPECT_EQ(binary->getPosition(), 2u);
+    EXPECT_EQ(binary->getOperator().value, "+");
+
+    auto* unary = dynamic_cast<UnaryOpNode*>(binary->getRight());
+    ASSERT_NE(unary, nullptr);
+    EXPECT_EQ(unary->getOpCode(), OpCode::NEG);
+    EXPECT_EQ(unary->getPosition(), 4u);
+    EXPECT_EQ(unary->getOperator().value, "-");
+}
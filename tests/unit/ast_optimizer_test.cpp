@@ -0,0 +1,181 @@
+/**
+ * @file ast_optimizer_test.cpp
+ * @brief Unit tests for ASTOptimizer
+ */
+
+#include <gtest/gtest.h>
+#include "calc/core/ast_optimizer.h"
+#include "calc/core/recursive_descent_parser.h"
+#include "calc/core/tokenizer.h"
+#include <cmath>
+
+using namespace calc;
+
+namespace {
+
+std::unique_ptr<ASTNode> parse(const std::string& expr) {
+    Tokenizer tokenizer(expr);
+    auto tokens = tokenizer.tokenize();
+    RecursiveDescentParser parser;  // Also accepts empty argument lists such as PI()
+    return parser.parse(tokens);
+}
+
+} // anonymous namespace
+
+class ASTOptimizerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MathFunctions::registerBuiltInFunctions(context);
+    }
+
+    std::unique_ptr<ASTNode> optimize(const std::string& expr, OptimizerOptions options = {}) {
+        ASTOptimizer optimizer(context, options);
+        auto optimized = optimizer.optimize(*parse(expr));
+        stats = optimizer.getStats();
+        return optimized;
+    }
+
+    // The optimized tree must evaluate exactly like the original
+    void expectSameAsOriginal(const std::string& expr) {
+        auto original = parse(expr);
+        auto optimized = optimize(expr);
+        EvaluatorVisitor evaluator;
+        EvaluationResult expected = evaluator.evaluate(original.get(), context);
+        EvaluationResult actual = evaluator.evaluate(optimized.get(), context);
+
+        ASSERT_EQ(actual.isSuccess(), expected.isSuccess()) << expr;
+        if (expected.isSuccess()) {
+            EXPECT_EQ(actual.getValue(), expected.getValue()) << expr;
+        } else {
+            EXPECT_EQ(actual.getErrorCode(), expected.getErrorCode()) << expr;
+            EXPECT_EQ(actual.getErrorMessage(), expected.getErrorMessage()) << expr;
+            EXPECT_EQ(actual.getErrorPosition(), expected.getErrorPosition()) << expr;
+        }
+    }
+
+    EvaluationContext context;
+    OptimizationStats stats;
+};
+
+TEST_F(ASTOptimizerTest, CountNodes) {
+    EXPECT_EQ(ASTOptimizer::countNodes(*parse("42")), 1u);
+    EXPECT_EQ(ASTOptimizer::countNodes(*parse("-x + max(1, 2, y)")), 7u);
+}
+
+TEST_F(ASTOptimizerTest, FoldsConstantSubtrees) {
+    context.setVariable("x", 3.0);
+    auto optimized = optimize("x * (2 * PI / 360) + sqrt(16) - E");
+
+    EXPECT_EQ(stats.nodesBefore, 12u);
+    EXPECT_EQ(stats.nodesAfter, 7u);
+    EXPECT_EQ(stats.constantsFolded, 5u);
+
+    auto folded = optimize("2 ^ 10 + abs(-3)");
+    auto literal = dynamic_cast<LiteralNode*>(folded.get());
+    ASSERT_NE(literal, nullptr);
+    EXPECT_DOUBLE_EQ(literal->getValue(), 1027.0);
+}
+
+TEST_F(ASTOptimizerTest, FoldsZeroArgumentConstantCalls) {
+    auto optimized = optimize("PI() * 2");
+    auto literal = dynamic_cast<LiteralNode*>(optimized.get());
+    ASSERT_NE(literal, nullptr);
+    EXPECT_DOUBLE_EQ(literal->getValue(), 2 * M_PI);
+}
+
+TEST_F(ASTOptimizerTest, KeepsFailingConstantSubtrees) {
+    for (const char* expr : {"1 / 0 + 2", "sqrt(-1) * 3", "log(0)", "10 ^ 400", "nosuch(1)"}) {
+        expectSameAsOriginal(expr);
+    }
+    optimize("1 / (2 - 2)");
+    EXPECT_EQ(stats.constantsFolded, 1u);
+    EXPECT_EQ(stats.nodesAfter, 3u);
+}
+
+TEST_F(ASTOptimizerTest, KeepsVariablesAndImpureFunctions) {
+    context.setVariable("PI", 3.0);
+    context.addFunction("tick", [](const std::vector<double>&) { return 1.0; });
+
+    auto optimized = optimize("PI + tick()");
+    EXPECT_EQ(stats.constantsFolded, 0u);
+    EXPECT_EQ(stats.nodesAfter, 3u);
+
+    EvaluatorVisitor evaluator;
+    EXPECT_DOUBLE_EQ(evaluator.evaluate(optimized.get(), context).getValue(), 4.0);
+}
+
+TEST_F(ASTOptimizerTest, KeepsColumnNames) {
+    ASTOptimizer optimizer(context);
+    auto optimized = optimizer.optimize(*parse("E * 2"), {"E"});
+    EXPECT_EQ(optimizer.getStats().constantsFolded, 0u);
+    EXPECT_NE(dynamic_cast<BinaryOpNode*>(optimized.get()), nullptr);
+}
+
+TEST_F(ASTOptimizerTest, SquareBecomesMultiplication) {
+    context.setVariable("x", 0.0);
+    auto optimized = optimize("x ^ 2");
+    EXPECT_EQ(stats.strengthReduced, 1u);
+    auto product = dynamic_cast<BinaryOpNode*>(optimized.get());
+    ASSERT_NE(product, nullptr);
+    EXPECT_EQ(product->getOpCode(), OpCode::MUL);
+
+    // Exact, including overflow errors and their position
+    for (double x : {0.0, -1.5, 3.0000001, 1e-170, 1.7e154, 1e200, -7.25e-3, 123456.789}) {
+        context.setVariable("x", x);
+        expectSameAsOriginal("x ^ 2");
+    }
+}
+
+TEST_F(ASTOptimizerTest, XorSemanticsAreNotStrengthReduced) {
+    context.setOperatorSemantics("^", OperatorSemantics::BITWISE_XOR);
+    context.setVariable("x", 5.0);
+    optimize("x ^ 2");
+    EXPECT_EQ(stats.strengthReduced, 0u);
+    expectSameAsOriginal("x ^ 2");
+    expectSameAsOriginal("(12 ^ 10) * x");
+}
+
+TEST_F(ASTOptimizerTest, DefaultRewritesAreExact) {
+    context.setVariable("x", -0.0);
+    context.setVariable("y", std::nan(""));
+    for (const char* expr : {"x + 0", "x * 1", "y * 1", "y / 1", "x ^ 1", "+x - 0", "x / 4",
+                             "hypot(3, 4) * x + sin(PI / 2)"}) {
+        expectSameAsOriginal(expr);
+    }
+    optimize("x + 0 - 0");
+    EXPECT_EQ(stats.identitiesRemoved, 0u);
+}
+
+TEST_F(ASTOptimizerTest, FastMathRemovesIdentities) {
+    OptimizerOptions fast;
+    fast.fastMath = true;
+    context.setVariable("x", 7.0);
+
+    auto optimized = optimize("(x + 0) * 1 - 0 + 0 * 1", fast);
+    EXPECT_EQ(stats.nodesAfter, 1u);
+    EXPECT_EQ(optimized->toString(), VariableNode("x", 1).toString());
+
+    optimize("1 * (0 + x) / 1", fast);
+    EXPECT_EQ(stats.nodesAfter, 1u);
+    EXPECT_EQ(stats.identitiesRemoved, 3u);
+}
+
+TEST_F(ASTOptimizerTest, FastMathStrengthReduction) {
+    OptimizerOptions fast;
+    fast.fastMath = true;
+    context.setVariable("x", 1.1);
+
+    auto reciprocal = optimize("x / 4", fast);
+    auto product = dynamic_cast<BinaryOpNode*>(reciprocal.get());
+    ASSERT_NE(product, nullptr);
+    EXPECT_EQ(product->getOpCode(), OpCode::MUL);
+
+    auto power = optimize("x ^ 5", fast);
+    EXPECT_EQ(stats.strengthReduced, 1u);
+    EvaluatorVisitor evaluator;
+    EXPECT_NEAR(evaluator.evaluate(power.get(), context).getValue(), std::pow(1.1, 5), 1e-12);
+
+    // Zero divisors, fractional and large exponents are left alone
+    optimize("x / 0 + x ^ 2.5 + x ^ 100", fast);
+    EXPECT_EQ(stats.strengthReduced, 0u);
+}
@@ -15,6 +15,7 @@ class TestVisitor : public ASTVisitor {
 public:
     int visitCount = 0;
     bool visitedLiteral = false;
+    bool visitedVariable = false;
     bool visitedBinary = false;
     bool visitedUnary = false;
     bool visitedFunction = false;
@@ -24,6 +25,11 @@ public:
         visitCount++;
     }
 
+    void visit(VariableNode& /*node*/) override {
+        visitedVariable = true;
+        visitCount++;
+    }
+
     void visit(BinaryOpNode& /*node*/) override {
         visitedBinary = true;
         visitCount++;
@@ -42,6 +48,7 @@ public:
     void reset() {
         visitCount = 0;
         visitedLiteral = false;
+        visitedVariable = false;
         visitedBinary = false;
         visitedUnary = false;
         visitedFunction = false;
@@ -0,0 +1,216 @@
+/**
+ * @file ast_walker_test.cpp
+ * @brief Unit tests for non-recursive traversal, cloning, teardown and
+ *        evaluation of very deep trees
+ */
+
+#include <gtest/gtest.h>
+#include "calc/core/ast.h"
+#include "calc/core/ast_optimizer.h"
+#include "calc/core/compiled_expression.h"
+#include "calc/core/evaluator.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace calc;
+
+namespace {
+
+// Deep enough to overflow the stack of any recursive walk
+constexpr size_t DEEP = 100000;
+
+std::unique_ptr<ASTNode> parse(const std::string& expr) {
+    Tokenizer tokenizer(expr);
+    auto tokens = tokenizer.tokenize();
+    ShuntingYardParser parser;
+    return parser.parse(tokens);
+}
+
+// 1 + (1 + (1 + ...)): every level is the right child of the one above
+std::unique_ptr<ASTNode> rightDeepSum(size_t depth) {
+    std::unique_ptr<ASTNode> node = std::make_unique<LiteralNode>(1.0);
+    for (size_t i = 1; i < depth; ++i) {
+        node = std::make_unique<BinaryOpNode>(std::make_unique<LiteralNode>(1.0), OpCode::ADD, 0,
+                                              std::move(node));
+    }
+    return node;
+}
+
+// -(-(-(... x))) with @p depth unary operators
+std::unique_ptr<ASTNode> negationChain(size_t depth) {
+    std::unique_ptr<ASTNode> node = std::make_unique<VariableNode>("x", 0);
+    for (size_t i = 0; i < depth; ++i) {
+        node = std::make_unique<UnaryOpNode>(OpCode::NEG, 0, std::move(node));
+    }
+    return node;
+}
+
+// Records the order nodes are visited in
+class OrderVisitor : public ASTVisitor {
+public:
+    std::vector<std::string> order;
+    PostOrderWalker* walker = nullptr;
+    size_t stopAfter = 0;
+
+    void visit(LiteralNode& node) override { record(node.toString()); }
+    void visit(VariableNode& node) override { record(node.getName()); }
+    void visit(BinaryOpNode& node) override { record(opCodeSymbol(node.getOpCode())); }
+    void visit(UnaryOpNode& /*node*/) override { record("neg"); }
+    void visit(FunctionCallNode& node) override { record(node.getName()); }
+
+private:
+    void record(const std::string& name) {
+        order.push_back(name);
+        if (walker != nullptr && order.size() == stopAfter) {
+            walker->stop();
+        }
+    }
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// PostOrderWalker Tests
+// ============================================================================
+
+TEST(PostOrderWalkerTest, VisitsChildrenBeforeParents) {
+    auto ast = parse("max(a, -b) * (c + 2)");
+    OrderVisitor visitor;
+    PostOrderWalker walker;
+
+    EXPECT_TRUE(walker.walk(*ast, visitor));
+    const std::vector<std::string> expected = {"a", "b", "neg", "max", "c", "2", "+", "*"};
+    EXPECT_EQ(visitor.order, expected);
+}
+
+TEST(PostOrderWalkerTest, WalksASingleLeaf) {
+    LiteralNode leaf(3.0);
+    OrderVisitor visitor;
+    PostOrderWalker walker;
+
+    EXPECT_TRUE(walker.walk(leaf, visitor));
+    EXPECT_EQ(visitor.order.size(), 1u);
+}
+
+TEST(PostOrderWalkerTest, StopEndsTheWalk) {
+    auto ast = parse("(a + b) * (c + d)");
+    OrderVisitor visitor;
+    PostOrderWalker walker;
+    visitor.walker = &walker;
+    visitor.stopAfter = 3;
+
+    EXPECT_FALSE(walker.walk(*ast, visitor));
+    EXPECT_EQ(visitor.order.size(), 3u);
+
+    // The walker is reusable after a stop
+    visitor.walker = nullptr;
+    visitor.order.clear();
+    EXPECT_TRUE(walker.walk(*ast, visitor));
+    EXPECT_EQ(visitor.order.size(), 7u);
+}
+
+TEST(PostOrderWalkerTest, ChildAccessors) {
+    auto ast = parse("max(1, 2, 3) + -x");
+    ASSERT_EQ(ast->getChildCount(), 2u);
+    EXPECT_EQ(ast->getChild(0)->getChildCount(), 3u);
+    EXPECT_EQ(ast->getChild(1)->getChildCount(), 1u);
+    EXPECT_EQ(ast->getChild(0)->getChild(0)->getChildCount(), 0u);
+}
+
+// ============================================================================
+// Deep Tree Tests
+// ============================================================================
+
+TEST(DeepTreeTest, CloneAndDestroyDeepTrees) {
+    auto sum = rightDeepSum(DEEP);
+    auto sumCopy = sum->clone();
+    sum.reset();
+
+    auto negations = negationChain(DEEP);
+    auto negationsCopy = negations->clone();
+    negations.reset();
+
+    EvaluationContext context;
+    context.setVariable("x", 2.0);
+    EvaluatorVisitor evaluator;
+    EXPECT_DOUBLE_EQ(evaluator.evaluate(sumCopy.get(), context).getValue(), static_cast<double>(DEEP));
+    EXPECT_DOUBLE_EQ(evaluator.evaluate(negationsCopy.get(), context).getValue(), 2.0);
+}
+
+TEST(DeepTreeTest, CloneKeepsTheShape) {
+    auto ast = parse("max(1, -x ^ 2, y) / (3 - z)");
+    auto copy = ast->clone();
+    EXPECT_EQ(copy->toString(), ast->toString());
+}
+
+TEST(DeepTreeTest, EvaluateMillionTermChain) {
+    std::string expr = "1";
+    for (int i = 1; i < 1000000; ++i) {
+        expr += "+1";
+    }
+    auto ast = parse(expr);
+
+    EvaluationContext context;
+    EvaluatorVisitor evaluator;
+    EvaluationResult result = evaluator.evaluate(ast.get(), context);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 1000000.0);
+}
+
+TEST(DeepTreeTest, ParseAndEvaluateDeepNesting) {
+    std::string expr;
+    for (size_t i = 1; i < DEEP; ++i) {
+        expr += "1+(";
+    }
+    expr += "1" + std::string(DEEP - 1, ')');
+    auto ast = parse(expr);
+
+    EvaluationContext context;
+    EvaluatorVisitor evaluator;
+    EvaluationResult result = evaluator.evaluate(ast.get(), context);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), static_cast<double>(DEEP));
+}
+
+TEST(DeepTreeTest, ErrorsDeepInTheTree) {
+    auto ast = std::make_unique<BinaryOpNode>(negationChain(DEEP), OpCode::DIV, 7,
+                                              std::make_unique<LiteralNode>(0.0));
+    EvaluationContext context;
+    EvaluatorVisitor evaluator;
+
+    EvaluationResult undefined = evaluator.evaluate(ast.get(), context);
+    EXPECT_EQ(undefined.getErrorCode(), ErrorCode::UNDEFINED_VARIABLE);
+
+    context.setVariable("x", 1.0);
+    EvaluationResult divided = evaluator.evaluate(ast.get(), context);
+    EXPECT_EQ(divided.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+    EXPECT_EQ(divided.getErrorPosition(), 7u);
+}
+
+TEST(DeepTreeTest, CompileDeepTree) {
+    auto ast = negationChain(DEEP);
+    EvaluationContext context;
+    context.setVariable("x", 3.0);
+
+    CompiledExpression program = CompiledExpression::compile(*ast, context);
+    VirtualMachine vm;
+    EvaluationResult result = vm.execute(program);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 3.0);
+}
+
+TEST(DeepTreeTest, OptimizeDeepTree) {
+    EvaluationContext context;
+    ASTOptimizer optimizer(context);
+
+    auto folded = optimizer.optimize(*rightDeepSum(DEEP));
+    auto* literal = dynamic_cast<LiteralNode*>(folded.get());
+    ASSERT_NE(literal, nullptr);
+    EXPECT_DOUBLE_EQ(literal->getValue(), static_cast<double>(DEEP));
+
+    auto kept = optimizer.optimize(*negationChain(DEEP));
+    EXPECT_EQ(optimizer.getStats().nodesAfter, DEEP + 1);
+}
@@ -0,0 +1,249 @@
+/**
+ * @file batch_runner_test.cpp
+ * @brief Unit tests for BatchRunner
+ */
+
+#include "calc/ui/cli/batch_runner.h"
+#include "calc/modes/precision_mode.h"
+#include "calc/modes/programmer_mode.h"
+#include "calc/modes/scientific_mode.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace calc;
+using namespace calc::cli;
+
+class BatchRunnerTest : public ::testing::Test {
+protected:
+    ScientificMode mode;
+
+    std::vector<std::string> splitLines(const std::string& text) {
+        std::vector<std::string> lines;
+        std::istringstream in(text);
+        std::string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+};
+
+TEST_F(BatchRunnerTest, OneResultPerLine) {
+    SharedEngine engine(mode);
+    BatchRunner runner(engine, 1);
+    std::istringstream in("1 + 2\nsqrt(16)\n10 / 4\n");
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+
+    EXPECT_EQ(out.str(), "3\n4\n2.5\n");
+    EXPECT_EQ(stats.lines, 3u);
+    EXPECT_EQ(stats.evaluated, 3u);
+    EXPECT_EQ(stats.failed, 0u);
+}
+
+TEST_F(BatchRunnerTest, ErrorsDoNotStopTheRun) {
+    SharedEngine engine(mode);
+    BatchRunner runner(engine, 2);
+    std::istringstream in("1 / 0\n2 * 3\n(1 + 2\nunknown(1)\n7\n");
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+    std::vector<std::string> lines = splitLines(out.str());
+
+    ASSERT_EQ(lines.size(), 5u);
+    EXPECT_EQ(lines[0].rfind("Error: ", 0), 0u);
+    EXPECT_EQ(lines[1], "6");
+    EXPECT_EQ(lines[2].rfind("Error: ", 0), 0u);
+    EXPECT_EQ(lines[3].rfind("Error: ", 0), 0u);
+    EXPECT_EQ(lines[4], "7");
+    EXPECT_EQ(stats.failed, 3u);
+}
+
+TEST_F(BatchRunnerTest, BlankLinesKeepTheirPlace) {
+    SharedEngine engine(mode);
+    BatchRunner runner(engine, 1);
+    std::istringstream in("1\n\n   \r\n2\r\n3");  // No newline after the last line
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+
+    EXPECT_EQ(out.str(), "1\n\n\n2\n3\n");
+    EXPECT_EQ(stats.lines, 5u);
+    EXPECT_EQ(stats.evaluated, 3u);
+}
+
+TEST_F(BatchRunnerTest, EmptyInput) {
+    SharedEngine engine(mode);
+    BatchRunner runner(engine);
+    std::istringstream in("");
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_EQ(stats.lines, 0u);
+    EXPECT_GE(runner.getWorkerCount(), 1u);
+}
+
+TEST_F(BatchRunnerTest, UsesTheModePrecision) {
+    mode.getContext().setPrecision(2);
+    SharedEngine engine(mode);
+    BatchRunner runner(engine, 1);
+    std::istringstream in("1 / 3\n");
+    std::ostringstream out;
+
+    (void)runner.run(in, out);
+
+    EXPECT_EQ(out.str(), "0.33\n");
+}
+
+TEST_F(BatchRunnerTest, ProgrammerModeMatchesSingleExpressions) {
+    ProgrammerMode programmer;
+    SharedEngine engine(programmer);
+    ASSERT_TRUE(engine.isInteger());
+    BatchRunner runner(engine, 2);
+    std::istringstream in("7 / 2\n0x20000000000001\n0xFF ^ 0x0F\n\n1 +\n");
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+    std::vector<std::string> lines = splitLines(out.str());
+
+    ASSERT_EQ(lines.size(), 5u);
+    EXPECT_EQ(lines[0], programmer.formatResult(programmer.evaluateInteger("7 / 2")));
+    EXPECT_EQ(lines[0], "3");
+    EXPECT_EQ(lines[1], "9007199254740993");
+    EXPECT_EQ(lines[2], "240");
+    EXPECT_EQ(lines[3], "");
+    EXPECT_EQ(lines[4].rfind("Error: ", 0), 0u);
+    EXPECT_EQ(stats.failed, 1u);
+
+    // The display base and word size are snapshotted with the context
+    programmer.setDisplayBase(16);
+    programmer.setWordSize(WordSize::BITS_8);
+    SharedEngine hex(programmer);
+    BatchRunner hexRunner(hex, 1);
+    std::istringstream hexIn("0 - 1\n");
+    std::ostringstream hexOut;
+    (void)hexRunner.run(hexIn, hexOut);
+    EXPECT_EQ(hexOut.str(), programmer.formatResult(programmer.evaluateInteger("0 - 1")) + "\n");
+}
+
+TEST_F(BatchRunnerTest, ProgrammerRecordsCarryTheExactWord) {
+    ProgrammerMode programmer;
+    programmer.setDisplayBase(16);
+    SharedEngine engine(programmer);
+    const std::string input = "0x20000000000001\n0 - 0x20000000000001\n";
+
+    BatchRunner jsonl(engine, 2);
+    jsonl.setFormat(ResultFormat::JSONL);
+    std::istringstream jsonlIn(input);
+    std::ostringstream jsonlOut;
+    (void)jsonl.run(jsonlIn, jsonlOut);
+    EXPECT_EQ(jsonlOut.str(),
+              "{\"expression\":\"0x20000000000001\",\"value\":9007199254740993}\n"
+              "{\"expression\":\"0 - 0x20000000000001\",\"value\":-9007199254740993}\n");
+
+    BatchRunner csv(engine, 1);
+    csv.setFormat(ResultFormat::CSV);
+    std::istringstream csvIn(input);
+    std::ostringstream csvOut;
+    (void)csv.run(csvIn, csvOut);
+    EXPECT_EQ(csvOut.str(),
+              "expression,value,error,message,position\n"
+              "0x20000000000001,9007199254740993,,,\n"
+              "0 - 0x20000000000001,-9007199254740993,,,\n");
+}
+
+TEST_F(BatchRunnerTest, PrecisionModeMatchesSingleExpressions) {
+    PrecisionMode precision(25);
+    SharedEngine engine(precision);
+    BatchRunner runner(engine, 2);
+    std::istringstream in("0.1 + 0.2\n1 / 3\n\n1 +\n");
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+    std::vector<std::string> lines = splitLines(out.str());
+
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[0], "0.3");
+    EXPECT_EQ(lines[1], precision.formatResult(precision.evaluatePrecise("1 / 3")));
+    EXPECT_EQ(lines[2], "");
+    EXPECT_EQ(lines[3].rfind("Error: ", 0), 0u);
+    EXPECT_EQ(stats.failed, 1u);
+}
+
+TEST_F(BatchRunnerTest, ManyWorkersKeepInputOrder) {
+    std::string input;
+    std::string expected;
+    for (int i = 0; i < 5000; ++i) {
+        const std::string n = std::to_string(i);
+        if (i % 7 == 0) {
+            input += n + " / (" + n + " - " + n + ")\n";
+            expected += "Error: Division by zero\n";
+        } else {
+            input += n + " * 2 + max(" + n + ", 1)\n";
+            expected += std::to_string(i * 3) + "\n";
+        }
+    }
+
+    // Small chunks exercise reading the next chunk while evaluating this one
+    SharedEngine engine(mode, 64);
+    BatchRunner runner(engine, 4, 300);
+    std::istringstream in(input);
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+
+    EXPECT_EQ(stats.lines, 5000u);
+    EXPECT_EQ(stats.failed, 715u);
+    std::vector<std::string> actual = splitLines(out.str());
+    std::vector<std::string> want = splitLines(expected);
+    ASSERT_EQ(actual.size(), want.size());
+    for (size_t i = 0; i < want.size(); ++i) {
+        if (want[i].rfind("Error: ", 0) == 0) {
+            EXPECT_EQ(actual[i].rfind("Error: ", 0), 0u) << "line " << i;
+        } else {
+            EXPECT_EQ(actual[i], want[i]) << "line " << i;
+        }
+    }
+}
+
+TEST_F(BatchRunnerTest, ManyChunksPerWorker) {
+    // Far more chunks than slots, so reading waits for chunks to be written
+    std::string input;
+    std::string expected;
+    for (int i = 0; i < 2000; ++i) {
+        input += std::to_string(i) + " + 1\n";
+        expected += std::to_string(i + 1) + "\n";
+    }
+
+    SharedEngine engine(mode);
+    BatchRunner runner(engine, 3, 7);
+    for (int run = 0; run < 2; ++run) {
+        std::istringstream in(input);
+        std::ostringstream out;
+        BatchStats stats = runner.run(in, out);
+        EXPECT_EQ(out.str(), expected) << "run " << run;
+        EXPECT_EQ(stats.lines, 2000u);
+        EXPECT_EQ(stats.evaluated, 2000u);
+        EXPECT_EQ(stats.failed, 0u);
+    }
+}
+
+TEST_F(BatchRunnerTest, StatsToString) {
+    BatchStats stats;
+    stats.lines = 10;
+    stats.evaluated = 8;
+    stats.failed = 1;
+    stats.seconds = 0.5;
+    stats.workers = 2;
+
+    std::string text = stats.toString();
+    EXPECT_NE(text.find("10 lines"), std::string::npos);
+    EXPECT_NE(text.find("1 failed"), std::string::npos);
+    EXPECT_NE(text.find("16 expr/s"), std::string::npos);
+    EXPECT_NE(text.find("2 workers"), std::string::npos);
+}
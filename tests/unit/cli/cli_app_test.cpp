@@ -6,7 +6,14 @@
 #include "calc/ui/cli/cli_app.h"
 #include "calc/modes/mode_manager.h"
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
 #include <sstream>
+#include <string>
+#include <unistd.h>
 #include <vector>
 
 using namespace std;
@@ -102,6 +109,11 @@ TEST_F(CliAppTest, IsREPLCommand_Export_ReturnsTrue) {
     EXPECT_TRUE(CliApp::isREPLCommand("export"));
 }
 
+TEST_F(CliAppTest, IsREPLCommand_Cache_ReturnsTrue) {
+    EXPECT_TRUE(CliApp::isREPLCommand("cache"));
+    EXPECT_TRUE(CliApp::isREPLCommand("cache clear"));
+}
+
 TEST_F(CliAppTest, IsREPLCommand_ColonPrefix_ReturnsTrue) {
     EXPECT_TRUE(CliApp::isREPLCommand(":"));
     EXPECT_TRUE(CliApp::isREPLCommand(":command"));
@@ -213,3 +225,143 @@ TEST_F(CliAppTest, CommandLineOptions_SetInteractive) {
 
     EXPECT_TRUE(options.interactive);
 }
+
+// Run the CLI with @p args and return what it printed to stdout
+static std::string runCli(std::vector<std::string> args, int& exitCode) {
+    std::vector<char*> argv;
+    std::string program = "calc_cli";
+    argv.push_back(program.data());
+    for (auto& arg : args) {
+        argv.push_back(arg.data());
+    }
+
+    std::ostringstream captured;
+    std::streambuf* previous = std::cout.rdbuf(captured.rdbuf());
+    CliApp app(static_cast<int>(argv.size()), argv.data());
+    exitCode = app.run();
+    std::cout.rdbuf(previous);
+    return captured.str();
+}
+
+// Run the CLI over @p input, with --output to a file, and return the file.
+// Batch and stream runs unsync the standard streams, which rebinds std::cin
+// to descriptor 0, so the input goes there rather than into std::cin.
+static std::string runCliOver(std::vector<std::string> args, const std::string& input, int& exitCode) {
+    const std::string inputPath = ::testing::TempDir() + "cli_app_test_input.txt";
+    const std::string outputPath = ::testing::TempDir() + "cli_app_test_output.txt";
+    {
+        std::ofstream file(inputPath, std::ios::binary | std::ios::trunc);
+        file << input;
+    }
+    for (auto& arg : args) {
+        if (arg == "@input") {
+            arg = inputPath;
+        }
+    }
+    args.push_back("--output");
+    args.push_back(outputPath);
+
+    const int savedStdin = ::dup(STDIN_FILENO);
+    const int fed = ::open(inputPath.c_str(), O_RDONLY);
+    ::dup2(fed, STDIN_FILENO);
+    ::close(fed);
+    std::cin.clear();
+    (void)runCli(args, exitCode);
+    ::dup2(savedStdin, STDIN_FILENO);
+    ::close(savedStdin);
+    std::cin.clear();
+
+    std::ifstream file(outputPath, std::ios::binary);
+    std::string output((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::remove(inputPath.c_str());
+    std::remove(outputPath.c_str());
+    return output;
+}
+
+TEST_F(CliAppTest, ProgrammerModePrintsWordsAbove2To53Exactly) {
+    int exitCode = -1;
+    std::string out = runCli({"--no-color", "-m", "programmer", "0x20000000000001"}, exitCode);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(out.find("Result: 9007199254740993\n"), std::string::npos) << out;
+
+    out = runCli({"--no-color", "-m", "programmer", "9223372036854775807"}, exitCode);
+    EXPECT_NE(out.find("Result: 9223372036854775807\n"), std::string::npos) << out;
+
+    out = runCli({"--no-color", "-m", "programmer", "9007199254740993 - 1"}, exitCode);
+    EXPECT_NE(out.find("Result: 9007199254740992\n"), std::string::npos) << out;
+
+    out = runCli({"--no-color", "-m", "programmer", "7 / 2"}, exitCode);
+    EXPECT_NE(out.find("Result: 3\n"), std::string::npos) << out;
+}
+
+TEST_F(CliAppTest, BitsSelectsWideProgrammerWords) {
+    int exitCode = -1;
+    std::string out = runCli({"--no-color", "-m", "programmer", "--bits", "128", "0xFFFFFFFFFFFFFFFF << 64"},
+                             exitCode);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(out.find("Result: -18446744073709551616\n"), std::string::npos) << out;
+
+    out = runCli({"--no-color", "-m", "programmer", "--bits", "0", "1 << 200"}, exitCode);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(out.find("Result: 1606938044258990275541962092341162602522202993782792835301376\n"),
+              std::string::npos) << out;
+
+    // Past the double range
+    out = runCli({"--no-color", "-m", "programmer", "--bits", "4096", "(1 << 4095) >> 4093"}, exitCode);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(out.find("Result: -4\n"), std::string::npos) << out;
+    out = runCli({"--no-color", "-m", "programmer", "--bits", "4096", "0 - (1 << 4000)"}, exitCode);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_NE(out.find("Result: -1318"), std::string::npos) << out;
+
+    out = runCli({"--no-color", "-m", "programmer", "--bits", "128", "1 +"}, exitCode);
+    EXPECT_EQ(exitCode, 1);
+    EXPECT_EQ(out.find("Result:"), std::string::npos) << out;
+
+    (void)runCli({"-m", "standard", "--bits", "128", "1"}, exitCode);
+    EXPECT_EQ(exitCode, 1);
+    (void)runCli({"-m", "programmer", "--bits", "128", "--stdin"}, exitCode);
+    EXPECT_EQ(exitCode, 1);
+}
+
+TEST_F(CliAppTest, ProgrammerModeReportsParseErrors) {
+    int exitCode = -1;
+    std::string out = runCli({"--no-color", "-m", "programmer", "1 +"}, exitCode);
+    EXPECT_EQ(exitCode, 1);
+    EXPECT_EQ(out.find("Result:"), std::string::npos) << out;
+}
+
+TEST_F(CliAppTest, PrecisionModeIsExactOverStdinAndBatch) {
+    const std::string input = "0.1+0.2\n1/3\n";
+    const std::string expected = "0.3\n0.33333333333333333333\n";
+    int exitCode = -1;
+
+    EXPECT_EQ(runCliOver({"-m", "precision", "-p", "20", "--stdin"}, input, exitCode), expected);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_EQ(runCliOver({"-m", "precision", "-p", "20", "--batch", "-"}, input, exitCode), expected);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_EQ(runCliOver({"-m", "precision", "-p", "20", "--batch", "@input"}, input, exitCode), expected);
+    EXPECT_EQ(exitCode, 0);
+
+    // The same digits as a single expression
+    std::string out = runCli({"--no-color", "-m", "precision", "0.1+0.2"}, exitCode);
+    EXPECT_NE(out.find("Result: 0.3\n"), std::string::npos) << out;
+}
+
+TEST_F(CliAppTest, ProgrammerRecordsCarryTheExactWord) {
+    const std::string record = "{\"expression\":\"0x20000000000001\",\"value\":9007199254740993}\n";
+    int exitCode = -1;
+
+    EXPECT_EQ(runCli({"-m", "programmer", "--format=jsonl", "0x20000000000001"}, exitCode), record);
+    EXPECT_EQ(exitCode, 0);
+    EXPECT_EQ(runCliOver({"-m", "programmer", "--format=jsonl", "--stdin"}, "0x20000000000001\n", exitCode),
+              record);
+    EXPECT_EQ(runCliOver({"-m", "programmer", "--format=jsonl", "--batch", "-"}, "0x20000000000001\n", exitCode),
+              record);
+    EXPECT_EQ(runCliOver({"-m", "programmer", "--format=jsonl", "--batch", "@input"}, "0x20000000000001\n",
+                         exitCode),
+              record);
+
+    std::string out = runCli({"-m", "programmer", "--bits", "128", "--format=csv", "1 << 100"}, exitCode);
+    EXPECT_EQ(out, "expression,value,error,message,position\n1 << 100,1267650600228229401496703205376,,,\n");
+}
@@ -123,6 +123,39 @@ TEST_F(CommandParserTest, LongRecursive_SetsRecursive) {
     EXPECT_TRUE(options.useRecursiveDescent);
 }
 
+TEST_F(CommandParserTest, ParserOption_DefaultsToShuntingYard) {
+    auto options = parse({"1 + 2"});
+
+    EXPECT_EQ(options.parser, "shunting-yard");
+}
+
+TEST_F(CommandParserTest, ParserOption_Pratt) {
+    auto options = parse({"--parser", "pratt"});
+
+    EXPECT_EQ(options.parser, "pratt");
+    EXPECT_FALSE(options.useRecursiveDescent);
+    EXPECT_FALSE(options.showHelp);
+}
+
+TEST_F(CommandParserTest, ParserOption_RecursiveSetsRecursive) {
+    auto options = parse({"--parser", "recursive"});
+
+    EXPECT_EQ(options.parser, "recursive-descent");
+    EXPECT_TRUE(options.useRecursiveDescent);
+}
+
+TEST_F(CommandParserTest, ParserOption_InvalidSetsShowHelp) {
+    auto options = parse({"--parser", "lalr"});
+
+    EXPECT_TRUE(options.showHelp);
+}
+
+TEST_F(CommandParserTest, ParserOption_MissingArgumentSetsShowHelp) {
+    auto options = parse({"--parser"});
+
+    EXPECT_TRUE(options.showHelp);
+}
+
 // Interactive option
 TEST_F(CommandParserTest, ShortInteractive_SetsInteractive) {
     auto options = parse({"-i"});
@@ -136,6 +169,109 @@ TEST_F(CommandParserTest, LongInteractive_SetsInteractive) {
     EXPECT_TRUE(options.interactive);
 }
 
+// Batch options
+TEST_F(CommandParserTest, Batch_SetsInputAndJobs) {
+    auto options = parse({"--batch", "input.txt", "-j", "4"});
+
+    ASSERT_TRUE(options.batchInput.has_value());
+    EXPECT_EQ(options.batchInput.value(), "input.txt");
+    EXPECT_EQ(options.jobs, 4u);
+    EXPECT_FALSE(options.expression.has_value());
+}
+
+TEST_F(CommandParserTest, Batch_AcceptsStdin) {
+    auto options = parse({"--batch", "-"});
+
+    ASSERT_TRUE(options.batchInput.has_value());
+    EXPECT_EQ(options.batchInput.value(), "-");
+    EXPECT_EQ(options.jobs, 0u);
+}
+
+TEST_F(CommandParserTest, Batch_MissingArgument_SetsShowHelp) {
+    EXPECT_TRUE(parse({"--batch"}).showHelp);
+    EXPECT_TRUE(parse({"--jobs", "many"}).showHelp);
+}
+
+TEST_F(CommandParserTest, Bits_SetsBigWordSize) {
+    EXPECT_FALSE(parse({}).bigWordBits.has_value());
+    auto options = parse({"--bits", "256"});
+    ASSERT_TRUE(options.bigWordBits.has_value());
+    EXPECT_EQ(options.bigWordBits.value(), 256u);
+    EXPECT_TRUE(parse({"--bits"}).showHelp);
+    EXPECT_TRUE(parse({"--bits", "wide"}).showHelp);
+}
+
+TEST_F(CommandParserTest, Output_SetsOutputPath) {
+    auto options = parse({"--batch", "input.txt", "-o", "results.txt"});
+
+    ASSERT_TRUE(options.outputPath.has_value());
+    EXPECT_EQ(options.outputPath.value(), "results.txt");
+    EXPECT_EQ(parse({"--stdin", "--output", "out.txt"}).outputPath.value(), "out.txt");
+    EXPECT_TRUE(parse({"--output"}).showHelp);
+}
+
+// Daemon
+TEST_F(CommandParserTest, Serve_SetsSocketPath) {
+    auto options = parse({"-m", "scientific", "--serve", "/tmp/calc.sock"});
+
+    ASSERT_TRUE(options.servePath.has_value());
+    EXPECT_EQ(options.servePath.value(), "/tmp/calc.sock");
+    EXPECT_EQ(options.mode, "scientific");
+    EXPECT_FALSE(options.connectPath.has_value());
+    EXPECT_TRUE(parse({"--serve"}).showHelp);
+}
+
+TEST_F(CommandParserTest, Connect_SetsSocketPath) {
+    auto options = parse({"--connect", "/tmp/calc.sock", "2 + 2"});
+
+    ASSERT_TRUE(options.connectPath.has_value());
+    EXPECT_EQ(options.connectPath.value(), "/tmp/calc.sock");
+    EXPECT_EQ(options.expression.value(), "2 + 2");
+    EXPECT_TRUE(parse({"--connect", "/tmp/calc.sock", "--stdin"}).streamInput);
+    EXPECT_TRUE(parse({"--connect"}).showHelp);
+}
+
+// Result formats
+TEST_F(CommandParserTest, Format_DefaultsToText) {
+    EXPECT_EQ(parse({"1+1"}).format, ResultFormat::TEXT);
+}
+
+TEST_F(CommandParserTest, Format_AcceptsEveryName) {
+    EXPECT_EQ(parse({"--format=jsonl"}).format, ResultFormat::JSONL);
+    EXPECT_EQ(parse({"--format=csv"}).format, ResultFormat::CSV);
+    EXPECT_EQ(parse({"--format", "tsv"}).format, ResultFormat::TSV);
+    EXPECT_EQ(parse({"--format", "binary"}).format, ResultFormat::BINARY);
+    EXPECT_EQ(parse({"--format=csv", "--format=text"}).format, ResultFormat::TEXT);
+}
+
+TEST_F(CommandParserTest, Format_Invalid_SetsShowHelp) {
+    EXPECT_TRUE(parse({"--format=xml"}).showHelp);
+    EXPECT_TRUE(parse({"--format"}).showHelp);
+}
+
+// Streaming options
+TEST_F(CommandParserTest, Stdin_SetsStreamInputAndFlushInterval) {
+    auto options = parse({"--stdin", "--flush-every", "100"});
+
+    EXPECT_TRUE(options.streamInput);
+    EXPECT_EQ(options.flushEvery, 100u);
+    EXPECT_FALSE(options.expression.has_value());
+    EXPECT_FALSE(options.showHelp);
+}
+
+TEST_F(CommandParserTest, Stdin_DefaultsToFlushingWhenFull) {
+    auto options = parse({"--stdin"});
+
+    EXPECT_TRUE(options.streamInput);
+    EXPECT_EQ(options.flushEvery, 0u);
+}
+
+TEST_F(CommandParserTest, FlushEvery_InvalidArgument_SetsShowHelp) {
+    EXPECT_TRUE(parse({"--flush-every"}).showHelp);
+    EXPECT_TRUE(parse({"--flush-every", "often"}).showHelp);
+    EXPECT_TRUE(parse({"--flush-every", "0"}).showHelp);
+}
+
 // Expression parsing
 TEST_F(CommandParserTest, SingleExpression_SetsExpression) {
     auto options = parse({"2+2"});
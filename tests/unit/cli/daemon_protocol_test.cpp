@@ -0,0 +1,131 @@
+/**
+ * @file daemon_protocol_test.cpp
+ * @brief Unit tests for the daemon request/response encoding
+ */
+
+#include "calc/ui/cli/daemon_protocol.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace calc;
+using namespace calc::cli;
+
+namespace {
+
+// The body of the single frame in @p frame
+std::string_view bodyOf(const std::string& frame) {
+    std::optional<size_t> length = DaemonProtocol::frameLength(frame);
+    EXPECT_TRUE(length.has_value());
+    EXPECT_EQ(*length + DaemonProtocol::HEADER_BYTES, frame.size());
+    return std::string_view(frame).substr(DaemonProtocol::HEADER_BYTES);
+}
+
+} // anonymous namespace
+
+TEST(DaemonProtocolTest, RequestRoundTrips) {
+    DaemonRequest request;
+    request.mode = "scientific";
+    request.precision = 12;
+    request.expressions = {"sin(1)", "", std::string("a\0b", 3)};
+
+    std::string frame;
+    DaemonProtocol::appendRequest(frame, request);
+    DaemonRequest decoded = DaemonProtocol::parseRequest(bodyOf(frame));
+
+    EXPECT_EQ(decoded.mode, "scientific");
+    EXPECT_EQ(decoded.precision, 12);
+    EXPECT_EQ(decoded.expressions, request.expressions);
+
+    request.mode.clear();
+    request.precision = -1;
+    frame.clear();
+    DaemonProtocol::appendRequest(frame, request);
+    decoded = DaemonProtocol::parseRequest(bodyOf(frame));
+    EXPECT_EQ(decoded.mode, "");
+    EXPECT_EQ(decoded.precision, -1);
+}
+
+TEST(DaemonProtocolTest, ResponseRoundTrips) {
+    DaemonResponse response;
+    response.results.push_back(DaemonResult::fromEvaluation(EvaluationResult(0.1), "0.100000"));
+    response.results.push_back(DaemonResult::fromEvaluation(
+        EvaluationResult(ErrorCode::DIVISION_BY_ZERO, "Division by zero", 2), "ignored"));
+    response.results.push_back(DaemonResult::fromEvaluation(EvaluationResult(-INFINITY), "-inf"));
+
+    std::string frame;
+    DaemonProtocol::appendResponse(frame, response);
+    DaemonResponse decoded = DaemonProtocol::parseResponse(bodyOf(frame));
+
+    ASSERT_TRUE(decoded.error.empty());
+    ASSERT_EQ(decoded.results.size(), 3u);
+    EXPECT_TRUE(decoded.results[0].isSuccess());
+    EXPECT_EQ(decoded.results[0].value, 0.1);
+    EXPECT_EQ(decoded.results[0].text, "0.100000");
+
+    EvaluationResult error = decoded.results[1].toEvaluationResult();
+    ASSERT_TRUE(error.isError());
+    EXPECT_EQ(error.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+    EXPECT_EQ(error.getErrorMessage(), "Division by zero");
+    EXPECT_EQ(error.getErrorPosition(), 2u);
+
+    EXPECT_EQ(decoded.results[2].toEvaluationResult().getValue(), -INFINITY);
+}
+
+TEST(DaemonProtocolTest, ErrorResponseRoundTrips) {
+    DaemonResponse response;
+    response.error = "Unknown mode 'x'";
+    response.results.resize(2);  // Not sent with an error
+
+    std::string frame;
+    DaemonProtocol::appendResponse(frame, response);
+    DaemonResponse decoded = DaemonProtocol::parseResponse(bodyOf(frame));
+
+    EXPECT_EQ(decoded.error, "Unknown mode 'x'");
+    EXPECT_TRUE(decoded.results.empty());
+}
+
+TEST(DaemonProtocolTest, FramesAreLittleEndianLengthPrefixed) {
+    DaemonRequest request;
+    request.expressions = {"1+1"};
+    std::string frame;
+    DaemonProtocol::appendRequest(frame, request);
+
+    // Version, empty mode, precision, count, one 3-byte expression
+    const size_t body = 1 + 4 + 4 + 4 + 4 + 3;
+    ASSERT_EQ(frame.size(), DaemonProtocol::HEADER_BYTES + body);
+    EXPECT_EQ(static_cast<unsigned char>(frame[0]), body);
+    EXPECT_EQ(frame.substr(1, 3), std::string(3, '\0'));
+    EXPECT_EQ(static_cast<unsigned char>(frame[4]), DaemonProtocol::PROTOCOL_VERSION);
+
+    // Pipelined frames are found one after another
+    DaemonProtocol::appendRequest(frame, request);
+    EXPECT_EQ(DaemonProtocol::frameLength(frame), body);
+    EXPECT_EQ(DaemonProtocol::frameLength(std::string_view(frame).substr(0, 3)), std::nullopt);
+}
+
+TEST(DaemonProtocolTest, MalformedMessagesThrow) {
+    DaemonRequest request;
+    request.mode = "standard";
+    request.expressions = {"1 + 2"};
+    std::string frame;
+    DaemonProtocol::appendRequest(frame, request);
+    std::string body(bodyOf(frame));
+
+    for (size_t length = 0; length < body.size(); ++length) {
+        EXPECT_THROW(DaemonProtocol::parseRequest(body.substr(0, length)), std::runtime_error) << length;
+    }
+    EXPECT_THROW(DaemonProtocol::parseRequest(body + "x"), std::runtime_error);
+
+    std::string version = body;
+    version[0] = 2;
+    EXPECT_THROW(DaemonProtocol::parseRequest(version), std::runtime_error);
+
+    // A count the body cannot hold is rejected before allocating
+    std::string count = body.substr(0, 1 + 4 + 8 + 4) + std::string("\xff\xff\xff\x7f");
+    EXPECT_THROW(DaemonProtocol::parseRequest(count), std::runtime_error);
+
+    EXPECT_THROW(DaemonProtocol::parseResponse(std::string(1, '\x07')), std::runtime_error);
+    EXPECT_THROW(DaemonProtocol::frameLength(std::string("\xff\xff\xff\xff", 4)), std::runtime_error);
+}
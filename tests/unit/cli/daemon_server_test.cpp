@@ -0,0 +1,238 @@
+/**
+ * @file daemon_server_test.cpp
+ * @brief Unit tests for DaemonServer and DaemonClient
+ */
+
+#include "calc/ui/cli/daemon_client.h"
+#include "calc/ui/cli/daemon_server.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace calc;
+using namespace calc::cli;
+
+#ifdef __linux__
+
+class DaemonServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "calc_daemon_test_" + std::to_string(::getpid()) + ".sock";
+        server = std::make_unique<DaemonServer>(modes, "scientific", 2);
+        server->listen(path);
+        serving = std::thread([this] { server->run(); });
+    }
+
+    void TearDown() override {
+        server->stop();
+        serving.join();
+        server.reset();
+    }
+
+    DaemonRequest request(std::vector<std::string> expressions, std::string mode = "", int precision = -1) {
+        DaemonRequest result;
+        result.mode = std::move(mode);
+        result.precision = precision;
+        result.expressions = std::move(expressions);
+        return result;
+    }
+
+    ModeManager modes;
+    std::string path;
+    std::unique_ptr<DaemonServer> server;
+    std::thread serving;
+};
+
+TEST_F(DaemonServerTest, EvaluatesInTheRequestedMode) {
+    DaemonClient client = DaemonClient::connect(path);
+
+    DaemonResponse response = client.evaluate(request({"sin(PI / 2) + 1", "1 / 0"}));
+    ASSERT_TRUE(response.error.empty());
+    ASSERT_EQ(response.results.size(), 2u);
+    EXPECT_EQ(response.results[0].value, 2.0);
+    EXPECT_EQ(response.results[0].text, "2");
+
+    EvaluationResult error = response.results[1].toEvaluationResult();
+    ASSERT_TRUE(error.isError());
+    EXPECT_EQ(error.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+    EXPECT_EQ(error.getErrorPosition(), 2u);
+
+    response = client.evaluate(request({"0xFF & 0x0F"}, "programmer"));
+    ASSERT_EQ(response.results.size(), 1u);
+    EXPECT_EQ(response.results[0].value, 15.0);
+
+    response = client.evaluate(request({"1 / 3"}, "standard", 3));
+    ASSERT_EQ(response.results.size(), 1u);
+    EXPECT_EQ(response.results[0].text, "0.333");
+}
+
+TEST_F(DaemonServerTest, ProgrammerModeSendsExactWords) {
+    DaemonClient client = DaemonClient::connect(path);
+
+    DaemonResponse response = client.evaluate(request({"7 / 2", "0x20000000000001", "1 +"}, "programmer"));
+    ASSERT_EQ(response.results.size(), 3u);
+    EXPECT_EQ(response.results[0].value, 3.0);
+    EXPECT_EQ(response.results[0].text, "3");
+    EXPECT_EQ(response.results[1].text, "9007199254740993");
+    EXPECT_FALSE(response.results[2].isSuccess());
+
+    // Streamed records match a local run
+    std::istringstream in("7 / 2\n9007199254740993\n");
+    std::ostringstream out;
+    (void)client.run(in, out, request({}, "programmer"));
+    EXPECT_EQ(out.str(), "3\n9007199254740993\n");
+}
+
+TEST_F(DaemonServerTest, PrecisionModeKeepsItsDigits) {
+    DaemonClient client = DaemonClient::connect(path);
+
+    DaemonResponse response = client.evaluate(request({"2 / 3", "0.1 + 0.2"}, "precision", 30));
+    ASSERT_EQ(response.results.size(), 2u);
+    EXPECT_EQ(response.results[0].text, "0.666666666666666666666666666667");
+    EXPECT_EQ(response.results[1].text, "0.3");
+    EXPECT_EQ(response.results[1].value, 0.3);
+
+    response = client.evaluate(request({"2 / 3"}, "precision"));
+    ASSERT_EQ(response.results.size(), 1u);
+    EXPECT_EQ(response.results[0].text, "0.66666666666666666666666666666666666666666666666667");
+}
+
+TEST_F(DaemonServerTest, RejectsUnknownModesAndPrecisions) {
+    DaemonClient client = DaemonClient::connect(path);
+
+    EXPECT_EQ(client.evaluate(request({"1"}, "nosuch")).error, "Unknown mode 'nosuch'");
+    EXPECT_FALSE(client.evaluate(request({"1"}, "standard", DaemonServer::MAX_DOUBLE_PRECISION + 1)).error.empty());
+    EXPECT_FALSE(client.evaluate(request({"1"}, "precision", 0)).error.empty());
+
+    // The connection is still usable
+    DaemonResponse response = client.evaluate(request({"1 + 1"}));
+    ASSERT_EQ(response.results.size(), 1u);
+    EXPECT_EQ(response.results[0].value, 2.0);
+}
+
+TEST_F(DaemonServerTest, PipelinedResponsesKeepRequestOrder) {
+    DaemonClient client = DaemonClient::connect(path);
+
+    // More than MAX_PENDING_REQUESTS in flight, so reading pauses and resumes
+    const int count = static_cast<int>(DaemonServer::MAX_PENDING_REQUESTS) * 3;
+    for (int i = 0; i < count; ++i) {
+        std::string mode = (i % 3 == 0) ? "precision" : "";
+        client.send(request({std::to_string(i) + " * 2", "nosuch(" + std::to_string(i) + ")"}, mode));
+    }
+    for (int i = 0; i < count; ++i) {
+        DaemonResponse response = client.receive();
+        ASSERT_EQ(response.results.size(), 2u) << i;
+        EXPECT_EQ(response.results[0].value, 2.0 * i) << i;
+        EXPECT_FALSE(response.results[1].isSuccess()) << i;
+    }
+}
+
+TEST_F(DaemonServerTest, ServesManyConnections) {
+    std::vector<std::thread> clients;
+    std::vector<int> failures(8, 0);
+    for (size_t c = 0; c < failures.size(); ++c) {
+        clients.emplace_back([&, c] {
+            DaemonClient client = DaemonClient::connect(path);
+            for (size_t i = 0; i < 50; ++i) {
+                DaemonResponse response = client.evaluate(request({std::to_string(c) + " + " + std::to_string(i)}));
+                if (response.results.size() != 1 || response.results[0].value != static_cast<double>(c + i)) {
+                    ++failures[c];
+                }
+            }
+        });
+    }
+    for (auto& thread : clients) {
+        thread.join();
+    }
+    for (int failed : failures) {
+        EXPECT_EQ(failed, 0);
+    }
+}
+
+TEST_F(DaemonServerTest, RunWritesStreamRecords) {
+    DaemonClient client = DaemonClient::connect(path);
+    std::istringstream in("1 + 2\n\nsqrt(16)\r\n1 / 0\n10 / 4");
+    std::ostringstream out;
+
+    BatchStats stats = client.run(in, out, request({}));
+
+    EXPECT_EQ(out.str(), "3\n\n4\nError: Division by zero at position 2\n2.5\n");
+    EXPECT_EQ(stats.lines, 5u);
+    EXPECT_EQ(stats.evaluated, 4u);
+    EXPECT_EQ(stats.failed, 1u);
+
+    // More lines than one request holds, in another format
+    std::string input;
+    for (size_t i = 0; i < DaemonClient::LINES_PER_REQUEST * 3 + 5; ++i) {
+        input += std::to_string(i) + "\n";
+    }
+    std::istringstream many(input);
+    std::ostringstream csv;
+    stats = client.run(many, csv, request({}), ResultFormat::CSV, 100);
+    EXPECT_EQ(stats.evaluated, DaemonClient::LINES_PER_REQUEST * 3 + 5);
+    const std::string expected = "expression,value,error,message,position\n0,0,,,\n1,1,,,\n";
+    EXPECT_EQ(csv.str().substr(0, expected.size()), expected);
+}
+
+TEST_F(DaemonServerTest, MalformedFramesCloseTheConnection) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+    ASSERT_EQ(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+
+    const char garbage[] = "\x02\x00\x00\x00\x09\x09";  // Version 9
+    ASSERT_EQ(::write(fd, garbage, 6), 6);
+    char byte;
+    EXPECT_EQ(::read(fd, &byte, 1), 0);
+    ::close(fd);
+
+    // Other clients are unaffected
+    DaemonClient client = DaemonClient::connect(path);
+    EXPECT_EQ(client.evaluate(request({"2 ^ 10"})).results.at(0).value, 1024.0);
+}
+
+TEST_F(DaemonServerTest, SocketInUseIsRefused) {
+    ModeManager other;
+    DaemonServer second(other, "standard", 1);
+    EXPECT_THROW(second.listen(path), std::runtime_error);
+}
+
+TEST(DaemonServerLifecycleTest, ReplacesStaleSocketsAndRemovesItsOwn) {
+    const std::string path = ::testing::TempDir() + "calc_daemon_stale_" + std::to_string(::getpid()) + ".sock";
+    {
+        // Leave a socket file nothing listens on
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+        ASSERT_EQ(::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+        ::close(fd);
+    }
+
+    ModeManager modes;
+    {
+        DaemonServer server(modes, "standard", 1);
+        EXPECT_NO_THROW(server.listen(path));
+        EXPECT_EQ(::access(path.c_str(), F_OK), 0);
+
+        server.stop();  // Before run(): run() returns at once
+        server.run();
+    }
+    EXPECT_NE(::access(path.c_str(), F_OK), 0);
+
+    EXPECT_THROW(DaemonClient::connect(path), std::runtime_error);
+    EXPECT_THROW(DaemonServer(modes, "standard", 1).run(), std::runtime_error);
+}
+
+#endif // __linux__
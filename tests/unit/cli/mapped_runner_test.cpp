@@ -0,0 +1,161 @@
+/**
+ * @file mapped_runner_test.cpp
+ * @brief Unit tests for MappedRunner and MappedFile
+ */
+
+#include "calc/ui/cli/mapped_runner.h"
+#include "calc/modes/scientific_mode.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace calc;
+using namespace calc::cli;
+
+class MappedRunnerTest : public ::testing::Test {
+protected:
+    ScientificMode mode;
+
+    // What BatchRunner writes for the same input
+    std::string batchOutput(const SharedEngine& engine, const std::string& input) {
+        BatchRunner runner(engine, 1);
+        std::istringstream in(input);
+        std::ostringstream out;
+        (void)runner.run(in, out);
+        return out.str();
+    }
+};
+
+TEST_F(MappedRunnerTest, OneResultPerLine) {
+    SharedEngine engine(mode);
+    MappedRunner runner(engine, 2);
+    std::ostringstream out;
+
+    BatchStats stats = runner.run("1 + 2\nsqrt(16)\n\n1 / 0\r\n10 / 4", out);  // No newline at the end
+
+    EXPECT_EQ(out.str(), "3\n4\n\nError: Division by zero at position 2\n2.5\n");
+    EXPECT_EQ(stats.lines, 5u);
+    EXPECT_EQ(stats.evaluated, 4u);
+    EXPECT_EQ(stats.failed, 1u);
+    EXPECT_EQ(stats.bytesRead, 24u);  // Line terminators excluded
+}
+
+TEST_F(MappedRunnerTest, EmptyInput) {
+    SharedEngine engine(mode);
+    MappedRunner runner(engine);
+    std::ostringstream out;
+
+    BatchStats stats = runner.run("", out);
+
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_EQ(stats.lines, 0u);
+    EXPECT_GE(runner.getWorkerCount(), 1u);
+}
+
+TEST_F(MappedRunnerTest, ChunksSplitOnLineBoundaries) {
+    std::string input;
+    for (int i = 0; i < 3000; ++i) {
+        const std::string n = std::to_string(i);
+        if (i % 11 == 0) {
+            input += "(" + n + " +\n";
+        } else if (i % 13 == 0) {
+            input += "\n";
+        } else if (i % 17 == 0) {
+            input += std::string(200, ' ') + n + "\n";  // Longer than the smallest chunks
+        } else {
+            input += n + " * 2 + max(" + n + ", 1)\r\n";
+        }
+    }
+
+    SharedEngine engine(mode, 64);
+    const std::string expected = batchOutput(engine, input);
+    for (size_t chunkBytes : {1u, 7u, 64u, 4096u, 1u << 20}) {
+        MappedRunner runner(engine, 3, chunkBytes);
+        std::ostringstream out;
+
+        BatchStats stats = runner.run(input, out);
+
+        EXPECT_EQ(out.str(), expected) << "chunk bytes " << chunkBytes;
+        EXPECT_EQ(stats.lines, 3000u) << "chunk bytes " << chunkBytes;
+        EXPECT_EQ(stats.failed, 273u) << "chunk bytes " << chunkBytes;
+    }
+}
+
+TEST_F(MappedRunnerTest, EveryFormatMatchesBatchRunner) {
+    const std::string input = "1 + 2\n\nmax(1, 2) / 3\n1 / 0\n";
+    SharedEngine engine(mode);
+
+    for (ResultFormat format : {ResultFormat::TEXT, ResultFormat::JSONL, ResultFormat::CSV,
+                                ResultFormat::TSV, ResultFormat::BINARY}) {
+        BatchRunner batch(engine, 1);
+        batch.setFormat(format);
+        std::istringstream batchIn(input);
+        std::ostringstream batchOut;
+        (void)batch.run(batchIn, batchOut);
+
+        MappedRunner mapped(engine, 2, 8);
+        mapped.setFormat(format);
+        std::ostringstream mappedOut;
+        (void)mapped.run(input, mappedOut);
+
+        EXPECT_EQ(mappedOut.str(), batchOut.str()) << static_cast<int>(format);
+    }
+}
+
+TEST_F(MappedRunnerTest, ManyChunksPerWorker) {
+    // More chunks than slots, so workers wait for chunks to be written
+    std::string input;
+    std::string expected;
+    for (int i = 0; i < 20000; ++i) {
+        input += std::to_string(i) + " + 1\n";
+        expected += std::to_string(i + 1) + "\n";
+    }
+
+    SharedEngine engine(mode);
+    MappedRunner runner(engine, 4, 100);
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(input, out);
+
+    EXPECT_EQ(out.str(), expected);
+    EXPECT_EQ(stats.evaluated, 20000u);
+    EXPECT_EQ(stats.workers, 4u);
+}
+
+TEST_F(MappedRunnerTest, MapsFiles) {
+    const std::string path = ::testing::TempDir() + "mapped_runner_test.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "2 ^ 10\nsin(0)\n";
+    }
+
+    MappedFile mapped = MappedFile::open(path);
+    EXPECT_EQ(mapped.size(), 14u);
+    EXPECT_EQ(mapped.view(), "2 ^ 10\nsin(0)\n");
+
+    SharedEngine engine(mode);
+    MappedRunner runner(engine, 1);
+    std::ostringstream out;
+    (void)runner.run(mapped.view(), out);
+    EXPECT_EQ(out.str(), "1024\n0\n");
+
+    std::remove(path.c_str());
+    EXPECT_EQ(mapped.view(), "2 ^ 10\nsin(0)\n");  // The mapping outlives the name
+}
+
+TEST_F(MappedRunnerTest, MapsEmptyFiles) {
+    const std::string path = ::testing::TempDir() + "mapped_runner_empty.txt";
+    std::ofstream(path, std::ios::binary).close();
+
+    MappedFile mapped = MappedFile::open(path);
+    EXPECT_EQ(mapped.size(), 0u);
+    EXPECT_TRUE(mapped.view().empty());
+    std::remove(path.c_str());
+}
+
+TEST_F(MappedRunnerTest, MissingFileThrows) {
+    EXPECT_THROW(MappedFile::open(::testing::TempDir() + "no_such_file.txt"), std::runtime_error);
+}
@@ -282,3 +282,141 @@ TEST_F(OutputFormatterTest, FormatResult_NaN_HandlesNaN) {
 
     EXPECT_TRUE(output.find("NaN") != std::string::npos);
 }
+
+// Value formatting
+TEST_F(OutputFormatterTest, FormatValue_MatchesFixedNotation) {
+    EXPECT_EQ(OutputFormatter::formatValue(2.5), "2.5");
+    EXPECT_EQ(OutputFormatter::formatValue(1.0 / 3.0), "0.333333");
+    EXPECT_EQ(OutputFormatter::formatValue(1.0 / 3.0, 2), "0.33");
+    EXPECT_EQ(OutputFormatter::formatValue(-0.125, 2), "-0.12");  // Ties round to even
+    EXPECT_EQ(OutputFormatter::formatValue(42.0), "42");
+    EXPECT_EQ(OutputFormatter::formatValue(1e20), "100000000000000000000");
+    EXPECT_EQ(OutputFormatter::formatValue(2.0000001), "2");
+    EXPECT_EQ(OutputFormatter::formatValue(0.1, 20), "0.10000000000000000555");
+    EXPECT_EQ(OutputFormatter::formatValue(std::numeric_limits<double>::max()).size(), 309u);
+}
+
+TEST_F(OutputFormatterTest, FormatValue_BeyondTheBufferFallsBackToStreams) {
+    std::string text = OutputFormatter::formatValue(0.1, 600);
+    EXPECT_EQ(text.substr(0, 22), "0.10000000000000000555");
+    EXPECT_EQ(text.size(), 57u);  // Exact binary value of 0.1, trailing zeros dropped
+}
+
+TEST_F(OutputFormatterTest, AppendValue_AppendsToExistingText) {
+    std::string out = "x = ";
+    OutputFormatter::appendValue(out, 0.75, 1);
+    EXPECT_EQ(out, "x = 0.8");
+}
+
+// Machine-readable records
+TEST_F(OutputFormatterTest, AppendShortest_RoundTrips) {
+    for (double value : {0.1, 1.0 / 3.0, 1e300, -2.5e-308, 123456789.0, 0.30000000000000004}) {
+        std::string text;
+        OutputFormatter::appendShortest(text, value);
+        EXPECT_EQ(std::stod(text), value) << text;
+    }
+
+    std::string text;
+    OutputFormatter::appendShortest(text, 0.1);
+    EXPECT_EQ(text, "0.1");
+}
+
+TEST_F(OutputFormatterTest, AppendRecord_Text) {
+    std::string out;
+    OutputFormatter::appendRecord(out, ResultFormat::TEXT, "1 / 3", createSuccessResult(1.0 / 3.0), 3);
+    OutputFormatter::appendRecord(out, ResultFormat::TEXT, "1 / 0",
+                                  createErrorResult(ErrorCode::DIVISION_BY_ZERO, "Division by zero", 2));
+    OutputFormatter::appendBlankRecord(out, ResultFormat::TEXT);
+
+    EXPECT_EQ(out, "0.333\nError: Division by zero at position 2\n\n");
+}
+
+TEST_F(OutputFormatterTest, AppendRecord_Jsonl) {
+    std::string out;
+    OutputFormatter::appendRecord(out, ResultFormat::JSONL, "2 / 3", createSuccessResult(2.0 / 3.0));
+    OutputFormatter::appendRecord(out, ResultFormat::JSONL, "f(\"x\\\")",
+                                  createErrorResult(ErrorCode::INVALID_FUNCTION, "Unknown function: f", 0));
+    OutputFormatter::appendRecord(out, ResultFormat::JSONL, "1e308 * 10",
+                                  createSuccessResult(std::numeric_limits<double>::infinity()));
+    OutputFormatter::appendBlankRecord(out, ResultFormat::JSONL);
+
+    EXPECT_EQ(out,
+              "{\"expression\":\"2 / 3\",\"value\":0.6666666666666666}\n"
+              "{\"expression\":\"f(\\\"x\\\\\\\")\",\"error\":\"INVALID_FUNCTION\","
+              "\"message\":\"Unknown function: f\",\"position\":0}\n"
+              "{\"expression\":\"1e308 * 10\",\"value\":\"inf\"}\n");
+    EXPECT_TRUE(OutputFormatter::recordHeader(ResultFormat::JSONL).empty());
+}
+
+TEST_F(OutputFormatterTest, AppendRecord_Csv) {
+    std::string out(OutputFormatter::recordHeader(ResultFormat::CSV));
+    OutputFormatter::appendRecord(out, ResultFormat::CSV, "1 + 2", createSuccessResult(3.0));
+    OutputFormatter::appendRecord(out, ResultFormat::CSV, "max(1, \"2\")",
+                                  createErrorResult(ErrorCode::UNEXPECTED_TOKEN, "Unexpected \", here", 7));
+    OutputFormatter::appendBlankRecord(out, ResultFormat::CSV);
+
+    EXPECT_EQ(out,
+              "expression,value,error,message,position\n"
+              "1 + 2,3,,,\n"
+              "\"max(1, \"\"2\"\")\",,UNEXPECTED_TOKEN,\"Unexpected \"\", here\",7\n");
+}
+
+TEST_F(OutputFormatterTest, AppendRecord_Tsv) {
+    std::string out(OutputFormatter::recordHeader(ResultFormat::TSV));
+    OutputFormatter::appendRecord(out, ResultFormat::TSV, "0.5\t* 3", createSuccessResult(1.5));
+    OutputFormatter::appendRecord(out, ResultFormat::TSV, "sqrt(-1)",
+                                  createErrorResult(ErrorCode::DOMAIN_ERROR, "Domain error", 0));
+
+    EXPECT_EQ(out,
+              "expression\tvalue\terror\tmessage\tposition\n"
+              "0.5\\t* 3\t1.5\t\t\t\n"
+              "sqrt(-1)\t\tDOMAIN_ERROR\tDomain error\t0\n");
+}
+
+TEST_F(OutputFormatterTest, AppendRecord_ExactValue) {
+    // 2^53 + 1 rounds to 2^53 as a double
+    const EvaluationResult word = createSuccessResult(9007199254740992.0);
+    std::string out;
+    OutputFormatter::appendRecord(out, ResultFormat::TEXT, "0x20000000000001", word, "9007199254740993");
+    OutputFormatter::appendRecord(out, ResultFormat::JSONL, "0x20000000000001", word, "9007199254740993");
+    OutputFormatter::appendRecord(out, ResultFormat::CSV, "0x20000000000001", word, "9007199254740993");
+    OutputFormatter::appendRecord(out, ResultFormat::TSV, "0x20000000000001", word, "9007199254740993");
+    OutputFormatter::appendRecord(out, ResultFormat::JSONL, "1 +",
+                                  createErrorResult(ErrorCode::UNEXPECTED_TOKEN, "Bad", 2), "");
+
+    EXPECT_EQ(out,
+              "9007199254740993\n"
+              "{\"expression\":\"0x20000000000001\",\"value\":9007199254740993}\n"
+              "0x20000000000001,9007199254740993,,,\n"
+              "0x20000000000001\t9007199254740993\t\t\t\n"
+              "{\"expression\":\"1 +\",\"error\":\"UNEXPECTED_TOKEN\",\"message\":\"Bad\",\"position\":2}\n");
+
+    // Binary records carry the double
+    std::string binary;
+    OutputFormatter::appendRecord(binary, ResultFormat::BINARY, "0x20000000000001", word, "9007199254740993");
+    std::string expected;
+    OutputFormatter::appendRecord(expected, ResultFormat::BINARY, "0x20000000000001", word);
+    EXPECT_EQ(binary, expected);
+}
+
+TEST_F(OutputFormatterTest, AppendRecord_BinaryIsLittleEndian) {
+    std::string out;
+    OutputFormatter::appendRecord(out, ResultFormat::BINARY, "1 + 2", createSuccessResult(3.0));
+    OutputFormatter::appendRecord(out, ResultFormat::BINARY, "1 / 0",
+                                  createErrorResult(ErrorCode::DIVISION_BY_ZERO, "Division by zero", 2));
+    OutputFormatter::appendBlankRecord(out, ResultFormat::BINARY);
+
+    ASSERT_EQ(out.size(), 3 * OutputFormatter::BINARY_RECORD_BYTES);
+    auto byte = [&](size_t i) { return static_cast<unsigned char>(out[i]); };
+
+    // 3.0 is 0x4008000000000000
+    EXPECT_EQ(byte(6), 0x08u);
+    EXPECT_EQ(byte(7), 0x40u);
+    EXPECT_EQ(byte(8), OutputFormatter::BINARY_STATUS_OK);
+
+    // Errors carry their position as the value and 1 + the code as the status
+    EXPECT_EQ(byte(16), 0x40u);  // 2.0 is 0x4000000000000000
+    EXPECT_EQ(byte(17), 1u + static_cast<unsigned>(ErrorCode::DIVISION_BY_ZERO));
+
+    EXPECT_EQ(byte(26), OutputFormatter::BINARY_STATUS_BLANK);
+}
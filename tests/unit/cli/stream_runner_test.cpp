@@ -0,0 +1,166 @@
+/**
+ * @file stream_runner_test.cpp
+ * @brief Unit tests for StreamRunner
+ */
+
+#include "calc/ui/cli/stream_runner.h"
+#include "calc/ui/cli/output_formatter.h"
+#include "calc/modes/scientific_mode.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace calc;
+using namespace calc::cli;
+
+namespace {
+
+// Records the output as it stood at each flush, and counts the writes
+class FlushRecorder : public std::stringbuf {
+public:
+    std::vector<std::string> flushes;
+    size_t writes = 0;
+
+protected:
+    int sync() override {
+        flushes.push_back(str());
+        return 0;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        if (n > 0) {
+            ++writes;
+        }
+        return std::stringbuf::xsputn(s, n);
+    }
+};
+
+} // anonymous namespace
+
+class StreamRunnerTest : public ::testing::Test {
+protected:
+    ScientificMode mode;
+};
+
+TEST_F(StreamRunnerTest, OneResultPerLine) {
+    SharedEngine engine(mode);
+    StreamRunner runner(engine);
+    std::istringstream in("1 + 2\nsqrt(16)\n\n1 / 0\r\n10 / 4");  // No newline after the last line
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+
+    EXPECT_EQ(out.str(), "3\n4\n\nError: Division by zero at position 2\n2.5\n");
+    EXPECT_EQ(stats.lines, 5u);
+    EXPECT_EQ(stats.evaluated, 4u);
+    EXPECT_EQ(stats.failed, 1u);
+    EXPECT_EQ(stats.workers, 1u);
+}
+
+TEST_F(StreamRunnerTest, MatchesBatchRunner) {
+    std::string input;
+    for (int i = 0; i < 2000; ++i) {
+        const std::string n = std::to_string(i);
+        input += (i % 5 == 0) ? "(" + n + " +\n" : "sin(" + n + ") * " + n + "\n";
+    }
+
+    SharedEngine engine(mode);
+    std::istringstream streamIn(input);
+    std::ostringstream streamOut;
+    std::istringstream batchIn(input);
+    std::ostringstream batchOut;
+
+    BatchStats streamStats = StreamRunner(engine).run(streamIn, streamOut);
+    BatchStats batchStats = BatchRunner(engine, 2).run(batchIn, batchOut);
+
+    EXPECT_EQ(streamOut.str(), batchOut.str());
+    EXPECT_EQ(streamStats.failed, batchStats.failed);
+    EXPECT_EQ(streamStats.bytesRead, batchStats.bytesRead);
+}
+
+TEST_F(StreamRunnerTest, WritesRecordsInTheChosenFormat) {
+    SharedEngine engine(mode);
+    StreamRunner runner(engine);
+    runner.setFormat(ResultFormat::CSV);
+    std::istringstream in("1 + 2\n\n1 / 0\n");
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+
+    EXPECT_EQ(out.str(),
+              "expression,value,error,message,position\n"
+              "1 + 2,3,,,\n"
+              "1 / 0,,DIVISION_BY_ZERO,Division by zero,2\n");
+    EXPECT_EQ(stats.failed, 1u);
+}
+
+TEST_F(StreamRunnerTest, BinaryRecordsKeepTheirPlace) {
+    SharedEngine engine(mode);
+    StreamRunner runner(engine);
+    runner.setFormat(ResultFormat::BINARY);
+    std::istringstream in("0.5\n\n1 / 0\n");
+    std::ostringstream out;
+
+    (void)runner.run(in, out);
+
+    const std::string bytes = out.str();
+    ASSERT_EQ(bytes.size(), 3 * OutputFormatter::BINARY_RECORD_BYTES);
+    EXPECT_EQ(static_cast<unsigned char>(bytes[8]), OutputFormatter::BINARY_STATUS_OK);
+    EXPECT_EQ(static_cast<unsigned char>(bytes[17]), OutputFormatter::BINARY_STATUS_BLANK);
+    EXPECT_EQ(static_cast<unsigned char>(bytes[26]), 1u + static_cast<unsigned>(ErrorCode::DIVISION_BY_ZERO));
+}
+
+TEST_F(StreamRunnerTest, FlushesOnlyAtTheEndByDefault) {
+    SharedEngine engine(mode);
+    StreamRunner runner(engine);
+    std::istringstream in("1\n2\n3\n");
+    FlushRecorder recorder;
+    std::ostream out(&recorder);
+
+    (void)runner.run(in, out);
+
+    ASSERT_EQ(recorder.flushes.size(), 1u);
+    EXPECT_EQ(recorder.flushes[0], "1\n2\n3\n");
+}
+
+TEST_F(StreamRunnerTest, FlushesEveryNLines) {
+    SharedEngine engine(mode);
+    StreamRunner runner(engine, 2);
+    std::istringstream in("1\n2\n3\n4\n5\n");
+    FlushRecorder recorder;
+    std::ostream out(&recorder);
+
+    (void)runner.run(in, out);
+
+    ASSERT_EQ(recorder.flushes.size(), 3u);
+    EXPECT_EQ(recorder.flushes[0], "1\n2\n");
+    EXPECT_EQ(recorder.flushes[1], "1\n2\n3\n4\n");
+    EXPECT_EQ(recorder.flushes[2], "1\n2\n3\n4\n5\n");
+}
+
+TEST_F(StreamRunnerTest, WritesWhenTheBufferFills) {
+    SharedEngine engine(mode);
+    StreamRunner runner(engine, 0, 8);
+    std::istringstream in("100\n200\n300\n400\n5\n");
+    FlushRecorder recorder;
+    std::ostream out(&recorder);
+
+    (void)runner.run(in, out);
+
+    EXPECT_EQ(recorder.str(), "100\n200\n300\n400\n5\n");
+    EXPECT_EQ(recorder.writes, 3u);  // Two full buffers and the rest
+    EXPECT_EQ(recorder.flushes.size(), 1u);
+}
+
+TEST_F(StreamRunnerTest, EmptyInput) {
+    SharedEngine engine(mode);
+    StreamRunner runner(engine);
+    std::istringstream in("");
+    std::ostringstream out;
+
+    BatchStats stats = runner.run(in, out);
+
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_EQ(stats.lines, 0u);
+}
@@ -0,0 +1,347 @@
+/**
+ * @file compiled_expression_test.cpp
+ * @brief Unit tests for CompiledExpression and VirtualMachine
+ */
+
+#include <gtest/gtest.h>
+#include "calc/core/compiled_expression.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <cmath>
+
+using namespace calc;
+
+namespace {
+
+std::unique_ptr<ASTNode> parse(const std::string& expr) {
+    Tokenizer tokenizer(expr);
+    auto tokens = tokenizer.tokenize();
+    ShuntingYardParser parser;
+    return parser.parse(tokens);
+}
+
+} // anonymous namespace
+
+class CompiledExpressionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MathFunctions::registerBuiltInFunctions(context);
+    }
+
+    EvaluationResult runCompiled(const std::string& expr) {
+        auto ast = parse(expr);
+        CompiledExpression program = CompiledExpression::compile(*ast, context);
+        return vm.execute(program);
+    }
+
+    EvaluationResult runReference(const std::string& expr) {
+        auto ast = parse(expr);
+        EvaluatorVisitor evaluator;
+        return evaluator.evaluate(ast.get(), context);
+    }
+
+    // The VM must agree with EvaluatorVisitor on values, codes and positions
+    void expectSameAsReference(const std::string& expr) {
+        EvaluationResult expected = runReference(expr);
+        EvaluationResult actual = runCompiled(expr);
+
+        ASSERT_EQ(actual.isSuccess(), expected.isSuccess()) << expr;
+        if (expected.isSuccess()) {
+            EXPECT_DOUBLE_EQ(actual.getValue(), expected.getValue()) << expr;
+        } else {
+            EXPECT_EQ(actual.getErrorCode(), expected.getErrorCode()) << expr;
+            EXPECT_EQ(actual.getErrorMessage(), expected.getErrorMessage()) << expr;
+            EXPECT_EQ(actual.getErrorPosition(), expected.getErrorPosition()) << expr;
+        }
+    }
+
+    EvaluationContext context;
+    VirtualMachine vm;
+};
+
+TEST_F(CompiledExpressionTest, Literal) {
+    EvaluationResult result = runCompiled("42");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 42.0);
+}
+
+TEST_F(CompiledExpressionTest, RegisterCountFollowsDepth) {
+    auto flat = parse("1 + 2 + 3 + 4");
+    EXPECT_EQ(CompiledExpression::compile(*flat, context).getRegisterCount(), 2u);
+
+    auto nested = parse("1 + (2 + (3 + 4))");
+    EXPECT_EQ(CompiledExpression::compile(*nested, context).getRegisterCount(), 4u);
+}
+
+TEST_F(CompiledExpressionTest, UnaryPlusEmitsNoInstruction) {
+    auto ast = parse("+5");
+    CompiledExpression program = CompiledExpression::compile(*ast, context);
+    EXPECT_EQ(program.getInstructions().size(), 1u);
+}
+
+TEST_F(CompiledExpressionTest, ArithmeticMatchesReference) {
+    for (const char* expr : {"1 + 2 * 3", "(1 + 2) * (3 - 4) / 5", "2 ^ 3 ^ 2", "-2 ^ 2",
+                             "10 % 3", "-(3 - 5) * +4", "1.5e3 / 7", "--5"}) {
+        expectSameAsReference(expr);
+    }
+}
+
+TEST_F(CompiledExpressionTest, FunctionsMatchReference) {
+    for (const char* expr : {"sin(PI / 2)", "max(1, 5, 3)", "pow(sqrt(16), 2)",
+                             "hypot(3, 4) + log10(1000)", "min(3, -2) * E"}) {
+        expectSameAsReference(expr);
+    }
+}
+
+TEST_F(CompiledExpressionTest, ErrorsMatchReference) {
+    for (const char* expr : {"1 / 0", "5 % 0", "sqrt(-1)", "log(0)", "unknown(1) + 2",
+                             "sin(1, 2)", "10 ^ 400", "(-8) ^ 0.5", "1 / (2 - 2) + foo(1)"}) {
+        expectSameAsReference(expr);
+    }
+}
+
+TEST_F(CompiledExpressionTest, BitwiseSemanticsResolvedAtCompileTime) {
+    context.setOperatorSemantics("^", OperatorSemantics::BITWISE_XOR);
+    for (const char* expr : {"12 ^ 10", "0xFF & 0x0F", "0xF0 | 0x0F", "~5", "(1 << 4) >> 2"}) {
+        expectSameAsReference(expr);
+    }
+
+    EvaluationResult result = runCompiled("12 ^ 10");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 6.0);
+}
+
+TEST_F(CompiledExpressionTest, UnknownOperatorsDeferredToRunTime) {
+    Token unknown(TokenType::OPERATOR, "@", 3);
+    BinaryOpNode binary(std::make_unique<LiteralNode>(2.0), unknown,
+                        std::make_unique<LiteralNode>(3.0));
+    EvaluationResult result = vm.execute(CompiledExpression::compile(binary, context));
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::EVALUATION_ERROR);
+    EXPECT_EQ(result.getErrorPosition(), 3u);
+
+    UnaryOpNode unary(unknown, std::make_unique<LiteralNode>(1.0));
+    result = vm.execute(CompiledExpression::compile(unary, context));
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::EVALUATION_ERROR);
+}
+
+TEST_F(CompiledExpressionTest, ReusedAcrossRuns) {
+    auto ast = parse("sin(1) * cos(1) + 2");
+    CompiledExpression program = CompiledExpression::compile(*ast, context);
+    double first = vm.execute(program).getValue();
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_DOUBLE_EQ(vm.execute(program).getValue(), first);
+    }
+}
+
+TEST_F(CompiledExpressionTest, SeesReplacedFunctionCallbacks) {
+    context.addFunction("twice", [](const std::vector<double>& args) { return args[0] * 2; });
+    auto ast = parse("twice(4)");
+    CompiledExpression program = CompiledExpression::compile(*ast, context);
+    EXPECT_DOUBLE_EQ(vm.execute(program).getValue(), 8.0);
+
+    context.addFunction("twice", [](const std::vector<double>& args) { return args[0] * 3; });
+    EXPECT_DOUBLE_EQ(vm.execute(program).getValue(), 12.0);
+}
+
+TEST_F(CompiledExpressionTest, ArityCheckedAtCompileTime) {
+    auto ast = parse("sin(1, 2) + 1");
+    CompiledExpression program = CompiledExpression::compile(*ast, context);
+    EXPECT_TRUE(program.getFunctions().empty());
+
+    EvaluationResult result = vm.execute(program);
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorMessage(), "sin requires exactly 1 argument");
+
+    expectSameAsReference("sin(1, 2) + 1");
+    expectSameAsReference("max(3) * 2");
+    expectSameAsReference("hypot(1) - 1");
+}
+
+TEST_F(CompiledExpressionTest, NestedFixedArityCalls) {
+    expectSameAsReference("max(sin(1), cos(1), hypot(3, max(4, 1, 2)))");
+    expectSameAsReference("pow(min(2, 3, 1.5), log(exp(2))) + PI");
+    expectSameAsReference("fmod(7, max(0, -1))");
+}
+
+TEST_F(CompiledExpressionTest, VariablesResolvedToSlots) {
+    context.setVariable("x", 3.0);
+    context.setVariable("y", 4.0);
+    expectSameAsReference("hypot(x, y) * PI");
+    expectSameAsReference("x / (y - 4)");
+    expectSameAsReference("rate * 2");
+
+    auto ast = parse("x * x");
+    CompiledExpression program = CompiledExpression::compile(*ast, context);
+    EXPECT_EQ(program.getInstructions()[0].op, BytecodeOp::LOAD_VAR);
+    EXPECT_DOUBLE_EQ(vm.execute(program).getValue(), 9.0);
+
+    // Reassigning a variable does not require recompiling
+    context.setVariable("x", 5.0);
+    EXPECT_DOUBLE_EQ(vm.execute(program).getValue(), 25.0);
+}
+
+TEST_F(CompiledExpressionTest, BatchOverColumns) {
+    context.setVariable("scale", 10.0);
+    const std::vector<double> x = {1.0, 2.0, 3.0, 4.0};
+    const std::vector<double> y = {4.0, 3.0, 0.0, 1.0};
+    std::vector<double> out(x.size());
+
+    auto ast = parse("scale * x / y");
+    BatchResult result = vm.evaluateBatch(*ast, context,
+        {{"x", x.data()}, {"y", y.data()}}, x.size(), out.data());
+
+    EXPECT_EQ(result.rows, 4u);
+    EXPECT_EQ(result.failedRows, 1u);
+    EXPECT_EQ(result.firstFailedRow, 2u);
+    ASSERT_TRUE(result.firstError.has_value());
+    EXPECT_EQ(result.firstError->getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+
+    EXPECT_DOUBLE_EQ(out[0], 2.5);
+    EXPECT_DOUBLE_EQ(out[1], 20.0 / 3.0);
+    EXPECT_TRUE(std::isnan(out[2]));
+    EXPECT_DOUBLE_EQ(out[3], 40.0);
+}
+
+TEST_F(CompiledExpressionTest, ColumnsShadowContextVariables) {
+    context.setVariable("x", 100.0);
+    const std::vector<double> x = {1.0, 2.0};
+    std::vector<double> out(x.size());
+
+    auto ast = parse("x + 1");
+    BatchResult result = vm.evaluateBatch(*ast, context, {{"x", x.data()}}, x.size(), out.data());
+    EXPECT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(out[0], 2.0);
+    EXPECT_DOUBLE_EQ(out[1], 3.0);
+}
+
+TEST_F(CompiledExpressionTest, ColumnProgramRejectsScalarExecution) {
+    auto ast = parse("x + 1");
+    CompiledExpression program = CompiledExpression::compile(*ast, context, {"x"});
+    EXPECT_TRUE(vm.execute(program).isError());
+
+    std::vector<double> out(2);
+    BatchResult result = vm.executeBatch(program, {}, out.size(), out.data());
+    EXPECT_EQ(result.failedRows, 2u);
+    EXPECT_TRUE(std::isnan(out[0]));
+}
+
+TEST_F(CompiledExpressionTest, ScalarSimdLevelAlwaysSupported) {
+    EXPECT_TRUE(isSimdLevelSupported(SimdLevel::SCALAR));
+    EXPECT_TRUE(isSimdLevelSupported(detectSimdLevel()));
+    EXPECT_EQ(vm.getSimdLevel(), detectSimdLevel());
+    EXPECT_EQ(simdLevelToString(SimdLevel::AVX2), "avx2");
+}
+
+TEST_F(CompiledExpressionTest, SimdLevelsMatchReference) {
+    // Blocks of 256 rows with a partial tail; some rows hit every error check
+    constexpr size_t ROWS = 1000;
+    std::vector<double> x(ROWS);
+    std::vector<double> y(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        x[i] = -3.0 + 0.0075 * static_cast<double>(i);
+        y[i] = static_cast<double>(static_cast<int>(i % 70) - 5);
+    }
+    y[17] = 1e300;
+    // Exact halves, where vectorized round() must still round away from zero
+    x[600] = 2.5;
+    x[601] = -0.5;
+
+    const std::vector<const char*> expressions = {
+        "x * y + x / y - 2 ^ x", "x % y", "y ^ 300",
+        "sin(x) * cos(y) + tan(x) + atan(y)", "asin(x) + acos(x / 3)",
+        "log(x) + log10(y) + sqrt(y) + exp(y)", "sinh(x) + cosh(x) + tanh(y) + cbrt(x)",
+        "abs(x) + floor(x) + ceil(x) + round(x) + trunc(x)", "max(x, y) + hypot(x, y)",
+        "-x * PI + scale", "missing + x"
+    };
+    context.setVariable("scale", 0.5);
+
+    std::vector<double> expected(ROWS);
+    std::vector<double> actual(ROWS);
+    for (const char* expr : expressions) {
+        auto ast = parse(expr);
+        CompiledExpression program = CompiledExpression::compile(*ast, context, {"x", "y"});
+
+        vm.setSimdLevel(SimdLevel::SCALAR);
+        BatchResult reference = vm.executeBatch(program, {x.data(), y.data()}, ROWS, expected.data());
+
+        for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (!isSimdLevelSupported(level)) {
+                continue;
+            }
+            vm.setSimdLevel(level);
+            BatchResult result = vm.executeBatch(program, {x.data(), y.data()}, ROWS, actual.data());
+
+            EXPECT_EQ(result.failedRows, reference.failedRows) << expr;
+            EXPECT_EQ(result.firstFailedRow, reference.firstFailedRow) << expr;
+            ASSERT_EQ(result.firstError.has_value(), reference.firstError.has_value()) << expr;
+            if (reference.firstError) {
+                EXPECT_EQ(result.firstError->getErrorMessage(), reference.firstError->getErrorMessage()) << expr;
+                EXPECT_EQ(result.firstError->getErrorPosition(), reference.firstError->getErrorPosition()) << expr;
+            }
+            for (size_t i = 0; i < ROWS; ++i) {
+                if (std::isnan(expected[i])) {
+                    EXPECT_TRUE(std::isnan(actual[i])) << expr << " row " << i;
+                } else {
+                    // Documented tolerance is 0 ULP
+                    EXPECT_EQ(actual[i], expected[i]) << expr << " row " << i;
+                }
+            }
+        }
+    }
+
+    // The scalar batch agrees with the reference evaluator row by row
+    auto ast = parse(expressions[0]);
+    vm.setSimdLevel(SimdLevel::SCALAR);
+    (void)vm.evaluateBatch(*ast, context, {{"x", x.data()}, {"y", y.data()}}, ROWS, expected.data());
+    for (size_t i = 0; i < ROWS; i += 37) {
+        context.setVariable("x", x[i]);
+        context.setVariable("y", y[i]);
+        EvaluationResult row = runReference(expressions[0]);
+        if (row.isSuccess()) {
+            EXPECT_DOUBLE_EQ(expected[i], row.getValue()) << "row " << i;
+        } else {
+            EXPECT_TRUE(std::isnan(expected[i])) << "row " << i;
+        }
+    }
+}
+
+TEST_F(CompiledExpressionTest, SimdLevelsMatchBitwiseReference) {
+    context.setOperatorSemantics("^", OperatorSemantics::BITWISE_XOR);
+    constexpr size_t ROWS = 300;
+    std::vector<double> x(ROWS);
+    std::vector<double> y(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        x[i] = static_cast<double>(i * 7919) - 1000.0;
+        y[i] = static_cast<double>(static_cast<int>(i % 80) - 8);
+    }
+    x[5] = 1e20;
+
+    std::vector<double> expected(ROWS);
+    std::vector<double> actual(ROWS);
+    for (const char* expr : {"(x & 0xFF) | (y ^ x)", "x << y", "x >> y", "~x ^ (y << 2)"}) {
+        auto ast = parse(expr);
+        CompiledExpression program = CompiledExpression::compile(*ast, context, {"x", "y"});
+        vm.setSimdLevel(SimdLevel::SCALAR);
+        (void)vm.executeBatch(program, {x.data(), y.data()}, ROWS, expected.data());
+
+        vm.setSimdLevel(detectSimdLevel());
+        (void)vm.executeBatch(program, {x.data(), y.data()}, ROWS, actual.data());
+        for (size_t i = 0; i < ROWS; ++i) {
+            EXPECT_EQ(actual[i], expected[i]) << expr << " row " << i;
+        }
+    }
+}
+
+TEST_F(CompiledExpressionTest, SimdBatchSeesReplacedBuiltin) {
+    auto ast = parse("sqrt(x)");
+    CompiledExpression program = CompiledExpression::compile(*ast, context, {"x"});
+    context.addFunction("sqrt", [](const std::vector<double>& args) { return args[0] + 1.0; });
+
+    const std::vector<double> x = {4.0, 9.0};
+    std::vector<double> out(x.size());
+    (void)vm.executeBatch(program, {x.data()}, x.size(), out.data());
+    EXPECT_DOUBLE_EQ(out[0], 5.0);
+    EXPECT_DOUBLE_EQ(out[1], 10.0);
+}
@@ -20,6 +20,7 @@ TEST(ErrorTest, ErrorCodeToString) {
     EXPECT_EQ(errorCodeToString(ErrorCode::INVALID_BASE), "Invalid Base");
     EXPECT_EQ(errorCodeToString(ErrorCode::PARSE_ERROR), "Parse Error");
     EXPECT_EQ(errorCodeToString(ErrorCode::EVALUATION_ERROR), "Evaluation Error");
+    EXPECT_EQ(errorCodeToString(ErrorCode::UNDEFINED_VARIABLE), "Undefined Variable");
     EXPECT_EQ(errorCodeToString(ErrorCode::UNKNOWN_ERROR), "Unknown Error");
 }
 
@@ -146,6 +146,46 @@ TEST_F(EvaluationContextTest, CallFunctionWrongArguments) {
     EXPECT_TRUE(result.isError());
 }
 
+TEST_F(EvaluationContextTest, FixedArityEntriesReportTheExpectedCount) {
+    const FunctionEntry* sin = context->findFunction("sin");
+    ASSERT_NE(sin, nullptr);
+    EXPECT_EQ(sin->arity, FunctionArity::UNARY);
+    EXPECT_EQ(sin->builtin, BuiltinFunction::SIN);
+    EXPECT_TRUE(sin->pure);
+
+    EvaluationResult result = context->callFunction("sin", {1.0, 2.0});
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::EVALUATION_ERROR);
+    EXPECT_EQ(result.getErrorMessage(), "sin requires exactly 1 argument");
+
+    result = context->callFunction("max", {1.0});
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorMessage(), "max requires at least 2 arguments");
+
+    result = context->callFunction("PI", {1.0});
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorMessage(), "PI requires exactly 0 arguments");
+}
+
+TEST_F(EvaluationContextTest, AddTypedFunctions) {
+    context->addFunction("half", [](double x) { return x / 2; }, BuiltinFunction::NONE, true);
+    context->addFunction("diff", [](double a, double b) { return a - b; });
+    context->addVariadicFunction("sum", [](const double* args, size_t count) {
+        double total = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            total += args[i];
+        }
+        return total;
+    }, 1);
+
+    EXPECT_DOUBLE_EQ(context->callFunction("half", {9.0}).getValue(), 4.5);
+    EXPECT_DOUBLE_EQ(context->callFunction("diff", {9.0, 4.0}).getValue(), 5.0);
+    EXPECT_DOUBLE_EQ(context->callFunction("sum", {1.0, 2.0, 3.0}).getValue(), 6.0);
+    EXPECT_TRUE(context->isPureFunction("half"));
+    EXPECT_FALSE(context->isPureFunction("diff"));
+    EXPECT_TRUE(context->callFunction("sum", {}).isError());
+}
+
 TEST_F(EvaluationContextTest, AddCustomFunction) {
     bool called = false;
     context->addFunction("test", [&](const std::vector<double>& args) -> double {
@@ -162,6 +202,85 @@ TEST_F(EvaluationContextTest, AddCustomFunction) {
     EXPECT_TRUE(called);
 }
 
+TEST_F(EvaluationContextTest, BuiltInsAreReplacedInPlace) {
+    const FunctionEntry* sqrt = context->findFunction("sqrt");
+    ASSERT_NE(sqrt, nullptr);
+    EXPECT_TRUE(MathFunctions::isBuiltInFunction("sqrt"));
+    EXPECT_FALSE(MathFunctions::isBuiltInFunction("sqr"));
+
+    context->addFunction("sqrt", [](double x) { return x + 1.0; });
+    EXPECT_EQ(context->findFunction("sqrt"), sqrt);
+    EXPECT_EQ(sqrt->builtin, BuiltinFunction::NONE);
+    EXPECT_DOUBLE_EQ(context->callFunction("sqrt", {4.0}).getValue(), 5.0);
+
+    // Registering again restores the built-in, still in the same entry
+    MathFunctions::registerBuiltInFunctions(*context);
+    EXPECT_EQ(context->findFunction("sqrt"), sqrt);
+    EXPECT_EQ(sqrt->builtin, BuiltinFunction::SQRT);
+    EXPECT_DOUBLE_EQ(context->callFunction("sqrt", {4.0}).getValue(), 2.0);
+}
+
+TEST(EvaluationContextBuiltInTest, OnlyRegisteredContextsHaveBuiltIns) {
+    EvaluationContext empty;
+    EXPECT_FALSE(empty.hasFunction("sin"));
+    EXPECT_EQ(empty.findFunction("PI"), nullptr);
+
+    // A function added under a built-in name before registering is replaced
+    EvaluationContext context;
+    context.addFunction("cos", [](double) { return 7.0; });
+    context.addFunction("twice", [](double x) { return x * 2; });
+    const FunctionEntry* cos = context.findFunction("cos");
+    MathFunctions::registerBuiltInFunctions(context);
+
+    EXPECT_EQ(context.findFunction("cos"), cos);
+    EXPECT_DOUBLE_EQ(context.callFunction("cos", {0.0}).getValue(), 1.0);
+    EXPECT_DOUBLE_EQ(context.callFunction("twice", {3.0}).getValue(), 6.0);
+    EXPECT_NEAR(context.callFunction("PI", {}).getValue(), M_PI, 1e-15);
+
+    // Copies own their functions
+    EvaluationContext copy = context;
+    copy.addFunction("PI", [] { return 3.0; });
+    EXPECT_DOUBLE_EQ(copy.callFunction("PI", {}).getValue(), 3.0);
+    EXPECT_NEAR(context.callFunction("PI", {}).getValue(), M_PI, 1e-15);
+}
+
+TEST_F(EvaluationContextTest, VariableSlotsAreStable) {
+    EXPECT_FALSE(context->hasVariable("x"));
+    EXPECT_EQ(context->findVariableSlot("x"), EvaluationContext::NO_SLOT);
+
+    size_t x = context->setVariable("x", 1.5);
+    size_t y = context->setVariable("y", 2.5);
+    EXPECT_NE(x, y);
+    EXPECT_EQ(context->setVariable("x", 3.0), x);
+    EXPECT_EQ(context->findVariableSlot("x"), x);
+    EXPECT_DOUBLE_EQ(context->getVariable(x), 3.0);
+
+    context->setVariable(y, 4.0);
+    EXPECT_DOUBLE_EQ(context->getVariable(context->findVariableSlot("y")), 4.0);
+}
+
+TEST_F(EvaluationContextTest, BindingRevisionTracksNamesNotValues) {
+    uint64_t revision = context->getBindingRevision();
+    size_t x = context->setVariable("x", 1.0);
+    EXPECT_GT(context->getBindingRevision(), revision);
+
+    revision = context->getBindingRevision();
+    context->setVariable("x", 2.0);
+    context->setVariable(x, 3.0);
+    EXPECT_EQ(context->getBindingRevision(), revision);
+
+    context->addFunction("twice", [](double v) { return 2.0 * v; });
+    EXPECT_GT(context->getBindingRevision(), revision);
+
+    revision = context->getBindingRevision();
+    context->setOperatorSemantics("^", OperatorSemantics::BITWISE_XOR);
+    EXPECT_GT(context->getBindingRevision(), revision);
+
+    revision = context->getBindingRevision();
+    MathFunctions::registerBuiltInFunctions(*context);
+    EXPECT_GT(context->getBindingRevision(), revision);
+}
+
 //=============================================================================
 // EvaluatorVisitor Tests
 //=============================================================================
@@ -349,6 +468,26 @@ TEST_F(EvaluatorVisitorTest, EvaluateNestedFunctionCalls) {
     EXPECT_DOUBLE_EQ(result.getValue(), 4.0);
 }
 
+TEST_F(EvaluatorVisitorTest, EvaluateNestedVariadicCalls) {
+    // max(1, min(5, 4, 6), 3) = 4; the inner call's arguments must not leak
+    // into the outer call's
+    std::vector<std::unique_ptr<ASTNode>> innerArgs;
+    innerArgs.push_back(std::make_unique<LiteralNode>(5.0));
+    innerArgs.push_back(std::make_unique<LiteralNode>(4.0));
+    innerArgs.push_back(std::make_unique<LiteralNode>(6.0));
+
+    std::vector<std::unique_ptr<ASTNode>> outerArgs;
+    outerArgs.push_back(std::make_unique<LiteralNode>(1.0));
+    outerArgs.push_back(std::make_unique<FunctionCallNode>("min", 0, std::move(innerArgs)));
+    outerArgs.push_back(std::make_unique<LiteralNode>(3.0));
+    FunctionCallNode node("max", 0, std::move(outerArgs));
+
+    EvaluationResult result = evaluator->evaluate(&node, *context);
+
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 4.0);
+}
+
 TEST_F(EvaluatorVisitorTest, EvaluateDivisionByZero) {
     Token div(TokenType::OPERATOR, "/", 0);
     BinaryOpNode node(std::make_unique<LiteralNode>(10.0), div,
@@ -403,6 +542,33 @@ TEST_F(EvaluatorVisitorTest, EvaluateUnknownFunction) {
     EXPECT_EQ(result.getErrorCode(), ErrorCode::INVALID_FUNCTION);
 }
 
+TEST_F(EvaluatorVisitorTest, EvaluateVariable) {
+    context->setVariable("x", 7.0);
+    VariableNode node("x", 0);
+
+    EvaluationResult result = evaluator->evaluate(&node, *context);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 7.0);
+}
+
+TEST_F(EvaluatorVisitorTest, EvaluateVariableFallsBackToConstant) {
+    VariableNode node("PI", 0);
+
+    EvaluationResult result = evaluator->evaluate(&node, *context);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), M_PI);
+}
+
+TEST_F(EvaluatorVisitorTest, EvaluateUndefinedVariable) {
+    VariableNode node("rate", 4);
+
+    EvaluationResult result = evaluator->evaluate(&node, *context);
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::UNDEFINED_VARIABLE);
+    EXPECT_EQ(result.getErrorMessage(), "Undefined variable: rate");
+    EXPECT_EQ(result.getErrorPosition(), 4u);
+}
+
 TEST_F(EvaluatorVisitorTest, EvaluateNullNode) {
     EvaluationResult result = evaluator->evaluate(nullptr, *context);
 
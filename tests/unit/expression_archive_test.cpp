@@ -0,0 +1,244 @@
+/**
+ * @file expression_archive_test.cpp
+ * @brief Unit tests for ExpressionArchiveWriter and ExpressionArchive
+ */
+
+#include <gtest/gtest.h>
+#include "calc/core/expression_archive.h"
+#include "calc/core/evaluator.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace calc;
+
+namespace {
+
+std::unique_ptr<ASTNode> parse(const std::string& expr) {
+    Tokenizer tokenizer(expr);
+    auto tokens = tokenizer.tokenize();
+    ShuntingYardParser parser;
+    return parser.parse(tokens);
+}
+
+std::vector<unsigned char> archiveOf(const std::vector<std::string>& exprs) {
+    ExpressionArchiveWriter writer;
+    for (const auto& expr : exprs) {
+        writer.add(*parse(expr), expr);
+    }
+    return writer.serialize();
+}
+
+// Byte offset of the node stream in an archive built by archiveOf()
+size_t nodeSectionOffset(const std::vector<unsigned char>& bytes) {
+    uint32_t counts[5];  // expressions, nodes, constants, strings, string bytes
+    std::memcpy(counts, bytes.data() + 8, sizeof(counts));
+    return 32 + counts[2] * sizeof(double) + counts[0] * 16;
+}
+
+void expectInvalid(std::vector<unsigned char> bytes) {
+    try {
+        (void)ExpressionArchive::fromBuffer(std::move(bytes));
+        FAIL() << "Expected an invalid archive";
+    } catch (const CalculatorException& e) {
+        EXPECT_EQ(e.getErrorCode(), ErrorCode::PARSE_ERROR);
+    }
+}
+
+} // anonymous namespace
+
+class ExpressionArchiveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MathFunctions::registerBuiltInFunctions(context);
+        context.setVariable("x", 0.3);
+        context.setVariable("y", -1.7);
+    }
+
+    // The loaded tree must print and evaluate exactly like the parsed one
+    void expectSameAsParsed(const ExpressionArchive& archive, size_t index,
+                            const std::string& expr) {
+        auto parsed = parse(expr);
+        ParsedExpression loaded = archive.load(index);
+        ASSERT_TRUE(loaded) << expr;
+        EXPECT_EQ(loaded->toString(), parsed->toString()) << expr;
+
+        EvaluationResult expected = evaluator.evaluate(parsed.get(), context);
+        EvaluationResult actual = evaluator.evaluate(loaded.get(), context);
+        ASSERT_EQ(actual.isSuccess(), expected.isSuccess()) << expr;
+        if (expected.isSuccess()) {
+            double a = actual.getValue();
+            double e = expected.getValue();
+            EXPECT_EQ(std::memcmp(&a, &e, sizeof(double)), 0) << expr;
+        } else {
+            EXPECT_EQ(actual.getErrorCode(), expected.getErrorCode()) << expr;
+            EXPECT_EQ(actual.getErrorPosition(), expected.getErrorPosition()) << expr;
+        }
+    }
+
+    EvaluationContext context;
+    EvaluatorVisitor evaluator;
+};
+
+TEST_F(ExpressionArchiveTest, RoundTrip) {
+    const std::vector<std::string> corpus = {
+        "42", "x", "-x ^ 2", "1 + 2 * 3 - 4 / 5 % 3", "sin(2 * PI * x) + cos(2 * PI * y)",
+        "max(1, -x, y, 3.5e10)", "~5 & 3 | 1 << 2 >> 1", "+x * -y", "-0.0 + 0.0",
+        // Errors keep their positions
+        "1 / (x - x)", "sqrt(y)", "  z + 1", "nope(1)", "sin(1, 2)",
+    };
+    ExpressionArchive archive = ExpressionArchive::fromBuffer(archiveOf(corpus));
+
+    ASSERT_EQ(archive.size(), corpus.size());
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        EXPECT_EQ(archive.getSource(i), corpus[i]);
+        expectSameAsParsed(archive, i, corpus[i]);
+    }
+    EXPECT_EQ(archive.getNodeCount(0), 1u);
+    EXPECT_EQ(archive.getNodeCount(2), 4u);
+}
+
+TEST_F(ExpressionArchiveTest, ConstantsAndNamesAreStoredOnce) {
+    ExpressionArchiveWriter one;
+    one.add(*parse("x * 2.5"));
+    ExpressionArchiveWriter many;
+    for (int i = 0; i < 100; ++i) {
+        many.add(*parse("x * 2.5"));
+    }
+    // Each extra expression costs its record and three nodes, nothing more
+    EXPECT_EQ(many.serialize().size() - one.serialize().size(), 99u * (16 + 3 * 16));
+}
+
+TEST_F(ExpressionArchiveTest, SourceIsOptional) {
+    ExpressionArchiveWriter writer;
+    EXPECT_EQ(writer.add(*parse("1 + 2")), 0u);
+    EXPECT_EQ(writer.add(*parse("3"), "3"), 1u);
+    EXPECT_EQ(writer.size(), 2u);
+
+    ExpressionArchive archive = ExpressionArchive::fromBuffer(writer.serialize());
+    EXPECT_TRUE(archive.getSource(0).empty());
+    EXPECT_EQ(archive.getSource(1), "3");
+}
+
+TEST_F(ExpressionArchiveTest, EmptyArchive) {
+    ExpressionArchiveWriter writer;
+    ExpressionArchive archive = ExpressionArchive::fromBuffer(writer.serialize());
+    EXPECT_EQ(archive.size(), 0u);
+    EXPECT_EQ(ExpressionArchive().size(), 0u);
+}
+
+TEST_F(ExpressionArchiveTest, SaveAndOpen) {
+    const std::vector<std::string> corpus = {"sin(x) + 1", "max(x, y) * 2", "x / 0"};
+    ExpressionArchiveWriter writer;
+    for (const auto& expr : corpus) {
+        writer.add(*parse(expr), expr);
+    }
+
+    auto path = std::filesystem::temp_directory_path() / "calc_archive_test.cxa";
+    writer.save(path.string());
+    ExpressionArchive archive = ExpressionArchive::open(path.string());
+    std::filesystem::remove(path);  // The mapping outlives the directory entry
+
+    ASSERT_EQ(archive.size(), corpus.size());
+    ExpressionArchive copy = archive;
+    archive = ExpressionArchive();
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        expectSameAsParsed(copy, i, corpus[i]);
+    }
+}
+
+TEST_F(ExpressionArchiveTest, OpenErrors) {
+    EXPECT_THROW((void)ExpressionArchive::open("/nonexistent/calc/archive.cxa"), CalculatorException);
+
+    auto path = std::filesystem::temp_directory_path() / "calc_archive_empty.cxa";
+    { std::ofstream file(path); }
+    EXPECT_THROW((void)ExpressionArchive::open(path.string()), CalculatorException);
+    std::filesystem::remove(path);
+
+    ExpressionArchiveWriter writer;
+    EXPECT_THROW(writer.save("/nonexistent/calc/archive.cxa"), CalculatorException);
+}
+
+TEST_F(ExpressionArchiveTest, RejectsBadHeaders) {
+    const std::vector<unsigned char> good = archiveOf({"x + 1", "max(2, y)"});
+    (void)ExpressionArchive::fromBuffer(good);
+
+    expectInvalid({});
+    expectInvalid(std::vector<unsigned char>(good.begin(), good.begin() + 16));
+    expectInvalid(std::vector<unsigned char>(good.begin(), good.end() - 1));
+
+    std::vector<unsigned char> trailing = good;
+    trailing.push_back(0);
+    expectInvalid(trailing);
+
+    std::vector<unsigned char> magic = good;
+    magic[0] = 'X';
+    expectInvalid(magic);
+
+    std::vector<unsigned char> version = good;
+    version[4] = 99;
+    expectInvalid(version);
+
+    std::vector<unsigned char> byteOrder = good;
+    std::swap(byteOrder[6], byteOrder[7]);
+    expectInvalid(byteOrder);
+
+    std::vector<unsigned char> nodeCount = good;
+    nodeCount[12] = 1;  // Counts that disagree with the size
+    expectInvalid(nodeCount);
+}
+
+TEST_F(ExpressionArchiveTest, RejectsBadNodesOnLoad) {
+    const std::vector<unsigned char> good = archiveOf({"x + 1"});
+    const size_t nodes = nodeSectionOffset(good);
+
+    // Nodes are x, 1, +: 16 bytes each, kind at +0, opcode at +1, pool or
+    // string index at +4 and argument count at +8
+    const std::vector<std::vector<std::pair<size_t, unsigned char>>> corruptions = {
+        {{nodes + 0, 9}},                     // Unknown kind
+        {{nodes + 4, 7}},                     // Name past the string table
+        {{nodes + 16 + 4, 5}},                // Constant past the pool
+        {{nodes + 32 + 1, 12}},               // NEG is not a binary operator
+        {{nodes + 32, 4}, {nodes + 32 + 8, 3}},  // Call with more arguments than operands
+        {{nodes + 16, 2}},                    // Binary operator with one operand
+        {{nodes + 32, 0}},                    // Three values left, no single root
+    };
+    for (size_t i = 0; i < corruptions.size(); ++i) {
+        std::vector<unsigned char> bytes = good;
+        for (const auto& [offset, value] : corruptions[i]) {
+            bytes[offset] = value;
+        }
+        ExpressionArchive archive = ExpressionArchive::fromBuffer(bytes);
+        EXPECT_THROW((void)archive.load(0), CalculatorException) << "corruption " << i;
+    }
+}
+
+TEST_F(ExpressionArchiveTest, DeepTrees) {
+    constexpr size_t DEPTH = 100000;
+    std::string expr;
+    for (size_t i = 1; i < DEPTH; ++i) {
+        expr += "1+(";
+    }
+    expr += "1" + std::string(DEPTH - 1, ')');
+
+    ExpressionArchive archive = ExpressionArchive::fromBuffer(archiveOf({expr}));
+    ParsedExpression loaded = archive.load(0);
+    EXPECT_EQ(archive.getNodeCount(0), 2 * DEPTH - 1);
+
+    EvaluationResult result = evaluator.evaluate(loaded.get(), context);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), static_cast<double>(DEPTH));
+}
+
+TEST_F(ExpressionArchiveTest, LoadsIntoOneArenaBlock) {
+    ExpressionArchive archive = ExpressionArchive::fromBuffer(
+        archiveOf({"sin(2 * PI * x) + max(x, y, 1, 2, 3) * -y ^ 2"}));
+    ParsedExpression loaded = archive.load(0);
+    ASSERT_NE(loaded.getArena(), nullptr);
+    EXPECT_EQ(loaded.getArena()->getBlockCount(), 1u);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file expression_cache_test.cpp
+ * @brief Unit tests for ExpressionCache
+ */
+
+#include <gtest/gtest.h>
+#include "calc/core/expression_cache.h"
+
+using namespace calc;
+
+namespace {
+
+std::shared_ptr<const ASTNode> literal(double value) {
+    return std::make_shared<LiteralNode>(value);
+}
+
+} // anonymous namespace
+
+class ExpressionCacheTest : public ::testing::Test {
+protected:
+    ExpressionCache cache{2};
+};
+
+TEST_F(ExpressionCacheTest, MissThenHit) {
+    EXPECT_EQ(cache.find("standard", "shunting-yard", "1+2"), nullptr);
+
+    auto ast = literal(3.0);
+    cache.insert("standard", "shunting-yard", "1+2", ast);
+    EXPECT_EQ(cache.find("standard", "shunting-yard", "1+2"), ast);
+
+    CacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.size, 1u);
+    EXPECT_EQ(stats.capacity, 2u);
+}
+
+TEST_F(ExpressionCacheTest, KeyIncludesModeAndParser) {
+    cache.insert("standard", "shunting-yard", "2^3", literal(8.0));
+
+    EXPECT_EQ(cache.find("programmer", "shunting-yard", "2^3"), nullptr);
+    EXPECT_EQ(cache.find("standard", "recursive-descent", "2^3"), nullptr);
+    EXPECT_NE(cache.find("standard", "shunting-yard", "2^3"), nullptr);
+}
+
+TEST_F(ExpressionCacheTest, EvictsLeastRecentlyUsed) {
+    cache.insert("m", "p", "a", literal(1.0));
+    cache.insert("m", "p", "b", literal(2.0));
+    ASSERT_NE(cache.find("m", "p", "a"), nullptr);  // "b" is now least recently used
+
+    cache.insert("m", "p", "c", literal(3.0));
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+    EXPECT_NE(cache.find("m", "p", "a"), nullptr);
+    EXPECT_EQ(cache.find("m", "p", "b"), nullptr);
+    EXPECT_NE(cache.find("m", "p", "c"), nullptr);
+}
+
+TEST_F(ExpressionCacheTest, EvictedTreeOutlivesEntry) {
+    cache.insert("m", "p", "a", literal(1.0));
+    auto held = cache.find("m", "p", "a");
+    cache.clear();
+
+    ASSERT_NE(held, nullptr);
+    EXPECT_DOUBLE_EQ(dynamic_cast<const LiteralNode&>(*held).getValue(), 1.0);
+}
+
+TEST_F(ExpressionCacheTest, ShrinkingCapacityEvicts) {
+    cache.insert("m", "p", "a", literal(1.0));
+    cache.insert("m", "p", "b", literal(2.0));
+
+    cache.setCapacity(1);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_NE(cache.find("m", "p", "b"), nullptr);
+
+    cache.setCapacity(0);
+    EXPECT_EQ(cache.size(), 0u);
+    cache.insert("m", "p", "a", literal(1.0));
+    EXPECT_EQ(cache.find("m", "p", "a"), nullptr);
+}
+
+TEST_F(ExpressionCacheTest, ResetStats) {
+    (void)cache.find("m", "p", "a");
+    cache.resetStats();
+
+    CacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.misses, 0u);
+    EXPECT_EQ(stats.evictions, 0u);
+}
+
+TEST_F(ExpressionCacheTest, EntriesHoldCompiledPrograms) {
+    EvaluationContext context;
+    CachedExpression* entry = cache.insert("m", "p", "a", literal(1.0));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_FALSE(entry->program.has_value());
+    entry->program = CompiledExpression::compile(*entry->ast, context);
+
+    CachedExpression* found = cache.lookup("m", "p", "a");
+    ASSERT_EQ(found, entry);
+    EXPECT_TRUE(found->program.has_value());
+    EXPECT_EQ(cache.getStats().hits, 1u);
+
+    // Replacing the tree drops bytecode compiled from the old one
+    entry = cache.insert("m", "p", "a", literal(2.0));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_FALSE(entry->program.has_value());
+
+    cache.setCapacity(0);
+    EXPECT_EQ(cache.insert("m", "p", "b", literal(3.0)), nullptr);
+    EXPECT_EQ(cache.lookup("m", "p", "b"), nullptr);
+}
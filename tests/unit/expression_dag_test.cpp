@@ -0,0 +1,190 @@
+/**
+ * @file expression_dag_test.cpp
+ * @brief Unit tests for ExpressionDag and compiling from it
+ */
+
+#include <gtest/gtest.h>
+#include "calc/core/expression_dag.h"
+#include "calc/core/compiled_expression.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <cmath>
+#include <cstring>
+
+using namespace calc;
+
+namespace {
+
+std::unique_ptr<ASTNode> parse(const std::string& expr) {
+    Tokenizer tokenizer(expr);
+    auto tokens = tokenizer.tokenize();
+    ShuntingYardParser parser;
+    return parser.parse(tokens);
+}
+
+int impureCalls = 0;
+int pureCalls = 0;
+
+double impureTick() {
+    return static_cast<double>(++impureCalls);
+}
+
+double pureSquare(double x) {
+    ++pureCalls;
+    return x * x;
+}
+
+} // anonymous namespace
+
+class ExpressionDagTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MathFunctions::registerBuiltInFunctions(context);
+        context.setVariable("x", 0.3);
+        context.setVariable("y", -1.7);
+        impureCalls = 0;
+        pureCalls = 0;
+    }
+
+    ExpressionDag build(const std::string& expr) {
+        return ExpressionDag::build(*parse(expr), context);
+    }
+
+    // The DAG program must evaluate exactly like the tree program
+    void expectSameAsTree(const std::string& expr) {
+        auto ast = parse(expr);
+        ExpressionDag dag = ExpressionDag::build(*ast, context);
+        EvaluationResult expected = vm.execute(CompiledExpression::compile(*ast, context));
+        EvaluationResult actual = vm.execute(CompiledExpression::compile(dag, context));
+
+        ASSERT_EQ(actual.isSuccess(), expected.isSuccess()) << "expression: " << expr;
+        if (expected.isSuccess()) {
+            double a = actual.getValue();
+            double e = expected.getValue();
+            EXPECT_EQ(std::memcmp(&a, &e, sizeof(double)), 0) << "expression: " << expr;
+        } else {
+            EXPECT_EQ(actual.getErrorCode(), expected.getErrorCode()) << "expression: " << expr;
+            EXPECT_EQ(actual.getErrorPosition(), expected.getErrorPosition()) << "expression: " << expr;
+        }
+    }
+
+    EvaluationContext context;
+    VirtualMachine vm;
+};
+
+TEST_F(ExpressionDagTest, SharesRepeatedSubexpressions) {
+    ExpressionDag dag = build("sin(2 * PI * x) + sin(2 * PI * x)");
+    const DagStats& stats = dag.getStats();
+
+    // 2, PI, *, x, *, sin once; the second sin(...) is 6 deduplicated nodes
+    EXPECT_EQ(stats.treeNodes, 13u);
+    EXPECT_EQ(stats.dagNodes, 7u);
+    EXPECT_EQ(stats.nodesDeduplicated, 6u);
+    EXPECT_EQ(stats.sharedNodes, 1u);
+
+    const ExpressionDag::Node& root = dag.getNodes()[dag.getRoot()];
+    EXPECT_EQ(root.kind, ExpressionDag::Kind::BINARY);
+    EXPECT_EQ(dag.getOperand(root, 0), dag.getOperand(root, 1));
+}
+
+TEST_F(ExpressionDagTest, OperandsComeFirst) {
+    ExpressionDag dag = build("max(x * y, x * y, -(x * y)) / (x * y)");
+    const auto& nodes = dag.getNodes();
+    for (uint32_t id = 0; id < nodes.size(); ++id) {
+        for (uint32_t i = 0; i < nodes[id].operandCount; ++i) {
+            EXPECT_LT(dag.getOperand(nodes[id], i), id);
+        }
+    }
+    EXPECT_EQ(dag.getStats().sharedNodes, 1u);  // x * y, used by max, neg and /
+}
+
+TEST_F(ExpressionDagTest, DistinctStructureIsKept) {
+    EXPECT_EQ(build("x - y + (y - x)").getStats().nodesDeduplicated, 2u);  // Only x and y
+    EXPECT_EQ(build("x * 2 + x * 2.0").getStats().nodesDeduplicated, 3u);  // Same value, same node
+    EXPECT_EQ(build("2 ^ 3 + 2 ^ 3").getStats().nodesDeduplicated, 3u);
+    EXPECT_EQ(build("max(1, 2) + max(2, 1)").getStats().nodesDeduplicated, 2u);
+}
+
+TEST_F(ExpressionDagTest, ImpureCallsAreNeverMerged) {
+    context.addFunction("tick", &impureTick);
+    ExpressionDag dag = build("tick * 2 + tick * 2 + tick * 2");
+    EXPECT_EQ(dag.getStats().sharedNodes, 1u);  // Only the literal 2
+
+    EvaluationResult result = vm.execute(CompiledExpression::compile(dag, context));
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), (1 + 2 + 3) * 2.0);
+    EXPECT_EQ(impureCalls, 3);
+}
+
+TEST_F(ExpressionDagTest, PureCallsRunOncePerEvaluation) {
+    context.addFunction("sq", &pureSquare, BuiltinFunction::NONE, true);
+    auto ast = parse("sq(x + 1) + sq(x + 1) * sq(x + 1) - sq(x)");
+
+    CompiledExpression tree = CompiledExpression::compile(*ast, context);
+    (void)vm.execute(tree);
+    EXPECT_EQ(pureCalls, 4);
+
+    pureCalls = 0;
+    CompiledExpression shared = CompiledExpression::compile(ExpressionDag::build(*ast, context), context);
+    EvaluationResult result = vm.execute(shared);
+    EXPECT_EQ(pureCalls, 2);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 1.69 + 1.69 * 1.69 - 0.09);
+}
+
+TEST_F(ExpressionDagTest, SameResultsAsTree) {
+    const std::vector<std::string> corpus = {
+        "x", "1 + 2", "sin(2 * PI * x) + sin(2 * PI * x) ^ 2 * cos(2 * PI * x)",
+        "sqrt(x ^ 2 + 1) / (1 + sqrt(x ^ 2 + 1)) + log(sqrt(x ^ 2 + 1))",
+        "max(x, y, x, y) - min(x * y, x * y)", "-(-x) + -(-x)", "+x * +x",
+        "(x + y) * (x + y) * (x + y) * (x + y)", "PI * PI + E",
+        "pow(x, y) + pow(x, y)", "hypot(x, y) / hypot(x, y)",
+        // Errors keep the position of the first occurrence
+        "1 / (x - x) + 1 / (x - x)", "sqrt(y) + sqrt(y)", "z + z", "nope(1) + nope(1)",
+        "sin(1, 2) + sin(1, 2)", "10 ^ 400 * 2 + 10 ^ 400 * 2",
+    };
+    for (const auto& expr : corpus) {
+        expectSameAsTree(expr);
+    }
+}
+
+TEST_F(ExpressionDagTest, BatchMatchesTree) {
+    const std::string expr = "sin(x * y) * sin(x * y) + cos(x * y) * cos(x * y) + 1 / (x - 0.5)";
+    constexpr size_t ROWS = 1000;
+    std::vector<double> x(ROWS);
+    std::vector<double> y(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        x[i] = 0.001 * static_cast<double>(i);
+        y[i] = 3.0 - 0.002 * static_cast<double>(i);
+    }
+
+    auto ast = parse(expr);
+    CompiledExpression tree = CompiledExpression::compile(*ast, context, {"x", "y"});
+    CompiledExpression shared =
+        CompiledExpression::compile(ExpressionDag::build(*ast, context), context, {"x", "y"});
+
+    std::vector<double> expected(ROWS);
+    std::vector<double> actual(ROWS);
+    BatchResult treeResult = vm.executeBatch(tree, {x.data(), y.data()}, ROWS, expected.data());
+    BatchResult dagResult = vm.executeBatch(shared, {x.data(), y.data()}, ROWS, actual.data());
+
+    EXPECT_EQ(dagResult.failedRows, treeResult.failedRows);
+    EXPECT_EQ(dagResult.firstFailedRow, treeResult.firstFailedRow);
+    EXPECT_EQ(std::memcmp(actual.data(), expected.data(), ROWS * sizeof(double)), 0);
+}
+
+TEST_F(ExpressionDagTest, SharedValuesAreCopiedNotRecomputed) {
+    auto ast = parse("(x + y) * (x + y)");
+    CompiledExpression tree = CompiledExpression::compile(*ast, context);
+    CompiledExpression shared = CompiledExpression::compile(ExpressionDag::build(*ast, context), context);
+
+    // x, y, +, save; load, *
+    const auto& code = shared.getInstructions();
+    ASSERT_EQ(code.size(), 6u);
+    EXPECT_EQ(tree.getInstructions().size(), 7u);
+    EXPECT_EQ(code[3].op, BytecodeOp::COPY);
+    EXPECT_EQ(code[4].op, BytecodeOp::COPY);
+    EXPECT_EQ(code[3].a, code[4].b);
+    EXPECT_GE(code[3].a, 2u);  // Above the two operand stack registers
+    EXPECT_EQ(shared.getRegisterCount(), 3u);
+}
@@ -0,0 +1,203 @@
+/**
+ * @file integer_evaluator_test.cpp
+ * @brief Unit tests for IntegerEvaluator and IntegerResult
+ */
+
+#include <gtest/gtest.h>
+#include "calc/core/integer_evaluator.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+
+using namespace calc;
+
+class IntegerEvaluatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MathFunctions::registerBuiltInFunctions(context);
+        context.setVariable("x", 7.0);
+        context.setVariable("half", 0.5);
+        context.setOperatorSemantics("^", OperatorSemantics::BITWISE_XOR);
+    }
+
+    IntegerResult eval(const std::string& expr, WordSize size = WordSize::BITS_64,
+                       bool isSigned = true) {
+        Tokenizer tokenizer(expr);
+        ShuntingYardParser parser;
+        auto ast = parser.parse(tokenizer.tokenize());
+        IntegerEvaluator evaluator(size, isSigned);
+        return evaluator.evaluate(*ast, context);
+    }
+
+    EvaluationContext context;
+};
+
+TEST_F(IntegerEvaluatorTest, Arithmetic) {
+    EXPECT_EQ(eval("1 + 2 * 3").getSigned(), 7);
+    EXPECT_EQ(eval("(0x10 - 0b11) * 0o2").getSigned(), 26);
+    EXPECT_EQ(eval("-7 / 2").getSigned(), -3);
+    EXPECT_EQ(eval("-7 % 2").getSigned(), -1);
+    EXPECT_EQ(eval("x * x").getSigned(), 49);
+    EXPECT_EQ(eval("max(3, x, 5)").getSigned(), 7);
+}
+
+TEST_F(IntegerEvaluatorTest, WrapsAtWordSize) {
+    EXPECT_EQ(eval("127 + 1", WordSize::BITS_8).getSigned(), -128);
+    EXPECT_EQ(eval("255 + 1", WordSize::BITS_8, false).getUnsigned(), 0u);
+    EXPECT_EQ(eval("0x7FFF + 1", WordSize::BITS_16).getSigned(), -32768);
+    EXPECT_EQ(eval("0 - 1", WordSize::BITS_32, false).getUnsigned(), 0xFFFFFFFFu);
+    EXPECT_EQ(eval("0x7FFFFFFFFFFFFFFF + 1").getSigned(), std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(eval("65536 * 65536", WordSize::BITS_32).getSigned(), 0);
+    EXPECT_EQ(eval("300", WordSize::BITS_8).getBits(), 44u);
+}
+
+TEST_F(IntegerEvaluatorTest, ExactLiterals) {
+    EXPECT_EQ(eval("0xFFFFFFFFFFFFFFFF", WordSize::BITS_64, false).getUnsigned(),
+              0xFFFFFFFFFFFFFFFFull);
+    EXPECT_EQ(eval("0xFFFFFFFFFFFFFFFF").getSigned(), -1);
+    EXPECT_EQ(eval("9007199254740993").getSigned(), 9007199254740993ll);  // 2^53 + 1
+    EXPECT_EQ(eval("9007199254740993 - 9007199254740992").getSigned(), 1);
+    EXPECT_EQ(eval("0x8000000000000001 & 0xF").getSigned(), 1);
+}
+
+TEST_F(IntegerEvaluatorTest, SignedAndUnsignedDisagree) {
+    // 0xF0 is -16 signed and 240 unsigned in 8 bits
+    EXPECT_EQ(eval("0xF0 / 2", WordSize::BITS_8).getSigned(), -8);
+    EXPECT_EQ(eval("0xF0 / 2", WordSize::BITS_8, false).getUnsigned(), 120u);
+    EXPECT_EQ(eval("0xF0 % 7", WordSize::BITS_8).getSigned(), -2);
+    EXPECT_EQ(eval("0xF0 % 7", WordSize::BITS_8, false).getUnsigned(), 2u);
+    EXPECT_EQ(eval("0xF0 >> 2", WordSize::BITS_8).getBits(), 0xFCu);
+    EXPECT_EQ(eval("0xF0 >> 2", WordSize::BITS_8, false).getBits(), 0x3Cu);
+}
+
+TEST_F(IntegerEvaluatorTest, MinimumDividedByMinusOne) {
+    EXPECT_EQ(eval("-128 / -1", WordSize::BITS_8).getSigned(), -128);
+    EXPECT_EQ(eval("-128 % -1", WordSize::BITS_8).getSigned(), 0);
+    EXPECT_EQ(eval("0x8000000000000000 / -1").getSigned(), std::numeric_limits<int64_t>::min());
+}
+
+TEST_F(IntegerEvaluatorTest, Shifts) {
+    EXPECT_EQ(eval("1 << 7", WordSize::BITS_8).getSigned(), -128);
+    EXPECT_EQ(eval("1 << 8", WordSize::BITS_8).getSigned(), 0);
+    EXPECT_EQ(eval("1 << 63").getBits(), 0x8000000000000000ull);
+    EXPECT_EQ(eval("1 << 64").getBits(), 0u);
+    EXPECT_EQ(eval("-1 >> 100").getSigned(), -1);
+    EXPECT_EQ(eval("-1 >> 100", WordSize::BITS_64, false).getBits(), 0u);
+
+    IntegerResult negative = eval("1 << -1");
+    ASSERT_TRUE(negative.isError());
+    EXPECT_EQ(negative.getErrorCode(), ErrorCode::DOMAIN_ERROR);
+    // Unsigned, -1 is a huge count rather than a negative one
+    EXPECT_EQ(eval("1 << -1", WordSize::BITS_64, false).getBits(), 0u);
+}
+
+TEST_F(IntegerEvaluatorTest, BitwiseOperators) {
+    EXPECT_EQ(eval("0b1100 & 0b1010").getSigned(), 8);
+    EXPECT_EQ(eval("0b1100 | 0b1010").getSigned(), 14);
+    EXPECT_EQ(eval("0b1100 ^ 0b1010").getSigned(), 6);
+    EXPECT_EQ(eval("~5").getSigned(), -6);
+    EXPECT_EQ(eval("~0", WordSize::BITS_16, false).getUnsigned(), 0xFFFFu);
+}
+
+TEST_F(IntegerEvaluatorTest, PowerWithoutXorSemantics) {
+    context.setOperatorSemantics("^", OperatorSemantics::POWER);
+    EXPECT_EQ(eval("2 ^ 10").getSigned(), 1024);
+    EXPECT_EQ(eval("3 ^ 40").getBits(), 12157665459056928801ull);  // Exact past 2^53
+    EXPECT_EQ(eval("2 ^ 8", WordSize::BITS_8).getSigned(), 0);
+    EXPECT_EQ(eval("2 ^ -1").getSigned(), 0);
+    EXPECT_EQ(eval("-1 ^ -3").getSigned(), -1);
+    EXPECT_EQ(eval("1 ^ -2").getSigned(), 1);
+
+    IntegerResult zero = eval("0 ^ -1");
+    ASSERT_TRUE(zero.isError());
+    EXPECT_EQ(zero.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+}
+
+TEST_F(IntegerEvaluatorTest, Errors) {
+    IntegerResult division = eval("1 / (x - 7)");
+    ASSERT_TRUE(division.isError());
+    EXPECT_EQ(division.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+
+    IntegerResult modulo = eval("1 % 0");
+    ASSERT_TRUE(modulo.isError());
+    EXPECT_EQ(modulo.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+
+    IntegerResult undefined = eval("1 + y");
+    ASSERT_TRUE(undefined.isError());
+    EXPECT_EQ(undefined.getErrorCode(), ErrorCode::UNDEFINED_VARIABLE);
+    EXPECT_EQ(undefined.getErrorPosition(), 4u);
+
+    EXPECT_EQ(eval("1.5 + 1").getErrorCode(), ErrorCode::DOMAIN_ERROR);
+    EXPECT_EQ(eval("half * 2").getErrorCode(), ErrorCode::DOMAIN_ERROR);
+    EXPECT_EQ(eval("PI").getErrorCode(), ErrorCode::DOMAIN_ERROR);
+    EXPECT_EQ(eval("sqrt(2)").getErrorCode(), ErrorCode::DOMAIN_ERROR);
+    EXPECT_EQ(eval("sqrt(-4)").getErrorCode(), ErrorCode::DOMAIN_ERROR);
+    EXPECT_EQ(eval("nope(1)").getErrorCode(), ErrorCode::INVALID_FUNCTION);
+}
+
+TEST_F(IntegerEvaluatorTest, FunctionsSeeSignedness) {
+    EXPECT_EQ(eval("abs(0xFF)", WordSize::BITS_8).getSigned(), 1);
+    EXPECT_EQ(eval("abs(0xFF)", WordSize::BITS_8, false).getUnsigned(), 255u);
+}
+
+TEST_F(IntegerEvaluatorTest, EvaluatorIsReusable) {
+    Tokenizer tokenizer("0xFF + 1");
+    ShuntingYardParser parser;
+    auto ast = parser.parse(tokenizer.tokenize());
+
+    IntegerEvaluator evaluator;
+    EXPECT_EQ(evaluator.getWordSize(), WordSize::BITS_64);
+    EXPECT_TRUE(evaluator.isSigned());
+    EXPECT_EQ(evaluator.evaluate(*ast, context).getSigned(), 256);
+
+    evaluator.setWordSize(WordSize::BITS_8);
+    evaluator.setSigned(false);
+    EXPECT_EQ(evaluator.evaluate(*ast, context).getUnsigned(), 0u);
+
+    Tokenizer bad("1 / 0");
+    auto failing = parser.parse(bad.tokenize());
+    EXPECT_TRUE(evaluator.evaluate(*failing, context).isError());
+    EXPECT_TRUE(evaluator.evaluate(*ast, context).isSuccess());
+}
+
+TEST_F(IntegerEvaluatorTest, DeepTrees) {
+    constexpr int DEPTH = 100000;
+    std::string expr;
+    for (int i = 1; i < DEPTH; ++i) {
+        expr += "1+(";
+    }
+    expr += "1" + std::string(DEPTH - 1, ')');
+    EXPECT_EQ(eval(expr, WordSize::BITS_16, false).getUnsigned(), static_cast<uint64_t>(DEPTH) & 0xFFFF);
+}
+
+TEST(IntegerResultTest, Accessors) {
+    IntegerResult result(0x1FF, WordSize::BITS_8, true);
+    EXPECT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.getBits(), 0xFFu);
+    EXPECT_EQ(result.getSigned(), -1);
+    EXPECT_EQ(result.getUnsigned(), 255u);
+    EXPECT_EQ(result.getValue(), -1);
+    EXPECT_EQ(result.getWordSize(), WordSize::BITS_8);
+    EXPECT_THROW((void)result.getErrorCode(), std::runtime_error);
+    EXPECT_THROW((void)result.getErrorMessage(), std::runtime_error);
+    EXPECT_DOUBLE_EQ(result.toEvaluationResult().getValue(), -1.0);
+
+    IntegerResult unsignedResult(0xFF, WordSize::BITS_8, false);
+    EXPECT_EQ(unsignedResult.getValue(), 255);
+    EXPECT_DOUBLE_EQ(unsignedResult.toEvaluationResult().getValue(), 255.0);
+
+    IntegerResult error(ErrorCode::DIVISION_BY_ZERO, "Division by zero", 3);
+    EXPECT_TRUE(error.isError());
+    EXPECT_EQ(error.getErrorPosition(), 3u);
+    EXPECT_TRUE(error.toEvaluationResult().isError());
+    EXPECT_EQ(error.toEvaluationResult().getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+}
+
+TEST(IntegerResultTest, WordMask) {
+    EXPECT_EQ(wordMask(WordSize::BITS_8), 0xFFu);
+    EXPECT_EQ(wordMask(WordSize::BITS_16), 0xFFFFu);
+    EXPECT_EQ(wordMask(WordSize::BITS_32), 0xFFFFFFFFu);
+    EXPECT_EQ(wordMask(WordSize::BITS_64), ~uint64_t{0});
+}
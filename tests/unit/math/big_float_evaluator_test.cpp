@@ -0,0 +1,144 @@
+/**
+ * @file big_float_evaluator_test.cpp
+ * @brief Unit tests for BigFloatEvaluator and BigFloatResult
+ */
+
+#include <gtest/gtest.h>
+#include "calc/math/big_float_evaluator.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <stdexcept>
+#include <string>
+
+using namespace calc;
+
+class BigFloatEvaluatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MathFunctions::registerBuiltInFunctions(context);
+        context.setVariable("x", 0.5);
+        context.setOperatorSemantics("^", OperatorSemantics::POWER);
+    }
+
+    BigFloatResult eval(const std::string& expr, size_t digits = 50, bool keepDigits = true) {
+        Tokenizer tokenizer(expr);
+        ShuntingYardParser parser;
+        parser.setKeepLiteralDigits(keepDigits);
+        auto ast = parser.parse(tokenizer.tokenize());
+        BigFloatEvaluator evaluator(BigFloat::precisionForDigits(digits) + 16);
+        return evaluator.evaluate(*ast, context);
+    }
+
+    std::string evalString(const std::string& expr, size_t digits = 50) {
+        BigFloatResult result = eval(expr, digits);
+        if (result.isError()) {
+            return "error: " + result.getErrorMessage();
+        }
+        return result.getValue().toString(digits);
+    }
+
+    EvaluationContext context;
+};
+
+TEST_F(BigFloatEvaluatorTest, Arithmetic) {
+    EXPECT_EQ(evalString("1 + 2 * 3"), "7");
+    EXPECT_EQ(evalString("0.1 + 0.2"), "0.3");
+    EXPECT_EQ(evalString("1 / 3"), "0." + std::string(50, '3'));
+    EXPECT_EQ(evalString("-7 % 2"), "-1");
+    EXPECT_EQ(evalString("7.5 % 2"), "1.5");
+    EXPECT_EQ(evalString("x * 3"), "1.5");
+    EXPECT_EQ(evalString("2 ^ 10"), "1024");
+    EXPECT_EQ(evalString("2 ^ 0.5"), "1.4142135623730950488016887242096980785696718753769");
+}
+
+TEST_F(BigFloatEvaluatorTest, LiteralsKeepTheirDigits) {
+    // Read from the digits, 0.1 * 3 is exactly 0.3 to every digit shown
+    EXPECT_EQ(evalString("0.1 * 3", 40), "0.3");
+
+    // Read through the double, the error of 0.1 shows past the 17th digit
+    BigFloatResult viaDouble = eval("0.1 * 3", 40, false);
+    ASSERT_TRUE(viaDouble.isSuccess());
+    EXPECT_EQ(viaDouble.getValue().toString(40), "0.3000000000000000166533453693773481063545");
+
+    EXPECT_EQ(evalString("123456789012345678901234567890 + 1", 40), "123456789012345678901234567891");
+}
+
+TEST_F(BigFloatEvaluatorTest, Functions) {
+    EXPECT_EQ(evalString("sqrt(2)", 30), "1.41421356237309504880168872421");
+    EXPECT_EQ(evalString("exp(1)", 30), "2.71828182845904523536028747135");
+    EXPECT_EQ(evalString("log(10)", 30), "2.30258509299404568401799145468");
+    EXPECT_EQ(evalString("log10(1000)"), "3");
+    EXPECT_EQ(evalString("sin(1)", 30), "0.84147098480789650665250232163");
+    EXPECT_EQ(evalString("4 * atan(1)", 30), "3.14159265358979323846264338328");
+    EXPECT_EQ(evalString("hypot(3, 4)"), "5");
+    EXPECT_EQ(evalString("max(0.1, 0.3, 0.2)"), "0.3");
+    EXPECT_EQ(evalString("min(0.1, 0.3, 0.2)"), "0.1");
+    EXPECT_EQ(evalString("floor(-2.5) + ceil(2.1) + round(2.5) + trunc(-1.9)"), "2");
+    EXPECT_EQ(evalString("remainder(7, 2)"), "-1");
+}
+
+TEST_F(BigFloatEvaluatorTest, PrecisionIsHonoured) {
+    const std::string digits = evalString("1 / 7", 1000);
+    ASSERT_EQ(digits.size(), 1002u);
+    EXPECT_EQ(digits.substr(0, 14), "0.142857142857");
+    EXPECT_EQ(digits.substr(digits.size() - 6), "571429");  // ...1428|57 rounds up
+}
+
+TEST_F(BigFloatEvaluatorTest, Bitwise) {
+    context.setOperatorSemantics("^", OperatorSemantics::BITWISE_XOR);
+    EXPECT_EQ(evalString("6 ^ 3"), "5");
+    EXPECT_EQ(evalString("6.9 & 3"), "2");
+    EXPECT_EQ(evalString("1 << 100", 40), "1267650600228229401496703205376");
+    EXPECT_EQ(evalString("-1 >> 100"), "-1");
+}
+
+TEST_F(BigFloatEvaluatorTest, Errors) {
+    BigFloatResult division = eval("1 / (x - 0.5)");
+    ASSERT_TRUE(division.isError());
+    EXPECT_EQ(division.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+
+    BigFloatResult modulo = eval("1 % 0");
+    ASSERT_TRUE(modulo.isError());
+    EXPECT_EQ(modulo.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+
+    BigFloatResult root = eval("sqrt(-1)");
+    ASSERT_TRUE(root.isError());
+    EXPECT_EQ(root.getErrorCode(), ErrorCode::DOMAIN_ERROR);
+
+    BigFloatResult logarithm = eval("log(0)");
+    ASSERT_TRUE(logarithm.isError());
+    EXPECT_EQ(logarithm.getErrorCode(), ErrorCode::DOMAIN_ERROR);
+
+    BigFloatResult undefined = eval("y + 1");
+    ASSERT_TRUE(undefined.isError());
+    EXPECT_EQ(undefined.getErrorCode(), ErrorCode::UNDEFINED_VARIABLE);
+
+    BigFloatResult arity = eval("sqrt(1, 2)");
+    ASSERT_TRUE(arity.isError());
+
+    EXPECT_THROW(division.getValue(), std::runtime_error);
+    EXPECT_THROW(BigFloatEvaluator(BigFloatEvaluator::MAX_PRECISION + 1), std::invalid_argument);
+    EXPECT_THROW(BigFloatEvaluator(1), std::invalid_argument);
+}
+
+TEST_F(BigFloatEvaluatorTest, ResultsBeyondTheOrderLimitOverflow) {
+    for (const char* expr : {"10 ^ 100000", "exp(1000000)", "1 << 100000", "(2 ^ 40000) * (2 ^ 40000)"}) {
+        BigFloatResult result = eval(expr);
+        ASSERT_TRUE(result.isError()) << expr;
+        EXPECT_EQ(result.getErrorCode(), ErrorCode::NUMERIC_OVERFLOW) << expr;
+    }
+    EXPECT_EQ(evalString("exp(-1000000)"), "0");
+}
+
+TEST_F(BigFloatEvaluatorTest, ToEvaluationResult) {
+    EvaluationResult small = eval("0.1 + 0.2").toEvaluationResult();
+    ASSERT_TRUE(small.isSuccess());
+    EXPECT_EQ(small.getValue(), 0.3);
+
+    EvaluationResult huge = eval("10 ^ 400").toEvaluationResult();
+    ASSERT_TRUE(huge.isError());
+    EXPECT_EQ(huge.getErrorCode(), ErrorCode::NUMERIC_OVERFLOW);
+
+    BigFloatResult result = eval("1", 20);
+    EXPECT_EQ(result.getPrecision(), BigFloat::precisionForDigits(20) + 16);
+}
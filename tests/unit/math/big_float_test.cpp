@@ -0,0 +1,259 @@
+/**
+ * @file big_float_test.cpp
+ * @brief Unit tests for arbitrary-precision floating point
+ */
+
+#include "calc/math/big_float.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace calc {
+
+namespace {
+
+const std::string PI_100 =
+    "3.141592653589793238462643383279502884197169399375105820974944592307816406286208998628034825342117068";
+const std::string E_100 =
+    "2.718281828459045235360287471352662497757247093699959574966967627724076630353547594571382178525166427";
+const std::string SQRT2_100 =
+    "1.414213562373095048801688724209698078569671875376948073176679737990732478462107038850387534327641573";
+const std::string LN2_100 =
+    "0.6931471805599453094172321214581765680755001343602552541206800094933936219696947156058633269964186875";
+
+} // anonymous namespace
+
+// ============================================================================
+// Test fixture for BigFloat tests
+// ============================================================================
+
+class BigFloatTest : public ::testing::Test {
+protected:
+    const size_t bits = BigFloat::precisionForDigits(100) + 16;
+
+    BigFloat decimal(const std::string& text) const {
+        return BigFloat::fromString(text, bits);
+    }
+
+    static BigFloat integer(int64_t value) {
+        return BigFloat(BigInteger(value));
+    }
+};
+
+// ============================================================================
+// Conversion Tests
+// ============================================================================
+
+TEST_F(BigFloatTest, ExactValues) {
+    EXPECT_TRUE(BigFloat().isZero());
+    EXPECT_EQ(integer(12).getMantissa(), BigInteger(3));
+    EXPECT_EQ(integer(12).getExponent(), 2);
+    EXPECT_EQ(integer(12).order(), 4);
+    EXPECT_EQ(BigFloat::fromDouble(0.375).toString(10), "0.375");
+    EXPECT_EQ(BigFloat::fromDouble(-0.375).getExponent(), -3);
+    EXPECT_THROW(BigFloat::fromDouble(std::numeric_limits<double>::infinity()), std::invalid_argument);
+    EXPECT_THROW(BigFloat::fromDouble(std::nan("")), std::invalid_argument);
+}
+
+TEST_F(BigFloatTest, ReadsDecimalDigits) {
+    EXPECT_EQ(decimal("0.1").toString(100), "0.1");
+    EXPECT_EQ(decimal("-12.5e-3").toString(10), "-0.0125");
+    EXPECT_EQ(decimal("1e50").toString(60), "100000000000000000000000000000000000000000000000000");
+    EXPECT_EQ(decimal(".5").toString(10), "0.5");
+    EXPECT_NE(decimal("0.1"), BigFloat::fromDouble(0.1));
+    EXPECT_THROW(decimal(""), std::invalid_argument);
+    EXPECT_THROW(decimal("1.2.3"), std::invalid_argument);
+    EXPECT_THROW(decimal("e5"), std::invalid_argument);
+    EXPECT_THROW(decimal("1e9999999"), std::out_of_range);
+}
+
+TEST_F(BigFloatTest, ReadingRoundsCorrectly) {
+    // 2^53 + 1 rounds to even at 53 bits, 2^53 + 3 up
+    EXPECT_EQ(BigFloat::fromString("9007199254740993", 53).toDouble(), 9007199254740992.0);
+    EXPECT_EQ(BigFloat::fromString("9007199254740995", 53).toDouble(), 9007199254740996.0);
+
+    // Reading at 53 bits agrees with strtod
+    std::mt19937_64 random(20240702);
+    for (int i = 0; i < 200; ++i) {
+        std::string text = std::to_string(random() % 1000000000) + "." +
+                           std::to_string(random() % 1000000000) + "e" +
+                           std::to_string(static_cast<int>(random() % 600) - 300);
+        EXPECT_EQ(BigFloat::fromString(text, 53).toDouble(), std::strtod(text.c_str(), nullptr)) << text;
+    }
+}
+
+TEST_F(BigFloatTest, WritesDigits) {
+    EXPECT_EQ(BigFloat().toString(10), "0");
+    EXPECT_EQ(integer(-42).toString(10), "-42");
+    EXPECT_EQ(integer(123456).toString(3), "1.23e+05");
+    EXPECT_EQ(decimal("0.00001").toString(10), "0.00001");
+    EXPECT_EQ(decimal("0.000001").toString(10), "1e-06");
+    EXPECT_EQ(decimal("2.5").toString(1), "2");   // Ties to even
+    EXPECT_EQ(decimal("3.5").toString(1), "4");
+    EXPECT_EQ(decimal("9.96").toString(2), "10");
+    EXPECT_EQ(decimal("1.5e300").toString(10), "1.5e+300");
+}
+
+TEST_F(BigFloatTest, ToDouble) {
+    EXPECT_EQ(decimal("0.1").toDouble(), 0.1);
+    EXPECT_EQ(decimal("-2.5").toDouble(), -2.5);
+    EXPECT_EQ(decimal("4.9406564584124654e-324").toDouble(), std::numeric_limits<double>::denorm_min());
+    EXPECT_TRUE(std::isinf(decimal("1e400").toDouble()));
+    EXPECT_EQ(decimal("1e-400").toDouble(), 0.0);
+}
+
+// ============================================================================
+// Arithmetic Tests
+// ============================================================================
+
+TEST_F(BigFloatTest, ExactArithmetic) {
+    EXPECT_EQ(decimal("0.5") + decimal("0.25"), decimal("0.75"));
+    EXPECT_EQ(decimal("0.5") - decimal("0.75"), decimal("-0.25"));
+    EXPECT_EQ(decimal("1.5") * decimal("-2.5"), decimal("-3.75"));
+    EXPECT_TRUE((integer(7) - integer(7)).isZero());
+}
+
+TEST_F(BigFloatTest, RoundedArithmetic) {
+    EXPECT_EQ(BigFloat::add(decimal("0.1"), decimal("0.2"), bits).toString(100), "0.3");
+    EXPECT_EQ(BigFloat::divide(integer(1), integer(3), bits).toString(100),
+              "0." + std::string(100, '3'));
+    EXPECT_EQ(BigFloat::divide(integer(2), integer(3), bits).toString(20), "0.66666666666666666667");
+    EXPECT_EQ(BigFloat::multiply(decimal("1.1"), decimal("1.1"), bits).toString(100), "1.21");
+    EXPECT_THROW(BigFloat::divide(integer(1), BigFloat(), bits), std::domain_error);
+
+    // A tiny addend is not lost before rounding: 1 + 2^-200 rounds up at 2 bits only with it
+    BigFloat tiny(BigInteger(1), -200);
+    EXPECT_EQ(BigFloat::add(integer(1), tiny, 2), integer(1));
+    EXPECT_EQ(BigFloat::add(decimal("1.25"), tiny, 2), decimal("1.5"));
+}
+
+TEST_F(BigFloatTest, RoundedArithmeticMatchesDouble) {
+    std::mt19937_64 random(20240703);
+    std::uniform_real_distribution<double> values(-1e6, 1e6);
+    for (int i = 0; i < 500; ++i) {
+        double a = values(random);
+        double b = values(random);
+        BigFloat x = BigFloat::fromDouble(a);
+        BigFloat y = BigFloat::fromDouble(b);
+        EXPECT_EQ(BigFloat::add(x, y, 53).toDouble(), a + b);
+        EXPECT_EQ(BigFloat::subtract(x, y, 53).toDouble(), a - b);
+        EXPECT_EQ(BigFloat::multiply(x, y, 53).toDouble(), a * b);
+        EXPECT_EQ(BigFloat::divide(x, y, 53).toDouble(), a / b);
+        EXPECT_EQ(BigFloat::sqrt(x.abs(), 53).toDouble(), std::sqrt(std::fabs(a)));
+    }
+}
+
+TEST_F(BigFloatTest, Roots) {
+    EXPECT_EQ(BigFloat::sqrt(integer(2), bits).toString(100), SQRT2_100);
+    EXPECT_EQ(BigFloat::sqrt(decimal("0.0625"), bits).toString(100), "0.25");
+    EXPECT_EQ(BigFloat::cbrt(integer(-27), bits).toString(100), "-3");
+    EXPECT_EQ(BigFloat::cbrt(integer(2), bits).toString(30), "1.25992104989487316476721060728");
+    EXPECT_THROW(BigFloat::sqrt(integer(-1), bits), std::domain_error);
+}
+
+TEST_F(BigFloatTest, Rounding) {
+    EXPECT_EQ(decimal("-2.5").trunc(), integer(-2));
+    EXPECT_EQ(decimal("-2.5").floor(), integer(-3));
+    EXPECT_EQ(decimal("-2.5").ceil(), integer(-2));
+    EXPECT_EQ(decimal("-2.5").round(), integer(-3));  // Half away from zero, as std::round
+    EXPECT_EQ(decimal("2.4").round(), integer(2));
+    EXPECT_EQ(decimal("7.75").toInteger(), BigInteger(7));
+    EXPECT_EQ(integer(1023).roundToPrecision(4), integer(1024));
+    EXPECT_EQ(integer(3).scaled(-2), decimal("0.75"));
+}
+
+TEST_F(BigFloatTest, Remainders) {
+    EXPECT_EQ(BigFloat::fmod(decimal("7.5"), integer(2)), decimal("1.5"));
+    EXPECT_EQ(BigFloat::fmod(decimal("-7.5"), integer(2)), decimal("-1.5"));
+    EXPECT_EQ(BigFloat::remainder(decimal("7.5"), integer(2)), decimal("-0.5"));
+    EXPECT_EQ(BigFloat::remainder(integer(5), integer(2)), integer(1));   // 2.5 ties to 2
+    EXPECT_EQ(BigFloat::remainder(integer(7), integer(2)), integer(-1));  // 3.5 ties to 4
+    EXPECT_THROW(BigFloat::fmod(integer(1), BigFloat()), std::domain_error);
+}
+
+TEST_F(BigFloatTest, Comparison) {
+    EXPECT_LT(decimal("-1"), decimal("-0.5"));
+    EXPECT_LT(decimal("0.1"), decimal("0.10000000000000000001"));
+    EXPECT_GT(decimal("1e10"), decimal("9999999999.9"));
+    EXPECT_EQ(BigFloat::compare(BigFloat(), -BigFloat()), 0);
+}
+
+// ============================================================================
+// Function Tests
+// ============================================================================
+
+TEST_F(BigFloatTest, Constants) {
+    EXPECT_EQ(BigFloatFunctions::pi(bits).toString(100), PI_100);
+    EXPECT_EQ(BigFloatFunctions::e(bits).toString(100), E_100);
+    EXPECT_EQ(BigFloatFunctions::ln2(bits).toString(100), LN2_100);
+
+    // Cached at a higher precision, then rounded down
+    EXPECT_EQ(BigFloatFunctions::pi(BigFloat::precisionForDigits(20)).toString(20), "3.1415926535897932385");
+}
+
+TEST_F(BigFloatTest, ExpAndLog) {
+    EXPECT_EQ(BigFloatFunctions::exp(integer(1), bits).toString(100), E_100);
+    EXPECT_EQ(BigFloatFunctions::exp(BigFloat(), bits), integer(1));
+    EXPECT_EQ(BigFloatFunctions::log(integer(2), bits).toString(100), LN2_100);
+    EXPECT_EQ(BigFloatFunctions::log(integer(10), bits).toString(50),
+              "2.3025850929940456840179914546843642076011014886288");
+    EXPECT_EQ(BigFloatFunctions::log10(decimal("1e-30"), bits), integer(-30));
+    EXPECT_EQ(BigFloatFunctions::log(BigFloatFunctions::exp(decimal("-3.25"), bits), bits).toString(90),
+              "-3.25");
+    EXPECT_THROW(BigFloatFunctions::log(BigFloat(), bits), std::domain_error);
+    EXPECT_THROW(BigFloatFunctions::log(integer(-1), bits), std::domain_error);
+    EXPECT_THROW(BigFloatFunctions::exp(decimal("1e10"), bits), std::overflow_error);
+}
+
+TEST_F(BigFloatTest, Trigonometry) {
+    EXPECT_EQ(BigFloatFunctions::sin(integer(1), bits).toString(50),
+              "0.84147098480789650665250232163029899962256306079837");
+    EXPECT_EQ(BigFloatFunctions::cos(integer(1), bits).toString(50),
+              "0.54030230586813971740093660744297660373231042061792");
+    EXPECT_EQ(BigFloatFunctions::tan(integer(1), bits).toString(50),
+              "1.5574077246549022305069748074583601730872507723815");
+    EXPECT_TRUE(BigFloatFunctions::sin(BigFloat(), bits).isZero());
+
+    // Argument reduction keeps every digit, however large the argument
+    EXPECT_EQ(BigFloatFunctions::sin(decimal("1e22"), bits).toString(30),
+              "-0.852200849767188801772705893753");
+
+    BigFloat quarter = BigFloatFunctions::pi(bits).scaled(-2);
+    EXPECT_EQ(BigFloatFunctions::atan(integer(1), bits).toString(100), quarter.toString(100));
+    EXPECT_EQ(BigFloatFunctions::asin(integer(1), bits).toString(100), quarter.scaled(1).toString(100));
+    EXPECT_EQ(BigFloatFunctions::acos(integer(-1), bits).toString(100), PI_100);
+    EXPECT_THROW(BigFloatFunctions::asin(decimal("1.0000001"), bits), std::domain_error);
+}
+
+TEST_F(BigFloatTest, Hyperbolic) {
+    EXPECT_EQ(BigFloatFunctions::sinh(integer(1), bits).toString(40),
+              "1.175201193643801456882381850595600815156");
+    EXPECT_EQ(BigFloatFunctions::cosh(integer(1), bits).toString(40),
+              "1.543080634815243778477905620757061682602");
+    EXPECT_EQ(BigFloatFunctions::tanh(integer(1), bits).toString(40),
+              "0.7615941559557648881194582826047935904128");
+    EXPECT_EQ(BigFloatFunctions::tanh(integer(100000), bits), integer(1));
+}
+
+TEST_F(BigFloatTest, PowAndHypot) {
+    EXPECT_EQ(BigFloatFunctions::pow(integer(2), integer(100), bits).toString(40),
+              "1267650600228229401496703205376");
+    EXPECT_EQ(BigFloatFunctions::pow(integer(2), decimal("0.5"), bits).toString(100), SQRT2_100);
+    EXPECT_EQ(BigFloatFunctions::pow(decimal("1.1"), integer(-2), bits).toString(30),
+              "0.826446280991735537190082644628");
+    EXPECT_EQ(BigFloatFunctions::pow(integer(-8), integer(3), bits), integer(-512));
+    EXPECT_THROW(BigFloatFunctions::pow(integer(-8), decimal("0.5"), bits), std::domain_error);
+    EXPECT_EQ(BigFloatFunctions::hypot(integer(3), integer(4), bits), integer(5));
+}
+
+TEST_F(BigFloatTest, PrecisionForDigits) {
+    EXPECT_GE(BigFloat::precisionForDigits(1), BigFloat::MIN_PRECISION);
+    EXPECT_GE(BigFloat::precisionForDigits(15), 50u);
+    EXPECT_LE(BigFloat::precisionForDigits(15), 53u);
+    EXPECT_GE(BigFloat::precisionForDigits(1000), 3322u);
+}
+
+} // namespace calc
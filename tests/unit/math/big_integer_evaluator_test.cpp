@@ -0,0 +1,148 @@
+/**
+ * @file big_integer_evaluator_test.cpp
+ * @brief Unit tests for BigIntegerEvaluator and BigIntegerResult
+ */
+
+#include <gtest/gtest.h>
+#include "calc/math/big_integer_evaluator.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <stdexcept>
+#include <string>
+
+using namespace calc;
+
+class BigIntegerEvaluatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MathFunctions::registerBuiltInFunctions(context);
+        context.setVariable("x", 7.0);
+        context.setVariable("half", 0.5);
+        context.setOperatorSemantics("^", OperatorSemantics::BITWISE_XOR);
+    }
+
+    BigIntegerResult eval(const std::string& expr, size_t wordBits = 0, bool isSigned = true) {
+        Tokenizer tokenizer(expr);
+        ShuntingYardParser parser;
+        auto ast = parser.parse(tokenizer.tokenize());
+        BigIntegerEvaluator evaluator(wordBits, isSigned);
+        return evaluator.evaluate(*ast, context);
+    }
+
+    std::string evalString(const std::string& expr, size_t wordBits = 0, bool isSigned = true,
+                           int base = 10) {
+        BigIntegerResult result = eval(expr, wordBits, isSigned);
+        if (result.isError()) {
+            return "error: " + result.getErrorMessage();
+        }
+        return result.getValue().toString(base);
+    }
+
+    EvaluationContext context;
+};
+
+TEST_F(BigIntegerEvaluatorTest, Arithmetic) {
+    EXPECT_EQ(evalString("1 + 2 * 3"), "7");
+    EXPECT_EQ(evalString("(0x10 - 0b11) * 0o2"), "26");
+    EXPECT_EQ(evalString("-7 / 2"), "-3");
+    EXPECT_EQ(evalString("-7 % 2"), "-1");
+    EXPECT_EQ(evalString("x * x"), "49");
+    EXPECT_EQ(evalString("max(3, x, 5)"), "7");
+}
+
+TEST_F(BigIntegerEvaluatorTest, UnboundedDoesNotWrap) {
+    EXPECT_EQ(evalString("0xFFFFFFFFFFFFFFFF + 1"), "18446744073709551616");
+    EXPECT_EQ(evalString("0xFFFFFFFFFFFFFFFF * 0xFFFFFFFFFFFFFFFF", 0, true, 16),
+              "FFFFFFFFFFFFFFFE0000000000000001");
+    EXPECT_EQ(evalString("1 << 200", 0, true, 16), "1" + std::string(50, '0'));
+}
+
+TEST_F(BigIntegerEvaluatorTest, WideLiterals) {
+    const std::string hex = "123456789ABCDEF0123456789ABCDEF0123456789ABCDEF";
+    EXPECT_EQ(evalString("0x" + hex, 0, true, 16), hex);
+    EXPECT_EQ(evalString("0x" + hex + " >> 128", 0, true, 16), "123456789ABCDEF");
+    EXPECT_EQ(evalString("0b1" + std::string(100, '0'), 0, true, 16), "1" + std::string(25, '0'));
+    EXPECT_EQ(evalString("123456789012345678901234567890 + 1"), "123456789012345678901234567891");
+}
+
+TEST_F(BigIntegerEvaluatorTest, WrapsAtWordSize) {
+    EXPECT_EQ(evalString("(1 << 127) - 1 + 1", 128), "-" + BigInteger::powerOfTwo(127).toString());
+    EXPECT_EQ(evalString("0 - 1", 128, false, 16), std::string(32, 'F'));
+    EXPECT_EQ(evalString("0 - 1", 4096, false, 16), std::string(1024, 'F'));
+    EXPECT_EQ(evalString("1 << 4096", 4096), "0");
+    EXPECT_EQ(evalString("300", 8), "44");
+}
+
+TEST_F(BigIntegerEvaluatorTest, SignedAndUnsignedDisagree) {
+    EXPECT_EQ(evalString("(0xF << 252) / 2", 256, true, 16), "-8" + std::string(62, '0'));
+    EXPECT_EQ(evalString("(0xF << 252) / 2", 256, false, 16), "78" + std::string(62, '0'));
+    EXPECT_EQ(evalString("-1 >> 100", 128), "-1");
+    EXPECT_EQ(evalString("-1 >> 100", 128, false, 16), "FFFFFFF");
+}
+
+TEST_F(BigIntegerEvaluatorTest, Power) {
+    context.setOperatorSemantics("^", OperatorSemantics::POWER);
+    EXPECT_EQ(evalString("3 ^ 40"), "12157665459056928801");
+    EXPECT_EQ(evalString("2 ^ 1000"), BigInteger::powerOfTwo(1000).toString());
+    EXPECT_EQ(evalString("3 ^ 100", 128, false), BigInteger::pow(BigInteger(3), 100).wrap(128, false).toString());
+    EXPECT_EQ(evalString("2 ^ 128", 128), "0");
+    EXPECT_EQ(evalString("-1 ^ 1000001"), "-1");
+    EXPECT_EQ(evalString("2 ^ -1"), "0");
+    EXPECT_EQ(evalString("-1 ^ -3"), "-1");
+
+    BigIntegerResult zero = eval("0 ^ -1");
+    ASSERT_TRUE(zero.isError());
+    EXPECT_EQ(zero.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+}
+
+TEST_F(BigIntegerEvaluatorTest, UnboundedResultsAreLimited) {
+    context.setOperatorSemantics("^", OperatorSemantics::POWER);
+    for (const char* expr : {"2 ^ 100000000", "1 << 100000000", "(1 << 600000) * (1 << 600000)"}) {
+        BigIntegerResult result = eval(expr);
+        ASSERT_TRUE(result.isError()) << expr;
+        EXPECT_EQ(result.getErrorCode(), ErrorCode::NUMERIC_OVERFLOW) << expr;
+    }
+    // The same expressions wrap when there is a word
+    EXPECT_EQ(evalString("2 ^ 100000000", 4096), "0");
+    EXPECT_EQ(evalString("0 << 100000000"), "0");
+}
+
+TEST_F(BigIntegerEvaluatorTest, Errors) {
+    BigIntegerResult division = eval("1 / (x - 7)");
+    ASSERT_TRUE(division.isError());
+    EXPECT_EQ(division.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+
+    BigIntegerResult fraction = eval("half + 1");
+    ASSERT_TRUE(fraction.isError());
+    EXPECT_EQ(fraction.getErrorCode(), ErrorCode::DOMAIN_ERROR);
+
+    BigIntegerResult shift = eval("1 << -1");
+    ASSERT_TRUE(shift.isError());
+    EXPECT_EQ(shift.getErrorCode(), ErrorCode::DOMAIN_ERROR);
+    // Unsigned, -1 is a huge count rather than a negative one
+    EXPECT_EQ(evalString("1 << -1", 128, false), "0");
+
+    BigIntegerResult undefined = eval("y + 1");
+    ASSERT_TRUE(undefined.isError());
+    EXPECT_EQ(undefined.getErrorCode(), ErrorCode::UNDEFINED_VARIABLE);
+
+    EXPECT_THROW(division.getValue(), std::runtime_error);
+    EXPECT_THROW(BigIntegerEvaluator(BigIntegerEvaluator::MAX_BITS + 1), std::invalid_argument);
+}
+
+TEST_F(BigIntegerEvaluatorTest, ToEvaluationResult) {
+    EvaluationResult small = eval("0x10 * 3").toEvaluationResult();
+    ASSERT_TRUE(small.isSuccess());
+    EXPECT_DOUBLE_EQ(small.getValue(), 48.0);
+
+    EvaluationResult huge = eval("1 << 2000").toEvaluationResult();
+    ASSERT_TRUE(huge.isError());
+    EXPECT_EQ(huge.getErrorCode(), ErrorCode::NUMERIC_OVERFLOW);
+}
+
+TEST_F(BigIntegerEvaluatorTest, ResultCarriesWord) {
+    BigIntegerResult result = eval("5", 256, false);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.getWordBits(), 256u);
+    EXPECT_FALSE(result.isSigned());
+}
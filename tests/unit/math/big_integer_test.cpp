@@ -0,0 +1,309 @@
+/**
+ * @file big_integer_test.cpp
+ * @brief Unit tests for arbitrary-precision integers
+ */
+
+#include "calc/math/big_integer.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace calc {
+
+// ============================================================================
+// Test fixture for BigInteger tests
+// ============================================================================
+
+class BigIntegerTest : public ::testing::Test {
+protected:
+    std::mt19937_64 random{20240611};
+
+    // A random value of exactly @p digits hexadecimal digits
+    BigInteger randomValue(size_t digits, bool negative = false) {
+        static const char HEX[] = "0123456789ABCDEF";
+        std::string text = negative ? "-" : "";
+        text += HEX[1 + random() % 15];
+        for (size_t i = 1; i < digits; ++i) {
+            text += HEX[random() % 16];
+        }
+        return BigInteger::fromString(text, 16);
+    }
+
+    // Product by shifting and adding, independent of multiplyLimbs
+    static BigInteger shiftAndAdd(const BigInteger& a, const BigInteger& b) {
+        BigInteger result;
+        for (size_t i = 0; i < b.bitLength(); ++i) {
+            if (b.testBit(i)) {
+                result += a << i;
+            }
+        }
+        return b.isNegative() ? -result : result;
+    }
+};
+
+// ============================================================================
+// Construction and storage
+// ============================================================================
+
+TEST_F(BigIntegerTest, DefaultIsZero) {
+    BigInteger zero;
+    EXPECT_TRUE(zero.isZero());
+    EXPECT_FALSE(zero.isNegative());
+    EXPECT_EQ(zero.sign(), 0);
+    EXPECT_EQ(zero.bitLength(), 0u);
+    EXPECT_EQ(zero.toString(), "0");
+}
+
+TEST_F(BigIntegerTest, FromInt64) {
+    EXPECT_EQ(BigInteger(42).toString(), "42");
+    EXPECT_EQ(BigInteger(-42).toString(), "-42");
+    EXPECT_EQ(BigInteger(std::numeric_limits<long long>::min()).toString(), "-9223372036854775808");
+    EXPECT_EQ(BigInteger::fromUnsigned(std::numeric_limits<unsigned long long>::max()).toString(),
+              "18446744073709551615");
+}
+
+TEST_F(BigIntegerTest, SmallValuesStayInline) {
+    BigInteger value = BigInteger::powerOfTwo(127);
+    EXPECT_TRUE(value.isInline());
+    EXPECT_EQ(value.getLimbCount(), 4u);
+
+    value <<= 1;
+    EXPECT_FALSE(value.isInline());
+    EXPECT_EQ(value.getLimbCount(), 5u);
+
+    // Copies and moves keep the value whichever storage it is in
+    BigInteger copy = value;
+    BigInteger moved = std::move(copy);
+    EXPECT_EQ(moved, BigInteger::powerOfTwo(128));
+    copy = BigInteger(7);
+    EXPECT_EQ(copy, BigInteger(7));
+    copy = moved;
+    EXPECT_EQ(copy, moved);
+}
+
+TEST_F(BigIntegerTest, FromDouble) {
+    EXPECT_EQ(BigInteger::fromDouble(0.0), BigInteger());
+    EXPECT_EQ(BigInteger::fromDouble(-12345.0), BigInteger(-12345));
+    EXPECT_EQ(BigInteger::fromDouble(std::ldexp(1.0, 200)), BigInteger::powerOfTwo(200));
+    EXPECT_THROW(BigInteger::fromDouble(3.5), std::invalid_argument);
+    EXPECT_THROW(BigInteger::fromDouble(std::numeric_limits<double>::infinity()), std::invalid_argument);
+    EXPECT_THROW(BigInteger::fromDouble(std::nan("")), std::invalid_argument);
+}
+
+TEST_F(BigIntegerTest, ToDouble) {
+    EXPECT_DOUBLE_EQ(BigInteger(-5).toDouble(), -5.0);
+    EXPECT_EQ(BigInteger::powerOfTwo(1000).toDouble(), std::ldexp(1.0, 1000));
+    // 2^64 + 1 rounds to 2^64; 2^53 + 3 rounds up to 2^53 + 4
+    EXPECT_EQ((BigInteger::powerOfTwo(64) + 1).toDouble(), std::ldexp(1.0, 64));
+    EXPECT_EQ((BigInteger::powerOfTwo(53) + 3).toDouble(), std::ldexp(1.0, 53) + 4.0);
+    EXPECT_TRUE(std::isinf(BigInteger::powerOfTwo(1024).toDouble()));
+}
+
+TEST_F(BigIntegerTest, FitsInt64) {
+    EXPECT_TRUE(BigInteger(std::numeric_limits<long long>::min()).fitsInt64());
+    EXPECT_EQ(BigInteger(std::numeric_limits<long long>::min()).toInt64(),
+              std::numeric_limits<long long>::min());
+    EXPECT_FALSE(BigInteger::powerOfTwo(63).fitsInt64());
+    EXPECT_TRUE((-BigInteger::powerOfTwo(63)).fitsInt64());
+}
+
+// ============================================================================
+// Base conversion
+// ============================================================================
+
+TEST_F(BigIntegerTest, FromStringInvalid) {
+    EXPECT_THROW(BigInteger::fromString("", 10), std::invalid_argument);
+    EXPECT_THROW(BigInteger::fromString("-", 10), std::invalid_argument);
+    EXPECT_THROW(BigInteger::fromString("12a", 10), std::invalid_argument);
+    EXPECT_THROW(BigInteger::fromString("102", 2), std::invalid_argument);
+    EXPECT_THROW(BigInteger::fromString("1", 1), std::invalid_argument);
+    EXPECT_THROW(BigInteger::fromString("1", 37), std::invalid_argument);
+    EXPECT_THROW(BigInteger(1).toString(37), std::invalid_argument);
+}
+
+TEST_F(BigIntegerTest, KnownDecimal) {
+    // The Mersenne prime 2^521 - 1
+    const std::string m521 =
+        "6864797660130609714981900799081393217269435300143305409394463459185543183397656052122559640661454"
+        "554977296311391480858037121987999716643812574028291115057151";
+    EXPECT_EQ((BigInteger::powerOfTwo(521) - 1).toString(10), m521);
+    EXPECT_EQ(BigInteger::fromString(m521, 10), BigInteger::powerOfTwo(521) - 1);
+
+    BigInteger factorial(1);
+    for (int i = 2; i <= 100; ++i) {
+        factorial *= BigInteger(i);
+    }
+    EXPECT_EQ(factorial.toString(),
+              "9332621544394415268169923885626670049071596826438162146859296389521759999322991560894146397615651"
+              "8286253697920827223758251185210916864000000000000000000000000");
+}
+
+TEST_F(BigIntegerTest, PowerOfTwoBases) {
+    BigInteger value = BigInteger::fromString("DEADBEEFCAFEBABE0123456789ABCDEF", 16);
+    EXPECT_EQ(value.toString(16), "DEADBEEFCAFEBABE0123456789ABCDEF");
+    EXPECT_EQ(BigInteger::fromString("deadbeefcafebabe0123456789abcdef", 16), value);
+    EXPECT_EQ(BigInteger::fromString(value.toString(2), 2), value);
+    EXPECT_EQ(BigInteger::fromString(value.toString(8), 8), value);
+    EXPECT_EQ(BigInteger(-255).toString(16), "-FF");
+    EXPECT_EQ(BigInteger(8).toString(8), "10");
+    EXPECT_EQ(BigInteger::fromString("0000000001", 2), BigInteger(1));
+}
+
+TEST_F(BigIntegerTest, RoundTripAllBases) {
+    for (size_t digits : {1u, 8u, 17u, 40u, 200u, 600u}) {
+        BigInteger value = randomValue(digits, digits % 2 == 0);
+        for (int base = 2; base <= 36; ++base) {
+            EXPECT_EQ(BigInteger::fromString(value.toString(base), base), value)
+                << digits << " hex digits in base " << base;
+        }
+    }
+}
+
+TEST_F(BigIntegerTest, DecimalRoundTrip4096Bits) {
+    BigInteger value = BigInteger::powerOfTwo(4096) - 1;
+    std::string decimal = value.toString(10);
+    ASSERT_EQ(decimal.size(), 1234u);
+    EXPECT_EQ(decimal.substr(0, 20), "10443888814131525066");
+    EXPECT_EQ(decimal.substr(decimal.size() - 20), "04708340403154190335");
+    EXPECT_EQ(BigInteger::fromString(decimal, 10), value);
+}
+
+TEST_F(BigIntegerTest, DecimalKeepsInnerZeros) {
+    // Interior chunks of zeros must be padded, not dropped
+    BigInteger value = BigInteger::pow(BigInteger(10), 300) + 7;
+    std::string decimal = value.toString();
+    ASSERT_EQ(decimal.size(), 301u);
+    EXPECT_EQ(decimal, "1" + std::string(299, '0') + "7");
+}
+
+// ============================================================================
+// Arithmetic
+// ============================================================================
+
+TEST_F(BigIntegerTest, AddSubtractSigns) {
+    BigInteger big = BigInteger::powerOfTwo(100);
+    EXPECT_EQ(big + -big, BigInteger());
+    EXPECT_EQ((big - 1) + 1, big);
+    EXPECT_EQ(BigInteger(5) - BigInteger(8), BigInteger(-3));
+    EXPECT_EQ(BigInteger(-5) - BigInteger(-8), BigInteger(3));
+    EXPECT_EQ((BigInteger() - big).toString(16), "-1" + std::string(25, '0'));
+}
+
+TEST_F(BigIntegerTest, MultiplyMatchesShiftAndAdd) {
+    // Sizes below, at and well beyond the Karatsuba threshold, balanced and lopsided
+    const size_t limbDigits = BigInteger::LIMB_BITS / 4;
+    const size_t sizes[][2] = {{3, 5}, {40, 40}, {31, 33}, {64, 64}, {100, 37}, {150, 9}, {257, 130}};
+    for (const auto& size : sizes) {
+        BigInteger a = randomValue(size[0] * limbDigits, size[0] % 2 == 1);
+        BigInteger b = randomValue(size[1] * limbDigits);
+        EXPECT_EQ(a * b, shiftAndAdd(a, b)) << size[0] << " x " << size[1] << " limbs";
+        EXPECT_EQ(b * a, a * b);
+    }
+}
+
+TEST_F(BigIntegerTest, SquareLargePower) {
+    // 3^2000 is about a hundred limbs, so pow() squares through Karatsuba
+    BigInteger byPow = BigInteger::pow(BigInteger(3), 2000);
+    BigInteger byLoop(1);
+    for (int i = 0; i < 2000; ++i) {
+        byLoop *= BigInteger(3);
+    }
+    EXPECT_EQ(byPow, byLoop);
+
+    std::string decimal = byPow.toString();
+    ASSERT_EQ(decimal.size(), 955u);
+    EXPECT_EQ(decimal.substr(0, 20), "17478712517226516096");
+    EXPECT_EQ(decimal.substr(decimal.size() - 20), "91673819054110440001");
+}
+
+TEST_F(BigIntegerTest, DivisionIdentity) {
+    const size_t dividendSizes[] = {1, 10, 33, 80, 300};
+    const size_t divisorSizes[] = {1, 2, 9, 32, 70};
+    for (size_t n : dividendSizes) {
+        for (size_t d : divisorSizes) {
+            BigInteger a = randomValue(n * 8, n % 2 == 0);
+            BigInteger b = randomValue(d * 8, d % 2 == 0);
+            BigInteger q;
+            BigInteger r;
+            BigInteger::divMod(a, b, q, r);
+            EXPECT_EQ(q * b + r, a) << n << " / " << d << " limbs";
+            // The remainder is smaller than the divisor and has the dividend's sign
+            EXPECT_LT(r.isNegative() ? -r : r, b.isNegative() ? -b : b);
+            EXPECT_TRUE(r.isZero() || r.isNegative() == a.isNegative());
+        }
+    }
+}
+
+TEST_F(BigIntegerTest, DivisionTruncates) {
+    EXPECT_EQ(BigInteger(7) / BigInteger(2), BigInteger(3));
+    EXPECT_EQ(BigInteger(-7) / BigInteger(2), BigInteger(-3));
+    EXPECT_EQ(BigInteger(-7) % BigInteger(2), BigInteger(-1));
+    EXPECT_EQ(BigInteger(7) % BigInteger(-2), BigInteger(1));
+    EXPECT_THROW(BigInteger(1) / BigInteger(), std::domain_error);
+
+    // Aliased arguments
+    BigInteger a = BigInteger::powerOfTwo(300) + 5;
+    BigInteger::divMod(a, a, a, a);
+    EXPECT_EQ(a, BigInteger());
+}
+
+TEST_F(BigIntegerTest, Pow) {
+    EXPECT_EQ(BigInteger::pow(BigInteger(2), 0), BigInteger(1));
+    EXPECT_EQ(BigInteger::pow(BigInteger(-2), 3), BigInteger(-8));
+    EXPECT_EQ(BigInteger::pow(BigInteger(2), 4096), BigInteger::powerOfTwo(4096));
+}
+
+// ============================================================================
+// Bitwise operators and words
+// ============================================================================
+
+TEST_F(BigIntegerTest, BitwiseTwosComplement) {
+    // Negative values behave as infinitely sign-extended two's complement
+    EXPECT_EQ(BigInteger(-1) & BigInteger(0xFF), BigInteger(0xFF));
+    EXPECT_EQ(BigInteger(-256) | BigInteger(0xFF), BigInteger(-1));
+    EXPECT_EQ(BigInteger(-1) ^ BigInteger(5), BigInteger(-6));
+    EXPECT_EQ(~BigInteger(0), BigInteger(-1));
+    EXPECT_EQ(~BigInteger::powerOfTwo(200), -BigInteger::powerOfTwo(200) - 1);
+
+    BigInteger a = randomValue(70, true);
+    BigInteger b = randomValue(45);
+    EXPECT_EQ((a & b) + (a | b), a + b);
+    EXPECT_EQ(a ^ b, (a | b) - (a & b));
+}
+
+TEST_F(BigIntegerTest, Shifts) {
+    EXPECT_EQ(BigInteger(1) << 200, BigInteger::powerOfTwo(200));
+    EXPECT_EQ(BigInteger::powerOfTwo(200) >> 199, BigInteger(2));
+    EXPECT_EQ(BigInteger(5) >> 10, BigInteger());
+    // Right shifts of negative values round towards negative infinity
+    EXPECT_EQ(BigInteger(-5) >> 1, BigInteger(-3));
+    EXPECT_EQ(-BigInteger::powerOfTwo(100) >> 100, BigInteger(-1));
+    EXPECT_EQ((-BigInteger::powerOfTwo(100) - 1) >> 100, BigInteger(-2));
+    EXPECT_EQ(BigInteger(-1) >> 1000, BigInteger(-1));
+}
+
+TEST_F(BigIntegerTest, Wrap) {
+    BigInteger value = BigInteger::fromString("-12345678901234567890123", 10);
+    EXPECT_EQ(value.wrap(128, false).toString(16), "FFFFFFFFFFFFFD62BD49B1898EBDBB35");
+    EXPECT_EQ(value.wrap(128, true), value);
+
+    BigInteger top = BigInteger::powerOfTwo(127);
+    EXPECT_EQ(top.wrap(128, true), -top);
+    EXPECT_EQ(top.wrap(128, false), top);
+    EXPECT_EQ(BigInteger::powerOfTwo(4096).wrap(4096, false), BigInteger());
+    EXPECT_EQ(BigInteger(-1).wrap(4096, false), BigInteger::powerOfTwo(4096) - 1);
+    EXPECT_EQ(BigInteger(300).wrap(8, true), BigInteger(44));
+}
+
+TEST_F(BigIntegerTest, Compare) {
+    EXPECT_LT(BigInteger(-3), BigInteger(2));
+    EXPECT_LT(-BigInteger::powerOfTwo(100), BigInteger(-3));
+    EXPECT_GT(BigInteger::powerOfTwo(100), BigInteger::powerOfTwo(99));
+    EXPECT_EQ(BigInteger::compare(BigInteger(4), BigInteger(4)), 0);
+}
+
+} // namespace calc
@@ -6,7 +6,12 @@
 #include "calc/math/converter.h"
 #include "calc/core/token.h"
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <random>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace calc {
 
@@ -338,10 +343,168 @@ TEST_F(ConverterTest, Format_Negative_NumberBase) {
     EXPECT_EQ(Converter::format(-10, NumberBase::DECIMAL), "-10");
 }
 
+TEST_F(ConverterTest, FormatUnsigned) {
+    EXPECT_EQ(Converter::formatUnsigned(0, NumberBase::BINARY), "0b0");
+    EXPECT_EQ(Converter::formatUnsigned(10, NumberBase::OCTAL), "0o12");
+    EXPECT_EQ(Converter::formatUnsigned(255, NumberBase::HEXADECIMAL), "0xFF");
+    EXPECT_EQ(Converter::formatUnsigned(0xFFFFFFFFFFFFFFFFull, NumberBase::HEXADECIMAL),
+              "0xFFFFFFFFFFFFFFFF");
+    EXPECT_EQ(Converter::formatUnsigned(0xFFFFFFFFFFFFFFFFull, NumberBase::OCTAL),
+              "0o1777777777777777777777");
+    EXPECT_EQ(Converter::formatUnsigned(0xFFFFFFFFFFFFFFFFull, NumberBase::DECIMAL),
+              "18446744073709551615");
+    EXPECT_EQ(Converter::formatUnsigned(0x8000000000000000ull, NumberBase::BINARY),
+              "0b1" + std::string(63, '0'));
+}
+
+TEST_F(ConverterTest, FormatBigInteger) {
+    BigInteger wide = BigInteger::powerOfTwo(100);
+    EXPECT_EQ(Converter::format(wide, NumberBase::HEXADECIMAL), "0x1" + std::string(25, '0'));
+    EXPECT_EQ(Converter::format(-wide, NumberBase::HEXADECIMAL), "-0x1" + std::string(25, '0'));
+    EXPECT_EQ(Converter::format(wide, NumberBase::DECIMAL), "1267650600228229401496703205376");
+    EXPECT_EQ(Converter::format(BigInteger(8), NumberBase::OCTAL), "0o10");
+    EXPECT_EQ(Converter::format(BigInteger(), NumberBase::BINARY), "0b0");
+}
+
+TEST_F(ConverterTest, BigIntegerConversion) {
+    const std::string digits = "1234567890ABCDEF1234567890ABCDEF1234567890";
+    BigInteger value = Converter::fromBaseBig(digits, 16);
+    EXPECT_EQ(Converter::convertToBase(value, 16), digits);
+    EXPECT_EQ(Converter::fromBaseBig(Converter::convertToBase(value, 36), 36), value);
+    EXPECT_EQ(Converter::fromBaseBig("-101", 2), BigInteger(-5));
+    EXPECT_THROW(Converter::fromBaseBig("12", 2), std::invalid_argument);
+}
+
 // ============================================================================
 // Edge Cases
 // ============================================================================
 
+TEST_F(ConverterTest, FromBaseOverflow) {
+    EXPECT_EQ(Converter::fromBase("7FFFFFFFFFFFFFFF", 16), 0x7FFFFFFFFFFFFFFFLL);
+    EXPECT_EQ(Converter::fromBase("-8000000000000000", 16), INT64_MIN);
+    EXPECT_THROW(Converter::fromBase("8000000000000000", 16), std::out_of_range);
+    EXPECT_THROW(Converter::fromBase("99999999999999999999", 10), std::out_of_range);
+    EXPECT_EQ(Converter::convertToBase(INT64_MIN, 16), "-8000000000000000");
+}
+
+TEST_F(ConverterTest, FromBaseRejectsSignWithoutDigits) {
+    EXPECT_THROW(Converter::fromBase("-", 10), std::invalid_argument);
+    EXPECT_THROW(Converter::fromBase("--1", 10), std::invalid_argument);
+    EXPECT_FALSE(Converter::isValidHex("-"));
+    EXPECT_TRUE(Converter::isValidHex("-fF"));
+}
+
+TEST_F(ConverterTest, FormatMinimumValue) {
+    EXPECT_EQ(Converter::format(INT64_MIN, NumberBase::HEXADECIMAL), "-0x8000000000000000");
+    EXPECT_EQ(Converter::format(INT64_MIN, NumberBase::DECIMAL), "-9223372036854775808");
+    EXPECT_EQ(Converter::format(-255, NumberBase::BINARY), "-0b11111111");
+}
+
+// ============================================================================
+// Buffer and Bulk Conversion Tests
+// ============================================================================
+
+TEST_F(ConverterTest, ToCharsWritesIntoBuffer) {
+    char buffer[Converter::MAX_CHARS];
+    EXPECT_EQ(std::string(buffer, Converter::toChars(-255LL, 16, buffer)), "-FF");
+    EXPECT_EQ(std::string(buffer, Converter::toChars(0LL, 2, buffer)), "0");
+    EXPECT_EQ(std::string(buffer, Converter::toChars(1234LL, 36, buffer)), "YA");
+    EXPECT_EQ(std::string(buffer, Converter::toChars(static_cast<long long>(INT64_MIN), 2, buffer)), "-1" + std::string(63, '0'));
+    EXPECT_EQ(Converter::toChars(static_cast<long long>(INT64_MIN), 2, buffer), Converter::MAX_CHARS);
+    EXPECT_EQ(std::string(buffer, Converter::toCharsUnsigned(UINT64_MAX, 10, buffer)), "18446744073709551615");
+    EXPECT_EQ(std::string(buffer, Converter::toCharsUnsigned(UINT64_MAX, 32, buffer)), "FVVVVVVVVVVVV");
+    EXPECT_THROW(Converter::toChars(1LL, 37, buffer), std::invalid_argument);
+}
+
+TEST_F(ConverterTest, FromBaseUnsigned) {
+    EXPECT_EQ(Converter::fromBaseUnsigned("FFFFFFFFFFFFFFFF", 16), UINT64_MAX);
+    EXPECT_EQ(Converter::fromBaseUnsigned("18446744073709551615", 10), UINT64_MAX);
+    EXPECT_THROW(Converter::fromBaseUnsigned("18446744073709551616", 10), std::out_of_range);
+    EXPECT_THROW(Converter::fromBaseUnsigned("-1", 10), std::invalid_argument);
+    EXPECT_THROW(Converter::fromBaseUnsigned("", 10), std::invalid_argument);
+}
+
+TEST_F(ConverterTest, MatchesReferenceInEveryBase) {
+    std::mt19937_64 random(20240801);
+    char buffer[Converter::MAX_CHARS];
+    for (int base = 2; base <= 36; ++base) {
+        for (int i = 0; i < 200; ++i) {
+            // Spread over magnitudes, not just the top of the range
+            const auto value = static_cast<long long>(random() >> (random() % 64));
+            const long long signedValue = (i % 2 == 0) ? value : -value;
+
+            // Reference digits by repeated division, most significant last
+            std::string expected;
+            unsigned long long magnitude = signedValue < 0 ? 0 - static_cast<unsigned long long>(signedValue)
+                                                           : static_cast<unsigned long long>(signedValue);
+            do {
+                expected.insert(expected.begin(), "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[magnitude % static_cast<unsigned long long>(base)]);
+                magnitude /= static_cast<unsigned long long>(base);
+            } while (magnitude != 0);
+            if (signedValue < 0) {
+                expected.insert(expected.begin(), '-');
+            }
+
+            ASSERT_EQ(std::string(buffer, Converter::toChars(signedValue, base, buffer)), expected);
+            ASSERT_EQ(Converter::fromBase(expected, base), signedValue);
+        }
+    }
+}
+
+TEST_F(ConverterTest, BulkRoundTrip) {
+    std::mt19937_64 random(20240802);
+    std::vector<long long> values = {0, -1, INT64_MIN, INT64_MAX};
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(static_cast<long long>(random()));
+    }
+
+    for (int base : {2, 8, 10, 16, 36}) {
+        std::string text = "kept:";
+        Converter::convertToBase(values.data(), values.size(), base, text);
+        ASSERT_EQ(text.compare(0, 5, "kept:"), 0);
+        EXPECT_EQ(text.back(), '\n');
+
+        std::vector<long long> parsed(values.size());
+        size_t count = Converter::fromBase(std::string_view(text).substr(5), base, parsed.data(), parsed.size());
+        EXPECT_EQ(count, values.size());
+        EXPECT_EQ(parsed, values) << "base " << base;
+    }
+}
+
+TEST_F(ConverterTest, BulkUnsigned) {
+    const unsigned long long ids[] = {0, 0xDEADBEEF, UINT64_MAX};
+    std::string text;
+    Converter::convertToBase(ids, 3, 16, text, ',');
+    EXPECT_EQ(text, "0,DEADBEEF,FFFFFFFFFFFFFFFF,");
+
+    unsigned long long parsed[3] = {};
+    EXPECT_EQ(Converter::fromBase("0,deadbeef,FFFFFFFFFFFFFFFF", 16, parsed, 3, ','), 3u);
+    EXPECT_EQ(parsed[1], 0xDEADBEEFull);
+    EXPECT_EQ(parsed[2], UINT64_MAX);
+
+    // The string is reused: converting again appends without reallocating
+    text.clear();
+    const size_t capacity = text.capacity();
+    Converter::convertToBase(ids, 3, 16, text, ',');
+    EXPECT_EQ(text.capacity(), capacity);
+}
+
+TEST_F(ConverterTest, BulkErrors) {
+    long long parsed[2] = {};
+    EXPECT_EQ(Converter::fromBase("", 10, parsed, 2), 0u);
+    EXPECT_THROW(Converter::fromBase("1\n2\n3\n", 10, parsed, 2), std::length_error);
+    EXPECT_THROW(Converter::fromBase("1\n\n2", 10, parsed, 2), std::invalid_argument);
+    EXPECT_THROW(Converter::fromBase("1\n99999999999999999999", 10, parsed, 2), std::out_of_range);
+    try {
+        Converter::fromBase("1\nG", 16, parsed, 2);
+        FAIL() << "expected std::invalid_argument";
+    } catch (const std::invalid_argument& e) {
+        EXPECT_STREQ(e.what(), "Invalid digit for base 16: 'G' in value 2");
+    }
+    std::string text;
+    EXPECT_THROW(Converter::convertToBase(parsed, 2, 1, text), std::invalid_argument);
+}
+
 TEST_F(ConverterTest, LargeNumberConversion) {
     long long largeValue = 0x7FFFFFFFFFFFFFFFLL;  // Max int64
     std::string hex = Converter::decimalToHex(largeValue);
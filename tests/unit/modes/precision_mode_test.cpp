@@ -0,0 +1,149 @@
+/**
+ * @file precision_mode_test.cpp
+ * @brief Unit tests for precision mode
+ */
+
+#include <gtest/gtest.h>
+#include "calc/modes/precision_mode.h"
+#include "calc/modes/mode_manager.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace calc {
+
+// ============================================================================
+// Test fixture for PrecisionMode tests
+// ============================================================================
+
+class PrecisionModeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        mode = std::make_unique<PrecisionMode>();
+    }
+
+    std::string evalString(const std::string& expression) {
+        BigFloatResult result = mode->evaluatePrecise(expression);
+        if (result.isError()) {
+            return "error: " + result.getErrorMessage();
+        }
+        return mode->formatResult(result);
+    }
+
+    std::unique_ptr<PrecisionMode> mode;
+};
+
+// ============================================================================
+// Mode Properties Tests
+// ============================================================================
+
+TEST_F(PrecisionModeTest, GetName) {
+    EXPECT_EQ(mode->getName(), "precision");
+}
+
+TEST_F(PrecisionModeTest, GetDescription) {
+    EXPECT_EQ(mode->getDescription(), "Precision mode: scientific functions to any number of significant digits");
+}
+
+TEST_F(PrecisionModeTest, DefaultPrecision) {
+    EXPECT_EQ(mode->getPrecision(), PrecisionMode::DEFAULT_DIGITS);
+    EXPECT_EQ(mode->getContext().getPrecision(), 50);
+}
+
+TEST_F(PrecisionModeTest, RegisteredWithModeManager) {
+    ModeManager manager;
+    Mode* registered = manager.getMode("precision");
+    ASSERT_NE(registered, nullptr);
+    EXPECT_NE(dynamic_cast<PrecisionMode*>(registered), nullptr);
+}
+
+// ============================================================================
+// Evaluation Tests
+// ============================================================================
+
+TEST_F(PrecisionModeTest, FiftyDigitsByDefault) {
+    EXPECT_EQ(evalString("0.1 + 0.2"), "0.3");
+    EXPECT_EQ(evalString("2 / 3"), "0.66666666666666666666666666666666666666666666666667");
+    EXPECT_EQ(evalString("sqrt(2)"), "1.4142135623730950488016887242096980785696718753769");
+    EXPECT_EQ(evalString("2 ^ 0.5"), "1.4142135623730950488016887242096980785696718753769");
+    EXPECT_EQ(evalString("4 * atan(1)"), "3.1415926535897932384626433832795028841971693993751");
+    EXPECT_EQ(evalString("PI"), "3.1415926535897932384626433832795028841971693993751");
+}
+
+TEST_F(PrecisionModeTest, ContextPrecisionIsHonoured) {
+    mode->setPrecision(10);
+    EXPECT_EQ(evalString("2 / 3"), "0.6666666667");
+
+    mode->getContext().setPrecision(100);
+    EXPECT_EQ(evalString("1 / 3"), "0." + std::string(100, '3'));
+
+    mode->getContext().setPrecision(0);  // Treated as one digit
+    EXPECT_EQ(evalString("2 / 3"), "0.7");
+}
+
+TEST_F(PrecisionModeTest, FinancialSums) {
+    // Decimal amounts add without binary representation error
+    EXPECT_EQ(evalString("1234567890123.45 + 0.01 + 0.02 - 0.03"), "1234567890123.45");
+    EXPECT_EQ(evalString("19.99 * 3"), "59.97");
+    EXPECT_EQ(evalString("1000000 * (1 + 0.05 / 12) ^ 120"),
+              "1647009.4976902830341856736543062801395041384423823");
+}
+
+TEST_F(PrecisionModeTest, EvaluateRoundsToDouble) {
+    EvaluationResult result = mode->evaluate("0.1 + 0.2");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.getValue(), 0.3);
+}
+
+TEST_F(PrecisionModeTest, Errors) {
+    EvaluationResult empty = mode->evaluate("");
+    ASSERT_TRUE(empty.isError());
+    EXPECT_EQ(empty.getErrorCode(), ErrorCode::INVALID_SYNTAX);
+
+    BigFloatResult syntax = mode->evaluatePrecise("1 +");
+    ASSERT_TRUE(syntax.isError());
+
+    BigFloatResult division = mode->evaluatePrecise("1 / 0");
+    ASSERT_TRUE(division.isError());
+    EXPECT_EQ(division.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+
+    EXPECT_THROW(mode->setPrecision(0), std::invalid_argument);
+    EXPECT_THROW(mode->setPrecision(PrecisionMode::MAX_DIGITS + 1), std::invalid_argument);
+
+    mode->getContext().setPrecision(PrecisionMode::MAX_DIGITS + 1);
+    BigFloatResult tooPrecise = mode->evaluatePrecise("1 / 3");
+    ASSERT_TRUE(tooPrecise.isError());
+    EXPECT_EQ(tooPrecise.getErrorCode(), ErrorCode::EVALUATION_ERROR);
+}
+
+TEST_F(PrecisionModeTest, EvaluateBatch) {
+    const double x[] = {0.5, 1.0, 0.0, 4.0};
+    std::vector<BatchColumn> columns = {{"x", x}};
+    double out[4];
+
+    BatchResult result = mode->evaluateBatch("sqrt(x) / x", columns, 4, out);
+    EXPECT_EQ(result.rows, 4u);
+    EXPECT_EQ(result.failedRows, 1u);
+    EXPECT_EQ(result.firstFailedRow, 2u);
+    ASSERT_TRUE(result.firstError.has_value());
+    EXPECT_EQ(result.firstError->getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+    EXPECT_DOUBLE_EQ(out[0], std::sqrt(2.0));
+    EXPECT_EQ(out[1], 1.0);
+    EXPECT_TRUE(std::isnan(out[2]));
+    EXPECT_EQ(out[3], 0.5);
+
+    // Columns do not leak into the mode's own context
+    EXPECT_FALSE(mode->getContext().hasVariable("x"));
+}
+
+TEST_F(PrecisionModeTest, CachesParsedTrees) {
+    evalString("1 / 7");
+    evalString("1 / 7");
+    CacheStats stats = mode->getCacheStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+
+    mode->clearCache();
+    EXPECT_EQ(mode->getCacheStats().size, 0u);
+}
+
+} // namespace calc
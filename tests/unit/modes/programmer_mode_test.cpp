@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 #include "calc/modes/programmer_mode.h"
+#include <cstdint>
 
 namespace calc {
 
@@ -423,4 +424,139 @@ TEST_F(ProgrammerModeTest, ParenthesizedBinary) {
     EXPECT_EQ(result.getValue(), 14);
 }
 
+// ============================================================================
+// Expression Cache Tests
+// ============================================================================
+
+TEST_F(ProgrammerModeTest, CachedExpressionKeepsXorSemantics) {
+    EXPECT_EQ(mode->evaluate("12 ^ 10").getValue(), 6);
+    EXPECT_EQ(mode->evaluate("12 ^ 10").getValue(), 6);
+
+    CacheStats stats = mode->getCacheStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+
+    mode->clearCache();
+    EXPECT_EQ(mode->getCacheStats().size, 0u);
+}
+
+TEST_F(ProgrammerModeTest, EvaluateBatchUsesXorSemantics) {
+    const std::vector<double> mask = {0xF0, 0x0F};
+    std::vector<double> out(mask.size());
+
+    BatchResult result = mode->evaluateBatch("0xFF ^ mask", {{"mask", mask.data()}},
+                                             mask.size(), out.data());
+    EXPECT_TRUE(result.isSuccess());
+    EXPECT_EQ(out[0], 0x0F);
+    EXPECT_EQ(out[1], 0xF0);
+}
+
+// ============================================================================
+// Word Size Tests
+// ============================================================================
+
+TEST_F(ProgrammerModeTest, DefaultWordIsSigned64) {
+    EXPECT_EQ(mode->getWordSize(), WordSize::BITS_64);
+    EXPECT_TRUE(mode->isSigned());
+    EXPECT_EQ(mode->evaluateInteger("0x7FFFFFFFFFFFFFFF + 1").getSigned(), INT64_MIN);
+}
+
+TEST_F(ProgrammerModeTest, ExactLiteralsPastDoublePrecision) {
+    IntegerResult result = mode->evaluateInteger("9007199254740993 + 0");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(mode->formatResult(result), "9007199254740993");
+
+    mode->setSigned(false);
+    result = mode->evaluateInteger("0xFFFFFFFFFFFFFFFF");
+    EXPECT_EQ(mode->formatResult(result), "18446744073709551615");
+    mode->setDisplayBase(16);
+    EXPECT_EQ(mode->formatResult(result), "0xFFFFFFFFFFFFFFFF");
+}
+
+TEST_F(ProgrammerModeTest, WordSizeWrapsResults) {
+    mode->setWordSize(WordSize::BITS_8);
+    EXPECT_EQ(mode->getWordSize(), WordSize::BITS_8);
+    EXPECT_EQ(mode->evaluate("127 + 1").getValue(), -128);
+
+    mode->setSigned(false);
+    EXPECT_FALSE(mode->isSigned());
+    EXPECT_EQ(mode->evaluate("127 + 1").getValue(), 128);
+    EXPECT_EQ(mode->evaluate("255 + 1").getValue(), 0);
+
+    mode->setWordSize(WordSize::BITS_16);
+    EXPECT_EQ(mode->evaluate("255 + 1").getValue(), 256);
+}
+
+TEST_F(ProgrammerModeTest, BigIntegerUnbounded) {
+    EXPECT_EQ(mode->getBigWordSize(), 0u);
+    BigIntegerResult result = mode->evaluateBigInteger("0xFFFFFFFFFFFFFFFF * 0x100 + 0xFF");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(mode->formatResult(result), "4722366482869645213695");
+    mode->setDisplayBase(16);
+    EXPECT_EQ(mode->formatResult(result), "0xFFFFFFFFFFFFFFFFFF");
+
+    result = mode->evaluateBigInteger("0 - 0x10000000000000000");
+    EXPECT_EQ(mode->formatResult(result), "-0x10000000000000000");
+}
+
+TEST_F(ProgrammerModeTest, BigIntegerWordSize) {
+    mode->setBigWordSize(128);
+    EXPECT_EQ(mode->getBigWordSize(), 128u);
+    BigIntegerResult result = mode->evaluateBigInteger("-1");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(mode->formatResult(result), "-1");
+    mode->setDisplayBase(16);
+    EXPECT_EQ(mode->formatResult(result), "0x" + std::string(32, 'F'));
+
+    mode->setSigned(false);
+    mode->setDisplayBase(10);
+    EXPECT_EQ(mode->formatResult(mode->evaluateBigInteger("-1")), "340282366920938463463374607431768211455");
+
+    EXPECT_THROW(mode->setBigWordSize(BigIntegerEvaluator::MAX_BITS + 1), std::invalid_argument);
+}
+
+TEST_F(ProgrammerModeTest, BigIntegerReportsParseErrors) {
+    mode->setBigWordSize(128);
+    BigIntegerResult result = mode->evaluateBigInteger("1 +");
+    EXPECT_TRUE(result.isError());
+
+    EXPECT_TRUE(mode->evaluateBigInteger("(1").isError());
+}
+
+TEST_F(ProgrammerModeTest, FormatResult_IntegerShowsBits) {
+    mode->setWordSize(WordSize::BITS_8);
+    IntegerResult result = mode->evaluateInteger("-1");
+    ASSERT_TRUE(result.isSuccess());
+
+    EXPECT_EQ(mode->formatResult(result), "-1");
+    mode->setDisplayBase(16);
+    EXPECT_EQ(mode->formatResult(result), "0xFF");
+    mode->setDisplayBase(2);
+    EXPECT_EQ(mode->formatResult(result), "0b11111111");
+
+    mode->setWordSize(WordSize::BITS_32);
+    mode->setDisplayBase(16);
+    EXPECT_EQ(mode->formatResult(mode->evaluateInteger("~0")), "0xFFFFFFFF");
+}
+
+TEST_F(ProgrammerModeTest, SignednessChangesDivisionAndShift) {
+    mode->setWordSize(WordSize::BITS_8);
+    EXPECT_EQ(mode->evaluate("0xF0 >> 4").getValue(), -1);
+    EXPECT_EQ(mode->evaluate("0xF0 / 16").getValue(), -1);
+
+    mode->setSigned(false);
+    EXPECT_EQ(mode->evaluate("0xF0 >> 4").getValue(), 15);
+    EXPECT_EQ(mode->evaluate("0xF0 / 16").getValue(), 15);
+}
+
+TEST_F(ProgrammerModeTest, FractionalValuesAreErrors) {
+    EvaluationResult result = mode->evaluate("1.5 + 1");
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::DOMAIN_ERROR);
+
+    result = mode->evaluate("7 / 0");
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+}
+
 } // namespace calc
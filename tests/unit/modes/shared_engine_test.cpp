@@ -0,0 +1,282 @@
+/**
+ * @file shared_engine_test.cpp
+ * @brief Unit tests for SharedEngine
+ */
+
+#include <gtest/gtest.h>
+#include "calc/modes/shared_engine.h"
+#include "calc/modes/scientific_mode.h"
+#include "calc/modes/programmer_mode.h"
+#include "calc/modes/precision_mode.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace calc;
+
+class SharedEngineTest : public ::testing::Test {
+protected:
+    ScientificMode mode;
+
+    // The engine must agree with the mode on values, codes and positions
+    void expectSameAsMode(const SharedEngine& engine, const std::string& expr) {
+        EvaluationScratch scratch;
+        EvaluationResult expected = mode.evaluate(expr);
+        EvaluationResult actual = engine.evaluate(expr, scratch);
+
+        ASSERT_EQ(actual.isSuccess(), expected.isSuccess()) << expr;
+        if (expected.isSuccess()) {
+            EXPECT_DOUBLE_EQ(actual.getValue(), expected.getValue()) << expr;
+        } else {
+            EXPECT_EQ(actual.getErrorCode(), expected.getErrorCode()) << expr;
+            EXPECT_EQ(actual.getErrorMessage(), expected.getErrorMessage()) << expr;
+            EXPECT_EQ(actual.getErrorPosition(), expected.getErrorPosition()) << expr;
+        }
+    }
+};
+
+TEST_F(SharedEngineTest, MatchesMode) {
+    SharedEngine engine(mode);
+    EXPECT_EQ(engine.getName(), "scientific");
+
+    expectSameAsMode(engine, "1 + 2 * 3");
+    expectSameAsMode(engine, "sin(PI / 2) + log(E)");
+    expectSameAsMode(engine, "max(1, 5, 3) ^ 2");
+    expectSameAsMode(engine, "1 / 0");
+    expectSameAsMode(engine, "sqrt(-1)");
+    expectSameAsMode(engine, "unknown(1)");
+    expectSameAsMode(engine, "(1 + 2");
+    expectSameAsMode(engine, "");
+}
+
+TEST_F(SharedEngineTest, UsesProgrammerSemantics) {
+    ProgrammerMode programmer;
+    SharedEngine engine(programmer);
+    EXPECT_DOUBLE_EQ(engine.evaluate("6 ^ 3").getValue(), 5.0);
+}
+
+TEST_F(SharedEngineTest, SnapshotsTheContext) {
+    mode.getContext().setVariable("rate", 2.0);
+    SharedEngine engine(mode);
+
+    mode.getContext().setVariable("rate", 3.0);
+    mode.getContext().addFunction("twice", [](double x) { return x * 2; });
+
+    EXPECT_DOUBLE_EQ(engine.evaluate("rate * 10").getValue(), 20.0);
+    EXPECT_EQ(engine.evaluate("twice(1)").getErrorCode(), ErrorCode::INVALID_FUNCTION);
+}
+
+TEST_F(SharedEngineTest, CachesCompiledPrograms) {
+    SharedEngine engine(mode, 2);
+    EvaluationScratch first;
+    EvaluationScratch second;
+
+    (void)engine.evaluate("1 + 1", first);
+    (void)engine.evaluate("1 + 1", first);   // Found in the scratch's own table
+    (void)engine.evaluate("1 + 1", second);  // Found in the shared cache
+
+    CacheStats stats = engine.getCacheStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.size, 1u);
+
+    (void)engine.evaluate("2 + 2", first);
+    (void)engine.evaluate("3 + 3", first);
+    stats = engine.getCacheStats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.size, 2u);
+
+    // Parse errors are not cached
+    (void)engine.evaluate("1 +", first);
+    (void)engine.evaluate("1 +", first);
+    EXPECT_EQ(engine.getCacheStats().misses, 5u);
+}
+
+TEST_F(SharedEngineTest, FullCacheDropsABoundedBatch) {
+    SharedEngine engine(mode, 16);
+    for (int i = 0; i < 17; ++i) {
+        (void)engine.evaluate(std::to_string(i) + " + 1");
+    }
+
+    // One eighth of the capacity makes room; the rest stays cached
+    CacheStats stats = engine.getCacheStats();
+    EXPECT_EQ(stats.evictions, 2u);
+    EXPECT_EQ(stats.size, 15u);
+}
+
+TEST_F(SharedEngineTest, ProgrammerModeEvaluatesIntegers) {
+    ProgrammerMode programmer;
+    SharedEngine engine(programmer);
+    EvaluationScratch scratch;
+    ASSERT_TRUE(engine.isInteger());
+    EXPECT_FALSE(SharedEngine(mode).isInteger());
+
+    for (const char* expr : {"7 / 2", "0x20000000000001", "1 << 62", "~0", "0xFF ^ 0x0F", "1 / 0", "1 +"}) {
+        IntegerResult expected = programmer.evaluateInteger(expr);
+        IntegerResult actual = engine.evaluateInteger(expr, scratch);
+        ASSERT_EQ(actual.isSuccess(), expected.isSuccess()) << expr;
+        if (expected.isSuccess()) {
+            EXPECT_EQ(actual.getBits(), expected.getBits()) << expr;
+            EXPECT_EQ(engine.formatInteger(actual), programmer.formatResult(expected)) << expr;
+        } else {
+            EXPECT_EQ(actual.getErrorCode(), expected.getErrorCode()) << expr;
+        }
+        EXPECT_EQ(engine.evaluate(expr, scratch).isSuccess(), expected.isSuccess()) << expr;
+    }
+    EXPECT_EQ(engine.evaluate("7 / 2", scratch).getValue(), 3.0);
+}
+
+TEST_F(SharedEngineTest, PrecisionModeEvaluatesExactly) {
+    PrecisionMode precision(30);
+    SharedEngine engine(precision);
+    EvaluationScratch scratch;
+    ASSERT_TRUE(engine.isPrecise());
+    EXPECT_FALSE(engine.isInteger());
+    EXPECT_FALSE(SharedEngine(mode).isPrecise());
+
+    for (const char* expr : {"0.1 + 0.2", "1 / 3", "sqrt(2)", "2^100 + 1", "1 / 0", "1 +"}) {
+        BigFloatResult expected = precision.evaluatePrecise(expr);
+        BigFloatResult actual = engine.evaluatePrecise(expr, scratch);
+        ASSERT_EQ(actual.isSuccess(), expected.isSuccess()) << expr;
+        if (expected.isSuccess()) {
+            EXPECT_EQ(engine.formatPrecise(actual), precision.formatResult(expected)) << expr;
+        } else {
+            EXPECT_EQ(actual.getErrorCode(), expected.getErrorCode()) << expr;
+        }
+    }
+    EXPECT_EQ(engine.formatPrecise(engine.evaluatePrecise("0.1 + 0.2", scratch)), "0.3");
+    EXPECT_EQ(engine.evaluate("0.1 + 0.2", scratch).getValue(), 0.3);
+}
+
+TEST_F(SharedEngineTest, UsesTheModesParser) {
+    mode.setParserType(ParserType::RECURSIVE_DESCENT);
+    SharedEngine engine(mode);
+    expectSameAsMode(engine, "1 2");
+    expectSameAsMode(engine, "(1 + 2");
+    expectSameAsMode(engine, "2 ^ 3 ^ 2");
+
+    // The shunting-yard parser reports the same error differently
+    ScientificMode shuntingYard;
+    SharedEngine other(shuntingYard);
+    EXPECT_NE(engine.evaluate("1 2").getErrorMessage(), other.evaluate("1 2").getErrorMessage());
+}
+
+TEST_F(SharedEngineTest, EvaluatesViewsIntoALargerBuffer) {
+    SharedEngine engine(mode);
+    EvaluationScratch scratch;
+    const std::string buffer = "1 + 2\n10 / 4\n1 +";
+    std::string_view view(buffer);
+
+    EXPECT_DOUBLE_EQ(engine.evaluate(view.substr(0, 5), scratch).getValue(), 3.0);
+    EXPECT_DOUBLE_EQ(engine.evaluate(view.substr(6, 6), scratch).getValue(), 2.5);
+    EXPECT_DOUBLE_EQ(engine.evaluate(view.substr(6, 6), scratch).getValue(), 2.5);
+    EXPECT_EQ(engine.evaluate(view.substr(13), scratch).getErrorCode(), ErrorCode::UNEXPECTED_TOKEN);
+
+    // Views with the same text share one program
+    EXPECT_EQ(engine.getCacheStats().size, 2u);
+}
+
+TEST_F(SharedEngineTest, PreloadsFromArchive) {
+    const std::vector<std::string> corpus = {"sin(x) * 2", "x / 0", "max(1, 2) + x", "sin(x) * 2"};
+    mode.getContext().setVariable("x", 0.5);
+    ExpressionArchiveWriter writer;
+    for (const auto& expr : corpus) {
+        Tokenizer tokenizer(expr);
+        writer.add(*ShuntingYardParser().parse(tokenizer.tokenize()), expr);
+    }
+    writer.add(*ShuntingYardParser().parse(Tokenizer("1 + 1").tokenize()));  // No source
+    ExpressionArchive archive = ExpressionArchive::fromBuffer(writer.serialize());
+
+    SharedEngine engine(mode);
+    EXPECT_EQ(engine.preload(archive), 3u);
+    EXPECT_EQ(engine.getCacheStats().size, 3u);
+    for (const auto& expr : corpus) {
+        expectSameAsMode(engine, expr);
+    }
+    CacheStats stats = engine.getCacheStats();
+    EXPECT_EQ(stats.misses, 0u);
+    EXPECT_EQ(stats.hits, 4u);  // Each call above uses a fresh scratch
+
+    // Stops when the cache is full
+    SharedEngine small(mode, 2);
+    EXPECT_EQ(small.preload(archive), 2u);
+    EXPECT_EQ(small.getCacheStats().size, 2u);
+}
+
+TEST_F(SharedEngineTest, ScratchMovesBetweenEngines) {
+    ProgrammerMode programmer;
+    SharedEngine power(mode);
+    SharedEngine xorEngine(programmer);
+    EvaluationScratch scratch;
+
+    EXPECT_DOUBLE_EQ(power.evaluate("6 ^ 3", scratch).getValue(), 216.0);
+    EXPECT_DOUBLE_EQ(xorEngine.evaluate("6 ^ 3", scratch).getValue(), 5.0);
+    EXPECT_DOUBLE_EQ(power.evaluate("6 ^ 3", scratch).getValue(), 216.0);
+}
+
+TEST_F(SharedEngineTest, BatchOverColumns) {
+    SharedEngine engine(mode);
+    EvaluationScratch scratch;
+    const std::vector<double> x = {0.0, 1.0, 2.0, 4.0};
+    std::vector<double> out(x.size());
+
+    BatchResult result = engine.evaluateBatch("sqrt(x) * 2", {{"x", x.data()}},
+                                              x.size(), out.data(), scratch);
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(out[3], 4.0);
+
+    result = engine.evaluateBatch("x +", {{"x", x.data()}}, x.size(), out.data(), scratch);
+    EXPECT_EQ(result.failedRows, x.size());
+}
+
+TEST_F(SharedEngineTest, ConcurrentEvaluationMatchesSingleThreaded) {
+    std::vector<std::string> expressions;
+    for (int i = 0; i < 200; ++i) {
+        const std::string n = std::to_string(i);
+        expressions.push_back("sin(" + n + ") * cos(" + n + ") + " + n + " / 7");
+        expressions.push_back("max(" + n + ", 100) - sqrt(" + n + ")");
+        expressions.push_back(n + " / (" + n + " % 3)");  // Fails for every third i
+    }
+
+    std::vector<EvaluationResult> expected;
+    for (const auto& expr : expressions) {
+        expected.push_back(mode.evaluate(expr));
+    }
+
+    // A small cache forces threads to build and evict programs concurrently
+    SharedEngine engine(mode, 32);
+    const unsigned threadCount = std::max(4u, std::thread::hardware_concurrency());
+    std::vector<size_t> mismatches(threadCount, 0);
+    std::vector<std::thread> threads;
+
+    for (unsigned t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            EvaluationScratch scratch;
+            for (size_t round = 0; round < 5; ++round) {
+                for (size_t i = 0; i < expressions.size(); ++i) {
+                    size_t index = (i * (size_t{t} + 1) + round) % expressions.size();
+                    EvaluationResult actual = (t % 2 == 0)
+                        ? engine.evaluate(expressions[index], scratch)
+                        : engine.evaluate(expressions[index]);
+                    const EvaluationResult& want = expected[index];
+                    bool same = actual.isSuccess() == want.isSuccess() &&
+                        (want.isSuccess() ? actual.getValue() == want.getValue()
+                                          : actual.getErrorCode() == want.getErrorCode());
+                    if (!same) {
+                        ++mismatches[t];
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (unsigned t = 0; t < threadCount; ++t) {
+        EXPECT_EQ(mismatches[t], 0u) << "thread " << t;
+    }
+    EXPECT_LE(engine.getCacheStats().size, 32u);
+}
@@ -6,6 +6,9 @@
 #include <gtest/gtest.h>
 #include "calc/modes/standard_mode.h"
 #include "calc/modes/mode_manager.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <cmath>
 
 using namespace calc;
 
@@ -235,6 +238,15 @@ TEST_F(StandardModeTest, SetParserTypeToShuntingYard) {
     EXPECT_EQ(mode_->getParserType(), "shunting-yard");
 }
 
+TEST_F(StandardModeTest, SetParserTypeToPratt) {
+    mode_->setParserType(ParserType::PRATT);
+    EXPECT_EQ(mode_->getParserType(), "pratt");
+
+    auto result = mode_->evaluate("2 ^ 3 ^ 2 - -4 * max(1, 2)");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 520.0);
+}
+
 TEST_F(StandardModeTest, BothParsersGiveSameResult) {
     mode_->setParserType(false);
     auto result1 = mode_->evaluate("2 + 3 * 4 - 6 / 2");
@@ -251,7 +263,7 @@ TEST_F(StandardModeTest, BothParsersGiveSameResult) {
 TEST_F(StandardModeTest, ModeManagerRegistration) {
     ModeManager manager;
     EXPECT_TRUE(manager.hasMode("standard"));
-    EXPECT_EQ(manager.getModeCount(), 3);  // standard + scientific + programmer
+    EXPECT_EQ(manager.getModeCount(), 4);  // standard + scientific + programmer + precision
 }
 
 TEST_F(StandardModeTest, ModeManagerGetDefault) {
@@ -271,6 +283,178 @@ TEST_F(StandardModeTest, ModeManagerEvaluate) {
     EXPECT_DOUBLE_EQ(result.getValue(), 5.0);
 }
 
+TEST_F(StandardModeTest, ModeManagerBuildsModesOnFirstUse) {
+    ModeManager manager;
+    EXPECT_EQ(manager.getAvailableModes(),
+              (std::vector<std::string>{"precision", "programmer", "scientific", "standard"}));
+    EXPECT_TRUE(manager.hasMode("scientific"));
+    EXPECT_FALSE(manager.isModeBuilt("scientific"));
+
+    const ModeManager& constManager = manager;
+    const Mode* scientific = constManager.getMode("scientific");
+    ASSERT_NE(scientific, nullptr);
+    EXPECT_EQ(scientific->getName(), "scientific");
+    EXPECT_TRUE(manager.isModeBuilt("scientific"));
+    EXPECT_EQ(manager.getMode("scientific"), scientific);
+    EXPECT_FALSE(manager.isModeBuilt("standard"));
+    EXPECT_FALSE(manager.isModeBuilt("precision"));
+}
+
+TEST_F(StandardModeTest, ModeManagerFactories) {
+    ModeManager manager;
+    int built = 0;
+    EXPECT_TRUE(manager.registerModeFactory("basic", [&built] {
+        ++built;
+        return std::make_unique<StandardMode>();
+    }));
+    EXPECT_FALSE(manager.registerModeFactory("standard", [] { return std::make_unique<StandardMode>(); }));
+    EXPECT_FALSE(manager.registerModeFactory("empty", nullptr));
+    EXPECT_FALSE(manager.registerMode(std::make_unique<StandardMode>()));
+    EXPECT_EQ(manager.getModeCount(), 5u);
+    EXPECT_EQ(built, 0);
+
+    ASSERT_NE(manager.getMode("basic"), nullptr);
+    ASSERT_NE(manager.getMode("basic"), nullptr);
+    EXPECT_EQ(built, 1);
+    EXPECT_EQ(manager.getMode("missing"), nullptr);
+}
+
+// Test parsed-expression cache
+TEST_F(StandardModeTest, RepeatedExpressionHitsCache) {
+    for (int i = 0; i < 3; ++i) {
+        auto result = mode_->evaluate("(1 + 2) * 3");
+        ASSERT_TRUE(result.isSuccess());
+        EXPECT_DOUBLE_EQ(result.getValue(), 9.0);
+    }
+
+    CacheStats stats = mode_->getCacheStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.size, 1u);
+}
+
+TEST_F(StandardModeTest, ParseErrorsAreNotCached) {
+    EXPECT_TRUE(mode_->evaluate("1 +").isError());
+    EXPECT_TRUE(mode_->evaluate("1 +").isError());
+    EXPECT_EQ(mode_->getCacheStats().size, 0u);
+}
+
+TEST_F(StandardModeTest, ParserSwitchUsesSeparateEntry) {
+    (void)mode_->evaluate("2 ^ 3 ^ 2");
+    mode_->setParserType(true);
+    auto result = mode_->evaluate("2 ^ 3 ^ 2");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 512.0);
+    EXPECT_EQ(mode_->getCacheStats().size, 2u);
+}
+
+TEST_F(StandardModeTest, CacheCapacityZeroDisablesCache) {
+    mode_->setCacheCapacity(0);
+    (void)mode_->evaluate("1 + 1");
+    (void)mode_->evaluate("1 + 1");
+
+    CacheStats stats = mode_->getCacheStats();
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.misses, 2u);
+}
+
+TEST_F(StandardModeTest, CacheCapacityZeroWalksTheTree) {
+    mode_->setCacheCapacity(0);
+    auto result = mode_->evaluate("sqrt(16) + 2 ^ 3");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 12.0);
+
+    result = mode_->evaluate("1 / 0");
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::DIVISION_BY_ZERO);
+}
+
+TEST_F(StandardModeTest, CompiledProgramMatchesTreeWalk) {
+    const char* expressions[] = {"2 ^ 3 ^ 2", "-(4 - 6) * 3 % 4", "max(1, 7, 3) / 2",
+                                 "sin(0) + abs(-2)", "1 / (2 - 2)", "sqrt(-1)", "nope(1)"};
+    EvaluatorVisitor evaluator;
+    for (const char* expression : expressions) {
+        auto compiled = mode_->evaluate(expression);
+        auto cached = mode_->evaluate(expression);  // Runs the cached bytecode
+        Tokenizer tokenizer(expression);
+        ShuntingYardParser parser;
+        auto walked = evaluator.evaluate(parser.parse(tokenizer.tokenize()).get(), mode_->getContext());
+
+        ASSERT_EQ(compiled.isSuccess(), walked.isSuccess()) << expression;
+        EXPECT_EQ(cached.isSuccess(), walked.isSuccess()) << expression;
+        if (walked.isSuccess()) {
+            EXPECT_DOUBLE_EQ(compiled.getValue(), walked.getValue()) << expression;
+            EXPECT_DOUBLE_EQ(cached.getValue(), walked.getValue()) << expression;
+        } else {
+            EXPECT_EQ(compiled.getErrorCode(), walked.getErrorCode()) << expression;
+            EXPECT_EQ(compiled.getErrorMessage(), walked.getErrorMessage()) << expression;
+            EXPECT_EQ(compiled.getErrorPosition(), walked.getErrorPosition()) << expression;
+        }
+    }
+}
+
+TEST_F(StandardModeTest, NewBindingsRecompileCachedPrograms) {
+    auto result = mode_->evaluate("rate * 2");
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::UNDEFINED_VARIABLE);
+
+    // Compiled with the name unbound; defining it must not leave the old program in use
+    size_t slot = mode_->getContext().setVariable("rate", 3.0);
+    result = mode_->evaluate("rate * 2");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 6.0);
+
+    // Assigning a value is read at run time
+    mode_->getContext().setVariable(slot, 5.0);
+    EXPECT_DOUBLE_EQ(mode_->evaluate("rate * 2").getValue(), 10.0);
+
+    mode_->getContext().addFunction("sqrt", [](double v) { return v + 1.0; });
+    EXPECT_DOUBLE_EQ(mode_->evaluate("sqrt(rate)").getValue(), 6.0);
+
+    mode_->getContext().setOperatorSemantics("^", OperatorSemantics::BITWISE_XOR);
+    EXPECT_DOUBLE_EQ(mode_->evaluate("6 ^ 3").getValue(), 5.0);
+    EXPECT_EQ(mode_->getCacheStats().misses, 3u);
+}
+
+// Test variables and batch evaluation
+TEST_F(StandardModeTest, EvaluateVariables) {
+    mode_->getContext().setVariable("width", 3.0);
+    mode_->getContext().setVariable("height", 4.0);
+
+    auto result = mode_->evaluate("width * height / 2");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_DOUBLE_EQ(result.getValue(), 6.0);
+
+    result = mode_->evaluate("depth + 1");
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(result.getErrorCode(), ErrorCode::UNDEFINED_VARIABLE);
+}
+
+TEST_F(StandardModeTest, EvaluateBatch) {
+    const std::vector<double> x = {0.0, 1.0, 2.0};
+    const std::vector<double> y = {1.0, 1.0, 1.0};
+    std::vector<double> out(x.size());
+
+    BatchResult result = mode_->evaluateBatch("x ^ 2 + y", {{"x", x.data()}, {"y", y.data()}},
+                                              x.size(), out.data());
+    EXPECT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.rows, 3u);
+    EXPECT_DOUBLE_EQ(out[0], 1.0);
+    EXPECT_DOUBLE_EQ(out[1], 2.0);
+    EXPECT_DOUBLE_EQ(out[2], 5.0);
+}
+
+TEST_F(StandardModeTest, EvaluateBatchParseError) {
+    const std::vector<double> x = {1.0, 2.0};
+    std::vector<double> out(x.size());
+
+    BatchResult result = mode_->evaluateBatch("x +", {{"x", x.data()}}, x.size(), out.data());
+    EXPECT_EQ(result.failedRows, 2u);
+    ASSERT_TRUE(result.firstError.has_value());
+    EXPECT_TRUE(std::isnan(out[0]));
+    EXPECT_TRUE(std::isnan(out[1]));
+}
+
 // Test context access
 TEST_F(StandardModeTest, GetContext) {
     EvaluationContext& context = mode_->getContext();
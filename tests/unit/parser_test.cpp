@@ -10,6 +10,7 @@
 #include "calc/core/recursive_descent_parser.h"
 #include "calc/core/tokenizer.h"
 #include <gtest/gtest.h>
+#include <stdexcept>
 
 using namespace calc;
 
@@ -199,6 +200,79 @@ TEST(ParserTest, BothParsersThrowOnUnbalancedParentheses) {
     EXPECT_THROW(rdParser.parse(tokens), SyntaxError);
 }
 
+// ============================================================================
+// Integer Literal Tests
+// ============================================================================
+
+// Whole literals keep their exact 64-bit value next to the double
+TEST(ParserTest, LiteralsCarryExactIntegers) {
+    ShuntingYardParser shuntingParser;
+    RecursiveDescentParser rdParser;
+
+    for (Parser* parser : {static_cast<Parser*>(&shuntingParser), static_cast<Parser*>(&rdParser)}) {
+        auto big = parser->parse(tokenize("0xFFFFFFFFFFFFFFFF"));
+        auto* hex = dynamic_cast<LiteralNode*>(big.get());
+        ASSERT_NE(hex, nullptr);
+        EXPECT_TRUE(hex->hasInteger());
+        EXPECT_EQ(hex->getInteger(), 0xFFFFFFFFFFFFFFFFull);
+
+        auto odd = parser->parse(tokenize("9007199254740993"));
+        auto* decimal = dynamic_cast<LiteralNode*>(odd.get());
+        ASSERT_NE(decimal, nullptr);
+        EXPECT_EQ(decimal->getInteger(), 9007199254740993ull);
+        EXPECT_EQ(decimal->getValue(), 9007199254740992.0);
+        EXPECT_EQ(decimal->clone()->toString(), odd->toString());
+        EXPECT_EQ(static_cast<LiteralNode*>(decimal->clone().get())->getInteger(), 9007199254740993ull);
+
+        auto fraction = parser->parse(tokenize("2.5"));
+        EXPECT_FALSE(static_cast<LiteralNode*>(fraction.get())->hasInteger());
+    }
+}
+
+TEST(ParserTest, WideLiteralsKeepTheirDigits) {
+    ShuntingYardParser parser;
+
+    auto wide = parser.parse(tokenize("0x1FFFFFFFFFFFFFFFF"));
+    auto* hex = dynamic_cast<LiteralNode*>(wide.get());
+    ASSERT_NE(hex, nullptr);
+    ASSERT_TRUE(hex->isWide());
+    EXPECT_EQ(hex->getDigits(), "1FFFFFFFFFFFFFFFF");
+    EXPECT_EQ(hex->getBase(), NumberBase::HEXADECIMAL);
+    EXPECT_EQ(hex->getInteger(), 0xFFFFFFFFFFFFFFFFull);  // Wrapped to 64 bits
+
+    auto copy = hex->clone();
+    EXPECT_EQ(static_cast<LiteralNode*>(copy.get())->getDigits(), "1FFFFFFFFFFFFFFFF");
+
+    auto decimal = parser.parse(tokenize("123456789012345678901234567890"));
+    ASSERT_TRUE(static_cast<LiteralNode*>(decimal.get())->isWide());
+    EXPECT_EQ(static_cast<LiteralNode*>(decimal.get())->getBase(), NumberBase::DECIMAL);
+
+    auto narrow = parser.parse(tokenize("0xFFFFFFFFFFFFFFFF"));
+    EXPECT_FALSE(static_cast<LiteralNode*>(narrow.get())->isWide());
+    EXPECT_THROW(static_cast<LiteralNode*>(narrow.get())->getDigits(), std::logic_error);
+}
+
+TEST(ParserTest, KeepsDecimalDigitsOnRequest) {
+    ShuntingYardParser parser;
+    EXPECT_FALSE(parser.getKeepLiteralDigits());
+    auto plain = parser.parse(tokenize("0.1"));
+    EXPECT_FALSE(static_cast<LiteralNode*>(plain.get())->hasDigits());
+
+    parser.setKeepLiteralDigits(true);
+    auto kept = parser.parse(tokenize("0.1"));
+    auto* tenth = dynamic_cast<LiteralNode*>(kept.get());
+    ASSERT_NE(tenth, nullptr);
+    ASSERT_TRUE(tenth->hasDigits());
+    EXPECT_FALSE(tenth->isWide());
+    EXPECT_EQ(tenth->getDigits(), "0.1");
+    EXPECT_EQ(tenth->getValue(), 0.1);
+    EXPECT_EQ(static_cast<LiteralNode*>(tenth->clone().get())->getDigits(), "0.1");
+
+    // Integer literals keep their exact integer as before
+    auto whole = parser.parse(tokenize("42"));
+    EXPECT_TRUE(static_cast<LiteralNode*>(whole.get())->hasInteger());
+}
+
 // ============================================================================
 // Parser Metadata Tests
 // ============================================================================
@@ -0,0 +1,236 @@
+/**
+ * @file pratt_parser_test.cpp
+ * @brief Unit tests for PrattParser class
+ */
+
+#include "calc/core/pratt_parser.h"
+#include "calc/core/shunting_yard_parser.h"
+#include "calc/core/tokenizer.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace calc;
+
+namespace {
+
+// Helper function to parse a string expression using PrattParser
+std::unique_ptr<ASTNode> parseExpression(const std::string& expr, bool enableUnary = true) {
+    Tokenizer tokenizer(expr);
+    auto tokens = tokenizer.tokenize();
+    PrattParser parser(enableUnary);
+    return parser.parse(tokens);
+}
+
+// Helper function to get string representation of parsed expression
+std::string parseToString(const std::string& expr) {
+    return parseExpression(expr)->toString();
+}
+
+// @p text repeated @p count times
+std::string repeat(const std::string& text, size_t count) {
+    std::string result;
+    for (size_t i = 0; i < count; ++i) {
+        result += text;
+    }
+    return result;
+}
+
+// Parse with @p parser and return the error it reports
+CalculatorException parseError(Parser& parser, const std::string& expr) {
+    Tokenizer tokenizer(expr);
+    auto tokens = tokenizer.tokenize();
+    try {
+        (void)parser.parse(tokens);
+    } catch (const CalculatorException& e) {
+        return e;
+    }
+    ADD_FAILURE() << "Expected an error for: " << expr;
+    return CalculatorException(ErrorCode::UNKNOWN_ERROR, "", 0);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Parser Construction Tests
+// ============================================================================
+
+TEST(PrattParserTest, DefaultConstruction) {
+    PrattParser parser;
+    EXPECT_TRUE(parser.isUnaryOperatorsEnabled());
+}
+
+TEST(PrattParserTest, SetUnaryOperatorsEnabled) {
+    PrattParser parser(false);
+    EXPECT_FALSE(parser.isUnaryOperatorsEnabled());
+
+    parser.setUnaryOperatorsEnabled(true);
+    EXPECT_TRUE(parser.isUnaryOperatorsEnabled());
+}
+
+TEST(PrattParserTest, GetName) {
+    PrattParser parser;
+    EXPECT_EQ(parser.getName(), "PrattParser");
+}
+
+// ============================================================================
+// Tree Shape Tests
+// ============================================================================
+
+TEST(PrattParserTest, ParseSingleValues) {
+    auto literal = parseExpression("42");
+    ASSERT_NE(dynamic_cast<LiteralNode*>(literal.get()), nullptr);
+    EXPECT_DOUBLE_EQ(static_cast<LiteralNode*>(literal.get())->getValue(), 42.0);
+
+    auto variable = parseExpression("x");
+    ASSERT_NE(dynamic_cast<VariableNode*>(variable.get()), nullptr);
+}
+
+TEST(PrattParserTest, Precedence) {
+    EXPECT_EQ(parseToString("1 + 2 * 3"), "(1 + (2 * 3))");
+    EXPECT_EQ(parseToString("1 * 2 + 3"), "((1 * 2) + 3)");
+    EXPECT_EQ(parseToString("2 * 3 ^ 2"), "(2 * (3 ^ 2))");
+    EXPECT_EQ(parseToString("(1 + 2) * 3"), "((1 + 2) * 3)");
+}
+
+TEST(PrattParserTest, Associativity) {
+    EXPECT_EQ(parseToString("1 - 2 - 3"), "((1 - 2) - 3)");
+    EXPECT_EQ(parseToString("8 / 4 / 2"), "((8 / 4) / 2)");
+    EXPECT_EQ(parseToString("2 ^ 3 ^ 2"), "(2 ^ (3 ^ 2))");
+}
+
+TEST(PrattParserTest, UnaryOperators) {
+    auto ast = parseExpression("-5");
+    auto* unary = dynamic_cast<UnaryOpNode*>(ast.get());
+    ASSERT_NE(unary, nullptr);
+    EXPECT_EQ(unary->getOpCode(), OpCode::NEG);
+
+    EXPECT_EQ(parseToString("-2 ^ 2"), parseToString("-(2 ^ 2)"));
+    EXPECT_EQ(parseToString("2 * -3"), "(2 * (-3))");
+}
+
+TEST(PrattParserTest, UnaryDisabled) {
+    EXPECT_THROW(parseExpression("-5", false), CalculatorException);
+    EXPECT_EQ(parseExpression("1 - 5", false)->toString(), "(1 - 5)");
+}
+
+TEST(PrattParserTest, FunctionCalls) {
+    auto ast = parseExpression("max(1, 2 + 3, sin(x))");
+    auto* call = dynamic_cast<FunctionCallNode*>(ast.get());
+    ASSERT_NE(call, nullptr);
+    EXPECT_EQ(call->getName(), "max");
+    EXPECT_EQ(call->getArguments().size(), 3u);
+}
+
+TEST(PrattParserTest, EmptyArgumentList) {
+    auto ast = parseExpression("rand()");
+    auto* call = dynamic_cast<FunctionCallNode*>(ast.get());
+    ASSERT_NE(call, nullptr);
+    EXPECT_TRUE(call->getArguments().empty());
+}
+
+TEST(PrattParserTest, DeeplyNestedParentheses) {
+    std::string expr = std::string(200, '(') + "1" + std::string(200, ')');
+    auto ast = parseExpression(expr);
+    ASSERT_NE(dynamic_cast<LiteralNode*>(ast.get()), nullptr);
+}
+
+TEST(PrattParserTest, NestingDepthLimit) {
+    const size_t deep = Parser::MAX_NESTING_DEPTH * 10;
+    PrattParser parser;
+
+    const size_t limit = Parser::MAX_NESTING_DEPTH - 1;
+    EXPECT_NO_THROW(parseExpression(repeat("(", limit) + "1" + repeat(")", limit)));
+
+    // Left-associative chains do not nest, however long
+    EXPECT_NO_THROW(parseExpression("1" + repeat("+1", deep)));
+
+    // Deeper input is an error rather than a stack overflow
+    for (const std::string& expr : {repeat("(", deep) + "1" + repeat(")", deep),
+                                    repeat("-", deep) + "1",
+                                    "2" + repeat("^2", deep),
+                                    repeat("max(1,", deep) + "1" + repeat(")", deep)}) {
+        EXPECT_EQ(parseError(parser, expr).getErrorCode(), ErrorCode::PARSE_ERROR)
+            << "expression: " << expr.substr(0, 10) << "...";
+    }
+}
+
+// ============================================================================
+// Error Handling Tests
+// ============================================================================
+
+TEST(PrattParserTest, Errors) {
+    PrattParser parser;
+
+    EXPECT_EQ(parseError(parser, "").getErrorCode(), ErrorCode::INVALID_SYNTAX);
+    EXPECT_EQ(parseError(parser, "1 +").getErrorCode(), ErrorCode::UNEXPECTED_TOKEN);
+    EXPECT_EQ(parseError(parser, "1 2").getErrorCode(), ErrorCode::UNEXPECTED_TOKEN);
+
+    CalculatorException unbalanced = parseError(parser, "1 + 2)");
+    EXPECT_EQ(unbalanced.getErrorCode(), ErrorCode::INVALID_SYNTAX);
+    EXPECT_EQ(unbalanced.getPosition(), 5u);
+
+    CalculatorException consecutive = parseError(parser, "1 * / 2");
+    EXPECT_EQ(consecutive.getErrorCode(), ErrorCode::INVALID_SYNTAX);
+    EXPECT_EQ(consecutive.getPosition(), 4u);
+}
+
+// The same trees and the same errors as ShuntingYardParser
+TEST(PrattParserTest, MatchesShuntingYardTrees) {
+    const std::vector<std::string> corpus = {
+        "1", "x", "1 + 2", "1 + 2 * 3 - 4 / 5 % 6", "2 ^ 3 ^ 2", "(2 ^ 3) ^ 2",
+        "-2 ^ 2", "2 ^ -2", "2 ^ -3 ^ 2", "-x * 3 + 1", "--5", "+-5", "-(-5)",
+        "5 + -3", "5 * -3", "+5 + +3", "2 * -3 + 1", "1 - -1 - -1",
+        "1 & 2 | 3 & 4", "1 << 2 << 3", "1 << 2 ^ 3", "2 ^ 3 << 1", "~1 & 2",
+        "-2 << 1", "1 + 2 << 3 * 4",
+        "sin(x)", "max(1, 2, 3)", "max(1 + 2, min(3, 4) * 5, -6)", "sqrt(x ^ 2 + y ^ 2)",
+        "((((1))))", "(1 + 2) * (3 - 4) / (5 ^ (6 - 7))", "0x1F + 0b101 * 0o17",
+        "PI * r ^ 2", "f(g(h(1)))", "1e3 * 2.5e-2",
+    };
+
+    ShuntingYardParser reference;
+    PrattParser parser;
+    for (const auto& expr : corpus) {
+        Tokenizer tokenizer(expr);
+        auto tokens = tokenizer.tokenize();
+        EXPECT_EQ(parser.parse(tokens)->toString(), reference.parse(tokens)->toString())
+            << "expression: " << expr;
+    }
+}
+
+// Where ShuntingYardParser takes the operand missing from an empty group or
+// argument from an enclosing expression, or ignores an empty group
+TEST(PrattParserTest, KnownShuntingYardDivergences) {
+    PrattParser parser;
+
+    CalculatorException nearest = parseError(parser, "1 + 2 * max(,1)");
+    EXPECT_EQ(nearest.getErrorCode(), ErrorCode::UNEXPECTED_TOKEN);
+    EXPECT_EQ(nearest.getPosition(), 6u);  // ShuntingYardParser: '+' at 2
+
+    nearest = parseError(parser, "max(1, max(,2))");
+    EXPECT_EQ(nearest.getPosition(), 7u);  // ShuntingYardParser: the outer max at 0
+
+    EXPECT_EQ(parseError(parser, "()2").getErrorCode(), ErrorCode::INVALID_SYNTAX);
+    EXPECT_EQ(parseError(parser, "2()").getErrorCode(), ErrorCode::UNEXPECTED_TOKEN);
+}
+
+TEST(PrattParserTest, MatchesShuntingYardErrors) {
+    const std::vector<std::string> corpus = {
+        "", "+", "*", "1 +", "1 *", "* 2", "1 2", "(1) 2", "2 (3)", "x y",
+        "(", ")", "(1 + 2", "1 + 2)", "((1)", "(1))", "max(1, 2", "sin(1))",
+        "1 ** 2", "1 */ 2", "1 | ~2", "1 + * 2", "1 ++ 2", "1 * / 2",
+        ",", "1, 2", "(*2)", "1 + (", "-", "(-", "1 + ()",
+        "()", "(())", "(()())", "() + 1", "() * ()", "-()", "2 * -()", "(() + 1)", "2 * (() + 1)",
+        "(()", "())", "max(1,,2)", "max(,1)", "max(1,)", "max(,)", "max(())", "max((), 1)",
+        "max(1, ())", "1 + max(,1)", "max(1,) + 1", "max(max(,1), 2)", "max(-(), 1)",
+    };
+
+    ShuntingYardParser reference;
+    PrattParser parser;
+    for (const auto& expr : corpus) {
+        CalculatorException expected = parseError(reference, expr);
+        CalculatorException actual = parseError(parser, expr);
+        EXPECT_EQ(actual.getErrorCode(), expected.getErrorCode()) << "expression: " << expr;
+        EXPECT_EQ(actual.getPosition(), expected.getPosition()) << "expression: " << expr;
+    }
+}
@@ -6,6 +6,9 @@
 #include "calc/core/recursive_descent_parser.h"
 #include "calc/core/tokenizer.h"
 #include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace calc;
 
@@ -25,6 +28,15 @@ std::string parseToString(const std::string& expr) {
     return ast->toString();
 }
 
+// @p text repeated @p count times
+std::string repeat(const std::string& text, size_t count) {
+    std::string result;
+    for (size_t i = 0; i < count; ++i) {
+        result += text;
+    }
+    return result;
+}
+
 } // anonymous namespace
 
 // ============================================================================
@@ -75,6 +87,24 @@ TEST(RecursiveDescentParserTest, ParseSingleDecimal) {
     EXPECT_DOUBLE_EQ(literal->getValue(), 3.14);
 }
 
+TEST(RecursiveDescentParserTest, ParsePrefixedLiterals) {
+    for (const auto& [expr, expected] : std::vector<std::pair<std::string, double>>{
+             {"0xFF", 255.0}, {"0b1010", 10.0}, {"0o17", 15.0}}) {
+        auto ast = parseExpression(expr);
+        auto* literal = dynamic_cast<LiteralNode*>(ast.get());
+
+        ASSERT_NE(literal, nullptr) << expr;
+        EXPECT_DOUBLE_EQ(literal->getValue(), expected) << expr;
+    }
+}
+
+TEST(RecursiveDescentParserTest, ParseInvalidNumberToken) {
+    std::vector<Token> tokens = {Token(TokenType::NUMBER, "1.2.3", 0),
+                                 Token(TokenType::EOF_TOKEN, "", 5)};
+    RecursiveDescentParser parser;
+    EXPECT_THROW(parser.parse(tokens), SyntaxError);
+}
+
 TEST(RecursiveDescentParserTest, ParseScientificNotation) {
     auto ast = parseExpression("1.23e4");
     auto* literal = dynamic_cast<LiteralNode*>(ast.get());
@@ -625,6 +655,28 @@ TEST(RecursiveDescentParserTest, MisplacedComma) {
     EXPECT_THROW(parser.parse(tokens), SyntaxError);
 }
 
+TEST(RecursiveDescentParserTest, NestingDepthLimit) {
+    const size_t deep = Parser::MAX_NESTING_DEPTH * 10;
+    RecursiveDescentParser parser;
+
+    const size_t limit = Parser::MAX_NESTING_DEPTH - 1;
+    EXPECT_NO_THROW(parseExpression(repeat("(", limit) + "1" + repeat(")", limit)));
+
+    // Deeper input is an error rather than a stack overflow
+    for (const std::string& expr : {repeat("(", deep) + "1" + repeat(")", deep),
+                                    repeat("-", deep) + "1",
+                                    "2" + repeat("^2", deep)}) {
+        Tokenizer tokenizer(expr);
+        auto tokens = tokenizer.tokenize();
+        try {
+            (void)parser.parse(tokens);
+            ADD_FAILURE() << "Expected a nesting error for " << expr.substr(0, 10) << "...";
+        } catch (const CalculatorException& e) {
+            EXPECT_EQ(e.getErrorCode(), ErrorCode::PARSE_ERROR);
+        }
+    }
+}
+
 // ============================================================================
 // String Representation Tests
 // ============================================================================
@@ -250,6 +250,30 @@ TEST(ShuntingYardParserTest, UnaryPlusAtStart) {
     EXPECT_EQ(unary->getOperator().value, "+");
 }
 
+TEST(ShuntingYardParserTest, UnaryOpCodes) {
+    auto ast = parse("-5");
+    auto* neg = dynamic_cast<UnaryOpNode*>(ast.get());
+    ASSERT_NE(neg, nullptr);
+    EXPECT_EQ(neg->getOpCode(), OpCode::NEG);
+
+    ast = parse("1 - 5");
+    auto* sub = dynamic_cast<BinaryOpNode*>(ast.get());
+    ASSERT_NE(sub, nullptr);
+    EXPECT_EQ(sub->getOpCode(), OpCode::SUB);
+}
+
+TEST(ShuntingYardParserTest, BitwiseNotBeforeBinaryOperator) {
+    auto ast = parse("~5 & 3");
+    auto* root = dynamic_cast<BinaryOpNode*>(ast.get());
+
+    ASSERT_NE(root, nullptr);
+    EXPECT_EQ(root->getOpCode(), OpCode::BIT_AND);
+
+    auto* left = dynamic_cast<UnaryOpNode*>(root->getLeft());
+    ASSERT_NE(left, nullptr);
+    EXPECT_EQ(left->getOpCode(), OpCode::BIT_NOT);
+}
+
 TEST(ShuntingYardParserTest, UnaryMinusInExpression) {
     auto ast = parse("-5+3");
     auto* root = dynamic_cast<BinaryOpNode*>(ast.get());
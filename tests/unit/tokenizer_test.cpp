@@ -5,6 +5,9 @@
 
 #include "calc/core/tokenizer.h"
 #include <gtest/gtest.h>
+#include <cmath>
+#include <string_view>
+#include <vector>
 
 using namespace calc;
 
@@ -16,6 +19,7 @@ TEST(TokenTest, TokenTypeToString) {
     EXPECT_EQ(tokenTypeToString(TokenType::NUMBER), "NUMBER");
     EXPECT_EQ(tokenTypeToString(TokenType::OPERATOR), "OPERATOR");
     EXPECT_EQ(tokenTypeToString(TokenType::FUNCTION), "FUNCTION");
+    EXPECT_EQ(tokenTypeToString(TokenType::VARIABLE), "VARIABLE");
     EXPECT_EQ(tokenTypeToString(TokenType::LPAREN), "LPAREN");
     EXPECT_EQ(tokenTypeToString(TokenType::RPAREN), "RPAREN");
     EXPECT_EQ(tokenTypeToString(TokenType::COMMA), "COMMA");
@@ -75,6 +79,61 @@ TEST(TokenTest, OperatorPrecedence) {
     EXPECT_EQ(sub.getPrecedence(), 2);
 }
 
+TEST(TokenTest, OperatorOpCode) {
+    EXPECT_EQ(Token(TokenType::OPERATOR, "+", 0).opcode, OpCode::ADD);
+    EXPECT_EQ(Token(TokenType::OPERATOR, "^", 0).opcode, OpCode::POW);
+    EXPECT_EQ(Token(TokenType::OPERATOR, "<<", 0).opcode, OpCode::SHL);
+    EXPECT_EQ(Token(TokenType::OPERATOR, "~", 0).opcode, OpCode::BIT_NOT);
+    EXPECT_EQ(Token(TokenType::OPERATOR, "@", 0).opcode, OpCode::NONE);
+    EXPECT_EQ(Token(TokenType::NUMBER, "+", 0).opcode, OpCode::NONE);
+}
+
+TEST(TokenTest, NumberConvertedFromValue) {
+    EXPECT_DOUBLE_EQ(Token(TokenType::NUMBER, "2.5e2", 0).number, 250.0);
+    EXPECT_DOUBLE_EQ(Token(TokenType::NUMBER, "ff", 0, NumberBase::HEXADECIMAL).number, 255.0);
+    EXPECT_DOUBLE_EQ(Token(TokenType::NUMBER, "101", 0, NumberBase::BINARY).number, 5.0);
+    EXPECT_TRUE(std::isnan(Token(TokenType::NUMBER, "+", 0).number));
+    EXPECT_TRUE(std::isnan(Token(TokenType::NUMBER, "19", 0, NumberBase::OCTAL).number));
+    EXPECT_DOUBLE_EQ(Token(TokenType::OPERATOR, "+", 0).number, 0.0);
+}
+
+TEST(TokenizerTest, NumbersConvertedOnce) {
+    Tokenizer tokenizer("max(1.5, .25, 6e-1, 0x1F, 0o17, 0b101)");
+    auto tokens = tokenizer.tokenize();
+
+    const std::vector<double> expected = {1.5, 0.25, 0.6, 31.0, 15.0, 5.0};
+    std::vector<double> actual;
+    for (const auto& token : tokens) {
+        if (token.type == TokenType::NUMBER) {
+            actual.push_back(token.number);
+        }
+    }
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_DOUBLE_EQ(actual[i], expected[i]);
+    }
+    EXPECT_EQ(tokens[12].value, "101");
+}
+
+TEST(TokenizerTest, NumberOutOfRange) {
+    try {
+        Tokenizer("1 + 1e400").tokenize();
+        FAIL() << "Expected SyntaxError";
+    } catch (const SyntaxError& e) {
+        EXPECT_EQ(e.getPosition(), 4u);
+    }
+}
+
+TEST(TokenizerTest, OperatorsClassifiedOnce) {
+    Tokenizer tokenizer("1 >> 2 | 3 % 4");
+    auto tokens = tokenizer.tokenize();
+
+    ASSERT_EQ(tokens.size(), 8);
+    EXPECT_EQ(tokens[1].opcode, OpCode::SHR);
+    EXPECT_EQ(tokens[3].opcode, OpCode::BIT_OR);
+    EXPECT_EQ(tokens[5].opcode, OpCode::MOD);
+}
+
 TEST(TokenTest, OperatorPrecedenceOnNonOperator) {
     Token num(TokenType::NUMBER, "123", 0);
     EXPECT_EQ(num.getPrecedence(), 0);  // Non-operators return 0
@@ -233,37 +292,37 @@ TEST(TokenizerTest, ParenthesesPair) {
 // ============================================================================
 
 TEST(TokenizerTest, SingleLetterFunction) {
-    Tokenizer tokenizer("sin");
+    Tokenizer tokenizer("sin()");
     auto tokens = tokenizer.tokenize();
 
-    ASSERT_EQ(tokens.size(), 2);
+    ASSERT_EQ(tokens.size(), 4);
     EXPECT_EQ(tokens[0].type, TokenType::FUNCTION);
     EXPECT_EQ(tokens[0].value, "sin");
 }
 
 TEST(TokenizerTest, MultiLetterFunction) {
-    Tokenizer tokenizer("sqrt");
+    Tokenizer tokenizer("sqrt()");
     auto tokens = tokenizer.tokenize();
 
-    ASSERT_EQ(tokens.size(), 2);
+    ASSERT_EQ(tokens.size(), 4);
     EXPECT_EQ(tokens[0].type, TokenType::FUNCTION);
     EXPECT_EQ(tokens[0].value, "sqrt");
 }
 
 TEST(TokenizerTest, FunctionWithNumbers) {
-    Tokenizer tokenizer("log10");
+    Tokenizer tokenizer("log10()");
     auto tokens = tokenizer.tokenize();
 
-    ASSERT_EQ(tokens.size(), 2);
+    ASSERT_EQ(tokens.size(), 4);
     EXPECT_EQ(tokens[0].type, TokenType::FUNCTION);
     EXPECT_EQ(tokens[0].value, "log10");
 }
 
 TEST(TokenizerTest, MixedCaseFunction) {
-    Tokenizer tokenizer("SIN");
+    Tokenizer tokenizer("SIN()");
     auto tokens = tokenizer.tokenize();
 
-    ASSERT_EQ(tokens.size(), 2);
+    ASSERT_EQ(tokens.size(), 4);
     EXPECT_EQ(tokens[0].type, TokenType::FUNCTION);
     EXPECT_EQ(tokens[0].value, "SIN");
 }
@@ -352,6 +411,26 @@ TEST(TokenizerTest, ComplexExpression) {
     EXPECT_EQ(tokens[8].value, "5");
 }
 
+TEST(TokenizerTest, IdentifierWithoutParenIsVariable) {
+    Tokenizer tokenizer("x1 + PI");
+    auto tokens = tokenizer.tokenize();
+
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[0].type, TokenType::VARIABLE);
+    EXPECT_EQ(tokens[0].value, "x1");
+    EXPECT_EQ(tokens[2].type, TokenType::VARIABLE);
+    EXPECT_EQ(tokens[2].value, "PI");
+}
+
+TEST(TokenizerTest, FunctionWithSpaceBeforeParen) {
+    Tokenizer tokenizer("sin (x)");
+    auto tokens = tokenizer.tokenize();
+
+    ASSERT_EQ(tokens.size(), 5);
+    EXPECT_EQ(tokens[0].type, TokenType::FUNCTION);
+    EXPECT_EQ(tokens[2].type, TokenType::VARIABLE);
+}
+
 // ============================================================================
 // Tokenizer Tests - Function Calls
 // ============================================================================
@@ -502,6 +581,99 @@ TEST(TokenizerTest, WhitespaceOnly) {
     EXPECT_EQ(tokens[0].type, TokenType::EOF_TOKEN);
 }
 
+// ============================================================================
+// Compact tokens
+// ============================================================================
+
+TEST(TokenizerTest, CompactTokensReferIntoTheInput) {
+    std::string_view input = "sin(x) << 2.5e1 + 0xFF";
+    std::vector<CompactToken> tokens;
+    Tokenizer::tokenize(input, tokens);
+
+    ASSERT_EQ(tokens.size(), 9u);
+    EXPECT_EQ(tokens[0].type, TokenType::FUNCTION);
+    EXPECT_EQ(tokens[0].text(input), "sin");
+    EXPECT_EQ(tokens[2].type, TokenType::VARIABLE);
+    EXPECT_EQ(tokens[2].offset, 4u);
+    EXPECT_EQ(tokens[4].opcode, OpCode::SHL);
+    EXPECT_EQ(tokens[5].text(input), "2.5e1");
+    EXPECT_DOUBLE_EQ(tokens[5].number, 25.0);
+    EXPECT_EQ(tokens[7].text(input), "0xFF");
+    EXPECT_EQ(tokens[7].numberBase, NumberBase::HEXADECIMAL);
+    EXPECT_DOUBLE_EQ(tokens[7].number, 255.0);
+    EXPECT_EQ(tokens[8].type, TokenType::EOF_TOKEN);
+    EXPECT_EQ(tokens[8].offset, input.size());
+}
+
+TEST(TokenizerTest, CompactTokensMatchTokens) {
+    const std::vector<std::string> inputs = {
+        "1 + 2 * 3", "max(1, 2.5, .5)", "~0b1010 & 0o17 | 0x1f >> 2", "  PI * r ^ 2  ", "-(3)"
+    };
+
+    std::vector<CompactToken> compact;
+    for (const auto& input : inputs) {
+        Tokenizer tokenizer(input);
+        std::vector<Token> tokens = tokenizer.tokenize();
+        Tokenizer::tokenize(input, compact);
+
+        ASSERT_EQ(compact.size(), tokens.size()) << input;
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            EXPECT_EQ(compact[i].type, tokens[i].type) << input;
+            EXPECT_EQ(compact[i].offset, tokens[i].position) << input;
+            EXPECT_EQ(compact[i].opcode, tokens[i].opcode) << input;
+            EXPECT_EQ(compact[i].numberBase, tokens[i].numberBase) << input;
+        }
+    }
+}
+
+TEST(TokenizerTest, CompactBufferIsReused) {
+    std::vector<CompactToken> tokens;
+    Tokenizer::tokenize("1 + 2 + 3 + 4", tokens);
+    const CompactToken* data = tokens.data();
+
+    Tokenizer::tokenize("5 * 6", tokens);
+    ASSERT_EQ(tokens.size(), 4u);
+    EXPECT_EQ(tokens.data(), data);
+    EXPECT_DOUBLE_EQ(tokens[2].number, 6.0);
+}
+
+TEST(TokenizerTest, CompactTokensReportErrorPositions) {
+    std::vector<CompactToken> tokens;
+    try {
+        Tokenizer::tokenize("1 + 2 # 3", tokens);
+        FAIL() << "Expected SyntaxError";
+    } catch (const SyntaxError& e) {
+        EXPECT_EQ(e.getPosition(), 6u);
+    }
+
+    EXPECT_THROW(Tokenizer::tokenize("0x", tokens), SyntaxError);
+    EXPECT_THROW(Tokenizer::tokenize("1.", tokens), SyntaxError);
+    EXPECT_THROW(Tokenizer::tokenize("1e400", tokens), SyntaxError);
+}
+
+TEST(TokenizerTest, PrefixedLiteralsWrapTo64Bits) {
+    std::vector<CompactToken> tokens;
+    Tokenizer::tokenize("0xFFFFFFFFFFFFFFFF", tokens);
+    EXPECT_DOUBLE_EQ(tokens[0].number, -1.0);
+}
+
+TEST(TokenizerTest, ViewOfALargerBuffer) {
+    const std::string buffer = "1 + 2\nsqrt(x)\n";
+    std::string_view line = std::string_view(buffer).substr(6, 7);
+
+    std::vector<Token> tokens = Tokenizer::tokenize(line);
+    Tokenizer tokenizer{std::string(line)};
+    std::vector<Token> expected = tokenizer.tokenize();
+
+    ASSERT_EQ(tokens.size(), expected.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        EXPECT_EQ(tokens[i].type, expected[i].type);
+        EXPECT_EQ(tokens[i].value, expected[i].value);
+        EXPECT_EQ(tokens[i].position, expected[i].position);
+    }
+    EXPECT_EQ(tokens[0].value, "sqrt");
+}
+
 // ============================================================================
 // Main function
 // ============================================================================